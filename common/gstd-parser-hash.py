@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#
+# This file is part of GStreamer Daemon
+# Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+#
+# Regenerates the perfect hash used by gstd_parser_parse_cmd() to
+# dispatch commands. Run it after adding or removing an entry in the
+# cmds[] table of libgstd/gstd_parser.c:
+#
+#   ./common/gstd-parser-hash.py libgstd/gstd_parser.c
+#
+# The script finds a multiplier for which every command name lands on a
+# distinct slot, then rewrites GSTD_PARSER_HASH_MULT and the slot
+# indices of cmds[] in place. The hash must match gstd_parser_hash().
+
+import re
+import sys
+
+BITS = 7
+MAX_MULT = 1 << 20
+
+ENTRY = re.compile(r'^(\s*)\[\s*\d+\s*\]\s*=\s*(\{"(\w+)",.*)$')
+MULT = re.compile(r'^(#define GSTD_PARSER_HASH_MULT )\d+$')
+
+
+def slot(name, mult):
+    h = 0
+    for c in name.lower():
+        h = (h * mult + ord(c)) & 0xffffffff
+    return h >> (32 - BITS)
+
+
+def find_mult(names):
+    for mult in range(3, MAX_MULT, 2):
+        if len({slot(n, mult) for n in names}) == len(names):
+            return mult
+    sys.exit("No perfect hash found, increase GSTD_PARSER_HASH_BITS")
+
+
+def main(path):
+    with open(path) as f:
+        lines = f.read().split('\n')
+
+    names = [m.group(3) for m in map(ENTRY.match, lines) if m]
+    if len(names) > (1 << BITS):
+        sys.exit("Too many commands for %d hash bits" % BITS)
+
+    mult = find_mult(names)
+
+    out = []
+    for line in lines:
+        m = ENTRY.match(line)
+        if m:
+            line = '%s[%d] = %s' % (m.group(1), slot(m.group(3), mult),
+                                    m.group(2))
+        m = MULT.match(line)
+        if m:
+            line = '%s%d' % (m.group(1), mult)
+        out.append(line)
+
+    with open(path, 'w') as f:
+        f.write('\n'.join(out))
+
+    print("%d commands, multiplier %d" % (len(names), mult))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s gstd_parser.c" % sys.argv[0])
+    main(sys.argv[1])
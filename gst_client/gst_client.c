@@ -115,7 +115,7 @@ static GstdClientCmd cmds[] = {
       "pipeline_create_ref <name> <description>"},
   {"pipeline_delete", gstd_client_cmd_socket,
         "Deletes the pipeline with the given name",
-      "pipeline_delete <name>"},
+      "pipeline_delete <name> [async]"},
   {"pipeline_delete_ref", gstd_client_cmd_socket,
         "Deletes the pipeline with the given name using refcount",
       "pipeline_delete_ref <name>"},
@@ -135,6 +135,27 @@ static GstdClientCmd cmds[] = {
       "pipeline_get_graph <name>"},
   {"pipeline_verbose", gstd_client_cmd_socket, "Updates pipeline verbose",
       "pipeline_verbose <name> <value>"},
+  {"pipeline_wait", gstd_client_cmd_socket,
+        "Waits until a state change, by default the latest, reaches its "
+        "target or fails, the response tells which. Timeout in "
+        "nanoseconds, -1 forever",
+      "pipeline_wait <name> [transition] [timeout]"},
+
+  {"template_create", gstd_client_cmd_socket,
+        "Registers a pipeline description with ${name} placeholders",
+      "template_create <name> <description>"},
+  {"template_delete", gstd_client_cmd_socket,
+        "Deletes the template with the given name",
+      "template_delete <name>"},
+  {"pipeline_create_from", gstd_client_cmd_socket,
+        "Creates a new pipeline from a template and its parameter values",
+      "pipeline_create_from <name> <template> [parameter=value ...]"},
+  {"standby_create", gstd_client_cmd_socket,
+        "Keeps pipelines of a description or template built in ready or paused",
+      "standby_create <name> <size> <ready|paused> <description>"},
+  {"standby_delete", gstd_client_cmd_socket,
+        "Deletes the standby pool with the given name",
+      "standby_delete <name>"},
 
   {"element_set", gstd_client_cmd_socket,
         "Sets a property in an element of a given pipeline",
@@ -145,6 +166,10 @@ static GstdClientCmd cmds[] = {
 
   {"list_pipelines", gstd_client_cmd_socket, "List the existing pipelines",
       "list_pipelines"},
+  {"list_templates", gstd_client_cmd_socket, "List the existing templates",
+      "list_templates"},
+  {"list_standby", gstd_client_cmd_socket, "List the existing standby pools",
+      "list_standby"},
   {"list_elements", gstd_client_cmd_socket,
         "List the elements in a given pipeline",
       "list_elements <pipe>"},
@@ -165,6 +190,11 @@ static GstdClientCmd cmds[] = {
         "Apply a timeout for the bus polling. -1: forever, 0: return immediately, "
         "n: wait n nanoseconds",
       "bus_timeout <pipe> <timeout>"},
+  {"bus_read_since", gstd_client_cmd_socket,
+        "Read the messages newer than a sequence number without taking them "
+        "from other readers, waiting timeout nanoseconds, -1 forever. "
+        "Continue from the returned \"next\"",
+      "bus_read_since <pipe> <seq> [types=any] [max=64] [timeout=0]"},
 
   {"event_eos", gstd_client_cmd_socket, "Send an end-of-stream event",
       "event_eos <pipe>"},
@@ -186,6 +216,11 @@ static GstdClientCmd cmds[] = {
       "signal_timeout <pipe> <element> <signal> <timeout>"},
   {"signal_disconnect", gstd_client_cmd_socket, "Disconnect from signal",
       "signal_disconnect <pipe> <element> <signal>"},
+  {"signal_read_since", gstd_client_cmd_socket,
+        "Read the emissions newer than a sequence number without taking them "
+        "from other readers, waiting timeout nanoseconds, -1 forever. "
+        "Continue from the returned \"next\"",
+      "signal_read_since <pipe> <element> <signal> <seq> [max=64] [timeout=0]"},
 
   {"action_emit", gstd_client_cmd_socket, "Emit action",
       "action_emit <pipe> <element> <action>"},
@@ -0,0 +1,1159 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Load generator for a running gstd. A number of clients, each with
+ * its own connection and thread, run a weighted mix of commands
+ * against fakesrc ! fakesink pipelines for a fixed time, and the
+ * throughput and latency percentiles of every command are printed as
+ * JSON. The TCP IPC is driven through libgstc, the Unix and HTTP IPCs
+ * through raw sockets.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+#include <json-glib/json-glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libgstc.h"
+
+/* cmdline defaults */
+#define GSTD_BENCH_DEFAULT_ADDRESS "127.0.0.1"
+#define GSTD_BENCH_DEFAULT_TCP_PORT 5000
+#define GSTD_BENCH_DEFAULT_HTTP_PORT 5001
+#define GSTD_BENCH_DEFAULT_UNIX_PORT 0
+#define GSTD_BENCH_DEFAULT_UNIX_PATH GSTD_RUN_STATE_DIR "/gstd_unix_socket"
+#define GSTD_BENCH_DEFAULT_CLIENTS 4
+#define GSTD_BENCH_DEFAULT_DURATION 10
+#define GSTD_BENCH_DEFAULT_WARMUP 1
+#define GSTD_BENCH_DEFAULT_PIPELINES 4
+#define GSTD_BENCH_DEFAULT_MIX \
+  "element_set=50,list_pipelines=15,churn=5,bus_read=15,status=15"
+
+/* How long to wait for a response before giving up, in milliseconds */
+#define GSTD_BENCH_TIMEOUT 5000
+
+#define GSTD_BENCH_DESCRIPTION "fakesrc name=src ! fakesink name=sink"
+#define GSTD_BENCH_CHURN_DESCRIPTION "fakesrc ! fakesink"
+
+typedef enum
+{
+  GSTD_BENCH_IPC_TCP,
+  GSTD_BENCH_IPC_UNIX,
+  GSTD_BENCH_IPC_HTTP
+} GstdBenchIpc;
+
+typedef enum
+{
+  GSTD_BENCH_OP_ELEMENT_SET,
+  GSTD_BENCH_OP_LIST_PIPELINES,
+  GSTD_BENCH_OP_CHURN,
+  GSTD_BENCH_OP_BUS_READ,
+  GSTD_BENCH_OP_STATUS,
+  GSTD_BENCH_OP_COUNT
+} GstdBenchOp;
+
+static const gchar *gstd_bench_op_names[GSTD_BENCH_OP_COUNT] = {
+  "element_set",
+  "list_pipelines",
+  "churn",
+  "bus_read",
+  "status",
+};
+
+typedef struct _GstdBenchOptions GstdBenchOptions;
+struct _GstdBenchOptions
+{
+  GstdBenchIpc ipc;
+  gchar *ipc_name;
+  gchar *address;
+  gint port;
+  gchar *path;
+  gint clients;
+  gint duration;
+  gint warmup;
+  gint pipelines;
+  gchar *mix;
+  gchar *output;
+
+  guint weights[GSTD_BENCH_OP_COUNT];
+  guint total_weight;
+};
+
+/*
+ * A connection to the daemon. TCP goes through libgstc, the rest
+ * through a socket opened on demand, so a dropped connection is
+ * reopened by the next request.
+ */
+typedef struct _GstdBenchConnection GstdBenchConnection;
+struct _GstdBenchConnection
+{
+  const GstdBenchOptions *options;
+
+  GstClient *gstc;
+
+  GSocketClient *client;
+  GSocketConnection *con;
+  GDataInputStream *input;
+};
+
+typedef struct _GstdBenchWorker GstdBenchWorker;
+struct _GstdBenchWorker
+{
+  guint id;
+  GstdBenchConnection connection;
+  GRand *rand;
+  guint churn_count;
+
+  /* Run until, counting only what starts after warmup_end, in ns */
+  guint64 warmup_end;
+  guint64 end;
+
+  /* Latencies of the successful requests, in ns */
+  GArray *latencies[GSTD_BENCH_OP_COUNT];
+  guint64 errors[GSTD_BENCH_OP_COUNT];
+};
+
+static guint64
+gstd_bench_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return (guint64) ts.tv_sec * G_GUINT64_CONSTANT (1000000000) + ts.tv_nsec;
+}
+
+static gchar *
+gstd_bench_pipeline_name (guint index)
+{
+  return g_strdup_printf ("bench_%u", index);
+}
+
+static gboolean
+gstd_bench_parse_ipc (GstdBenchOptions * options, GError ** error)
+{
+  if (!g_strcmp0 (options->ipc_name, "tcp")) {
+    options->ipc = GSTD_BENCH_IPC_TCP;
+  } else if (!g_strcmp0 (options->ipc_name, "unix")) {
+    options->ipc = GSTD_BENCH_IPC_UNIX;
+  } else if (!g_strcmp0 (options->ipc_name, "http")) {
+    options->ipc = GSTD_BENCH_IPC_HTTP;
+  } else {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Unknown IPC \"%s\", expected tcp, unix or http", options->ipc_name);
+    return FALSE;
+  }
+
+  if (options->port < 0) {
+    switch (options->ipc) {
+      case GSTD_BENCH_IPC_TCP:
+        options->port = GSTD_BENCH_DEFAULT_TCP_PORT;
+        break;
+      case GSTD_BENCH_IPC_UNIX:
+        options->port = GSTD_BENCH_DEFAULT_UNIX_PORT;
+        break;
+      case GSTD_BENCH_IPC_HTTP:
+        options->port = GSTD_BENCH_DEFAULT_HTTP_PORT;
+        break;
+    }
+  }
+
+  return TRUE;
+}
+
+/*
+ * Parses a mix like "element_set=50,churn=5", commands left out are
+ * not run
+ */
+static gboolean
+gstd_bench_parse_mix (GstdBenchOptions * options, GError ** error)
+{
+  gchar **entries;
+  gchar **pair;
+  guint64 weight;
+  gint op;
+  gint i;
+  gboolean ret = FALSE;
+
+  entries = g_strsplit (options->mix, ",", -1);
+
+  for (i = 0; entries[i]; i++) {
+    pair = g_strsplit (g_strstrip (entries[i]), "=", 2);
+
+    for (op = 0; op < GSTD_BENCH_OP_COUNT; op++) {
+      if (!g_strcmp0 (pair[0], gstd_bench_op_names[op])) {
+        break;
+      }
+    }
+
+    if (GSTD_BENCH_OP_COUNT == op || NULL == pair[1]
+        || !g_ascii_string_to_unsigned (pair[1], 10, 0, G_MAXUINT16,
+            &weight, NULL)) {
+      g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+          "Bad mix entry \"%s\", expected <command>=<weight>", entries[i]);
+      g_strfreev (pair);
+      goto out;
+    }
+    g_strfreev (pair);
+
+    options->weights[op] = weight;
+  }
+
+  for (op = 0; op < GSTD_BENCH_OP_COUNT; op++) {
+    options->total_weight += options->weights[op];
+  }
+
+  if (0 == options->total_weight) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "The mix doesn't run any command");
+    goto out;
+  }
+
+  ret = TRUE;
+
+out:
+  g_strfreev (entries);
+  return ret;
+}
+
+static void
+gstd_bench_disconnect (GstdBenchConnection * self)
+{
+  g_clear_object (&self->input);
+
+  if (self->con) {
+    g_io_stream_close (G_IO_STREAM (self->con), NULL, NULL);
+    g_clear_object (&self->con);
+  }
+}
+
+static gboolean
+gstd_bench_connect (GstdBenchConnection * self, GError ** error)
+{
+  const GstdBenchOptions *options = self->options;
+  GSocketAddress *socket_address;
+  GstcStatus status;
+  gchar *path;
+
+  if (GSTD_BENCH_IPC_TCP == options->ipc) {
+    if (self->gstc) {
+      return TRUE;
+    }
+
+    status = gstc_client_new (options->address, options->port,
+        GSTD_BENCH_TIMEOUT, 1, &self->gstc);
+    if (GSTC_OK != status) {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+          "Unable to create the libgstc client (%d)", status);
+      self->gstc = NULL;
+      return FALSE;
+    }
+
+    /* Nothing is exchanged on creation, make sure the daemon answers */
+    status = gstc_client_ping (self->gstc);
+    if (GSTC_OK != status) {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_CONNECTION_REFUSED,
+          "Unable to reach gstd at %s:%d (%d)", options->address,
+          options->port, status);
+      return FALSE;
+    }
+
+    return TRUE;
+  }
+
+  if (self->con) {
+    return TRUE;
+  }
+
+  if (!self->client) {
+    self->client = g_socket_client_new ();
+    g_socket_client_set_timeout (self->client, GSTD_BENCH_TIMEOUT / 1000);
+  }
+
+  if (GSTD_BENCH_IPC_UNIX == options->ipc) {
+    path = g_strdup_printf ("%s_%d", options->path, options->port);
+    socket_address = g_unix_socket_address_new (path);
+    g_free (path);
+
+    self->con = g_socket_client_connect (self->client,
+        G_SOCKET_CONNECTABLE (socket_address), NULL, error);
+    g_object_unref (socket_address);
+  } else {
+    self->con = g_socket_client_connect_to_host (self->client,
+        options->address, options->port, NULL, error);
+  }
+
+  if (!self->con) {
+    return FALSE;
+  }
+
+  self->input =
+      g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM
+          (self->con)));
+  g_data_input_stream_set_newline_type (self->input,
+      G_DATA_STREAM_NEWLINE_TYPE_CR_LF);
+
+  return TRUE;
+}
+
+static void
+gstd_bench_connection_clear (GstdBenchConnection * self)
+{
+  gstd_bench_disconnect (self);
+  g_clear_object (&self->client);
+
+  if (self->gstc) {
+    gstc_client_free (self->gstc);
+    self->gstc = NULL;
+  }
+}
+
+/*
+ * Sends a command through the Unix IPC, which answers with a NUL
+ * terminated JSON response. Returns TRUE if the command succeeded.
+ */
+static gboolean
+gstd_bench_socket_command (GstdBenchConnection * self, const gchar * command)
+{
+  GOutputStream *output;
+  JsonParser *parser = NULL;
+  JsonNode *root;
+  gchar *response = NULL;
+  gsize length;
+  GError *error = NULL;
+  gboolean ret = FALSE;
+
+  if (!gstd_bench_connect (self, &error)) {
+    goto out;
+  }
+
+  output = g_io_stream_get_output_stream (G_IO_STREAM (self->con));
+  if (!g_output_stream_write_all (output, command, strlen (command), NULL,
+          NULL, &error)) {
+    goto disconnect;
+  }
+
+  response = g_data_input_stream_read_upto (self->input, "", 1, &length,
+      NULL, &error);
+  if (!response) {
+    goto disconnect;
+  }
+
+  /* Consume the terminator */
+  g_data_input_stream_read_byte (self->input, NULL, &error);
+  if (error) {
+    goto disconnect;
+  }
+
+  parser = json_parser_new ();
+  if (!json_parser_load_from_data (parser, response, length, NULL)) {
+    goto out;
+  }
+
+  root = json_parser_get_root (parser);
+  ret = JSON_NODE_HOLDS_OBJECT (root)
+      && 0 == json_object_get_int_member (json_node_get_object (root), "code");
+  goto out;
+
+disconnect:
+  gstd_bench_disconnect (self);
+
+out:
+  g_clear_error (&error);
+  g_clear_object (&parser);
+  g_free (response);
+
+  return ret;
+}
+
+/*
+ * Skips a chunked body, trailers included
+ */
+static gboolean
+gstd_bench_http_skip_chunks (GstdBenchConnection * self, GError ** error)
+{
+  GInputStream *input = G_INPUT_STREAM (self->input);
+  gchar *line;
+  guint64 size;
+
+  do {
+    line = g_data_input_stream_read_line (self->input, NULL, NULL, error);
+    if (!line) {
+      return FALSE;
+    }
+    size = g_ascii_strtoull (line, NULL, 16);
+    g_free (line);
+
+    if (size > 0 && (gssize) (size + 2) != g_input_stream_skip (input,
+            size + 2, NULL, error)) {
+      return FALSE;
+    }
+  } while (size > 0);
+
+  /* Trailers up to the empty line */
+  while ((line = g_data_input_stream_read_line (self->input, NULL, NULL,
+              error))) {
+    size = strlen (line);
+    g_free (line);
+    if (0 == size) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*
+ * Sends a request with an empty body through the HTTP IPC, keeping the
+ * connection alive. Returns TRUE if the daemon answered 200 OK.
+ */
+static gboolean
+gstd_bench_http_request (GstdBenchConnection * self, const gchar * method,
+    const gchar * path)
+{
+  GOutputStream *output;
+  gchar *request = NULL;
+  gchar *line = NULL;
+  guint64 content_length = 0;
+  gboolean chunked = FALSE;
+  gboolean closing = FALSE;
+  guint status = 0;
+  GError *error = NULL;
+  gboolean ret = FALSE;
+
+  if (!gstd_bench_connect (self, &error)) {
+    goto out;
+  }
+
+  request = g_strdup_printf ("%s %s HTTP/1.1\r\nHost: %s:%d\r\n"
+      "Content-Length: 0\r\n\r\n", method, path, self->options->address,
+      self->options->port);
+
+  output = g_io_stream_get_output_stream (G_IO_STREAM (self->con));
+  if (!g_output_stream_write_all (output, request, strlen (request), NULL,
+          NULL, &error)) {
+    goto disconnect;
+  }
+
+  /* HTTP/1.1 200 OK */
+  line = g_data_input_stream_read_line (self->input, NULL, NULL, &error);
+  if (!line || !g_str_has_prefix (line, "HTTP/1.") || strlen (line) < 12) {
+    goto disconnect;
+  }
+  status = g_ascii_strtoull (line + 9, NULL, 10);
+  g_free (line);
+
+  while ((line = g_data_input_stream_read_line (self->input, NULL, NULL,
+              &error)) && '\0' != line[0]) {
+    if (!g_ascii_strncasecmp (line, "Content-Length:", 15)) {
+      content_length = g_ascii_strtoull (line + 15, NULL, 10);
+    } else if (!g_ascii_strncasecmp (line, "Transfer-Encoding:", 18)) {
+      chunked = NULL != strstr (line + 18, "chunked");
+    } else if (!g_ascii_strncasecmp (line, "Connection:", 11)) {
+      closing = NULL != strstr (line + 11, "close");
+    }
+    g_free (line);
+  }
+
+  if (!line) {
+    goto disconnect;
+  }
+
+  if (chunked) {
+    if (!gstd_bench_http_skip_chunks (self, &error)) {
+      goto disconnect;
+    }
+  } else if (content_length > 0 && (gssize) content_length !=
+      g_input_stream_skip (G_INPUT_STREAM (self->input), content_length,
+          NULL, &error)) {
+    goto disconnect;
+  }
+
+  ret = 200 == status;
+
+  if (!closing) {
+    goto out;
+  }
+
+disconnect:
+  gstd_bench_disconnect (self);
+
+out:
+  g_clear_error (&error);
+  g_free (line);
+  g_free (request);
+
+  return ret;
+}
+
+/*
+ * The requests below are the building blocks of the commands, each
+ * sent the way the IPC in use expects
+ */
+
+static gboolean
+gstd_bench_pipeline_create (GstdBenchConnection * self, const gchar * name,
+    const gchar * description)
+{
+  gchar *request;
+  gchar *escaped;
+  gboolean ret;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      return GSTC_OK == gstc_pipeline_create (self->gstc, name, description);
+    case GSTD_BENCH_IPC_UNIX:
+      request = g_strdup_printf ("pipeline_create %s %s", name, description);
+      ret = gstd_bench_socket_command (self, request);
+      break;
+    default:
+      escaped = g_uri_escape_string (description, NULL, FALSE);
+      request = g_strdup_printf ("/pipelines?name=%s&description=%s", name,
+          escaped);
+      g_free (escaped);
+      ret = gstd_bench_http_request (self, "POST", request);
+      break;
+  }
+  g_free (request);
+
+  return ret;
+}
+
+static gboolean
+gstd_bench_pipeline_delete (GstdBenchConnection * self, const gchar * name)
+{
+  gchar *request;
+  gboolean ret;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      return GSTC_OK == gstc_pipeline_delete (self->gstc, name);
+    case GSTD_BENCH_IPC_UNIX:
+      request = g_strdup_printf ("pipeline_delete %s", name);
+      ret = gstd_bench_socket_command (self, request);
+      break;
+    default:
+      request = g_strdup_printf ("/pipelines?name=%s", name);
+      ret = gstd_bench_http_request (self, "DELETE", request);
+      break;
+  }
+  g_free (request);
+
+  return ret;
+}
+
+/*
+ * Runs a single command through a libgstc batch, for the commands
+ * libgstc has no call for
+ */
+static gboolean
+gstd_bench_gstc_command (GstdBenchConnection * self, const gchar * command)
+{
+  GstcBatch *batch = NULL;
+  GstcStatus status;
+
+  status = gstc_batch_new (&batch, 1);
+  if (GSTC_OK != status) {
+    return FALSE;
+  }
+
+  status = gstc_batch_add (batch, "%s", command);
+  if (GSTC_OK == status) {
+    status = gstc_batch_execute (self->gstc, batch, NULL, NULL);
+  }
+  gstc_batch_free (batch);
+
+  return GSTC_OK == status;
+}
+
+static gboolean
+gstd_bench_bus_timeout (GstdBenchConnection * self, const gchar * name)
+{
+  gchar *request;
+  gboolean ret;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      request = g_strdup_printf ("bus_timeout %s 0", name);
+      ret = gstd_bench_gstc_command (self, request);
+      break;
+    case GSTD_BENCH_IPC_UNIX:
+      request = g_strdup_printf ("bus_timeout %s 0", name);
+      ret = gstd_bench_socket_command (self, request);
+      break;
+    default:
+      request = g_strdup_printf ("/pipelines/%s/bus/timeout?name=0", name);
+      ret = gstd_bench_http_request (self, "PUT", request);
+      break;
+  }
+  g_free (request);
+
+  return ret;
+}
+
+static gboolean
+gstd_bench_element_set (GstdBenchConnection * self, const gchar * name,
+    gint value)
+{
+  gchar *request;
+  gboolean ret;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      return GSTC_OK == gstc_element_set (self->gstc, name, "src", "sizemax",
+          "%d", value);
+    case GSTD_BENCH_IPC_UNIX:
+      request = g_strdup_printf ("element_set %s src sizemax %d", name, value);
+      ret = gstd_bench_socket_command (self, request);
+      break;
+    default:
+      request = g_strdup_printf ("/pipelines/%s/elements/src/properties/"
+          "sizemax?name=%d", name, value);
+      ret = gstd_bench_http_request (self, "PUT", request);
+      break;
+  }
+  g_free (request);
+
+  return ret;
+}
+
+static gboolean
+gstd_bench_list_pipelines (GstdBenchConnection * self)
+{
+  gchar **pipelines = NULL;
+  gint length = 0;
+  gint i;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      if (GSTC_OK != gstc_pipeline_list (self->gstc, &pipelines, &length)) {
+        return FALSE;
+      }
+      for (i = 0; i < length; i++) {
+        free (pipelines[i]);
+      }
+      free (pipelines);
+      return TRUE;
+    case GSTD_BENCH_IPC_UNIX:
+      return gstd_bench_socket_command (self, "list_pipelines");
+    default:
+      return gstd_bench_http_request (self, "GET", "/pipelines");
+  }
+}
+
+static gboolean
+gstd_bench_bus_read (GstdBenchConnection * self, const gchar * name)
+{
+  gchar *request;
+  gboolean ret;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      request = g_strdup_printf ("bus_read %s", name);
+      ret = gstd_bench_gstc_command (self, request);
+      break;
+    case GSTD_BENCH_IPC_UNIX:
+      request = g_strdup_printf ("bus_read %s", name);
+      ret = gstd_bench_socket_command (self, request);
+      break;
+    default:
+      request = g_strdup_printf ("/pipelines/%s/bus/message", name);
+      ret = gstd_bench_http_request (self, "GET", request);
+      break;
+  }
+  g_free (request);
+
+  return ret;
+}
+
+/*
+ * Polls the status of a pipeline. The HTTP IPC publishes the status of
+ * every pipeline at once, the socket IPCs read the state of one.
+ */
+static gboolean
+gstd_bench_status (GstdBenchConnection * self, const gchar * name)
+{
+  gchar *request;
+  gchar *state = NULL;
+  gboolean ret;
+
+  switch (self->options->ipc) {
+    case GSTD_BENCH_IPC_TCP:
+      ret = GSTC_OK == gst_pipeline_get_state (self->gstc, name, &state);
+      free (state);
+      return ret;
+    case GSTD_BENCH_IPC_UNIX:
+      request = g_strdup_printf ("read /pipelines/%s/state", name);
+      ret = gstd_bench_socket_command (self, request);
+      g_free (request);
+      return ret;
+    default:
+      return gstd_bench_http_request (self, "GET", "/pipelines/status");
+  }
+}
+
+static GstdBenchOp
+gstd_bench_pick_op (GstdBenchWorker * worker)
+{
+  const GstdBenchOptions *options = worker->connection.options;
+  guint pick;
+  gint op;
+
+  pick = g_rand_int_range (worker->rand, 0, options->total_weight);
+
+  for (op = 0; op < GSTD_BENCH_OP_COUNT - 1; op++) {
+    if (pick < options->weights[op]) {
+      break;
+    }
+    pick -= options->weights[op];
+  }
+
+  return op;
+}
+
+static gboolean
+gstd_bench_run_op (GstdBenchWorker * worker, GstdBenchOp op)
+{
+  GstdBenchConnection *connection = &worker->connection;
+  gchar *name;
+  gboolean ret = FALSE;
+
+  if (GSTD_BENCH_OP_CHURN == op) {
+    name = g_strdup_printf ("bench_churn_%u_%u", worker->id,
+        worker->churn_count++);
+    ret = gstd_bench_pipeline_create (connection, name,
+        GSTD_BENCH_CHURN_DESCRIPTION);
+    /* Delete even if the create seemed to fail, it may have timed out */
+    ret = gstd_bench_pipeline_delete (connection, name) && ret;
+    g_free (name);
+    return ret;
+  }
+
+  if (GSTD_BENCH_OP_LIST_PIPELINES == op) {
+    return gstd_bench_list_pipelines (connection);
+  }
+
+  name = gstd_bench_pipeline_name (g_rand_int_range (worker->rand, 0,
+          connection->options->pipelines));
+
+  switch (op) {
+    case GSTD_BENCH_OP_ELEMENT_SET:
+      ret = gstd_bench_element_set (connection, name,
+          g_rand_int_range (worker->rand, 1, 4097));
+      break;
+    case GSTD_BENCH_OP_BUS_READ:
+      ret = gstd_bench_bus_read (connection, name);
+      break;
+    case GSTD_BENCH_OP_STATUS:
+      ret = gstd_bench_status (connection, name);
+      break;
+    default:
+      g_assert_not_reached ();
+  }
+  g_free (name);
+
+  return ret;
+}
+
+static gpointer
+gstd_bench_worker_run (gpointer user_data)
+{
+  GstdBenchWorker *worker = user_data;
+  GstdBenchOp op;
+  guint64 start;
+  guint64 latency;
+  gboolean ok;
+
+  while ((start = gstd_bench_now ()) < worker->end) {
+    op = gstd_bench_pick_op (worker);
+    ok = gstd_bench_run_op (worker, op);
+    latency = gstd_bench_now () - start;
+
+    if (start < worker->warmup_end) {
+      continue;
+    }
+
+    if (ok) {
+      g_array_append_val (worker->latencies[op], latency);
+    } else {
+      worker->errors[op]++;
+    }
+  }
+
+  return NULL;
+}
+
+static gint
+gstd_bench_compare (gconstpointer a, gconstpointer b)
+{
+  guint64 x = *(const guint64 *) a;
+  guint64 y = *(const guint64 *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+/* Nearest rank of a sorted array, in microseconds */
+static gdouble
+gstd_bench_percentile (GArray * sorted, gdouble percentile)
+{
+  guint rank;
+
+  if (0 == sorted->len) {
+    return 0;
+  }
+
+  rank = (guint) (percentile * sorted->len);
+  if (rank < percentile * sorted->len) {
+    rank++;
+  }
+  rank = CLAMP (rank, 1, sorted->len);
+
+  return g_array_index (sorted, guint64, rank - 1) / 1000.0;
+}
+
+static void
+gstd_bench_add_results (JsonBuilder * builder, GArray * latencies,
+    guint64 errors, gint duration)
+{
+  g_array_sort (latencies, gstd_bench_compare);
+
+  json_builder_begin_object (builder);
+  json_builder_set_member_name (builder, "requests");
+  json_builder_add_int_value (builder, latencies->len);
+  json_builder_set_member_name (builder, "errors");
+  json_builder_add_int_value (builder, errors);
+  json_builder_set_member_name (builder, "throughput");
+  json_builder_add_double_value (builder,
+      (gdouble) latencies->len / duration);
+
+  json_builder_set_member_name (builder, "latency_us");
+  json_builder_begin_object (builder);
+  json_builder_set_member_name (builder, "p50");
+  json_builder_add_double_value (builder,
+      gstd_bench_percentile (latencies, 0.5));
+  json_builder_set_member_name (builder, "p99");
+  json_builder_add_double_value (builder,
+      gstd_bench_percentile (latencies, 0.99));
+  json_builder_set_member_name (builder, "p999");
+  json_builder_add_double_value (builder,
+      gstd_bench_percentile (latencies, 0.999));
+  json_builder_set_member_name (builder, "max");
+  json_builder_add_double_value (builder,
+      gstd_bench_percentile (latencies, 1));
+  json_builder_end_object (builder);
+
+  json_builder_end_object (builder);
+}
+
+static gchar *
+gstd_bench_report (const GstdBenchOptions * options,
+    GstdBenchWorker * workers)
+{
+  JsonBuilder *builder;
+  JsonGenerator *generator;
+  JsonNode *root;
+  GArray *latencies;
+  GArray *total;
+  guint64 errors;
+  guint64 total_errors = 0;
+  gchar *out;
+  gint op;
+  gint i;
+
+  builder = json_builder_new ();
+  total = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  json_builder_begin_object (builder);
+  json_builder_set_member_name (builder, "ipc");
+  json_builder_add_string_value (builder, options->ipc_name);
+  json_builder_set_member_name (builder, "clients");
+  json_builder_add_int_value (builder, options->clients);
+  json_builder_set_member_name (builder, "pipelines");
+  json_builder_add_int_value (builder, options->pipelines);
+  json_builder_set_member_name (builder, "duration");
+  json_builder_add_int_value (builder, options->duration);
+
+  json_builder_set_member_name (builder, "mix");
+  json_builder_begin_object (builder);
+  for (op = 0; op < GSTD_BENCH_OP_COUNT; op++) {
+    json_builder_set_member_name (builder, gstd_bench_op_names[op]);
+    json_builder_add_int_value (builder, options->weights[op]);
+  }
+  json_builder_end_object (builder);
+
+  json_builder_set_member_name (builder, "operations");
+  json_builder_begin_object (builder);
+  for (op = 0; op < GSTD_BENCH_OP_COUNT; op++) {
+    if (0 == options->weights[op]) {
+      continue;
+    }
+
+    latencies = g_array_new (FALSE, FALSE, sizeof (guint64));
+    errors = 0;
+    for (i = 0; i < options->clients; i++) {
+      g_array_append_vals (latencies, workers[i].latencies[op]->data,
+          workers[i].latencies[op]->len);
+      errors += workers[i].errors[op];
+    }
+    g_array_append_vals (total, latencies->data, latencies->len);
+    total_errors += errors;
+
+    json_builder_set_member_name (builder, gstd_bench_op_names[op]);
+    gstd_bench_add_results (builder, latencies, errors, options->duration);
+    g_array_unref (latencies);
+  }
+  json_builder_end_object (builder);
+
+  json_builder_set_member_name (builder, "total");
+  gstd_bench_add_results (builder, total, total_errors, options->duration);
+
+  json_builder_end_object (builder);
+
+  root = json_builder_get_root (builder);
+  generator = json_generator_new ();
+  json_generator_set_pretty (generator, TRUE);
+  json_generator_set_root (generator, root);
+  out = json_generator_to_data (generator, NULL);
+
+  g_object_unref (generator);
+  json_node_unref (root);
+  g_array_unref (total);
+  g_object_unref (builder);
+
+  return out;
+}
+
+/*
+ * Creates the pipelines the commands run against, replacing any left
+ * behind by an interrupted run. Bus reads return right away.
+ */
+static gboolean
+gstd_bench_setup (GstdBenchConnection * connection,
+    const GstdBenchOptions * options)
+{
+  gchar *name;
+  gboolean ret = TRUE;
+  gint i;
+
+  for (i = 0; i < options->pipelines && ret; i++) {
+    name = gstd_bench_pipeline_name (i);
+    gstd_bench_pipeline_delete (connection, name);
+
+    if (!gstd_bench_pipeline_create (connection, name, GSTD_BENCH_DESCRIPTION)
+        || !gstd_bench_bus_timeout (connection, name)) {
+      g_printerr ("Unable to set up pipeline %s\n", name);
+      ret = FALSE;
+    }
+    g_free (name);
+  }
+
+  return ret;
+}
+
+static void
+gstd_bench_teardown (GstdBenchConnection * connection,
+    const GstdBenchOptions * options)
+{
+  gchar *name;
+  gint i;
+
+  for (i = 0; i < options->pipelines; i++) {
+    name = gstd_bench_pipeline_name (i);
+    gstd_bench_pipeline_delete (connection, name);
+    g_free (name);
+  }
+}
+
+int
+main (gint argc, gchar * argv[])
+{
+  GstdBenchOptions options = {
+    .port = -1,
+    .clients = GSTD_BENCH_DEFAULT_CLIENTS,
+    .duration = GSTD_BENCH_DEFAULT_DURATION,
+    .warmup = GSTD_BENCH_DEFAULT_WARMUP,
+    .pipelines = GSTD_BENCH_DEFAULT_PIPELINES,
+  };
+  GOptionEntry entries[] = {
+    {"ipc", 'i', 0, G_OPTION_ARG_STRING, &options.ipc_name,
+        "The IPC to drive: tcp, unix or http (default: tcp)", "ipc"},
+    {"address", 'a', 0, G_OPTION_ARG_STRING, &options.address,
+        "The address of the TCP and HTTP IPCs (default: "
+          GSTD_BENCH_DEFAULT_ADDRESS ")", "address"},
+    {"port", 'p', 0, G_OPTION_ARG_INT, &options.port,
+          "The port of the IPC, the suffix of the socket path for Unix "
+          "(default: 5000 for tcp, 5001 for http, 0 for unix)", "port"},
+    {"path", 0, 0, G_OPTION_ARG_STRING, &options.path,
+          "The base path of the Unix socket (default: "
+          GSTD_BENCH_DEFAULT_UNIX_PATH ")", "path"},
+    {"clients", 'c', 0, G_OPTION_ARG_INT, &options.clients,
+          "Concurrent clients, each with its own connection (default: 4)",
+        "clients"},
+    {"duration", 'd', 0, G_OPTION_ARG_INT, &options.duration,
+        "Seconds to measure for (default: 10)", "seconds"},
+    {"warmup", 'w', 0, G_OPTION_ARG_INT, &options.warmup,
+        "Seconds to run before measuring (default: 1)", "seconds"},
+    {"pipelines", 'n', 0, G_OPTION_ARG_INT, &options.pipelines,
+        "Pipelines to run the commands against (default: 4)", "pipelines"},
+    {"mix", 'm', 0, G_OPTION_ARG_STRING, &options.mix,
+          "Weighted commands to run, out of element_set, list_pipelines, "
+          "churn, bus_read and status (default: " GSTD_BENCH_DEFAULT_MIX ")",
+        "mix"},
+    {"output", 'o', 0, G_OPTION_ARG_FILENAME, &options.output,
+        "Write the results to this file instead of stdout", "file"},
+    {NULL}
+  };
+  GOptionContext *context;
+  GstdBenchConnection setup = { 0 };
+  GstdBenchWorker *workers = NULL;
+  GThread **threads = NULL;
+  GError *error = NULL;
+  gchar *report = NULL;
+  guint64 warmup_end;
+  guint64 end;
+  gint ret = EXIT_FAILURE;
+  gint op;
+  gint i;
+
+  context = g_option_context_new ("- GStreamer Daemon load generator");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    goto error;
+  }
+
+  if (!options.ipc_name) {
+    options.ipc_name = g_strdup ("tcp");
+  }
+  if (!options.address) {
+    options.address = g_strdup (GSTD_BENCH_DEFAULT_ADDRESS);
+  }
+  if (!options.path) {
+    options.path = g_strdup (GSTD_BENCH_DEFAULT_UNIX_PATH);
+  }
+  if (!options.mix) {
+    options.mix = g_strdup (GSTD_BENCH_DEFAULT_MIX);
+  }
+
+  if (!gstd_bench_parse_ipc (&options, &error)
+      || !gstd_bench_parse_mix (&options, &error)) {
+    goto error;
+  }
+
+  if (options.clients < 1 || options.duration < 1 || options.warmup < 0
+      || options.pipelines < 1) {
+    g_set_error (&error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Clients, duration and pipelines must be positive");
+    goto error;
+  }
+
+  setup.options = &options;
+  if (!gstd_bench_connect (&setup, &error)) {
+    goto error;
+  }
+
+  if (!gstd_bench_setup (&setup, &options)) {
+    goto teardown;
+  }
+
+  /* Connect everyone before starting the clock */
+  workers = g_new0 (GstdBenchWorker, options.clients);
+  for (i = 0; i < options.clients; i++) {
+    workers[i].id = i;
+    workers[i].connection.options = &options;
+    workers[i].rand = g_rand_new_with_seed (i);
+    for (op = 0; op < GSTD_BENCH_OP_COUNT; op++) {
+      workers[i].latencies[op] = g_array_new (FALSE, FALSE, sizeof (guint64));
+    }
+
+    if (!gstd_bench_connect (&workers[i].connection, &error)) {
+      goto teardown;
+    }
+  }
+
+  warmup_end = gstd_bench_now () + options.warmup * G_GUINT64_CONSTANT
+      (1000000000);
+  end = warmup_end + options.duration * G_GUINT64_CONSTANT (1000000000);
+
+  threads = g_new0 (GThread *, options.clients);
+  for (i = 0; i < options.clients; i++) {
+    workers[i].warmup_end = warmup_end;
+    workers[i].end = end;
+    threads[i] = g_thread_new ("bench", gstd_bench_worker_run, &workers[i]);
+  }
+
+  for (i = 0; i < options.clients; i++) {
+    g_thread_join (threads[i]);
+  }
+
+  report = gstd_bench_report (&options, workers);
+
+  if (options.output) {
+    if (!g_file_set_contents (options.output, report, -1, &error)) {
+      goto teardown;
+    }
+  } else {
+    g_print ("%s\n", report);
+  }
+
+  ret = EXIT_SUCCESS;
+
+teardown:
+  gstd_bench_teardown (&setup, &options);
+
+error:
+  if (error) {
+    g_printerr ("%s\n", error->message);
+    g_error_free (error);
+  }
+
+  if (workers) {
+    for (i = 0; i < options.clients; i++) {
+      gstd_bench_connection_clear (&workers[i].connection);
+      if (workers[i].rand) {
+        g_rand_free (workers[i].rand);
+      }
+      for (op = 0; op < GSTD_BENCH_OP_COUNT; op++) {
+        if (workers[i].latencies[op]) {
+          g_array_unref (workers[i].latencies[op]);
+        }
+      }
+    }
+    g_free (workers);
+  }
+
+  gstd_bench_connection_clear (&setup);
+  g_option_context_free (context);
+  g_free (threads);
+  g_free (report);
+  g_free (options.ipc_name);
+  g_free (options.address);
+  g_free (options.path);
+  g_free (options.mix);
+  g_free (options.output);
+
+  return ret;
+}
@@ -43,11 +43,20 @@
 #include "libgstc.h"
 #include "libgstc_socket.h"
 #include "libgstc_json.h"
+#include "libgstc_cbor.h"
 #include "libgstc_assert.h"
 #include "libgstc_thread.h"
 
 #define PRINTF_ERROR -1
 
+/* Connections a client opens at most, see gstc_client_set_max_connections */
+#ifndef GSTC_DEFAULT_MAX_CONNECTIONS
+#define GSTC_DEFAULT_MAX_CONNECTIONS 4
+#endif
+
+/* Acquires whichever connection is available */
+#define ANY_CONNECTION -1
+
 /* Gst client command update formats */
 #define CREATE_FORMAT "create %s %s"
 #define READ_FORMAT   "read %s"
@@ -63,8 +72,7 @@
 #define PIPELINE_CREATE_FORMAT               "%s %s"
 #define PIPELINE_STATE_FORMAT                "/pipelines/%s/state"
 #define PIPELINE_GRAPH_FORMAT                "/pipelines/%s/graph"
-#define PIPELINE_BUS_FORMAT                  "/pipelines/%s/bus/%s"
-#define PIPELINE_BUS_MSG_FORMAT              "/pipelines/%s/bus/message"
+#define PIPELINE_BUS_READ_SINCE_FORMAT       "bus_read_since %s %s %s 1 %lli"
 #define PIPELINE_ELEMENTS_FORMAT             "/pipelines/%s/elements/"
 #define PIPELINE_ELEMENTS_PROPERTIES_FORMAT  "/pipelines/%s/elements/%s/properties"
 #define PIPELINE_ELEMENTS_PROPERTY_FORMAT    "/pipelines/%s/elements/%s/properties/%s"
@@ -77,7 +85,16 @@
 
 #define SEEK_FORMAT        "seek %f %d %d %d %lld %d %lld"
 #define FLUSH_STOP_FORMAT  "flush_stop %s"
-#define TIMEOUT_FORMAT  "%lli"
+
+/* A sequence number ahead of any the daemon retains, reads from it
+ * wait for the next message posted */
+#define BUS_SEQ_NEXT "18446744073709551614"
+
+/* Gst client batch formats, operations go one per line */
+#define BATCH_FORMAT                "batch %s"
+#define BATCH_STOP_ON_ERROR         "stop_on_error"
+#define BATCH_ELEMENT_SET_FORMAT    "element_set %s %s %s %s"
+#define BATCH_PIPELINE_STATE_FORMAT "pipeline_%s %s"
 
 
 static GstcStatus gstc_cmd_send (GstClient * client, const char *request);
@@ -93,7 +110,29 @@ static GstcStatus gstc_cmd_delete (GstClient * client, const char *where,
     const char *what);
 static GstcStatus gstc_cmd_change_state (GstClient * client, const char *pipe,
     const char *state);
-static GstcStatus gstc_response_get_code (const char *response, int *code);
+static GstcStatus gstc_response_get_code (GstClient * client,
+    const char *response, int *code);
+static GstcStatus gstc_response_child_string (GstClient * client,
+    const char *response, const char *parent_name, const char *data_name,
+    char **out);
+static GstcStatus gstc_response_get_child_char_array (GstClient * client,
+    const char *response, const char *parent_name, const char *array_name,
+    const char *element_name, char **out[], int *array_lenght);
+static GstcStatus gstc_response_get_child_int_array (GstClient * client,
+    const char *response, const char *parent_name, const char *array_name,
+    int *out, int max_lenght, int *array_lenght);
+static GstcStatus gstc_client_open (GstClient * client, GstcSocket ** socket);
+static GstcStatus gstc_client_acquire (GstClient * client, int *slot,
+    GstcSocket ** socket);
+static void gstc_client_release (GstClient * client, const int slot,
+    const int discard);
+static GstcStatus gstc_client_collect (GstClient * client,
+    GstcSocket * socket);
+static GstcStatus gstc_cmd_send_socket (GstClient * client,
+    GstcSocket * socket, const char *request, char **response,
+    const int timeout);
+static GstcStatus gstc_batch_append (GstcBatch * batch,
+    const char *operation);
 static void *gstc_bus_thread (void *user_data);
 static GstcStatus
 gstc_pipeline_bus_wait_callback (GstClient * _client, const char *pipeline_name,
@@ -102,8 +141,37 @@ gstc_pipeline_bus_wait_callback (GstClient * _client, const char *pipeline_name,
 
 struct _GstClient
 {
-  GstcSocket *socket;
+  char *address;
+  unsigned int port;
+  int keep_connection_open;
   int timeout;
+
+  /* Guards the fields below */
+  GstcMutex lock;
+  /* Broadcast every time a connection is released */
+  GstcCond released;
+
+  /* Connections are opened on demand, a thread checks one out for
+   * each request so they are never used concurrently */
+  GstcSocket **sockets;
+  int *busy;
+  unsigned int slots;
+  unsigned int max_connections;
+
+  /* 1 if pipelining is available, -1 if not, 0 if not tried yet */
+  int framing;
+  /* First failure among the pipelined requests */
+  GstcStatus async_status;
+  /* 1 if the connections were switched to CBOR */
+  int cbor;
+};
+
+struct _GstcBatch
+{
+  /* The batch command, operations are appended one per line */
+  char *request;
+  size_t size;
+  int length;
 };
 
 typedef struct _GstcThreadData GstcThreadData;
@@ -128,33 +196,229 @@ struct _GstcSyncBusData
 };
 
 static GstcStatus
-gstc_response_get_code (const char *response, int *code)
+gstc_response_get_code (GstClient * client, const char *response, int *code)
 {
   const char *code_field_name = "code";
 
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
   gstc_assert_and_ret_val (NULL != response, GSTC_NULL_ARGUMENT);
   gstc_assert_and_ret_val (NULL != code, GSTC_NULL_ARGUMENT);
 
+  if (client->cbor) {
+    return gstc_cbor_get_int (response, code_field_name, code);
+  }
+
   return gstc_json_get_int (response, code_field_name, code);
 }
 
+/*
+ * Responses are JSON unless the client switched to CBOR
+ */
 static GstcStatus
-gstc_cmd_send_get_response (GstClient * client, const char *request,
-    char **response, const int timeout)
+gstc_response_child_string (GstClient * client, const char *response,
+    const char *parent_name, const char *data_name, char **out)
+{
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+
+  if (client->cbor) {
+    return gstc_cbor_child_string (response, parent_name, data_name, out);
+  }
+
+  return gstc_json_child_string (response, parent_name, data_name, out);
+}
+
+static GstcStatus
+gstc_response_get_child_char_array (GstClient * client, const char *response,
+    const char *parent_name, const char *array_name,
+    const char *element_name, char **out[], int *array_lenght)
+{
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+
+  if (client->cbor) {
+    return gstc_cbor_get_child_char_array (response, parent_name,
+        array_name, element_name, out, array_lenght);
+  }
+
+  return gstc_json_get_child_char_array (response, parent_name, array_name,
+      element_name, out, array_lenght);
+}
+
+static GstcStatus
+gstc_response_get_child_int_array (GstClient * client, const char *response,
+    const char *parent_name, const char *array_name, int *out,
+    int max_lenght, int *array_lenght)
+{
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+
+  if (client->cbor) {
+    return gstc_cbor_get_child_int_array (response, parent_name, array_name,
+        out, max_lenght, array_lenght);
+  }
+
+  return gstc_json_get_child_int_array (response, parent_name, array_name,
+      out, max_lenght, array_lenght);
+}
+
+/*
+ * Opens a new connection, in the encoding the client is using
+ */
+static GstcStatus
+gstc_client_open (GstClient * client, GstcSocket ** socket)
+{
+  GstcStatus ret;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != socket, GSTC_NULL_ARGUMENT);
+
+  ret = gstc_socket_new (client->address, client->port,
+      client->keep_connection_open, socket);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  if (client->cbor) {
+    ret = gstc_socket_enable_cbor (*socket, client->timeout);
+    if (GSTC_OK != ret) {
+      gstc_socket_free (*socket);
+      *socket = NULL;
+    }
+  }
+
+  return ret;
+}
+
+/*
+ * Checks out a connection, waiting for one to be released if they are
+ * all busy. With ANY_CONNECTION in @slot an idle connection is taken,
+ * or a new one is opened if there is room, and @slot is set to the one
+ * to release. Otherwise @socket is the connection in @slot, NULL if it
+ * was never opened.
+ */
+static GstcStatus
+gstc_client_acquire (GstClient * client, int *slot, GstcSocket ** socket)
+{
+  GstcStatus ret = GSTC_OK;
+  unsigned int i;
+  int empty;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != slot, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != socket, GSTC_NULL_ARGUMENT);
+
+  gstc_mutex_lock (&(client->lock));
+
+  if (ANY_CONNECTION != *slot) {
+    while (client->busy[*slot]) {
+      gstc_cond_wait (&(client->released), &(client->lock));
+    }
+    client->busy[*slot] = 1;
+    *socket = client->sockets[*slot];
+    gstc_mutex_unlock (&(client->lock));
+
+    return GSTC_OK;
+  }
+
+  while (ANY_CONNECTION == *slot) {
+    empty = ANY_CONNECTION;
+
+    for (i = 0; i < client->max_connections; i++) {
+      if (client->busy[i]) {
+        continue;
+      }
+      if (NULL != client->sockets[i]) {
+        *slot = i;
+        break;
+      }
+      if (ANY_CONNECTION == empty) {
+        empty = i;
+      }
+    }
+
+    if (ANY_CONNECTION == *slot) {
+      if (ANY_CONNECTION != empty) {
+        *slot = empty;
+      } else {
+        gstc_cond_wait (&(client->released), &(client->lock));
+      }
+    }
+  }
+
+  client->busy[*slot] = 1;
+  *socket = client->sockets[*slot];
+
+  gstc_mutex_unlock (&(client->lock));
+
+  if (NULL != *socket) {
+    return GSTC_OK;
+  }
+
+  /* Connecting may take a while, the slot is reserved meanwhile */
+  ret = gstc_client_open (client, socket);
+
+  gstc_mutex_lock (&(client->lock));
+  if (GSTC_OK == ret) {
+    client->sockets[*slot] = *socket;
+  } else {
+    client->busy[*slot] = 0;
+    gstc_cond_broadcast (&(client->released));
+  }
+  gstc_mutex_unlock (&(client->lock));
+
+  return ret;
+}
+
+/*
+ * Gives back a connection checked out with gstc_client_acquire(). If
+ * @discard is set, or there are too many connections, it is closed and
+ * a new one will be opened when needed.
+ */
+static void
+gstc_client_release (GstClient * client, const int slot, const int discard)
+{
+  GstcSocket *socket = NULL;
+
+  gstc_assert_and_ret (NULL != client);
+
+  gstc_mutex_lock (&(client->lock));
+
+  if (discard || (unsigned int) slot >= client->max_connections) {
+    socket = client->sockets[slot];
+    client->sockets[slot] = NULL;
+  }
+  client->busy[slot] = 0;
+  gstc_cond_broadcast (&(client->released));
+
+  gstc_mutex_unlock (&(client->lock));
+
+  if (NULL != socket) {
+    gstc_socket_free (socket);
+  }
+}
+
+static GstcStatus
+gstc_cmd_send_socket (GstClient * client, GstcSocket * socket,
+    const char *request, char **response, const int timeout)
 {
   GstcStatus ret;
   int code = GSTC_NOT_FOUND;
 
   gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != socket, GSTC_NULL_ARGUMENT);
   gstc_assert_and_ret_val (NULL != request, GSTC_NULL_ARGUMENT);
   gstc_assert_and_ret_val (NULL != response, GSTC_NULL_ARGUMENT);
 
-  ret = gstc_socket_send (client->socket, request, response, timeout);
+  /* Pipelined replies come first, keep their status for gstc_client_sync */
+  ret = gstc_client_collect (client, socket);
   if (GSTC_OK != ret) {
     goto out;
   }
 
-  ret = gstc_response_get_code (*response, &code);
+  ret = gstc_socket_send (socket, request, response, timeout);
+  if (GSTC_OK != ret) {
+    goto out;
+  }
+
+  ret = gstc_response_get_code (client, *response, &code);
   if (GSTC_OK != ret) {
     goto out;
   }
@@ -166,6 +430,32 @@ out:
   return ret;
 }
 
+static GstcStatus
+gstc_cmd_send_get_response (GstClient * client, const char *request,
+    char **response, const int timeout)
+{
+  GstcStatus ret;
+  GstcSocket *socket;
+  int slot = ANY_CONNECTION;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != request, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != response, GSTC_NULL_ARGUMENT);
+
+  *response = NULL;
+
+  ret = gstc_client_acquire (client, &slot, &socket);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  ret = gstc_cmd_send_socket (client, socket, request, response, timeout);
+
+  gstc_client_release (client, slot, 0);
+
+  return ret;
+}
+
 static GstcStatus
 gstc_cmd_send (GstClient * client, const char *request)
 {
@@ -183,6 +473,44 @@ gstc_cmd_send (GstClient * client, const char *request)
   return ret;
 }
 
+/*
+ * Reads the pipelined replies pending in @socket, which must be
+ * checked out by the calling thread
+ */
+static GstcStatus
+gstc_client_collect (GstClient * client, GstcSocket * socket)
+{
+  GstcStatus ret = GSTC_OK;
+  unsigned int id;
+  char *response;
+  int code;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != socket, GSTC_NULL_ARGUMENT);
+
+  while (gstc_socket_get_pending (socket) > 0) {
+    ret = gstc_socket_receive (socket, &id, &response, client->timeout);
+    if (GSTC_OK != ret) {
+      break;
+    }
+
+    code = GSTC_NOT_FOUND;
+    ret = gstc_response_get_code (client, response, &code);
+    free (response);
+    if (GSTC_OK != ret) {
+      break;
+    }
+
+    gstc_mutex_lock (&(client->lock));
+    if (GSTC_OK != code && GSTC_OK == client->async_status) {
+      client->async_status = code;
+    }
+    gstc_mutex_unlock (&(client->lock));
+  }
+
+  return ret;
+}
+
 static GstcStatus
 gstc_cmd_create (GstClient * client, const char *where, const char *what)
 {
@@ -296,17 +624,151 @@ gstc_client_new (const char *address, const unsigned int port,
     return GSTC_OOM;
   }
 
+  client->address = strdup (address);
+  client->port = port;
+  client->keep_connection_open = keep_connection_open;
   client->timeout = wait_time;
+  client->slots = GSTC_DEFAULT_MAX_CONNECTIONS;
+  client->max_connections = GSTC_DEFAULT_MAX_CONNECTIONS;
+  client->sockets =
+      (GstcSocket **) calloc (client->slots, sizeof (GstcSocket *));
+  client->busy = (int *) calloc (client->slots, sizeof (int));
+  client->framing = 0;
+  client->async_status = GSTC_OK;
+  client->cbor = 0;
+
+  if (NULL == client->address || NULL == client->sockets
+      || NULL == client->busy) {
+    ret = GSTC_OOM;
+    goto free_client;
+  }
 
-  ret =
-      gstc_socket_new (address, port, keep_connection_open, &(client->socket));
+  gstc_mutex_init (&(client->lock));
+  gstc_cond_init (&(client->released));
+
+  /* Open the first connection right away to report an unreachable daemon */
+  ret = gstc_client_open (client, &(client->sockets[0]));
   if (GSTC_OK != ret) {
-    free (client);
-    return ret;
+    goto free_client;
   }
 
   *out = client;
 
+  return ret;
+
+free_client:
+  free (client->busy);
+  free (client->sockets);
+  free (client->address);
+  free (client);
+
+  return ret;
+}
+
+GstcStatus
+gstc_client_set_max_connections (GstClient * client,
+    unsigned int max_connections)
+{
+  GstcSocket **sockets;
+  int *busy;
+  unsigned int i;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+
+  if (0 == max_connections) {
+    return GSTC_TYPE_ERROR;
+  }
+
+  gstc_mutex_lock (&(client->lock));
+
+  if (max_connections > client->slots) {
+    sockets = (GstcSocket **) realloc (client->sockets,
+        max_connections * sizeof (GstcSocket *));
+    if (NULL == sockets) {
+      gstc_mutex_unlock (&(client->lock));
+      return GSTC_OOM;
+    }
+    client->sockets = sockets;
+
+    busy = (int *) realloc (client->busy, max_connections * sizeof (int));
+    if (NULL == busy) {
+      gstc_mutex_unlock (&(client->lock));
+      return GSTC_OOM;
+    }
+    client->busy = busy;
+
+    for (i = client->slots; i < max_connections; i++) {
+      client->sockets[i] = NULL;
+      client->busy[i] = 0;
+    }
+    client->slots = max_connections;
+  }
+
+  /* Connections beyond the limit are closed as they are released */
+  for (i = max_connections; i < client->max_connections; i++) {
+    if (!client->busy[i] && NULL != client->sockets[i]) {
+      gstc_socket_free (client->sockets[i]);
+      client->sockets[i] = NULL;
+    }
+  }
+
+  client->max_connections = max_connections;
+
+  /* Threads waiting for a connection may open a new one now */
+  gstc_cond_broadcast (&(client->released));
+
+  gstc_mutex_unlock (&(client->lock));
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_client_set_encoding (GstClient * client, GstcEncoding encoding)
+{
+  GstcStatus ret;
+  GstcSocket *socket;
+  unsigned int slots;
+  unsigned int i;
+  int slot = ANY_CONNECTION;
+  int discard;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+
+  if (GSTC_ENCODING_JSON == encoding) {
+    /* JSON is only available if CBOR was never enabled */
+    return 1 == client->cbor ? GSTC_UNSUPPORTED : GSTC_OK;
+  }
+
+  gstc_assert_and_ret_val (GSTC_ENCODING_CBOR == encoding, GSTC_TYPE_ERROR);
+
+  /* Find out if the daemon takes CBOR before committing to it */
+  ret = gstc_client_acquire (client, &slot, &socket);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  ret = gstc_socket_enable_cbor (socket, client->timeout);
+  gstc_client_release (client, slot, 0);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  gstc_mutex_lock (&(client->lock));
+  client->cbor = 1;
+  client->framing = 1;
+  slots = client->slots;
+  gstc_mutex_unlock (&(client->lock));
+
+  /* Switch the other connections too, those that can't be switched
+   * are opened again */
+  for (i = 0; i < slots; i++) {
+    slot = i;
+    gstc_client_acquire (client, &slot, &socket);
+    discard = NULL != socket
+        && GSTC_OK != gstc_socket_enable_cbor (socket, client->timeout);
+    gstc_client_release (client, slot, discard);
+  }
+
   return ret;
 }
 
@@ -551,7 +1013,8 @@ gst_pipeline_get_state (GstClient * client, const char *pipeline_name,
     goto unref;
   }
 
-  ret = gstc_json_child_string (response, "response", "value", out);
+  ret = gstc_response_child_string (client, response, "response", "value",
+      out);
 
   free (response);
 
@@ -587,9 +1050,19 @@ gstc_pipeline_verbose (GstClient * client, const char *pipeline_name,
 void
 gstc_client_free (GstClient * client)
 {
+  unsigned int i;
+
   gstc_assert_and_ret (NULL != client);
 
-  gstc_socket_free (client->socket);
+  for (i = 0; i < client->slots; i++) {
+    if (NULL != client->sockets[i]) {
+      gstc_socket_free (client->sockets[i]);
+    }
+  }
+
+  free (client->busy);
+  free (client->sockets);
+  free (client->address);
   free (client);
 }
 
@@ -675,7 +1148,8 @@ gstc_element_get (GstClient * client, const char *pname,
     goto unref;
   }
 
-  ret = gstc_json_child_string (response, "response", "value", &out);
+  ret = gstc_response_child_string (client, response, "response", "value",
+      &out);
   if (ret != GSTC_OK) {
     goto unref_response;
   }
@@ -725,6 +1199,336 @@ gstc_element_set (GstClient * client, const char *pname,
   return GSTC_OK;
 }
 
+GstcStatus
+gstc_element_set_async (GstClient * client, const char *pname,
+    const char *element, const char *parameter, const char *format, ...)
+{
+  GstcStatus ret;
+  va_list ap;
+  int asprintf_ret;
+  unsigned int id;
+  int framing;
+  int slot = ANY_CONNECTION;
+  GstcSocket *socket;
+  char *what;
+  char *how;
+  char *request;
+  char *response = NULL;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != pname, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != element, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != parameter, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != format, GSTC_NULL_ARGUMENT);
+
+  va_start (ap, format);
+  asprintf_ret = vasprintf (&how, format, ap);
+  va_end (ap);
+  if (PRINTF_ERROR == asprintf_ret) {
+    return GSTC_OOM;
+  }
+
+  asprintf_ret =
+      asprintf (&what, PIPELINE_ELEMENTS_PROPERTY_FORMAT, pname, element,
+      parameter);
+  if (PRINTF_ERROR == asprintf_ret) {
+    ret = GSTC_OOM;
+    goto free_how;
+  }
+
+  asprintf_ret = asprintf (&request, UPDATE_FORMAT, what, how);
+  if (PRINTF_ERROR == asprintf_ret) {
+    ret = GSTC_OOM;
+    goto free_what;
+  }
+
+  ret = gstc_client_acquire (client, &slot, &socket);
+  if (GSTC_OK != ret) {
+    goto free_request;
+  }
+
+  gstc_mutex_lock (&(client->lock));
+  framing = client->framing;
+  gstc_mutex_unlock (&(client->lock));
+
+  /* Each connection is switched the first time it is used for this */
+  if (-1 != framing) {
+    ret = gstc_socket_enable_framing (socket, client->timeout);
+    if (GSTC_OK == ret) {
+      framing = 1;
+    } else if (GSTC_UNSUPPORTED == ret) {
+      framing = -1;
+    } else {
+      /* The connection failed, not the daemon, try again next time */
+      framing = 0;
+    }
+
+    gstc_mutex_lock (&(client->lock));
+    if (0 != framing) {
+      client->framing = framing;
+    }
+    gstc_mutex_unlock (&(client->lock));
+  }
+
+  if (1 == framing) {
+    ret = gstc_socket_submit (socket, request, &id);
+  } else {
+    /* No pipelining available, record the outcome for gstc_client_sync */
+    ret = gstc_cmd_send_socket (client, socket, request, &response,
+        client->timeout);
+    free (response);
+    if (ret > 0) {
+      gstc_mutex_lock (&(client->lock));
+      if (GSTC_OK == client->async_status) {
+        client->async_status = ret;
+      }
+      gstc_mutex_unlock (&(client->lock));
+      ret = GSTC_OK;
+    }
+  }
+
+  gstc_client_release (client, slot, 0);
+
+free_request:
+  free (request);
+free_what:
+  free (what);
+free_how:
+  free (how);
+
+  return ret;
+}
+
+GstcStatus
+gstc_client_sync (GstClient * client)
+{
+  GstcStatus ret = GSTC_OK;
+  GstcStatus collect_ret;
+  GstcSocket *socket;
+  unsigned int slots;
+  unsigned int i;
+  int slot;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+
+  gstc_mutex_lock (&(client->lock));
+  slots = client->slots;
+  gstc_mutex_unlock (&(client->lock));
+
+  /* Requests may have been pipelined over any of the connections */
+  for (i = 0; i < slots; i++) {
+    slot = i;
+    gstc_client_acquire (client, &slot, &socket);
+    if (NULL != socket) {
+      collect_ret = gstc_client_collect (client, socket);
+      if (GSTC_OK == ret) {
+        ret = collect_ret;
+      }
+    }
+    gstc_client_release (client, slot, 0);
+  }
+
+  gstc_mutex_lock (&(client->lock));
+  if (GSTC_OK == ret) {
+    ret = client->async_status;
+  }
+  client->async_status = GSTC_OK;
+  gstc_mutex_unlock (&(client->lock));
+
+  return ret;
+}
+
+GstcStatus
+gstc_batch_new (GstcBatch ** batch, int stop_on_error)
+{
+  int asprintf_ret;
+  char *request;
+
+  gstc_assert_and_ret_val (NULL != batch, GSTC_NULL_ARGUMENT);
+
+  *batch = (GstcBatch *) malloc (sizeof (GstcBatch));
+  if (NULL == *batch) {
+    return GSTC_OOM;
+  }
+
+  asprintf_ret = asprintf (&request, BATCH_FORMAT,
+      stop_on_error ? BATCH_STOP_ON_ERROR : "");
+  if (PRINTF_ERROR == asprintf_ret) {
+    free (*batch);
+    *batch = NULL;
+    return GSTC_OOM;
+  }
+
+  (*batch)->request = request;
+  (*batch)->size = asprintf_ret;
+  (*batch)->length = 0;
+
+  return GSTC_OK;
+}
+
+/*
+ * Adds @operation as a new line of the batch command
+ */
+static GstcStatus
+gstc_batch_append (GstcBatch * batch, const char *operation)
+{
+  size_t len;
+  char *request;
+
+  gstc_assert_and_ret_val (NULL != batch, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != operation, GSTC_NULL_ARGUMENT);
+
+  /* The daemon splits the operations at newlines */
+  if (NULL != strchr (operation, '\n')) {
+    return GSTC_MALFORMED;
+  }
+
+  len = strlen (operation);
+  request = (char *) realloc (batch->request, batch->size + len + 2);
+  if (NULL == request) {
+    return GSTC_OOM;
+  }
+
+  request[batch->size] = '\n';
+  memcpy (request + batch->size + 1, operation, len + 1);
+
+  batch->request = request;
+  batch->size += len + 1;
+  batch->length++;
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_batch_add (GstcBatch * batch, const char *format, ...)
+{
+  GstcStatus ret;
+  va_list ap;
+  int asprintf_ret;
+  char *operation;
+
+  gstc_assert_and_ret_val (NULL != batch, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != format, GSTC_NULL_ARGUMENT);
+
+  va_start (ap, format);
+  asprintf_ret = vasprintf (&operation, format, ap);
+  va_end (ap);
+  if (PRINTF_ERROR == asprintf_ret) {
+    return GSTC_OOM;
+  }
+
+  ret = gstc_batch_append (batch, operation);
+  free (operation);
+
+  return ret;
+}
+
+GstcStatus
+gstc_batch_element_set (GstcBatch * batch, const char *pname,
+    const char *element, const char *parameter, const char *format, ...)
+{
+  GstcStatus ret;
+  va_list ap;
+  int asprintf_ret;
+  char *how;
+
+  gstc_assert_and_ret_val (NULL != batch, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != pname, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != element, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != parameter, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != format, GSTC_NULL_ARGUMENT);
+
+  va_start (ap, format);
+  asprintf_ret = vasprintf (&how, format, ap);
+  va_end (ap);
+  if (PRINTF_ERROR == asprintf_ret) {
+    return GSTC_OOM;
+  }
+
+  ret = gstc_batch_add (batch, BATCH_ELEMENT_SET_FORMAT, pname, element,
+      parameter, how);
+  free (how);
+
+  return ret;
+}
+
+GstcStatus
+gstc_batch_pipeline_play (GstcBatch * batch, const char *pipeline_name)
+{
+  gstc_assert_and_ret_val (NULL != pipeline_name, GSTC_NULL_ARGUMENT);
+
+  return gstc_batch_add (batch, BATCH_PIPELINE_STATE_FORMAT, "play",
+      pipeline_name);
+}
+
+GstcStatus
+gstc_batch_pipeline_pause (GstcBatch * batch, const char *pipeline_name)
+{
+  gstc_assert_and_ret_val (NULL != pipeline_name, GSTC_NULL_ARGUMENT);
+
+  return gstc_batch_add (batch, BATCH_PIPELINE_STATE_FORMAT, "pause",
+      pipeline_name);
+}
+
+GstcStatus
+gstc_batch_pipeline_stop (GstcBatch * batch, const char *pipeline_name)
+{
+  gstc_assert_and_ret_val (NULL != pipeline_name, GSTC_NULL_ARGUMENT);
+
+  return gstc_batch_add (batch, BATCH_PIPELINE_STATE_FORMAT, "stop",
+      pipeline_name);
+}
+
+int
+gstc_batch_get_length (GstcBatch * batch)
+{
+  gstc_assert_and_ret_val (NULL != batch, 0);
+
+  return batch->length;
+}
+
+GstcStatus
+gstc_batch_execute (GstClient * client, GstcBatch * batch, int *codes,
+    int *executed)
+{
+  GstcStatus ret;
+  GstcStatus parse_ret;
+  char *response = NULL;
+  int length = 0;
+
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != batch, GSTC_NULL_ARGUMENT);
+
+  ret = gstc_cmd_send_get_response (client, batch->request, &response,
+      client->timeout);
+
+  /* The codes are there even if an operation failed */
+  if (NULL != response) {
+    parse_ret = gstc_response_get_child_int_array (client, response,
+        "response", "codes", codes, codes ? batch->length : 0, &length);
+    if (GSTC_OK == ret && GSTC_OK != parse_ret) {
+      ret = parse_ret;
+    }
+  }
+
+  if (NULL != executed) {
+    *executed = length;
+  }
+
+  free (response);
+
+  return ret;
+}
+
+void
+gstc_batch_free (GstcBatch * batch)
+{
+  gstc_assert_and_ret (NULL != batch);
+
+  free (batch->request);
+  free (batch);
+}
+
 GstcStatus
 gstc_pipeline_flush_start (GstClient * client, const char *pipeline_name)
 {
@@ -810,8 +1614,8 @@ gstc_element_properties_list (GstClient * client,
     goto out;
   }
 
-  ret = gstc_json_get_child_char_array (response, "response", "nodes",
-      "name", properties, list_lenght);
+  ret = gstc_response_get_child_char_array (client, response, "response",
+      "nodes", "name", properties, list_lenght);
 
   free (response);
 
@@ -897,8 +1701,8 @@ gstc_pipeline_list_elements (GstClient * client,
   }
 
   ret =
-      gstc_json_get_child_char_array (response, "response", "nodes", "name",
-      elements, list_lenght);
+      gstc_response_get_child_char_array (client, response, "response",
+      "nodes", "name", elements, list_lenght);
 
   free (response);
 
@@ -912,25 +1716,36 @@ static void *
 gstc_bus_thread (void *user_data)
 {
   GstcThreadData *data = (GstcThreadData *) user_data;
+  GstcSocket *socket;
   int asprintf_ret;
-  char *where;
-  char *response;
+  char *request;
+  char *response = NULL;
   const char *pipeline_name = data->pipeline_name;
   const char *message_name = data->message;
   long long timeout = data->timeout;
   GstClient *client = data->client;
 
-  asprintf_ret = asprintf (&where, PIPELINE_BUS_MSG_FORMAT, pipeline_name);
+  /* The filter and the timeout go with the read, concurrent waits on
+   * the same pipeline don't overwrite each other's */
+  asprintf_ret = asprintf (&request, PIPELINE_BUS_READ_SINCE_FORMAT,
+      pipeline_name, BUS_SEQ_NEXT, message_name, timeout);
   if (PRINTF_ERROR == asprintf_ret) {
+    free (data);
     return NULL;
   }
 
-  /* -1 is used in this function so that the socket has an unlimited timeout */
-  gstc_cmd_read (client, where, &response, -1);
+  /* The wait may be long, it gets a connection of its own instead of
+   * holding one the other threads could use */
+  if (GSTC_OK == gstc_client_open (client, &socket)) {
+    /* -1 is used in this function so that the socket has an unlimited timeout */
+    gstc_cmd_send_socket (client, socket, request, &response, -1);
+    gstc_socket_free (socket);
+  }
+
   data->func (client, pipeline_name, message_name, timeout, response,
       data->user_data);
 
-  free (where);
+  free (request);
   free (response);
   free (data);
 
@@ -943,41 +1758,20 @@ gstc_pipeline_bus_wait_async (GstClient * client,
     const long long timeout, GstcPipelineBusWaitCallback callback,
     void *user_data)
 {
-  int asprintf_ret;
   GstcThreadData *data;
   GstcThread thread;
-  char *where_timeout;
-  char *where_types;
-  char *how_timeout;
-  const char *what_timeout = "timeout";
-  const char *what_types = "types";
-  GstcStatus ret = GSTC_OK;
-
-  asprintf_ret =
-      asprintf (&where_timeout, PIPELINE_BUS_FORMAT, pipeline_name,
-      what_timeout);
-  if (PRINTF_ERROR == asprintf_ret) {
-    ret = GSTC_OOM;
-    goto out;
-  }
+  GstcStatus ret;
 
-  asprintf_ret = asprintf (&how_timeout, TIMEOUT_FORMAT, timeout);
-  if (PRINTF_ERROR == asprintf_ret) {
-    ret = GSTC_OOM;
-    goto free_where;
-  }
+  gstc_assert_and_ret_val (NULL != client, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != pipeline_name, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != message_name, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != callback, GSTC_NULL_ARGUMENT);
 
-  asprintf_ret =
-      asprintf (&where_types, PIPELINE_BUS_FORMAT, pipeline_name, what_types);
-  if (PRINTF_ERROR == asprintf_ret) {
-    ret = GSTC_OOM;
-    goto free_how;
+  data = malloc (sizeof (GstcThreadData));
+  if (NULL == data) {
+    return GSTC_OOM;
   }
 
-  gstc_cmd_update (client, where_types, message_name);
-  gstc_cmd_update (client, where_timeout, how_timeout);
-
-  data = malloc (sizeof (GstcThreadData));
   data->client = client;
   data->pipeline_name = pipeline_name;
   data->message = message_name;
@@ -985,16 +1779,10 @@ gstc_pipeline_bus_wait_async (GstClient * client,
   data->user_data = user_data;
   data->timeout = timeout;
   ret = gstc_thread_new (&thread, gstc_bus_thread, data);
+  if (GSTC_OK != ret) {
+    free (data);
+  }
 
-  free (where_types);
-
-free_how:
-  free (how_timeout);
-
-free_where:
-  free (where_timeout);
-
-out:
   return ret;
 }
 
@@ -1011,24 +1799,41 @@ gstc_pipeline_bus_wait_callback (GstClient * _client, const char *pipeline_name,
 {
   GstcSyncBusData *data = (GstcSyncBusData *) user_data;
   GstcStatus ret = GSTC_OK;
-  const int msglen = strlen (message) + 1;
   const char *response_tag = "response";
-  int is_null;
+  char **types = NULL;
+  int msglen;
+  int count = 0;
+  int i;
 
   gstc_mutex_lock (&(data->mutex));
   data->waiting = 0;
+
+  /* The daemon couldn't be reached */
+  if (NULL == message) {
+    data->message = NULL;
+    data->ret = GSTC_RECV_ERROR;
+    goto out;
+  }
+
+  msglen = strlen (message) + 1;
   data->message = (char *) malloc (msglen);
   memcpy (data->message, message, msglen);
 
-  /* If a valid string was received, a valid bus message was received.
-     Otherwise, a timeout occurred */
-  ret = gstc_json_is_null (message, response_tag, &is_null);
+  /* The read holds the message if one arrived in time. Otherwise, a
+     timeout occurred */
+  ret = gstc_response_get_child_char_array (_client, message, response_tag,
+      "messages", "type", &types, &count);
   if (GSTC_OK == ret) {
-    data->ret = is_null ? GSTC_BUS_TIMEOUT : ret;
+    data->ret = 0 == count ? GSTC_BUS_TIMEOUT : ret;
+    for (i = 0; i < count; i++) {
+      free (types[i]);
+    }
+    free (types);
   } else {
     data->ret = ret;
   }
 
+out:
   gstc_cond_signal (&(data->cond));
   gstc_mutex_unlock (&(data->mutex));
 
@@ -1080,8 +1885,8 @@ gstc_pipeline_list (GstClient * client, char **pipelines[], int *list_lenght)
     goto out;
   }
 
-  ret = gstc_json_get_child_char_array (response, "response", "nodes",
-      "name", pipelines, list_lenght);
+  ret = gstc_response_get_child_char_array (client, response, "response",
+      "nodes", "name", pipelines, list_lenght);
 
   free (response);
 
@@ -1137,8 +1942,8 @@ gstc_pipeline_list_signals (GstClient * client, const char *pipeline_name,
     goto out;
   }
 
-  ret = gstc_json_get_child_char_array (response, "response", "nodes",
-      "name", signals, list_lenght);
+  ret = gstc_response_get_child_char_array (client, response, "response",
+      "nodes", "name", signals, list_lenght);
 
   free (response);
 
@@ -59,7 +59,11 @@
  *     method is passed. To remove a function from the call back list,
  *     the call back function should return a value of zero.
  *
- * 3 ) Because of the lack of polymoriphism in the C programming
+ * 3 ) A #GstClient may be shared by several threads. Each request
+ *     checks out one of the client's connections, see
+ *     gstc_client_set_max_connections().
+ *
+ * 4 ) Because of the lack of polymoriphism in the C programming
  *     language, values passed into or out of the API are essientally
  *     strings.  Because the calling application know the datatype,
  *     the calling application handles the data conversion.  To make
@@ -102,6 +106,8 @@ extern "C"
  * @GSTC_BUS_TIMEOUT: A timeout was received while waiting on the bus
  * @GSTC_LONG_RESPONSE: The response exceeds our maximum, typically
  * meaning a missing null terminator
+ * @GSTC_UNSUPPORTED: The operation is not supported by the daemon or
+ * the connection mode
  *
  * Return codes for the different libgstc operations
  */
@@ -121,7 +127,8 @@ typedef enum
   GSTC_THREAD_ERROR = -11,
   GSTC_BUS_TIMEOUT = -12,
   GSTC_SOCKET_TIMEOUT = -13,
-  GSTC_LONG_RESPONSE = -14
+  GSTC_LONG_RESPONSE = -14,
+  GSTC_UNSUPPORTED = -15
 } GstcStatus;
 
 /**
@@ -137,7 +144,7 @@ typedef struct _GstClient GstClient;
  * @wait_time: time to wait in milliseconds for a response from the daemon
  * before returning an error, applies to all non-blocking gstc_* methods.
  * Zero returns immediately and negative means wait forever.
- * @keep_connection_open: if non-zero the underlying network socket
+ * @keep_connection_open: if non-zero the underlying network sockets
  * will be kept open until gstc_client_free() is called
  * @client: placeholder for newly allocated client.
  *
@@ -147,6 +154,11 @@ typedef struct _GstClient GstClient;
  * through @client. If an error occurs, the appropriate status is
  * returned and @client is not valid.
  *
+ * The client is thread safe. Connections are opened as concurrent
+ * requests need them, up to GSTC_DEFAULT_MAX_CONNECTIONS, and a
+ * persistent connection the daemon closed is opened again on its
+ * next use.
+ *
  * Returns: GstcStatus indicating success, daemon unreachable, out of
  * memory.
  */
@@ -165,6 +177,52 @@ GstcStatus gstc_client_new (const char *address, const unsigned int port,
 void
 gstc_client_free (GstClient *client);
 
+/**
+ * gstc_client_set_max_connections:
+ * @client: The client returned by gstc_client_new()
+ * @max_connections: Connections to the daemon the client may open
+ *
+ * Limits how many requests are in flight at the same time. Threads
+ * issuing a request while all the connections are busy wait for one
+ * to be released. Waiting for a bus message takes a connection of its
+ * own, outside of this limit.
+ *
+ * Returns: GstcStatus indicating success, out of memory, or
+ * GSTC_TYPE_ERROR if @max_connections is zero
+ */
+GstcStatus gstc_client_set_max_connections (GstClient *client,
+    unsigned int max_connections);
+
+/**
+ * GstcEncoding:
+ * @GSTC_ENCODING_JSON: Requests and responses are JSON text
+ * @GSTC_ENCODING_CBOR: Requests and responses are CBOR (RFC 8949)
+ *
+ * Encoding of the data exchanged with the daemon
+ */
+typedef enum
+{
+  GSTC_ENCODING_JSON,
+  GSTC_ENCODING_CBOR
+} GstcEncoding;
+
+/**
+ * gstc_client_set_encoding:
+ * @client: The client returned by gstc_client_new()
+ * @encoding: The encoding to use from now on
+ *
+ * Switches the connection to a compact binary encoding, which avoids
+ * formatting and parsing text on both ends. Requires a client created
+ * with keep_connection_open, and must be called before any *_async
+ * function since it also enables pipelining. Responses handed to the
+ * application, such as bus messages, are CBOR encoded as well.
+ *
+ * Returns: GstcStatus indicating success, daemon unreachable, daemon
+ * timeout, or GSTC_UNSUPPORTED if the connection can't be switched
+ */
+GstcStatus gstc_client_set_encoding (GstClient *client,
+    GstcEncoding encoding);
+
 /**
  * gstc_client_ping:
  * @client: The client returned by gstc_client_new()
@@ -399,6 +457,143 @@ GstcStatus gstc_element_get (GstClient *client, const char *pname,
 GstcStatus gstc_element_set(GstClient *client, const char *pname,
     const char *element, const char *parameter, const char *format, ...);
     
+/**
+ * gstc_element_set_async:
+ * @client: The client returned by gstc_client_new()
+ * @pipeline_name: Name associated with the pipeline
+ * @element_name: Element name to be set
+ * @property_name: Property name to be set
+ * @format: printf style format of the value, as in gstc_element_set()
+ * @...: Arguments for @format
+ *
+ * Sends a property update without waiting for the daemon to reply, so
+ * many updates can be in flight over the same connection. Requires a
+ * client created with keep_connection_open; the first call switches
+ * the connection to the framed protocol. If the connection is not
+ * persistent or the daemon doesn't support framing, the update is sent
+ * synchronously instead. Use gstc_client_sync() to collect the
+ * results.
+ *
+ * Returns: GstcStatus indicating whether the request was sent
+ */
+GstcStatus gstc_element_set_async(GstClient *client, const char *pname,
+    const char *element, const char *parameter, const char *format, ...);
+
+/**
+ * gstc_client_sync:
+ * @client: The client returned by gstc_client_new()
+ *
+ * Waits for the replies of every request sent by the *_async
+ * functions. Synchronous calls collect pending replies as well, in
+ * which case their status is kept until the next gstc_client_sync().
+ *
+ * Returns: GSTC_OK if every request succeeded, otherwise the status of
+ * the first one that failed
+ */
+GstcStatus gstc_client_sync(GstClient *client);
+
+/**
+ * GstcBatch:
+ * Opaque list of operations sent together by gstc_batch_execute()
+ */
+typedef struct _GstcBatch GstcBatch;
+
+/**
+ * gstc_batch_new:
+ * @batch: placeholder for the newly allocated batch
+ * @stop_on_error: if non-zero the daemon skips the operations after
+ * the first one that fails
+ *
+ * Creates an empty batch. Operations are queued locally and sent to
+ * the daemon in a single request, which runs them in order and
+ * resolves the elements shared by several of them only once.
+ *
+ * Returns: GstcStatus indicating success or out of memory
+ */
+GstcStatus gstc_batch_new (GstcBatch **batch, int stop_on_error);
+
+/**
+ * gstc_batch_add:
+ * @batch: The batch returned by gstc_batch_new()
+ * @format: printf style format of a full daemon command
+ * @...: Arguments for @format
+ *
+ * Queues any command understood by the daemon. Commands can't span
+ * several lines.
+ *
+ * Returns: GstcStatus indicating success, out of memory, or malformed
+ * if the command holds a newline
+ */
+GstcStatus gstc_batch_add (GstcBatch *batch, const char *format, ...);
+
+/**
+ * gstc_batch_element_set:
+ * @batch: The batch returned by gstc_batch_new()
+ * @pname: Name associated with the pipeline
+ * @element: Element name
+ * @parameter: Property name to be set
+ * @format: printf style format of the value, as in gstc_element_set()
+ * @...: Arguments for @format
+ *
+ * Queues a property update.
+ *
+ * Returns: GstcStatus indicating success, out of memory, or malformed
+ * if the value holds a newline
+ */
+GstcStatus gstc_batch_element_set (GstcBatch *batch, const char *pname,
+    const char *element, const char *parameter, const char *format, ...);
+
+/**
+ * gstc_batch_pipeline_play:
+ * @batch: The batch returned by gstc_batch_new()
+ * @pipeline_name: Name associated with the pipeline
+ *
+ * Queues a change of the pipeline to the playing state. The same goes
+ * for gstc_batch_pipeline_pause() and gstc_batch_pipeline_stop().
+ *
+ * Returns: GstcStatus indicating success or out of memory
+ */
+GstcStatus gstc_batch_pipeline_play (GstcBatch *batch,
+    const char *pipeline_name);
+GstcStatus gstc_batch_pipeline_pause (GstcBatch *batch,
+    const char *pipeline_name);
+GstcStatus gstc_batch_pipeline_stop (GstcBatch *batch,
+    const char *pipeline_name);
+
+/**
+ * gstc_batch_get_length:
+ * @batch: The batch returned by gstc_batch_new()
+ *
+ * Returns: The number of operations queued in @batch
+ */
+int gstc_batch_get_length (GstcBatch *batch);
+
+/**
+ * gstc_batch_execute:
+ * @client: The client returned by gstc_client_new()
+ * @batch: The batch to send
+ * @codes: (nullable): placeholder for the return code of each
+ * operation, with room for gstc_batch_get_length() entries
+ * @executed: (nullable): placeholder for the number of operations the
+ * daemon ran, fewer than queued if it stopped on an error
+ *
+ * Runs every operation in @batch with a single round trip. The batch
+ * is left untouched, so it can be sent again.
+ *
+ * Returns: GstcStatus indicating success, daemon unreachable, daemon
+ * timeout, or the code of the first operation that failed
+ */
+GstcStatus gstc_batch_execute (GstClient *client, GstcBatch *batch,
+    int *codes, int *executed);
+
+/**
+ * gstc_batch_free:
+ * @batch: The batch to free
+ *
+ * Releases the batch and its queued operations.
+ */
+void gstc_batch_free (GstcBatch *batch);
+
 /**
  * gstc_element_properties_list:
  * @client: The client returned by gstc_client_new()
@@ -529,6 +724,9 @@ GstcStatus gstc_pipeline_list_elements(GstClient *client, const char *pipeline_n
  * @message_name: The type of message to receive
  * @timeout: The amount of nanoseconds to wait for the event, or -1
  * for unlimited
+ * @message: The daemon response to the bus read, its "messages" hold
+ * the message received or are empty on timeout. NULL if the daemon
+ * couldn't be reached
  * @user_data: (allow none): A placeholder for custom data
  * 
  * The callback signature of the function to be registered in
@@ -553,7 +751,10 @@ typedef GstcStatus
  * @user_data: (allow none): A placeholder for custom data
  * 
  * Register a callback function to be called when a specific message
- * is received on the bus or a timeout ocurred.
+ * is received on the bus or a timeout ocurred. Only messages posted
+ * after the call are considered. The filter and the timeout belong to
+ * this wait alone, several waits may run on the same pipeline at once
+ * and each gets its own copy of the message.
  *
  * Returns: GstcStatus indicating success, thread error or timeout.
  */
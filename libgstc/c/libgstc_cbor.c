@@ -0,0 +1,594 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libgstc_assert.h"
+#include "libgstc_cbor.h"
+
+/* Self-described CBOR tag, see libgstd/gstd_cbor_writer.h */
+#define CBOR_MAGIC "\xd9\xd9\xf7"
+#define CBOR_MAGIC_SIZE (3)
+
+#define CBOR_UINT (0)
+#define CBOR_NEGINT (1)
+#define CBOR_BYTES (2)
+#define CBOR_TEXT (3)
+#define CBOR_ARRAY (4)
+#define CBOR_MAP (5)
+#define CBOR_TAG (6)
+#define CBOR_SIMPLE (7)
+
+#define CBOR_AI_1BYTE (24)
+#define CBOR_AI_8BYTES (27)
+#define CBOR_AI_INDEFINITE (31)
+
+#define CBOR_FALSE (0xf4)
+#define CBOR_TRUE (0xf5)
+#define CBOR_NULL (0xf6)
+#define CBOR_FLOAT32 (0xfa)
+#define CBOR_FLOAT64 (0xfb)
+#define CBOR_BREAK (0xff)
+
+/* Deepest nesting accepted when validating */
+#define CBOR_MAX_DEPTH (64)
+
+/* Validated data needs no bound */
+#define CBOR_NO_LIMIT ((size_t) -1)
+
+typedef struct _GstcCborHead GstcCborHead;
+struct _GstcCborHead
+{
+  unsigned char initial;
+  unsigned char major;
+  unsigned char info;
+  uint64_t value;
+};
+
+static int gstc_cbor_read_head (const unsigned char *data, size_t size,
+    size_t * pos, GstcCborHead * head);
+static int gstc_cbor_skip (const unsigned char *data, size_t size,
+    size_t * pos, unsigned int depth);
+static size_t gstc_cbor_root (const char *cbor);
+static GstcStatus gstc_cbor_find_member (const unsigned char *data,
+    size_t * pos, const char *name);
+static GstcStatus gstc_cbor_scalar_to_string (const unsigned char *data,
+    size_t pos, char **out);
+static GstcStatus gstc_cbor_read_int (const unsigned char *data,
+    size_t * pos, int *out);
+
+static int
+gstc_cbor_read_head (const unsigned char *data, size_t size, size_t * pos,
+    GstcCborHead * head)
+{
+  unsigned int len;
+  unsigned int i;
+
+  if (*pos >= size) {
+    return 0;
+  }
+
+  head->initial = data[*pos];
+  head->major = head->initial >> 5;
+  head->info = head->initial & 0x1f;
+  (*pos)++;
+
+  if (head->info < CBOR_AI_1BYTE || CBOR_AI_INDEFINITE == head->info) {
+    head->value = head->info;
+    return 1;
+  }
+
+  if (head->info > CBOR_AI_8BYTES) {
+    return 0;
+  }
+
+  len = 1 << (head->info - CBOR_AI_1BYTE);
+  if (size - *pos < len) {
+    return 0;
+  }
+
+  /* Big endian */
+  head->value = 0;
+  for (i = 0; i < len; i++) {
+    head->value = (head->value << 8) | data[*pos + i];
+  }
+  *pos += len;
+
+  return 1;
+}
+
+static int
+gstc_cbor_skip (const unsigned char *data, size_t size, size_t * pos,
+    unsigned int depth)
+{
+  GstcCborHead head;
+  uint64_t count;
+  uint64_t i;
+
+  if (depth > CBOR_MAX_DEPTH) {
+    return 0;
+  }
+
+  if (!gstc_cbor_read_head (data, size, pos, &head)) {
+    return 0;
+  }
+
+  if (CBOR_AI_INDEFINITE == head.info) {
+    if (head.major < CBOR_BYTES || head.major > CBOR_MAP) {
+      return 0;
+    }
+
+    while (*pos < size && CBOR_BREAK != data[*pos]) {
+      if (!gstc_cbor_skip (data, size, pos, depth + 1)) {
+        return 0;
+      }
+    }
+    if (*pos >= size) {
+      return 0;
+    }
+    (*pos)++;
+    return 1;
+  }
+
+  switch (head.major) {
+    case CBOR_BYTES:
+    case CBOR_TEXT:
+      if (size - *pos < head.value) {
+        return 0;
+      }
+      *pos += head.value;
+      return 1;
+    case CBOR_ARRAY:
+    case CBOR_MAP:
+      count = CBOR_MAP == head.major ? head.value * 2 : head.value;
+      for (i = 0; i < count; i++) {
+        if (!gstc_cbor_skip (data, size, pos, depth + 1)) {
+          return 0;
+        }
+      }
+      return 1;
+    case CBOR_TAG:
+      return gstc_cbor_skip (data, size, pos, depth + 1);
+    default:
+      return 1;
+  }
+}
+
+int
+gstc_cbor_has_magic (const char *data)
+{
+  gstc_assert_and_ret_val (NULL != data, 0);
+
+  return 0 == strncmp (data, CBOR_MAGIC, CBOR_MAGIC_SIZE);
+}
+
+size_t
+gstc_cbor_item_size (const char *data, size_t size)
+{
+  size_t pos = 0;
+
+  gstc_assert_and_ret_val (NULL != data, 0);
+
+  if (!gstc_cbor_skip ((const unsigned char *) data, size, &pos, 0)) {
+    return 0;
+  }
+
+  return pos;
+}
+
+size_t
+gstc_cbor_text_head (unsigned char *head, size_t size)
+{
+  unsigned int info;
+  unsigned int len;
+  unsigned int i;
+
+  gstc_assert_and_ret_val (NULL != head, 0);
+
+  if (size < CBOR_AI_1BYTE) {
+    head[0] = (CBOR_TEXT << 5) | size;
+    return 1;
+  }
+
+  /* The length follows in 1, 2, 4 or 8 big endian bytes */
+  if (size <= UINT8_MAX) {
+    info = CBOR_AI_1BYTE;
+  } else if (size <= UINT16_MAX) {
+    info = CBOR_AI_1BYTE + 1;
+  } else if (size <= UINT32_MAX) {
+    info = CBOR_AI_1BYTE + 2;
+  } else {
+    info = CBOR_AI_8BYTES;
+  }
+  len = 1 << (info - CBOR_AI_1BYTE);
+
+  head[0] = (CBOR_TEXT << 5) | info;
+  for (i = 0; i < len; i++) {
+    head[len - i] = (unsigned char) ((uint64_t) size >> (8 * i));
+  }
+
+  return len + 1;
+}
+
+/*
+ * Returns the position of the response item, after its tag
+ */
+static size_t
+gstc_cbor_root (const char *cbor)
+{
+  return gstc_cbor_has_magic (cbor) ? CBOR_MAGIC_SIZE : 0;
+}
+
+/*
+ * Looks up @name in the map at @pos. On success @pos points to the
+ * member value.
+ */
+static GstcStatus
+gstc_cbor_find_member (const unsigned char *data, size_t * pos,
+    const char *name)
+{
+  GstcCborHead head;
+  GstcCborHead key;
+  const size_t name_len = strlen (name);
+  uint64_t i;
+
+  if (!gstc_cbor_read_head (data, CBOR_NO_LIMIT, pos, &head)) {
+    return GSTC_MALFORMED;
+  }
+
+  if (CBOR_MAP != head.major) {
+    return GSTC_TYPE_ERROR;
+  }
+
+  for (i = 0; CBOR_AI_INDEFINITE == head.info || i < head.value; i++) {
+    if (CBOR_AI_INDEFINITE == head.info && CBOR_BREAK == data[*pos]) {
+      break;
+    }
+
+    if (!gstc_cbor_read_head (data, CBOR_NO_LIMIT, pos, &key)) {
+      return GSTC_MALFORMED;
+    }
+
+    /* Keys are always plain text strings in the daemon responses */
+    if (CBOR_TEXT != key.major || CBOR_AI_INDEFINITE == key.info) {
+      return GSTC_MALFORMED;
+    }
+
+    if (key.value == name_len
+        && 0 == memcmp (data + *pos, name, name_len)) {
+      *pos += key.value;
+      return GSTC_OK;
+    }
+    *pos += key.value;
+
+    if (!gstc_cbor_skip (data, CBOR_NO_LIMIT, pos, 0)) {
+      return GSTC_MALFORMED;
+    }
+  }
+
+  return GSTC_NOT_FOUND;
+}
+
+static GstcStatus
+gstc_cbor_scalar_to_string (const unsigned char *data, size_t pos,
+    char **out)
+{
+  GstcCborHead head;
+  union
+  {
+    uint32_t u;
+    float f;
+  } f32;
+  union
+  {
+    uint64_t u;
+    double d;
+  } f64;
+  char number[32];
+  const char *string = number;
+  size_t len;
+
+  if (!gstc_cbor_read_head (data, CBOR_NO_LIMIT, &pos, &head)) {
+    return GSTC_MALFORMED;
+  }
+
+  switch (head.major) {
+    case CBOR_TEXT:
+      if (CBOR_AI_INDEFINITE == head.info) {
+        return GSTC_TYPE_ERROR;
+      }
+      string = (const char *) data + pos;
+      len = head.value;
+      break;
+    case CBOR_UINT:
+      len = snprintf (number, sizeof (number), "%llu",
+          (unsigned long long) head.value);
+      break;
+    case CBOR_NEGINT:
+      len = snprintf (number, sizeof (number), "-%llu",
+          (unsigned long long) head.value + 1);
+      break;
+    case CBOR_SIMPLE:
+      if (CBOR_TRUE == head.initial || CBOR_FALSE == head.initial) {
+        string = CBOR_TRUE == head.initial ? "true" : "false";
+        len = strlen (string);
+      } else if (CBOR_FLOAT32 == head.initial) {
+        f32.u = (uint32_t) head.value;
+        len = snprintf (number, sizeof (number), "%.9g", f32.f);
+      } else if (CBOR_FLOAT64 == head.initial) {
+        f64.u = head.value;
+        len = snprintf (number, sizeof (number), "%.17g", f64.d);
+      } else {
+        /* Null and everything else are not strings, as with JSON */
+        return GSTC_TYPE_ERROR;
+      }
+      break;
+    default:
+      return GSTC_TYPE_ERROR;
+  }
+
+  *out = (char *) malloc (len + 1);
+  if (NULL == *out) {
+    return GSTC_OOM;
+  }
+  memcpy (*out, string, len);
+  (*out)[len] = '\0';
+
+  return GSTC_OK;
+}
+
+static GstcStatus
+gstc_cbor_read_int (const unsigned char *data, size_t * pos, int *out)
+{
+  GstcCborHead head;
+
+  if (!gstc_cbor_read_head (data, CBOR_NO_LIMIT, pos, &head)) {
+    return GSTC_MALFORMED;
+  }
+
+  if (CBOR_UINT == head.major) {
+    *out = (int) head.value;
+  } else if (CBOR_NEGINT == head.major) {
+    *out = -1 - (int) head.value;
+  } else {
+    return GSTC_TYPE_ERROR;
+  }
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_cbor_get_int (const char *cbor, const char *name, int *out)
+{
+  const unsigned char *data = (const unsigned char *) cbor;
+  GstcStatus ret;
+  size_t pos;
+
+  gstc_assert_and_ret_val (cbor != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (out != NULL, GSTC_NULL_ARGUMENT);
+
+  pos = gstc_cbor_root (cbor);
+  ret = gstc_cbor_find_member (data, &pos, name);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  return gstc_cbor_read_int (data, &pos, out);
+}
+
+GstcStatus
+gstc_cbor_is_null (const char *cbor, const char *name, int *out)
+{
+  GstcStatus ret;
+  size_t pos;
+
+  gstc_assert_and_ret_val (cbor != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (out != NULL, GSTC_NULL_ARGUMENT);
+
+  pos = gstc_cbor_root (cbor);
+  ret = gstc_cbor_find_member ((const unsigned char *) cbor, &pos, name);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  *out = CBOR_NULL == (unsigned char) cbor[pos];
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_cbor_get_child_char_array (const char *cbor, const char *parent_name,
+    const char *array_name, const char *element_name, char **out[],
+    int *array_lenght)
+{
+  const unsigned char *data = (const unsigned char *) cbor;
+  GstcCborHead head;
+  GstcStatus ret;
+  size_t pos;
+  size_t element;
+  int count;
+  int i;
+  int j;
+
+  gstc_assert_and_ret_val (cbor != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (parent_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (array_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (element_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (out != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (array_lenght != NULL, GSTC_NULL_ARGUMENT);
+
+  pos = gstc_cbor_root (cbor);
+  ret = gstc_cbor_find_member (data, &pos, parent_name);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  ret = gstc_cbor_find_member (data, &pos, array_name);
+  if (GSTC_OK != ret) {
+    return GSTC_NOT_FOUND == ret ? GSTC_TYPE_ERROR : ret;
+  }
+
+  if (!gstc_cbor_read_head (data, CBOR_NO_LIMIT, &pos, &head)) {
+    return GSTC_MALFORMED;
+  }
+
+  if (CBOR_ARRAY != head.major) {
+    return GSTC_TYPE_ERROR;
+  }
+
+  /* Indefinite arrays have to be walked once to be counted */
+  if (CBOR_AI_INDEFINITE == head.info) {
+    element = pos;
+    for (count = 0; CBOR_BREAK != data[element]; count++) {
+      gstc_cbor_skip (data, CBOR_NO_LIMIT, &element, 0);
+    }
+  } else {
+    count = (int) head.value;
+  }
+
+  *array_lenght = count;
+  *out = (char **) malloc (count * sizeof (char *));
+  if (NULL == *out) {
+    return GSTC_OOM;
+  }
+
+  for (i = 0; i < count; i++) {
+    element = pos;
+    ret = gstc_cbor_find_member (data, &element, element_name);
+    if (GSTC_OK == ret) {
+      ret = gstc_cbor_scalar_to_string (data, element, &(*out)[i]);
+    } else if (GSTC_NOT_FOUND == ret) {
+      ret = GSTC_TYPE_ERROR;
+    }
+
+    if (GSTC_OK != ret) {
+      goto clear_mem;
+    }
+
+    gstc_cbor_skip (data, CBOR_NO_LIMIT, &pos, 0);
+  }
+
+  return GSTC_OK;
+
+clear_mem:
+  /* In case of failure all allocated memory is freed */
+  for (j = 0; j < i; j++) {
+    free ((*out)[j]);
+  }
+  free (*out);
+  return ret;
+}
+
+GstcStatus
+gstc_cbor_get_child_int_array (const char *cbor, const char *parent_name,
+    const char *array_name, int *out, int max_lenght, int *array_lenght)
+{
+  const unsigned char *data = (const unsigned char *) cbor;
+  GstcCborHead head;
+  GstcStatus ret;
+  size_t pos;
+  int i;
+
+  gstc_assert_and_ret_val (cbor != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (parent_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (array_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (out != NULL || max_lenght == 0,
+      GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (array_lenght != NULL, GSTC_NULL_ARGUMENT);
+
+  pos = gstc_cbor_root (cbor);
+  ret = gstc_cbor_find_member (data, &pos, parent_name);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  ret = gstc_cbor_find_member (data, &pos, array_name);
+  if (GSTC_OK != ret) {
+    return GSTC_NOT_FOUND == ret ? GSTC_TYPE_ERROR : ret;
+  }
+
+  if (!gstc_cbor_read_head (data, CBOR_NO_LIMIT, &pos, &head)) {
+    return GSTC_MALFORMED;
+  }
+
+  if (CBOR_ARRAY != head.major) {
+    return GSTC_TYPE_ERROR;
+  }
+
+  for (i = 0; CBOR_AI_INDEFINITE == head.info ? CBOR_BREAK != data[pos]
+      : (uint64_t) i < head.value; i++) {
+    if (i < max_lenght) {
+      ret = gstc_cbor_read_int (data, &pos, &out[i]);
+      if (GSTC_OK != ret) {
+        return ret;
+      }
+    } else {
+      gstc_cbor_skip (data, CBOR_NO_LIMIT, &pos, 0);
+    }
+  }
+
+  *array_lenght = i;
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_cbor_child_string (const char *cbor, const char *parent_name,
+    const char *data_name, char **out)
+{
+  GstcStatus ret;
+  size_t pos;
+
+  gstc_assert_and_ret_val (cbor != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (parent_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (data_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (out != NULL, GSTC_NULL_ARGUMENT);
+
+  pos = gstc_cbor_root (cbor);
+  ret = gstc_cbor_find_member ((const unsigned char *) cbor, &pos,
+      parent_name);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  ret = gstc_cbor_find_member ((const unsigned char *) cbor, &pos, data_name);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  return gstc_cbor_scalar_to_string ((const unsigned char *) cbor, pos, out);
+}
@@ -0,0 +1,139 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LIBGSTC_CBOR_H__
+#define __LIBGSTC_CBOR_H__
+
+#include <stddef.h>
+
+#include "libgstc.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Minimal CBOR (RFC 8949) support for the responses of a connection
+ * switched with gstc_client_set_encoding(). The daemon starts every
+ * CBOR response with the self-described tag, so it can be told apart
+ * from JSON text.
+ */
+
+/*
+ * Returns non-zero if @data starts with the self-described CBOR tag
+ */
+int
+gstc_cbor_has_magic (const char *data);
+
+/*
+ * Returns the size of the first complete item in @data, or zero if it
+ * is incomplete or malformed. Every other gstc_cbor_* function expects
+ * data that passed this check.
+ */
+size_t
+gstc_cbor_item_size (const char *data, size_t size);
+
+/*
+ * Writes to @head the header of a text string of @size bytes and
+ * returns its length, at most 9 bytes.
+ */
+size_t
+gstc_cbor_text_head (unsigned char *head, size_t size);
+
+GstcStatus
+gstc_cbor_get_int (const char *cbor, const char *name, int *out);
+
+GstcStatus
+gstc_cbor_is_null (const char *cbor, const char *name, int *out);
+
+/**
+ * gstc_cbor_get_child_char_array:
+ * @cbor: Validated CBOR data to be searched for
+ * @parent_name: element name that is parent to the array
+ * @array_name: name of the array
+ * @element_name: name of the elements inside the array
+ * @out: pointer to array of char*, this memory is allocated by this function
+ * but needs to be freed by the client
+ * @array_lenght: number of elements in out array
+ *
+ * Same as gstc_json_get_child_char_array() for CBOR data.
+ *
+ * Returns: GstcStatus indicating success, null argument, type error,
+ * malformed data, unfound element
+ */
+GstcStatus
+gstc_cbor_get_child_char_array (const char *cbor, const char *parent_name,
+    const char *array_name, const char *element_name, char **out[],
+    int *array_lenght);
+
+/**
+ * gstc_cbor_get_child_int_array:
+ * @cbor: Validated CBOR data to be searched for
+ * @parent_name: element name that is parent to the array
+ * @array_name: name of the array of integers
+ * @out: placeholder for the integers, only the first @max_lenght are
+ * written
+ * @max_lenght: number of integers that fit in @out
+ * @array_lenght: number of elements in the array
+ *
+ * Same as gstc_json_get_child_int_array() for CBOR data.
+ *
+ * Returns: GstcStatus indicating success, null argument, type error,
+ * malformed data, unfound element
+ */
+GstcStatus
+gstc_cbor_get_child_int_array (const char *cbor, const char *parent_name,
+    const char *array_name, int *out, int max_lenght, int *array_lenght);
+
+/**
+ * gstc_cbor_child_string:
+ * @cbor: Validated CBOR data to be searched for
+ * @parent_name: element name that is parent to the string
+ * @data_name: name of the string
+ * @out: pointer to output string memory, this memory should be freed by the user
+ *
+ * Same as gstc_json_child_string() for CBOR data. Numbers and booleans
+ * are converted to text, since CBOR keeps them binary.
+ *
+ * Returns: GstcStatus indicating success, null argument, type error,
+ * malformed data, unfound element
+ */
+GstcStatus
+gstc_cbor_child_string (const char *cbor, const char *parent_name,
+    const char *data_name, char **out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBGSTC_CBOR_H__
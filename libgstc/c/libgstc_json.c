@@ -206,6 +206,52 @@ clear_mem:
 
 }
 
+GstcStatus
+gstc_json_get_child_int_array (const char *json, const char *parent_name,
+    const char *array_name, int *out, int max_lenght, int *array_lenght)
+{
+  GstcStatus ret;
+  json_t *root;
+  json_t *parent;
+  json_t *array_data;
+  json_t *data;
+  int i;
+
+  gstc_assert_and_ret_val (json != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (parent_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (array_name != NULL, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (out != NULL || max_lenght == 0,
+      GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (array_lenght != NULL, GSTC_NULL_ARGUMENT);
+
+  ret = gstc_json_get_value (json, parent_name, &root, &parent);
+  if (GSTC_OK != ret) {
+    goto out;
+  }
+
+  array_data = json_object_get (parent, array_name);
+  if (!json_is_array (array_data)) {
+    ret = GSTC_TYPE_ERROR;
+    goto unref;
+  }
+
+  *array_lenght = json_array_size (array_data);
+
+  for (i = 0; i < *array_lenght && i < max_lenght; i++) {
+    data = json_array_get (array_data, i);
+    if (!json_is_integer (data)) {
+      ret = GSTC_TYPE_ERROR;
+      goto unref;
+    }
+    out[i] = json_integer_value (data);
+  }
+
+unref:
+  json_decref (root);
+out:
+  return ret;
+}
+
 GstcStatus
 gstc_json_child_string (const char *json, const char *parent_name,
     const char *data_name, char **out)
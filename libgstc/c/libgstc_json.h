@@ -58,6 +58,23 @@ GstcStatus
 gstc_json_get_child_char_array(const char *json, const char* parent_name,
   const char* array_name, const char *element_name, char **out[], int *array_lenght);
 
+/**
+ * gstc_json_get_child_int_array:
+ * @json: Json as a cstring with the data to be searched for
+ * @parent_name: element name that is parent to the array
+ * @array_name: name of the array of integers
+ * @out: placeholder for the integers, only the first @max_lenght are
+ * written
+ * @max_lenght: number of integers that fit in @out
+ * @array_lenght: number of elements in the array
+ *
+ * Returns: GstcStatus indicating success, null argument, type error,
+ * malformed string, unfound element
+ */
+GstcStatus
+gstc_json_get_child_int_array (const char *json, const char *parent_name,
+  const char *array_name, int *out, int max_lenght, int *array_lenght);
+
   /**
    * gstc_json_child_string:
    * @json: Json as a cstring with the data to be searched for
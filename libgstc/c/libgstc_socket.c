@@ -31,13 +31,16 @@
  */
 
 #include <arpa/inet.h>
+#include <errno.h>
 #include <poll.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include "libgstc_assert.h"
+#include "libgstc_cbor.h"
 #include "libgstc_socket.h"
 
 /* Allow the user to override this value at build time */
@@ -47,15 +50,51 @@
 
 #define NUMBER_OF_SOCKETS (1)
 
+/* Framed protocol, see libgstd/gstd_socket.h */
+#define FRAMED_HELLO "protocol framed"
+#define FRAMED_ACK "\"protocol\" : \"framed\""
+#define CBOR_HELLO "protocol framed cbor"
+#define CBOR_ACK "\"encoding\" : \"cbor\""
+#define FRAME_HEADER_SIZE (8)
+
+/* Don't die on SIGPIPE when the daemon dropped the connection */
+#ifdef MSG_NOSIGNAL
+#  define SEND_FLAGS MSG_NOSIGNAL
+#else
+#  define SEND_FLAGS 0
+#endif
+
 static int create_new_socket ();
 static GstcStatus open_socket (GstcSocket * self);
-static GstcStatus accumulate_response (int socket, char **response);
+static void close_socket (GstcSocket * self);
+static int is_healthy (GstcSocket * self);
+static GstcStatus reconnect (GstcSocket * self, const int timeout);
+static GstcStatus accumulate_response (int socket, char **response,
+    int *closed);
+static GstcStatus wait_for_data (int socket, const int timeout);
+static GstcStatus send_all (int socket, const char *data, size_t size);
+static GstcStatus exchange (GstcSocket * self, const char *request,
+    char **response, const int timeout, int *closed);
+static GstcStatus send_framed (GstcSocket * self, const char *request,
+    const int timeout, char **response);
+static GstcStatus send_hello (GstcSocket * self, const char *hello,
+    const char *ack, const int timeout);
 
 struct _GstcSocket
 {
+  /* -1 while a persistent connection is closed */
   int socket;
   struct sockaddr_in server;
   int keep_connection_open;
+
+  /* Framed mode state */
+  int framed;
+  int cbor;
+  unsigned int next_id;
+  unsigned int pending;
+  char *buffer;
+  size_t buffer_len;
+  size_t buffer_size;
 };
 
 static int
@@ -81,18 +120,89 @@ open_socket (GstcSocket * self)
 
   if (setsockopt (self->socket, SOL_SOCKET, SO_RCVBUF, &buffsize,
           sizeof (buffsize))) {
-    close (self->socket);
+    close_socket (self);
     return GSTC_SOCKET_ERROR;
   }
 
   if (connect (self->socket, (struct sockaddr *) &self->server,
           sizeof (self->server)) < 0) {
-    close (self->socket);
+    close_socket (self);
     return GSTC_UNREACHABLE;
   }
   return GSTC_OK;
 }
 
+static void
+close_socket (GstcSocket * self)
+{
+  if (-1 != self->socket) {
+    close (self->socket);
+    self->socket = -1;
+  }
+
+  /* Whatever was in flight is lost with the connection */
+  self->pending = 0;
+  self->buffer_len = 0;
+}
+
+/*
+ * An idle persistent connection must have nothing to read: the daemon
+ * may have closed it, or the reply to a request that timed out may
+ * have arrived since. Either way it can't be trusted anymore.
+ */
+static int
+is_healthy (GstcSocket * self)
+{
+  struct pollfd ufds[NUMBER_OF_SOCKETS];
+
+  if (-1 == self->socket) {
+    return 0;
+  }
+
+  /* Pipelined replies are expected */
+  if (self->pending > 0) {
+    return 1;
+  }
+
+  ufds[0].fd = self->socket;
+  ufds[0].events = POLLIN;
+
+  return 0 == poll (ufds, NUMBER_OF_SOCKETS, 0) && 0 == self->buffer_len;
+}
+
+/*
+ * Opens the connection again, switched to the protocol it was using
+ */
+static GstcStatus
+reconnect (GstcSocket * self, const int timeout)
+{
+  GstcStatus ret;
+  const int framed = self->framed;
+  const int cbor = self->cbor;
+
+  close_socket (self);
+
+  ret = open_socket (self);
+  if (GSTC_OK != ret || !framed) {
+    return ret;
+  }
+
+  self->framed = 0;
+  if (cbor) {
+    ret = send_hello (self, CBOR_HELLO, CBOR_ACK, timeout);
+  } else {
+    ret = send_hello (self, FRAMED_HELLO, FRAMED_ACK, timeout);
+  }
+
+  /* Keep the protocol for the next attempt */
+  if (GSTC_OK != ret) {
+    self->framed = framed;
+    close_socket (self);
+  }
+
+  return ret;
+}
+
 GstcStatus
 gstc_socket_new (const char *address, const unsigned int port,
     const int keep_connection_open, GstcSocket ** out)
@@ -112,7 +222,15 @@ gstc_socket_new (const char *address, const unsigned int port,
     goto out;
   }
 
+  self->socket = -1;
   self->keep_connection_open = keep_connection_open;
+  self->framed = 0;
+  self->cbor = 0;
+  self->next_id = 0;
+  self->pending = 0;
+  self->buffer = NULL;
+  self->buffer_len = 0;
+  self->buffer_size = 0;
 
   self->server.sin_addr.s_addr = inet_addr (address);
   self->server.sin_family = domain;
@@ -137,8 +255,11 @@ out:
   return ret;
 }
 
+/*
+ * @closed is set if the daemon closed the connection without replying
+ */
 static GstcStatus
-accumulate_response (int socket, char **response)
+accumulate_response (int socket, char **response, int *closed)
 {
   char buffer[1024];
   ssize_t read = 0;
@@ -155,7 +276,11 @@ accumulate_response (int socket, char **response)
   do {
     read = recv (socket, buffer, sizeof(buffer), flags);
 
-    if (read < 0) {
+    if (read <= 0) {
+      /* Writing to a closed connection gets it reset */
+      *closed = 0 == acc && (0 == read || ECONNRESET == errno);
+      free (*response);
+      *response = NULL;
       ret = GSTC_RECV_ERROR;
       break;
     }
@@ -178,71 +303,400 @@ accumulate_response (int socket, char **response)
   return ret;
 }
 
+static GstcStatus
+wait_for_data (int socket, const int timeout)
+{
+  int rv;
+  struct pollfd ufds[NUMBER_OF_SOCKETS];
+
+  ufds[0].fd = socket;
+  ufds[0].events = POLLIN;
+
+  rv = poll (ufds, NUMBER_OF_SOCKETS, timeout);
+
+  /* Error ocurred in poll */
+  if (rv == -1) {
+    return GSTC_SOCKET_ERROR;
+  }
+
+  /* Timeout ocurred */
+  if (rv == 0) {
+    return GSTC_SOCKET_TIMEOUT;
+  }
+
+  /* Check for events on the socket */
+  if (0 == (ufds[0].revents & POLLIN)) {
+    return GSTC_SOCKET_ERROR;
+  }
+
+  return GSTC_OK;
+}
+
+static GstcStatus
+send_all (int socket, const char *data, size_t size)
+{
+  ssize_t sent;
+  const int flags = SEND_FLAGS;
+
+  while (size > 0) {
+    sent = send (socket, data, size, flags);
+    if (sent < 0) {
+      return GSTC_SEND_ERROR;
+    }
+    data += sent;
+    size -= sent;
+  }
+
+  return GSTC_OK;
+}
+
+/*
+ * Sends @request and waits for its NUL terminated reply
+ */
+static GstcStatus
+exchange (GstcSocket * self, const char *request, char **response,
+    const int timeout, int *closed)
+{
+  GstcStatus ret;
+
+  *closed = 0;
+
+  ret = send_all (self->socket, request, strlen (request));
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  ret = wait_for_data (self->socket, timeout);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  return accumulate_response (self->socket, response, closed);
+}
+
 GstcStatus
 gstc_socket_send (GstcSocket * self, const char *request, char **response,
     const int timeout)
 {
-  int rv;
-  struct pollfd ufds[NUMBER_OF_SOCKETS];
   GstcStatus ret;
+  int reused;
+  int closed = 0;
 
   gstc_assert_and_ret_val (NULL != self, GSTC_NULL_ARGUMENT);
   gstc_assert_and_ret_val (NULL != request, GSTC_NULL_ARGUMENT);
   gstc_assert_and_ret_val (NULL != response, GSTC_NULL_ARGUMENT);
 
+  *response = NULL;
+
   if (!self->keep_connection_open) {
     ret = open_socket (self);
     if (ret != GSTC_OK) {
-      goto out;
+      return ret;
     }
+
+    ret = exchange (self, request, response, timeout, &closed);
+    close_socket (self);
+
+    return ret;
   }
 
-  if (send (self->socket, request, strlen (request), 0) < 0) {
-    ret = GSTC_SEND_ERROR;
-    goto close_con;
+  reused = is_healthy (self);
+  if (!reused) {
+    ret = reconnect (self, timeout);
+    if (GSTC_OK != ret) {
+      return ret;
+    }
   }
 
-  ufds[0].fd = self->socket;
-  ufds[0].events = POLLIN;
+  if (self->framed) {
+    ret = send_framed (self, request, timeout, response);
 
-  rv = poll (ufds, NUMBER_OF_SOCKETS, timeout);
+    /* Late replies are told apart by their id, anything else is fatal */
+    if (GSTC_OK != ret && GSTC_SOCKET_TIMEOUT != ret) {
+      close_socket (self);
+    }
 
-  /* Error ocurred in poll */
-  if (rv == -1) {
-    ret = GSTC_SOCKET_ERROR;
-    goto close_con;
+    return ret;
   }
 
-  /* Timeout ocurred */
-  if (rv == 0) {
-    ret = GSTC_SOCKET_TIMEOUT;
-    goto close_con;
+  ret = exchange (self, request, response, timeout, &closed);
+
+  /* The daemon may close an idle connection right after it was checked,
+   * before reading the request. Send it again over a new one. */
+  if (reused && (GSTC_SEND_ERROR == ret || closed)) {
+    ret = reconnect (self, timeout);
+    if (GSTC_OK == ret) {
+      ret = exchange (self, request, response, timeout, &closed);
+    }
   }
 
-  /* Check for events on the socket */
-  if (0 == (ufds[0].revents & POLLIN)) {
-    ret = GSTC_SOCKET_ERROR;
-    goto close_con;
+  /* A late reply would be taken for the one of the next request */
+  if (GSTC_OK != ret) {
+    close_socket (self);
   }
 
-  ret = accumulate_response (self->socket, response);
+  return ret;
+}
+
+static GstcStatus
+send_hello (GstcSocket * self, const char *hello, const char *ack,
+    const int timeout)
+{
+  GstcStatus ret;
+  char *response = NULL;
+  int closed;
 
-close_con:
+  /* Requests can only be pipelined over a persistent connection */
   if (!self->keep_connection_open) {
-    close (self->socket);
+    return GSTC_UNSUPPORTED;
+  }
+
+  /* The hello is answered like any command, nothing else may be read */
+  if (!is_healthy (self)) {
+    close_socket (self);
+    ret = open_socket (self);
+    if (GSTC_OK != ret) {
+      return ret;
+    }
+  }
+
+  ret = exchange (self, hello, &response, timeout, &closed);
+  if (GSTC_OK != ret) {
+    close_socket (self);
+    return ret;
+  }
+
+  /* Older daemons answer with an unknown command error */
+  if (NULL != strstr (response, FRAMED_ACK) && NULL != strstr (response, ack)) {
+    self->framed = 1;
+  } else {
+    ret = GSTC_UNSUPPORTED;
+  }
+
+  free (response);
+
+  return ret;
+}
+
+GstcStatus
+gstc_socket_enable_framing (GstcSocket * self, const int timeout)
+{
+  gstc_assert_and_ret_val (NULL != self, GSTC_NULL_ARGUMENT);
+
+  /* Submitting doesn't check the connection, do it here */
+  if (self->framed) {
+    return is_healthy (self) ? GSTC_OK : reconnect (self, timeout);
+  }
+
+  return send_hello (self, FRAMED_HELLO, FRAMED_ACK, timeout);
+}
+
+GstcStatus
+gstc_socket_enable_cbor (GstcSocket * self, const int timeout)
+{
+  GstcStatus ret;
+
+  gstc_assert_and_ret_val (NULL != self, GSTC_NULL_ARGUMENT);
+
+  if (self->cbor) {
+    return GSTC_OK;
+  }
+
+  /* The encoding is chosen by the hello, it can't change afterwards */
+  if (self->framed) {
+    return GSTC_UNSUPPORTED;
+  }
+
+  ret = send_hello (self, CBOR_HELLO, CBOR_ACK, timeout);
+  if (GSTC_OK == ret) {
+    self->cbor = 1;
+  }
+
+  return ret;
+}
+
+GstcStatus
+gstc_socket_submit (GstcSocket * self, const char *request, unsigned int *id)
+{
+  GstcStatus ret;
+  size_t size;
+  size_t head_size = 0;
+  unsigned char head[9];
+  uint32_t header[2];
+  char *frame;
+
+  gstc_assert_and_ret_val (NULL != self, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != request, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != id, GSTC_NULL_ARGUMENT);
+
+  if (!self->framed) {
+    return GSTC_UNSUPPORTED;
+  }
+
+  /* CBOR requests are the command as a text string */
+  size = strlen (request);
+  if (self->cbor) {
+    head_size = gstc_cbor_text_head (head, size);
+  }
+
+  /* Send header and payload at once to avoid an extra segment */
+  frame = (char *) malloc (FRAME_HEADER_SIZE + head_size + size);
+  if (NULL == frame) {
+    return GSTC_OOM;
+  }
+
+  *id = self->next_id++;
+  header[0] = htonl ((uint32_t) (head_size + size));
+  header[1] = htonl (*id);
+  memcpy (frame, header, FRAME_HEADER_SIZE);
+  memcpy (frame + FRAME_HEADER_SIZE, head, head_size);
+  memcpy (frame + FRAME_HEADER_SIZE + head_size, request, size);
+
+  ret = send_all (self->socket, frame, FRAME_HEADER_SIZE + head_size + size);
+  free (frame);
+
+  if (GSTC_OK == ret) {
+    self->pending++;
+  } else {
+    close_socket (self);
   }
 
-out:
   return ret;
 }
 
+GstcStatus
+gstc_socket_receive (GstcSocket * self, unsigned int *id, char **response,
+    const int timeout)
+{
+  GstcStatus ret;
+  ssize_t read;
+  uint32_t header[2];
+  uint32_t size;
+  char *grown;
+  const int flags = 0;
+
+  gstc_assert_and_ret_val (NULL != self, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != id, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != response, GSTC_NULL_ARGUMENT);
+
+  *response = NULL;
+
+  if (!self->framed) {
+    return GSTC_UNSUPPORTED;
+  }
+
+  while (1) {
+    /* A complete frame may already be buffered */
+    if (self->buffer_len >= FRAME_HEADER_SIZE) {
+      memcpy (header, self->buffer, FRAME_HEADER_SIZE);
+      size = ntohl (header[0]);
+
+      if (size >= GSTC_MAX_RESPONSE_LENGTH) {
+        return GSTC_LONG_RESPONSE;
+      }
+
+      if (self->buffer_len >= FRAME_HEADER_SIZE + size) {
+        /* Binary responses are checked once here, so they can be
+         * parsed later without knowing their size */
+        if (self->cbor && gstc_cbor_item_size (self->buffer +
+                FRAME_HEADER_SIZE, size) != size) {
+          *id = ntohl (header[1]);
+          self->buffer_len -= FRAME_HEADER_SIZE + size;
+          memmove (self->buffer, self->buffer + FRAME_HEADER_SIZE + size,
+              self->buffer_len);
+          self->pending--;
+          return GSTC_MALFORMED;
+        }
+
+        *response = (char *) malloc (size + 1);
+        if (NULL == *response) {
+          return GSTC_OOM;
+        }
+
+        *id = ntohl (header[1]);
+        memcpy (*response, self->buffer + FRAME_HEADER_SIZE, size);
+        (*response)[size] = '\0';
+
+        self->buffer_len -= FRAME_HEADER_SIZE + size;
+        memmove (self->buffer, self->buffer + FRAME_HEADER_SIZE + size,
+            self->buffer_len);
+        self->pending--;
+
+        return GSTC_OK;
+      }
+    }
+
+    ret = wait_for_data (self->socket, timeout);
+    if (GSTC_SOCKET_TIMEOUT == ret) {
+      return ret;
+    } else if (GSTC_OK != ret) {
+      close_socket (self);
+      return ret;
+    }
+
+    if (self->buffer_size - self->buffer_len < 4096) {
+      grown = (char *) realloc (self->buffer, 2 * self->buffer_size + 4096);
+      if (NULL == grown) {
+        return GSTC_OOM;
+      }
+      self->buffer = grown;
+      self->buffer_size = 2 * self->buffer_size + 4096;
+    }
+
+    read = recv (self->socket, self->buffer + self->buffer_len,
+        self->buffer_size - self->buffer_len, flags);
+    if (read <= 0) {
+      close_socket (self);
+      return GSTC_RECV_ERROR;
+    }
+    self->buffer_len += read;
+  }
+}
+
+unsigned int
+gstc_socket_get_pending (GstcSocket * self)
+{
+  gstc_assert_and_ret_val (NULL != self, 0);
+
+  return self->pending;
+}
+
+static GstcStatus
+send_framed (GstcSocket * self, const char *request, const int timeout,
+    char **response)
+{
+  GstcStatus ret;
+  unsigned int id;
+  unsigned int received;
+
+  ret = gstc_socket_submit (self, request, &id);
+  if (GSTC_OK != ret) {
+    return ret;
+  }
+
+  /* Replies come in order, skip the ones of pipelined requests */
+  do {
+    ret = gstc_socket_receive (self, &received, response, timeout);
+    if (GSTC_OK != ret) {
+      return ret;
+    }
+    if (received != id) {
+      free (*response);
+      *response = NULL;
+    }
+  } while (received != id);
+
+  return GSTC_OK;
+}
+
 void
 gstc_socket_free (GstcSocket * socket)
 {
   gstc_assert_and_ret (NULL != socket);
 
   if (socket->keep_connection_open) {
-    close (socket->socket);
+    close_socket (socket);
   }
+  free (socket->buffer);
   free (socket);
 }
@@ -49,6 +49,44 @@ GstcStatus
 gstc_socket_send (GstcSocket *socket, const char *request,
     char ** response, const int timeout);
 
+/*
+ * Switches a persistent connection to the framed protocol, which allows
+ * several requests to be in flight. Returns GSTC_UNSUPPORTED if the
+ * connection isn't persistent or the daemon doesn't know the protocol.
+ */
+GstcStatus
+gstc_socket_enable_framing (GstcSocket *socket, const int timeout);
+
+/*
+ * Switches a persistent connection to the framed protocol with CBOR
+ * payloads. Must be called before any other switch; returns
+ * GSTC_UNSUPPORTED if the connection is already framed, isn't
+ * persistent or the daemon doesn't know the encoding.
+ */
+GstcStatus
+gstc_socket_enable_cbor (GstcSocket *socket, const int timeout);
+
+/*
+ * Sends @request over a framed connection without waiting for the
+ * reply. @id identifies the reply in gstc_socket_receive().
+ */
+GstcStatus
+gstc_socket_submit (GstcSocket *socket, const char *request,
+    unsigned int *id);
+
+/*
+ * Receives the next reply of a framed connection, in request order.
+ */
+GstcStatus
+gstc_socket_receive (GstcSocket *socket, unsigned int *id,
+    char **response, const int timeout);
+
+/*
+ * Amount of submitted requests whose reply hasn't been received
+ */
+unsigned int
+gstc_socket_get_pending (GstcSocket *socket);
+
 void
 gstc_socket_free (GstcSocket *socket);
 
@@ -110,3 +110,11 @@ gstc_cond_signal (GstcCond * cond)
 
   pthread_cond_signal (&(cond->cond));
 }
+
+void
+gstc_cond_broadcast (GstcCond * cond)
+{
+  gstc_assert_and_ret (NULL != cond);
+
+  pthread_cond_broadcast (&(cond->cond));
+}
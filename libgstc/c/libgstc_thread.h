@@ -84,6 +84,9 @@ gstc_cond_wait (GstcCond *cond, GstcMutex *mutex);
 void
 gstc_cond_signal (GstcCond *cond);
 
+void
+gstc_cond_broadcast (GstcCond *cond);
+
 #ifdef __cplusplus
 }
 #endif
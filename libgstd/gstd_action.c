@@ -165,7 +165,7 @@ gstd_action_to_string (GstdObject * obj, gchar ** outstring)
   g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
 
   self = GSTD_ACTION (obj);
-  formatter = g_object_new (obj->formatter_factory, NULL);
+  formatter = gstd_object_new_formatter (obj);
 
   action_id =
       g_signal_lookup (GSTD_OBJECT_NAME (self), G_OBJECT_TYPE (self->target));
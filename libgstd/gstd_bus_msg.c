@@ -132,24 +132,19 @@ gstd_bus_msg_factory_make (GstMessage * target)
   return msg;
 }
 
-static GstdReturnCode
-gstd_bus_msg_to_string (GstdObject * object, gchar ** outstring)
+GstdReturnCode
+gstd_bus_msg_serialize (GstdBusMsg * self, GstdIFormatter * formatter)
 {
-  GstdBusMsg *self;
   GstMessage *target;
   gchar *ts;
   GValue value = G_VALUE_INIT;
-  GstdIFormatter *formatter = g_object_new (object->formatter_factory, NULL);
-
-  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
-
-  self = GSTD_BUS_MSG (object);
 
+  g_return_val_if_fail (GSTD_IS_BUS_MSG (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (formatter, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (self->target, GSTD_MISSING_INITIALIZATION);
+
   target = self->target;
 
-  gstd_iformatter_begin_object (formatter);
   gstd_iformatter_set_member_name (formatter, "type");
   gstd_iformatter_set_string_value (formatter, GST_MESSAGE_TYPE_NAME (target));
 
@@ -171,11 +166,29 @@ gstd_bus_msg_to_string (GstdObject * object, gchar ** outstring)
     GSTD_BUS_MSG_GET_CLASS (self)->to_string (self, formatter, target);
   }
 
+  return GSTD_EOK;
+}
+
+static GstdReturnCode
+gstd_bus_msg_to_string (GstdObject * object, gchar ** outstring)
+{
+  GstdIFormatter *formatter;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  formatter = gstd_object_new_formatter (object);
+
+  gstd_iformatter_begin_object (formatter);
+  ret = gstd_bus_msg_serialize (GSTD_BUS_MSG (object), formatter);
   gstd_iformatter_end_object (formatter);
 
-  gstd_iformatter_generate (formatter, outstring);
+  if (GSTD_EOK == ret) {
+    gstd_iformatter_generate (formatter, outstring);
+  }
 
   /* Free formatter */
   g_object_unref (formatter);
-  return GSTD_EOK;
+  return ret;
 }
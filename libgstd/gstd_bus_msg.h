@@ -64,6 +64,19 @@ struct _GstdBusMsgClass
 
 GstdBusMsg *gstd_bus_msg_factory_make (GstMessage * target);
 
+/**
+ * gstd_bus_msg_serialize:
+ * @self: The bus message
+ * @formatter: The formatter, with an object already begun
+ *
+ * Writes the members of @self into the current object of @formatter,
+ * so messages can be embedded in larger responses.
+ *
+ * Returns: GSTD_EOK on success.
+ */
+GstdReturnCode gstd_bus_msg_serialize (GstdBusMsg * self,
+    GstdIFormatter * formatter);
+
 G_END_DECLS
 
 #endif // __GSTD_BUS_MSG_H__
@@ -92,18 +92,34 @@ gstd_callback_dispose (GObject * object)
 static GstdReturnCode
 gstd_callback_to_string (GstdObject * object, gchar ** outstring)
 {
-  GstdCallback *self;
-  guint i;
-  GstdIFormatter *formatter = g_object_new (object->formatter_factory, NULL);
+  GstdIFormatter *formatter;
 
   g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
 
-  self = GSTD_CALLBACK (object);
+  GST_DEBUG_OBJECT (object, "Callback to string %p", object);
 
-  GST_DEBUG_OBJECT (self, "Callback to string %p", object);
+  formatter = gstd_object_new_formatter (object);
 
   gstd_iformatter_begin_object (formatter);
+  gstd_callback_serialize (GSTD_CALLBACK (object), formatter);
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  /* Free formatter */
+  g_object_unref (formatter);
+  return GSTD_EOK;
+}
+
+void
+gstd_callback_serialize (GstdCallback * self, GstdIFormatter * formatter)
+{
+  guint i;
+
+  g_return_if_fail (GSTD_IS_CALLBACK (self));
+  g_return_if_fail (formatter);
+
   gstd_iformatter_set_member_name (formatter, "name");
   gstd_iformatter_set_string_value (formatter, self->signal_name);
 
@@ -122,14 +138,6 @@ gstd_callback_to_string (GstdObject * object, gchar ** outstring)
   }
 
   gstd_iformatter_end_array (formatter);
-
-  gstd_iformatter_end_object (formatter);
-
-  gstd_iformatter_generate (formatter, outstring);
-
-  /* Free formatter */
-  g_object_unref (formatter);
-  return GSTD_EOK;
 }
 
 
@@ -63,5 +63,16 @@ struct _GstdCallbackClass
 GstdCallback *gstd_callback_new (const gchar * signal_name,
     GValue * return_value, guint n_param_values, const GValue * param_values);
 
+/**
+ * gstd_callback_serialize:
+ * @self: The callback to describe
+ * @formatter: A formatter with an object open
+ *
+ * Adds the "name" and "arguments" members of @self to the object
+ * currently open in @formatter, so callbacks can be embedded in larger
+ * responses.
+ */
+void gstd_callback_serialize (GstdCallback * self, GstdIFormatter * formatter);
+
 G_END_DECLS
 #endif // __GSTD_CALLBACK_H__
@@ -0,0 +1,709 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "gstd_cbor_writer.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_cbor_writer_debug);
+#define GST_CAT_DEFAULT gstd_cbor_writer_debug
+
+/* Deepest nesting of maps and arrays accepted when walking an item */
+#define CBOR_MAX_DEPTH     64
+
+/* Initial size of the output buffer */
+#define CBOR_BUFFER_SIZE   512
+
+/*
+ * After the magic, outputs hold their item as encoded CBOR (tag 24) in
+ * a byte string with an 8-byte length, filled in on generate. The
+ * length travels with the output through the string based APIs.
+ */
+#define CBOR_ENCODED_HEAD      "\xd8\x18\x5b"
+#define CBOR_ENCODED_HEAD_SIZE 3
+#define CBOR_OUTPUT_HEADER_SIZE \
+  (GSTD_CBOR_MAGIC_SIZE + CBOR_ENCODED_HEAD_SIZE + 8)
+
+/* Additional information values with a special meaning */
+#define CBOR_AI_1BYTE      24
+#define CBOR_AI_2BYTES     25
+#define CBOR_AI_4BYTES     26
+#define CBOR_AI_8BYTES     27
+#define CBOR_AI_INDEFINITE 31
+
+#define CBOR_FALSE         0xf4
+#define CBOR_TRUE          0xf5
+#define CBOR_FLOAT32       0xfa
+#define CBOR_FLOAT64       0xfb
+#define CBOR_BREAK         0xff
+
+typedef struct _GstdCborWriterClass GstdCborWriterClass;
+
+/**
+ * GstdCborWriter:
+ * A streaming CBOR formatter. Maps and arrays are written with
+ * indefinite lengths, so values go straight to the output without
+ * knowing the amount of children beforehand.
+ */
+struct _GstdCborWriter
+{
+  GObject parent;
+  GByteArray *buffer;
+  guint depth;
+};
+
+struct _GstdCborWriterClass
+{
+  GObjectClass parent_class;
+};
+
+static void gstd_iformatter_interface_init (GstdIFormatterInterface * iface);
+
+static void gstd_cbor_writer_finalize (GObject * object);
+
+G_DEFINE_TYPE_WITH_CODE (GstdCborWriter, gstd_cbor_writer, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE (GSTD_TYPE_IFORMATTER,
+        gstd_iformatter_interface_init));
+
+static void
+gstd_cbor_writer_class_init (GstdCborWriterClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  object_class->finalize = gstd_cbor_writer_finalize;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_cbor_writer_debug, "gstdcborwriter",
+      debug_color, "Gstd CBOR writer category");
+}
+
+static void
+gstd_cbor_writer_reset (GstdCborWriter * self)
+{
+  g_byte_array_set_size (self->buffer, CBOR_OUTPUT_HEADER_SIZE);
+  memcpy (self->buffer->data, GSTD_CBOR_MAGIC, GSTD_CBOR_MAGIC_SIZE);
+  memcpy (self->buffer->data + GSTD_CBOR_MAGIC_SIZE, CBOR_ENCODED_HEAD,
+      CBOR_ENCODED_HEAD_SIZE);
+  self->depth = 0;
+}
+
+static void
+gstd_cbor_writer_init (GstdCborWriter * self)
+{
+  GST_LOG_OBJECT (self, "Initializing CBOR writer");
+
+  self->buffer = g_byte_array_sized_new (CBOR_BUFFER_SIZE);
+  gstd_cbor_writer_reset (self);
+}
+
+void
+gstd_cbor_append_head (GByteArray * out, guint8 major, guint64 value)
+{
+  guint8 head[9];
+  guint len;
+
+  g_return_if_fail (out);
+
+  major <<= 5;
+
+  if (value < CBOR_AI_1BYTE) {
+    head[0] = major | value;
+    len = 1;
+  } else if (value <= G_MAXUINT8) {
+    head[0] = major | CBOR_AI_1BYTE;
+    head[1] = value;
+    len = 2;
+  } else if (value <= G_MAXUINT16) {
+    head[0] = major | CBOR_AI_2BYTES;
+    GST_WRITE_UINT16_BE (head + 1, value);
+    len = 3;
+  } else if (value <= G_MAXUINT32) {
+    head[0] = major | CBOR_AI_4BYTES;
+    GST_WRITE_UINT32_BE (head + 1, value);
+    len = 5;
+  } else {
+    head[0] = major | CBOR_AI_8BYTES;
+    GST_WRITE_UINT64_BE (head + 1, value);
+    len = 9;
+  }
+
+  g_byte_array_append (out, head, len);
+}
+
+void
+gstd_cbor_append_text (GByteArray * out, const gchar * text)
+{
+  gsize len;
+
+  g_return_if_fail (out);
+
+  if (NULL == text)
+    text = "";
+
+  len = strlen (text);
+  gstd_cbor_append_head (out, GSTD_CBOR_TEXT, len);
+  g_byte_array_append (out, (const guint8 *) text, len);
+}
+
+static void
+gstd_cbor_writer_append_int (GstdCborWriter * self, gint64 value)
+{
+  /* Negative values are stored as -1 - n, which can not overflow */
+  if (value < 0)
+    gstd_cbor_append_head (self->buffer, GSTD_CBOR_NEGINT,
+        ~((guint64) value));
+  else
+    gstd_cbor_append_head (self->buffer, GSTD_CBOR_UINT, value);
+}
+
+static void
+gstd_cbor_writer_append_float (GstdCborWriter * self, gfloat value)
+{
+  union
+  {
+    gfloat f;
+    guint32 u;
+  } bits;
+  guint8 data[5];
+
+  bits.f = value;
+  data[0] = CBOR_FLOAT32;
+  GST_WRITE_UINT32_BE (data + 1, bits.u);
+  g_byte_array_append (self->buffer, data, sizeof (data));
+}
+
+static void
+gstd_cbor_writer_append_double (GstdCborWriter * self, gdouble value)
+{
+  union
+  {
+    gdouble d;
+    guint64 u;
+  } bits;
+  guint8 data[9];
+
+  bits.d = value;
+  data[0] = CBOR_FLOAT64;
+  GST_WRITE_UINT64_BE (data + 1, bits.u);
+  g_byte_array_append (self->buffer, data, sizeof (data));
+}
+
+static void
+gstd_cbor_writer_append_byte (GstdCborWriter * self, guint8 byte)
+{
+  g_byte_array_append (self->buffer, &byte, 1);
+}
+
+static void
+gstd_cbor_writer_begin (GstdCborWriter * self, guint8 major)
+{
+  gstd_cbor_writer_append_byte (self, (major << 5) | CBOR_AI_INDEFINITE);
+  self->depth++;
+}
+
+static void
+gstd_cbor_writer_end (GstdCborWriter * self)
+{
+  g_return_if_fail (self->depth > 0);
+
+  self->depth--;
+  gstd_cbor_writer_append_byte (self, CBOR_BREAK);
+}
+
+static void
+gstd_cbor_writer_begin_object (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_writer_begin (GSTD_CBOR_WRITER (iface), GSTD_CBOR_MAP);
+}
+
+static void
+gstd_cbor_writer_end_object (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_writer_end (GSTD_CBOR_WRITER (iface));
+}
+
+static void
+gstd_cbor_writer_begin_array (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_writer_begin (GSTD_CBOR_WRITER (iface), GSTD_CBOR_ARRAY);
+}
+
+static void
+gstd_cbor_writer_end_array (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_writer_end (GSTD_CBOR_WRITER (iface));
+}
+
+static void
+gstd_cbor_writer_set_member_name (GstdIFormatter * iface, const gchar * name)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+  g_return_if_fail (name);
+
+  /* Inside a map keys and values simply alternate */
+  gstd_cbor_append_text (GSTD_CBOR_WRITER (iface)->buffer, name);
+}
+
+static void
+gstd_cbor_writer_set_string_value (GstdIFormatter * iface, const gchar * value)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_append_text (GSTD_CBOR_WRITER (iface)->buffer, value);
+}
+
+static void
+gstd_cbor_writer_set_null_value (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_writer_append_byte (GSTD_CBOR_WRITER (iface), GSTD_CBOR_NULL);
+}
+
+static void
+gstd_cbor_writer_set_value (GstdIFormatter * iface, const GValue * value)
+{
+  GstdCborWriter *self;
+  gchar *contents;
+
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+  g_return_if_fail (value);
+
+  self = GSTD_CBOR_WRITER (iface);
+
+  /* Same type mapping as the JSON writer, but numbers stay binary */
+  switch (G_VALUE_TYPE (value)) {
+    case G_TYPE_BOOLEAN:
+      gstd_cbor_writer_append_byte (self,
+          g_value_get_boolean (value) ? CBOR_TRUE : CBOR_FALSE);
+      break;
+    case G_TYPE_INT:
+      gstd_cbor_writer_append_int (self, g_value_get_int (value));
+      break;
+    case G_TYPE_UINT:
+      gstd_cbor_append_head (self->buffer, GSTD_CBOR_UINT,
+          g_value_get_uint (value));
+      break;
+    case G_TYPE_INT64:
+      gstd_cbor_writer_append_int (self, g_value_get_int64 (value));
+      break;
+    case G_TYPE_UINT64:
+      gstd_cbor_append_head (self->buffer, GSTD_CBOR_UINT,
+          g_value_get_uint64 (value));
+      break;
+    case G_TYPE_FLOAT:
+      gstd_cbor_writer_append_float (self, g_value_get_float (value));
+      break;
+    case G_TYPE_DOUBLE:
+      gstd_cbor_writer_append_double (self, g_value_get_double (value));
+      break;
+    case G_TYPE_STRING:
+      gstd_cbor_append_text (self->buffer, g_value_get_string (value));
+      break;
+    default:
+      contents = g_strdup_value_contents (value);
+      gstd_cbor_append_text (self->buffer, contents);
+      g_free (contents);
+  }
+}
+
+/*
+ * The output is binary, the trailing NUL only keeps string helpers from
+ * running past the end. Use gstd_cbor_output_get_item() to get the
+ * item and its length.
+ */
+static void
+gstd_cbor_writer_generate (GstdIFormatter * iface, gchar ** outstring)
+{
+  GstdCborWriter *self;
+  const guint8 nul = '\0';
+
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+  g_return_if_fail (outstring);
+
+  self = GSTD_CBOR_WRITER (iface);
+
+  /* Close what was left open so the output is always a complete item */
+  if (self->depth > 0) {
+    GST_WARNING_OBJECT (self, "Generating with %u unclosed levels",
+        self->depth);
+  }
+  while (self->depth > 0) {
+    gstd_cbor_writer_end (self);
+  }
+
+  GST_WRITE_UINT64_BE (self->buffer->data + GSTD_CBOR_MAGIC_SIZE +
+      CBOR_ENCODED_HEAD_SIZE, self->buffer->len - CBOR_OUTPUT_HEADER_SIZE);
+
+  /* Hand the buffer over and start a new one */
+  g_byte_array_append (self->buffer, &nul, 1);
+  *outstring = (gchar *) g_byte_array_free (self->buffer, FALSE);
+
+  self->buffer = g_byte_array_sized_new (CBOR_BUFFER_SIZE);
+  gstd_cbor_writer_reset (self);
+}
+
+static void
+gstd_cbor_writer_reset_iface (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_CBOR_WRITER (iface));
+
+  gstd_cbor_writer_reset (GSTD_CBOR_WRITER (iface));
+}
+
+static void
+gstd_cbor_writer_finalize (GObject * object)
+{
+  GstdCborWriter *self = GSTD_CBOR_WRITER (object);
+
+  GST_LOG_OBJECT (self, "finalize");
+
+  g_byte_array_unref (self->buffer);
+
+  G_OBJECT_CLASS (gstd_cbor_writer_parent_class)->finalize (object);
+}
+
+static void
+gstd_iformatter_interface_init (GstdIFormatterInterface * iface)
+{
+  iface->begin_object = gstd_cbor_writer_begin_object;
+  iface->end_object = gstd_cbor_writer_end_object;
+  iface->begin_array = gstd_cbor_writer_begin_array;
+  iface->end_array = gstd_cbor_writer_end_array;
+  iface->set_member_name = gstd_cbor_writer_set_member_name;
+  iface->set_string_value = gstd_cbor_writer_set_string_value;
+  iface->set_null_value = gstd_cbor_writer_set_null_value;
+  iface->set_value = gstd_cbor_writer_set_value;
+  iface->generate = gstd_cbor_writer_generate;
+  iface->reset = gstd_cbor_writer_reset_iface;
+}
+
+gboolean
+gstd_cbor_has_magic (const gchar * data)
+{
+  g_return_val_if_fail (data, FALSE);
+
+  /* Stops at the first mismatch, so short strings are safe */
+  return 0 == strncmp (data, GSTD_CBOR_MAGIC, GSTD_CBOR_MAGIC_SIZE);
+}
+
+gsize
+gstd_cbor_output_get_item (const gchar * output, const guint8 ** item)
+{
+  guint64 size;
+
+  g_return_val_if_fail (output, 0);
+  g_return_val_if_fail (item, 0);
+
+  /* Neither the magic nor the head contain a NUL, so plain text stops
+   * matching before its end */
+  if (!gstd_cbor_has_magic (output)
+      || strncmp (output + GSTD_CBOR_MAGIC_SIZE, CBOR_ENCODED_HEAD,
+          CBOR_ENCODED_HEAD_SIZE)) {
+    return 0;
+  }
+
+  size = GST_READ_UINT64_BE (output + GSTD_CBOR_MAGIC_SIZE +
+      CBOR_ENCODED_HEAD_SIZE);
+  *item = (const guint8 *) output + CBOR_OUTPUT_HEADER_SIZE;
+
+  /* Walk it within its own length, it must be exactly one item */
+  if (size > G_MAXSIZE || gstd_cbor_item_size (*item, size) != size) {
+    return 0;
+  }
+
+  return size;
+}
+
+/*
+ * Decodes the head of the item at @pos. Returns FALSE if it does not
+ * fit in @size or uses a reserved encoding.
+ */
+static gboolean
+gstd_cbor_read_head (const guint8 * data, gsize size, gsize * pos,
+    guint8 * major, guint8 * info, guint64 * value)
+{
+  guint len;
+
+  if (*pos >= size)
+    return FALSE;
+
+  *major = data[*pos] >> 5;
+  *info = data[*pos] & 0x1f;
+  (*pos)++;
+
+  if (*info < CBOR_AI_1BYTE || CBOR_AI_INDEFINITE == *info) {
+    *value = *info;
+    return TRUE;
+  }
+
+  if (*info > CBOR_AI_8BYTES)
+    return FALSE;
+
+  len = 1 << (*info - CBOR_AI_1BYTE);
+  if (size - *pos < len)
+    return FALSE;
+
+  switch (len) {
+    case 1:
+      *value = data[*pos];
+      break;
+    case 2:
+      *value = GST_READ_UINT16_BE (data + *pos);
+      break;
+    case 4:
+      *value = GST_READ_UINT32_BE (data + *pos);
+      break;
+    default:
+      *value = GST_READ_UINT64_BE (data + *pos);
+      break;
+  }
+  *pos += len;
+
+  return TRUE;
+}
+
+static gboolean
+gstd_cbor_skip (const guint8 * data, gsize size, gsize * pos, guint depth)
+{
+  guint8 major;
+  guint8 info;
+  guint64 value;
+  guint64 count;
+  guint64 i;
+
+  if (depth > CBOR_MAX_DEPTH)
+    return FALSE;
+
+  if (!gstd_cbor_read_head (data, size, pos, &major, &info, &value))
+    return FALSE;
+
+  if (CBOR_AI_INDEFINITE == info) {
+    if (major < GSTD_CBOR_BYTES || major > GSTD_CBOR_MAP)
+      return FALSE;
+
+    /* Chunks or children up to the break */
+    while (*pos < size && CBOR_BREAK != data[*pos]) {
+      if (!gstd_cbor_skip (data, size, pos, depth + 1))
+        return FALSE;
+    }
+    if (*pos >= size)
+      return FALSE;
+    (*pos)++;
+    return TRUE;
+  }
+
+  switch (major) {
+    case GSTD_CBOR_BYTES:
+    case GSTD_CBOR_TEXT:
+      if (size - *pos < value)
+        return FALSE;
+      *pos += value;
+      return TRUE;
+    case GSTD_CBOR_ARRAY:
+    case GSTD_CBOR_MAP:
+      count = GSTD_CBOR_MAP == major ? value * 2 : value;
+      for (i = 0; i < count; i++) {
+        if (!gstd_cbor_skip (data, size, pos, depth + 1))
+          return FALSE;
+      }
+      return TRUE;
+    case GSTD_CBOR_TAG:
+      return gstd_cbor_skip (data, size, pos, depth + 1);
+    default:
+      /* Integers, simple values and floats are all in the head */
+      return TRUE;
+  }
+}
+
+gsize
+gstd_cbor_item_size (const guint8 * data, gsize size)
+{
+  gsize pos = 0;
+
+  g_return_val_if_fail (data, 0);
+
+  if (!gstd_cbor_skip (data, size, &pos, 0))
+    return 0;
+
+  return pos;
+}
+
+/*
+ * Appends the scalar at @pos to @command as a word
+ */
+static gboolean
+gstd_cbor_append_word (const guint8 * data, gsize size, gsize * pos,
+    GString * command)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+  union
+  {
+    guint32 u;
+    gfloat f;
+  } f32;
+  union
+  {
+    guint64 u;
+    gdouble d;
+  } f64;
+  guint8 major;
+  guint8 info;
+  guint64 value;
+  gsize start = *pos;
+
+  if (!gstd_cbor_read_head (data, size, pos, &major, &info, &value)
+      || CBOR_AI_INDEFINITE == info)
+    return FALSE;
+
+  switch (major) {
+    case GSTD_CBOR_UINT:
+      g_string_append_printf (command, "%" G_GUINT64_FORMAT, value);
+      return TRUE;
+    case GSTD_CBOR_NEGINT:
+      if (value > G_MAXINT64)
+        return FALSE;
+      g_string_append_printf (command, "%" G_GINT64_FORMAT,
+          -1 - (gint64) value);
+      return TRUE;
+    case GSTD_CBOR_TEXT:
+      if (size - *pos < value)
+        return FALSE;
+      g_string_append_len (command, (const gchar *) data + *pos, value);
+      *pos += value;
+      return TRUE;
+    case GSTD_CBOR_SIMPLE:
+      if (CBOR_FALSE == data[start] || CBOR_TRUE == data[start]) {
+        g_string_append (command,
+            CBOR_TRUE == data[start] ? "true" : "false");
+        return TRUE;
+      }
+      if (CBOR_FLOAT32 == data[start]) {
+        f32.u = value;
+        g_string_append (command, g_ascii_dtostr (buf, sizeof (buf), f32.f));
+        return TRUE;
+      }
+      if (CBOR_FLOAT64 == data[start]) {
+        f64.u = value;
+        g_string_append (command, g_ascii_dtostr (buf, sizeof (buf), f64.d));
+        return TRUE;
+      }
+      return FALSE;
+    default:
+      return FALSE;
+  }
+}
+
+gchar *
+gstd_cbor_to_command (const guint8 * data, gsize size)
+{
+  GString *command;
+  guint8 major;
+  guint8 info;
+  guint64 count;
+  guint64 i;
+  gsize pos = 0;
+
+  g_return_val_if_fail (data, NULL);
+
+  /* Skip the self-described tag if present */
+  if (size >= GSTD_CBOR_MAGIC_SIZE
+      && 0 == memcmp (data, GSTD_CBOR_MAGIC, GSTD_CBOR_MAGIC_SIZE))
+    pos = GSTD_CBOR_MAGIC_SIZE;
+
+  if (pos >= size)
+    return NULL;
+
+  command = g_string_new (NULL);
+
+  if (GSTD_CBOR_ARRAY != data[pos] >> 5) {
+    if (!gstd_cbor_append_word (data, size, &pos, command))
+      goto error;
+    return g_string_free (command, FALSE);
+  }
+
+  if (!gstd_cbor_read_head (data, size, &pos, &major, &info, &count))
+    goto error;
+
+  for (i = 0; CBOR_AI_INDEFINITE == info || i < count; i++) {
+    if (CBOR_AI_INDEFINITE == info && pos < size && CBOR_BREAK == data[pos])
+      break;
+    if (i > 0)
+      g_string_append_c (command, ' ');
+    if (!gstd_cbor_append_word (data, size, &pos, command))
+      goto error;
+  }
+
+  return g_string_free (command, FALSE);
+
+error:
+  g_string_free (command, TRUE);
+  return NULL;
+}
+
+GByteArray *
+gstd_cbor_envelope (gint code, const gchar * description, const gchar * output)
+{
+  const guint8 null = GSTD_CBOR_NULL;
+  const guint8 *item;
+  GByteArray *envelope;
+  gsize item_len;
+
+  g_return_val_if_fail (description, NULL);
+
+  envelope = g_byte_array_new ();
+  g_byte_array_append (envelope, (const guint8 *) GSTD_CBOR_MAGIC,
+      GSTD_CBOR_MAGIC_SIZE);
+  gstd_cbor_append_head (envelope, GSTD_CBOR_MAP, 3);
+  gstd_cbor_append_text (envelope, "code");
+  if (code < 0)
+    gstd_cbor_append_head (envelope, GSTD_CBOR_NEGINT, -1 - (gint64) code);
+  else
+    gstd_cbor_append_head (envelope, GSTD_CBOR_UINT, code);
+  gstd_cbor_append_text (envelope, "description");
+  gstd_cbor_append_text (envelope, description);
+  gstd_cbor_append_text (envelope, "response");
+
+  if (NULL == output) {
+    g_byte_array_append (envelope, &null, 1);
+  } else if ((item_len = gstd_cbor_output_get_item (output, &item))) {
+    /* Embed the item without its tags */
+    g_byte_array_append (envelope, item, item_len);
+  } else if (gstd_cbor_has_magic (output)) {
+    GST_WARNING ("Dropping a malformed CBOR output");
+    g_byte_array_append (envelope, &null, 1);
+  } else {
+    /* Commands that answer with plain text */
+    gstd_cbor_append_text (envelope, output);
+  }
+
+  return envelope;
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_CBOR_WRITER_H__
+#define __GSTD_CBOR_WRITER_H__
+
+#include <gst/gst.h>
+
+#include "gstd_iformatter.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_CBOR_WRITER \
+  (gstd_cbor_writer_get_type())
+#define GSTD_CBOR_WRITER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_CBOR_WRITER,GstdCborWriter))
+#define GSTD_CBOR_WRITER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_CBOR_WRITER,GstdCborWriterClass))
+#define GSTD_IS_CBOR_WRITER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_CBOR_WRITER))
+#define GSTD_IS_CBOR_WRITER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_CBOR_WRITER))
+#define GSTD_CBOR_WRITER_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_CBOR_WRITER, GstdCborWriterClass))
+
+typedef struct _GstdCborWriter GstdCborWriter;
+
+GType gstd_cbor_writer_get_type (void);
+
+/* CBOR major types (RFC 8949) */
+#define GSTD_CBOR_UINT   0
+#define GSTD_CBOR_NEGINT 1
+#define GSTD_CBOR_BYTES  2
+#define GSTD_CBOR_TEXT   3
+#define GSTD_CBOR_ARRAY  4
+#define GSTD_CBOR_MAP    5
+#define GSTD_CBOR_TAG    6
+#define GSTD_CBOR_SIMPLE 7
+
+#define GSTD_CBOR_NULL   0xf6
+
+/*
+ * Every generated output starts with the self-described CBOR tag
+ * (55799). No JSON text starts with it, so callers that only get a
+ * string back can tell both encodings apart. The item follows as
+ * encoded CBOR (tag 24), so its length is known without walking it.
+ */
+#define GSTD_CBOR_MAGIC      "\xd9\xd9\xf7"
+#define GSTD_CBOR_MAGIC_SIZE 3
+
+/**
+ * gstd_cbor_has_magic:
+ * @data: A NUL terminated string or a generated CBOR output
+ *
+ * Returns: TRUE if @data was produced by a #GstdCborWriter.
+ */
+gboolean gstd_cbor_has_magic (const gchar * data);
+
+/**
+ * gstd_cbor_output_get_item:
+ * @output: A NUL terminated string or a generated CBOR output
+ * @item: (out): The item carried by @output
+ *
+ * Returns: The size of @item, checked to hold exactly one well formed
+ * item, or 0 if @output was not produced by a #GstdCborWriter.
+ */
+gsize gstd_cbor_output_get_item (const gchar * output, const guint8 ** item);
+
+/**
+ * gstd_cbor_item_size:
+ * @data: Encoded data
+ * @size: Amount of bytes available in @data
+ *
+ * Returns: The size of the first complete item in @data, or 0 if it is
+ * incomplete or malformed.
+ */
+gsize gstd_cbor_item_size (const guint8 * data, gsize size);
+
+void gstd_cbor_append_head (GByteArray * out, guint8 major, guint64 value);
+void gstd_cbor_append_text (GByteArray * out, const gchar * text);
+
+/**
+ * gstd_cbor_to_command:
+ * @data: A complete CBOR item
+ * @size: Size of @data
+ *
+ * Decodes a request: either a text string holding the command, or an
+ * array of text strings, integers, floats and booleans holding its
+ * words.
+ *
+ * Returns: (transfer full) (nullable): The command as text, or NULL
+ * if @data is not a valid request.
+ */
+gchar *gstd_cbor_to_command (const guint8 * data, gsize size);
+
+/**
+ * gstd_cbor_envelope:
+ * @code: The command return code
+ * @description: The description of @code
+ * @output: (nullable): The command output, either generated by a
+ * #GstdCborWriter or plain text
+ *
+ * Returns: (transfer full): A map with the code, description and
+ * response members of the JSON envelope, tagged as CBOR.
+ */
+GByteArray *gstd_cbor_envelope (gint code, const gchar * description,
+    const gchar * output);
+
+G_END_DECLS
+
+#endif // __GSTD_CBOR_WRITER_H__
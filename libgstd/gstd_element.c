@@ -29,9 +29,9 @@
 
 #include "gstd_action.h"
 #include "gstd_element.h"
+#include "gstd_element_reader.h"
 #include "gstd_event_handler.h"
 #include "gstd_iformatter.h"
-#include "gstd_json_builder.h"
 #include "gstd_list.h"
 #include "gstd_list_reader.h"
 #include "gstd_object.h"
@@ -51,6 +51,7 @@ enum
   PROP_PROPERTIES,
   PROP_SIGNALS,
   PROP_ACTIONS,
+  PROP_INDEX,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
@@ -94,6 +95,11 @@ struct _GstdElement
    * The actions held by the element
    */
   GstdList *element_actions;
+
+  /*
+   * The element index of the pipeline, to find the children of bins
+   */
+  GWeakRef index;
 };
 
 struct _GstdElementClass
@@ -110,6 +116,7 @@ gstd_element_get_property (GObject *, guint, GValue *, GParamSpec *);
 static void
 gstd_element_set_property (GObject *, guint, const GValue *, GParamSpec *);
 static void gstd_element_dispose (GObject *);
+static void gstd_element_finalize (GObject *);
 static GstdReturnCode gstd_element_to_string (GstdObject *, gchar **);
 void gstd_element_internal_to_string (GstdElement *, gchar **);
 void gstd_element_properties_to_string (GstdElement * self,
@@ -118,10 +125,11 @@ void gstd_element_signals_to_string (GstdElement * self,
     GstdIFormatter * formatter);
 void gstd_element_actions_to_string (GstdElement * self,
     GstdIFormatter * formatter);
-static GstdReturnCode gstd_element_fill_properties (GstdElement * self);
-static GstdReturnCode gstd_element_fill_signals_and_actions (GstdElement *
-    self);
+static GstdList *gstd_element_get_list (GstdElement * self, guint property_id);
 static GType gstd_element_property_get_type (GType g_type);
+
+typedef void (*GstdElementPropertyFunc) (const gchar * name, GObject * target,
+    GParamSpec * pspec, gpointer user_data);
 static void
 gstd_element_class_init (GstdElementClass * klass)
 {
@@ -133,6 +141,7 @@ gstd_element_class_init (GstdElementClass * klass)
   object_class->set_property = gstd_element_set_property;
   object_class->get_property = gstd_element_get_property;
   object_class->dispose = gstd_element_dispose;
+  object_class->finalize = gstd_element_finalize;
 
   properties[PROP_GSTELEMENT] =
       g_param_spec_object ("gstelement",
@@ -168,6 +177,13 @@ gstd_element_class_init (GstdElementClass * klass)
       GSTD_TYPE_LIST,
       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
 
+  properties[PROP_INDEX] =
+      g_param_spec_object ("index",
+      "Index",
+      "The list indexing every element of the pipeline by path",
+      GSTD_TYPE_LIST,
+      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   gstd_object_class->to_string = gstd_element_to_string;
@@ -187,29 +203,13 @@ gstd_element_init (GstdElement * self)
   self->event_handler = NULL;
 
   gstd_object_set_reader (GSTD_OBJECT (self),
-      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
-
-  self->element_properties =
-      GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "element_properties",
-          "node-type", GSTD_TYPE_PROPERTY, "flags", GSTD_PARAM_READ, NULL));
-
-  self->element_signals =
-      GSTD_LIST (g_object_new (GSTD_TYPE_SIGNAL_LIST, "name", "element_signals",
-          "node-type", GSTD_TYPE_SIGNAL, "flags", GSTD_PARAM_READ, NULL));
-
-  self->element_actions =
-      GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "element_actions",
-          "node-type", GSTD_TYPE_ACTION, "flags", GSTD_PARAM_READ, NULL));
-
-  gstd_object_set_reader (GSTD_OBJECT (self->element_properties),
-      g_object_new (GSTD_TYPE_LIST_READER, NULL));
-
-  gstd_object_set_reader (GSTD_OBJECT (self->element_signals),
-      g_object_new (GSTD_TYPE_LIST_READER, NULL));
-
-  gstd_object_set_reader (GSTD_OBJECT (self->element_actions),
-      g_object_new (GSTD_TYPE_LIST_READER, NULL));
+      g_object_new (GSTD_TYPE_ELEMENT_READER, NULL));
+  g_weak_ref_init (&self->index, NULL);
 
+  /* Created on first use, see gstd_element_get_list() */
+  self->element_properties = NULL;
+  self->element_signals = NULL;
+  self->element_actions = NULL;
 }
 
 static void
@@ -229,13 +229,24 @@ gstd_element_dispose (GObject * object)
     self->event_handler = NULL;
   }
 
-  g_object_unref (self->element_properties);
-  g_object_unref (self->element_signals);
-  g_object_unref (self->element_actions);
+  g_clear_object (&self->element_properties);
+  g_clear_object (&self->element_signals);
+  g_clear_object (&self->element_actions);
+  g_weak_ref_set (&self->index, NULL);
 
   G_OBJECT_CLASS (gstd_element_parent_class)->dispose (object);
 }
 
+static void
+gstd_element_finalize (GObject * object)
+{
+  GstdElement *self = GSTD_ELEMENT (object);
+
+  g_weak_ref_clear (&self->index);
+
+  G_OBJECT_CLASS (gstd_element_parent_class)->finalize (object);
+}
+
 static void
 gstd_element_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec)
@@ -254,17 +265,10 @@ gstd_element_get_property (GObject * object,
       g_value_set_object (value, self->event_handler);
       break;
     case PROP_PROPERTIES:
-      GST_DEBUG_OBJECT (self, "Returning properties %p",
-          self->element_properties);
-      g_value_set_object (value, self->element_properties);
-      break;
     case PROP_SIGNALS:
-      GST_DEBUG_OBJECT (self, "Returning signals %p", self->element_signals);
-      g_value_set_object (value, self->element_signals);
-      break;
     case PROP_ACTIONS:
-      GST_DEBUG_OBJECT (self, "Returning actions %p", self->element_actions);
-      g_value_set_object (value, self->element_actions);
+      GST_DEBUG_OBJECT (self, "Returning %s", pspec->name);
+      g_value_take_object (value, gstd_element_get_list (self, property_id));
       break;
     default:
       /* We don't have any other property... */
@@ -290,9 +294,9 @@ gstd_element_set_property (GObject * object,
 
       GST_DEBUG_OBJECT (self, "Setting element %p (%s)", self->element,
           GST_OBJECT_NAME (self->element));
-
-      gstd_element_fill_properties (self);
-      gstd_element_fill_signals_and_actions (self);
+      break;
+    case PROP_INDEX:
+      g_weak_ref_set (&self->index, g_value_get_object (value));
       break;
     default:
       /* We don't have any other property... */
@@ -305,118 +309,193 @@ static GstdReturnCode
 gstd_element_to_string (GstdObject * object, gchar ** outstring)
 {
   GstdElement *self = GSTD_ELEMENT (object);
-  gchar *props;
-  gchar *internal;
+  GstdIFormatter *formatter = NULL;
 
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
   g_warn_if_fail (!*outstring);
 
-  /* Lets leverage the parent's class implementation */
-  GSTD_OBJECT_CLASS (gstd_element_parent_class)->to_string (GSTD_OBJECT
-      (object), &props);
-  // A little hack to remove the last bracket
-  props[strlen (props) - 2] = '\0';
+  /* Write the object properties and the ones of the internal GST
+   * element in a single pass, so the output is valid in any encoding */
+  formatter = gstd_object_new_formatter (object);
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_object_format_properties (object, formatter);
+  gstd_element_properties_to_string (self, formatter);
+  gstd_element_signals_to_string (self, formatter);
+  gstd_element_actions_to_string (self, formatter);
+
+  gstd_iformatter_end_object (formatter);
 
-  // Now parse the properties of the internal GST element
-  gstd_element_internal_to_string (self, &internal);
+  gstd_iformatter_generate (formatter, outstring);
 
-  *outstring = g_strdup_printf ("%s,%s", props, internal);
-  g_free (props);
-  g_free (internal);
+  /* Free formatter */
+  g_object_unref (formatter);
 
   return GSTD_EOK;
 }
 
-void
-gstd_element_properties_to_string (GstdElement * self,
-    GstdIFormatter * formatter)
+static void
+gstd_element_property_to_string (const gchar * name, GObject * target,
+    GParamSpec * pspec, gpointer user_data)
 {
-  GList *list;
-  GParamSpec *pspec;
+  GstdIFormatter *formatter = user_data;
   GValue value = G_VALUE_INIT;
   GValue flags = G_VALUE_INIT;
   const gchar *typename;
   gchar *sflags;
 
-  g_return_if_fail (GSTD_IS_OBJECT (self));
+  /* Describe each parameter using a structure */
+  gstd_iformatter_begin_object (formatter);
 
-  gstd_iformatter_set_member_name (formatter, "element_properties");
-  gstd_iformatter_begin_array (formatter);
+  gstd_iformatter_set_member_name (formatter, "name");
 
-  list = self->element_properties->list;
-  while (list) {
-    GstdProperty *property = list->data;
-
-    if (property->pspec)
-      pspec = property->pspec;
-    else
-      pspec =
-          g_object_class_find_property (G_OBJECT_GET_CLASS (property->target),
-          GSTD_OBJECT_NAME (property));
-    /* Describe each parameter using a structure */
-    gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_string_value (formatter, name);
 
-    gstd_iformatter_set_member_name (formatter, "name");
+  typename = g_type_name (pspec->value_type);
 
-    gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (property));
+  g_value_init (&value, pspec->value_type);
+  g_object_get_property (target, pspec->name, &value);
 
-    typename = g_type_name (pspec->value_type);
+  gstd_iformatter_set_member_name (formatter, "value");
+  gstd_iformatter_set_value (formatter, &value);
 
-    g_value_init (&value, pspec->value_type);
-    g_object_get_property (G_OBJECT (property->target), pspec->name, &value);
+  gstd_iformatter_set_member_name (formatter, "param");
+  /* Describe the parameter specs using a structure */
+  gstd_iformatter_begin_object (formatter);
 
-    gstd_iformatter_set_member_name (formatter, "value");
-    gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
 
-    gstd_iformatter_set_member_name (formatter, "param");
-    /* Describe the parameter specs using a structure */
-    gstd_iformatter_begin_object (formatter);
+  g_value_init (&flags, GSTD_TYPE_PARAM_FLAGS);
+  g_value_set_flags (&flags, pspec->flags);
+  sflags = g_strdup_value_contents (&flags);
+  g_value_unset (&flags);
 
-    g_value_unset (&value);
+  gstd_iformatter_set_member_name (formatter, "description");
+  gstd_iformatter_set_string_value (formatter, pspec->_blurb);
 
-    g_value_init (&flags, GSTD_TYPE_PARAM_FLAGS);
-    g_value_set_flags (&flags, pspec->flags);
-    sflags = g_strdup_value_contents (&flags);
-    g_value_unset (&flags);
+  gstd_iformatter_set_member_name (formatter, "type");
+  gstd_iformatter_set_string_value (formatter, typename);
 
-    gstd_iformatter_set_member_name (formatter, "description");
-    gstd_iformatter_set_string_value (formatter, pspec->_blurb);
+  gstd_iformatter_set_member_name (formatter, "access");
+  gstd_iformatter_set_string_value (formatter, sflags);
 
-    gstd_iformatter_set_member_name (formatter, "type");
-    gstd_iformatter_set_string_value (formatter, typename);
+  /* Close parameter specs structure */
+  gstd_iformatter_end_object (formatter);
 
-    gstd_iformatter_set_member_name (formatter, "access");
-    gstd_iformatter_set_string_value (formatter, sflags);
+  g_free (sflags);
 
-    /* Close parameter specs structure */
-    gstd_iformatter_end_object (formatter);
+  /* Close parameter structure */
+  gstd_iformatter_end_object (formatter);
+}
 
-    g_free (sflags);
+/*
+ * Calls @func for every property of @object and, through the child
+ * proxy interface, of its children, named "child::property".
+ * Children's properties come after their parent's, depth first.
+ */
+static void
+gstd_element_foreach_property (GObject * object, const gchar * prefix,
+    GstdElementPropertyFunc func, gpointer user_data)
+{
+  GParamSpec **pspecs;
+  guint n_pspecs;
+  GObject *child;
+  gchar *name;
+  guint count;
+  guint i;
 
-    /* Close parameter structure */
-    gstd_iformatter_end_object (formatter);
+  pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (object),
+      &n_pspecs);
+  for (i = 0; i < n_pspecs; i++) {
+    name = g_strconcat (prefix ? prefix : "", pspecs[i]->name, NULL);
+    func (name, object, pspecs[i], user_data);
+    g_free (name);
+  }
+  g_free (pspecs);
 
-    list = list->next;
+  if (!GST_IS_CHILD_PROXY (object)) {
+    return;
   }
 
+  count = gst_child_proxy_get_children_count (GST_CHILD_PROXY (object));
+  for (i = 0; i < count; i++) {
+    child = gst_child_proxy_get_child_by_index (GST_CHILD_PROXY (object), i);
+    if (!child || !GST_IS_OBJECT (child)) {
+      g_clear_object (&child);
+      continue;
+    }
+
+    name = g_strconcat (prefix ? prefix : "", GST_OBJECT_NAME (child), "::",
+        NULL);
+    gstd_element_foreach_property (child, name, func, user_data);
+    g_free (name);
+    g_object_unref (child);
+  }
+}
+
+void
+gstd_element_properties_to_string (GstdElement * self,
+    GstdIFormatter * formatter)
+{
+  g_return_if_fail (GSTD_IS_OBJECT (self));
+
+  gstd_iformatter_set_member_name (formatter, "element_properties");
+  gstd_iformatter_begin_array (formatter);
+
+  /* Straight from the element, no GstdProperty needs to exist */
+  gstd_element_foreach_property (G_OBJECT (self->element), NULL,
+      gstd_element_property_to_string, formatter);
+
   gstd_iformatter_end_array (formatter);
 
 }
 
+/*
+ * Returns the names of the signals of @element across its type
+ * hierarchy, either the action signals or the rest.
+ */
+static GPtrArray *
+gstd_element_list_signals (GstElement * element, gboolean actions)
+{
+  GPtrArray *names = g_ptr_array_new_with_free_func (g_free);
+  GSignalQuery query;
+  guint *signals;
+  guint n_signals;
+  GType type;
+  guint i;
+
+  for (type = G_OBJECT_TYPE (element); type; type = g_type_parent (type)) {
+    signals = g_signal_list_ids (type, &n_signals);
+
+    for (i = 0; i < n_signals; ++i) {
+      g_signal_query (signals[i], &query);
+      if (!(query.signal_flags & G_SIGNAL_ACTION) == !actions) {
+        g_ptr_array_add (names, g_strdup (query.signal_name));
+      }
+    }
+    g_free (signals);
+  }
+
+  return names;
+}
+
 static void
 gstd_element_signals_to_string_internal (GstdElement * self,
-    GList * signal_list, GstdIFormatter * formatter)
+    gboolean actions, GstdIFormatter * formatter)
 {
+  GPtrArray *names;
   GSignalQuery query;
+  guint i;
   guint j;
   const gchar *typename;
 
   gstd_iformatter_begin_array (formatter);
 
-  while (signal_list) {
+  names = gstd_element_list_signals (self->element, actions);
+  for (i = 0; i < names->len; i++) {
     guint signal_id;
 
-    signal_id = g_signal_lookup (GSTD_OBJECT_NAME (signal_list->data),
+    signal_id = g_signal_lookup (g_ptr_array_index (names, i),
         G_OBJECT_TYPE (self->element));
     g_signal_query (signal_id, &query);
 
@@ -440,9 +519,8 @@ gstd_element_signals_to_string_internal (GstdElement * self,
 
     /* Close signal structure */
     gstd_iformatter_end_object (formatter);
-
-    signal_list = signal_list->next;
   }
+  g_ptr_array_unref (names);
 
   gstd_iformatter_end_array (formatter);
 }
@@ -450,25 +528,19 @@ gstd_element_signals_to_string_internal (GstdElement * self,
 void
 gstd_element_signals_to_string (GstdElement * self, GstdIFormatter * formatter)
 {
-  GList *signal_list;
-
   g_return_if_fail (GSTD_IS_OBJECT (self));
 
   gstd_iformatter_set_member_name (formatter, "element_signals");
-  signal_list = self->element_signals->list;
-  gstd_element_signals_to_string_internal (self, signal_list, formatter);
+  gstd_element_signals_to_string_internal (self, FALSE, formatter);
 }
 
 void
 gstd_element_actions_to_string (GstdElement * self, GstdIFormatter * formatter)
 {
-  GList *action_list = NULL;
-
   g_return_if_fail (GSTD_IS_OBJECT (self));
 
   gstd_iformatter_set_member_name (formatter, "element_actions");
-  action_list = self->element_actions->list;
-  gstd_element_signals_to_string_internal (self, action_list, formatter);
+  gstd_element_signals_to_string_internal (self, TRUE, formatter);
 }
 
 void
@@ -478,7 +550,7 @@ gstd_element_internal_to_string (GstdElement * self, gchar ** outstring)
 
   g_return_if_fail (GSTD_IS_OBJECT (self));
 
-  formatter = g_object_new (GSTD_TYPE_JSON_BUILDER, NULL);
+  formatter = gstd_object_new_formatter (GSTD_OBJECT (self));
   gstd_iformatter_begin_object (formatter);
 
   gstd_element_properties_to_string (self, formatter);
@@ -493,143 +565,163 @@ gstd_element_internal_to_string (GstdElement * self, gchar ** outstring)
   g_object_unref (formatter);
 }
 
-static GstdReturnCode
-gstd_element_append_object_properties (GstObject * object,
-    GstdList * properties, GstElement * target, gchar * property_suffix)
+static void
+gstd_element_add_property_name (const gchar * name, GObject * target,
+    GParamSpec * pspec, gpointer user_data)
 {
-  GParamSpec **properties_array;
-  guint n_properties;
-  GstdObject *element_property;
-  GType type;
-  GObjectClass *g_class;
-  guint i;
-  gchar *property_name;
-
-  g_return_val_if_fail (GST_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (GST_IS_OBJECT (target), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (properties, GSTD_NULL_ARGUMENT);
-
-  GST_DEBUG_OBJECT (target, "Gathering \"%s\" properties",
-      GST_OBJECT_NAME (object));
-
-  g_class = G_OBJECT_GET_CLASS (object);
-  properties_array = g_object_class_list_properties (g_class, &n_properties);
-
-  for (i = 0; i < n_properties; ++i) {
-    type = gstd_element_property_get_type (properties_array[i]->value_type);
-    if (property_suffix)
-      property_name =
-          g_strconcat (property_suffix, properties_array[i]->name, NULL);
-    else
-      property_name = g_strdup (properties_array[i]->name);
-
-    element_property = g_object_new (type, "name",
-        property_name, "target", target, "pspec", properties_array[i], NULL);
+  g_ptr_array_add (user_data, g_strdup (name));
+}
 
-    g_free (property_name);
-    gstd_list_append_child (properties, element_property);
-  }
+static GPtrArray *
+gstd_element_property_names (GstdList * list, gpointer user_data)
+{
+  GPtrArray *names = g_ptr_array_new_with_free_func (g_free);
 
-  g_free (properties_array);
+  gstd_element_foreach_property (user_data, NULL,
+      gstd_element_add_property_name, names);
 
-  return GSTD_EOK;
+  return names;
 }
 
-static GstdReturnCode
-gstd_element_fill_child_properties (GstdElement * self, GstObject * element,
-    gchar * hierarchy)
+/*
+ * Resolves "child::grandchild::property" through the child proxies
+ * down to the object owning the property.
+ */
+static GstdObject *
+gstd_element_make_property (GstdList * list, const gchar * name,
+    gpointer user_data)
 {
+  GstdObject *property = NULL;
+  GObject *target = g_object_ref (user_data);
   GObject *child;
-  guint count;
-  gint i;
-  gchar *suffix;
-
-  if (!GST_IS_CHILD_PROXY (element))
-    goto out;
-
-  count = gst_child_proxy_get_children_count (GST_CHILD_PROXY (element));
-
-  GST_DEBUG_OBJECT (self, "%s has %d childrens", GST_OBJECT_NAME (element),
-      count);
-  if (!count)
-    goto out;
-
-  for (i = 0; i < count; i++) {
-    child = gst_child_proxy_get_child_by_index (GST_CHILD_PROXY (element), i);
-    if (!child || !GST_IS_OBJECT (child))
-      continue;
+  GParamSpec *pspec;
+  GString *canonical = g_string_new (NULL);
+  gchar **path;
+  guint n;
+  guint i;
 
-    if (hierarchy)
-      suffix = g_strconcat (hierarchy, GST_OBJECT_NAME (child), "::", NULL);
-    else
-      suffix = g_strdup_printf ("%s::", GST_OBJECT_NAME (child));
+  path = g_strsplit (name, "::", -1);
+  n = g_strv_length (path);
 
-    GST_DEBUG_OBJECT (self, "Child suffix %s", suffix);
-    gstd_element_fill_child_properties (self, GST_OBJECT (child), suffix);
+  for (i = 0; i + 1 < n; i++) {
+    child = GST_IS_CHILD_PROXY (target) ?
+        gst_child_proxy_get_child_by_name (GST_CHILD_PROXY (target),
+        path[i]) : NULL;
+    g_object_unref (target);
+    target = child;
 
-    gstd_element_append_object_properties (GST_OBJECT (child),
-        self->element_properties, GST_ELEMENT_CAST (child), suffix);
+    if (!target || !GST_IS_OBJECT (target)) {
+      goto out;
+    }
+    g_string_append_printf (canonical, "%s::", GST_OBJECT_NAME (target));
+  }
 
-    g_free (suffix);
-    g_object_unref (child);
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (target),
+      path[n - 1]);
+  if (!pspec) {
+    goto out;
   }
+  g_string_append (canonical, pspec->name);
+
+  property = g_object_new (gstd_element_property_get_type (pspec->value_type),
+      "name", canonical->str, "target", target, "pspec", pspec, NULL);
 
 out:
-  return GSTD_EOK;
+  g_clear_object (&target);
+  g_string_free (canonical, TRUE);
+  g_strfreev (path);
+
+  return property;
 }
 
-static GstdReturnCode
-gstd_element_fill_properties (GstdElement * self)
+static GPtrArray *
+gstd_element_signal_names (GstdList * list, gpointer user_data)
 {
-
-  g_return_val_if_fail (GSTD_IS_ELEMENT (self), GSTD_NULL_ARGUMENT);
-
-  gstd_element_append_object_properties (GST_OBJECT (self->element),
-      self->element_properties, self->element, NULL);
-
-  gstd_element_fill_child_properties (self, GST_OBJECT (self->element), NULL);
-  return GSTD_EOK;
+  return gstd_element_list_signals (user_data, FALSE);
 }
 
+static GPtrArray *
+gstd_element_action_names (GstdList * list, gpointer user_data)
+{
+  return gstd_element_list_signals (user_data, TRUE);
+}
 
-static GstdReturnCode
-gstd_element_fill_signals_and_actions (GstdElement * self)
+/* Creates the GstdSignal or GstdAction, whichever the list holds */
+static GstdObject *
+gstd_element_make_signal (GstdList * list, const gchar * name,
+    gpointer user_data)
 {
-  guint *signals;
-  guint n_signals;
   GSignalQuery query;
-  GstdObject *gstd_object;
-  GType type;
-  guint i;
+  guint signal_id;
+  gboolean action;
 
-  g_return_val_if_fail (GSTD_IS_ELEMENT (self), GSTD_NULL_ARGUMENT);
+  signal_id = g_signal_lookup (name, G_OBJECT_TYPE (user_data));
+  if (0 == signal_id) {
+    return NULL;
+  }
 
-  GST_DEBUG_OBJECT (self, "Gathering \"%s\" signals & actions",
-      GST_OBJECT_NAME (self->element));
+  g_signal_query (signal_id, &query);
+  action = GSTD_TYPE_ACTION == list->node_type;
+  if (!(query.signal_flags & G_SIGNAL_ACTION) != !action) {
+    return NULL;
+  }
 
-  for (type = G_OBJECT_TYPE (self->element); type; type = g_type_parent (type)) {
+  return g_object_new (list->node_type, "name", query.signal_name, "target",
+      user_data, NULL);
+}
 
-    signals = g_signal_list_ids (type, &n_signals);
+/*
+ * The lists are only created when first read, and their nodes when
+ * first looked up. Most of the properties and signals of an element
+ * are never touched.
+ */
+static GstdList *
+gstd_element_get_list (GstdElement * self, guint property_id)
+{
+  GstdList **list;
+  GType list_type = GSTD_TYPE_LIST;
+  GType node_type;
+  const gchar *name;
+  GstdListNamesFunc names;
+  GstdListNodeFunc make_node;
 
-    for (i = 0; i < n_signals; ++i) {
-      g_signal_query (signals[i], &query);
+  switch (property_id) {
+    case PROP_PROPERTIES:
+      list = &self->element_properties;
+      name = "element_properties";
+      node_type = GSTD_TYPE_PROPERTY;
+      names = gstd_element_property_names;
+      make_node = gstd_element_make_property;
+      break;
+    case PROP_SIGNALS:
+      list = &self->element_signals;
+      list_type = GSTD_TYPE_SIGNAL_LIST;
+      name = "element_signals";
+      node_type = GSTD_TYPE_SIGNAL;
+      names = gstd_element_signal_names;
+      make_node = gstd_element_make_signal;
+      break;
+    default:
+      list = &self->element_actions;
+      name = "element_actions";
+      node_type = GSTD_TYPE_ACTION;
+      names = gstd_element_action_names;
+      make_node = gstd_element_make_signal;
+      break;
+  }
 
-      GST_DEBUG_OBJECT (self, "signal/action query %d: name %s", i,
-          query.signal_name);
-      if (query.signal_flags & G_SIGNAL_ACTION) {
-        gstd_object = g_object_new (GSTD_TYPE_ACTION, "name",
-            query.signal_name, "target", self->element, NULL);
-        gstd_list_append_child (self->element_actions, gstd_object);
-      } else {
-        gstd_object = g_object_new (GSTD_TYPE_SIGNAL, "name",
-            query.signal_name, "target", self->element, NULL);
-        gstd_list_append_child (self->element_signals, gstd_object);
-      }
-    }
-    g_free (signals);
+  GST_OBJECT_LOCK (self);
+  if (NULL == *list && self->element) {
+    *list = GSTD_LIST (g_object_new (list_type, "name", name, "node-type",
+            node_type, "flags", GSTD_PARAM_READ, NULL));
+    gstd_object_set_reader (GSTD_OBJECT (*list),
+        g_object_new (GSTD_TYPE_LIST_READER, NULL));
+    gstd_list_set_node_factory (*list, names, make_node,
+        gst_object_ref (self->element), gst_object_unref);
   }
+  GST_OBJECT_UNLOCK (self);
 
-  return GSTD_EOK;
+  return *list ? g_object_ref (*list) : NULL;
 }
 
 static GType
@@ -676,3 +768,30 @@ gstd_element_property_get_type (GType g_type)
     }
   }
 }
+
+GstdObject *
+gstd_element_find_child (GstdElement * self, const gchar * name)
+{
+  GstdList *index;
+  GstdObject *child = NULL;
+  gchar *path;
+
+  g_return_val_if_fail (GSTD_IS_ELEMENT (self), NULL);
+  g_return_val_if_fail (name, NULL);
+
+  if (!GST_IS_BIN (self->element)) {
+    return NULL;
+  }
+
+  index = g_weak_ref_get (&self->index);
+  if (!index) {
+    return NULL;
+  }
+
+  path = g_strconcat (GSTD_OBJECT_NAME (self), "/", name, NULL);
+  child = gstd_list_find_child (index, path);
+  g_free (path);
+  g_object_unref (index);
+
+  return child;
+}
@@ -23,6 +23,8 @@
 
 #include <glib-object.h>
 
+#include "gstd_object.h"
+
 G_BEGIN_DECLS
 /*
  * Type declaration.
@@ -43,5 +45,18 @@ typedef struct _GstdElement GstdElement;
 typedef struct _GstdElementClass GstdElementClass;
 GType gstd_element_get_type (void);
 
+/**
+ * gstd_element_find_child:
+ * @self: A bin element
+ * @name: The name of a child of the bin
+ *
+ * Looks the child up in the element index of the pipeline, where it
+ * is kept under the path of @self followed by "/@name".
+ *
+ * Returns: (transfer full) (nullable): The child #GstdElement, NULL if
+ * there is none or the pipeline is gone.
+ */
+GstdObject *gstd_element_find_child (GstdElement * self, const gchar * name);
+
 G_END_DECLS
 #endif // __GSTD_ELEMENT_H__
@@ -0,0 +1,109 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+
+#include "gstd_element.h"
+#include "gstd_element_reader.h"
+#include "gstd_property_reader.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_element_reader_debug);
+#define GST_CAT_DEFAULT gstd_element_reader_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static GstdReturnCode gstd_element_reader_read (GstdIReader * iface,
+    GstdObject * object, const gchar * name, GstdObject ** out);
+
+typedef struct _GstdElementReaderClass GstdElementReaderClass;
+
+struct _GstdElementReader
+{
+  GstdPropertyReader parent;
+};
+
+struct _GstdElementReaderClass
+{
+  GstdPropertyReaderClass parent_class;
+};
+
+static GstdIReaderInterface *parent_interface = NULL;
+
+static void
+gstd_ireader_interface_init (GstdIReaderInterface * iface)
+{
+  parent_interface = g_type_interface_peek_parent (iface);
+
+  iface->read = gstd_element_reader_read;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdElementReader, gstd_element_reader,
+    GSTD_TYPE_PROPERTY_READER, G_IMPLEMENT_INTERFACE (GSTD_TYPE_IREADER,
+        gstd_ireader_interface_init));
+
+static void
+gstd_element_reader_class_init (GstdElementReaderClass * klass)
+{
+  guint debug_color;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_element_reader_debug, "gstdelementreader",
+      debug_color, "Gstd Element Reader category");
+}
+
+static void
+gstd_element_reader_init (GstdElementReader * self)
+{
+  GST_INFO_OBJECT (self, "Initializing element reader");
+}
+
+static GstdReturnCode
+gstd_element_reader_read (GstdIReader * iface, GstdObject * object,
+    const gchar * name, GstdObject ** out)
+{
+  GstdObject *child;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (GSTD_IS_ELEMENT (object), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (name, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
+
+  /* The element's own resources take precedence over its children */
+  if (g_object_class_find_property (G_OBJECT_GET_CLASS (object), name)) {
+    return parent_interface->read (iface, object, name, out);
+  }
+
+  child = gstd_element_find_child (GSTD_ELEMENT (object), name);
+  if (!child) {
+    GST_ERROR_OBJECT (iface, "No %s resource in %s", name,
+        GSTD_OBJECT_NAME (object));
+    return GSTD_NO_RESOURCE;
+  }
+
+  *out = child;
+
+  return GSTD_EOK;
+}
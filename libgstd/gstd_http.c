@@ -28,10 +28,14 @@
 #include <libsoup/soup.h>
 #include <json-glib/json-glib.h>
 
+#include "gstd_cbor_writer.h"
 #include "gstd_http.h"
 #include "gstd_list.h"
+#include "gstd_metrics.h"
 #include "gstd_parser.h"
+#include "gstd_bus_msg.h"
 #include "gstd_pipeline.h"
+#include "gstd_pipeline_bus.h"
 #include "gstd_session.h"
 
 /* Gstd HTTP debugging category */
@@ -46,14 +50,72 @@ typedef SoupServerMessage SoupMsg;
 typedef SoupMessage SoupMsg;
 #endif
 
+/*
+ * A client following a pipeline bus through server-sent events. The
+ * thread posting a message only schedules a flush, which pulls the
+ * messages from the bus ring in the server context. Nothing is pulled
+ * while a chunk is being written, so a stalled client loses the
+ * oldest messages instead of having them pile up.
+ */
+typedef struct _GstdHttpStream
+{
+  gint refcount;
+  SoupServer *server;
+  SoupMsg *msg;
+  GMainContext *context;
+  GstdPipelineBus *bus;
+  guint id;
+  gint types;
+
+  /* Protects scheduled and closed */
+  GMutex lock;
+  gboolean scheduled;
+  gboolean closed;
+
+  /* Only used from the server context */
+  guint64 seq;
+  gboolean writing;
+  gboolean finished;
+} GstdHttpStream;
+
+/*
+ * A client waiting for a status newer than since. Everything but the
+ * watch function runs in the server context.
+ */
+typedef struct _GstdHttpStatusPoll
+{
+  gint refcount;
+  SoupServer *server;
+  SoupMsg *msg;
+  GMainContext *context;
+  GstdSession *session;
+  guint64 since;
+  guint watch_id;
+  GSource *timeout;
+  gboolean paused;
+  gboolean done;
+} GstdHttpStatusPoll;
+
 typedef struct _GstdHttpRequest
 {
+  gint refcount;
   SoupServer *server;
   SoupMsg *msg;
   GstdSession *session;
   const char *path;
   GHashTable *query;
   GMutex *mutex;
+
+  /* Parked reads complete in the server context, see do_request_parked() */
+  GMainContext *context;
+  GCancellable *cancellable;
+  gulong finished_id;
+  gboolean cbor;
+  GstdReturnCode ret;
+  gchar *output;
+
+  /* Protected by mutex */
+  gboolean finished;
 } GstdHttpRequest;
 
 struct _GstdHttp
@@ -84,16 +146,27 @@ static gboolean gstd_http_init_get_option_group (GstdIpc * base,
     GOptionGroup ** group);
 static SoupStatus get_status_code (GstdReturnCode ret);
 static GstdReturnCode do_get (SoupServer * server, SoupMsg * msg,
-    char **output, const char *path, GstdSession * session);
+    char **output, const char *path, GHashTable * query,
+    GstdSession * session, GstdHttpRequest * request, gboolean * parked);
 static GstdReturnCode do_post (SoupServer * server, SoupMsg * msg,
     char *name, char *description, char **output, const char *path,
     GstdSession * session);
 static GstdReturnCode do_put (SoupServer * server, SoupMsg * msg,
     char *name, char **output, const char *path, GstdSession * session);
 static GstdReturnCode do_delete (SoupServer * server, SoupMsg * msg,
-    char *name, char **output, const char *path, GstdSession * session);
+    char *name, gboolean wait, char **output, const char *path,
+    GstdSession * session);
+static GstdReturnCode do_batch (SoupServer * server, SoupMsg * msg,
+    char **output, GstdSession * session);
 static void do_request (gpointer data_request, gpointer eval);
+static void do_request_parked (GstdReturnCode ret, gchar * output,
+    gpointer data);
+static JsonParser *load_json_body (SoupMsg * msg);
 static void parse_json_body (SoupMsg *msg, gchar **out_name, gchar **out_desc);
+static gboolean accepts_cbor (SoupMsg * msg);
+static void status_poll_on_change (gpointer data);
+static void status_poll_finish (GstdHttpStatusPoll * poll, GBytes * document,
+    guint64 version);
 #if SOUP_CHECK_VERSION(3,0,0)
 static void server_callback (SoupServer * server, SoupMsg * msg,
     const char *path, GHashTable * query, gpointer data);
@@ -156,6 +229,7 @@ gstd_http_finalize (GObject * object)
   }
 
   if (self->pool) {
+    gstd_metrics_remove_pool (self->pool);
     g_thread_pool_free (self->pool, FALSE, TRUE);
     self->pool = NULL;
   }
@@ -183,9 +257,90 @@ get_status_code (GstdReturnCode ret)
   return status;
 }
 
+static const gchar *
+query_lookup (GHashTable * query, const gchar * key, const gchar * fallback)
+{
+  const gchar *value = NULL;
+
+  if (query) {
+    value = g_hash_table_lookup (query, key);
+  }
+
+  return value ? value : fallback;
+}
+
+/*
+ * GET /pipelines/{name}/bus/messages[?since=&types=&max=&timeout=]
+ *
+ * The messages newer than since, to be read again from the returned
+ * "next". Defaults match the bus_read_since command.
+ */
+static gchar *
+build_read_since (const char *path, GHashTable * query)
+{
+  const gchar *name = path + strlen ("/pipelines/");
+  gint len = strlen (name) - strlen ("/bus/messages");
+
+  return g_strdup_printf ("bus_read_since %.*s %s %s %s %s", len, name,
+      query_lookup (query, "since", "0"), query_lookup (query, "types", "any"),
+      query_lookup (query, "max", "64"), query_lookup (query, "timeout", "0"));
+}
+
+/*
+ * GET /pipelines/{name}/state/wait[?transition=&timeout=]
+ *
+ * The state once the transition is over. Defaults match the
+ * pipeline_wait command: the latest transition, waiting forever.
+ */
+static gchar *
+build_state_wait (const char *path, GHashTable * query)
+{
+  const gchar *name = path + strlen ("/pipelines/");
+  gint len = strlen (name) - strlen ("/state/wait");
+
+  return g_strdup_printf ("pipeline_wait %.*s %s %s", len, name,
+      query_lookup (query, "transition", "0"), query_lookup (query,
+          "timeout", "-1"));
+}
+
+/*
+ * GET /pipelines/{name}/elements/{element}/signals/{signal}/callbacks
+ * [?since=&max=&timeout=]
+ *
+ * The emissions newer than since, like /bus/messages. Returns NULL if
+ * @path is something else.
+ */
+static gchar *
+build_signal_read_since (const char *path, GHashTable * query)
+{
+  gchar **parts;
+  gchar *message = NULL;
+
+  /* "", "pipelines", name, "elements", element, "signals", signal,
+   * "callbacks" */
+  parts = g_strsplit (path, "/", -1);
+  if (8 == g_strv_length (parts) && !g_strcmp0 (parts[3], "elements")
+      && !g_strcmp0 (parts[5], "signals") && '\0' != parts[2][0]
+      && '\0' != parts[4][0] && '\0' != parts[6][0]) {
+    message = g_strdup_printf ("signal_read_since %s %s %s %s %s %s",
+        parts[2], parts[4], parts[6], query_lookup (query, "since", "0"),
+        query_lookup (query, "max", "64"), query_lookup (query, "timeout",
+            "0"));
+  }
+  g_strfreev (parts);
+
+  return message;
+}
+
+/*
+ * Reads waiting for a bus message or a signal, like /bus/message with
+ * an infinite timeout, are parked and set @parked, the worker is not
+ * held meanwhile.
+ */
 static GstdReturnCode
 do_get (SoupServer * server, SoupMsg * msg, char **output, const char *path,
-    GstdSession * session)
+    GHashTable * query, GstdSession * session, GstdHttpRequest * request,
+    gboolean * parked)
 {
   gchar *message = NULL;
   GstdReturnCode ret = GSTD_EOK;
@@ -196,8 +351,26 @@ do_get (SoupServer * server, SoupMsg * msg, char **output, const char *path,
   g_return_val_if_fail (output, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (path, GSTD_NULL_ARGUMENT);
 
-  message = g_strdup_printf ("read %s", path);
-  ret = gstd_parser_parse_cmd (session, message, output);
+  /* Readers with a cursor of their own, see bus_read_since and
+   * signal_read_since */
+  if (g_str_has_prefix (path, "/pipelines/")
+      && g_str_has_suffix (path, "/bus/messages")
+      && strlen (path) > strlen ("/pipelines//bus/messages")) {
+    message = build_read_since (path, query);
+  } else if (g_str_has_prefix (path, "/pipelines/")
+      && g_str_has_suffix (path, "/callbacks")) {
+    message = build_signal_read_since (path, query);
+  } else if (g_str_has_prefix (path, "/pipelines/")
+      && g_str_has_suffix (path, "/state/wait")
+      && strlen (path) > strlen ("/pipelines//state/wait")) {
+    message = build_state_wait (path, query);
+  }
+
+  if (!message) {
+    message = g_strdup_printf ("read %s", path);
+  }
+  *parked = !gstd_parser_parse_cmd_async (session, message,
+      request->cancellable, do_request_parked, request, &ret, output);
   g_free (message);
   message = NULL;
 
@@ -270,7 +443,7 @@ out:
 }
 
 static GstdReturnCode
-do_delete (SoupServer * server, SoupMsg * msg, char *name,
+do_delete (SoupServer * server, SoupMsg * msg, char *name, gboolean wait,
     char **output, const char *path, GstdSession * session)
 {
   gchar *message = NULL;
@@ -290,7 +463,12 @@ do_delete (SoupServer * server, SoupMsg * msg, char *name,
     goto out;
   }
 
-  message = g_strdup_printf ("delete %s %s", path, name);
+  /* ?wait=false returns before the pipeline finished tearing down */
+  if (!wait && 0 == g_strcmp0 (path, "/pipelines")) {
+    message = g_strdup_printf ("pipeline_delete %s async", name);
+  } else {
+    message = g_strdup_printf ("delete %s %s", path, name);
+  }
   ret = gstd_parser_parse_cmd (session, message, output);
   g_free (message);
   message = NULL;
@@ -299,16 +477,231 @@ out:
   return ret;
 }
 
+/*
+ * POST /batch takes the commands as a JSON array of strings, either
+ * as the body itself or as its "operations" member, next to an
+ * optional "stop_on_error" boolean.
+ */
+static GstdReturnCode
+do_batch (SoupServer * server, SoupMsg * msg, char **output,
+    GstdSession * session)
+{
+  JsonParser *parser = NULL;
+  JsonNode *root = NULL;
+  JsonObject *obj = NULL;
+  JsonArray *operations = NULL;
+  JsonNode *operation = NULL;
+  const gchar **cmds = NULL;
+  gboolean stop_on_error = FALSE;
+  GstdReturnCode ret = GSTD_BAD_VALUE;
+  guint length = 0;
+  guint i = 0;
+
+  g_return_val_if_fail (server, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (msg, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (session, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (output, GSTD_NULL_ARGUMENT);
+
+  parser = load_json_body (msg);
+  if (!parser) {
+    GST_ERROR_OBJECT (session, "Batch requests need a JSON body");
+    goto out;
+  }
+
+  root = json_parser_get_root (parser);
+  if (JSON_NODE_HOLDS_ARRAY (root)) {
+    operations = json_node_get_array (root);
+  } else if (JSON_NODE_HOLDS_OBJECT (root)) {
+    obj = json_node_get_object (root);
+    if (json_object_has_member (obj, "operations")
+        && JSON_NODE_HOLDS_ARRAY (json_object_get_member (obj,
+                "operations"))) {
+      operations = json_object_get_array_member (obj, "operations");
+    }
+    if (json_object_has_member (obj, "stop_on_error")) {
+      stop_on_error = json_object_get_boolean_member (obj, "stop_on_error");
+    }
+  }
+
+  if (!operations) {
+    GST_ERROR_OBJECT (session, "No operations in the batch request");
+    goto unref;
+  }
+
+  length = json_array_get_length (operations);
+  cmds = g_new0 (const gchar *, length + 1);
+  for (i = 0; i < length; i++) {
+    operation = json_array_get_element (operations, i);
+    if (!JSON_NODE_HOLDS_VALUE (operation)
+        || json_node_get_value_type (operation) != G_TYPE_STRING) {
+      GST_ERROR_OBJECT (session, "Batch operation %u is not a string", i);
+      goto free_cmds;
+    }
+    cmds[i] = json_node_get_string (operation);
+  }
+
+  ret = gstd_parser_parse_batch (session, cmds, stop_on_error, output);
+
+free_cmds:
+  g_free (cmds);
+unref:
+  g_object_unref (parser);
+out:
+  return ret;
+}
+
+static GstdHttpRequest *
+request_ref (GstdHttpRequest * request)
+{
+  g_atomic_int_inc (&request->refcount);
+
+  return request;
+}
+
 static void
-do_request (gpointer data_request, gpointer eval)
+request_unref (gpointer data)
+{
+  GstdHttpRequest *request = data;
+
+  if (!g_atomic_int_dec_and_test (&request->refcount)) {
+    return;
+  }
+
+  if (request->query != NULL) {
+    g_hash_table_unref (request->query);
+  }
+  g_main_context_unref (request->context);
+  g_object_unref (request->cancellable);
+  g_object_unref (request->msg);
+  g_free (request->output);
+  g_free (request);
+}
+
+/*
+ * Runs in the server context when the client is gone, a parked read
+ * ends right away
+ */
+static void
+#if SOUP_CHECK_VERSION(3,0,0)
+request_finished (SoupServerMessage * msg, gpointer data)
+#else
+request_finished (SoupMessage * msg, gpointer data)
+#endif
+{
+  GstdHttpRequest *request = data;
+
+  g_mutex_lock (request->mutex);
+  request->finished = TRUE;
+  g_mutex_unlock (request->mutex);
+
+  g_cancellable_cancel (request->cancellable);
+}
+
+/*
+ * Wraps @output in the response envelope and sends it, unless the
+ * client already left. Takes @output and the reference of the caller.
+ */
+static void
+finish_request (GstdHttpRequest * request, GstdReturnCode ret, gchar * output)
 {
+  SoupMsg *msg = request->msg;
+  GByteArray *cbor_response = NULL;
+  const gchar *description = NULL;
   gchar *response = NULL;
+  SoupStatus status = SOUP_STATUS_OK;
+
+  description = gstd_return_code_to_string (ret);
+
+  if (request->cbor) {
+    cbor_response = gstd_cbor_envelope (ret, description, output);
+    g_free (output);
+    output = NULL;
+
+#if SOUP_CHECK_VERSION(3,0,0)
+    soup_server_message_set_response (msg, "application/cbor",
+        SOUP_MEMORY_COPY, (const char *) cbor_response->data,
+        cbor_response->len);
+#else
+    soup_message_set_response (msg, "application/cbor", SOUP_MEMORY_COPY,
+        (const char *) cbor_response->data, cbor_response->len);
+#endif
+    g_byte_array_unref (cbor_response);
+    cbor_response = NULL;
+  } else {
+    response =
+        g_strdup_printf
+        ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : %s\n}",
+        ret, description, output ? output : "null");
+    g_free (output);
+    output = NULL;
+
+#if SOUP_CHECK_VERSION(3,0,0)
+    soup_server_message_set_response (msg, "application/json",
+        SOUP_MEMORY_COPY, response, strlen (response));
+#else
+    soup_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
+        response, strlen (response));
+#endif
+    g_free (response);
+    response = NULL;
+  }
+
+  status = get_status_code (ret);
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  soup_server_message_set_status (msg, status, NULL);
+#else
+  soup_message_set_status (msg, status);
+#endif
+
+  g_mutex_lock (request->mutex);
+  if (!request->finished) {
+#if SOUP_CHECK_VERSION(3,2,0)
+    soup_server_message_unpause (msg);
+#else
+    soup_server_unpause_message (request->server, msg);
+#endif
+  }
+  g_mutex_unlock (request->mutex);
+
+  g_signal_handler_disconnect (msg, request->finished_id);
+  request_unref (request);
+}
+
+static gboolean
+resume_request (gpointer data)
+{
+  GstdHttpRequest *request = data;
+  gchar *output = request->output;
+
+  request->output = NULL;
+  finish_request (request, request->ret, output);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Runs in the park thread once a parked read completes, the response
+ * is sent from the server context like any other event
+ */
+static void
+do_request_parked (GstdReturnCode ret, gchar * output, gpointer data)
+{
+  GstdHttpRequest *request = data;
+
+  request->ret = ret;
+  request->output = output;
+
+  g_main_context_invoke (request->context, resume_request, request);
+}
+
+static void
+do_request (gpointer data_request, gpointer eval)
+{
   gchar *name = NULL;
   gchar *description_pipe = NULL;
   GstdReturnCode ret = GSTD_BAD_COMMAND;
   gchar *output = NULL;
-  const gchar *description = NULL;
-  SoupStatus status = SOUP_STATUS_OK;
   SoupServer *server = NULL;
   SoupMsg *msg = NULL;
   GstdSession *session = NULL;
@@ -316,11 +709,16 @@ do_request (gpointer data_request, gpointer eval)
   GHashTable *query = NULL;
   GstdHttpRequest *data_request_local = NULL;
   const char *method;
+  gboolean batch;
+  gboolean wait;
+  gboolean parked = FALSE;
 
   g_return_if_fail (data_request);
 
   data_request_local = (GstdHttpRequest *) data_request;
 
+  gstd_metrics_set_thread_ipc (GSTD_METRICS_IPC_HTTP);
+
   /*
    * Extract all fields from the request struct atomically.
    * The struct may be accessed from multiple threads, so we need
@@ -334,7 +732,17 @@ do_request (gpointer data_request, gpointer eval)
   query = data_request_local->query;
   g_mutex_unlock (data_request_local->mutex);
 
-  parse_json_body (msg, &name, &description_pipe);
+#if SOUP_CHECK_VERSION(3,0,0)
+  method = soup_server_message_get_method (msg);
+#else
+  method = msg->method;
+#endif
+
+  /* Batches carry their own body, see do_batch() */
+  batch = method == SOUP_METHOD_POST && 0 == g_strcmp0 (path, "/batch");
+  if (!batch) {
+    parse_json_body (msg, &name, &description_pipe);
+  }
 
   if (!name && query) {
     name = g_strdup (g_hash_table_lookup (query, "name"));
@@ -342,77 +750,70 @@ do_request (gpointer data_request, gpointer eval)
   if (!description_pipe && query) {
     description_pipe = g_strdup (g_hash_table_lookup (query, "description"));
   }
-#if SOUP_CHECK_VERSION(3,0,0)
-  method = soup_server_message_get_method (msg);
-#else
-  method = msg->method;
-#endif
-  if (method == SOUP_METHOD_GET) {
-    ret = do_get (server, msg, &output, path, session);
+
+  /* Objects are serialized as CBOR for clients that prefer it */
+  data_request_local->cbor = accepts_cbor (msg);
+  if (data_request_local->cbor) {
+    gstd_object_set_thread_formatter (GSTD_TYPE_CBOR_WRITER);
+  }
+
+  if (batch) {
+    ret = do_batch (server, msg, &output, session);
+  } else if (method == SOUP_METHOD_GET) {
+    ret = do_get (server, msg, &output, path, query, session,
+        data_request_local, &parked);
   } else if (method == SOUP_METHOD_POST) {
     ret = do_post (server, msg, name, description_pipe, &output, path, session);
   } else if (method == SOUP_METHOD_PUT) {
     ret = do_put (server, msg, name, &output, path, session);
   } else if (method == SOUP_METHOD_DELETE) {
-    ret = do_delete (server, msg, name, &output, path, session);
+    wait = !query || g_strcmp0 (g_hash_table_lookup (query, "wait"), "false");
+    ret = do_delete (server, msg, name, wait, &output, path, session);
   } else if (method == SOUP_METHOD_OPTIONS) {
     ret = GSTD_EOK;
   }
+  gstd_object_set_thread_formatter (0);
   g_free (name);
   g_free (description_pipe);
   name = NULL;
   description_pipe = NULL;
 
-  description = gstd_return_code_to_string (ret);
-  response =
-      g_strdup_printf
-      ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : %s\n}",
-      ret, description, output ? output : "null");
-  g_free (output);
-  output = NULL;
+  /* The worker is released, do_request_parked() sends the response */
+  if (parked) {
+    return;
+  }
 
-#if SOUP_CHECK_VERSION(3,0,0)
-  soup_server_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
-      response, strlen (response));
-#else
-  soup_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
-      response, strlen (response));
-#endif
-  g_free (response);
-  response = NULL;
+  finish_request (data_request_local, ret, output);
+}
 
-  status = get_status_code (ret);
+/*
+ * Whether the client listed application/cbor in its Accept header
+ */
+static gboolean
+accepts_cbor (SoupMsg * msg)
+{
+  SoupMessageHeaders *request_headers = NULL;
+  const char *accept;
 
 #if SOUP_CHECK_VERSION(3,0,0)
-  soup_server_message_set_status (msg, status, NULL);
-#else
-  soup_message_set_status (msg, status);
-#endif
-
-  g_mutex_lock (data_request_local->mutex);
-
-#if SOUP_CHECK_VERSION(3,2,0)
-  soup_server_message_unpause (msg);
+  request_headers = soup_server_message_get_request_headers (msg);
 #else
-  soup_server_unpause_message (server, msg);
+  request_headers = msg->request_headers;
 #endif
-  g_mutex_unlock (data_request_local->mutex);
 
-  if (query != NULL) {
-    g_hash_table_unref (query);
-  }
-  g_free (data_request);
-  data_request = NULL;
+  accept = soup_message_headers_get_list (request_headers, "Accept");
 
-  return;
+  return accept && soup_header_contains (accept, "application/cbor");
 }
 
-static void
-parse_json_body (SoupMsg *msg, gchar **out_name, gchar **out_desc)
+/*
+ * Parses the request body if it is JSON. Returns NULL otherwise.
+ */
+static JsonParser *
+load_json_body (SoupMsg * msg)
 {
   const char *content_type = NULL;
   JsonParser *parser = NULL;
-  JsonNode *root = NULL;
   GError *err = NULL;
   const char *body_data = NULL;
   gsize body_length = 0;
@@ -424,12 +825,7 @@ parse_json_body (SoupMsg *msg, gchar **out_name, gchar **out_desc)
   SoupBuffer *body_buffer = NULL;
 #endif
 
-  g_return_if_fail (msg);
-  g_return_if_fail (out_name);
-  g_return_if_fail (out_desc);
-
-  *out_name = NULL;
-  *out_desc = NULL;
+  g_return_val_if_fail (msg, NULL);
 
 #if SOUP_CHECK_VERSION(3,0,0)
   request_body = soup_server_message_get_request_body (msg);
@@ -440,212 +836,450 @@ parse_json_body (SoupMsg *msg, gchar **out_name, gchar **out_desc)
 #endif
 
   if (!request_body) {
-    return;
+    return NULL;
   }
 
 #if SOUP_CHECK_VERSION(3,0,0)
   /* libsoup3: use GBytes API for body access */
   body_bytes = soup_message_body_flatten (request_body);
   if (!body_bytes) {
-    return;
+    return NULL;
   }
   body_data = g_bytes_get_data (body_bytes, &body_length);
   if (body_length == 0) {
     g_bytes_unref (body_bytes);
-    return;
+    return NULL;
   }
 #else
   /* libsoup2: flatten returns SoupBuffer, access via buffer */
   body_buffer = soup_message_body_flatten (request_body);
   if (!body_buffer) {
-    return;
+    return NULL;
   }
   body_data = body_buffer->data;
   body_length = body_buffer->length;
   if (body_length == 0) {
     soup_buffer_free (body_buffer);
+    return NULL;
+  }
+#endif
+
+  content_type = soup_message_headers_get_content_type (request_headers, NULL);
+
+  if (!content_type || !g_str_has_prefix (content_type, "application/json")) {
+    goto out;
+  }
+
+  parser = json_parser_new ();
+  if (!json_parser_load_from_data (parser, body_data, body_length, &err)) {
+    g_clear_error (&err);
+    g_object_unref (parser);
+    parser = NULL;
+  }
+
+out:
+#if SOUP_CHECK_VERSION(3,0,0)
+  if (body_bytes) {
+    g_bytes_unref (body_bytes);
+  }
+#else
+  if (body_buffer) {
+    soup_buffer_free (body_buffer);
+  }
+#endif
+  return parser;
+}
+
+static void
+parse_json_body (SoupMsg *msg, gchar **out_name, gchar **out_desc)
+{
+  JsonParser *parser = NULL;
+  JsonNode *root = NULL;
+
+  g_return_if_fail (msg);
+  g_return_if_fail (out_name);
+  g_return_if_fail (out_desc);
+
+  *out_name = NULL;
+  *out_desc = NULL;
+
+  parser = load_json_body (msg);
+  if (!parser) {
+    return;
+  }
+
+  root = json_parser_get_root (parser);
+  if (JSON_NODE_HOLDS_OBJECT (root)) {
+    JsonObject *obj = json_node_get_object (root);
+    if (json_object_has_member (obj, "name")) {
+      const char *value = json_object_get_string_member (obj, "name");
+      if (value) *out_name = g_strdup (value);
+    }
+    if (json_object_has_member (obj, "description")) {
+      const char *value = json_object_get_string_member (obj, "description");
+      if (value) *out_desc = g_strdup (value);
+    }
+  }
+  g_object_unref (parser);
+}
+
+static void
+#if SOUP_CHECK_VERSION(3,0,0)
+handle_health_request (SoupServer * server, SoupMsg * msg)
+#else
+handle_health_request (SoupServer * server, SoupMessage * msg)
+#endif
+{
+  /* Simple liveness check - if HTTP server responds, gstd is alive.
+   * Avoids GStreamer calls that could hang and trigger container restarts. */
+  static const char *health_response =
+      "{\n  \"code\" : 0,\n  \"description\" : \"OK\",\n  \"response\" : {\"status\": \"healthy\"}\n}";
+  SoupMessageHeaders *response_headers = NULL;
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  response_headers = soup_server_message_get_response_headers (msg);
+#else
+  response_headers = msg->response_headers;
+#endif
+
+  soup_message_headers_append (response_headers,
+      "Access-Control-Allow-Origin", "*");
+  soup_message_headers_append (response_headers,
+      "Access-Control-Allow-Headers", "origin,range,content-type");
+  soup_message_headers_append (response_headers,
+      "Access-Control-Allow-Methods", "GET");
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  soup_server_message_set_response (msg, "application/json", SOUP_MEMORY_STATIC,
+      health_response, strlen (health_response));
+  soup_server_message_set_status (msg, SOUP_STATUS_OK, NULL);
+#else
+  soup_message_set_response (msg, "application/json", SOUP_MEMORY_STATIC,
+      health_response, strlen (health_response));
+  soup_message_set_status (msg, SOUP_STATUS_OK);
+#endif
+}
+
+static void
+#if SOUP_CHECK_VERSION(3,0,0)
+status_respond (SoupMsg * msg, GBytes * document, guint64 version)
+#else
+status_respond (SoupMessage * msg, GBytes * document, guint64 version)
+#endif
+{
+  SoupMessageHeaders *response_headers = NULL;
+  gchar *etag;
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  response_headers = soup_server_message_get_response_headers (msg);
+#else
+  response_headers = msg->response_headers;
+#endif
+
+  etag = g_strdup_printf ("\"%" G_GUINT64_FORMAT "\"", version);
+  soup_message_headers_replace (response_headers, "ETag", etag);
+  soup_message_headers_replace (response_headers, "Cache-Control",
+      "no-cache");
+  g_free (etag);
+
+  /* NULL when the client already has this version */
+  if (!document) {
+#if SOUP_CHECK_VERSION(3,0,0)
+    soup_server_message_set_status (msg, SOUP_STATUS_NOT_MODIFIED, NULL);
+#else
+    soup_message_set_status (msg, SOUP_STATUS_NOT_MODIFIED);
+#endif
     return;
   }
+#if SOUP_CHECK_VERSION(3,0,0)
+  soup_server_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
+      g_bytes_get_data (document, NULL), g_bytes_get_size (document));
+  soup_server_message_set_status (msg, SOUP_STATUS_OK, NULL);
+#else
+  soup_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
+      g_bytes_get_data (document, NULL), g_bytes_get_size (document));
+  soup_message_set_status (msg, SOUP_STATUS_OK);
 #endif
+}
+
+static GstdHttpStatusPoll *
+status_poll_ref (GstdHttpStatusPoll * poll)
+{
+  g_atomic_int_inc (&poll->refcount);
+  return poll;
+}
+
+static void
+status_poll_unref (gpointer data)
+{
+  GstdHttpStatusPoll *poll = data;
+
+  if (!g_atomic_int_dec_and_test (&poll->refcount))
+    return;
+
+  g_main_context_unref (poll->context);
+  gst_object_unref (poll->session);
+  g_free (poll);
+}
+
+/*
+ * Answers @poll if the status moved past the version of the client,
+ * otherwise watches the next change. Only runs in the server context.
+ */
+static gboolean
+status_poll_check (GstdHttpStatusPoll * poll)
+{
+  GBytes *document;
+  guint64 version;
+
+  while (TRUE) {
+    document = gstd_status_get (poll->session->status, &version);
+    if (version > poll->since) {
+      break;
+    }
+    g_bytes_unref (document);
+
+    /* The watch keeps a reference until it runs or is removed */
+    poll->watch_id = gstd_status_watch (poll->session->status, version,
+        status_poll_on_change, status_poll_ref (poll));
+    if (poll->watch_id) {
+      return FALSE;
+    }
+    status_poll_unref (poll);
+  }
 
-  content_type = soup_message_headers_get_content_type (request_headers, NULL);
+  status_poll_finish (poll, document, version);
+  g_bytes_unref (document);
 
-  if (!content_type || !g_str_has_prefix (content_type, "application/json")) {
-    goto out;
+  return TRUE;
+}
+
+static gboolean
+status_poll_wake (gpointer data)
+{
+  GstdHttpStatusPoll *poll = data;
+
+  if (!poll->done) {
+    status_poll_check (poll);
   }
 
-  parser = json_parser_new ();
-  if (!json_parser_load_from_data (parser, body_data, body_length, &err)) {
-    g_clear_error (&err);
-    g_object_unref (parser);
-    goto out;
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Runs in the thread that made the change, the check is left to the
+ * server context. Takes the reference of the watch.
+ */
+static void
+status_poll_on_change (gpointer data)
+{
+  GstdHttpStatusPoll *poll = data;
+  GSource *source;
+
+  source = g_idle_source_new ();
+  g_source_set_callback (source, status_poll_wake, poll, status_poll_unref);
+  g_source_attach (source, poll->context);
+  g_source_unref (source);
+}
+
+/* Stops watching, the next wake finds the poll done */
+static void
+status_poll_stop (GstdHttpStatusPoll * poll)
+{
+  poll->done = TRUE;
+
+  if (poll->watch_id && gstd_status_unwatch (poll->watch_id)) {
+    status_poll_unref (poll);
   }
+  poll->watch_id = 0;
 
-  root = json_parser_get_root (parser);
-  if (JSON_NODE_HOLDS_OBJECT (root)) {
-    JsonObject *obj = json_node_get_object (root);
-    if (json_object_has_member (obj, "name")) {
-      const char *value = json_object_get_string_member (obj, "name");
-      if (value) *out_name = g_strdup (value);
-    }
-    if (json_object_has_member (obj, "description")) {
-      const char *value = json_object_get_string_member (obj, "description");
-      if (value) *out_desc = g_strdup (value);
-    }
+  if (poll->timeout) {
+    g_source_destroy (poll->timeout);
+    g_source_unref (poll->timeout);
+    poll->timeout = NULL;
   }
-  g_object_unref (parser);
+}
 
-out:
-#if SOUP_CHECK_VERSION(3,0,0)
-  if (body_bytes) {
-    g_bytes_unref (body_bytes);
+static void
+status_poll_finish (GstdHttpStatusPoll * poll, GBytes * document,
+    guint64 version)
+{
+  status_poll_stop (poll);
+  status_respond (poll->msg, document, version);
+
+  /* Answered right away, the message was never paused */
+  if (!poll->paused) {
+    return;
   }
+#if SOUP_CHECK_VERSION(3,2,0)
+  soup_server_message_unpause (poll->msg);
 #else
-  if (body_buffer) {
-    soup_buffer_free (body_buffer);
-  }
+  soup_server_unpause_message (poll->server, poll->msg);
 #endif
 }
 
+static gboolean
+status_poll_timeout (gpointer data)
+{
+  GstdHttpStatusPoll *poll = data;
+
+  GST_DEBUG ("Status poll since %" G_GUINT64_FORMAT " timed out",
+      poll->since);
+
+  /* Nothing new, the client still has the latest version */
+  status_poll_finish (poll, NULL, poll->since);
+
+  return G_SOURCE_REMOVE;
+}
+
 static void
 #if SOUP_CHECK_VERSION(3,0,0)
-handle_health_request (SoupServer * server, SoupMsg * msg)
+status_poll_finished (SoupServerMessage * msg, gpointer data)
 #else
-handle_health_request (SoupServer * server, SoupMessage * msg)
+status_poll_finished (SoupMessage * msg, gpointer data)
 #endif
 {
-  /* Simple liveness check - if HTTP server responds, gstd is alive.
-   * Avoids GStreamer calls that could hang and trigger container restarts. */
-  static const char *health_response =
-      "{\n  \"code\" : 0,\n  \"description\" : \"OK\",\n  \"response\" : {\"status\": \"healthy\"}\n}";
-  SoupMessageHeaders *response_headers = NULL;
+  GstdHttpStatusPoll *poll = data;
+
+  status_poll_stop (poll);
+  status_poll_unref (poll);
+}
 
+/*
+ * GET /metrics
+ *
+ * Fast-path handler for Prometheus scrapes, it bypasses the thread
+ * pool so a busy pool doesn't hide its own queue depth. Only reads
+ * counters, it never waits for a command.
+ */
+static void
 #if SOUP_CHECK_VERSION(3,0,0)
-  response_headers = soup_server_message_get_response_headers (msg);
+handle_metrics (SoupServer * server, SoupMsg * msg, GstdSession * session)
 #else
-  response_headers = msg->response_headers;
+handle_metrics (SoupServer * server, SoupMessage * msg, GstdSession * session)
 #endif
+{
+  GString *metrics;
+  gsize len;
 
-  soup_message_headers_append (response_headers,
-      "Access-Control-Allow-Origin", "*");
-  soup_message_headers_append (response_headers,
-      "Access-Control-Allow-Headers", "origin,range,content-type");
-  soup_message_headers_append (response_headers,
-      "Access-Control-Allow-Methods", "GET");
+  metrics = g_string_new (NULL);
+  gstd_metrics_format (metrics, session->pipelines);
+  len = metrics->len;
 
 #if SOUP_CHECK_VERSION(3,0,0)
-  soup_server_message_set_response (msg, "application/json", SOUP_MEMORY_STATIC,
-      health_response, strlen (health_response));
+  soup_server_message_set_response (msg, "text/plain; version=0.0.4",
+      SOUP_MEMORY_TAKE, g_string_free (metrics, FALSE), len);
   soup_server_message_set_status (msg, SOUP_STATUS_OK, NULL);
 #else
-  soup_message_set_response (msg, "application/json", SOUP_MEMORY_STATIC,
-      health_response, strlen (health_response));
+  soup_message_set_response (msg, "text/plain; version=0.0.4",
+      SOUP_MEMORY_TAKE, g_string_free (metrics, FALSE), len);
   soup_message_set_status (msg, SOUP_STATUS_OK);
 #endif
 }
 
 /*
- * Fast-path handler for pipeline status polling.
- * This bypasses the thread pool to avoid contention during frequent
- * monitoring requests. Returns a lightweight JSON with pipeline names
- * and states only.
+ * GET /pipelines/status[?since=<version>&timeout=<ns>]
+ *
+ * Fast-path handler for pipeline status polling. This bypasses the
+ * thread pool to avoid contention during frequent monitoring requests.
+ * The document is published by the session and only rebuilt after a
+ * change, so a poll just sends the current one. The version is the
+ * ETag: a client sending it back in If-None-Match gets a 304 while
+ * nothing changed. With since, the response waits until the version
+ * is newer, or answers 304 once timeout expires, -1 by default to wait
+ * for as long as the client stays.
  */
 static void
 #if SOUP_CHECK_VERSION(3,0,0)
 handle_pipelines_status (SoupServer * server, SoupMsg * msg,
-    GstdSession * session)
+    GHashTable * query, GstdSession * session)
 #else
 handle_pipelines_status (SoupServer * server, SoupMessage * msg,
-    GstdSession * session)
+    GHashTable * query, GstdSession * session)
 #endif
 {
-  GString *json;
-  GList *pipelines;
-  GList *iter;
-  guint count;
-  gboolean first = TRUE;
+  SoupMessageHeaders *request_headers = NULL;
   SoupMessageHeaders *response_headers = NULL;
+  GstdHttpStatusPoll *poll;
+  const gchar *since;
+  const gchar *if_none_match;
+  GBytes *document;
+  guint64 version;
+  gint64 timeout = -1;
+  gchar *etag;
 
 #if SOUP_CHECK_VERSION(3,0,0)
+  request_headers = soup_server_message_get_request_headers (msg);
   response_headers = soup_server_message_get_response_headers (msg);
 #else
+  request_headers = msg->request_headers;
   response_headers = msg->response_headers;
 #endif
 
   soup_message_headers_append (response_headers,
       "Access-Control-Allow-Origin", "*");
   soup_message_headers_append (response_headers,
-      "Access-Control-Allow-Headers", "origin,range,content-type");
+      "Access-Control-Allow-Headers", "origin,range,content-type,if-none-match");
   soup_message_headers_append (response_headers,
       "Access-Control-Allow-Methods", "GET");
+  soup_message_headers_append (response_headers,
+      "Access-Control-Expose-Headers", "ETag");
 
-  json = g_string_new ("{\n  \"code\" : 0,\n  \"description\" : \"OK\",\n");
-  g_string_append (json, "  \"response\" : {\n    \"pipelines\": [");
-
-  /* Snapshot the pipeline list under the lock, then release the lock
-   * before querying states. gst_element_get_state() can block if a
-   * state change is in progress (it needs the element's state lock),
-   * so holding the list lock during state queries can deadlock the
-   * entire pipeline list — blocking create/delete/play on all pipelines. */
-  GST_OBJECT_LOCK (session->pipelines);
-  pipelines = g_list_copy (session->pipelines->list);
-  count = session->pipelines->count;
-  /* Ref each pipeline to prevent use-after-free after releasing the lock */
-  for (iter = pipelines; iter != NULL; iter = g_list_next (iter)) {
-    gst_object_ref (iter->data);
-  }
-  GST_OBJECT_UNLOCK (session->pipelines);
-
-  for (iter = pipelines; iter != NULL; iter = g_list_next (iter)) {
-    GstdPipeline *pipeline = GSTD_PIPELINE (iter->data);
-    const gchar *name;
-    GstState current_state = GST_STATE_NULL;
-
-    name = GSTD_OBJECT_NAME (pipeline);
-
-    /* Read the cached state without blocking.
-     * gst_element_get_state() acquires the element's state lock, which
-     * blocks if gst_element_set_state() is in progress on another thread.
-     * Since this endpoint runs on the soup main thread, any blocking here
-     * stalls all HTTP I/O. Use GST_STATE() for a lock-free read of the
-     * last-known state instead. */
-    GstElement *element = gstd_pipeline_get_element (pipeline);
-    if (element) {
-      gst_object_ref (element);
-      current_state = GST_STATE (element);
-      gst_object_unref (element);
-    }
+  since = query_lookup (query, "since", NULL);
+  if (!since) {
+    document = gstd_status_get (session->status, &version);
 
-    if (!first) {
-      g_string_append (json, ",");
-    }
-    first = FALSE;
+    etag = g_strdup_printf ("\"%" G_GUINT64_FORMAT "\"", version);
+    if_none_match = soup_message_headers_get_one (request_headers,
+        "If-None-Match");
+    status_respond (msg, 0 == g_strcmp0 (if_none_match, etag) ? NULL :
+        document, version);
 
-    g_string_append_printf (json,
-        "\n      {\"name\": \"%s\", \"state\": \"%s\"}",
-        name,
-        gst_element_state_get_name (current_state));
+    g_free (etag);
+    g_bytes_unref (document);
+    return;
+  }
+
+  poll = g_new0 (GstdHttpStatusPoll, 1);
+  poll->refcount = 1;
+  poll->server = server;
+  poll->msg = msg;
+  poll->context = g_main_context_ref_thread_default ();
+  poll->session = gst_object_ref (session);
+
+  if (!g_ascii_string_to_unsigned (since, 10, 0, G_MAXUINT64, &poll->since,
+          NULL)
+      || !g_ascii_string_to_signed (query_lookup (query, "timeout", "-1"), 10,
+          -1, G_MAXINT64, &timeout, NULL)) {
+    status_poll_unref (poll);
+#if SOUP_CHECK_VERSION(3,0,0)
+    soup_server_message_set_status (msg, SOUP_STATUS_BAD_REQUEST, NULL);
+#else
+    soup_message_set_status (msg, SOUP_STATUS_BAD_REQUEST);
+#endif
+    return;
+  }
 
-    gst_object_unref (pipeline);
+  if (status_poll_check (poll)) {
+    status_poll_unref (poll);
+    return;
   }
 
-  g_list_free (pipelines);
+  if (timeout >= 0) {
+    poll->timeout = g_timeout_source_new (timeout / GST_MSECOND);
+    g_source_set_callback (poll->timeout, status_poll_timeout, poll, NULL);
+    g_source_attach (poll->timeout, poll->context);
+  }
 
-  g_string_append (json, "\n    ],\n    \"count\": ");
-  g_string_append_printf (json, "%u", count);
-  g_string_append (json, "\n  }\n}");
+  /* The first reference is released once the client is done */
+  g_signal_connect (msg, "finished", G_CALLBACK (status_poll_finished), poll);
 
-#if SOUP_CHECK_VERSION(3,0,0)
-  soup_server_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
-      json->str, json->len);
-  soup_server_message_set_status (msg, SOUP_STATUS_OK, NULL);
+  poll->paused = TRUE;
+#if SOUP_CHECK_VERSION(3,2,0)
+  soup_server_message_pause (msg);
 #else
-  soup_message_set_response (msg, "application/json", SOUP_MEMORY_COPY,
-      json->str, json->len);
-  soup_message_set_status (msg, SOUP_STATUS_OK);
+  soup_server_pause_message (server, msg);
 #endif
-
-  g_string_free (json, TRUE);
 }
 
 /*
@@ -999,6 +1633,334 @@ error_500:
   return;
 }
 
+static GstdHttpStream *
+stream_ref (GstdHttpStream * stream)
+{
+  g_atomic_int_inc (&stream->refcount);
+  return stream;
+}
+
+static void
+stream_unref (gpointer data)
+{
+  GstdHttpStream *stream = data;
+
+  if (!g_atomic_int_dec_and_test (&stream->refcount))
+    return;
+
+  g_mutex_clear (&stream->lock);
+  g_main_context_unref (stream->context);
+  g_object_unref (stream->bus);
+  g_free (stream);
+}
+
+/*
+ * Appends @message, taking it. Every line of the serialized message
+ * goes in its own data field. The id is the bus sequence number, so a
+ * reconnecting client resumes from it through Last-Event-ID.
+ */
+static void
+stream_append_event (GString * events, guint64 seq, GstMessage * message)
+{
+  GstdBusMsg *busmsg;
+  gchar *serialized = NULL;
+  gchar **lines;
+  guint i;
+
+  g_string_append_printf (events, "event: %s\nid: %" G_GUINT64_FORMAT "\n",
+      GST_MESSAGE_TYPE_NAME (message), seq);
+
+  /* The bus message takes the reference */
+  busmsg = gstd_bus_msg_factory_make (message);
+  gstd_object_to_string (GSTD_OBJECT (busmsg), &serialized);
+  g_object_unref (busmsg);
+
+  lines = g_strsplit (serialized ? serialized : "null", "\n", -1);
+  for (i = 0; lines[i]; i++) {
+    g_string_append_printf (events, "data: %s\n", lines[i]);
+  }
+  g_string_append_c (events, '\n');
+
+  g_strfreev (lines);
+  g_free (serialized);
+}
+
+static gboolean
+stream_flush (gpointer data)
+{
+  GstdHttpStream *stream = data;
+  SoupMessageBody *body;
+  GstMessage *message;
+  GString *events;
+  guint64 lost;
+  gboolean closed;
+
+  g_mutex_lock (&stream->lock);
+  closed = stream->closed;
+  stream->scheduled = FALSE;
+  g_mutex_unlock (&stream->lock);
+
+  /* The client left, or is still taking the previous chunk and the
+   * flush is done again once it's written */
+  if (stream->finished || stream->writing) {
+    return G_SOURCE_REMOVE;
+  }
+
+  /* Everything retained, the messages posted before closing too */
+  events = g_string_new (NULL);
+  while (TRUE) {
+    message = gstd_pipeline_bus_next (stream->bus, &stream->seq,
+        stream->types, &lost);
+    if (message) {
+      stream_append_event (events, stream->seq, message);
+    } else if (lost) {
+      g_string_append_printf (events, "event: lost\ndata: { \"lost\" : %"
+          G_GUINT64_FORMAT " }\n\n", lost);
+    } else {
+      break;
+    }
+  }
+
+  if (closed) {
+    g_string_append (events, "event: close\ndata: null\n\n");
+  }
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  body = soup_server_message_get_response_body (stream->msg);
+#else
+  body = stream->msg->response_body;
+#endif
+
+  if (events->len) {
+    soup_message_body_append (body, SOUP_MEMORY_TAKE, events->str,
+        events->len);
+    g_string_free (events, FALSE);
+    stream->writing = TRUE;
+  } else {
+    g_string_free (events, TRUE);
+  }
+
+  if (closed) {
+    soup_message_body_complete (body);
+  }
+#if SOUP_CHECK_VERSION(3,2,0)
+  soup_server_message_unpause (stream->msg);
+#else
+  soup_server_unpause_message (stream->server, stream->msg);
+#endif
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Runs in the thread that posted @message, only schedules a flush
+ */
+static void
+stream_on_message (GstdPipelineBus * bus, GstMessage * message,
+    guint64 seq, gpointer data)
+{
+  GstdHttpStream *stream = data;
+  GSource *source;
+
+  g_mutex_lock (&stream->lock);
+
+  if (NULL == message) {
+    stream->closed = TRUE;
+  }
+
+  if (!stream->scheduled) {
+    stream->scheduled = TRUE;
+    source = g_idle_source_new ();
+    g_source_set_callback (source, stream_flush, stream_ref (stream),
+        stream_unref);
+    g_source_attach (source, stream->context);
+    g_source_unref (source);
+  }
+
+  g_mutex_unlock (&stream->lock);
+}
+
+/*
+ * The previous chunk is out, pulls what was posted meanwhile
+ */
+static void
+#if SOUP_CHECK_VERSION(3,0,0)
+stream_wrote_chunk (SoupServerMessage * msg, guint size, gpointer data)
+#else
+stream_wrote_chunk (SoupMessage * msg, gpointer data)
+#endif
+{
+  GstdHttpStream *stream = data;
+
+  stream->writing = FALSE;
+  stream_flush (stream);
+}
+
+static void
+#if SOUP_CHECK_VERSION(3,0,0)
+stream_finished (SoupServerMessage * msg, gpointer data)
+#else
+stream_finished (SoupMessage * msg, gpointer data)
+#endif
+{
+  GstdHttpStream *stream = data;
+
+  GST_DEBUG ("Bus stream client for %s left", GSTD_OBJECT_NAME (stream->bus));
+
+  stream->finished = TRUE;
+  gstd_pipeline_bus_unsubscribe (stream->bus, stream->id);
+  stream_unref (stream);
+}
+
+/*
+ * GET /pipelines/{name}/bus/stream[?types=error+eos]
+ *
+ * Keeps the response open and pushes every bus message matching
+ * types, or the bus filter if not given, as a server-sent event named
+ * after the message type. Unlike the message resource, it doesn't
+ * take the messages from the bus. The stream ends with a "close"
+ * event when the pipeline is deleted. A client sending Last-Event-ID
+ * first gets the messages it missed that are still kept.
+ */
+static void
+#if SOUP_CHECK_VERSION(3,0,0)
+handle_bus_stream (SoupServer * server, SoupMsg * msg, const char *path,
+    GHashTable * query, GstdSession * session)
+#else
+handle_bus_stream (SoupServer * server, SoupMessage * msg, const char *path,
+    GHashTable * query, GstdSession * session)
+#endif
+{
+  SoupMessageHeaders *request_headers = NULL;
+  SoupMessageHeaders *response_headers = NULL;
+  SoupMessageBody *body = NULL;
+  GstdHttpStream *stream;
+  GstdObject *bus = NULL;
+  const gchar *filter = NULL;
+  const gchar *last_event_id;
+  guint64 since = GSTD_PIPELINE_BUS_SEQ_NONE;
+  gchar *uri;
+  gchar *error_json;
+  gint types;
+  GstdReturnCode ret;
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  request_headers = soup_server_message_get_request_headers (msg);
+  response_headers = soup_server_message_get_response_headers (msg);
+  body = soup_server_message_get_response_body (msg);
+#else
+  request_headers = msg->request_headers;
+  response_headers = msg->response_headers;
+  body = msg->response_body;
+#endif
+
+  soup_message_headers_append (response_headers,
+      "Access-Control-Allow-Origin", "*");
+  soup_message_headers_append (response_headers,
+      "Access-Control-Allow-Headers", "origin,range,content-type");
+  soup_message_headers_append (response_headers,
+      "Access-Control-Allow-Methods", "GET");
+
+  last_event_id = soup_message_headers_get_one (request_headers,
+      "Last-Event-ID");
+  if (last_event_id
+      && !gstd_pipeline_bus_parse_seq (last_event_id, &since)) {
+    ret = GSTD_BAD_VALUE;
+    goto error;
+  }
+
+  /* The bus is the parent of the stream */
+  uri = g_strndup (path, strlen (path) - strlen ("/stream"));
+  ret = gstd_get_by_uri (session, uri, &bus);
+  g_free (uri);
+
+  if (GSTD_EOK == ret && !GSTD_IS_PIPELINE_BUS (bus)) {
+    ret = GSTD_BAD_COMMAND;
+  }
+  if (ret) {
+    goto error;
+  }
+
+  if (query) {
+    filter = g_hash_table_lookup (query, "types");
+  }
+  if (filter) {
+    if (!gstd_pipeline_bus_parse_types (filter, &types)) {
+      ret = GSTD_BAD_VALUE;
+      goto error;
+    }
+  } else {
+    g_object_get (bus, "types", &types, NULL);
+  }
+
+  stream = g_new0 (GstdHttpStream, 1);
+  stream->refcount = 1;
+  stream->server = server;
+  stream->msg = msg;
+  stream->context = g_main_context_ref_thread_default ();
+  stream->bus = GSTD_PIPELINE_BUS (bus);
+  stream->types = types;
+  g_mutex_init (&stream->lock);
+
+  /* Without Last-Event-ID, it starts with the messages posted from now
+   * on. Retained messages after the cursor schedule a flush right
+   * away. */
+  if (GSTD_PIPELINE_BUS_SEQ_NONE == since) {
+    g_object_get (bus, "last-seq", &since, NULL);
+  }
+  stream->seq = since;
+
+  stream->id = gstd_pipeline_bus_subscribe (stream->bus, types, since,
+      stream_on_message, stream_ref (stream), stream_unref);
+  if (0 == stream->id) {
+    stream_unref (stream);
+    stream_unref (stream);
+    ret = GSTD_NO_PIPELINE;
+    goto error;
+  }
+
+  /* The first reference is released once the client is done */
+  g_signal_connect (msg, "finished", G_CALLBACK (stream_finished), stream);
+  g_signal_connect (msg, "wrote-chunk", G_CALLBACK (stream_wrote_chunk),
+      stream);
+
+  soup_message_headers_set_encoding (response_headers, SOUP_ENCODING_CHUNKED);
+  soup_message_headers_append (response_headers, "Cache-Control", "no-cache");
+  soup_message_headers_set_content_type (response_headers,
+      "text/event-stream", NULL);
+
+  /* Written events are not needed anymore */
+  soup_message_body_set_accumulate (body, FALSE);
+
+#if SOUP_CHECK_VERSION(3,0,0)
+  soup_server_message_set_status (msg, SOUP_STATUS_OK, NULL);
+#else
+  soup_message_set_status (msg, SOUP_STATUS_OK);
+#endif
+
+  GST_INFO ("Streaming bus of %s with types 0x%x", GSTD_OBJECT_NAME (bus),
+      types);
+  return;
+
+error:
+  if (bus) {
+    g_object_unref (bus);
+  }
+
+  error_json = g_strdup_printf
+      ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : null\n}",
+      ret, gstd_return_code_to_string (ret));
+#if SOUP_CHECK_VERSION(3,0,0)
+  soup_server_message_set_response (msg, "application/json", SOUP_MEMORY_TAKE,
+      error_json, strlen (error_json));
+  soup_server_message_set_status (msg, get_status_code (ret), NULL);
+#else
+  soup_message_set_response (msg, "application/json", SOUP_MEMORY_TAKE,
+      error_json, strlen (error_json));
+  soup_message_set_status (msg, get_status_code (ret));
+#endif
+}
+
 static void
 #if SOUP_CHECK_VERSION(3,0,0)
 server_callback (SoupServer * server, SoupMsg * msg,
@@ -1027,10 +1989,24 @@ server_callback (SoupServer * server, SoupMessage * msg,
   self = GSTD_HTTP (data);
   session = self->session;
 
+  /* Fast path for Prometheus scrapes - bypass thread pool */
+  if (g_strcmp0 (path, "/metrics") == 0) {
+    handle_metrics (server, msg, session);
+    return;
+  }
+
   /* Fast path for pipeline status polling - bypass thread pool.
    * This endpoint is optimized for frequent monitoring requests. */
   if (g_strcmp0 (path, "/pipelines/status") == 0) {
-    handle_pipelines_status (server, msg, session);
+    handle_pipelines_status (server, msg, query, session);
+    return;
+  }
+
+  /* Bus streams stay open, they are fed from the server context instead
+   * of holding a worker */
+  if (g_str_has_prefix (path, "/pipelines/")
+      && g_str_has_suffix (path, "/bus/stream")) {
+    handle_bus_stream (server, msg, path, query, session);
     return;
   }
 
@@ -1046,7 +2022,8 @@ server_callback (SoupServer * server, SoupMessage * msg,
 
   data_request = g_new0 (GstdHttpRequest, 1);
 
-  data_request->msg = msg;
+  data_request->refcount = 1;
+  data_request->msg = g_object_ref (msg);
   data_request->server = server;
   data_request->session = session;
   data_request->path = path;
@@ -1056,7 +2033,14 @@ server_callback (SoupServer * server, SoupMessage * msg,
     data_request->query = query;
   }
   data_request->mutex = &self->mutex;
+  data_request->context = g_main_context_ref_thread_default ();
+  data_request->cancellable = g_cancellable_new ();
 
+  /* The handler keeps its own reference, it may run while being
+   * disconnected */
+  data_request->finished_id = g_signal_connect_data (msg, "finished",
+      G_CALLBACK (request_finished), request_ref (data_request),
+      (GClosureNotify) request_unref, 0);
 
 #if SOUP_CHECK_VERSION(3,0,0)
   response_headers = soup_server_message_get_response_headers (msg);
@@ -1079,10 +2063,8 @@ server_callback (SoupServer * server, SoupMessage * msg,
   if (!g_thread_pool_push (self->pool, (gpointer) data_request, NULL)) {
     GST_ERROR_OBJECT (self, "Thread pool push failed");
     /* Clean up the request that couldn't be queued */
-    if (data_request->query) {
-      g_hash_table_unref (data_request->query);
-    }
-    g_free (data_request);
+    g_signal_handler_disconnect (msg, data_request->finished_id);
+    request_unref (data_request);
     /* Unpause the message so libsoup can complete it with an error */
     g_mutex_lock (&self->mutex);
 #if SOUP_CHECK_VERSION(3,0,0)
@@ -1130,6 +2112,7 @@ gstd_http_start (GstdIpc * base, GstdSession * session)
   if (error) {
     goto noconnection;
   }
+  gstd_metrics_add_pool ("http", self->pool);
 
   sa = g_inet_socket_address_new_from_string (address, port);
   if (!sa) {
@@ -1162,6 +2145,7 @@ noconnection:
       error = NULL;
     }
     if (self->pool) {
+      gstd_metrics_remove_pool (self->pool);
       g_thread_pool_free (self->pool, TRUE, FALSE);
       self->pool = NULL;
     }
@@ -1222,6 +2206,7 @@ gstd_http_stop (GstdIpc * base)
 
   /* Wait for pending requests before destroying the pool */
   if (self->pool) {
+    gstd_metrics_remove_pool (self->pool);
     g_thread_pool_free (self->pool, FALSE, TRUE);  /* wait=TRUE for clean shutdown */
     self->pool = NULL;
   }
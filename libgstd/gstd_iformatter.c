@@ -87,6 +87,14 @@ gstd_iformatter_generate (GstdIFormatter * self, gchar ** outstring)
   GSTD_IFORMATTER_GET_INTERFACE (self)->generate (self, outstring);
 }
 
+void
+gstd_iformatter_reset (GstdIFormatter * self)
+{
+  g_return_if_fail (self);
+
+  GSTD_IFORMATTER_GET_INTERFACE (self)->reset (self);
+}
+
 static void
 gstd_iformatter_default_init (GstdIFormatterInterface * iface)
 {
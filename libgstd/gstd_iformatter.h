@@ -55,6 +55,8 @@ struct _GstdIFormatterInterface
   void (*set_value) (GstdIFormatter * self, const GValue * value);
 
   void (*generate) (GstdIFormatter * self, gchar ** outstring);
+
+  void (*reset) (GstdIFormatter * self);
 };
 
 void gstd_iformatter_begin_object (GstdIFormatter * self);
@@ -77,5 +79,7 @@ void gstd_iformatter_set_value (GstdIFormatter * self, const GValue * value);
 
 void gstd_iformatter_generate (GstdIFormatter * self, gchar ** outstring);
 
+void gstd_iformatter_reset (GstdIFormatter * self);
+
 G_END_DECLS
 #endif /* __GSTD_IFORMATTER_H__ */
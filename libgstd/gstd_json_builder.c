@@ -261,6 +261,17 @@ gstd_json_builder_generate (GstdIFormatter * iface, gchar ** outstring)
   *outstring = json_stream;
 }
 
+static void
+gstd_json_builder_reset (GstdIFormatter * iface)
+{
+  GstdJsonBuilder *self;
+
+  g_return_if_fail (GSTD_IS_JSON_BUILDER (iface));
+
+  self = GSTD_JSON_BUILDER (iface);
+  json_builder_reset (self->json_builder);
+}
+
 static void
 gstd_json_builder_finalize (GObject * object)
 {
@@ -283,4 +294,5 @@ gstd_iformatter_interface_init (GstdIFormatterInterface * iface)
   iface->set_null_value = gstd_json_set_null_value;
   iface->set_value = gstd_json_set_value;
   iface->generate = gstd_json_builder_generate;
+  iface->reset = gstd_json_builder_reset;
 }
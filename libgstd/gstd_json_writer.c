@@ -0,0 +1,505 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "gstd_json_writer.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_json_writer_debug);
+#define GST_CAT_DEFAULT gstd_json_writer_debug
+
+/* Output matches the pretty printed json-glib generator */
+#define JSON_INDENT_CHAR   ' '
+#define JSON_INDENT_LEVEL  4
+
+/* Deepest nesting of objects and arrays supported */
+#define JSON_MAX_DEPTH     64
+
+/* Initial size of a fresh output buffer */
+#define JSON_BUFFER_SIZE   4096
+/* Buffers larger than this are handed out instead of being recycled */
+#define JSON_BUFFER_RETAIN (256 * 1024)
+
+typedef struct _GstdJsonWriterClass GstdJsonWriterClass;
+
+/**
+ * GstdJsonWriter:
+ * A streaming JSON formatter. Values are written straight into a
+ * growable buffer, no intermediate tree is built. The buffer is
+ * recycled through a per-thread slot so back to back responses don't
+ * have to grow a new one.
+ */
+struct _GstdJsonWriter
+{
+  GObject parent;
+  GString *buffer;
+
+  /* Current nesting level and whether each level has children */
+  guint depth;
+  gboolean has_children[JSON_MAX_DEPTH];
+
+  /* Levels opened past JSON_MAX_DEPTH, written as a single null and
+   * everything inside them dropped */
+  guint skipped;
+
+  /* A member name was written and its value is pending */
+  gboolean member;
+};
+
+struct _GstdJsonWriterClass
+{
+  GObjectClass parent_class;
+};
+
+static void gstd_iformatter_interface_init (GstdIFormatterInterface * iface);
+
+static void gstd_json_writer_finalize (GObject * object);
+
+static void gstd_json_writer_free_buffer (gpointer buffer);
+
+G_DEFINE_TYPE_WITH_CODE (GstdJsonWriter, gstd_json_writer, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE (GSTD_TYPE_IFORMATTER,
+        gstd_iformatter_interface_init));
+
+/* Idle buffer of the current thread, ready to be reused */
+static GPrivate gstd_json_writer_buffer =
+G_PRIVATE_INIT (gstd_json_writer_free_buffer);
+
+static void
+gstd_json_writer_free_buffer (gpointer buffer)
+{
+  g_string_free ((GString *) buffer, TRUE);
+}
+
+static void
+gstd_json_writer_class_init (GstdJsonWriterClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  object_class->finalize = gstd_json_writer_finalize;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_json_writer_debug, "gstdjsonwriter",
+      debug_color, "Gstd JSON writer category");
+}
+
+static void
+gstd_json_writer_init (GstdJsonWriter * self)
+{
+  GST_LOG_OBJECT (self, "Initializing Json writer");
+
+  self->buffer = g_private_get (&gstd_json_writer_buffer);
+  if (self->buffer) {
+    /* Take ownership, the slot must not free it */
+    g_private_set (&gstd_json_writer_buffer, NULL);
+    g_string_truncate (self->buffer, 0);
+  } else {
+    self->buffer = g_string_sized_new (JSON_BUFFER_SIZE);
+  }
+
+  self->depth = 0;
+  self->skipped = 0;
+  self->member = FALSE;
+}
+
+static void
+gstd_json_writer_reset (GstdJsonWriter * self)
+{
+  g_string_truncate (self->buffer, 0);
+  self->depth = 0;
+  self->skipped = 0;
+  self->member = FALSE;
+}
+
+static void
+gstd_json_writer_indent (GstdJsonWriter * self, guint level)
+{
+  gsize len = self->buffer->len;
+  gsize size = level * JSON_INDENT_LEVEL;
+
+  g_string_set_size (self->buffer, len + size);
+  memset (self->buffer->str + len, JSON_INDENT_CHAR, size);
+}
+
+/*
+ * Separates the upcoming value from its predecessor, unless it is the
+ * value of a member, whose name already did so.
+ */
+static void
+gstd_json_writer_separate (GstdJsonWriter * self)
+{
+  if (self->member) {
+    self->member = FALSE;
+    return;
+  }
+
+  if (0 == self->depth)
+    return;
+
+  if (self->has_children[self->depth - 1]) {
+    g_string_append_len (self->buffer, ",\n", 2);
+  } else {
+    g_string_append_c (self->buffer, '\n');
+    self->has_children[self->depth - 1] = TRUE;
+  }
+  gstd_json_writer_indent (self, self->depth);
+}
+
+void
+gstd_json_writer_append_escaped (GString * buffer, const gchar * str)
+{
+  const gchar *run = str;
+  const gchar *p;
+
+  g_return_if_fail (buffer);
+  g_return_if_fail (str);
+
+  g_string_append_c (buffer, '"');
+
+  /* Copy unescaped runs in bulk */
+  for (p = str; *p; p++) {
+    guchar c = *p;
+
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+
+    g_string_append_len (buffer, run, p - run);
+    run = p + 1;
+
+    switch (c) {
+      case '"':
+        g_string_append_len (buffer, "\\\"", 2);
+        break;
+      case '\\':
+        g_string_append_len (buffer, "\\\\", 2);
+        break;
+      case '\b':
+        g_string_append_len (buffer, "\\b", 2);
+        break;
+      case '\f':
+        g_string_append_len (buffer, "\\f", 2);
+        break;
+      case '\n':
+        g_string_append_len (buffer, "\\n", 2);
+        break;
+      case '\r':
+        g_string_append_len (buffer, "\\r", 2);
+        break;
+      case '\t':
+        g_string_append_len (buffer, "\\t", 2);
+        break;
+      default:
+        g_string_append_printf (buffer, "\\u%04x", c);
+        break;
+    }
+  }
+  g_string_append_len (buffer, run, p - run);
+
+  g_string_append_c (buffer, '"');
+}
+
+static void
+gstd_json_writer_escape (GstdJsonWriter * self, const gchar * str)
+{
+  gstd_json_writer_append_escaped (self->buffer, str);
+}
+
+static void
+gstd_json_writer_append_uint (GstdJsonWriter * self, guint64 value,
+    gboolean negative)
+{
+  gchar digits[24];
+  gchar *p = digits + sizeof (digits);
+
+  do {
+    *--p = '0' + (value % 10);
+    value /= 10;
+  } while (value);
+
+  if (negative)
+    *--p = '-';
+
+  g_string_append_len (self->buffer, p, digits + sizeof (digits) - p);
+}
+
+static void
+gstd_json_writer_append_int (GstdJsonWriter * self, gint64 value)
+{
+  /* Negate as unsigned so G_MININT64 doesn't overflow */
+  if (value < 0)
+    gstd_json_writer_append_uint (self, -(guint64) value, TRUE);
+  else
+    gstd_json_writer_append_uint (self, value, FALSE);
+}
+
+static void
+gstd_json_writer_append_double (GstdJsonWriter * self, gdouble value)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append (self->buffer, g_ascii_dtostr (buf, sizeof (buf), value));
+}
+
+static void
+gstd_json_writer_begin (GstdJsonWriter * self, gchar open)
+{
+  if (self->skipped) {
+    self->skipped++;
+    return;
+  }
+
+  gstd_json_writer_separate (self);
+
+  /* Keep the output valid, the whole level reads as null */
+  if (self->depth >= JSON_MAX_DEPTH) {
+    GST_ERROR_OBJECT (self, "JSON nesting deeper than %d levels",
+        JSON_MAX_DEPTH);
+    g_string_append_len (self->buffer, "null", 4);
+    self->skipped = 1;
+    return;
+  }
+
+  g_string_append_c (self->buffer, open);
+  self->has_children[self->depth] = FALSE;
+  self->depth++;
+}
+
+static void
+gstd_json_writer_end (GstdJsonWriter * self, gchar close)
+{
+  if (self->skipped) {
+    self->skipped--;
+    return;
+  }
+
+  g_return_if_fail (self->depth > 0);
+
+  self->depth--;
+  g_string_append_c (self->buffer, '\n');
+  gstd_json_writer_indent (self, self->depth);
+  g_string_append_c (self->buffer, close);
+}
+
+static void
+gstd_json_writer_begin_object (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  gstd_json_writer_begin (GSTD_JSON_WRITER (iface), '{');
+}
+
+static void
+gstd_json_writer_end_object (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  gstd_json_writer_end (GSTD_JSON_WRITER (iface), '}');
+}
+
+static void
+gstd_json_writer_begin_array (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  gstd_json_writer_begin (GSTD_JSON_WRITER (iface), '[');
+}
+
+static void
+gstd_json_writer_end_array (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  gstd_json_writer_end (GSTD_JSON_WRITER (iface), ']');
+}
+
+static void
+gstd_json_writer_set_member_name (GstdIFormatter * iface, const gchar * name)
+{
+  GstdJsonWriter *self;
+
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+  g_return_if_fail (name);
+
+  self = GSTD_JSON_WRITER (iface);
+  if (self->skipped)
+    return;
+
+  gstd_json_writer_separate (self);
+  gstd_json_writer_escape (self, name);
+  g_string_append_len (self->buffer, " : ", 3);
+  self->member = TRUE;
+}
+
+static void
+gstd_json_writer_set_string_value (GstdIFormatter * iface, const gchar * value)
+{
+  GstdJsonWriter *self;
+
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  self = GSTD_JSON_WRITER (iface);
+  if (self->skipped)
+    return;
+
+  gstd_json_writer_separate (self);
+  gstd_json_writer_escape (self, value ? value : "");
+}
+
+static void
+gstd_json_writer_set_null_value (GstdIFormatter * iface)
+{
+  GstdJsonWriter *self;
+
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  self = GSTD_JSON_WRITER (iface);
+  if (self->skipped)
+    return;
+
+  gstd_json_writer_separate (self);
+  g_string_append_len (self->buffer, "null", 4);
+}
+
+static void
+gstd_json_writer_set_value (GstdIFormatter * iface, const GValue * value)
+{
+  GstdJsonWriter *self;
+  const gchar *str_value;
+  gchar *contents;
+
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+  g_return_if_fail (value);
+
+  self = GSTD_JSON_WRITER (iface);
+  if (self->skipped)
+    return;
+
+  gstd_json_writer_separate (self);
+
+  switch (G_VALUE_TYPE (value)) {
+      /* Since Json format only supports string, boolean, integer and
+       * double, only related gtypes are cast to this formats
+       */
+    case G_TYPE_BOOLEAN:
+      g_string_append (self->buffer,
+          g_value_get_boolean (value) ? "true" : "false");
+      break;
+    case G_TYPE_INT:
+      gstd_json_writer_append_int (self, g_value_get_int (value));
+      break;
+    case G_TYPE_UINT:
+      gstd_json_writer_append_uint (self, g_value_get_uint (value), FALSE);
+      break;
+    case G_TYPE_INT64:
+      gstd_json_writer_append_int (self, g_value_get_int64 (value));
+      break;
+    case G_TYPE_UINT64:
+      gstd_json_writer_append_uint (self, g_value_get_uint64 (value), FALSE);
+      break;
+    case G_TYPE_FLOAT:
+      gstd_json_writer_append_double (self, g_value_get_float (value));
+      break;
+    case G_TYPE_DOUBLE:
+      gstd_json_writer_append_double (self, g_value_get_double (value));
+      break;
+    case G_TYPE_STRING:
+      str_value = g_value_get_string (value);
+      gstd_json_writer_escape (self, str_value ? str_value : "");
+      break;
+    default:
+      /* if the gvalue is not a boolean, integer or float point value, then
+       * gvalue is converted to string
+       */
+      contents = g_strdup_value_contents (value);
+      gstd_json_writer_escape (self, contents);
+      g_free (contents);
+  }
+}
+
+static void
+gstd_json_writer_generate (GstdIFormatter * iface, gchar ** outstring)
+{
+  GstdJsonWriter *self;
+
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+  g_return_if_fail (outstring);
+
+  self = GSTD_JSON_WRITER (iface);
+
+  if (self->depth > 0 || self->skipped > 0) {
+    GST_WARNING_OBJECT (self, "Generating with %u unclosed levels",
+        self->depth + self->skipped);
+  }
+
+  if (self->buffer->allocated_len > JSON_BUFFER_RETAIN) {
+    /* Too big to keep around, hand it out as is */
+    *outstring = g_string_free (self->buffer, FALSE);
+    self->buffer = g_string_sized_new (JSON_BUFFER_SIZE);
+  } else {
+    *outstring = g_strndup (self->buffer->str, self->buffer->len);
+  }
+
+  gstd_json_writer_reset (self);
+}
+
+static void
+gstd_json_writer_reset_iface (GstdIFormatter * iface)
+{
+  g_return_if_fail (GSTD_IS_JSON_WRITER (iface));
+
+  gstd_json_writer_reset (GSTD_JSON_WRITER (iface));
+}
+
+static void
+gstd_json_writer_finalize (GObject * object)
+{
+  GstdJsonWriter *self = GSTD_JSON_WRITER (object);
+
+  GST_LOG_OBJECT (self, "finalize");
+
+  /* Park the buffer for the next writer in this thread */
+  if (NULL == g_private_get (&gstd_json_writer_buffer)
+      && self->buffer->allocated_len <= JSON_BUFFER_RETAIN) {
+    g_private_set (&gstd_json_writer_buffer, self->buffer);
+  } else {
+    g_string_free (self->buffer, TRUE);
+  }
+  self->buffer = NULL;
+
+  G_OBJECT_CLASS (gstd_json_writer_parent_class)->finalize (object);
+}
+
+static void
+gstd_iformatter_interface_init (GstdIFormatterInterface * iface)
+{
+  iface->begin_object = gstd_json_writer_begin_object;
+  iface->end_object = gstd_json_writer_end_object;
+  iface->begin_array = gstd_json_writer_begin_array;
+  iface->end_array = gstd_json_writer_end_array;
+  iface->set_member_name = gstd_json_writer_set_member_name;
+  iface->set_string_value = gstd_json_writer_set_string_value;
+  iface->set_null_value = gstd_json_writer_set_null_value;
+  iface->set_value = gstd_json_writer_set_value;
+  iface->generate = gstd_json_writer_generate;
+  iface->reset = gstd_json_writer_reset_iface;
+}
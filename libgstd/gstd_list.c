@@ -27,6 +27,7 @@
 #include <string.h>
 
 #include "gstd_list.h"
+#include "gstd_metrics.h"
 #include "gstd_object.h"
 
 enum
@@ -48,7 +49,6 @@ GST_DEBUG_CATEGORY_STATIC (gstd_list_debug);
 #define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
 
 /* VTable */
-static gint gstd_list_find_node (gconstpointer, gconstpointer);
 static GstdReturnCode
 gstd_list_create (GstdObject * object, const gchar * name,
     const gchar * description);
@@ -58,23 +58,26 @@ static GstdReturnCode gstd_list_to_string (GstdObject *, gchar **);
 
 G_DEFINE_TYPE (GstdList, gstd_list, GSTD_TYPE_OBJECT);
 
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
 /* VTable */
 static void gstd_list_get_property (GObject *, guint, GValue *, GParamSpec *);
 static void
 gstd_list_set_property (GObject *, guint, const GValue *, GParamSpec *);
 static void gstd_list_dispose (GObject *);
+static void gstd_list_finalize (GObject *);
 
 static void
 gstd_list_class_init (GstdListClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GstdObjectClass *gstd_object_class = GSTD_OBJECT_CLASS (klass);
-  GParamSpec *properties[N_PROPERTIES] = { NULL, };
   guint debug_color;
 
   object_class->set_property = gstd_list_set_property;
   object_class->get_property = gstd_list_get_property;
   object_class->dispose = gstd_list_dispose;
+  object_class->finalize = gstd_list_finalize;
 
   properties[PROP_COUNT] =
       g_param_spec_uint ("count",
@@ -113,9 +116,33 @@ static void
 gstd_list_init (GstdList * self)
 {
   GST_INFO_OBJECT (self, "Initializing list");
-  self->list = NULL;
+  g_queue_init (&self->nodes);
+  self->index = g_hash_table_new (g_str_hash, g_str_equal);
   self->count = GSTD_LIST_DEFAULT_COUNT;
   self->node_type = GSTD_LIST_DEFAULT_NODE_TYPE;
+  self->names = NULL;
+  self->make_node = NULL;
+  self->factory_data = NULL;
+  self->factory_notify = NULL;
+}
+
+/*
+ * Takes the lock of @self, timing the wait only when it is busy so the
+ * free case costs no clock read
+ */
+static void
+gstd_list_lock (GstdList * self)
+{
+  GstClockTime start;
+
+  if (G_LIKELY (g_mutex_trylock (GST_OBJECT_GET_LOCK (self)))) {
+    gstd_metrics_observe_list_lock (0);
+    return;
+  }
+
+  start = gst_util_get_timestamp ();
+  GST_OBJECT_LOCK (self);
+  gstd_metrics_observe_list_lock (MAX (gst_util_get_timestamp () - start, 1));
 }
 
 static void
@@ -125,24 +152,49 @@ gstd_list_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s list", GSTD_OBJECT_NAME (self));
 
-  GST_OBJECT_LOCK (self);
-  if (self->list) {
-    g_list_free_full (self->list, g_object_unref);
-    self->list = NULL;
-  }
+  gstd_list_lock (self);
+  g_hash_table_remove_all (self->index);
+  g_list_free_full (self->nodes.head, g_object_unref);
+  g_queue_init (&self->nodes);
+  self->count = 0;
   GST_OBJECT_UNLOCK (self);
 
+  if (self->factory_notify) {
+    self->factory_notify (self->factory_data);
+  }
+  self->names = NULL;
+  self->make_node = NULL;
+  self->factory_data = NULL;
+  self->factory_notify = NULL;
+
   G_OBJECT_CLASS (gstd_list_parent_class)->dispose (object);
 }
 
+static void
+gstd_list_finalize (GObject * object)
+{
+  GstdList *self = GSTD_LIST (object);
+
+  g_hash_table_unref (self->index);
+
+  G_OBJECT_CLASS (gstd_list_parent_class)->finalize (object);
+}
+
 static void
 gstd_list_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec)
 {
   GstdList *self = GSTD_LIST (object);
+  GPtrArray *names;
 
   switch (property_id) {
     case PROP_COUNT:
+      if (self->names) {
+        names = self->names (self, self->factory_data);
+        g_value_set_uint (value, names->len);
+        g_ptr_array_unref (names);
+        break;
+      }
       GST_DEBUG_OBJECT (self, "Returning count of %u", self->count);
       g_value_set_uint (value, self->count);
       break;
@@ -185,17 +237,6 @@ gstd_list_set_property (GObject * object,
   }
 }
 
-static gint
-gstd_list_find_node (gconstpointer _obj, gconstpointer _name)
-{
-  GstdObject *obj = GSTD_OBJECT (_obj);
-  gchar *name = (gchar *) _name;
-
-  GST_LOG ("Comparing %s vs %s", GSTD_OBJECT_NAME (obj), name);
-
-  return strcmp (GSTD_OBJECT_NAME (obj), name);
-}
-
 static GstdReturnCode
 gstd_list_create (GstdObject * object, const gchar * name,
     const gchar * description)
@@ -255,8 +296,8 @@ gstd_list_delete (GstdObject * object, const gchar * node)
   g_return_val_if_fail (object->deleter, GSTD_MISSING_INITIALIZATION);
 
   /* Test if the resource to delete exists */
-  GST_OBJECT_LOCK (self);
-  found = g_list_find_custom (self->list, node, gstd_list_find_node);
+  gstd_list_lock (self);
+  found = g_hash_table_lookup (self->index, node);
 
   if (!found) {
     GST_OBJECT_UNLOCK (self);
@@ -268,17 +309,23 @@ gstd_list_delete (GstdObject * object, const gchar * node)
   GST_INFO_OBJECT (self, "Deleting %s from %s list", GSTD_OBJECT_NAME (self),
       GSTD_OBJECT_NAME (self));
 
+  /* The index key is owned by the node, drop it before the deleter
+   * releases the node */
+  g_hash_table_remove (self->index, node);
+
   ret = gstd_ideleter_delete (object->deleter, todelete);
   if (ret) {
+    g_hash_table_insert (self->index, GSTD_OBJECT_NAME (todelete), found);
     GST_OBJECT_UNLOCK (self);
     return ret;
   }
 
-  self->count--;
-
-  self->list = g_list_delete_link (self->list, found);
+  g_queue_delete_link (&self->nodes, found);
+  self->count = self->nodes.length;
   GST_OBJECT_UNLOCK (self);
 
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_COUNT]);
+
   return ret;
 
 unexisting:
@@ -293,44 +340,89 @@ static GstdReturnCode
 gstd_list_to_string (GstdObject * object, gchar ** outstring)
 {
   GstdList *self = GSTD_LIST (object);
-  gchar *props;
-  gchar *acc;
-  gchar *node;
+  GstdIFormatter *formatter;
+  GPtrArray *snapshot;
   GList *list;
-  const gchar *separator;
+  guint i;
 
   g_return_val_if_fail (GSTD_IS_OBJECT (object), GSTD_NULL_ARGUMENT);
   g_warn_if_fail (!*outstring);
 
-  /* Lets leverage the parent's class implementation */
-  GSTD_OBJECT_CLASS (gstd_list_parent_class)->to_string (GSTD_OBJECT (object),
-      &props);
-  // A little hack to remove the last bracket
-  props[strlen (props) - 2] = '\0';
+  /* Only hold the lock long enough to take a copy of each name. Lazy
+   * lists are listed without creating their nodes */
+  if (self->names) {
+    snapshot = self->names (self, self->factory_data);
+  } else {
+    gstd_list_lock (self);
+    snapshot = g_ptr_array_new_full (self->nodes.length, g_free);
+    for (list = self->nodes.head; list; list = list->next) {
+      g_ptr_array_add (snapshot, g_strdup (GSTD_OBJECT_NAME (list->data)));
+    }
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  formatter = gstd_object_new_formatter (object);
 
-  acc = g_strdup ("");
+  gstd_iformatter_begin_object (formatter);
+  gstd_object_format_properties (object, formatter);
 
-  /* Lock while iterating the list to prevent concurrent modification */
-  GST_OBJECT_LOCK (self);
-  list = self->list;
-  while (list) {
-    separator = list->next ? "," : "";
-    node =
-        g_strdup_printf ("%s{\n    \"name\" : \"%s\"\n  }%s", acc,
-        GSTD_OBJECT_NAME (list->data), separator);
-    g_free (acc);
-    acc = node;
-    list = list->next;
+  gstd_iformatter_set_member_name (formatter, "nodes");
+  gstd_iformatter_begin_array (formatter);
+  for (i = 0; i < snapshot->len; i++) {
+    gstd_iformatter_begin_object (formatter);
+    gstd_iformatter_set_member_name (formatter, "name");
+    gstd_iformatter_set_string_value (formatter,
+        g_ptr_array_index (snapshot, i));
+    gstd_iformatter_end_object (formatter);
   }
-  GST_OBJECT_UNLOCK (self);
+  gstd_iformatter_end_array (formatter);
 
-  *outstring = g_strdup_printf ("%s,\n  \"nodes\" : [%s]\n}", props, acc);
-  g_free (props);
-  g_free (acc);
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  g_object_unref (formatter);
+  g_ptr_array_unref (snapshot);
 
   return GSTD_EOK;
 }
 
+/*
+ * Creates the node of a lazy list and keeps it. The node is created
+ * outside the lock, if another thread got to add it first, that one
+ * is used.
+ */
+static GstdObject *
+gstd_list_make_child (GstdList * self, const gchar * name)
+{
+  GstdObject *child;
+  GList *found;
+
+  child = self->make_node (self, name, self->factory_data);
+  if (!child) {
+    return NULL;
+  }
+
+  gstd_list_lock (self);
+  found = g_hash_table_lookup (self->index, GSTD_OBJECT_NAME (child));
+  if (found) {
+    GST_OBJECT_UNLOCK (self);
+    g_object_unref (child);
+    return g_object_ref (found->data);
+  }
+
+  g_queue_push_tail (&self->nodes, child);
+  g_hash_table_insert (self->index, GSTD_OBJECT_NAME (child),
+      self->nodes.tail);
+  self->count = self->nodes.length;
+  GST_OBJECT_UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "Created %s in %s list", name,
+      GSTD_OBJECT_NAME (self));
+
+  return g_object_ref (child);
+}
+
 GstdObject *
 gstd_list_find_child (GstdList * self, const gchar * name)
 {
@@ -340,8 +432,8 @@ gstd_list_find_child (GstdList * self, const gchar * name)
   g_return_val_if_fail (self, NULL);
   g_return_val_if_fail (name, NULL);
 
-  GST_OBJECT_LOCK (self);
-  result = g_list_find_custom (self->list, name, gstd_list_find_node);
+  gstd_list_lock (self);
+  result = g_hash_table_lookup (self->index, name);
 
   if (result) {
     child = GSTD_OBJECT (result->data);
@@ -353,30 +445,34 @@ gstd_list_find_child (GstdList * self, const gchar * name)
   }
   GST_OBJECT_UNLOCK (self);
 
+  if (!child && self->make_node) {
+    child = gstd_list_make_child (self, name);
+  }
+
   return child;
 }
 
 gboolean
 gstd_list_append_child (GstdList * self, GstdObject * child)
 {
-  GList *found;
-
   g_return_val_if_fail (self, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (child, GSTD_NULL_ARGUMENT);
 
   /* Test if the resource to create already exists */
-  GST_OBJECT_LOCK (self);
-  found =
-      g_list_find_custom (self->list, GSTD_OBJECT_NAME (child),
-      gstd_list_find_node);
-  if (found) {
+  gstd_list_lock (self);
+  if (g_hash_table_contains (self->index, GSTD_OBJECT_NAME (child))) {
     GST_OBJECT_UNLOCK (self);
     goto exists;
   }
 
-  self->list = g_list_append (self->list, child);
-  self->count = g_list_length (self->list);
+  g_queue_push_tail (&self->nodes, child);
+  g_hash_table_insert (self->index, GSTD_OBJECT_NAME (child),
+      self->nodes.tail);
+  self->count = self->nodes.length;
   GST_OBJECT_UNLOCK (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_COUNT]);
+
   GST_INFO_OBJECT (self, "Appended %s to %s list", GSTD_OBJECT_NAME (child),
       GSTD_OBJECT_NAME (self));
 
@@ -389,3 +485,51 @@ exists:
     return FALSE;
   }
 }
+
+gboolean
+gstd_list_remove_child (GstdList * self, const gchar * name)
+{
+  GstdObject *child;
+  GList *found;
+
+  g_return_val_if_fail (GSTD_IS_LIST (self), FALSE);
+  g_return_val_if_fail (name, FALSE);
+
+  gstd_list_lock (self);
+  found = g_hash_table_lookup (self->index, name);
+  if (!found) {
+    GST_OBJECT_UNLOCK (self);
+    return FALSE;
+  }
+
+  child = found->data;
+  g_hash_table_remove (self->index, name);
+  g_queue_delete_link (&self->nodes, found);
+  self->count = self->nodes.length;
+  GST_OBJECT_UNLOCK (self);
+
+  GST_INFO_OBJECT (self, "Removed %s from %s list", name,
+      GSTD_OBJECT_NAME (self));
+
+  /* The node owns the index key, release it last */
+  g_object_unref (child);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_COUNT]);
+
+  return TRUE;
+}
+
+void
+gstd_list_set_node_factory (GstdList * self, GstdListNamesFunc names,
+    GstdListNodeFunc make_node, gpointer user_data, GDestroyNotify notify)
+{
+  g_return_if_fail (GSTD_IS_LIST (self));
+  g_return_if_fail (names);
+  g_return_if_fail (make_node);
+  g_return_if_fail (NULL == self->make_node);
+
+  self->names = names;
+  self->make_node = make_node;
+  self->factory_data = user_data;
+  self->factory_notify = notify;
+}
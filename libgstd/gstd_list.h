@@ -44,6 +44,28 @@ G_BEGIN_DECLS
 typedef struct _GstdList GstdList;
 typedef struct _GstdListClass GstdListClass;
 
+/**
+ * GstdListNamesFunc:
+ * @list: The list being enumerated
+ * @user_data: The data given to gstd_list_set_node_factory()
+ *
+ * Returns: (transfer full): The names of every node the list can
+ * hold, whether it was created already or not, in listing order.
+ */
+typedef GPtrArray *(*GstdListNamesFunc) (GstdList * list, gpointer user_data);
+
+/**
+ * GstdListNodeFunc:
+ * @list: The list missing the node
+ * @name: The name of the node to create
+ * @user_data: The data given to gstd_list_set_node_factory()
+ *
+ * Returns: (transfer full) (nullable): The new node called @name, NULL
+ * if the list has no such node.
+ */
+typedef GstdObject *(*GstdListNodeFunc) (GstdList * list, const gchar * name,
+    gpointer user_data);
+
 /**
  * GstdList:
  * A wrapper for the conventional list
@@ -58,7 +80,26 @@ struct _GstdList
 
   GParamFlags flags;
 
-  GList *list;
+  /*
+   * The nodes in insertion order. Listing iterates this sequence so
+   * the output order is stable.
+   */
+  GQueue nodes;
+
+  /*
+   * Name to GList link index into nodes, so lookup, insertion and
+   * deletion by name don't need to walk the sequence.
+   */
+  GHashTable *index;
+
+  /*
+   * Creates nodes on their first lookup, see
+   * gstd_list_set_node_factory(). Set once before the list is shared.
+   */
+  GstdListNamesFunc names;
+  GstdListNodeFunc make_node;
+  gpointer factory_data;
+  GDestroyNotify factory_notify;
 };
 
 struct _GstdListClass
@@ -71,5 +112,32 @@ GType gstd_list_get_type (void);
 GstdObject *gstd_list_find_child (GstdList * self, const gchar * name);
 gboolean gstd_list_append_child (GstdList *, GstdObject * child);
 
+/**
+ * gstd_list_remove_child:
+ * @self: The list holding the node
+ * @name: The name of the node to drop
+ *
+ * Drops a node without going through the list deleter, for lists
+ * that mirror a collection maintained elsewhere.
+ *
+ * Returns: TRUE if the node was in the list.
+ */
+gboolean gstd_list_remove_child (GstdList * self, const gchar * name);
+
+/**
+ * gstd_list_set_node_factory:
+ * @self: A list with no nodes yet
+ * @names: Enumerates the nodes for listing and counting
+ * @make_node: Creates a node missing from the list
+ * @user_data: Data to pass to @names and @make_node
+ * @notify: (nullable): Frees @user_data along with the list
+ *
+ * Makes the list create its nodes lazily: a node is only instantiated
+ * when gstd_list_find_child() first looks it up, and kept afterwards.
+ * Listing and "count" are answered from @names without creating any.
+ */
+void gstd_list_set_node_factory (GstdList * self, GstdListNamesFunc names,
+    GstdListNodeFunc make_node, gpointer user_data, GDestroyNotify notify);
+
 G_END_DECLS
 #endif // __GSTD_LIST_H__
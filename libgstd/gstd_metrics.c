@@ -0,0 +1,631 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_metrics.h"
+#include "gstd_pipeline.h"
+
+/* Upper bounds of the latency buckets, the last one is +Inf */
+static const struct
+{
+  GstClockTime bound;
+  const gchar *le;
+} gstd_metrics_buckets[] = {
+  {50 * GST_USECOND, "5e-05"},
+  {100 * GST_USECOND, "0.0001"},
+  {250 * GST_USECOND, "0.00025"},
+  {500 * GST_USECOND, "0.0005"},
+  {GST_MSECOND, "0.001"},
+  {2500 * GST_USECOND, "0.0025"},
+  {5 * GST_MSECOND, "0.005"},
+  {10 * GST_MSECOND, "0.01"},
+  {25 * GST_MSECOND, "0.025"},
+  {50 * GST_MSECOND, "0.05"},
+  {100 * GST_MSECOND, "0.1"},
+  {250 * GST_MSECOND, "0.25"},
+  {500 * GST_MSECOND, "0.5"},
+  {GST_SECOND, "1"},
+  {2500 * GST_MSECOND, "2.5"},
+  {5 * GST_SECOND, "5"},
+  {10 * GST_SECOND, "10"},
+};
+
+#define GSTD_METRICS_BUCKETS G_N_ELEMENTS (gstd_metrics_buckets)
+
+/*
+ * Counters are gsize so they can be bumped with g_atomic_pointer_add().
+ * Nanosecond totals would wrap a 32-bit gsize in a few seconds, so they
+ * are guint64 and go through gstd_metrics_sum_add() instead
+ */
+typedef struct _GstdMetricsHistogram
+{
+  gsize buckets[GSTD_METRICS_BUCKETS + 1];
+  guint64 sum;
+  gsize errors;
+} GstdMetricsHistogram;
+
+typedef struct _GstdMetricsPool
+{
+  const gchar *name;
+  GThreadPool *pool;
+} GstdMetricsPool;
+
+struct _GstdMetricsPipeline
+{
+  gint refcount;
+
+  /* Only compared, the pipeline owns its counters */
+  gpointer target;
+
+  gsize transitions;
+  gsize errors;
+  gsize processed;
+  gsize dropped;
+
+  /* The last QoS totals of each element, only used from the streaming
+   * threads. Protected by lock */
+  GMutex lock;
+  GHashTable *qos;
+};
+
+typedef struct _GstdMetricsQos
+{
+  guint64 processed;
+  guint64 dropped;
+} GstdMetricsQos;
+
+static const gchar *gstd_metrics_ipc_names[GSTD_METRICS_IPC_COUNT] = {
+  [GSTD_METRICS_IPC_API] = "api",
+  [GSTD_METRICS_IPC_TCP] = "tcp",
+  [GSTD_METRICS_IPC_UNIX] = "unix",
+  [GSTD_METRICS_IPC_HTTP] = "http",
+};
+
+/* The IPC of the calling thread, API if never set */
+static GPrivate gstd_metrics_thread_ipc;
+
+static GstdMetricsHistogram
+    gstd_metrics_commands[GSTD_METRICS_IPC_COUNT][GSTD_METRICS_MAX_COMMANDS];
+static const gchar *gstd_metrics_command_names[GSTD_METRICS_MAX_COMMANDS];
+
+static gsize gstd_metrics_lock_acquired = 0;
+static gsize gstd_metrics_lock_contended = 0;
+static guint64 gstd_metrics_lock_waited = 0;
+
+#if GLIB_SIZEOF_VOID_P < 8
+/* Without 64-bit pointer atomics the nanosecond sums take a lock */
+static GMutex gstd_metrics_sum_lock;
+#endif
+
+/* Only taken to add, remove or export pools */
+static GMutex gstd_metrics_pools_lock;
+static GSList *gstd_metrics_pools = NULL;
+
+static void gstd_metrics_on_message (GstdPipelineBus * bus,
+    GstMessage * message, guint64 seq, gpointer user_data);
+static void gstd_metrics_append_escaped (GString * out, const gchar * str);
+static void gstd_metrics_append_seconds (GString * out, guint64 ns);
+static void gstd_metrics_sum_add (guint64 * sum, guint64 ns);
+static guint64 gstd_metrics_sum_get (guint64 * sum);
+
+const gchar *
+gstd_metrics_ipc_get_name (GstdMetricsIpc ipc)
+{
+  g_return_val_if_fail (ipc < GSTD_METRICS_IPC_COUNT, NULL);
+
+  return gstd_metrics_ipc_names[ipc];
+}
+
+void
+gstd_metrics_set_thread_ipc (GstdMetricsIpc ipc)
+{
+  g_return_if_fail (ipc < GSTD_METRICS_IPC_COUNT);
+
+  g_private_set (&gstd_metrics_thread_ipc, GINT_TO_POINTER (ipc));
+}
+
+void
+gstd_metrics_observe_command (guint slot, const gchar * name,
+    GstdReturnCode ret, GstClockTime elapsed)
+{
+  GstdMetricsHistogram *histogram;
+  GstdMetricsIpc ipc;
+  guint bucket;
+
+  g_return_if_fail (slot < GSTD_METRICS_MAX_COMMANDS);
+  g_return_if_fail (name);
+
+  ipc = GPOINTER_TO_INT (g_private_get (&gstd_metrics_thread_ipc));
+  histogram = &gstd_metrics_commands[ipc][slot];
+
+  /* Names are static, every thread writes the same pointer */
+  if (G_UNLIKELY (NULL == g_atomic_pointer_get
+          (&gstd_metrics_command_names[slot]))) {
+    g_atomic_pointer_set (&gstd_metrics_command_names[slot], name);
+  }
+
+  for (bucket = 0; bucket < GSTD_METRICS_BUCKETS; bucket++) {
+    if (elapsed <= gstd_metrics_buckets[bucket].bound) {
+      break;
+    }
+  }
+
+  g_atomic_pointer_add (&histogram->buckets[bucket], 1);
+  gstd_metrics_sum_add (&histogram->sum, elapsed);
+  if (GSTD_EOK != ret) {
+    g_atomic_pointer_add (&histogram->errors, 1);
+  }
+}
+
+void
+gstd_metrics_observe_list_lock (GstClockTime waited)
+{
+  g_atomic_pointer_add (&gstd_metrics_lock_acquired, 1);
+
+  if (waited) {
+    g_atomic_pointer_add (&gstd_metrics_lock_contended, 1);
+    gstd_metrics_sum_add (&gstd_metrics_lock_waited, waited);
+  }
+}
+
+void
+gstd_metrics_add_pool (const gchar * name, GThreadPool * pool)
+{
+  GstdMetricsPool *entry;
+
+  g_return_if_fail (name);
+  g_return_if_fail (pool);
+
+  entry = g_new (GstdMetricsPool, 1);
+  entry->name = name;
+  entry->pool = pool;
+
+  g_mutex_lock (&gstd_metrics_pools_lock);
+  gstd_metrics_pools = g_slist_append (gstd_metrics_pools, entry);
+  g_mutex_unlock (&gstd_metrics_pools_lock);
+}
+
+void
+gstd_metrics_remove_pool (GThreadPool * pool)
+{
+  GSList *iter;
+
+  g_mutex_lock (&gstd_metrics_pools_lock);
+  for (iter = gstd_metrics_pools; iter; iter = g_slist_next (iter)) {
+    GstdMetricsPool *entry = iter->data;
+
+    if (entry->pool == pool) {
+      gstd_metrics_pools = g_slist_delete_link (gstd_metrics_pools, iter);
+      g_free (entry);
+      break;
+    }
+  }
+  g_mutex_unlock (&gstd_metrics_pools_lock);
+}
+
+GstdMetricsPipeline *
+gstd_metrics_pipeline_new (void)
+{
+  GstdMetricsPipeline *self;
+
+  self = g_new0 (GstdMetricsPipeline, 1);
+  self->refcount = 1;
+  g_mutex_init (&self->lock);
+  self->qos = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      g_free);
+
+  return self;
+}
+
+GstdMetricsPipeline *
+gstd_metrics_pipeline_ref (GstdMetricsPipeline * self)
+{
+  g_return_val_if_fail (self, NULL);
+
+  g_atomic_int_inc (&self->refcount);
+  return self;
+}
+
+void
+gstd_metrics_pipeline_unref (GstdMetricsPipeline * self)
+{
+  g_return_if_fail (self);
+
+  if (!g_atomic_int_dec_and_test (&self->refcount))
+    return;
+
+  g_hash_table_unref (self->qos);
+  g_mutex_clear (&self->lock);
+  g_free (self);
+}
+
+/*
+ * QoS messages carry the running totals of the element posting them,
+ * only the difference with its previous message is added
+ */
+static void
+gstd_metrics_on_qos (GstdMetricsPipeline * self, GstMessage * message)
+{
+  GstdMetricsQos *last;
+  GstFormat format;
+  guint64 processed;
+  guint64 dropped;
+  guint64 new_processed = 0;
+  guint64 new_dropped = 0;
+
+  gst_message_parse_qos_stats (message, &format, &processed, &dropped);
+  if (GST_FORMAT_BUFFERS != format && GST_FORMAT_DEFAULT != format) {
+    return;
+  }
+
+  g_mutex_lock (&self->lock);
+  last = g_hash_table_lookup (self->qos, GST_MESSAGE_SRC (message));
+  if (!last) {
+    last = g_new0 (GstdMetricsQos, 1);
+    g_hash_table_insert (self->qos, GST_MESSAGE_SRC (message), last);
+  }
+
+  /* -1 if unknown, a smaller total means the element was reset */
+  if (G_MAXUINT64 != processed) {
+    new_processed = processed >= last->processed ?
+        processed - last->processed : processed;
+    last->processed = processed;
+  }
+  if (G_MAXUINT64 != dropped) {
+    new_dropped = dropped >= last->dropped ? dropped - last->dropped : dropped;
+    last->dropped = dropped;
+  }
+  g_mutex_unlock (&self->lock);
+
+  g_atomic_pointer_add (&self->processed, new_processed);
+  g_atomic_pointer_add (&self->dropped, new_dropped);
+}
+
+/* Runs in the posting thread, with the bus subscriptions locked */
+static void
+gstd_metrics_on_message (GstdPipelineBus * bus, GstMessage * message,
+    guint64 seq, gpointer user_data)
+{
+  GstdMetricsPipeline *self = user_data;
+
+  if (!message) {
+    return;
+  }
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_STATE_CHANGED:
+      if (GST_MESSAGE_SRC (message) == self->target) {
+        g_atomic_pointer_add (&self->transitions, 1);
+      }
+      break;
+    case GST_MESSAGE_ERROR:
+      g_atomic_pointer_add (&self->errors, 1);
+      break;
+    case GST_MESSAGE_QOS:
+      gstd_metrics_on_qos (self, message);
+      break;
+    default:
+      break;
+  }
+}
+
+void
+gstd_metrics_pipeline_track (GstdMetricsPipeline * self,
+    GstElement * pipeline, GstdPipelineBus * bus)
+{
+  guint id;
+
+  g_return_if_fail (self);
+  g_return_if_fail (GST_IS_ELEMENT (pipeline));
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (bus));
+
+  self->target = pipeline;
+
+  id = gstd_pipeline_bus_subscribe (bus, GST_MESSAGE_STATE_CHANGED |
+      GST_MESSAGE_ERROR | GST_MESSAGE_QOS, GSTD_PIPELINE_BUS_SEQ_NONE,
+      gstd_metrics_on_message, gstd_metrics_pipeline_ref (self),
+      (GDestroyNotify) gstd_metrics_pipeline_unref);
+
+  if (0 == id) {
+    gstd_metrics_pipeline_unref (self);
+  }
+}
+
+void
+gstd_metrics_pipeline_get (GstdMetricsPipeline * self, guint64 * transitions,
+    guint64 * errors, guint64 * processed, guint64 * dropped)
+{
+  g_return_if_fail (self);
+
+  if (transitions) {
+    *transitions = g_atomic_pointer_get (&self->transitions);
+  }
+  if (errors) {
+    *errors = g_atomic_pointer_get (&self->errors);
+  }
+  if (processed) {
+    *processed = g_atomic_pointer_get (&self->processed);
+  }
+  if (dropped) {
+    *dropped = g_atomic_pointer_get (&self->dropped);
+  }
+}
+
+/* Label values escape backslashes, quotes and line feeds */
+static void
+gstd_metrics_append_escaped (GString * out, const gchar * str)
+{
+  for (; *str; str++) {
+    if ('\\' == *str || '"' == *str) {
+      g_string_append_c (out, '\\');
+    } else if ('\n' == *str) {
+      g_string_append (out, "\\n");
+      continue;
+    }
+    g_string_append_c (out, *str);
+  }
+}
+
+static void
+gstd_metrics_sum_add (guint64 * sum, guint64 ns)
+{
+#if GLIB_SIZEOF_VOID_P < 8
+  g_mutex_lock (&gstd_metrics_sum_lock);
+  *sum += ns;
+  g_mutex_unlock (&gstd_metrics_sum_lock);
+#else
+  g_atomic_pointer_add ((gsize *) sum, ns);
+#endif
+}
+
+static guint64
+gstd_metrics_sum_get (guint64 * sum)
+{
+#if GLIB_SIZEOF_VOID_P < 8
+  guint64 ns;
+
+  g_mutex_lock (&gstd_metrics_sum_lock);
+  ns = *sum;
+  g_mutex_unlock (&gstd_metrics_sum_lock);
+
+  return ns;
+#else
+  return (guint64) g_atomic_pointer_get ((gsize *) sum);
+#endif
+}
+
+static void
+gstd_metrics_append_seconds (GString * out, guint64 ns)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append (out, g_ascii_dtostr (buf, sizeof (buf),
+          (gdouble) ns / GST_SECOND));
+}
+
+static void
+gstd_metrics_format_commands (GString * out)
+{
+  guint ipc;
+  guint slot;
+  guint bucket;
+
+  g_string_append (out,
+      "# HELP gstd_command_duration_seconds Time taken to run a command.\n"
+      "# TYPE gstd_command_duration_seconds histogram\n");
+
+  for (ipc = 0; ipc < GSTD_METRICS_IPC_COUNT; ipc++) {
+    for (slot = 0; slot < GSTD_METRICS_MAX_COMMANDS; slot++) {
+      GstdMetricsHistogram *histogram = &gstd_metrics_commands[ipc][slot];
+      const gchar *name = g_atomic_pointer_get
+          (&gstd_metrics_command_names[slot]);
+      gsize count = 0;
+
+      if (!name) {
+        continue;
+      }
+
+      /* Commands never run through this IPC are left out */
+      for (bucket = 0; bucket <= GSTD_METRICS_BUCKETS; bucket++) {
+        count += g_atomic_pointer_get (&histogram->buckets[bucket]);
+      }
+      if (0 == count) {
+        continue;
+      }
+
+      /* Buckets are cumulative, a concurrent update may be seen in a
+       * bucket and not in the following ones, count is the last one */
+      count = 0;
+      for (bucket = 0; bucket <= GSTD_METRICS_BUCKETS; bucket++) {
+        count += g_atomic_pointer_get (&histogram->buckets[bucket]);
+        g_string_append_printf (out,
+            "gstd_command_duration_seconds_bucket{ipc=\"%s\",command=\"%s\","
+            "le=\"%s\"} %" G_GSIZE_FORMAT "\n", gstd_metrics_ipc_names[ipc],
+            name, bucket < GSTD_METRICS_BUCKETS ?
+            gstd_metrics_buckets[bucket].le : "+Inf", count);
+      }
+
+      g_string_append_printf (out,
+          "gstd_command_duration_seconds_sum{ipc=\"%s\",command=\"%s\"} ",
+          gstd_metrics_ipc_names[ipc], name);
+      gstd_metrics_append_seconds (out,
+          gstd_metrics_sum_get (&histogram->sum));
+      g_string_append_printf (out,
+          "\ngstd_command_duration_seconds_count{ipc=\"%s\",command=\"%s\"} %"
+          G_GSIZE_FORMAT "\n", gstd_metrics_ipc_names[ipc], name, count);
+    }
+  }
+
+  g_string_append (out,
+      "# HELP gstd_command_errors_total Commands that didn't return 0.\n"
+      "# TYPE gstd_command_errors_total counter\n");
+
+  for (ipc = 0; ipc < GSTD_METRICS_IPC_COUNT; ipc++) {
+    for (slot = 0; slot < GSTD_METRICS_MAX_COMMANDS; slot++) {
+      GstdMetricsHistogram *histogram = &gstd_metrics_commands[ipc][slot];
+      const gchar *name = g_atomic_pointer_get
+          (&gstd_metrics_command_names[slot]);
+      gsize errors = g_atomic_pointer_get (&histogram->errors);
+
+      if (name && errors) {
+        g_string_append_printf (out,
+            "gstd_command_errors_total{ipc=\"%s\",command=\"%s\"} %"
+            G_GSIZE_FORMAT "\n", gstd_metrics_ipc_names[ipc], name, errors);
+      }
+    }
+  }
+}
+
+static void
+gstd_metrics_format_pools (GString * out)
+{
+  GSList *iter;
+
+  g_string_append (out,
+      "# HELP gstd_thread_pool_queue_depth Tasks waiting for a thread.\n"
+      "# TYPE gstd_thread_pool_queue_depth gauge\n");
+
+  g_mutex_lock (&gstd_metrics_pools_lock);
+  for (iter = gstd_metrics_pools; iter; iter = g_slist_next (iter)) {
+    GstdMetricsPool *entry = iter->data;
+
+    g_string_append_printf (out,
+        "gstd_thread_pool_queue_depth{pool=\"%s\"} %u\n", entry->name,
+        g_thread_pool_unprocessed (entry->pool));
+  }
+
+  g_string_append (out,
+      "# HELP gstd_thread_pool_threads Threads currently in the pool.\n"
+      "# TYPE gstd_thread_pool_threads gauge\n");
+
+  for (iter = gstd_metrics_pools; iter; iter = g_slist_next (iter)) {
+    GstdMetricsPool *entry = iter->data;
+
+    g_string_append_printf (out,
+        "gstd_thread_pool_threads{pool=\"%s\"} %u\n", entry->name,
+        g_thread_pool_get_num_threads (entry->pool));
+  }
+  g_mutex_unlock (&gstd_metrics_pools_lock);
+}
+
+static void
+gstd_metrics_format_list_lock (GString * out)
+{
+  g_string_append_printf (out,
+      "# HELP gstd_list_lock_acquisitions_total Times a list lock was taken.\n"
+      "# TYPE gstd_list_lock_acquisitions_total counter\n"
+      "gstd_list_lock_acquisitions_total %" G_GSIZE_FORMAT "\n"
+      "# HELP gstd_list_lock_contended_total Times a list lock was busy.\n"
+      "# TYPE gstd_list_lock_contended_total counter\n"
+      "gstd_list_lock_contended_total %" G_GSIZE_FORMAT "\n"
+      "# HELP gstd_list_lock_wait_seconds_total Time spent waiting for a "
+      "busy list lock.\n"
+      "# TYPE gstd_list_lock_wait_seconds_total counter\n"
+      "gstd_list_lock_wait_seconds_total ",
+      g_atomic_pointer_get (&gstd_metrics_lock_acquired),
+      g_atomic_pointer_get (&gstd_metrics_lock_contended));
+  gstd_metrics_append_seconds (out,
+      gstd_metrics_sum_get (&gstd_metrics_lock_waited));
+  g_string_append_c (out, '\n');
+}
+
+static void
+gstd_metrics_format_pipelines (GString * out, GstdList * list)
+{
+  static const struct
+  {
+    const gchar *name;
+    const gchar *help;
+  } counters[] = {
+    {"gstd_pipeline_state_transitions_total",
+        "State changes of the top-level bin."},
+    {"gstd_pipeline_errors_total", "Error messages posted on the bus."},
+    {"gstd_pipeline_qos_processed_total",
+        "Buffers processed according to QoS messages."},
+    {"gstd_pipeline_qos_dropped_total",
+        "Buffers dropped according to QoS messages."},
+  };
+  GList *pipelines;
+  GList *iter;
+  GString *series[G_N_ELEMENTS (counters)];
+  guint64 values[G_N_ELEMENTS (counters)];
+  guint count;
+  guint i;
+
+  /* Only hold the list lock to take the pipelines */
+  GST_OBJECT_LOCK (list);
+  pipelines = g_list_copy_deep (list->nodes.head, (GCopyFunc) gst_object_ref,
+      NULL);
+  count = list->count;
+  GST_OBJECT_UNLOCK (list);
+
+  g_string_append_printf (out,
+      "# HELP gstd_pipelines Pipelines in the session.\n"
+      "# TYPE gstd_pipelines gauge\ngstd_pipelines %u\n", count);
+
+  for (i = 0; i < G_N_ELEMENTS (counters); i++) {
+    series[i] = g_string_new (NULL);
+  }
+
+  for (iter = pipelines; iter; iter = g_list_next (iter)) {
+    GstdPipeline *pipeline = GSTD_PIPELINE (iter->data);
+    GstdMetricsPipeline *metrics = gstd_pipeline_get_metrics (pipeline);
+
+    if (!metrics) {
+      continue;
+    }
+
+    gstd_metrics_pipeline_get (metrics, &values[0], &values[1], &values[2],
+        &values[3]);
+
+    for (i = 0; i < G_N_ELEMENTS (counters); i++) {
+      g_string_append_printf (series[i], "%s{pipeline=\"", counters[i].name);
+      gstd_metrics_append_escaped (series[i], GSTD_OBJECT_NAME (pipeline));
+      g_string_append_printf (series[i], "\"} %" G_GUINT64_FORMAT "\n",
+          values[i]);
+    }
+  }
+
+  g_list_free_full (pipelines, gst_object_unref);
+
+  for (i = 0; i < G_N_ELEMENTS (counters); i++) {
+    g_string_append_printf (out, "# HELP %s %s\n# TYPE %s counter\n",
+        counters[i].name, counters[i].help, counters[i].name);
+    g_string_append_len (out, series[i]->str, series[i]->len);
+    g_string_free (series[i], TRUE);
+  }
+}
+
+void
+gstd_metrics_format (GString * out, GstdList * pipelines)
+{
+  g_return_if_fail (out);
+
+  gstd_metrics_format_commands (out);
+  gstd_metrics_format_pools (out);
+  gstd_metrics_format_list_lock (out);
+
+  if (pipelines) {
+    gstd_metrics_format_pipelines (out, pipelines);
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_METRICS_H__
+#define __GSTD_METRICS_H__
+
+#include <gst/gst.h>
+
+#include "gstd_list.h"
+#include "gstd_pipeline_bus.h"
+#include "gstd_return_codes.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Daemon metrics, exported in the Prometheus text format by the HTTP
+ * /metrics resource. Every counter is updated with atomic operations
+ * and nothing is locked on the command path, a scrape just reads them
+ * as they are.
+ */
+
+/**
+ * GstdMetricsIpc:
+ * @GSTD_METRICS_IPC_API: Commands run directly through libgstd
+ * @GSTD_METRICS_IPC_TCP: Commands received by the TCP IPC
+ * @GSTD_METRICS_IPC_UNIX: Commands received by the Unix IPC
+ * @GSTD_METRICS_IPC_HTTP: Requests received by the HTTP IPC
+ *
+ * The IPC label of the commands run by a thread.
+ */
+typedef enum
+{
+  GSTD_METRICS_IPC_API,
+  GSTD_METRICS_IPC_TCP,
+  GSTD_METRICS_IPC_UNIX,
+  GSTD_METRICS_IPC_HTTP,
+  GSTD_METRICS_IPC_COUNT
+} GstdMetricsIpc;
+
+/**
+ * gstd_metrics_ipc_get_name:
+ * @ipc: An IPC label
+ *
+ * Returns: (transfer none): The static name of @ipc, as exported.
+ */
+const gchar *gstd_metrics_ipc_get_name (GstdMetricsIpc ipc);
+
+/* As many commands as slots in the parser table */
+#define GSTD_METRICS_MAX_COMMANDS 128
+
+/**
+ * gstd_metrics_set_thread_ipc:
+ * @ipc: The IPC the calling thread runs commands for
+ *
+ * Labels the commands the calling thread runs from now on.
+ */
+void gstd_metrics_set_thread_ipc (GstdMetricsIpc ipc);
+
+/**
+ * gstd_metrics_observe_command:
+ * @slot: The slot of the command in the parser table
+ * @name: (transfer none): The name of the command, static
+ * @ret: What the command returned
+ * @elapsed: How long it took to run, in nanoseconds
+ *
+ * Counts a command run by the calling thread. Parked reads are
+ * counted up to the point they are parked.
+ */
+void gstd_metrics_observe_command (guint slot, const gchar * name,
+    GstdReturnCode ret, GstClockTime elapsed);
+
+/**
+ * gstd_metrics_observe_list_lock:
+ * @waited: How long the lock of a #GstdList took, zero if it was free
+ */
+void gstd_metrics_observe_list_lock (GstClockTime waited);
+
+/**
+ * gstd_metrics_add_pool:
+ * @name: (transfer none): The label of the pool, static
+ * @pool: A pool whose queue depth to export
+ *
+ * Exports @pool until gstd_metrics_remove_pool() is called.
+ */
+void gstd_metrics_add_pool (const gchar * name, GThreadPool * pool);
+void gstd_metrics_remove_pool (GThreadPool * pool);
+
+/**
+ * GstdMetricsPipeline:
+ * The counters of a pipeline, kept up to date from its bus.
+ */
+typedef struct _GstdMetricsPipeline GstdMetricsPipeline;
+
+GstdMetricsPipeline *gstd_metrics_pipeline_new (void);
+GstdMetricsPipeline *gstd_metrics_pipeline_ref (GstdMetricsPipeline * self);
+void gstd_metrics_pipeline_unref (GstdMetricsPipeline * self);
+
+/**
+ * gstd_metrics_pipeline_track:
+ * @self: The counters of @pipeline
+ * @pipeline: The top-level bin
+ * @bus: The bus of @pipeline
+ *
+ * Counts the state changes of @pipeline, the errors and the buffers
+ * processed and dropped reported in QoS messages, summed up over the
+ * elements posting them.
+ */
+void gstd_metrics_pipeline_track (GstdMetricsPipeline * self,
+    GstElement * pipeline, GstdPipelineBus * bus);
+
+/**
+ * gstd_metrics_pipeline_get:
+ * @self: The counters of a pipeline
+ * @transitions: (out) (optional): State changes of the top-level bin
+ * @errors: (out) (optional): Error messages
+ * @processed: (out) (optional): Buffers processed according to QoS
+ * @dropped: (out) (optional): Buffers dropped according to QoS
+ */
+void gstd_metrics_pipeline_get (GstdMetricsPipeline * self,
+    guint64 * transitions, guint64 * errors, guint64 * processed,
+    guint64 * dropped);
+
+/**
+ * gstd_metrics_format:
+ * @out: The string to append to
+ * @pipelines: (nullable): The pipeline list whose counters to export
+ *
+ * Appends every metric in the Prometheus text exposition format.
+ */
+void gstd_metrics_format (GString * out, GstdList * pipelines);
+
+G_END_DECLS
+#endif // __GSTD_METRICS_H__
@@ -116,7 +116,6 @@ gstd_msg_reader_read_message (GstdIReader * iface,
 {
   GstdReturnCode ret = GSTD_EOK;
   GstdPipelineBus *gstdbus;
-  GstBus *bus;
   gint64 timeout;
   gint types;
   GstMessage *msg;
@@ -127,7 +126,6 @@ gstd_msg_reader_read_message (GstdIReader * iface,
 
   gstdbus = GSTD_PIPELINE_BUS (object);
 
-  bus = gstd_pipeline_bus_get_bus (gstdbus);
   g_object_get (gstdbus, "timeout", &timeout, NULL);
   g_object_get (gstdbus, "types", &types, NULL);
 
@@ -138,19 +136,15 @@ gstd_msg_reader_read_message (GstdIReader * iface,
   if (GST_MESSAGE_UNKNOWN == types) {
     GST_INFO_OBJECT (gstdbus, "Flushing the bus for %" GST_TIME_FORMAT,
         GST_TIME_ARGS (timeout));
-    gst_bus_set_flushing (bus, TRUE);
-    g_usleep (GST_TIME_AS_USECONDS (timeout));
-    gst_bus_set_flushing (bus, FALSE);
+    gstd_pipeline_bus_flush (gstdbus, timeout);
     msg = NULL;
   } else {
-    msg = gst_bus_timed_pop_filtered (bus, timeout, types);
+    msg = gstd_pipeline_bus_pop (gstdbus, types, timeout);
   }
 
   if (msg) {
     *out = GSTD_OBJECT (gstd_bus_msg_factory_make (msg));
   }
 
-  gst_object_unref (bus);
-
   return ret;
 }
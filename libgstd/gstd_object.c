@@ -33,7 +33,7 @@
 #include "gstd_no_updater.h"
 #include "gstd_no_deleter.h"
 
-#include "gstd_json_builder.h"
+#include "gstd_json_writer.h"
 
 enum
 {
@@ -47,6 +47,13 @@ GST_DEBUG_CATEGORY_STATIC (gstd_object_debug);
 
 #define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
 
+/* Formatter type override of the current thread, if any */
+static GPrivate thread_formatter;
+
+/* Last formatter created by the current thread, handed out again once
+ * nobody else holds it */
+static GPrivate thread_idle_formatter = G_PRIVATE_INIT (g_object_unref);
+
 G_DEFINE_TYPE (GstdObject, gstd_object, GST_TYPE_OBJECT);
 
 /* VTable */
@@ -127,7 +134,7 @@ gstd_object_init (GstdObject * self)
   self->reader = g_object_new (GSTD_TYPE_NO_READER, NULL);
   self->updater = g_object_new (GSTD_TYPE_NO_UPDATER, NULL);
   self->deleter = g_object_new (GSTD_TYPE_NO_DELETER, NULL);
-  self->formatter_factory = GSTD_TYPE_JSON_BUILDER;
+  self->formatter_factory = GSTD_TYPE_JSON_WRITER;
 }
 
 void
@@ -257,8 +264,8 @@ gstd_object_delete_default (GstdObject * object, const gchar * name)
 }
 
 
-static GstdReturnCode
-gstd_object_to_string_default (GstdObject * self, gchar ** outstring)
+void
+gstd_object_format_properties (GstdObject * self, GstdIFormatter * formatter)
 {
   GParamSpec **properties;
   GValue value = G_VALUE_INIT;
@@ -266,9 +273,10 @@ gstd_object_to_string_default (GstdObject * self, gchar ** outstring)
   gchar *sflags;
   guint n, i;
   const gchar *typename;
-  GstdIFormatter *formatter = g_object_new (self->formatter_factory, NULL);
 
-  gstd_iformatter_begin_object (formatter);
+  g_return_if_fail (GSTD_IS_OBJECT (self));
+  g_return_if_fail (GSTD_IS_IFORMATTER (formatter));
+
   gstd_iformatter_set_member_name (formatter, "properties");
   gstd_iformatter_begin_array (formatter);
 
@@ -319,6 +327,61 @@ gstd_object_to_string_default (GstdObject * self, gchar ** outstring)
   g_free (properties);
 
   gstd_iformatter_end_array (formatter);
+}
+
+GstdIFormatter *
+gstd_object_new_formatter (GstdObject * self)
+{
+  GstdIFormatter *formatter;
+  GType type;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (self), NULL);
+
+  type = GPOINTER_TO_SIZE (g_private_get (&thread_formatter));
+  if (0 == type) {
+    type = self->formatter_factory;
+  }
+
+  formatter = g_private_get (&thread_idle_formatter);
+  if (formatter && G_OBJECT_TYPE (formatter) == type) {
+    /* Only the slot holds it, the previous response is done with it */
+    if (1 == g_atomic_int_get (&G_OBJECT (formatter)->ref_count)) {
+      gstd_iformatter_reset (formatter);
+      return g_object_ref (formatter);
+    }
+
+    /* Still in use by an outer serialization */
+    return g_object_new (type, NULL);
+  }
+
+  formatter = g_object_new (type, NULL);
+  g_private_replace (&thread_idle_formatter, g_object_ref (formatter));
+
+  return formatter;
+}
+
+void
+gstd_object_set_thread_formatter (GType formatter_type)
+{
+  g_return_if_fail (0 == formatter_type
+      || g_type_is_a (formatter_type, GSTD_TYPE_IFORMATTER));
+
+  g_private_set (&thread_formatter, GSIZE_TO_POINTER (formatter_type));
+}
+
+GType
+gstd_object_get_thread_formatter (void)
+{
+  return GPOINTER_TO_SIZE (g_private_get (&thread_formatter));
+}
+
+static GstdReturnCode
+gstd_object_to_string_default (GstdObject * self, gchar ** outstring)
+{
+  GstdIFormatter *formatter = gstd_object_new_formatter (self);
+
+  gstd_iformatter_begin_object (formatter);
+  gstd_object_format_properties (self, formatter);
   gstd_iformatter_end_object (formatter);
 
   gstd_iformatter_generate (formatter, outstring);
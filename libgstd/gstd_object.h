@@ -124,5 +124,46 @@ void gstd_object_set_reader (GstdObject * self, GstdIReader * reader);
 void gstd_object_set_updater (GstdObject * self, GstdIUpdater * updater);
 void gstd_object_set_deleter (GstdObject * self, GstdIDeleter * deleter);
 
+/**
+ * gstd_object_format_properties:
+ * @self: The object to describe
+ * @formatter: A formatter with an open object
+ *
+ * Writes the "properties" member describing every property of @self.
+ * Used by subclasses that extend the default serialization.
+ */
+void gstd_object_format_properties (GstdObject * self,
+    GstdIFormatter * formatter);
+
+/**
+ * gstd_object_new_formatter:
+ * @self: The object to be serialized
+ *
+ * Returns: (transfer full): A formatter of the type set for the
+ * calling thread, or of the object's formatter_factory otherwise. Each
+ * thread keeps its last formatter and hands it out again, reset, once
+ * the previous user released it.
+ */
+GstdIFormatter *gstd_object_new_formatter (GstdObject * self);
+
+/**
+ * gstd_object_set_thread_formatter:
+ * @formatter_type: A type implementing #GstdIFormatter, or 0 to go back
+ * to each object's formatter_factory
+ *
+ * Overrides the formatter used by every object serialized from the
+ * calling thread. Lets the IPCs answer one connection in a different
+ * encoding without touching the shared objects.
+ */
+void gstd_object_set_thread_formatter (GType formatter_type);
+
+/**
+ * gstd_object_get_thread_formatter:
+ *
+ * Returns: The formatter type set for the calling thread, 0 if none.
+ * Work finished from another thread carries it along with this.
+ */
+GType gstd_object_get_thread_formatter (void);
+
 G_END_DECLS
 #endif //__GSTD_OBJECT_H__
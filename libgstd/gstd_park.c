@@ -0,0 +1,553 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_park.h"
+
+#include "gstd_bus_msg.h"
+#include "gstd_pipeline_bus.h"
+#include "gstd_signal.h"
+#include "gstd_signal_reader.h"
+#include "gstd_state.h"
+
+/* Gstd Park debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_park_debug);
+#define GST_CAT_DEFAULT gstd_park_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+typedef struct _GstdParkOp GstdParkOp;
+typedef struct _GstdParkEvent GstdParkEvent;
+
+/*
+ * A parked read. One reference belongs to the waiter registered on the
+ * bus, the signal or the state and one to each source attached to the
+ * park context.
+ */
+struct _GstdParkOp
+{
+  gint refcount;
+
+  GstdObject *object;
+  GstdParkFunc func;
+  gpointer user_data;
+
+  /* The bus is flushed until the timeout instead of read */
+  gboolean flushing;
+
+  /* Waits for messages newer than a sequence number or for a state
+   * transition, the object itself is the result and the caller reads
+   * it again */
+  gboolean peeking;
+
+  /* protected by lock */
+  GMutex lock;
+  gboolean done;
+  guint id;
+  GSource *timer;
+  GSource *cancelled;
+};
+
+/* An event handed from the posting or emitting thread to the park thread */
+struct _GstdParkEvent
+{
+  GstdParkOp *op;
+  GstMessage *message;
+  GstdObject *callback;
+};
+
+static GMainContext *gstd_park_context (void);
+static GstdParkOp *gstd_park_op_ref (GstdParkOp * op);
+static void gstd_park_op_unref (gpointer data);
+static void gstd_park_complete (GstdParkOp * op, GstdObject * result);
+static void gstd_park_schedule (GstdParkOp * op, GstMessage * message,
+    GstdObject * callback);
+static gboolean gstd_park_deliver (gpointer data);
+static void gstd_park_event_free (gpointer data);
+static void gstd_park_on_message (GstdPipelineBus * bus, GstMessage * message,
+    gpointer user_data);
+static void gstd_park_on_callback (GstdObject * callback, gpointer user_data);
+static void gstd_park_on_settled (GstdState * state, gpointer user_data);
+static void gstd_park_on_posted (GstdPipelineBus * bus, GstMessage * message,
+    gpointer user_data);
+static void gstd_park_on_emitted (GstdObject * callback, gpointer user_data);
+static gboolean gstd_park_abort (gpointer data);
+static gboolean gstd_park_on_cancelled (GCancellable * cancellable,
+    gpointer data);
+static void gstd_park_arm (GstdParkOp * op, GSource ** slot, GSource * source,
+    GSourceFunc func);
+
+static gpointer
+gstd_park_loop (gpointer data)
+{
+  GMainLoop *loop = g_main_loop_new (data, FALSE);
+
+  g_main_loop_run (loop);
+  g_main_loop_unref (loop);
+
+  return NULL;
+}
+
+/*
+ * A single thread serves every timeout and completion, however many
+ * reads are parked.
+ */
+static GMainContext *
+gstd_park_context (void)
+{
+  static gsize initialized = 0;
+  static GMainContext *context = NULL;
+
+  if (g_once_init_enter (&initialized)) {
+    GST_DEBUG_CATEGORY_INIT (gstd_park_debug, "gstdpark", 0,
+        "Gstd parked reads category");
+
+    context = g_main_context_new ();
+    g_thread_unref (g_thread_new ("gstd-park", gstd_park_loop, context));
+
+    g_once_init_leave (&initialized, 1);
+  }
+
+  return context;
+}
+
+static GstdParkOp *
+gstd_park_op_ref (GstdParkOp * op)
+{
+  g_atomic_int_inc (&op->refcount);
+
+  return op;
+}
+
+static void
+gstd_park_op_unref (gpointer data)
+{
+  GstdParkOp *op = data;
+
+  if (!g_atomic_int_dec_and_test (&op->refcount)) {
+    return;
+  }
+
+  g_object_unref (op->object);
+  g_mutex_clear (&op->lock);
+  g_free (op);
+}
+
+/* Runs in the park thread, only the first result is delivered */
+static void
+gstd_park_complete (GstdParkOp * op, GstdObject * result)
+{
+  GSource *timer;
+  GSource *cancelled;
+
+  g_mutex_lock (&op->lock);
+  if (op->done) {
+    g_mutex_unlock (&op->lock);
+    g_clear_object (&result);
+    return;
+  }
+  op->done = TRUE;
+  timer = op->timer;
+  cancelled = op->cancelled;
+  op->timer = op->cancelled = NULL;
+  g_mutex_unlock (&op->lock);
+
+  if (timer) {
+    g_source_destroy (timer);
+    g_source_unref (timer);
+  }
+  if (cancelled) {
+    g_source_destroy (cancelled);
+    g_source_unref (cancelled);
+  }
+
+  op->func (result, op->user_data);
+}
+
+static void
+gstd_park_event_free (gpointer data)
+{
+  GstdParkEvent *event = data;
+
+  if (event->message) {
+    gst_message_unref (event->message);
+  }
+  g_clear_object (&event->callback);
+  gstd_park_op_unref (event->op);
+  g_free (event);
+}
+
+static gboolean
+gstd_park_deliver (gpointer data)
+{
+  GstdParkEvent *event = data;
+  GstdObject *result = event->callback;
+
+  event->callback = NULL;
+  if (event->message) {
+    result = GSTD_OBJECT (gstd_bus_msg_factory_make (event->message));
+    event->message = NULL;
+  }
+
+  gstd_park_complete (event->op, result);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Takes over the waiter reference of @op */
+static void
+gstd_park_schedule (GstdParkOp * op, GstMessage * message,
+    GstdObject * callback)
+{
+  GstdParkEvent *event = g_new0 (GstdParkEvent, 1);
+
+  event->op = op;
+  event->message = message;
+  event->callback = callback;
+
+  g_main_context_invoke_full (gstd_park_context (), G_PRIORITY_DEFAULT,
+      gstd_park_deliver, event, gstd_park_event_free);
+}
+
+/* Runs with the bus locked, so just hand the message over */
+static void
+gstd_park_on_message (GstdPipelineBus * bus, GstMessage * message,
+    gpointer user_data)
+{
+  gstd_park_schedule (user_data, message ? gst_message_ref (message) : NULL,
+      NULL);
+}
+
+static void
+gstd_park_on_callback (GstdObject * callback, gpointer user_data)
+{
+  gstd_park_schedule (user_data, NULL, callback);
+}
+
+static void
+gstd_park_on_settled (GstdState * state, gpointer user_data)
+{
+  gstd_park_schedule (user_data, NULL, g_object_ref (GSTD_OBJECT (state)));
+}
+
+/*
+ * Timeout or cancellation. The waiter is withdrawn first: if it already
+ * fired, the event on its way completes the read instead. A state wait
+ * still answers with the transition record.
+ */
+static gboolean
+gstd_park_abort (gpointer data)
+{
+  GstdParkOp *op = data;
+  gboolean withdrawn;
+  guint id;
+
+  g_mutex_lock (&op->lock);
+  id = op->id;
+  g_mutex_unlock (&op->lock);
+
+  if (op->flushing) {
+    gstd_pipeline_bus_flush (GSTD_PIPELINE_BUS (op->object), 0);
+    withdrawn = FALSE;
+    gstd_park_complete (op, NULL);
+  } else if (GSTD_IS_STATE (op->object)) {
+    withdrawn = gstd_state_wait_cancel (GSTD_STATE (op->object), id);
+  } else if (op->peeking && GSTD_IS_PIPELINE_BUS (op->object)) {
+    withdrawn =
+        gstd_pipeline_bus_read_since_cancel (GSTD_PIPELINE_BUS (op->object),
+        id);
+  } else if (op->peeking) {
+    withdrawn = gstd_signal_reader_read_since_cancel (op->object->reader, id);
+  } else if (GSTD_IS_PIPELINE_BUS (op->object)) {
+    withdrawn = gstd_pipeline_bus_pop_cancel (GSTD_PIPELINE_BUS (op->object),
+        id);
+  } else {
+    withdrawn = gstd_signal_reader_cancel (op->object->reader, id);
+  }
+
+  if (withdrawn) {
+    GST_DEBUG ("parked read %u of %s ended without event", id,
+        GSTD_OBJECT_NAME (op->object));
+    gstd_park_complete (op, op->peeking ? g_object_ref (op->object) : NULL);
+    gstd_park_op_unref (op);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gstd_park_on_posted (GstdPipelineBus * bus, GstMessage * message,
+    gpointer user_data)
+{
+  gstd_park_schedule (user_data, NULL, g_object_ref (GSTD_OBJECT (bus)));
+}
+
+/* The emission is read again along with the others */
+static void
+gstd_park_on_emitted (GstdObject * callback, gpointer user_data)
+{
+  GstdParkOp *op = user_data;
+
+  g_clear_object (&callback);
+  gstd_park_schedule (op, NULL, g_object_ref (op->object));
+}
+
+static gboolean
+gstd_park_on_cancelled (GCancellable * cancellable, gpointer data)
+{
+  return gstd_park_abort (data);
+}
+
+/* Attaches @source to the park context unless the read is over */
+static void
+gstd_park_arm (GstdParkOp * op, GSource ** slot, GSource * source,
+    GSourceFunc func)
+{
+  g_source_set_callback (source, func, gstd_park_op_ref (op),
+      gstd_park_op_unref);
+
+  g_mutex_lock (&op->lock);
+  if (!op->done) {
+    *slot = g_source_ref (source);
+    g_source_attach (source, gstd_park_context ());
+  }
+  g_mutex_unlock (&op->lock);
+
+  g_source_unref (source);
+}
+
+static GstdParkOp *
+gstd_park_op_new (GstdObject * object, GstdParkFunc func, gpointer user_data)
+{
+  GstdParkOp *op;
+
+  /* Also brings the debug category up */
+  gstd_park_context ();
+
+  op = g_new0 (GstdParkOp, 1);
+  op->refcount = 1;
+  op->object = g_object_ref (object);
+  op->func = func;
+  op->user_data = user_data;
+  g_mutex_init (&op->lock);
+
+  return op;
+}
+
+/* Arms the timeout, in ms or -1 for none, and the cancellation of the
+ * waiter @id */
+static void
+gstd_park_op_start (GstdParkOp * op, guint id, gint interval,
+    GCancellable * cancellable)
+{
+  g_mutex_lock (&op->lock);
+  op->id = id;
+  g_mutex_unlock (&op->lock);
+
+  if (interval >= 0) {
+    gstd_park_arm (op, &op->timer, g_timeout_source_new (interval),
+        gstd_park_abort);
+  }
+  if (cancellable) {
+    gstd_park_arm (op, &op->cancelled, g_cancellable_source_new (cancellable),
+        (GSourceFunc) gstd_park_on_cancelled);
+  }
+
+  gstd_park_op_unref (op);
+}
+
+gboolean
+gstd_park_is_blocking (GstdObject * object, const gchar * name)
+{
+  g_return_val_if_fail (GSTD_IS_OBJECT (object), FALSE);
+  g_return_val_if_fail (name, FALSE);
+
+  return (GSTD_IS_PIPELINE_BUS (object) && !g_strcmp0 (name, "message")) ||
+      (GSTD_IS_SIGNAL (object) && !g_strcmp0 (name, "callback")) ||
+      (GSTD_IS_STATE (object) && !g_strcmp0 (name, "wait"));
+}
+
+gboolean
+gstd_park_read (GstdObject * object, GCancellable * cancellable,
+    GstdParkFunc func, gpointer user_data, GstdObject ** out)
+{
+  GstdParkOp *op;
+  GstMessage *message = NULL;
+  const gchar *name;
+  gint64 timeout;
+  gint types = GST_MESSAGE_ANY;
+  gint interval;
+  guint id = 0;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (object) ||
+      GSTD_IS_SIGNAL (object), TRUE);
+  g_return_val_if_fail (func, TRUE);
+  g_return_val_if_fail (out, TRUE);
+
+  *out = NULL;
+
+  /* Signal timeouts are in microseconds, bus timeouts in nanoseconds */
+  g_object_get (object, "timeout", &timeout, NULL);
+  if (GSTD_IS_PIPELINE_BUS (object)) {
+    name = "message";
+    g_object_get (object, "types", &types, NULL);
+    interval = timeout > 0 ? GST_TIME_AS_MSECONDS (timeout) : -1;
+  } else {
+    name = "callback";
+    interval = timeout > 0 ? timeout / 1000 : -1;
+  }
+
+  /* Nothing to wait for */
+  if (0 == timeout) {
+    gstd_object_read (object, name, out);
+    return TRUE;
+  }
+
+  op = gstd_park_op_new (object, func, user_data);
+
+  if (GSTD_IS_PIPELINE_BUS (object) && GST_MESSAGE_UNKNOWN == types) {
+    /* A flush, see gstd_msg_reader_read_message() */
+    op->flushing = TRUE;
+    gstd_pipeline_bus_flush (GSTD_PIPELINE_BUS (object), 0);
+    if (timeout < 0) {
+      gstd_park_op_unref (op);
+      return TRUE;
+    }
+  } else if (GSTD_IS_PIPELINE_BUS (object)) {
+    gstd_park_op_ref (op);
+    message = gstd_pipeline_bus_pop_async (GSTD_PIPELINE_BUS (object), types,
+        gstd_park_on_message, op, &id);
+
+    /* Already there, or the pipeline is gone */
+    if (message || 0 == id) {
+      gstd_park_op_unref (op);
+      gstd_park_op_unref (op);
+      if (message) {
+        *out = GSTD_OBJECT (gstd_bus_msg_factory_make (message));
+      }
+      return TRUE;
+    }
+  } else {
+    GstdObject *callback;
+
+    gstd_park_op_ref (op);
+    callback = gstd_signal_reader_read_async (object->reader, object,
+        gstd_park_on_callback, op, &id);
+
+    /* An emission was already pending */
+    if (callback) {
+      gstd_park_op_unref (op);
+      gstd_park_op_unref (op);
+      *out = callback;
+      return TRUE;
+    }
+  }
+
+  GST_DEBUG_OBJECT (object, "parked read %u of %s", id, name);
+
+  gstd_park_op_start (op, id, interval, cancellable);
+
+  return FALSE;
+}
+
+gboolean
+gstd_park_read_since (GstdObject * object, guint64 since, gint types,
+    gint64 timeout, GCancellable * cancellable, GstdParkFunc func,
+    gpointer user_data)
+{
+  GstdParkOp *op;
+  guint id;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (object) ||
+      GSTD_IS_SIGNAL (object), TRUE);
+  g_return_val_if_fail (func, TRUE);
+
+  /* Nothing to wait for */
+  if (0 == timeout) {
+    return TRUE;
+  }
+
+  op = gstd_park_op_new (object, func, user_data);
+  op->peeking = TRUE;
+
+  gstd_park_op_ref (op);
+  if (GSTD_IS_PIPELINE_BUS (object)) {
+    id = gstd_pipeline_bus_read_since_async (GSTD_PIPELINE_BUS (object),
+        since, types, gstd_park_on_posted, op);
+  } else {
+    id = gstd_signal_reader_read_since_async (object->reader, object, since,
+        gstd_park_on_emitted, op);
+  }
+
+  /* Already there, or the source is gone */
+  if (0 == id) {
+    gstd_park_op_unref (op);
+    gstd_park_op_unref (op);
+    return TRUE;
+  }
+
+  GST_DEBUG_OBJECT (object, "parked read %u of %s since %" G_GUINT64_FORMAT,
+      id, GSTD_OBJECT_NAME (object), since);
+
+  gstd_park_op_start (op, id,
+      timeout > 0 ? GST_TIME_AS_MSECONDS (timeout) : -1, cancellable);
+
+  return FALSE;
+}
+
+gboolean
+gstd_park_wait (GstdState * state, guint64 transition, gint64 timeout,
+    GCancellable * cancellable, GstdParkFunc func, gpointer user_data)
+{
+  GstdParkOp *op;
+  guint id;
+
+  g_return_val_if_fail (GSTD_IS_STATE (state), TRUE);
+  g_return_val_if_fail (func, TRUE);
+
+  /* Nothing to wait for */
+  if (0 == timeout) {
+    return TRUE;
+  }
+
+  op = gstd_park_op_new (GSTD_OBJECT (state), func, user_data);
+  op->peeking = TRUE;
+
+  gstd_park_op_ref (op);
+  id = gstd_state_wait_async (state, transition, gstd_park_on_settled, op);
+
+  /* Already over */
+  if (0 == id) {
+    gstd_park_op_unref (op);
+    gstd_park_op_unref (op);
+    return TRUE;
+  }
+
+  GST_DEBUG_OBJECT (state, "parked wait %u of transition %" G_GUINT64_FORMAT,
+      id, transition);
+
+  gstd_park_op_start (op, id,
+      timeout > 0 ? GST_TIME_AS_MSECONDS (timeout) : -1, cancellable);
+
+  return FALSE;
+}
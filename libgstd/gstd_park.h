@@ -0,0 +1,121 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_PARK_H__
+#define __GSTD_PARK_H__
+
+#include <gio/gio.h>
+
+#include "gstd_object.h"
+#include "gstd_state.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GstdParkFunc:
+ * @result: (transfer full) (nullable): The object read, NULL if none
+ * arrived before the timeout, the read was cancelled or its source is
+ * gone. A state wait always gets the state, with its transition
+ * record, and gstd_park_read_since() the object it was given
+ * @user_data: The data given to gstd_park_read()
+ *
+ * Completes a parked read. Always runs in the single park thread,
+ * which also serves every timeout, so it should not block.
+ */
+typedef void (*GstdParkFunc) (GstdObject * result, gpointer user_data);
+
+/**
+ * gstd_park_is_blocking:
+ * @object: The object owning @name
+ * @name: The resource to be read
+ *
+ * Returns: TRUE if reading @name may block waiting for an event: the
+ * "message" of a pipeline bus, the "callback" of a signal or the
+ * "wait" of a pipeline state.
+ */
+gboolean gstd_park_is_blocking (GstdObject * object, const gchar * name);
+
+/**
+ * gstd_park_read:
+ * @object: A #GstdPipelineBus or a #GstdSignal
+ * @cancellable: (nullable): Ends the read early, @func is still called
+ * @func: Called once with the result, unless it is available right away
+ * @user_data: Data to pass to @func
+ * @out: (out) (transfer full) (nullable): The result, if available
+ * right away
+ *
+ * Reads the "message" of a bus or the "callback" of a signal the way
+ * gstd_object_read() would, honoring their timeout, but without holding
+ * the calling thread while waiting. The read is parked on the bus or
+ * the signal instead, and continued when the event arrives.
+ *
+ * Returns: TRUE if the read completed right away and @out is set,
+ * FALSE if it was parked and @func will be called.
+ */
+gboolean gstd_park_read (GstdObject * object, GCancellable * cancellable,
+    GstdParkFunc func, gpointer user_data, GstdObject ** out);
+
+/**
+ * gstd_park_read_since:
+ * @object: A #GstdPipelineBus or a #GstdSignal
+ * @since: The sequence number of the last message or emission seen
+ * @types: The #GstMessageType mask of the messages of interest, unused
+ * for a signal
+ * @timeout: Nanoseconds to wait, -1 to wait forever
+ * @cancellable: (nullable): Ends the wait early, @func is still called
+ * @func: Called once with @object when there is something to read
+ * @user_data: Data to pass to @func
+ *
+ * Parks the wait of gstd_pipeline_bus_read_since() or
+ * gstd_signal_reader_read_since() instead of holding the calling
+ * thread. @func gets @object once a message or an emission newer than
+ * @since arrives, the timeout expires or the wait is cancelled, and
+ * they are then read with no timeout.
+ *
+ * Returns: TRUE if there is no need to wait, FALSE if the wait was
+ * parked and @func will be called.
+ */
+gboolean gstd_park_read_since (GstdObject * object, guint64 since,
+    gint types, gint64 timeout, GCancellable * cancellable,
+    GstdParkFunc func, gpointer user_data);
+
+/**
+ * gstd_park_wait:
+ * @state: The #GstdState of the pipeline
+ * @transition: The transition to wait for, 0 for the latest one
+ * @timeout: Nanoseconds to wait, -1 to wait forever
+ * @cancellable: (nullable): Ends the wait early, @func is still called
+ * @func: Called once with @state when the transition is over
+ * @user_data: Data to pass to @func
+ *
+ * Parks the wait of gstd_state_wait() instead of holding the calling
+ * thread. @func gets @state once @transition is over, the timeout
+ * expires or the wait is cancelled, and the outcome is then read with
+ * no timeout.
+ *
+ * Returns: TRUE if there is no need to wait, FALSE if the wait was
+ * parked and @func will be called.
+ */
+gboolean gstd_park_wait (GstdState * state, guint64 transition,
+    gint64 timeout, GCancellable * cancellable, GstdParkFunc func,
+    gpointer user_data);
+
+G_END_DECLS
+#endif // __GSTD_PARK_H__
@@ -22,261 +22,611 @@
 #include "config.h"
 #endif
 
+#include <stdarg.h>
+#include <string.h>
+
 #include "gstd_event_handler.h"
+#include "gstd_metrics.h"
+#include "gstd_park.h"
 #include "gstd_pipeline.h"
+#include "gstd_pipeline_bus.h"
 #include "gstd_session.h"
+#include "gstd_signal.h"
+#include "gstd_signal_reader.h"
 #include "gstd_state.h"
 
 #include "gstd_parser.h"
 
+/* Most commands take at most 4 arguments, the last one holds the rest */
+#define GSTD_PARSER_MAX_TOKENS 4
+
+/* URIs and names shorter than this are built on the stack */
+#define GSTD_PARSER_BUFFER_SIZE 512
+
+/* See gstd_parser_hash() and common/gstd-parser-hash.py */
+#define GSTD_PARSER_HASH_BITS 7
+#define GSTD_PARSER_HASH_MULT 44131
+
 #define check_argument(arg, code) \
     if (NULL == (arg)) return (code)
 
+/**
+ * GstdParserToken:
+ * A view into the command string. The token is NUL terminated only
+ * if it is the last one in the command.
+ */
+typedef struct _GstdParserToken
+{
+  const gchar *str;
+  gint len;
+} GstdParserToken;
+
+/**
+ * GstdParserBatch:
+ * A batch run by the current thread. Operations resolve the parent of
+ * their URI through @parents, so a run of element_set on the same
+ * element walks the tree once.
+ */
+typedef struct _GstdParserBatch
+{
+  GHashTable *parents;
+  guint generation;
+} GstdParserBatch;
+
+/* The batch being run by this thread, if any */
+static GPrivate batch_scope;
+
+/**
+ * GstdParserPark:
+ * A command run by gstd_parser_parse_cmd_async(). Blocking reads
+ * found while running it are parked with these, and @parked set.
+ */
+typedef struct _GstdParserPark
+{
+  GCancellable *cancellable;
+  GstdParserFunc func;
+  gpointer user_data;
+  GType formatter;
+  gboolean parked;
+} GstdParserPark;
+
+/**
+ * GstdParserParked:
+ * A read waiting in the park thread for its object.
+ */
+typedef struct _GstdParserParked
+{
+  GstdParserFunc func;
+  gpointer user_data;
+  GType formatter;
+} GstdParserParked;
+
+/**
+ * GstdParserParkedSince:
+ * A read_since waiting in the park thread for newer entries.
+ */
+typedef struct _GstdParserParkedSince
+{
+  GstdParserParked parked;
+  guint64 since;
+  gint types;
+  guint max;
+} GstdParserParkedSince;
+
+/**
+ * GstdParserParkedWait:
+ * A pipeline_wait waiting in the park thread for its transition.
+ */
+typedef struct _GstdParserParkedWait
+{
+  GstdParserParked parked;
+  guint64 transition;
+} GstdParserParkedWait;
+
+/* The asynchronous command being run by this thread, if any */
+static GPrivate park_scope;
+
 /**
  * Prototypes for the functions
  */
 static GstdReturnCode gstd_parser_create (GstdSession * session,
-    GstdObject * obj, gchar * args, gchar ** response);
+    const gchar * uri, const gchar * name, const gchar * description,
+    gchar ** response);
 static GstdReturnCode gstd_parser_read (GstdSession * session,
-    GstdObject * obj, gchar * args, gchar ** reponse);
+    const gchar * uri, gchar ** response);
 static GstdReturnCode gstd_parser_update (GstdSession * session,
-    GstdObject * obj, gchar * args, gchar ** response);
+    const gchar * uri, const gchar * value, gchar ** response);
 static GstdReturnCode gstd_parser_delete (GstdSession * session,
-    GstdObject * obj, gchar * args, gchar ** response);
-static GstdReturnCode gstd_parser_parse_raw_cmd (GstdSession * session,
-    gchar * action, gchar * args, gchar ** response);
-static GstdReturnCode gstd_parser_pipeline_create (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_delete (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_play (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_pause (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_stop (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_graph (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_verbose (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_element_set (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_element_get (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_list_pipelines (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_list_elements (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_list_properties (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_list_signals (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_bus_read (GstdSession *, gchar *, gchar *,
+    const gchar * uri, const gchar * name, gboolean wait, gchar ** response);
+static GstdReturnCode gstd_parser_raw_create (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_raw_read (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_raw_update (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_raw_delete (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_bus_filter (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_pipeline_create (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_create_from (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_template_create (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_template_delete (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_list_templates (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_standby_create (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_standby_delete (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_list_standby (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_delete (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_play (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_pause (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_stop (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_graph (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_verbose (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_wait (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_element_set (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_bus_timeout (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_element_get (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_event_eos (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_list_pipelines (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_list_elements (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_list_properties (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_list_signals (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_bus_read (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_event_seek (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_bus_filter (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_event_flush_start (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_event_flush_stop (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_signal_connect (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_signal_timeout (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_signal_disconnect (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_action_emit (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_debug_enable (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_bus_timeout (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_debug_threshold (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_debug_color (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_bus_read_since (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_event_eos (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_debug_reset (GstdSession *, gchar *, gchar *,
+static GstdReturnCode gstd_parser_event_seek (GstdSession *, const gchar *,
     gchar **);
-static GstdReturnCode gstd_parser_pipeline_create_ref (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_delete_ref (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_play_ref (GstdSession *, gchar *,
-    gchar *, gchar **);
-static GstdReturnCode gstd_parser_pipeline_stop_ref (GstdSession *, gchar *,
-    gchar *, gchar **);
-
-typedef GstdReturnCode GstdFunc (GstdSession *, gchar *, gchar *, gchar **);
+static GstdReturnCode gstd_parser_event_flush_start (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_event_flush_stop (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_connect (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_timeout (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_disconnect (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_signal_read_since (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_action_emit (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_debug_enable (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_debug_threshold (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_debug_color (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_debug_reset (GstdSession *, const gchar *,
+    gchar **);
+static GstdReturnCode gstd_parser_pipeline_create_ref (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_delete_ref (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_play_ref (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_pipeline_stop_ref (GstdSession *,
+    const gchar *, gchar **);
+static GstdReturnCode gstd_parser_batch (GstdSession *, const gchar *,
+    gchar **);
+
+typedef GstdReturnCode GstdFunc (GstdSession *, const gchar *, gchar **);
 typedef struct _GstdCmd
 {
   const gchar *cmd;
   GstdFunc *callback;
 } GstdCmd;
 
-static GstdCmd cmds[] = {
-  {"create", gstd_parser_parse_raw_cmd},
-  {"read", gstd_parser_parse_raw_cmd},
-  {"update", gstd_parser_parse_raw_cmd},
-  {"delete", gstd_parser_parse_raw_cmd},
-
-  {"pipeline_create", gstd_parser_pipeline_create},
-  {"pipeline_delete", gstd_parser_pipeline_delete},
-  {"pipeline_play", gstd_parser_pipeline_play},
-  {"pipeline_pause", gstd_parser_pipeline_pause},
-  {"pipeline_stop", gstd_parser_pipeline_stop},
-  {"pipeline_get_graph", gstd_parser_pipeline_graph},
-  {"pipeline_verbose", gstd_parser_pipeline_verbose},
-
-  {"element_set", gstd_parser_element_set},
-  {"element_get", gstd_parser_element_get},
-
-  {"list_pipelines", gstd_parser_list_pipelines},
-  {"list_elements", gstd_parser_list_elements},
-  {"list_properties", gstd_parser_list_properties},
-  {"list_signals", gstd_parser_list_signals},
-
-  {"bus_read", gstd_parser_bus_read},
-  {"bus_filter", gstd_parser_bus_filter},
-  {"bus_timeout", gstd_parser_bus_timeout},
-
-  {"event_eos", gstd_parser_event_eos},
-  {"event_seek", gstd_parser_event_seek},
-  {"event_flush_start", gstd_parser_event_flush_start},
-  {"event_flush_stop", gstd_parser_event_flush_stop},
-
-  {"signal_connect", gstd_parser_signal_connect},
-  {"signal_timeout", gstd_parser_signal_timeout},
-  {"signal_disconnect", gstd_parser_signal_disconnect},
-
-  {"action_emit", gstd_parser_action_emit},
-
-  {"debug_enable", gstd_parser_debug_enable},
-  {"debug_threshold", gstd_parser_debug_threshold},
-  {"debug_color", gstd_parser_debug_color},
-  {"debug_reset", gstd_parser_debug_reset},
-
-  {"pipeline_create_ref", gstd_parser_pipeline_create_ref},
-  {"pipeline_delete_ref", gstd_parser_pipeline_delete_ref},
-  {"pipeline_play_ref", gstd_parser_pipeline_play_ref},
-  {"pipeline_stop_ref", gstd_parser_pipeline_stop_ref},
-
-  {NULL}
+/*
+ * Commands are placed at the slot given by gstd_parser_hash(), so
+ * dispatch is a single string comparison. The slot indices are
+ * generated, run common/gstd-parser-hash.py after editing this table.
+ */
+static const GstdCmd cmds[1 << GSTD_PARSER_HASH_BITS] = {
+  [20] = {"create", gstd_parser_raw_create},
+  [93] = {"read", gstd_parser_raw_read},
+  [16] = {"update", gstd_parser_raw_update},
+  [59] = {"delete", gstd_parser_raw_delete},
+
+  [17] = {"pipeline_create", gstd_parser_pipeline_create},
+  [57] = {"pipeline_delete", gstd_parser_pipeline_delete},
+  [66] = {"pipeline_play", gstd_parser_pipeline_play},
+  [101] = {"pipeline_pause", gstd_parser_pipeline_pause},
+  [65] = {"pipeline_stop", gstd_parser_pipeline_stop},
+  [73] = {"pipeline_get_graph", gstd_parser_pipeline_graph},
+  [11] = {"pipeline_verbose", gstd_parser_pipeline_verbose},
+  [49] = {"pipeline_wait", gstd_parser_pipeline_wait},
+
+  [36] = {"element_set", gstd_parser_element_set},
+  [107] = {"element_get", gstd_parser_element_get},
+
+  [67] = {"list_pipelines", gstd_parser_list_pipelines},
+  [38] = {"list_elements", gstd_parser_list_elements},
+  [76] = {"list_properties", gstd_parser_list_properties},
+  [27] = {"list_signals", gstd_parser_list_signals},
+
+  [99] = {"bus_read", gstd_parser_bus_read},
+  [24] = {"bus_filter", gstd_parser_bus_filter},
+  [127] = {"bus_timeout", gstd_parser_bus_timeout},
+  [62] = {"bus_read_since", gstd_parser_bus_read_since},
+
+  [44] = {"event_eos", gstd_parser_event_eos},
+  [74] = {"event_seek", gstd_parser_event_seek},
+  [112] = {"event_flush_start", gstd_parser_event_flush_start},
+  [111] = {"event_flush_stop", gstd_parser_event_flush_stop},
+
+  [30] = {"signal_connect", gstd_parser_signal_connect},
+  [81] = {"signal_timeout", gstd_parser_signal_timeout},
+  [90] = {"signal_disconnect", gstd_parser_signal_disconnect},
+  [52] = {"signal_read_since", gstd_parser_signal_read_since},
+
+  [105] = {"action_emit", gstd_parser_action_emit},
+
+  [15] = {"debug_enable", gstd_parser_debug_enable},
+  [7] = {"debug_threshold", gstd_parser_debug_threshold},
+  [123] = {"debug_color", gstd_parser_debug_color},
+  [84] = {"debug_reset", gstd_parser_debug_reset},
+
+  [70] = {"pipeline_create_ref", gstd_parser_pipeline_create_ref},
+  [82] = {"pipeline_delete_ref", gstd_parser_pipeline_delete_ref},
+  [8] = {"pipeline_play_ref", gstd_parser_pipeline_play_ref},
+  [14] = {"pipeline_stop_ref", gstd_parser_pipeline_stop_ref},
+
+  [19] = {"batch", gstd_parser_batch},
+
+  [120] = {"pipeline_create_from", gstd_parser_pipeline_create_from},
+  [23] = {"template_create", gstd_parser_template_create},
+  [63] = {"template_delete", gstd_parser_template_delete},
+  [9] = {"list_templates", gstd_parser_list_templates},
+
+  [40] = {"standby_create", gstd_parser_standby_create},
+  [79] = {"standby_delete", gstd_parser_standby_delete},
+  [106] = {"list_standby", gstd_parser_list_standby},
 };
 
-static GstdReturnCode
-gstd_parser_parse_raw_cmd (GstdSession * session, gchar * action, gchar * args,
-    gchar ** response)
+static guint
+gstd_parser_hash (const gchar * str, gint len)
 {
-  gchar **tokens = NULL;
-  gchar *uri, *rest;
-  GstdObject *node;
-  GstdReturnCode ret;
+  guint32 hash = 0;
+  gint i;
 
-  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
-  g_warn_if_fail (!*response);
+  for (i = 0; i < len; i++) {
+    hash = hash * GSTD_PARSER_HASH_MULT + g_ascii_tolower (str[i]);
+  }
 
+  return hash >> (32 - GSTD_PARSER_HASH_BITS);
+}
 
-  tokens = g_strsplit (args, " ", 2);
-  uri = tokens[0];
-  rest = tokens[1];
+/*
+ * Splits @str at single spaces into at most @max views, the same way
+ * g_strsplit (str, " ", max) would, but without copying. The last
+ * token extends to the end of @str. Returns the amount of tokens.
+ */
+static guint
+gstd_parser_tokenize (const gchar * str, GstdParserToken * tokens, guint max)
+{
+  const gchar *space;
+  guint n = 0;
 
-  // Alias the empty string to the base
-  if (!uri)
-    uri = (gchar *) "/";
+  if (NULL == str || '\0' == *str)
+    return 0;
 
-  ret = gstd_get_by_uri (session, uri, &node);
-  if (ret || NULL == node) {
-    goto out;
+  while (n < max - 1 && (space = strchr (str, ' '))) {
+    tokens[n].str = str;
+    tokens[n].len = space - str;
+    str = space + 1;
+    n++;
   }
 
-  if (!g_ascii_strcasecmp ("CREATE", action)) {
-    ret = gstd_parser_create (session, node, rest, response);
-  } else if (!g_ascii_strcasecmp ("READ", action)) {
-    ret = gstd_parser_read (session, node, rest, response);
-  } else if (!g_ascii_strcasecmp ("UPDATE", action)) {
-    ret = gstd_parser_update (session, node, rest, response);
-  } else if (!g_ascii_strcasecmp ("DELETE", action)) {
-    ret = gstd_parser_delete (session, node, rest, response);
-  } else {
-    GST_ERROR_OBJECT (session, "Unknown command \"%s\"", action);
-    ret = GSTD_BAD_COMMAND;
-  }
+  tokens[n].str = str;
+  tokens[n].len = strlen (str);
 
-  g_object_unref (node);
+  return n + 1;
+}
 
-out:
-  {
-    g_strfreev (tokens);
-    return ret;
+/*
+ * Copies @token into @buf to parse it as a value. Returns FALSE if it
+ * doesn't fit, no valid value is that long.
+ */
+static gboolean
+gstd_parser_token_copy (const GstdParserToken * token, gchar * buf,
+    gsize size)
+{
+  if ((gsize) token->len >= size)
+    return FALSE;
+
+  memcpy (buf, token->str, token->len);
+  buf[token->len] = '\0';
+
+  return TRUE;
+}
+
+/*
+ * Formats into @buf if it fits, otherwise into a newly allocated
+ * string. Release the result with gstd_parser_free_buffer().
+ */
+static gchar *
+gstd_parser_vformat (gchar * buf, gsize size, const gchar * format,
+    va_list args)
+G_GNUC_PRINTF (3, 0);
+
+static gchar *
+gstd_parser_format (gchar * buf, gsize size, const gchar * format, ...)
+G_GNUC_PRINTF (3, 4);
+
+static gchar *
+gstd_parser_vformat (gchar * buf, gsize size, const gchar * format,
+    va_list args)
+{
+  va_list copy;
+  gint len;
+  gchar *out = buf;
+
+  va_copy (copy, args);
+  len = g_vsnprintf (buf, size, format, copy);
+  va_end (copy);
+
+  if (len >= (gint) size) {
+    out = g_strdup_vprintf (format, args);
   }
+
+  return out;
+}
+
+static gchar *
+gstd_parser_format (gchar * buf, gsize size, const gchar * format, ...)
+{
+  va_list args;
+  gchar *out;
+
+  va_start (args, format);
+  out = gstd_parser_vformat (buf, size, format, args);
+  va_end (args);
+
+  return out;
+}
+
+static void
+gstd_parser_free_buffer (gchar * str, gchar * buf)
+{
+  if (str != buf)
+    g_free (str);
 }
 
 GstdReturnCode
 gstd_parser_parse_cmd (GstdSession * session, const gchar * cmd,
     gchar ** response)
 {
-  gchar **tokens = NULL;
-  gchar *action, *args;
-  GstdCmd *cb;
+  GstdParserToken tokens[2];
+  const GstdCmd *cb;
+  const gchar *args;
+  GstClockTime start;
+  GType formatter;
   GstdReturnCode ret = GSTD_BAD_COMMAND;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (cmd, GSTD_NULL_ARGUMENT);
   g_warn_if_fail (!*response);
 
-  tokens = g_strsplit (cmd, " ", 2);
-  action = tokens[0];
-  args = tokens[1];
+  if (0 == gstd_parser_tokenize (cmd, tokens, 2))
+    goto unknown;
+
+  cb = &cmds[gstd_parser_hash (tokens[0].str, tokens[0].len)];
+  if (NULL == cb->cmd
+      || g_ascii_strncasecmp (cb->cmd, tokens[0].str, tokens[0].len)
+      || '\0' != cb->cmd[tokens[0].len])
+    goto unknown;
+
+  /* Like the rest of the command line, arguments are optional */
+  args = tokens[0].str[tokens[0].len] ? tokens[1].str : NULL;
+
+  /* Respond with the session's formatter unless the IPC picked one, the
+   * shared objects are never touched */
+  formatter = gstd_object_get_thread_formatter ();
+  if (0 == formatter)
+    gstd_object_set_thread_formatter (GSTD_OBJECT (session)->
+        formatter_factory);
+
+  start = gst_util_get_timestamp ();
+  ret = cb->callback (session, args, response);
+
+  if (0 == formatter)
+    gstd_object_set_thread_formatter (0);
+
+  gstd_metrics_observe_command (cb - cmds, cb->cmd, ret,
+      gst_util_get_timestamp () - start);
+
+  return ret;
+
+unknown:
+  GST_ERROR_OBJECT (session, "Unknown command \"%s\"", cmd);
+  return ret;
+}
+
+gboolean
+gstd_parser_parse_cmd_async (GstdSession * session, const gchar * cmd,
+    GCancellable * cancellable, GstdParserFunc func, gpointer user_data,
+    GstdReturnCode * ret, gchar ** response)
+{
+  GstdParserPark park;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), TRUE);
+  g_return_val_if_fail (cmd, TRUE);
+  g_return_val_if_fail (func, TRUE);
+  g_return_val_if_fail (ret, TRUE);
+  g_return_val_if_fail (response, TRUE);
+
+  park.cancellable = cancellable;
+  park.func = func;
+  park.user_data = user_data;
+  park.formatter = gstd_object_get_thread_formatter ();
+  if (0 == park.formatter)
+    park.formatter = GSTD_OBJECT (session)->formatter_factory;
+  park.parked = FALSE;
+
+  g_private_set (&park_scope, &park);
+  *ret = gstd_parser_parse_cmd (session, cmd, response);
+  g_private_set (&park_scope, NULL);
+
+  return !park.parked;
+}
 
-  cb = cmds;
-  while (cb->cmd) {
-    if (!g_ascii_strcasecmp (cb->cmd, action)) {
-      ret = cb->callback (session, action, args, response);
+GstdReturnCode
+gstd_parser_parse_batch (GstdSession * session, const gchar * const *cmds,
+    gboolean stop_on_error, gchar ** response)
+{
+  GstdParserBatch batch;
+  GstdIFormatter *formatter;
+  GValue value = G_VALUE_INIT;
+  gchar *output;
+  GstdReturnCode ret = GSTD_EOK;
+  GstdReturnCode code;
+  guint i;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (cmds, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+  g_warn_if_fail (!*response);
+
+  if (g_private_get (&batch_scope)) {
+    GST_ERROR_OBJECT (session, "Batches can't be nested");
+    return GSTD_BAD_COMMAND;
+  }
+
+  batch.parents = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      g_object_unref);
+  batch.generation = gstd_uri_cache_get_generation (session->uri_cache);
+  g_private_set (&batch_scope, &batch);
+
+  formatter = gstd_object_new_formatter (GSTD_OBJECT (session));
+  g_value_init (&value, G_TYPE_INT);
+
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_member_name (formatter, "codes");
+  gstd_iformatter_begin_array (formatter);
+
+  for (i = 0; cmds[i]; i++) {
+    if ('\0' == cmds[i][0])
+      continue;
+
+    /* Only the codes are reported, operations don't serialize */
+    output = NULL;
+    code = gstd_parser_parse_cmd (session, cmds[i], &output);
+    g_free (output);
+
+    g_value_set_int (&value, code);
+    gstd_iformatter_set_value (formatter, &value);
+
+    if (GSTD_EOK == code)
+      continue;
+
+    /* The batch fails with its first failing operation */
+    if (GSTD_EOK == ret)
+      ret = code;
+
+    if (stop_on_error) {
+      GST_INFO_OBJECT (session, "Batch stopped at \"%s\"", cmds[i]);
       break;
     }
-    cb++;
   }
 
-  if (ret == GSTD_BAD_COMMAND)
-    GST_ERROR_OBJECT (session, "Unknown command \"%s\"", action);
-  g_strfreev (tokens);
+  gstd_iformatter_end_array (formatter);
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_generate (formatter, response);
+
+  g_private_set (&batch_scope, NULL);
+  g_hash_table_unref (batch.parents);
+  g_value_unset (&value);
+  g_object_unref (formatter);
 
   return ret;
 }
 
+/*
+ * Resolves @uri like gstd_get_by_uri(). Within a batch the parent
+ * node of @uri is resolved once and reused by the next operations,
+ * until a pipeline is added or removed.
+ */
+static GstdReturnCode
+gstd_parser_get_by_uri (GstdSession * session, const gchar * uri,
+    GstdObject ** node)
+{
+  GstdParserBatch *batch = g_private_get (&batch_scope);
+  GstdObject *parent;
+  const gchar *name;
+  gchar *prefix;
+  guint generation;
+  GstdReturnCode ret;
+
+  if (NULL == batch)
+    return gstd_get_by_uri (session, uri, node);
 
+  name = strrchr (uri, '/');
+  if (NULL == name || name == uri || '\0' == name[1])
+    return gstd_get_by_uri (session, uri, node);
+
+  generation = gstd_uri_cache_get_generation (session->uri_cache);
+  if (generation != batch->generation) {
+    g_hash_table_remove_all (batch->parents);
+    batch->generation = generation;
+  }
+
+  prefix = g_strndup (uri, name - uri);
+  parent = g_hash_table_lookup (batch->parents, prefix);
+  if (NULL == parent) {
+    ret = gstd_get_by_uri (session, prefix, &parent);
+    if (ret) {
+      g_free (prefix);
+      return ret;
+    }
+    g_hash_table_insert (batch->parents, prefix, parent);
+  } else {
+    g_free (prefix);
+  }
+
+  return gstd_object_read (parent, name + 1, node);
+}
 
 static GstdReturnCode
-gstd_parser_create (GstdSession * session, GstdObject * obj, gchar * args,
-    gchar ** response)
+gstd_parser_create (GstdSession * session, const gchar * uri,
+    const gchar * name, const gchar * description, gchar ** response)
 {
-  gchar **tokens = NULL;
-  gchar *name;
-  gchar *description;
-  GstdObject *new;
+  GstdObject *obj = NULL;
+  GstdObject *new = NULL;
   GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (G_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (uri, GSTD_NULL_ARGUMENT);
 
   // This may mean a potential leak
   g_warn_if_fail (!*response);
 
-  // Tokens has the form {<name>, <description>}
-  if (NULL == args) {
-    name = NULL;
-    description = NULL;
-  } else {
-    tokens = g_strsplit (args, " ", 2);
-    name = tokens[0];
-    description = tokens[1];
-  }
+  ret = gstd_parser_get_by_uri (session, uri, &obj);
+  if (ret || NULL == obj)
+    return ret;
 
   if (NULL == name) {
     /* No name provided, hence no desciption either, but it may contain garbage */
@@ -287,6 +637,9 @@ gstd_parser_create (GstdSession * session, GstdObject * obj, gchar * args,
   if (ret)
     goto out;
 
+  if (g_private_get (&batch_scope))
+    goto out;
+
   gstd_object_read (obj, name, &new);
   if (NULL != new) {
     gstd_object_to_string (new, response);
@@ -294,717 +647,1444 @@ gstd_parser_create (GstdSession * session, GstdObject * obj, gchar * args,
   }
 
 out:
-  {
-    if (tokens)
-      g_strfreev (tokens);
-    return ret;
+  g_object_unref (obj);
+  return ret;
+}
+
+/* Runs in the park thread, with the formatter of the parking thread */
+static void
+gstd_parser_on_parked (GstdObject * result, gpointer user_data)
+{
+  GstdParserParked *parked = user_data;
+  gchar *response = NULL;
+  GstdReturnCode ret = GSTD_EOK;
+
+  if (result) {
+    gstd_object_set_thread_formatter (parked->formatter);
+    ret = gstd_object_to_string (result, &response);
+    gstd_object_set_thread_formatter (0);
+    g_object_unref (result);
   }
+
+  parked->func (ret, response, parked->user_data);
+  g_free (parked);
 }
 
+/* Reads the messages of a bus or the emissions of a signal */
 static GstdReturnCode
-gstd_parser_read (GstdSession * session, GstdObject * obj, gchar * args,
+gstd_parser_read_since_now (GstdObject * object, guint64 since, gint types,
+    guint max, gint64 timeout, gchar ** response)
+{
+  if (GSTD_IS_PIPELINE_BUS (object))
+    return gstd_pipeline_bus_read_since (GSTD_PIPELINE_BUS (object), since,
+        types, max, timeout, response);
+
+  return gstd_signal_reader_read_since (object->reader, object, since, max,
+      timeout, response);
+}
+
+/* Runs in the park thread once there is something newer to read */
+static void
+gstd_parser_on_parked_since (GstdObject * result, gpointer user_data)
+{
+  GstdParserParkedSince *parked = user_data;
+  gchar *response = NULL;
+  GstdReturnCode ret;
+
+  gstd_object_set_thread_formatter (parked->parked.formatter);
+  ret = gstd_parser_read_since_now (result, parked->since, parked->types,
+      parked->max, 0, &response);
+  gstd_object_set_thread_formatter (0);
+  g_object_unref (result);
+
+  parked->parked.func (ret, response, parked->parked.user_data);
+  g_free (parked);
+}
+
+/*
+ * Reads the entries of @object newer than @since through
+ * gstd_park_read_since() if the command runs asynchronously. Returns
+ * FALSE if it doesn't, so it is read as usual.
+ */
+static gboolean
+gstd_parser_read_since_parked (GstdSession * session, GstdObject * object,
+    guint64 since, gint types, guint max, gint64 timeout,
+    GstdReturnCode * ret, gchar ** response)
+{
+  GstdParserPark *park = g_private_get (&park_scope);
+  GstdParserParkedSince *parked;
+
+  /* Operations in a batch are not parked, they must run in order */
+  if (NULL == park || park->parked || g_private_get (&batch_scope)
+      || 0 == timeout)
+    return FALSE;
+
+  parked = g_new0 (GstdParserParkedSince, 1);
+  parked->parked.func = park->func;
+  parked->parked.user_data = park->user_data;
+  parked->parked.formatter = park->formatter;
+  parked->since = since;
+  parked->types = types;
+  parked->max = max;
+
+  if (gstd_park_read_since (object, since, types, timeout,
+          park->cancellable, gstd_parser_on_parked_since, parked)) {
+    g_free (parked);
+    *ret = gstd_parser_read_since_now (object, since, types, max, 0,
+        response);
+  } else {
+    GST_DEBUG_OBJECT (session, "Parked read of %s since %" G_GUINT64_FORMAT,
+        GSTD_OBJECT_NAME (object), since);
+    park->parked = TRUE;
+  }
+
+  return TRUE;
+}
+
+/*
+ * Reads the outcome of @transition. The record is the response even
+ * when the transition failed, was replaced or is still in progress.
+ */
+static GstdReturnCode
+gstd_parser_wait_now (GstdState * state, guint64 transition, gint64 timeout,
     gchar ** response)
 {
+  GstdReturnCode ret;
+  GstdReturnCode printed;
+
+  ret = gstd_state_wait (state, transition, timeout);
+  if (GSTD_BAD_VALUE == ret)
+    return ret;
+
+  printed = gstd_object_to_string (GSTD_OBJECT (state), response);
+
+  return ret ? ret : printed;
+}
+
+/* Runs in the park thread once the transition is over */
+static void
+gstd_parser_on_parked_wait (GstdObject * result, gpointer user_data)
+{
+  GstdParserParkedWait *parked = user_data;
+  gchar *response = NULL;
+  GstdReturnCode ret;
+
+  gstd_object_set_thread_formatter (parked->parked.formatter);
+  ret = gstd_parser_wait_now (GSTD_STATE (result), parked->transition, 0,
+      &response);
+  gstd_object_set_thread_formatter (0);
+  g_object_unref (result);
+
+  parked->parked.func (ret, response, parked->parked.user_data);
+  g_free (parked);
+}
+
+/*
+ * Waits for @transition of @state, 0 being the latest one, through
+ * gstd_park_wait() if the command runs asynchronously.
+ */
+static GstdReturnCode
+gstd_parser_wait (GstdSession * session, GstdState * state,
+    guint64 transition, gint64 timeout, gchar ** response)
+{
+  GstdParserPark *park = g_private_get (&park_scope);
+  GstdParserParkedWait *parked;
+
+  /* Pin the latest one, a newer change must not be waited for instead */
+  if (0 == transition)
+    transition = gstd_state_get_transition (state);
+
+  /* Operations in a batch are not parked, they must run in order */
+  if (NULL == park || park->parked || g_private_get (&batch_scope)
+      || 0 == timeout)
+    return gstd_parser_wait_now (state, transition, timeout, response);
+
+  parked = g_new0 (GstdParserParkedWait, 1);
+  parked->parked.func = park->func;
+  parked->parked.user_data = park->user_data;
+  parked->parked.formatter = park->formatter;
+  parked->transition = transition;
+
+  if (gstd_park_wait (state, transition, timeout, park->cancellable,
+          gstd_parser_on_parked_wait, parked)) {
+    g_free (parked);
+    return gstd_parser_wait_now (state, transition, 0, response);
+  }
+
+  GST_DEBUG_OBJECT (session, "Parked wait of transition %" G_GUINT64_FORMAT,
+      transition);
+  park->parked = TRUE;
+
+  return GSTD_EOK;
+}
+
+/*
+ * Reads @uri through gstd_park_read() if it names a bus message or a
+ * signal callback and the command runs asynchronously, and through
+ * gstd_parser_wait() if it names a state wait. Returns FALSE if @uri is
+ * not one of those, so it is read as usual.
+ */
+static gboolean
+gstd_parser_read_parked (GstdSession * session, const gchar * uri,
+    GstdParserPark * park, GstdReturnCode * ret, gchar ** response)
+{
+  GstdParserParked *parked;
+  GstdObject *parent = NULL;
+  GstdObject *obj = NULL;
+  const gchar *name;
+  gchar *prefix;
+  gboolean parkable;
+
+  /* Operations in a batch are not parked, they must run in order */
+  parkable = park && !park->parked && !g_private_get (&batch_scope);
+
+  name = strrchr (uri, '/');
+  if (NULL == name || name == uri || (g_strcmp0 (name, "/wait")
+          && (!parkable || (g_strcmp0 (name, "/message")
+                  && g_strcmp0 (name, "/callback")))))
+    return FALSE;
+
+  prefix = g_strndup (uri, name - uri);
+  *ret = gstd_get_by_uri (session, prefix, &parent);
+  g_free (prefix);
+  if (*ret)
+    return TRUE;
+
+  name++;
+  if (GSTD_IS_STATE (parent) && !g_strcmp0 (name, "wait")) {
+    *ret = gstd_parser_wait (session, GSTD_STATE (parent), 0, -1, response);
+    g_object_unref (parent);
+    return TRUE;
+  }
+
+  if (!parkable || !gstd_park_is_blocking (parent, name)) {
+    g_object_unref (parent);
+    return FALSE;
+  }
+
+  parked = g_new0 (GstdParserParked, 1);
+  parked->func = park->func;
+  parked->user_data = park->user_data;
+  parked->formatter = park->formatter;
+
+  if (gstd_park_read (parent, park->cancellable, gstd_parser_on_parked,
+          parked, &obj)) {
+    g_free (parked);
+    if (obj) {
+      *ret = gstd_object_to_string (obj, response);
+      g_object_unref (obj);
+    }
+  } else {
+    GST_DEBUG_OBJECT (session, "Parked read of %s", uri);
+    park->parked = TRUE;
+  }
+
+  g_object_unref (parent);
+  return TRUE;
+}
+
+static GstdReturnCode
+gstd_parser_read (GstdSession * session, const gchar * uri, gchar ** response)
+{
+  GstdParserPark *park = g_private_get (&park_scope);
+  GstdObject *obj = NULL;
+  GstdReturnCode ret;
+
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (uri, GSTD_NULL_ARGUMENT);
 
   // This may mean a potential leak
   g_warn_if_fail (!*response);
 
+  if (gstd_parser_read_parked (session, uri, park, &ret, response))
+    return ret;
+
+  ret = gstd_parser_get_by_uri (session, uri, &obj);
+  if (ret || NULL == obj)
+    return ret;
+
   // Print the raw object
-  return gstd_object_to_string (obj, response);
+  ret = gstd_object_to_string (obj, response);
+  g_object_unref (obj);
+
+  return ret;
 }
 
 static GstdReturnCode
-gstd_parser_update (GstdSession * session, GstdObject * obj, gchar * args,
-    gchar ** response)
+gstd_parser_update (GstdSession * session, const gchar * uri,
+    const gchar * value, gchar ** response)
 {
+  GstdObject *obj = NULL;
   GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (uri, GSTD_NULL_ARGUMENT);
 
-  if (!args) {
+  ret = gstd_parser_get_by_uri (session, uri, &obj);
+  if (ret || NULL == obj)
+    return ret;
+
+  if (!value) {
     GST_ERROR_OBJECT (obj, "No argument provided for update");
     ret = GSTD_BAD_VALUE;
     goto out;
   }
   *response = NULL;
 
-  ret = gstd_object_update (obj, args);
+  ret = gstd_object_update (obj, value);
   if (ret) {
     goto out;
   }
 
-  /* Serialize the updated object */
-  gstd_object_to_string (obj, response);
+  /* Serialize the updated object, unless it's part of a batch */
+  if (!g_private_get (&batch_scope))
+    gstd_object_to_string (obj, response);
 out:
-  {
-    return ret;
-  }
+  g_object_unref (obj);
+  return ret;
 }
 
 static GstdReturnCode
-gstd_parser_delete (GstdSession * session, GstdObject * obj, gchar * args,
-    gchar ** response)
+gstd_parser_delete (GstdSession * session, const gchar * uri,
+    const gchar * name, gboolean wait, gchar ** response)
 {
+  GstdObject *obj = NULL;
+  GstdObject *pipeline = NULL;
+  GstdReturnCode ret;
+
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (uri, GSTD_NULL_ARGUMENT);
+
+  ret = gstd_parser_get_by_uri (session, uri, &obj);
+  if (ret || NULL == obj)
+    return ret;
 
   *response = NULL;
 
-  return gstd_object_delete (obj, args);
+  if (NULL == name) {
+    ret = GSTD_NULL_ARGUMENT;
+  } else {
+    /* Pipelines are torn down off the list lock, keep this one to wait
+     * for it out here */
+    if (wait && obj == GSTD_OBJECT (session->pipelines))
+      pipeline = gstd_list_find_child (GSTD_LIST (obj), name);
+    ret = gstd_object_delete (obj, name);
+  }
+
+  if (pipeline) {
+    if (GSTD_EOK == ret)
+      gstd_session_wait_pipeline_deleted (session, pipeline);
+    g_object_unref (pipeline);
+  }
+
+  g_object_unref (obj);
+  return ret;
 }
 
+/*
+ * Low level commands have the form <action> <uri> [args]. The URI is
+ * copied out of the command, the arguments are used in place.
+ */
+static void
+gstd_parser_raw_split (const gchar * args, gchar * buf, gsize size,
+    gchar ** uri, const gchar ** rest)
+{
+  GstdParserToken tokens[2];
+  guint n;
+
+  n = gstd_parser_tokenize (args, tokens, 2);
+
+  // Alias the empty string to the base
+  if (0 == n) {
+    *uri = gstd_parser_format (buf, size, "/");
+    *rest = NULL;
+    return;
+  }
+
+  *uri = gstd_parser_format (buf, size, "%.*s", tokens[0].len, tokens[0].str);
+  *rest = n > 1 ? tokens[1].str : NULL;
+}
 
 static GstdReturnCode
-gstd_parser_pipeline_create (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_raw_create (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar namebuf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  const gchar *rest;
   gchar *uri;
+  gchar *name = NULL;
+  const gchar *description = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  gstd_parser_raw_split (args, buf, sizeof (buf), &uri, &rest);
+
+  // Tokens has the form {<name>, <description>}
+  if (gstd_parser_tokenize (rest, tokens, 2) > 0) {
+    name = gstd_parser_format (namebuf, sizeof (namebuf), "%.*s",
+        tokens[0].len, tokens[0].str);
+    description = tokens[0].str[tokens[0].len] ? tokens[1].str : NULL;
+  }
 
-  uri = g_strdup_printf ("/pipelines %s", args ? args : "");
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
-  g_free (uri);
+  ret = gstd_parser_create (session, uri, name, description, response);
+
+  if (name)
+    gstd_parser_free_buffer (name, namebuf);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_delete (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_raw_read (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  const gchar *rest;
   gchar *uri;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines %s", args);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "delete", uri, response);
-  g_free (uri);
+  gstd_parser_raw_split (args, buf, sizeof (buf), &uri, &rest);
+  ret = gstd_parser_read (session, uri, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_play (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_raw_update (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  const gchar *rest;
   gchar *uri;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines/%s/state playing", args);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
-  g_free (uri);
+  gstd_parser_raw_split (args, buf, sizeof (buf), &uri, &rest);
+  ret = gstd_parser_update (session, uri, rest, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_pause (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_raw_delete (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  const gchar *rest;
   gchar *uri;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines/%s/state paused", args);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
-  g_free (uri);
+  gstd_parser_raw_split (args, buf, sizeof (buf), &uri, &rest);
+  ret = gstd_parser_delete (session, uri, rest, TRUE, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_stop (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_pipeline_create (GstdSession * session, const gchar * args,
     gchar ** response)
 {
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  gchar *name = NULL;
+  const gchar *description = NULL;
   GstdReturnCode ret;
-  gchar *uri;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines/%s/state null", args);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
-  g_free (uri);
+  if (gstd_parser_tokenize (args, tokens, 2) > 0) {
+    name = gstd_parser_format (buf, sizeof (buf), "%.*s", tokens[0].len,
+        tokens[0].str);
+    description = tokens[0].str[tokens[0].len] ? tokens[1].str : NULL;
+  }
+
+  ret = gstd_parser_create (session, "/pipelines", name, description,
+      response);
+
+  if (name)
+    gstd_parser_free_buffer (name, buf);
 
   return ret;
 }
 
+/*
+ * pipeline_create_from <name> <template> [parameter=value ...]: the
+ * same as pipeline_create with a "@template parameter=value ..."
+ * description
+ */
 static GstdReturnCode
-gstd_parser_pipeline_graph (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_pipeline_create_from (GstdSession * session, const gchar * args,
     gchar ** response)
 {
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar descbuf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  gchar *name = NULL;
+  gchar *description = NULL;
   GstdReturnCode ret;
-  gchar *uri;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines/%s/graph", args);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
-  g_free (uri);
+  if (gstd_parser_tokenize (args, tokens, 2) > 0) {
+    name = gstd_parser_format (buf, sizeof (buf), "%.*s", tokens[0].len,
+        tokens[0].str);
+    if (tokens[0].str[tokens[0].len])
+      description = gstd_parser_format (descbuf, sizeof (descbuf), "@%s",
+          tokens[1].str);
+  }
+
+  ret = gstd_parser_create (session, "/pipelines", name, description,
+      response);
+
+  if (description)
+    gstd_parser_free_buffer (description, descbuf);
+  if (name)
+    gstd_parser_free_buffer (name, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_verbose (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_template_create (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret = GSTD_BAD_COMMAND;
-
-#if GST_VERSION_MINOR >= 10
-  gchar *uri;
-  gchar **tokens = NULL;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  gchar *name = NULL;
+  const gchar *description = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
+  if (gstd_parser_tokenize (args, tokens, 2) > 0) {
+    name = gstd_parser_format (buf, sizeof (buf), "%.*s", tokens[0].len,
+        tokens[0].str);
+    description = tokens[0].str[tokens[0].len] ? tokens[1].str : NULL;
+  }
 
+  ret = gstd_parser_create (session, "/templates", name, description,
+      response);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  if (name)
+    gstd_parser_free_buffer (name, buf);
 
-  uri = g_strdup_printf ("/pipelines/%s/verbose %s", tokens[0], tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  return ret;
+}
 
-  g_free (uri);
-  g_strfreev (tokens);
+static GstdReturnCode
+gstd_parser_template_delete (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-#else
-  GST_ERROR_OBJECT (session, "GST v.%d.%d does not support deep notify",
-      GST_VERSION_MAJOR, GST_VERSION_MINOR);
-#endif
+  return gstd_parser_delete (session, "/templates", args, FALSE, response);
+}
 
-  return ret;
+static GstdReturnCode
+gstd_parser_list_templates (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+
+  return gstd_parser_read (session, "/templates", response);
 }
 
+/*
+ * standby_create <name> <size> <state> <description>: keeps size
+ * pipelines of the description, or "@template parameter=value ...",
+ * built and parked in state, ready or paused
+ */
 static GstdReturnCode
-gstd_parser_element_set (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_standby_create (GstdSession * session, const gchar * args,
     gchar ** response)
 {
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar descbuf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[4];
+  gchar *name = NULL;
+  gchar *description = NULL;
+  guint n;
   GstdReturnCode ret;
-  gchar *uri;
-  gchar **tokens = NULL;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 4);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-  check_argument (tokens[2], GSTD_BAD_COMMAND);
-  check_argument (tokens[3], GSTD_BAD_COMMAND);
+  n = gstd_parser_tokenize (args, tokens, 4);
+  if (n > 0) {
+    name = gstd_parser_format (buf, sizeof (buf), "%.*s", tokens[0].len,
+        tokens[0].str);
+  }
+
+  if (4 == n) {
+    description = gstd_parser_format (descbuf, sizeof (descbuf),
+        "size=%.*s state=%.*s %s", tokens[1].len, tokens[1].str,
+        tokens[2].len, tokens[2].str, tokens[3].str);
+  }
 
-  uri = g_strdup_printf ("/pipelines/%s/elements/%s/properties/%s %s",
-      tokens[0], tokens[1], tokens[2], tokens[3]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  ret = gstd_parser_create (session, "/standby", name, description,
+      response);
 
-  g_free (uri);
-  g_strfreev (tokens);
+  if (description)
+    gstd_parser_free_buffer (description, descbuf);
+  if (name)
+    gstd_parser_free_buffer (name, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_element_get (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_standby_delete (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  return gstd_parser_delete (session, "/standby", args, FALSE, response);
+}
+
+static GstdReturnCode
+gstd_parser_list_standby (GstdSession * session, const gchar * args,
     gchar ** response)
 {
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+
+  return gstd_parser_read (session, "/standby", response);
+}
+
+/*
+ * pipeline_delete <name> [async]: by default the command returns once
+ * the pipeline reached NULL. With "async" it returns as soon as it is
+ * unlinked, while it shows up as "deleting" in the pipelines status.
+ */
+static GstdReturnCode
+gstd_parser_pipeline_delete (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  gchar *name = NULL;
+  gboolean wait = TRUE;
+  guint n;
   GstdReturnCode ret;
-  gchar *uri;
-  gchar **tokens = NULL;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 3);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  n = gstd_parser_tokenize (args, tokens, 2);
+  if (2 == n) {
+    if (g_strcmp0 (tokens[1].str, "async")) {
+      GST_ERROR_OBJECT (session, "Unknown delete option \"%s\"",
+          tokens[1].str);
+      return GSTD_BAD_VALUE;
+    }
+    wait = FALSE;
+  }
+
+  if (n > 0)
+    name = gstd_parser_format (buf, sizeof (buf), "%.*s", tokens[0].len,
+        tokens[0].str);
 
-  uri = g_strdup_printf ("/pipelines/%s/elements/%s/properties/%s",
-      tokens[0], tokens[1], tokens[2]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  ret = gstd_parser_delete (session, "/pipelines", name, wait, response);
 
-  g_free (uri);
-  g_strfreev (tokens);
+  if (name)
+    gstd_parser_free_buffer (name, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_list_pipelines (GstdSession * session, gchar * action, gchar * args,
-    gchar ** response)
+gstd_parser_pipeline_set_state (GstdSession * session, const gchar * args,
+    const gchar * state, gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
   gchar *uri;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines");
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
-  g_free (uri);
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%s/state", args);
+  ret = gstd_parser_update (session, uri, state, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_list_elements (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_pipeline_play (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
+  return gstd_parser_pipeline_set_state (session, args, "playing", response);
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_pause (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_pipeline_set_state (session, args, "paused", response);
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_stop (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_pipeline_set_state (session, args, "null", response);
+}
+
+/*
+ * Reads the node at the URI built from @format
+ */
+static GstdReturnCode
+gstd_parser_read_formatted (GstdSession * session, gchar ** response,
+    const gchar * format, ...)
+G_GNUC_PRINTF (3, 4);
+
+static GstdReturnCode
+gstd_parser_read_formatted (GstdSession * session, gchar ** response,
+    const gchar * format, ...)
+{
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  va_list args;
   gchar *uri;
+  GstdReturnCode ret;
 
-  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  va_start (args, format);
+  uri = gstd_parser_vformat (buf, sizeof (buf), format, args);
+  va_end (args);
 
-  uri = g_strdup_printf ("/pipelines/%s/elements/", args);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
-  g_free (uri);
+  ret = gstd_parser_read (session, uri, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_list_properties (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_pipeline_graph (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  return gstd_parser_read_formatted (session, response, "/pipelines/%s/graph",
+      args);
+}
+
+static GstdReturnCode
+gstd_parser_pipeline_verbose (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  GstdReturnCode ret = GSTD_BAD_COMMAND;
+
+#if GST_VERSION_MINOR >= 10
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
   gchar *uri;
-  gchar **tokens = NULL;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  if (gstd_parser_tokenize (args, tokens, 2) < 2)
+    return GSTD_BAD_COMMAND;
 
-  uri =
-      g_strdup_printf ("/pipelines/%s/elements/%s/properties", tokens[0],
-      tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%.*s/verbose",
+      tokens[0].len, tokens[0].str);
+  ret = gstd_parser_update (session, uri, tokens[1].str, response);
+  gstd_parser_free_buffer (uri, buf);
 
-  g_free (uri);
-  g_strfreev (tokens);
+#else
+  GST_ERROR_OBJECT (session, "GST v.%d.%d does not support deep notify",
+      GST_VERSION_MAJOR, GST_VERSION_MINOR);
+#endif
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_list_signals (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_element_set (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[GSTD_PARSER_MAX_TOKENS];
   gchar *uri;
-  gchar **tokens = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-
-  uri =
-      g_strdup_printf ("/pipelines/%s/elements/%s/signals", tokens[0],
-      tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  if (gstd_parser_tokenize (args, tokens, 4) < 4)
+    return GSTD_BAD_COMMAND;
 
-  g_free (uri);
-  g_strfreev (tokens);
+  uri = gstd_parser_format (buf, sizeof (buf),
+      "/pipelines/%.*s/elements/%.*s/properties/%.*s", tokens[0].len,
+      tokens[0].str, tokens[1].len, tokens[1].str, tokens[2].len,
+      tokens[2].str);
+  ret = gstd_parser_update (session, uri, tokens[3].str, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_bus_read (GstdSession * session, gchar * action,
-    gchar * pipeline, gchar ** response)
+gstd_parser_element_get (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[GSTD_PARSER_MAX_TOKENS];
   gchar *uri;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
 
-  uri = g_strdup_printf ("/pipelines/%s/bus/message", pipeline);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  if (gstd_parser_tokenize (args, tokens, 3) < 3)
+    return GSTD_BAD_COMMAND;
 
-  g_free (uri);
+  uri = gstd_parser_format (buf, sizeof (buf),
+      "/pipelines/%.*s/elements/%.*s/properties/%.*s", tokens[0].len,
+      tokens[0].str, tokens[1].len, tokens[1].str, tokens[2].len,
+      tokens[2].str);
+  ret = gstd_parser_read (session, uri, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_bus_filter (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_list_pipelines (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+
+  return gstd_parser_read (session, "/pipelines", response);
+}
+
+static GstdReturnCode
+gstd_parser_list_elements (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+
+  return gstd_parser_read_formatted (session, response,
+      "/pipelines/%s/elements/", args);
+}
+
+/*
+ * Reads /pipelines/<pipeline>/elements/<element>/<resource>
+ */
+static GstdReturnCode
+gstd_parser_read_element_resource (GstdSession * session,
+    const gchar * args, const gchar * resource, gchar ** response)
+{
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
   gchar *uri;
-  gchar **tokens = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
+  if (gstd_parser_tokenize (args, tokens, 2) < 2)
+    return GSTD_BAD_COMMAND;
+
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%.*s/elements/%s/%s",
+      tokens[0].len, tokens[0].str, tokens[1].str, resource);
+  ret = gstd_parser_read (session, uri, response);
+  gstd_parser_free_buffer (uri, buf);
 
-  uri = g_strdup_printf ("/pipelines/%s/bus/types %s", tokens[0], tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  return ret;
+}
 
-  g_free (uri);
-  g_strfreev (tokens);
+static GstdReturnCode
+gstd_parser_list_properties (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_read_element_resource (session, args, "properties",
+      response);
+}
+
+static GstdReturnCode
+gstd_parser_list_signals (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_read_element_resource (session, args, "signals",
+      response);
+}
+
+static GstdReturnCode
+gstd_parser_bus_read (GstdSession * session, const gchar * pipeline,
+    gchar ** response)
+{
+  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  return ret;
+  return gstd_parser_read_formatted (session, response,
+      "/pipelines/%s/bus/message", pipeline);
 }
 
+/*
+ * Updates /pipelines/<pipeline>/<resource> with the rest of @args
+ */
 static GstdReturnCode
-gstd_parser_bus_timeout (GstdSession * session, gchar * action, gchar * args,
-    gchar ** response)
+gstd_parser_update_pipeline_resource (GstdSession * session,
+    const gchar * args, const gchar * resource, gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
   gchar *uri;
-  gchar **tokens = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-
-  uri = g_strdup_printf ("/pipelines/%s/bus/timeout %s", tokens[0], tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  if (gstd_parser_tokenize (args, tokens, 2) < 2)
+    return GSTD_BAD_COMMAND;
 
-  g_free (uri);
-  g_strfreev (tokens);
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%.*s/%s",
+      tokens[0].len, tokens[0].str, resource);
+  ret = gstd_parser_update (session, uri, tokens[1].str, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_event_eos (GstdSession * session, gchar * action, gchar * pipeline,
+gstd_parser_bus_filter (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
-  gchar *uri;
-
-  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
-
-  uri = g_strdup_printf ("/pipelines/%s/event eos", pipeline);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
-
-  g_free (uri);
+  return gstd_parser_update_pipeline_resource (session, args, "bus/types",
+      response);
+}
 
-  return ret;
+static GstdReturnCode
+gstd_parser_bus_timeout (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_update_pipeline_resource (session, args, "bus/timeout",
+      response);
 }
 
+/*
+ * pipeline_wait <name> [transition] [timeout]
+ *
+ * Answers with the state record once the transition, by default the
+ * latest one, is over. Timeout is in nanoseconds and defaults to
+ * waiting for as long as it takes. Fails with the record as response
+ * if the transition failed, was replaced or is still in progress.
+ * Parked like bus_read when asynchronous.
+ */
 static GstdReturnCode
-gstd_parser_event_seek (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_pipeline_wait (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar value[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[3];
   gchar *uri;
-  gchar **tokens = NULL;
+  gchar *end;
+  GstdObject *state = NULL;
+  guint64 transition = 0;
+  gint64 timeout = -1;
+  guint n;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  // We don't check for the second token since we want to allow defaults
-
-  uri = g_strdup_printf ("/pipelines/%s/event seek %s", tokens[0], tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
+  n = gstd_parser_tokenize (args, tokens, 3);
+  if (n < 1) {
+    return GSTD_BAD_COMMAND;
+  }
 
-  g_free (uri);
-  g_strfreev (tokens);
+  if (n > 1) {
+    if (!gstd_parser_token_copy (&tokens[1], value, sizeof (value))) {
+      return GSTD_BAD_VALUE;
+    }
+    transition = g_ascii_strtoull (value, &end, 10);
+    if ('\0' != *end) {
+      return GSTD_BAD_VALUE;
+    }
+  }
 
-  return ret;
-}
+  if (n > 2) {
+    timeout = g_ascii_strtoll (tokens[2].str, &end, 10);
+    if ('\0' != *end) {
+      return GSTD_BAD_VALUE;
+    }
+  }
 
-static GstdReturnCode
-gstd_parser_event_flush_start (GstdSession * session, gchar * action,
-    gchar * pipeline, gchar ** response)
-{
-  GstdReturnCode ret;
-  gchar *uri;
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%.*s/state",
+      tokens[0].len, tokens[0].str);
+  ret = gstd_parser_get_by_uri (session, uri, &state);
+  gstd_parser_free_buffer (uri, buf);
+  if (ret) {
+    goto out;
+  }
 
-  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+  if (!GSTD_IS_STATE (state)) {
+    ret = GSTD_BAD_COMMAND;
+    goto out;
+  }
 
-  uri = g_strdup_printf ("/pipelines/%s/event flush_start", pipeline);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
+  ret = gstd_parser_wait (session, GSTD_STATE (state), transition, timeout,
+      response);
 
-  g_free (uri);
+out:
+  if (state) {
+    g_object_unref (state);
+  }
 
   return ret;
 }
 
+#define GSTD_PARSER_BUS_READ_MAX_DEFAULT 64
+
+/*
+ * bus_read_since <pipeline> <seq> [types] [max] [timeout]
+ *
+ * Reads up to max messages newer than seq without consuming them, the
+ * response tells the seq to continue from. Types default to any and
+ * timeout, in nanoseconds, to not waiting at all. Parked like bus_read
+ * when asynchronous.
+ */
 static GstdReturnCode
-gstd_parser_event_flush_stop (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_bus_read_since (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar value[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[5];
   gchar *uri;
-  gchar **tokens = NULL;
+  gchar *end;
+  GstdObject *bus = NULL;
+  guint64 since;
+  guint64 last;
+  guint64 max = GSTD_PARSER_BUS_READ_MAX_DEFAULT;
+  gint64 timeout = 0;
+  gint types = GST_MESSAGE_ANY;
+  guint n;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  // We don't check for the second token since we want to allow defaults
+  n = gstd_parser_tokenize (args, tokens, 5);
+  if (n < 2) {
+    return GSTD_BAD_COMMAND;
+  }
 
-  uri =
-      g_strdup_printf ("/pipelines/%s/event flush_stop %s", tokens[0],
-      tokens[1]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
+  if (!gstd_parser_token_copy (&tokens[1], value, sizeof (value))
+      || !gstd_pipeline_bus_parse_seq (value, &since)) {
+    GST_ERROR_OBJECT (session, "Invalid sequence number \"%.*s\"",
+        tokens[1].len, tokens[1].str);
+    return GSTD_BAD_VALUE;
+  }
 
-  g_free (uri);
-  g_strfreev (tokens);
+  if (n > 2 && (!gstd_parser_token_copy (&tokens[2], value, sizeof (value))
+          || !gstd_pipeline_bus_parse_types (value, &types))) {
+    return GSTD_BAD_VALUE;
+  }
 
-  return ret;
-}
+  if (n > 3) {
+    if (!gstd_parser_token_copy (&tokens[3], value, sizeof (value))) {
+      return GSTD_BAD_VALUE;
+    }
+    max = g_ascii_strtoull (value, &end, 10);
+    if ('\0' != *end || 0 == max || max > G_MAXUINT) {
+      return GSTD_BAD_VALUE;
+    }
+  }
 
-static GstdReturnCode
-gstd_parser_debug_enable (GstdSession * session, gchar * action,
-    gchar * enabled, gchar ** response)
-{
-  GstdReturnCode ret;
-  gchar *uri;
+  if (n > 4) {
+    timeout = g_ascii_strtoll (tokens[4].str, &end, 10);
+    if ('\0' != *end) {
+      return GSTD_BAD_VALUE;
+    }
+  }
 
-  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%.*s/bus",
+      tokens[0].len, tokens[0].str);
+  ret = gstd_parser_get_by_uri (session, uri, &bus);
+  gstd_parser_free_buffer (uri, buf);
+  if (ret) {
+    goto out;
+  }
+
+  if (!GSTD_IS_PIPELINE_BUS (bus)) {
+    ret = GSTD_BAD_COMMAND;
+    goto out;
+  }
 
-  check_argument (enabled, GSTD_BAD_COMMAND);
+  /* A cursor ahead of the ring waits for the next message. Pin it, so
+   * a parked read still returns that message once it arrives */
+  g_object_get (bus, "last-seq", &last, NULL);
+  since = MIN (since, last);
+
+  /* Waiting doesn't hold the thread when run asynchronously */
+  if (gstd_parser_read_since_parked (session, bus, since, types, max,
+          timeout, &ret, response)) {
+    goto out;
+  }
 
-  uri = g_strdup_printf ("/debug/enable %s", enabled);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  ret = gstd_pipeline_bus_read_since (GSTD_PIPELINE_BUS (bus), since, types,
+      max, timeout, response);
 
-  g_free (uri);
+out:
+  if (bus) {
+    g_object_unref (bus);
+  }
 
   return ret;
 }
 
+/*
+ * Sends the @event event to the pipeline named by the first token in
+ * @args, the rest is passed as the event description.
+ */
 static GstdReturnCode
-gstd_parser_debug_threshold (GstdSession * session, gchar * action,
-    gchar * threshold, gchar ** response)
+gstd_parser_send_event (GstdSession * session, const gchar * args,
+    const gchar * event, gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  const gchar *description;
   gchar *uri;
+  guint n;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  check_argument (threshold, GSTD_BAD_COMMAND);
-
-  uri = g_strdup_printf ("/debug/threshold %s", threshold);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  n = gstd_parser_tokenize (args, tokens, 2);
+  check_argument (n > 0 ? tokens[0].str : NULL, GSTD_BAD_COMMAND);
+  // We don't check for the second token since we want to allow defaults
+  description = n > 1 ? tokens[1].str : NULL;
 
-  g_free (uri);
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%.*s/event",
+      tokens[0].len, tokens[0].str);
+  ret = gstd_parser_create (session, uri, event, description, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_debug_color (GstdSession * session, gchar * action, gchar * colored,
+gstd_parser_event_eos (GstdSession * session, const gchar * pipeline,
     gchar ** response)
 {
-  GstdReturnCode ret;
-  gchar *uri;
-
-  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
 
-  check_argument (colored, GSTD_BAD_COMMAND);
+  return gstd_parser_send_event (session, pipeline, "eos", response);
+}
 
-  uri = g_strdup_printf ("/debug/color %s", colored);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+static GstdReturnCode
+gstd_parser_event_seek (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_send_event (session, args, "seek", response);
+}
 
-  g_free (uri);
+static GstdReturnCode
+gstd_parser_event_flush_start (GstdSession * session, const gchar * pipeline,
+    gchar ** response)
+{
+  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
 
-  return ret;
+  return gstd_parser_send_event (session, pipeline, "flush_start", response);
 }
 
-
 static GstdReturnCode
-gstd_parser_debug_reset (GstdSession * session, gchar * action, gchar * reset,
+gstd_parser_event_flush_stop (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
-  gchar *uri;
+  return gstd_parser_send_event (session, args, "flush_stop", response);
+}
 
+static GstdReturnCode
+gstd_parser_debug_update (GstdSession * session, const gchar * uri,
+    const gchar * value, gchar ** response)
+{
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  check_argument (reset, GSTD_BAD_COMMAND);
+  check_argument (value, GSTD_BAD_COMMAND);
 
-  uri = g_strdup_printf ("/debug/reset %s", reset);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  return gstd_parser_update (session, uri, value, response);
+}
+
+static GstdReturnCode
+gstd_parser_debug_enable (GstdSession * session, const gchar * enabled,
+    gchar ** response)
+{
+  return gstd_parser_debug_update (session, "/debug/enable", enabled,
+      response);
+}
 
-  g_free (uri);
+static GstdReturnCode
+gstd_parser_debug_threshold (GstdSession * session, const gchar * threshold,
+    gchar ** response)
+{
+  return gstd_parser_debug_update (session, "/debug/threshold", threshold,
+      response);
+}
 
-  return ret;
+static GstdReturnCode
+gstd_parser_debug_color (GstdSession * session, const gchar * colored,
+    gchar ** response)
+{
+  return gstd_parser_debug_update (session, "/debug/color", colored,
+      response);
 }
 
+static GstdReturnCode
+gstd_parser_debug_reset (GstdSession * session, const gchar * reset,
+    gchar ** response)
+{
+  return gstd_parser_debug_update (session, "/debug/reset", reset, response);
+}
 
+/*
+ * Reads /pipelines/<pipeline>/elements/<element>/signals/<signal>/<resource>
+ */
 static GstdReturnCode
-gstd_parser_signal_connect (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_read_signal_resource (GstdSession * session, const gchar * args,
+    const gchar * resource, gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[GSTD_PARSER_MAX_TOKENS];
   gchar *uri;
-  gchar **tokens = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 3);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  if (gstd_parser_tokenize (args, tokens, 3) < 3)
+    return GSTD_BAD_COMMAND;
 
-  uri = g_strdup_printf ("/pipelines/%s/elements/%s/signals/%s/callback",
-      tokens[0], tokens[1], tokens[2]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
-
-  g_free (uri);
-  g_strfreev (tokens);
+  uri = gstd_parser_format (buf, sizeof (buf),
+      "/pipelines/%.*s/elements/%.*s/signals/%s/%s", tokens[0].len,
+      tokens[0].str, tokens[1].len, tokens[1].str, tokens[2].str, resource);
+  ret = gstd_parser_read (session, uri, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
+static GstdReturnCode
+gstd_parser_signal_connect (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_read_signal_resource (session, args, "callback",
+      response);
+}
+
+static GstdReturnCode
+gstd_parser_signal_disconnect (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  return gstd_parser_read_signal_resource (session, args, "disconnect",
+      response);
+}
 
+/*
+ * signal_read_since <pipeline> <element> <signal> <seq> [max] [timeout]
+ *
+ * Reads up to max emissions newer than seq without taking them from
+ * other readers, the response tells the seq to continue from. The
+ * timeout, in nanoseconds like bus_read_since, defaults to not waiting
+ * at all. Parked like the callback read when asynchronous.
+ */
 static GstdReturnCode
-gstd_parser_signal_disconnect (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_signal_read_since (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar value[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[6];
   gchar *uri;
-  gchar **tokens = NULL;
+  gchar *end;
+  GstdObject *signal = NULL;
+  guint64 since;
+  guint64 max = GSTD_PARSER_BUS_READ_MAX_DEFAULT;
+  gint64 timeout = 0;
+  guint n;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 3);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  n = gstd_parser_tokenize (args, tokens, 6);
+  if (n < 4) {
+    return GSTD_BAD_COMMAND;
+  }
+
+  if (!gstd_parser_token_copy (&tokens[3], value, sizeof (value))
+      || !gstd_pipeline_bus_parse_seq (value, &since)) {
+    GST_ERROR_OBJECT (session, "Invalid sequence number \"%.*s\"",
+        tokens[3].len, tokens[3].str);
+    return GSTD_BAD_VALUE;
+  }
+
+  if (n > 4) {
+    if (!gstd_parser_token_copy (&tokens[4], value, sizeof (value))) {
+      return GSTD_BAD_VALUE;
+    }
+    max = g_ascii_strtoull (value, &end, 10);
+    if ('\0' != *end || 0 == max || max > G_MAXUINT) {
+      return GSTD_BAD_VALUE;
+    }
+  }
+
+  if (n > 5) {
+    timeout = g_ascii_strtoll (tokens[5].str, &end, 10);
+    if ('\0' != *end) {
+      return GSTD_BAD_VALUE;
+    }
+  }
+
+  uri = gstd_parser_format (buf, sizeof (buf),
+      "/pipelines/%.*s/elements/%.*s/signals/%.*s", tokens[0].len,
+      tokens[0].str, tokens[1].len, tokens[1].str, tokens[2].len,
+      tokens[2].str);
+  ret = gstd_parser_get_by_uri (session, uri, &signal);
+  gstd_parser_free_buffer (uri, buf);
+  if (ret) {
+    goto out;
+  }
+
+  if (!GSTD_IS_SIGNAL (signal)) {
+    ret = GSTD_BAD_COMMAND;
+    goto out;
+  }
+
+  /* Waiting doesn't hold the thread when run asynchronously */
+  if (gstd_parser_read_since_parked (session, signal, since,
+          GST_MESSAGE_ANY, max, timeout, &ret, response)) {
+    goto out;
+  }
 
-  uri = g_strdup_printf ("/pipelines/%s/elements/%s/signals/%s/disconnect",
-      tokens[0], tokens[1], tokens[2]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "read", uri, response);
+  ret = gstd_signal_reader_read_since (signal->reader, signal, since, max,
+      timeout, response);
 
-  g_free (uri);
-  g_strfreev (tokens);
+out:
+  if (signal) {
+    g_object_unref (signal);
+  }
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_action_emit (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_action_emit (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar namebuf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[GSTD_PARSER_MAX_TOKENS];
+  const gchar *description = NULL;
   gchar *uri;
-  gchar **tokens = NULL;
+  gchar *name;
+  guint n;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 4);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-  check_argument (tokens[2], GSTD_BAD_COMMAND);
+  n = gstd_parser_tokenize (args, tokens, 4);
+  if (n < 3)
+    return GSTD_BAD_COMMAND;
 
-  /* tokens[3] may be NULL for no-arg actions */
-  if (tokens[3] && tokens[3][0] != '\0') {
-    uri = g_strdup_printf ("/pipelines/%s/elements/%s/actions/%s %s %s",
-        tokens[0], tokens[1], tokens[2], tokens[2], tokens[3]);
-  } else {
-    /* No-arg action: omit the description argument */
-    uri = g_strdup_printf ("/pipelines/%s/elements/%s/actions/%s %s",
-        tokens[0], tokens[1], tokens[2], tokens[2]);
+  /* The 4th token may be missing for no-arg actions */
+  if (n > 3 && tokens[3].str[0] != '\0') {
+    description = tokens[3].str;
   }
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "create", uri, response);
 
-  g_free (uri);
-  g_strfreev (tokens);
+  name = gstd_parser_format (namebuf, sizeof (namebuf), "%.*s", tokens[2].len,
+      tokens[2].str);
+  uri = gstd_parser_format (buf, sizeof (buf),
+      "/pipelines/%.*s/elements/%.*s/actions/%s", tokens[0].len,
+      tokens[0].str, tokens[1].len, tokens[1].str, name);
+  ret = gstd_parser_create (session, uri, name, description, response);
+
+  gstd_parser_free_buffer (uri, buf);
+  gstd_parser_free_buffer (name, namebuf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_signal_timeout (GstdSession * session, gchar * action, gchar * args,
+gstd_parser_signal_timeout (GstdSession * session, const gchar * args,
     gchar ** response)
 {
-  GstdReturnCode ret;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[GSTD_PARSER_MAX_TOKENS];
   gchar *uri;
-  gchar **tokens = NULL;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 4);
-  check_argument (tokens[0], GSTD_BAD_COMMAND);
-  check_argument (tokens[1], GSTD_BAD_COMMAND);
-  check_argument (tokens[2], GSTD_BAD_COMMAND);
-  check_argument (tokens[3], GSTD_BAD_COMMAND);
-
-  uri = g_strdup_printf ("/pipelines/%s/elements/%s/signals/%s/timeout %s",
-      tokens[0], tokens[1], tokens[2], tokens[3]);
-  ret = gstd_parser_parse_raw_cmd (session, (gchar *) "update", uri, response);
+  if (gstd_parser_tokenize (args, tokens, 4) < 4)
+    return GSTD_BAD_COMMAND;
 
-  g_free (uri);
-  g_strfreev (tokens);
+  uri = gstd_parser_format (buf, sizeof (buf),
+      "/pipelines/%.*s/elements/%.*s/signals/%.*s/timeout", tokens[0].len,
+      tokens[0].str, tokens[1].len, tokens[1].str, tokens[2].len,
+      tokens[2].str);
+  ret = gstd_parser_update (session, uri, tokens[3].str, response);
+  gstd_parser_free_buffer (uri, buf);
 
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_create_ref (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_pipeline_create_ref (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  gchar **tokens = NULL;
-  gchar *description = NULL;
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  GstdParserToken tokens[2];
+  gchar *name;
+  const gchar *description;
+  gchar *current = NULL;
   GstdObject *pipeline_list_node = NULL;
   GstdObject *pipeline_node = NULL;
+  guint n;
   GstdReturnCode ret = GSTD_EOK;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  tokens = g_strsplit (args, " ", 2);
+  n = gstd_parser_tokenize (args, tokens, 2);
+  if (0 == n)
+    return GSTD_BAD_COMMAND;
+
+  name = gstd_parser_format (buf, sizeof (buf), "%.*s", tokens[0].len,
+      tokens[0].str);
+  description = n > 1 ? tokens[1].str : NULL;
 
   /* Get the pipeline list node */
   ret = gstd_get_by_uri (session, "/pipelines", &pipeline_list_node);
@@ -1015,26 +2095,25 @@ gstd_parser_pipeline_create_ref (GstdSession * session, gchar * action,
   GST_OBJECT_LOCK (session);
 
   /* Look for the pipeline node */
-  pipeline_node =
-      gstd_list_find_child (GSTD_LIST (pipeline_list_node), tokens[0]);
+  pipeline_node = gstd_list_find_child (GSTD_LIST (pipeline_list_node), name);
 
   /* Pipeline doesn't exist */
   if (!pipeline_node) {
-    ret = gstd_parser_pipeline_create (session, action, args, response);
+    ret = gstd_parser_pipeline_create (session, args, response);
     if (ret) {
       goto create_error;
     }
     pipeline_node =
-        gstd_list_find_child (GSTD_LIST (pipeline_list_node), tokens[0]);
+        gstd_list_find_child (GSTD_LIST (pipeline_list_node), name);
   } else {
-    g_object_get (pipeline_node, "description", &description, NULL);
+    g_object_get (pipeline_node, "description", &current, NULL);
     /* Return error code if the descriptions don't match */
-    if (0 != g_strcmp0 (description, tokens[1])) {
+    if (0 != g_strcmp0 (current, description)) {
       ret = GSTD_EXISTING_NAME;
-      g_free (description);
+      g_free (current);
       goto create_error;
     }
-    g_free (description);
+    g_free (current);
   }
   ret = gstd_pipeline_increment_refcount (GSTD_PIPELINE (pipeline_node));
 
@@ -1046,21 +2125,21 @@ create_error:
   GST_OBJECT_UNLOCK (session);
   gst_object_unref (pipeline_list_node);
 pipeline_list_node_error:
-  g_strfreev (tokens);
+  gstd_parser_free_buffer (name, buf);
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_delete_ref (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_pipeline_delete_ref (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
   GstdObject *pipeline_list_node = NULL;
   GstdObject *pipeline_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
   guint refcount = 0;
+  gboolean deleted = FALSE;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
@@ -1081,58 +2160,84 @@ gstd_parser_pipeline_delete_ref (GstdSession * session, gchar * action,
 
   g_object_get (pipeline_node, "refcount", &refcount, NULL);
   if (1 == refcount) {
-    ret = gstd_parser_pipeline_delete (session, action, args, response);
+    ret = gstd_object_delete (pipeline_list_node, args);
+    deleted = GSTD_EOK == ret;
   } else {
     ret = gstd_pipeline_decrement_refcount (GSTD_PIPELINE (pipeline_node));
   }
 
 pipeline_node_error:
+  GST_OBJECT_UNLOCK (session);
+  gst_object_unref (pipeline_list_node);
+
+  /* Don't hold the session while the pipeline goes to NULL */
+  if (deleted) {
+    gstd_session_wait_pipeline_deleted (session, pipeline_node);
+  }
+
   /* gstd_list_find_child returns a ref'd pointer, must unref when done */
   if (pipeline_node) {
     g_object_unref (pipeline_node);
   }
-  GST_OBJECT_UNLOCK (session);
-  gst_object_unref (pipeline_list_node);
 pipeline_list_node_error:
   return ret;
 }
 
+/*
+ * Resolves /pipelines/<args> and /pipelines/<args>/state
+ */
+static GstdReturnCode
+gstd_parser_get_pipeline_state (GstdSession * session, const gchar * args,
+    GstdObject ** pipeline_node, GstdObject ** state_node)
+{
+  gchar buf[GSTD_PARSER_BUFFER_SIZE];
+  gchar *uri;
+  GstdReturnCode ret;
+
+  /* Get the pipeline node */
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%s", args);
+  ret = gstd_get_by_uri (session, uri, pipeline_node);
+  gstd_parser_free_buffer (uri, buf);
+  if (ret) {
+    return ret;
+  }
+
+  /* Get the state node */
+  uri = gstd_parser_format (buf, sizeof (buf), "/pipelines/%s/state", args);
+  ret = gstd_get_by_uri (session, uri, state_node);
+  gstd_parser_free_buffer (uri, buf);
+  if (ret) {
+    gst_object_unref (*pipeline_node);
+    *pipeline_node = NULL;
+  }
+
+  return ret;
+}
+
 static GstdReturnCode
-gstd_parser_pipeline_play_ref (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_pipeline_play_ref (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  gchar *uri = NULL;
   GstdObject *pipeline_node = NULL;
   GstdObject *state_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
   guint refcount = 0;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  /* Get the pipeline node */
-  uri = g_strdup_printf ("/pipelines/%s", args);
-  ret = gstd_get_by_uri (session, uri, &pipeline_node);
-  g_free (uri);
+  ret = gstd_parser_get_pipeline_state (session, args, &pipeline_node,
+      &state_node);
   if (ret) {
     goto pipeline_node_error;
   }
 
-  /* Get the state node */
-  uri = g_strdup_printf ("/pipelines/%s/state", args);
-  ret = gstd_get_by_uri (session, uri, &state_node);
-  g_free (uri);
-  if (ret) {
-    goto state_node_error;
-  }
-
   GST_OBJECT_LOCK (pipeline_node);
 
   g_object_get (state_node, "refcount", &refcount, NULL);
   if (0 == refcount) {
-    ret = gstd_parser_pipeline_play (session, action, args, response);
+    ret = gstd_parser_pipeline_play (session, args, response);
     if (ret) {
       goto play_error;
     }
@@ -1144,48 +2249,35 @@ gstd_parser_pipeline_play_ref (GstdSession * session, gchar * action,
 play_error:
   GST_OBJECT_UNLOCK (pipeline_node);
   gst_object_unref (state_node);
-state_node_error:
   gst_object_unref (pipeline_node);
 pipeline_node_error:
   return ret;
 }
 
 static GstdReturnCode
-gstd_parser_pipeline_stop_ref (GstdSession * session, gchar * action,
-    gchar * args, gchar ** response)
+gstd_parser_pipeline_stop_ref (GstdSession * session, const gchar * args,
+    gchar ** response)
 {
-  gchar *uri = NULL;
   GstdObject *pipeline_node = NULL;
   GstdObject *state_node = NULL;
   GstdReturnCode ret = GSTD_EOK;
   guint refcount = 0;
 
   g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (action, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
 
-  /* Get the pipeline node */
-  uri = g_strdup_printf ("/pipelines/%s", args);
-  ret = gstd_get_by_uri (session, uri, &pipeline_node);
-  g_free (uri);
+  ret = gstd_parser_get_pipeline_state (session, args, &pipeline_node,
+      &state_node);
   if (ret) {
     goto pipeline_node_error;
   }
 
-  /* Get the state node */
-  uri = g_strdup_printf ("/pipelines/%s/state", args);
-  ret = gstd_get_by_uri (session, uri, &state_node);
-  g_free (uri);
-  if (ret) {
-    goto state_node_error;
-  }
-
   GST_OBJECT_LOCK (pipeline_node);
 
   g_object_get (state_node, "refcount", &refcount, NULL);
   if (1 == refcount) {
-    ret = gstd_parser_pipeline_stop (session, action, args, response);
+    ret = gstd_parser_pipeline_stop (session, args, response);
     if (ret) {
       goto stop_error;
     }
@@ -1197,8 +2289,51 @@ gstd_parser_pipeline_stop_ref (GstdSession * session, gchar * action,
 stop_error:
   GST_OBJECT_UNLOCK (pipeline_node);
   gst_object_unref (state_node);
-state_node_error:
   gst_object_unref (pipeline_node);
 pipeline_node_error:
   return ret;
 }
+
+/*
+ * batch [stop_on_error]
+ * <command>
+ * ...
+ *
+ * Commands go one per line. The first line holds the options.
+ */
+static GstdReturnCode
+gstd_parser_batch (GstdSession * session, const gchar * args,
+    gchar ** response)
+{
+  gchar **lines;
+  gboolean stop_on_error;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (args, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  lines = g_strsplit (args, "\n", -1);
+
+  if (NULL == lines[0]) {
+    ret = GSTD_BAD_COMMAND;
+    goto out;
+  }
+
+  if (0 == g_strcmp0 (lines[0], "stop_on_error")) {
+    stop_on_error = TRUE;
+  } else if ('\0' == lines[0][0]) {
+    stop_on_error = FALSE;
+  } else {
+    GST_ERROR_OBJECT (session, "Unknown batch option \"%s\"", lines[0]);
+    ret = GSTD_BAD_VALUE;
+    goto out;
+  }
+
+  ret = gstd_parser_parse_batch (session, (const gchar * const *) lines + 1,
+      stop_on_error, response);
+
+out:
+  g_strfreev (lines);
+  return ret;
+}
@@ -26,6 +26,7 @@
 #endif
 
 #include <glib.h>
+#include <gio/gio.h>
 
 #include "gstd_return_codes.h"
 #include "gstd_session.h"
@@ -42,4 +43,56 @@
 GstdReturnCode gstd_parser_parse_cmd (GstdSession * session, const gchar * cmd,
     gchar ** response);
 
+/**
+ * Runs several commands in order in a single call. Commands sharing a
+ * URI prefix, like properties of the same element, resolve it once.
+ *
+ * \param session GstdSession object.
+ * \param cmds NULL terminated array of command lines, empty ones are
+ * skipped.
+ * \param stop_on_error Whether to skip the rest of the commands after
+ * the first one that fails.
+ * \param response Reference to the object where the "codes" array,
+ * holding the return code of each command run, will be stored.
+ *
+ * \return GSTD_EOK if every command succeeded, otherwise the return
+ * code of the first one that failed.
+ **/
+GstdReturnCode gstd_parser_parse_batch (GstdSession * session,
+    const gchar * const *cmds, gboolean stop_on_error, gchar ** response);
+
+/**
+ * Completes a command parked by gstd_parser_parse_cmd_async(). Runs
+ * in the park thread, see gstd_park.h.
+ *
+ * \param ret GstdReturnCode return code for the transaction.
+ * \param response (transfer full) The result, NULL if none.
+ * \param user_data The data given to gstd_parser_parse_cmd_async().
+ **/
+typedef void (*GstdParserFunc) (GstdReturnCode ret, gchar * response,
+    gpointer user_data);
+
+/**
+ * Like gstd_parser_parse_cmd(), except that reads waiting for a bus
+ * message or a signal emission, like bus_read with an infinite
+ * timeout, are parked instead of blocking the calling thread. The
+ * thread's formatter, see gstd_object_set_thread_formatter(), is
+ * carried over to the completion.
+ *
+ * \param session GstdSession object.
+ * \param cmd Command line to be parsed.
+ * \param cancellable Ends a parked read early, as if it timed out.
+ * \param func Called with the result if the command was parked.
+ * \param user_data Data to pass to func.
+ * \param ret Return code of the command, if it completed.
+ * \param response Reference to the object where the result will be
+ * stored, if it completed.
+ *
+ * \return TRUE if the command completed and ret and response are set,
+ * FALSE if it was parked and func will be called instead.
+ **/
+gboolean gstd_parser_parse_cmd_async (GstdSession * session,
+    const gchar * cmd, GCancellable * cancellable, GstdParserFunc func,
+    gpointer user_data, GstdReturnCode * ret, gchar ** response);
+
 #endif // __GSTD_PARSER_H__
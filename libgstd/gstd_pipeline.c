@@ -33,6 +33,9 @@
 #include "gstd_pipeline_bus.h"
 #include "gstd_property_reader.h"
 #include "gstd_state.h"
+#include "gstd_stats.h"
+#include "gstd_template.h"
+#include "gstd_uri_cache.h"
 
 #include "gstd_pipeline.h"
 
@@ -48,6 +51,9 @@ enum
   PROP_GRAPH,
   PROP_VERBOSE,
   PROP_REFCOUNT,
+  PROP_TEMPLATE,
+  PROP_PREBUILT,
+  PROP_STATS,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
@@ -77,6 +83,12 @@ struct _GstdPipeline
    */
   gchar *description;
 
+  /**
+   * The template the pipeline is built from, if any. The description
+   * is then "@template name=value ..."
+   */
+  GstdTemplate *template;
+
   /**
    * The gstd event handler for this pipeline
    */
@@ -95,15 +107,36 @@ struct _GstdPipeline
   GstElement *pipeline;
 
   /**
-   * The list of GstdElement held by the pipeline
+   * The list of GstdElement held by the pipeline and, recursively, by
+   * its bins, keyed by their path: "bin/child"
    */
   GstdList *elements;
 
+  /**
+   * The path each GstElement is indexed with in elements, kept up to
+   * date from the deep-element-added/removed signals. Protected by
+   * index_lock
+   */
+  GHashTable *paths;
+  GMutex index_lock;
+  gulong element_added_id;
+  gulong element_removed_id;
+
   /**
    * The state of the GstPipeline
    */
   GstdState *state;
 
+  /**
+   * The tracer stats of the GstPipeline, disabled until requested
+   */
+  GstdStats *stats;
+
+  /**
+   * Counters exported by the metrics resource, kept from the bus
+   */
+  GstdMetricsPipeline *metrics;
+
   /**
    * Position of the media progress pipeline
    */
@@ -145,10 +178,12 @@ gstd_pipeline_get_property (GObject *, guint, GValue *, GParamSpec *);
 static void
 gstd_pipeline_set_property (GObject *, guint, const GValue *, GParamSpec *);
 static void gstd_pipeline_dispose (GObject *);
+static void gstd_pipeline_finalize (GObject *);
 static GstdReturnCode
 gstd_pipeline_create (GstdPipeline *, const gchar *, gint, const gchar *);
 static GstdReturnCode gstd_pipeline_fill_elements (GstdPipeline *,
     GstElement *);
+static void gstd_pipeline_unwatch_elements (GstdPipeline *);
 
 static void
 gstd_pipeline_class_init (GstdPipelineClass * klass)
@@ -160,6 +195,7 @@ gstd_pipeline_class_init (GstdPipelineClass * klass)
   object_class->set_property = gstd_pipeline_set_property;
   object_class->get_property = gstd_pipeline_get_property;
   object_class->dispose = gstd_pipeline_dispose;
+  object_class->finalize = gstd_pipeline_finalize;
 
   properties[PROP_DESCRIPTION] =
       g_param_spec_string ("description",
@@ -218,6 +254,25 @@ gstd_pipeline_class_init (GstdPipelineClass * klass)
       "Reference count of pipeline creation",
       0, G_MAXINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_TEMPLATE] =
+      g_param_spec_object ("template", "Template",
+      "The template to build the pipeline from instead of parsing it",
+      GSTD_TYPE_TEMPLATE,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_PREBUILT] =
+      g_param_spec_object ("prebuilt", "Prebuilt",
+      "A pipeline already built from the description, to use as is",
+      GST_TYPE_PIPELINE,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_STATS] =
+      g_param_spec_object ("stats", "Stats",
+      "The throughput and latency of the pipeline",
+      GSTD_TYPE_STATS,
+      G_PARAM_READABLE |
+      G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ | GSTD_PARAM_UPDATE);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -231,16 +286,24 @@ gstd_pipeline_init (GstdPipeline * self)
 {
   GST_INFO_OBJECT (self, "Initializing pipeline");
   self->description = g_strdup (GSTD_PIPELINE_DEFAULT_DESCRIPTION);
+  self->template = NULL;
   self->pipeline = NULL;
   self->event_handler = NULL;
   self->pipeline_bus = NULL;
   self->state = NULL;
+  self->stats = NULL;
+  self->metrics = NULL;
   self->graph = NULL;
   self->deep_notify_id = 0;
   self->refcount = 0;
 
   self->elements = g_object_new (GSTD_TYPE_LIST, "name", "elements",
       "node-type", GSTD_TYPE_ELEMENT, "flags", GSTD_PARAM_READ, NULL);
+  self->paths = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      g_free);
+  g_mutex_init (&self->index_lock);
+  self->element_added_id = 0;
+  self->element_removed_id = 0;
 
   gstd_object_set_reader (GSTD_OBJECT (self->elements),
       g_object_new (GSTD_TYPE_LIST_READER, NULL));
@@ -284,6 +347,13 @@ gstd_pipeline_build (GstdPipeline * object)
     /* pipeline_bus now owns the bus reference */
   }
 
+  /* Asynchronous state changes complete from the bus */
+  gstd_state_track (self->state, self->pipeline_bus);
+
+  self->metrics = gstd_metrics_pipeline_new ();
+  gstd_metrics_pipeline_track (self->metrics, self->pipeline,
+      self->pipeline_bus);
+
   goto out;
 
 out2:
@@ -291,6 +361,7 @@ out2:
   self->event_handler = NULL;
 
 out1:
+  gstd_pipeline_unwatch_elements (self);
   g_object_unref (self->elements);
   self->elements = NULL;
   gst_object_unref (self->pipeline);
@@ -314,12 +385,18 @@ gstd_pipeline_dispose (GObject * object)
     self->state = NULL;
   }
 
+  g_clear_object (&self->stats);
+
   if (self->description) {
     g_free (self->description);
     self->description = NULL;
   }
 
+  g_clear_object (&self->template);
+
   if (self->pipeline_bus) {
+    /* Subscribers may still hold the bus, let them know it's over */
+    gstd_pipeline_bus_close (self->pipeline_bus);
     g_object_unref (self->pipeline_bus);
     self->pipeline_bus = NULL;
   }
@@ -329,7 +406,10 @@ gstd_pipeline_dispose (GObject * object)
     self->event_handler = NULL;
   }
 
+  g_clear_pointer (&self->metrics, gstd_metrics_pipeline_unref);
+
   if (self->pipeline) {
+    gstd_pipeline_unwatch_elements (self);
     gst_object_unref (self->pipeline);
     self->pipeline = NULL;
   }
@@ -346,6 +426,17 @@ gstd_pipeline_dispose (GObject * object)
   G_OBJECT_CLASS (gstd_pipeline_parent_class)->dispose (object);
 }
 
+static void
+gstd_pipeline_finalize (GObject * object)
+{
+  GstdPipeline *self = GSTD_PIPELINE (object);
+
+  g_hash_table_unref (self->paths);
+  g_mutex_clear (&self->index_lock);
+
+  G_OBJECT_CLASS (gstd_pipeline_parent_class)->finalize (object);
+}
+
 static void
 gstd_pipeline_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec)
@@ -371,6 +462,10 @@ gstd_pipeline_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning pipeline state %p", self->state);
       g_value_set_object (value, self->state);
       break;
+    case PROP_STATS:
+      GST_DEBUG_OBJECT (self, "Returning pipeline stats %p", self->stats);
+      g_value_set_object (value, self->stats);
+      break;
     case PROP_EVENT:
       GST_DEBUG_OBJECT (self, "Returning event handler %p",
           self->event_handler);
@@ -465,6 +560,17 @@ gstd_pipeline_set_property (GObject * object,
           self->description);
       break;
 
+    case PROP_TEMPLATE:
+      g_clear_object (&self->template);
+      self->template = g_value_dup_object (value);
+      break;
+
+    case PROP_PREBUILT:
+      if (self->pipeline)
+        gst_object_unref (self->pipeline);
+      self->pipeline = g_value_dup_object (value);
+      break;
+
     case PROP_STATE:
       if (self->state) {
         g_object_unref (self->state);
@@ -518,16 +624,28 @@ gstd_pipeline_create (GstdPipeline * self, const gchar * name,
   GError *error;
   gchar *pipename;
   GstParseFlags flags;
+  GstdReturnCode ret;
 
   g_return_val_if_fail (self, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (index != -1, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (description, GSTD_NULL_ARGUMENT);
 
   error = NULL;
-  flags = GST_PARSE_FLAG_FATAL_ERRORS | GST_PARSE_FLAG_NO_SINGLE_ELEMENT_BINS;
-  self->pipeline = gst_parse_launch_full (description, NULL, flags, &error);
-  if (!self->pipeline)
-    goto wrong_pipeline;
+  if (self->pipeline) {
+    /* Taken from a standby pool, see gstd_standby_claim() */
+    GST_DEBUG_OBJECT (self, "Using a prebuilt pipeline");
+  } else if (self->template) {
+    /* The parameters follow the template name */
+    ret = gstd_template_instantiate (self->template, strchr (description,
+            ' '), &self->pipeline);
+    if (ret)
+      return ret;
+  } else {
+    flags = GST_PARSE_FLAG_FATAL_ERRORS | GST_PARSE_FLAG_NO_SINGLE_ELEMENT_BINS;
+    self->pipeline = gst_parse_launch_full (description, NULL, flags, &error);
+    if (!self->pipeline)
+      goto wrong_pipeline;
+  }
 
   /* Single element descriptions (i.e.: playbin) aren't returned in a
      pipeline. This is a problem for us since we concepts like the bus
@@ -543,6 +661,9 @@ gstd_pipeline_create (GstdPipeline * self, const gchar * name,
   }
   self->state = gstd_state_new (self->pipeline);
 
+  g_clear_object (&self->stats);
+  self->stats = gstd_stats_new (self->pipeline);
+
   /* If the user didn't provide a name or provided an empty name
    * assign the fallback using the idex */
   if (!name || name[0] == '\0') {
@@ -573,18 +694,135 @@ wrong_pipeline:
   }
 }
 
+/*
+ * The path of @element below the pipeline, its name and the names of
+ * the bins holding it separated by '/'. NULL if it isn't in the
+ * pipeline (anymore).
+ */
+static gchar *
+gstd_pipeline_element_path (GstdPipeline * self, GstElement * element)
+{
+  GstObject *object = gst_object_ref (element);
+  GstObject *parent;
+  GString *path = g_string_new (NULL);
+
+  while ((parent = gst_object_get_parent (object))) {
+    gchar *name = gst_object_get_name (object);
+
+    g_string_prepend (path, name);
+    g_free (name);
+
+    gst_object_unref (object);
+    object = parent;
+
+    if (object == GST_OBJECT (self->pipeline)) {
+      break;
+    }
+    g_string_prepend_c (path, '/');
+  }
+
+  if (object != GST_OBJECT (self->pipeline)) {
+    g_string_free (path, TRUE);
+    path = NULL;
+  }
+  gst_object_unref (object);
+
+  return path ? g_string_free (path, FALSE) : NULL;
+}
+
+static void
+gstd_pipeline_index_element (GstdPipeline * self, GstElement * element)
+{
+  GstdObject *gstd_element;
+  gchar *path;
+
+  path = gstd_pipeline_element_path (self, element);
+  if (!path) {
+    return;
+  }
+
+  g_mutex_lock (&self->index_lock);
+  if (g_hash_table_contains (self->paths, element)) {
+    g_mutex_unlock (&self->index_lock);
+    g_free (path);
+    return;
+  }
+
+  GST_LOG_OBJECT (self, "Saving element \"%s\"", path);
+
+  gstd_element = g_object_new (GSTD_TYPE_ELEMENT, "name", path, "gstelement",
+      element, "index", self->elements, NULL);
+  if (gstd_list_append_child (self->elements, gstd_element)) {
+    g_hash_table_insert (self->paths, element, path);
+  } else {
+    g_object_unref (gstd_element);
+    g_free (path);
+  }
+  g_mutex_unlock (&self->index_lock);
+}
+
+static void
+gstd_pipeline_unindex_element (GstdPipeline * self, GstElement * element)
+{
+  gchar *path;
+
+  g_mutex_lock (&self->index_lock);
+  path = g_hash_table_lookup (self->paths, element);
+  if (path) {
+    GST_LOG_OBJECT (self, "Dropping element \"%s\"", path);
+    gstd_list_remove_child (self->elements, path);
+    g_hash_table_remove (self->paths, element);
+  }
+  g_mutex_unlock (&self->index_lock);
+
+  /* URIs resolved through it may be cached */
+  if (path) {
+    gstd_uri_cache_invalidate_all ();
+  }
+}
+
+static void
+gstd_pipeline_on_element_added (GstBin * bin, GstBin * sub_bin,
+    GstElement * element, gpointer user_data)
+{
+  gstd_pipeline_index_element (GSTD_PIPELINE (user_data), element);
+}
+
+static void
+gstd_pipeline_on_element_removed (GstBin * bin, GstBin * sub_bin,
+    GstElement * element, gpointer user_data)
+{
+  gstd_pipeline_unindex_element (GSTD_PIPELINE (user_data), element);
+}
+
+static void
+gstd_pipeline_unwatch_elements (GstdPipeline * self)
+{
+  if (self->element_added_id) {
+    g_signal_handler_disconnect (self->pipeline, self->element_added_id);
+    self->element_added_id = 0;
+  }
+  if (self->element_removed_id) {
+    g_signal_handler_disconnect (self->pipeline, self->element_removed_id);
+    self->element_removed_id = 0;
+  }
+}
+
 /* Maximum number of iterator resyncs before giving up */
 #define GSTD_MAX_ITERATOR_RESYNC 10
 
+/*
+ * Indexes every element in the pipeline, bins included, and keeps the
+ * index live: elements added or removed later, like the ones created
+ * by decodebin, show up or go away.
+ */
 static GstdReturnCode
 gstd_pipeline_fill_elements (GstdPipeline * self, GstElement * element)
 {
-  GstPipeline *pipe;
   GstIterator *it;
   GValue item = G_VALUE_INIT;
   GstElement *gste;
   gboolean done;
-  GstdElement *gstd_element;
   gint resync_count = 0;
 
   g_return_val_if_fail (GSTD_IS_PIPELINE (self), GSTD_NULL_ARGUMENT);
@@ -595,9 +833,17 @@ gstd_pipeline_fill_elements (GstdPipeline * self, GstElement * element)
   if (!GST_IS_PIPELINE (element))
     goto singleelement;
 
-  pipe = GST_PIPELINE (element);
+#if GST_VERSION_MINOR >= 10
+  /* Watch first, so nothing added meanwhile is missed. Elements seen
+   * twice are only indexed once */
+  self->element_added_id = g_signal_connect (element, "deep-element-added",
+      G_CALLBACK (gstd_pipeline_on_element_added), self);
+  self->element_removed_id = g_signal_connect (element,
+      "deep-element-removed", G_CALLBACK (gstd_pipeline_on_element_removed),
+      self);
+#endif
 
-  it = gst_bin_iterate_elements (GST_BIN (pipe));
+  it = gst_bin_iterate_recurse (GST_BIN (element));
   if (!it)
     goto noiter;
 
@@ -607,11 +853,7 @@ gstd_pipeline_fill_elements (GstdPipeline * self, GstElement * element)
     switch (gst_iterator_next (it, &item)) {
       case GST_ITERATOR_OK:
         gste = g_value_get_object (&item);
-        GST_LOG_OBJECT (self, "Saving element \"%s\"", GST_OBJECT_NAME (gste));
-
-        gstd_element = g_object_new (GSTD_TYPE_ELEMENT, "name",
-            GST_OBJECT_NAME (gste), "gstelement", gste, NULL);
-        gstd_list_append_child (self->elements, GSTD_OBJECT (gstd_element));
+        gstd_pipeline_index_element (self, gste);
 
         g_value_reset (&item);
         /* Reset resync count on successful iteration */
@@ -688,3 +930,10 @@ gstd_pipeline_get_element (GstdPipeline * self)
   g_return_val_if_fail (self, NULL);
   return self->pipeline;
 }
+
+GstdMetricsPipeline *
+gstd_pipeline_get_metrics (GstdPipeline * self)
+{
+  g_return_val_if_fail (self, NULL);
+  return self->metrics;
+}
@@ -24,6 +24,7 @@
 #include <glib-object.h>
 
 #include "gstd_object.h"
+#include "gstd_metrics.h"
 
 G_BEGIN_DECLS
 /*
@@ -74,5 +75,14 @@ GstdReturnCode gstd_pipeline_decrement_refcount (GstdPipeline * self);
  **/
 GstElement *gstd_pipeline_get_element (GstdPipeline * self);
 
+/**
+ * Get the counters exported by the metrics resource
+ *
+ * \param self GstdPipeline object
+ *
+ * \return The counters, or NULL if not built. Does not add a reference.
+ **/
+GstdMetricsPipeline *gstd_pipeline_get_metrics (GstdPipeline * self);
+
 G_END_DECLS
 #endif // __GSTD_PIPELINE_H__
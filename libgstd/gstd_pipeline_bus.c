@@ -22,6 +22,7 @@
 #include "config.h"
 #endif
 #include "gstd_pipeline_bus.h"
+#include "gstd_bus_msg.h"
 #include "gstd_msg_reader.h"
 #include "gstd_msg_type.h"
 
@@ -30,10 +31,32 @@ enum
   PROP_MESSAGE = 1,
   PROP_TIMEOUT,
   PROP_TYPES,
+  PROP_LAST_SEQ,
+  PROP_MAX_MESSAGES,
+  PROP_MAX_AGE,
+  PROP_KEEP_LAST_ERROR,
+  PROP_DROPPED,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
 
+typedef struct _GstdPipelineBusSubscription
+{
+  guint id;
+  gint types;
+  GstdPipelineBusFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+} GstdPipelineBusSubscription;
+
+typedef struct _GstdPipelineBusWaiter
+{
+  guint id;
+  gint types;
+  GstdPipelineBusPopFunc func;
+  gpointer user_data;
+} GstdPipelineBusWaiter;
+
 struct _GstdPipelineBus
 {
   GstdObject parent;
@@ -42,6 +65,32 @@ struct _GstdPipelineBus
   gint64 timeout;
   gint types;
 
+  /* Every message is drained from the bus into the ring, the ones
+   * retained go from first_seq to last_seq and the one with sequence
+   * number n lives at ring[n % size]. Readers keep their own position,
+   * except for the "message" resource which shares cursor. Everything
+   * below is protected by lock. */
+  GMutex lock;
+  GCond arrived;
+  GstMessage **ring;
+  gint64 *arrival;
+  guint size;
+  guint64 first_seq;
+  guint64 last_seq;
+  guint64 cursor;
+
+  /* Retention, messages beyond max_age ns are dropped too */
+  guint64 max_age;
+  gboolean keep_last_error;
+  GstMessage *last_error;
+  GHashTable *dropped;
+
+  GList *subscriptions;
+  /* Parked pops take the message, parked read_since only peek */
+  GList *waiters;
+  GList *readers;
+  guint next_id;
+  gboolean closed;
 };
 
 struct _GstdPipelineBusClass
@@ -55,6 +104,11 @@ static void
 gstd_pipeline_bus_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec);
 static void gstd_pipeline_bus_dispose (GObject *);
+static void gstd_pipeline_bus_finalize (GObject *);
+static GstBusSyncReply gstd_pipeline_bus_drain (GstBus * bus,
+    GstMessage * message, gpointer user_data);
+static void gstd_pipeline_bus_resize (GstdPipelineBus * self, guint size);
+static gchar *gstd_pipeline_bus_dropped_to_string (GstdPipelineBus * self);
 
 G_DEFINE_TYPE (GstdPipelineBus, gstd_pipeline_bus, GSTD_TYPE_OBJECT);
 
@@ -66,6 +120,13 @@ GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_bus_debug);
 #define GSTD_PIPELINE_BUS_TIMEOUT_MIN -1
 #define GSTD_PIPELINE_BUS_TIMEOUT_MAX G_MAXINT64
 #define GSTD_PIPELINE_BUS_TYPES_DEFAULT (GST_MESSAGE_ERROR | GST_MESSAGE_WARNING | GST_MESSAGE_INFO)
+#define GSTD_PIPELINE_BUS_MAX_MESSAGES_MAX 65536
+#define GSTD_PIPELINE_BUS_MAX_AGE_DEFAULT 0
+#define GSTD_PIPELINE_BUS_KEEP_LAST_ERROR_DEFAULT TRUE
+
+/* The pipeline bus owning a GstBus, to find its messages from the
+ * pipeline state */
+#define GSTD_PIPELINE_BUS_QUARK g_quark_from_static_string ("gstd-pipeline-bus")
 
 static void
 gstd_pipeline_bus_class_init (GstdPipelineBusClass * klass)
@@ -77,6 +138,7 @@ gstd_pipeline_bus_class_init (GstdPipelineBusClass * klass)
   object_class->set_property = gstd_pipeline_bus_set_property;
   object_class->get_property = gstd_pipeline_bus_get_property;
   object_class->dispose = gstd_pipeline_bus_dispose;
+  object_class->finalize = gstd_pipeline_bus_finalize;
 
   properties[PROP_MESSAGE] =
       g_param_spec_object ("message",
@@ -101,6 +163,39 @@ gstd_pipeline_bus_class_init (GstdPipelineBusClass * klass)
       GSTD_PIPELINE_BUS_TYPES_DEFAULT,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_LAST_SEQ] =
+      g_param_spec_uint64 ("last-seq",
+      "Last Sequence",
+      "The sequence number of the newest message, 0 if none arrived yet",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_MAX_MESSAGES] =
+      g_param_spec_uint ("max-messages",
+      "Max Messages",
+      "The amount of messages retained for the readers, the oldest are dropped",
+      1, GSTD_PIPELINE_BUS_MAX_MESSAGES_MAX, GSTD_PIPELINE_BUS_RING_SIZE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_MAX_AGE] =
+      g_param_spec_uint64 ("max-age",
+      "Max Age",
+      "Nanoseconds after which retained messages are dropped, 0: no limit",
+      0, G_MAXUINT64, GSTD_PIPELINE_BUS_MAX_AGE_DEFAULT,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_KEEP_LAST_ERROR] =
+      g_param_spec_boolean ("keep-last-error",
+      "Keep Last Error",
+      "Keep the latest error message after it is dropped, to report failures",
+      GSTD_PIPELINE_BUS_KEEP_LAST_ERROR_DEFAULT,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_DROPPED] =
+      g_param_spec_string ("dropped",
+      "Dropped",
+      "The amount of messages dropped by the retention policy, per type",
+      NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -116,6 +211,23 @@ gstd_pipeline_bus_init (GstdPipelineBus * self)
 
   self->timeout = GSTD_PIPELINE_BUS_TIMEOUT_DEFAULT;
   self->types = GSTD_PIPELINE_BUS_TYPES_DEFAULT;
+  self->size = GSTD_PIPELINE_BUS_RING_SIZE;
+  self->ring = g_new0 (GstMessage *, self->size);
+  self->arrival = g_new0 (gint64, self->size);
+  self->first_seq = 1;
+  self->last_seq = 0;
+  self->cursor = 0;
+  self->max_age = GSTD_PIPELINE_BUS_MAX_AGE_DEFAULT;
+  self->keep_last_error = GSTD_PIPELINE_BUS_KEEP_LAST_ERROR_DEFAULT;
+  self->last_error = NULL;
+  self->dropped = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+  self->subscriptions = NULL;
+  self->waiters = NULL;
+  self->readers = NULL;
+  self->next_id = 1;
+  self->closed = FALSE;
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->arrived);
 
   gstd_object_set_reader (GSTD_OBJECT (self),
       g_object_new (GSTD_TYPE_MSG_READER, NULL));
@@ -132,6 +244,10 @@ gstd_pipeline_bus_new (GstBus * bus)
   self = GSTD_PIPELINE_BUS (g_object_new (GSTD_TYPE_PIPELINE_BUS, NULL));
   self->bus = G_OBJECT (bus);
 
+  /* Nothing is left queued in the bus, it all goes to the ring */
+  g_object_set_qdata (self->bus, GSTD_PIPELINE_BUS_QUARK, self);
+  gst_bus_set_sync_handler (bus, gstd_pipeline_bus_drain, self, NULL);
+
   return self;
 }
 
@@ -151,6 +267,30 @@ gstd_pipeline_bus_set_property (GObject * object,
       self->types = g_value_get_flags (value);
       GST_INFO_OBJECT (self, "Types changed to: 0x%x", self->types);
       break;
+    case PROP_MAX_MESSAGES:
+      g_mutex_lock (&self->lock);
+      gstd_pipeline_bus_resize (self, g_value_get_uint (value));
+      g_mutex_unlock (&self->lock);
+      GST_INFO_OBJECT (self, "Max messages changed to: %u", self->size);
+      break;
+    case PROP_MAX_AGE:
+      g_mutex_lock (&self->lock);
+      self->max_age = g_value_get_uint64 (value);
+      g_mutex_unlock (&self->lock);
+      GST_INFO_OBJECT (self, "Max age changed to: %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (self->max_age));
+      break;
+    case PROP_KEEP_LAST_ERROR:
+      g_mutex_lock (&self->lock);
+      self->keep_last_error = g_value_get_boolean (value);
+      if (!self->keep_last_error && self->last_error) {
+        gst_message_unref (self->last_error);
+        self->last_error = NULL;
+      }
+      g_mutex_unlock (&self->lock);
+      GST_INFO_OBJECT (self, "Keep last error changed to: %d",
+          self->keep_last_error);
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -179,6 +319,25 @@ gstd_pipeline_bus_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning types 0x%x", self->types);
       g_value_set_flags (value, self->types);
       break;
+    case PROP_LAST_SEQ:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint64 (value, self->last_seq);
+      g_mutex_unlock (&self->lock);
+      break;
+    case PROP_MAX_MESSAGES:
+      g_value_set_uint (value, self->size);
+      break;
+    case PROP_MAX_AGE:
+      g_value_set_uint64 (value, self->max_age);
+      break;
+    case PROP_KEEP_LAST_ERROR:
+      g_value_set_boolean (value, self->keep_last_error);
+      break;
+    case PROP_DROPPED:
+      g_mutex_lock (&self->lock);
+      g_value_take_string (value, gstd_pipeline_bus_dropped_to_string (self));
+      g_mutex_unlock (&self->lock);
+      break;
     default:
       /* We don't have any other property... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -193,11 +352,42 @@ gstd_pipeline_bus_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s pipeline bus", GSTD_OBJECT_NAME (self));
 
+  if (self->bus) {
+    gstd_pipeline_bus_close (self);
+    gst_bus_set_sync_handler (GST_BUS (self->bus), NULL, NULL, NULL);
+    g_object_set_qdata (self->bus, GSTD_PIPELINE_BUS_QUARK, NULL);
+  }
+
   g_clear_object (&self->bus);
 
   G_OBJECT_CLASS (gstd_pipeline_bus_parent_class)->dispose (object);
 }
 
+static void
+gstd_pipeline_bus_finalize (GObject * object)
+{
+  GstdPipelineBus *self = GSTD_PIPELINE_BUS (object);
+  guint i;
+
+  for (i = 0; i < self->size; i++) {
+    if (self->ring[i]) {
+      gst_message_unref (self->ring[i]);
+    }
+  }
+  g_free (self->ring);
+  g_free (self->arrival);
+
+  if (self->last_error) {
+    gst_message_unref (self->last_error);
+  }
+  g_hash_table_unref (self->dropped);
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->arrived);
+
+  G_OBJECT_CLASS (gstd_pipeline_bus_parent_class)->finalize (object);
+}
+
 GstBus *
 gstd_pipeline_bus_get_bus (GstdPipelineBus * self)
 {
@@ -205,3 +395,699 @@ gstd_pipeline_bus_get_bus (GstdPipelineBus * self)
 
   return gst_object_ref (self->bus);
 }
+
+/* Must be called with the lock held */
+static GstMessage *
+gstd_pipeline_bus_at (GstdPipelineBus * self, guint64 seq)
+{
+  return self->ring[seq % self->size];
+}
+
+/* Must be called with the lock held */
+static gchar *
+gstd_pipeline_bus_dropped_to_string (GstdPipelineBus * self)
+{
+  GstStructure *structure;
+  GHashTableIter iter;
+  gpointer type;
+  gpointer count;
+  gchar *string;
+
+  structure = gst_structure_new_empty ("dropped");
+
+  g_hash_table_iter_init (&iter, self->dropped);
+  while (g_hash_table_iter_next (&iter, &type, &count)) {
+    gst_structure_set (structure,
+        gst_message_type_get_name (GPOINTER_TO_UINT (type)), G_TYPE_UINT64,
+        *(guint64 *) count, NULL);
+  }
+
+  string = gst_structure_to_string (structure);
+  gst_structure_free (structure);
+
+  return string;
+}
+
+/*
+ * Drops the oldest retained message, counting it by type. Must be
+ * called with the lock held and at least one message retained.
+ */
+static void
+gstd_pipeline_bus_drop_oldest (GstdPipelineBus * self)
+{
+  GstMessage **slot;
+  guint64 *count;
+  GstMessageType type;
+
+  slot = &self->ring[self->first_seq % self->size];
+  type = GST_MESSAGE_TYPE (*slot);
+
+  count = g_hash_table_lookup (self->dropped, GUINT_TO_POINTER (type));
+  if (NULL == count) {
+    count = g_new0 (guint64, 1);
+    g_hash_table_insert (self->dropped, GUINT_TO_POINTER (type), count);
+  }
+  (*count)++;
+
+  if (GST_MESSAGE_ERROR == type && self->keep_last_error) {
+    if (self->last_error) {
+      gst_message_unref (self->last_error);
+    }
+    self->last_error = *slot;
+  } else {
+    gst_message_unref (*slot);
+  }
+
+  *slot = NULL;
+  self->first_seq++;
+}
+
+/* Drops the messages older than max-age, must be called with the lock held */
+static void
+gstd_pipeline_bus_expire (GstdPipelineBus * self)
+{
+  gint64 now;
+  gint64 oldest;
+
+  now = g_get_monotonic_time ();
+  if (0 == self->max_age || GST_TIME_AS_USECONDS (self->max_age) >= now) {
+    return;
+  }
+
+  oldest = now - GST_TIME_AS_USECONDS (self->max_age);
+  while (self->first_seq <= self->last_seq
+      && self->arrival[self->first_seq % self->size] < oldest) {
+    gstd_pipeline_bus_drop_oldest (self);
+  }
+}
+
+/*
+ * Moves the retained messages to a ring of @size, dropping the oldest
+ * ones if they don't fit. Must be called with the lock held.
+ */
+static void
+gstd_pipeline_bus_resize (GstdPipelineBus * self, guint size)
+{
+  GstMessage **ring;
+  gint64 *arrival;
+  guint64 seq;
+
+  while (self->last_seq - self->first_seq + 1 > size) {
+    gstd_pipeline_bus_drop_oldest (self);
+  }
+
+  ring = g_new0 (GstMessage *, size);
+  arrival = g_new0 (gint64, size);
+  for (seq = self->first_seq; seq <= self->last_seq; seq++) {
+    ring[seq % size] = self->ring[seq % self->size];
+    arrival[seq % size] = self->arrival[seq % self->size];
+  }
+
+  g_free (self->ring);
+  g_free (self->arrival);
+  self->ring = ring;
+  self->arrival = arrival;
+  self->size = size;
+}
+
+/*
+ * Runs in the thread posting @message, so the bus never queues
+ * anything. Stores it, dropping the oldest one once the ring is full,
+ * and hands it to the subscribers.
+ */
+static GstBusSyncReply
+gstd_pipeline_bus_drain (GstBus * bus, GstMessage * message,
+    gpointer user_data)
+{
+  GstdPipelineBus *self = GSTD_PIPELINE_BUS (user_data);
+  GstdPipelineBusSubscription *sub;
+  GstdPipelineBusWaiter *waiter;
+  GList *iter;
+  GList *next;
+
+  g_mutex_lock (&self->lock);
+
+  gstd_pipeline_bus_expire (self);
+  if (self->last_seq - self->first_seq + 1 == self->size) {
+    gstd_pipeline_bus_drop_oldest (self);
+  }
+
+  self->last_seq++;
+  self->ring[self->last_seq % self->size] = gst_message_ref (message);
+  self->arrival[self->last_seq % self->size] = g_get_monotonic_time ();
+
+  for (iter = self->subscriptions; iter; iter = iter->next) {
+    sub = iter->data;
+    if (GST_MESSAGE_TYPE (message) & sub->types) {
+      sub->func (self, message, self->last_seq, sub->user_data);
+    }
+  }
+
+  /* Parked readers share the cursor, so the message is skipped unless
+   * the first one interested takes it */
+  if (self->waiters) {
+    self->cursor = self->last_seq;
+  }
+  for (iter = self->waiters; iter; iter = iter->next) {
+    waiter = iter->data;
+    if (GST_MESSAGE_TYPE (message) & waiter->types) {
+      self->waiters = g_list_delete_link (self->waiters, iter);
+      waiter->func (self, message, waiter->user_data);
+      g_free (waiter);
+      break;
+    }
+  }
+
+  /* Readers with a cursor of their own all get it */
+  for (iter = self->readers; iter; iter = next) {
+    next = iter->next;
+    waiter = iter->data;
+    if (GST_MESSAGE_TYPE (message) & waiter->types) {
+      self->readers = g_list_delete_link (self->readers, iter);
+      waiter->func (self, message, waiter->user_data);
+      g_free (waiter);
+    }
+  }
+
+  g_cond_broadcast (&self->arrived);
+  g_mutex_unlock (&self->lock);
+
+  return GST_BUS_DROP;
+}
+
+static void
+gstd_pipeline_bus_subscription_free (gpointer data)
+{
+  GstdPipelineBusSubscription *sub = data;
+
+  if (sub->notify) {
+    sub->notify (sub->user_data);
+  }
+  g_free (sub);
+}
+
+guint
+gstd_pipeline_bus_subscribe (GstdPipelineBus * self, gint types,
+    guint64 since, GstdPipelineBusFunc func, gpointer user_data,
+    GDestroyNotify notify)
+{
+  GstdPipelineBusSubscription *sub;
+  GstMessage *message;
+  guint64 seq;
+  guint id = 0;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), 0);
+  g_return_val_if_fail (func, 0);
+
+  g_mutex_lock (&self->lock);
+
+  if (self->closed) {
+    GST_WARNING_OBJECT (self, "Unable to subscribe, the pipeline is gone");
+    goto out;
+  }
+
+  /* Catch up from the ring, nothing can slip in between */
+  if (GSTD_PIPELINE_BUS_SEQ_NONE != since) {
+    gstd_pipeline_bus_expire (self);
+    for (seq = MAX (since + 1, self->first_seq);
+        seq <= self->last_seq; seq++) {
+      message = gstd_pipeline_bus_at (self, seq);
+      if (GST_MESSAGE_TYPE (message) & types) {
+        func (self, message, seq, user_data);
+      }
+    }
+  }
+
+  sub = g_new0 (GstdPipelineBusSubscription, 1);
+  sub->id = id = self->next_id++;
+  sub->types = types;
+  sub->func = func;
+  sub->user_data = user_data;
+  sub->notify = notify;
+  self->subscriptions = g_list_append (self->subscriptions, sub);
+
+  GST_INFO_OBJECT (self, "New subscription %u for types 0x%x", id, types);
+
+out:
+  g_mutex_unlock (&self->lock);
+  return id;
+}
+
+void
+gstd_pipeline_bus_unsubscribe (GstdPipelineBus * self, guint id)
+{
+  GstdPipelineBusSubscription *sub = NULL;
+  GList *iter;
+
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (self));
+
+  g_mutex_lock (&self->lock);
+  for (iter = self->subscriptions; iter; iter = iter->next) {
+    if (((GstdPipelineBusSubscription *) iter->data)->id == id) {
+      sub = iter->data;
+      self->subscriptions = g_list_delete_link (self->subscriptions, iter);
+      break;
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  /* Already gone if the bus was closed */
+  if (sub) {
+    GST_INFO_OBJECT (self, "Removed subscription %u", id);
+    gstd_pipeline_bus_subscription_free (sub);
+  }
+}
+
+GstMessage *
+gstd_pipeline_bus_next (GstdPipelineBus * self, guint64 * seq, gint types,
+    guint64 * lost)
+{
+  GstMessage *message = NULL;
+  GstMessage *candidate;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), NULL);
+  g_return_val_if_fail (seq, NULL);
+  g_return_val_if_fail (lost, NULL);
+
+  *lost = 0;
+
+  g_mutex_lock (&self->lock);
+  gstd_pipeline_bus_expire (self);
+
+  /* A cursor ahead of the ring, from before a restart, starts over
+   * with new messages */
+  *seq = MIN (*seq, self->last_seq);
+  if (*seq + 1 < self->first_seq) {
+    *lost = self->first_seq - *seq - 1;
+    *seq = self->first_seq - 1;
+    goto out;
+  }
+
+  while (*seq < self->last_seq) {
+    (*seq)++;
+    candidate = gstd_pipeline_bus_at (self, *seq);
+    if (GST_MESSAGE_TYPE (candidate) & types) {
+      message = gst_message_ref (candidate);
+      break;
+    }
+  }
+
+out:
+  g_mutex_unlock (&self->lock);
+  return message;
+}
+
+void
+gstd_pipeline_bus_close (GstdPipelineBus * self)
+{
+  GstdPipelineBusSubscription *sub;
+  GstdPipelineBusWaiter *waiter;
+  GList *subscriptions;
+  GList *waiters;
+  GList *iter;
+
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (self));
+
+  g_mutex_lock (&self->lock);
+  self->closed = TRUE;
+  subscriptions = self->subscriptions;
+  self->subscriptions = NULL;
+  waiters = g_list_concat (self->waiters, self->readers);
+  self->waiters = self->readers = NULL;
+
+  for (iter = subscriptions; iter; iter = iter->next) {
+    sub = iter->data;
+    sub->func (self, NULL, self->last_seq, sub->user_data);
+  }
+
+  for (iter = waiters; iter; iter = iter->next) {
+    waiter = iter->data;
+    waiter->func (self, NULL, waiter->user_data);
+  }
+  g_list_free_full (waiters, g_free);
+
+  /* Blocked readers give up */
+  g_cond_broadcast (&self->arrived);
+  g_mutex_unlock (&self->lock);
+
+  g_list_free_full (subscriptions, gstd_pipeline_bus_subscription_free);
+}
+
+/*
+ * Turns a timeout in nanoseconds into the deadline taken by
+ * gstd_pipeline_bus_wait(), -1 still meaning forever and 0 not waiting
+ */
+static gint64
+gstd_pipeline_bus_deadline (gint64 timeout)
+{
+  if (timeout <= 0) {
+    return timeout;
+  }
+
+  return g_get_monotonic_time () + GST_TIME_AS_USECONDS (timeout);
+}
+
+/*
+ * Waits until a message newer than @seq arrives or @deadline passes.
+ * Must be called with the lock held, returns FALSE if none did.
+ */
+static gboolean
+gstd_pipeline_bus_wait (GstdPipelineBus * self, guint64 seq, gint64 deadline)
+{
+  while (self->last_seq <= seq && !self->closed) {
+    if (0 == deadline) {
+      return FALSE;
+    } else if (deadline < 0) {
+      g_cond_wait (&self->arrived, &self->lock);
+    } else if (!g_cond_wait_until (&self->arrived, &self->lock, deadline)) {
+      break;
+    }
+  }
+
+  return self->last_seq > seq;
+}
+
+/*
+ * Moves the shared cursor to the next retained message matching
+ * @types, if any. Must be called with the lock held.
+ */
+static GstMessage *
+gstd_pipeline_bus_pop_locked (GstdPipelineBus * self, gint types)
+{
+  GstMessage *candidate;
+
+  gstd_pipeline_bus_expire (self);
+  self->cursor = MAX (self->cursor, self->first_seq - 1);
+
+  /* As with gst_bus_pop_filtered(), the others are skipped */
+  while (self->cursor < self->last_seq) {
+    self->cursor++;
+    candidate = gstd_pipeline_bus_at (self, self->cursor);
+    if (GST_MESSAGE_TYPE (candidate) & types) {
+      return gst_message_ref (candidate);
+    }
+  }
+
+  return NULL;
+}
+
+GstMessage *
+gstd_pipeline_bus_pop (GstdPipelineBus * self, gint types, gint64 timeout)
+{
+  GstMessage *message;
+  gint64 deadline;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), NULL);
+
+  deadline = gstd_pipeline_bus_deadline (timeout);
+
+  g_mutex_lock (&self->lock);
+  message = gstd_pipeline_bus_pop_locked (self, types);
+  while (!message && gstd_pipeline_bus_wait (self, self->cursor, deadline)) {
+    message = gstd_pipeline_bus_pop_locked (self, types);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return message;
+}
+
+GstMessage *
+gstd_pipeline_bus_pop_async (GstdPipelineBus * self, gint types,
+    GstdPipelineBusPopFunc func, gpointer user_data, guint * id)
+{
+  GstdPipelineBusWaiter *waiter;
+  GstMessage *message;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), NULL);
+  g_return_val_if_fail (func, NULL);
+  g_return_val_if_fail (id, NULL);
+
+  *id = 0;
+
+  g_mutex_lock (&self->lock);
+  message = gstd_pipeline_bus_pop_locked (self, types);
+  if (!message && !self->closed) {
+    waiter = g_new0 (GstdPipelineBusWaiter, 1);
+    waiter->id = *id = self->next_id++;
+    waiter->types = types;
+    waiter->func = func;
+    waiter->user_data = user_data;
+    self->waiters = g_list_append (self->waiters, waiter);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return message;
+}
+
+/* Removes the waiter @id from @waiters, returns FALSE if not there */
+static gboolean
+gstd_pipeline_bus_cancel (GstdPipelineBus * self, GList ** waiters, guint id)
+{
+  GList *iter;
+  gboolean found = FALSE;
+
+  g_mutex_lock (&self->lock);
+  for (iter = *waiters; iter; iter = iter->next) {
+    if (((GstdPipelineBusWaiter *) iter->data)->id == id) {
+      g_free (iter->data);
+      *waiters = g_list_delete_link (*waiters, iter);
+      found = TRUE;
+      break;
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  return found;
+}
+
+gboolean
+gstd_pipeline_bus_pop_cancel (GstdPipelineBus * self, guint id)
+{
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), FALSE);
+
+  return gstd_pipeline_bus_cancel (self, &self->waiters, id);
+}
+
+void
+gstd_pipeline_bus_flush (GstdPipelineBus * self, gint64 timeout)
+{
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (self));
+
+  g_mutex_lock (&self->lock);
+  self->cursor = self->last_seq;
+  g_mutex_unlock (&self->lock);
+
+  g_usleep (GST_TIME_AS_USECONDS (timeout));
+
+  g_mutex_lock (&self->lock);
+  self->cursor = self->last_seq;
+  g_mutex_unlock (&self->lock);
+}
+
+GstdReturnCode
+gstd_pipeline_bus_read_since (GstdPipelineBus * self, guint64 since,
+    gint types, guint max, gint64 timeout, gchar ** response)
+{
+  GstdIFormatter *formatter;
+  GPtrArray *messages;
+  GArray *seqs;
+  GstMessage *message;
+  GstdBusMsg *busmsg;
+  GValue value = G_VALUE_INIT;
+  guint64 first;
+  guint64 lost = 0;
+  guint64 seq;
+  gint64 deadline;
+  guint i;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  messages = g_ptr_array_new ();
+  seqs = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  deadline = gstd_pipeline_bus_deadline (timeout);
+
+  /* Only the references are taken under the lock. A cursor ahead of
+   * the ring, from before a restart, starts over with new messages */
+  g_mutex_lock (&self->lock);
+  seq = MIN (since, self->last_seq);
+  while (0 == messages->len && gstd_pipeline_bus_wait (self, seq, deadline)) {
+    gstd_pipeline_bus_expire (self);
+    first = self->first_seq;
+    if (seq + 1 < first) {
+      lost += first - seq - 1;
+      seq = first - 1;
+    }
+
+    while (seq < self->last_seq && messages->len < max) {
+      seq++;
+      message = gstd_pipeline_bus_at (self, seq);
+      if (GST_MESSAGE_TYPE (message) & types) {
+        g_ptr_array_add (messages, gst_message_ref (message));
+        g_array_append_val (seqs, seq);
+      }
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  formatter = gstd_object_new_formatter (GSTD_OBJECT (self));
+  gstd_iformatter_begin_object (formatter);
+
+  /* Where the next read should start from */
+  g_value_init (&value, G_TYPE_UINT64);
+  g_value_set_uint64 (&value, seq);
+  gstd_iformatter_set_member_name (formatter, "next");
+  gstd_iformatter_set_value (formatter, &value);
+
+  /* Messages overwritten before they could be read */
+  g_value_set_uint64 (&value, lost);
+  gstd_iformatter_set_member_name (formatter, "lost");
+  gstd_iformatter_set_value (formatter, &value);
+
+  gstd_iformatter_set_member_name (formatter, "messages");
+  gstd_iformatter_begin_array (formatter);
+  for (i = 0; i < messages->len; i++) {
+    gstd_iformatter_begin_object (formatter);
+
+    g_value_set_uint64 (&value, g_array_index (seqs, guint64, i));
+    gstd_iformatter_set_member_name (formatter, "seq");
+    gstd_iformatter_set_value (formatter, &value);
+
+    /* The bus message takes the reference */
+    busmsg = gstd_bus_msg_factory_make (g_ptr_array_index (messages, i));
+    gstd_bus_msg_serialize (busmsg, formatter);
+    g_object_unref (busmsg);
+
+    gstd_iformatter_end_object (formatter);
+  }
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_generate (formatter, response);
+
+  g_value_unset (&value);
+  g_object_unref (formatter);
+  g_ptr_array_unref (messages);
+  g_array_unref (seqs);
+
+  return GSTD_EOK;
+}
+
+guint
+gstd_pipeline_bus_read_since_async (GstdPipelineBus * self, guint64 since,
+    gint types, GstdPipelineBusPopFunc func, gpointer user_data)
+{
+  GstdPipelineBusWaiter *waiter;
+  guint64 seq;
+  guint id = 0;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), 0);
+  g_return_val_if_fail (func, 0);
+
+  g_mutex_lock (&self->lock);
+  if (self->closed) {
+    goto out;
+  }
+
+  /* Same starting point as gstd_pipeline_bus_read_since() */
+  gstd_pipeline_bus_expire (self);
+  seq = MAX (MIN (since, self->last_seq), self->first_seq - 1);
+  while (seq < self->last_seq) {
+    seq++;
+    if (GST_MESSAGE_TYPE (gstd_pipeline_bus_at (self, seq)) & types) {
+      goto out;
+    }
+  }
+
+  waiter = g_new0 (GstdPipelineBusWaiter, 1);
+  waiter->id = id = self->next_id++;
+  waiter->types = types;
+  waiter->func = func;
+  waiter->user_data = user_data;
+  self->readers = g_list_append (self->readers, waiter);
+
+out:
+  g_mutex_unlock (&self->lock);
+  return id;
+}
+
+gboolean
+gstd_pipeline_bus_read_since_cancel (GstdPipelineBus * self, guint id)
+{
+  g_return_val_if_fail (GSTD_IS_PIPELINE_BUS (self), FALSE);
+
+  return gstd_pipeline_bus_cancel (self, &self->readers, id);
+}
+
+GstMessage *
+gstd_pipeline_bus_find_last (GstBus * bus, gint types)
+{
+  GstdPipelineBus *self;
+  GstMessage *message = NULL;
+  guint64 seq;
+
+  g_return_val_if_fail (GST_IS_BUS (bus), NULL);
+
+  self = g_object_get_qdata (G_OBJECT (bus), GSTD_PIPELINE_BUS_QUARK);
+  if (NULL == self) {
+    return NULL;
+  }
+
+  g_mutex_lock (&self->lock);
+  for (seq = self->last_seq; seq >= self->first_seq && seq > 0; seq--) {
+    if (GST_MESSAGE_TYPE (gstd_pipeline_bus_at (self, seq)) & types) {
+      message = gst_message_ref (gstd_pipeline_bus_at (self, seq));
+      break;
+    }
+  }
+
+  /* Dropped already, but kept around */
+  if (!message && self->last_error && (types & GST_MESSAGE_ERROR)) {
+    message = gst_message_ref (self->last_error);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return message;
+}
+
+gboolean
+gstd_pipeline_bus_parse_types (const gchar * types, gint * out)
+{
+  GValue value = G_VALUE_INIT;
+  gboolean ret;
+
+  g_return_val_if_fail (types, FALSE);
+  g_return_val_if_fail (out, FALSE);
+
+  g_value_init (&value, GSTD_TYPE_MSG_TYPE);
+  ret = gst_value_deserialize (&value, types);
+  if (ret) {
+    *out = g_value_get_flags (&value);
+  }
+  g_value_unset (&value);
+
+  return ret;
+}
+
+gboolean
+gstd_pipeline_bus_parse_seq (const gchar * seq, guint64 * out)
+{
+  gchar *end = NULL;
+  guint64 parsed;
+
+  g_return_val_if_fail (seq, FALSE);
+  g_return_val_if_fail (out, FALSE);
+
+  if (!g_ascii_isdigit (seq[0])) {
+    return FALSE;
+  }
+
+  parsed = g_ascii_strtoull (seq, &end, 10);
+  if ('\0' != *end || GSTD_PIPELINE_BUS_SEQ_NONE == parsed) {
+    return FALSE;
+  }
+
+  *out = parsed;
+  return TRUE;
+}
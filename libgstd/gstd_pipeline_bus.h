@@ -56,6 +56,237 @@ GstdPipelineBus *gstd_pipeline_bus_new (GstBus * bus);
 
 GstBus *gstd_pipeline_bus_get_bus (GstdPipelineBus * self);
 
+/**
+ * GSTD_PIPELINE_BUS_RING_SIZE:
+ *
+ * How many of the latest messages are kept for the readers by
+ * default, see the "max-messages" property. Once full, new messages
+ * drop the oldest ones.
+ */
+#define GSTD_PIPELINE_BUS_RING_SIZE 256
+
+/**
+ * GSTD_PIPELINE_BUS_SEQ_NONE:
+ *
+ * Subscribes without replaying the messages already kept.
+ */
+#define GSTD_PIPELINE_BUS_SEQ_NONE G_MAXUINT64
+
+/**
+ * GstdPipelineBusFunc:
+ * @self: The pipeline bus the message was posted on
+ * @message: (nullable): The posted message, NULL once the pipeline is
+ * gone and no more messages will follow
+ * @seq: The sequence number of @message, starting at 1
+ * @user_data: The data given on subscription
+ *
+ * Runs in the thread that posted @message, usually a streaming
+ * thread, with the subscriptions locked. It should only wake the
+ * subscriber, which pulls the messages itself, and must not
+ * (un)subscribe.
+ */
+typedef void (*GstdPipelineBusFunc) (GstdPipelineBus * self,
+    GstMessage * message, guint64 seq, gpointer user_data);
+
+/**
+ * gstd_pipeline_bus_subscribe:
+ * @self: The pipeline bus to listen to
+ * @types: The #GstMessageType mask of the messages of interest
+ * @since: Replay the kept messages newer than this sequence number
+ * first, or #GSTD_PIPELINE_BUS_SEQ_NONE
+ * @func: Called for every message matching @types
+ * @user_data: Data to pass to @func
+ * @notify: (nullable): Destroys @user_data once the subscription is
+ * gone
+ *
+ * Delivers the messages as they are posted, next to the other readers,
+ * which still get them.
+ *
+ * Returns: The subscription id, 0 if the pipeline is already gone.
+ */
+guint gstd_pipeline_bus_subscribe (GstdPipelineBus * self, gint types,
+    guint64 since, GstdPipelineBusFunc func, gpointer user_data,
+    GDestroyNotify notify);
+
+void gstd_pipeline_bus_unsubscribe (GstdPipelineBus * self, guint id);
+
+/**
+ * gstd_pipeline_bus_next:
+ * @self: The pipeline bus
+ * @seq: (inout): The sequence number of the last message seen, moved
+ * past the one returned
+ * @types: The #GstMessageType mask of the messages of interest
+ * @lost: (out): The messages dropped from the ring before being read
+ *
+ * Reads with a cursor of its own, without waiting. Subscribers use it
+ * to pull the messages once woken instead of queueing them, so a slow
+ * one never holds more than the ring does.
+ *
+ * Returns: (transfer full) (nullable): The next message matching
+ * @types, NULL if there is none yet or if some were lost, in which
+ * case @seq is moved to the oldest one retained.
+ */
+GstMessage *gstd_pipeline_bus_next (GstdPipelineBus * self, guint64 * seq,
+    gint types, guint64 * lost);
+
+/**
+ * gstd_pipeline_bus_close:
+ * @self: The pipeline bus
+ *
+ * Ends every subscription, notifying them with a NULL message. Called
+ * when the pipeline is deleted.
+ */
+void gstd_pipeline_bus_close (GstdPipelineBus * self);
+
+/**
+ * gstd_pipeline_bus_pop:
+ * @self: The pipeline bus
+ * @types: The #GstMessageType mask of the messages of interest
+ * @timeout: Nanoseconds to wait for one, -1 to wait forever
+ *
+ * Reads the next message using the cursor shared by the "message"
+ * resource, skipping the ones not matching @types.
+ *
+ * Returns: (transfer full) (nullable): The message, NULL on timeout or
+ * if the pipeline is gone.
+ */
+GstMessage *gstd_pipeline_bus_pop (GstdPipelineBus * self, gint types,
+    gint64 timeout);
+
+/**
+ * GstdPipelineBusPopFunc:
+ * @self: The pipeline bus
+ * @message: (nullable): The message read, NULL if the pipeline is gone
+ * @user_data: The data given to gstd_pipeline_bus_pop_async()
+ *
+ * Runs in the thread that posted @message with the bus locked, it
+ * should only hand the message over.
+ */
+typedef void (*GstdPipelineBusPopFunc) (GstdPipelineBus * self,
+    GstMessage * message, gpointer user_data);
+
+/**
+ * gstd_pipeline_bus_pop_async:
+ * @self: The pipeline bus
+ * @types: The #GstMessageType mask of the messages of interest
+ * @func: Called once with the next message matching @types
+ * @user_data: Data to pass to @func
+ * @id: (out): The id to cancel the read with, 0 if it is not pending
+ *
+ * Like gstd_pipeline_bus_pop() without blocking: if no message is
+ * there yet, the read is parked until one is posted and no thread is
+ * held meanwhile.
+ *
+ * Returns: (transfer full) (nullable): The message if there was one
+ * already, in which case @func won't be called.
+ */
+GstMessage *gstd_pipeline_bus_pop_async (GstdPipelineBus * self,
+    gint types, GstdPipelineBusPopFunc func, gpointer user_data, guint * id);
+
+/**
+ * gstd_pipeline_bus_pop_cancel:
+ * @self: The pipeline bus
+ * @id: The id given by gstd_pipeline_bus_pop_async()
+ *
+ * Returns: TRUE if the read was still parked, FALSE if its function
+ * was already called.
+ */
+gboolean gstd_pipeline_bus_pop_cancel (GstdPipelineBus * self, guint id);
+
+/**
+ * gstd_pipeline_bus_flush:
+ * @self: The pipeline bus
+ * @timeout: Nanoseconds during which messages are discarded
+ *
+ * Skips the shared cursor past every message posted until @timeout
+ * expires. Other readers are not affected.
+ */
+void gstd_pipeline_bus_flush (GstdPipelineBus * self, gint64 timeout);
+
+/**
+ * gstd_pipeline_bus_read_since:
+ * @self: The pipeline bus
+ * @since: The sequence number of the last message seen, 0 for all
+ * @types: The #GstMessageType mask of the messages of interest
+ * @max: The maximum amount of messages to return
+ * @timeout: Nanoseconds to wait if there is none yet, -1 to wait
+ * forever
+ * @response: (out): The batch, holding the "next" sequence number to
+ * read from, the "lost" messages overwritten before being read and
+ * the "messages" themselves, each with its "seq"
+ *
+ * Reads with a cursor of its own, so readers don't steal messages from
+ * each other.
+ *
+ * Returns: #GSTD_EOK, even if no message arrived in time.
+ */
+GstdReturnCode gstd_pipeline_bus_read_since (GstdPipelineBus * self,
+    guint64 since, gint types, guint max, gint64 timeout,
+    gchar ** response);
+
+/**
+ * gstd_pipeline_bus_read_since_async:
+ * @self: The pipeline bus
+ * @since: The sequence number of the last message seen
+ * @types: The #GstMessageType mask of the messages of interest
+ * @func: Called once with the first message matching @types posted
+ * from now on
+ * @user_data: Data to pass to @func
+ *
+ * Waits the way gstd_pipeline_bus_read_since() does without holding
+ * the calling thread, the messages are then read with no timeout.
+ * Unlike gstd_pipeline_bus_pop_async(), the message is not taken from
+ * the other readers.
+ *
+ * Returns: The id to cancel the wait with, 0 if a message newer than
+ * @since is already retained or the pipeline is gone, in which case
+ * @func won't be called.
+ */
+guint gstd_pipeline_bus_read_since_async (GstdPipelineBus * self,
+    guint64 since, gint types, GstdPipelineBusPopFunc func,
+    gpointer user_data);
+
+/**
+ * gstd_pipeline_bus_read_since_cancel:
+ * @self: The pipeline bus
+ * @id: The id given by gstd_pipeline_bus_read_since_async()
+ *
+ * Returns: TRUE if the wait was still pending, FALSE if its function
+ * was already called.
+ */
+gboolean gstd_pipeline_bus_read_since_cancel (GstdPipelineBus * self,
+    guint id);
+
+/**
+ * gstd_pipeline_bus_find_last:
+ * @bus: The bus of a gstd pipeline
+ * @types: The #GstMessageType mask of the message to look for
+ *
+ * Returns: (transfer full) (nullable): The newest message kept matching
+ * @types, without consuming it. With "keep-last-error" set, the last
+ * error is found even if it was already dropped.
+ */
+GstMessage *gstd_pipeline_bus_find_last (GstBus * bus, gint types);
+
+/**
+ * gstd_pipeline_bus_parse_types:
+ * @types: Message types as given to the "types" property, ie:
+ * "error+eos"
+ * @out: (out): The resulting #GstMessageType mask
+ *
+ * Returns: TRUE if @types could be parsed.
+ */
+gboolean gstd_pipeline_bus_parse_types (const gchar * types, gint * out);
+
+/**
+ * gstd_pipeline_bus_parse_seq:
+ * @seq: A decimal message sequence number
+ * @out: (out): The parsed sequence number
+ *
+ * Returns: TRUE if @seq could be parsed.
+ */
+gboolean gstd_pipeline_bus_parse_seq (const gchar * seq, guint64 * out);
+
 
 G_END_DECLS
 
@@ -18,9 +18,21 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <string.h>
+
+#include "gstd_list.h"
 #include "gstd_pipeline_creator.h"
 #include "gstd_pipeline.h"
 #include "gstd_property_reader.h"
+#include "gstd_standby.h"
+#include "gstd_template.h"
+
+enum
+{
+  PROP_TEMPLATES = 1,
+  PROP_STANDBY,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
 
 /* Gstd Core debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_creator_debug);
@@ -30,6 +42,9 @@ GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_creator_debug);
 
 static GstdReturnCode gstd_pipeline_creator_create (GstdICreator * iface,
     const gchar * name, const gchar * description, GstdObject ** out);
+static void gstd_pipeline_creator_set_property (GObject *, guint,
+    const GValue *, GParamSpec *);
+static void gstd_pipeline_creator_dispose (GObject *);
 
 typedef struct _GstdPipelineCreatorClass GstdPipelineCreatorClass;
 
@@ -40,6 +55,17 @@ typedef struct _GstdPipelineCreatorClass GstdPipelineCreatorClass;
 struct _GstdPipelineCreator
 {
   GObject parent;
+
+  /**
+   * The templates a description "@template name=value ..." refers to
+   */
+  GstdList *templates;
+
+  /**
+   * The pools pipelines are taken from when they keep the description
+   * ready
+   */
+  GstdList *standby;
 };
 
 struct _GstdPipelineCreatorClass
@@ -61,8 +87,27 @@ G_DEFINE_TYPE_WITH_CODE (GstdPipelineCreator, gstd_pipeline_creator,
 static void
 gstd_pipeline_creator_class_init (GstdPipelineCreatorClass * klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
   guint debug_color;
 
+  object_class->set_property = gstd_pipeline_creator_set_property;
+  object_class->dispose = gstd_pipeline_creator_dispose;
+
+  properties[PROP_TEMPLATES] =
+      g_param_spec_object ("templates", "Templates",
+      "The templates pipelines may be created from",
+      GSTD_TYPE_LIST,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_STANDBY] =
+      g_param_spec_object ("standby", "Standby",
+      "The pools of pipelines kept ready",
+      GSTD_TYPE_LIST,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
   /* Initialize debug category with nice colors */
   debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
   GST_DEBUG_CATEGORY_INIT (gstd_pipeline_creator_debug, "gstdpipelinecreator",
@@ -73,6 +118,99 @@ static void
 gstd_pipeline_creator_init (GstdPipelineCreator * self)
 {
   GST_INFO_OBJECT (self, "Initializing pipeline creator");
+  self->templates = NULL;
+  self->standby = NULL;
+}
+
+static void
+gstd_pipeline_creator_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdPipelineCreator *self = GSTD_PIPELINE_CREATOR (object);
+
+  switch (property_id) {
+    case PROP_TEMPLATES:
+      g_clear_object (&self->templates);
+      self->templates = g_value_dup_object (value);
+      break;
+    case PROP_STANDBY:
+      g_clear_object (&self->standby);
+      self->standby = g_value_dup_object (value);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_pipeline_creator_dispose (GObject * object)
+{
+  GstdPipelineCreator *self = GSTD_PIPELINE_CREATOR (object);
+
+  g_clear_object (&self->templates);
+  g_clear_object (&self->standby);
+
+  G_OBJECT_CLASS (gstd_pipeline_creator_parent_class)->dispose (object);
+}
+
+/* The template named by a "@template name=value ..." description */
+static GstdReturnCode
+gstd_pipeline_creator_find_template (GstdPipelineCreator * self,
+    const gchar * description, GstdObject ** template)
+{
+  gchar *name;
+
+  *template = NULL;
+
+  if ('@' != description[0]) {
+    return GSTD_EOK;
+  }
+
+  name = g_strndup (description + 1, strcspn (description + 1, " "));
+  if (self->templates) {
+    *template = gstd_list_find_child (self->templates, name);
+  }
+
+  if (!*template) {
+    GST_ERROR_OBJECT (self, "No template named \"%s\"", name);
+    g_free (name);
+    return GSTD_NO_RESOURCE;
+  }
+
+  g_free (name);
+
+  return GSTD_EOK;
+}
+
+/* A pipeline parked by one of the standby pools, if any keeps it ready */
+static GstElement *
+gstd_pipeline_creator_claim (GstdPipelineCreator * self,
+    GstdObject * template, const gchar * description)
+{
+  GstElement *prebuilt = NULL;
+  GList *pools;
+  GList *iter;
+
+  if (!self->standby || 0 == self->standby->count) {
+    return NULL;
+  }
+
+  /* Claims may set properties, don't hold the list meanwhile */
+  GST_OBJECT_LOCK (self->standby);
+  pools = g_list_copy_deep (self->standby->nodes.head,
+      (GCopyFunc) g_object_ref, NULL);
+  GST_OBJECT_UNLOCK (self->standby);
+
+  for (iter = pools; iter && !prebuilt; iter = g_list_next (iter)) {
+    prebuilt = gstd_standby_claim (GSTD_STANDBY (iter->data),
+        (GstdTemplate *) template, description);
+  }
+
+  g_list_free_full (pools, g_object_unref);
+
+  return prebuilt;
 }
 
 static GstdReturnCode
@@ -80,6 +218,9 @@ gstd_pipeline_creator_create (GstdICreator * iface, const gchar * name,
     const gchar * description, GstdObject ** out)
 {
   GstdPipeline *pipeline;
+  GstdObject *template;
+  GstElement *prebuilt;
+  GstdReturnCode ret;
   *out = NULL;
 
   g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
@@ -94,9 +235,25 @@ gstd_pipeline_creator_create (GstdICreator * iface, const gchar * name,
     return GSTD_MISSING_ARGUMENT;
   }
 
+  ret = gstd_pipeline_creator_find_template (GSTD_PIPELINE_CREATOR (iface),
+      description, &template);
+  if (ret) {
+    return ret;
+  }
+
+  prebuilt = gstd_pipeline_creator_claim (GSTD_PIPELINE_CREATOR (iface),
+      template, description);
+
   pipeline = g_object_new (GSTD_TYPE_PIPELINE, "name", name, "description",
-      description, NULL);
+      description, "template", template, "prebuilt", prebuilt, NULL);
   *out = GSTD_OBJECT (pipeline);
 
+  if (template) {
+    g_object_unref (template);
+  }
+  if (prebuilt) {
+    gst_object_unref (prebuilt);
+  }
+
   return gstd_pipeline_build (pipeline);
 }
@@ -27,7 +27,9 @@
 #include <string.h>
 
 #include "gstd_list.h"
+#include "gstd_metrics.h"
 #include "gstd_object.h"
+#include "gstd_status.h"
 
 
 /* Gstd Core debugging category */
@@ -36,20 +38,43 @@ GST_DEBUG_CATEGORY_STATIC (gstd_pipeline_deleter_debug);
 
 #define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
 
+/* Pipelines slow to reach NULL don't hold back the next teardowns */
+#define GSTD_PIPELINE_DELETER_MAX_THREADS 4
+
 static GstdReturnCode gstd_pipeline_deleter_delete (GstdIDeleter * iface,
     GstdObject * object);
+static void gstd_pipeline_deleter_teardown (gpointer data,
+    gpointer user_data);
+static void gstd_pipeline_deleter_finalize (GObject * object);
 
 typedef struct _GstdPipelineDeleterClass GstdPipelineDeleterClass;
 
 /**
  * GstdPipelineDeleter:
- * A wrapper for the conventional pipeline_deleter
+ * Unlinks pipelines right away and sets them to NULL on the teardown
+ * pool, so the pipeline list isn't held while they shut down.
  */
 struct _GstdPipelineDeleter
 {
   GObject parent;
+
+  /* Teardowns still running, protected by mutex */
+  GPtrArray *deleting;
+  GMutex mutex;
+  GCond done;
 };
 
+/*
+ * A pipeline on its way to NULL. Holds a reference to its deleter, so
+ * a deleter never goes away with teardowns pending.
+ */
+typedef struct _GstdPipelineTeardown
+{
+  GstdPipelineDeleter *deleter;
+  GstdObject *pipeline;
+  gchar *name;
+} GstdPipelineTeardown;
+
 struct _GstdPipelineDeleterClass
 {
   GObjectClass parent_class;
@@ -69,40 +94,184 @@ G_DEFINE_TYPE_WITH_CODE (GstdPipelineDeleter, gstd_pipeline_deleter,
 static void
 gstd_pipeline_deleter_class_init (GstdPipelineDeleterClass * klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   guint debug_color;
 
+  object_class->finalize = gstd_pipeline_deleter_finalize;
+
   /* Initialize debug category with nice colors */
   debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
   GST_DEBUG_CATEGORY_INIT (gstd_pipeline_deleter_debug, "gstdpipelinedeleter",
       debug_color, "Gstd Pipeline Deleter category");
 }
 
+/* Shared by every deleter, so sessions don't spawn their own threads */
+static GThreadPool *
+gstd_pipeline_deleter_teardowns (void)
+{
+  static gsize initialized = 0;
+  static GThreadPool *teardowns = NULL;
+
+  if (g_once_init_enter (&initialized)) {
+    teardowns = g_thread_pool_new (gstd_pipeline_deleter_teardown, NULL,
+        GSTD_PIPELINE_DELETER_MAX_THREADS, FALSE, NULL);
+    gstd_metrics_add_pool ("teardown", teardowns);
+    g_once_init_leave (&initialized, 1);
+  }
+
+  return teardowns;
+}
+
 static void
 gstd_pipeline_deleter_init (GstdPipelineDeleter * self)
 {
   GST_INFO_OBJECT (self, "Initializing pipeline deleter");
+
+  self->deleting = g_ptr_array_new ();
+  g_mutex_init (&self->mutex);
+  g_cond_init (&self->done);
+}
+
+static void
+gstd_pipeline_deleter_finalize (GObject * object)
+{
+  GstdPipelineDeleter *self = GSTD_PIPELINE_DELETER (object);
+
+  /* Every teardown holds a reference, none can be pending here */
+  g_ptr_array_unref (self->deleting);
+  g_mutex_clear (&self->mutex);
+  g_cond_clear (&self->done);
+
+  G_OBJECT_CLASS (gstd_pipeline_deleter_parent_class)->finalize (object);
 }
 
 static GstdReturnCode
-gstd_pipeline_deleter_delete (GstdIDeleter * iface, GstdObject * object)
+gstd_pipeline_deleter_stop (GstdObject * object)
 {
   GstdObject *state;
   GstdReturnCode ret;
 
-  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
-
   /* Stop the pipe if playing */
   ret = gstd_object_read (object, "state", &state);
   if (ret)
     return ret;
 
   ret = gstd_object_update (state, "NULL");
-  if (ret)
-    return ret;
-
   g_object_unref (state);
-  g_object_unref (object);
 
   return ret;
 }
+
+static void
+gstd_pipeline_deleter_teardown (gpointer data, gpointer user_data)
+{
+  GstdPipelineTeardown *teardown = data;
+  GstdPipelineDeleter *self = teardown->deleter;
+  GstdReturnCode ret;
+
+  ret = gstd_pipeline_deleter_stop (teardown->pipeline);
+  if (ret) {
+    GST_WARNING_OBJECT (self, "Unable to stop pipeline \"%s\": %s",
+        teardown->name, gstd_return_code_to_string (ret));
+  }
+
+  /* Released before the waiters are woken up, unless they hold it */
+  g_object_unref (teardown->pipeline);
+
+  GST_INFO_OBJECT (self, "Pipeline \"%s\" torn down", teardown->name);
+
+  g_mutex_lock (&self->mutex);
+  g_ptr_array_remove (self->deleting, teardown);
+  g_cond_broadcast (&self->done);
+  g_mutex_unlock (&self->mutex);
+
+  /* The pipeline leaves the status */
+  gstd_status_invalidate_all ();
+
+  g_free (teardown->name);
+  g_free (teardown);
+  g_object_unref (self);
+}
+
+static GstdReturnCode
+gstd_pipeline_deleter_delete (GstdIDeleter * iface, GstdObject * object)
+{
+  GstdPipelineDeleter *self;
+  GstdPipelineTeardown *teardown;
+  GError *error = NULL;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_PIPELINE_DELETER (iface);
+
+  /* The list's reference is handed over to the teardown */
+  teardown = g_new (GstdPipelineTeardown, 1);
+  teardown->deleter = g_object_ref (self);
+  teardown->pipeline = object;
+  teardown->name = g_strdup (GSTD_OBJECT_NAME (object));
+
+  g_mutex_lock (&self->mutex);
+  g_ptr_array_add (self->deleting, teardown);
+  g_mutex_unlock (&self->mutex);
+
+  if (!g_thread_pool_push (gstd_pipeline_deleter_teardowns (), teardown,
+          &error)) {
+    GST_WARNING_OBJECT (self, "Tearing down in place: %s", error->message);
+    g_error_free (error);
+    gstd_pipeline_deleter_teardown (teardown, NULL);
+  }
+
+  return GSTD_EOK;
+}
+
+static gboolean
+gstd_pipeline_deleter_is_deleting (GstdPipelineDeleter * self,
+    GstdObject * pipeline)
+{
+  GstdPipelineTeardown *teardown;
+  guint i;
+
+  for (i = 0; i < self->deleting->len; i++) {
+    teardown = g_ptr_array_index (self->deleting, i);
+    if (teardown->pipeline == pipeline) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+void
+gstd_pipeline_deleter_wait (GstdPipelineDeleter * self, GstdObject * pipeline)
+{
+  g_return_if_fail (GSTD_IS_PIPELINE_DELETER (self));
+  g_return_if_fail (GSTD_IS_OBJECT (pipeline));
+
+  g_mutex_lock (&self->mutex);
+  while (gstd_pipeline_deleter_is_deleting (self, pipeline)) {
+    g_cond_wait (&self->done, &self->mutex);
+  }
+  g_mutex_unlock (&self->mutex);
+}
+
+gchar **
+gstd_pipeline_deleter_get_deleting (GstdPipelineDeleter * self)
+{
+  GstdPipelineTeardown *teardown;
+  gchar **names;
+  guint i;
+
+  g_return_val_if_fail (GSTD_IS_PIPELINE_DELETER (self), NULL);
+
+  g_mutex_lock (&self->mutex);
+  names = g_new (gchar *, self->deleting->len + 1);
+  for (i = 0; i < self->deleting->len; i++) {
+    teardown = g_ptr_array_index (self->deleting, i);
+    names[i] = g_strdup (teardown->name);
+  }
+  names[i] = NULL;
+  g_mutex_unlock (&self->mutex);
+
+  return names;
+}
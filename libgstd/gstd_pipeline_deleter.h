@@ -45,5 +45,25 @@ typedef struct _GstdPipelineDeleter GstdPipelineDeleter;
 
 GType gstd_pipeline_deleter_get_type (void);
 
+/**
+ * gstd_pipeline_deleter_wait:
+ * @self: The deleter of the pipeline list
+ * @pipeline: The deleted pipeline
+ *
+ * Blocks until @pipeline reached NULL and the teardown released it.
+ * Pipelines deleted later under the same name are not waited for.
+ */
+void gstd_pipeline_deleter_wait (GstdPipelineDeleter * self,
+    GstdObject * pipeline);
+
+/**
+ * gstd_pipeline_deleter_get_deleting:
+ * @self: The deleter of the pipeline list
+ *
+ * Returns: (transfer full): The names of the deleted pipelines still
+ * shutting down, free them with g_strfreev()
+ */
+gchar **gstd_pipeline_deleter_get_deleting (GstdPipelineDeleter * self);
+
 G_END_DECLS
 #endif // __GSTD_PIPELINE_DELETER_H__
@@ -183,7 +183,7 @@ gstd_property_to_string (GstdObject * obj, gchar ** outstring)
   GValue value = G_VALUE_INIT;
   gchar *sflags;
   const gchar *typename;
-  GstdIFormatter *formatter = g_object_new (obj->formatter_factory, NULL);
+  GstdIFormatter *formatter = gstd_object_new_formatter (obj);
 
   g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
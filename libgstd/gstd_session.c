@@ -28,7 +28,19 @@
 #include "gstd_pipeline_creator.h"
 #include "gstd_property_reader.h"
 #include "gstd_list_reader.h"
+#include "gstd_park.h"
 #include "gstd_pipeline_deleter.h"
+#include "gstd_template.h"
+#include "gstd_template_creator.h"
+#include "gstd_template_deleter.h"
+#include "gstd_standby.h"
+#include "gstd_standby_creator.h"
+#include "gstd_standby_deleter.h"
+
+#include <string.h>
+
+/* Longest URI segment resolved without touching the heap */
+#define GSTD_SESSION_URI_SEGMENT_MAX 256
 
 /* Gstd Session debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_session_debug);
@@ -43,6 +55,9 @@ enum
   PROP_PIPELINES = 1,
   PROP_PID,
   PROP_DEBUG,
+  PROP_FORMATTER,
+  PROP_TEMPLATES,
+  PROP_STANDBY,
   N_PROPERTIES                  // NOT A PROPERTY
 };
 
@@ -57,6 +72,11 @@ gstd_session_set_property (GObject *, guint, const GValue *, GParamSpec *);
 static void gstd_session_get_property (GObject *, guint, GValue *,
     GParamSpec *);
 static void gstd_session_dispose (GObject *);
+static void gstd_session_finalize (GObject *);
+static void gstd_session_pipelines_changed (GObject * list,
+    GParamSpec * pspec, gpointer user_data);
+static gboolean gstd_session_is_cacheable (GstdObject * parent,
+    const gchar * name);
 
 /* Singleton instance using thread-safe weak reference */
 static GWeakRef the_session_ref;
@@ -72,6 +92,7 @@ gstd_session_class_init (GstdSessionClass * klass)
   object_class->set_property = gstd_session_set_property;
   object_class->get_property = gstd_session_get_property;
   object_class->dispose = gstd_session_dispose;
+  object_class->finalize = gstd_session_finalize;
 
   properties[PROP_PIPELINES] =
       g_param_spec_object ("pipelines",
@@ -95,6 +116,30 @@ gstd_session_class_init (GstdSessionClass * klass)
       "The debug object containing debug information",
       GSTD_TYPE_DEBUG, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_FORMATTER] =
+      g_param_spec_gtype ("formatter",
+      "Formatter",
+      "The GstdIFormatter type used to serialize the session responses",
+      GSTD_TYPE_IFORMATTER, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_TEMPLATES] =
+      g_param_spec_object ("templates",
+      "Templates",
+      "The pipeline templates registered by the user",
+      GSTD_TYPE_LIST,
+      G_PARAM_READABLE |
+      G_PARAM_STATIC_STRINGS |
+      GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE);
+
+  properties[PROP_STANDBY] =
+      g_param_spec_object ("standby",
+      "Standby",
+      "The pools of pipelines kept ready for creation",
+      GSTD_TYPE_LIST,
+      G_PARAM_READABLE |
+      G_PARAM_STATIC_STRINGS |
+      GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -117,8 +162,38 @@ gstd_session_init (GstdSession * self)
           GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_UPDATE |
           GSTD_PARAM_DELETE, NULL));
 
+  self->templates =
+      GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "templates",
+          "node-type", GSTD_TYPE_TEMPLATE, "flags",
+          GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE, NULL));
+
+  gstd_object_set_creator (GSTD_OBJECT (self->templates),
+      g_object_new (GSTD_TYPE_TEMPLATE_CREATOR, NULL));
+
+  gstd_object_set_reader (GSTD_OBJECT (self->templates),
+      g_object_new (GSTD_TYPE_LIST_READER, NULL));
+
+  gstd_object_set_deleter (GSTD_OBJECT (self->templates),
+      g_object_new (GSTD_TYPE_TEMPLATE_DELETER, NULL));
+
+  self->standby =
+      GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "standby",
+          "node-type", GSTD_TYPE_STANDBY, "flags",
+          GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE, NULL));
+
+  gstd_object_set_creator (GSTD_OBJECT (self->standby),
+      g_object_new (GSTD_TYPE_STANDBY_CREATOR, "templates", self->templates,
+          NULL));
+
+  gstd_object_set_reader (GSTD_OBJECT (self->standby),
+      g_object_new (GSTD_TYPE_LIST_READER, NULL));
+
+  gstd_object_set_deleter (GSTD_OBJECT (self->standby),
+      g_object_new (GSTD_TYPE_STANDBY_DELETER, NULL));
+
   gstd_object_set_creator (GSTD_OBJECT (self->pipelines),
-      g_object_new (GSTD_TYPE_PIPELINE_CREATOR, NULL));
+      g_object_new (GSTD_TYPE_PIPELINE_CREATOR, "templates", self->templates,
+          "standby", self->standby, NULL));
 
   gstd_object_set_reader (GSTD_OBJECT (self->pipelines),
       g_object_new (GSTD_TYPE_LIST_READER, NULL));
@@ -126,6 +201,15 @@ gstd_session_init (GstdSession * self)
   gstd_object_set_deleter (GSTD_OBJECT (self->pipelines),
       g_object_new (GSTD_TYPE_PIPELINE_DELETER, NULL));
 
+  self->uri_cache = gstd_uri_cache_new (GSTD_URI_CACHE_DEFAULT_CAPACITY);
+  self->status = gstd_status_new (self->pipelines);
+  g_signal_connect (self->pipelines, "notify::count",
+      G_CALLBACK (gstd_session_pipelines_changed), self);
+  g_signal_connect (self->templates, "notify::count",
+      G_CALLBACK (gstd_session_pipelines_changed), self);
+  g_signal_connect (self->standby, "notify::count",
+      G_CALLBACK (gstd_session_pipelines_changed), self);
+
   self->debug =
       GSTD_DEBUG (g_object_new (GSTD_TYPE_DEBUG, "name", "Debug", NULL));
 
@@ -151,6 +235,17 @@ gstd_session_get_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Returning debug object %p", self->debug);
       g_value_set_object (value, self->debug);
       break;
+    case PROP_FORMATTER:
+      g_value_set_gtype (value, GSTD_OBJECT (self)->formatter_factory);
+      break;
+    case PROP_TEMPLATES:
+      GST_DEBUG_OBJECT (self, "Returning template list %p", self->templates);
+      g_value_set_object (value, self->templates);
+      break;
+    case PROP_STANDBY:
+      GST_DEBUG_OBJECT (self, "Returning standby list %p", self->standby);
+      g_value_set_object (value, self->standby);
+      break;
 
     default:
       /* We don't have any other property... */
@@ -168,9 +263,17 @@ gstd_session_set_property (GObject * object,
   switch (property_id) {
     case PROP_PIPELINES:
       if (self->pipelines) {
+        g_signal_handlers_disconnect_by_data (self->pipelines, self);
         g_object_unref (self->pipelines);
       }
       self->pipelines = g_value_dup_object (value);
+      if (self->pipelines) {
+        g_signal_connect (self->pipelines, "notify::count",
+            G_CALLBACK (gstd_session_pipelines_changed), self);
+      }
+      gstd_uri_cache_clear (self->uri_cache);
+      gstd_status_free (self->status);
+      self->status = self->pipelines ? gstd_status_new (self->pipelines) : NULL;
       GST_INFO_OBJECT (self, "Changed pipeline list to %p", self->pipelines);
       break;
     case PROP_DEBUG:
@@ -180,6 +283,11 @@ gstd_session_set_property (GObject * object,
       self->debug = g_value_dup_object (value);
       GST_DEBUG_OBJECT (self, "Changing debug object to %p", self->debug);
       break;
+    case PROP_FORMATTER:
+      GSTD_OBJECT (self)->formatter_factory = g_value_get_gtype (value);
+      GST_INFO_OBJECT (self, "Changed formatter to %s",
+          g_type_name (GSTD_OBJECT (self)->formatter_factory));
+      break;
 
     default:
       /* We don't have any other property... */
@@ -195,11 +303,27 @@ gstd_session_dispose (GObject * object)
 
   GST_INFO_OBJECT (object, "Deinitializing gstd session");
 
+  /* Cached nodes hold references into the pipeline list */
+  gstd_uri_cache_clear (self->uri_cache);
+
   if (self->pipelines) {
+    g_signal_handlers_disconnect_by_data (self->pipelines, self);
     g_object_unref (self->pipelines);
     self->pipelines = NULL;
   }
 
+  if (self->templates) {
+    g_signal_handlers_disconnect_by_data (self->templates, self);
+    g_object_unref (self->templates);
+    self->templates = NULL;
+  }
+
+  if (self->standby) {
+    g_signal_handlers_disconnect_by_data (self->standby, self);
+    g_object_unref (self->standby);
+    self->standby = NULL;
+  }
+
   if (self->debug) {
     g_object_unref (self->debug);
     self->debug = NULL;
@@ -208,6 +332,46 @@ gstd_session_dispose (GObject * object)
   G_OBJECT_CLASS (gstd_session_parent_class)->dispose (object);
 }
 
+static void
+gstd_session_finalize (GObject * object)
+{
+  GstdSession *self = GSTD_SESSION (object);
+
+  gstd_uri_cache_free (self->uri_cache);
+  gstd_status_free (self->status);
+
+  G_OBJECT_CLASS (gstd_session_parent_class)->finalize (object);
+}
+
+static void
+gstd_session_pipelines_changed (GObject * list, GParamSpec * pspec,
+    gpointer user_data)
+{
+  GstdSession *self = GSTD_SESSION (user_data);
+
+  GST_DEBUG_OBJECT (self, "%s list changed, flushing URI cache",
+      GSTD_OBJECT_NAME (list));
+  gstd_uri_cache_clear (self->uri_cache);
+
+  if (list == G_OBJECT (self->pipelines)) {
+    gstd_status_invalidate_all ();
+  }
+}
+
+/*
+ * Only list children and object properties are stable across reads.
+ * Other readers (bus messages, signal callbacks, state waits) produce
+ * a fresh result on every read and must never be served from the
+ * cache, even when their reader extends the property one.
+ */
+static gboolean
+gstd_session_is_cacheable (GstdObject * parent, const gchar * name)
+{
+  return (GSTD_IS_LIST_READER (parent->reader)
+      || GSTD_IS_PROPERTY_READER (parent->reader))
+      && !gstd_park_is_blocking (parent, name);
+}
+
 GstdSession *
 gstd_session_new (const gchar * name)
 {
@@ -249,51 +413,108 @@ GstdReturnCode
 gstd_get_by_uri (GstdSession * gstd, const gchar * uri, GstdObject ** node)
 {
   GstdObject *parent, *child;
-  gchar **nodes;
-  gchar **it;
+  gchar segment[GSTD_SESSION_URI_SEGMENT_MAX];
+  gchar *name;
+  const gchar *start;
+  const gchar *end;
+  gsize len;
+  gboolean cacheable = TRUE;
+  gboolean root = TRUE;
+  guint generation;
   GstdReturnCode ret;
 
   g_return_val_if_fail (GSTD_IS_SESSION (gstd), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (uri, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (node, GSTD_NULL_ARGUMENT);
 
-  nodes = g_strsplit_set (uri, "/", -1);
-
-  if (!nodes)
-    goto badcommand;
+  parent = gstd_uri_cache_lookup (gstd->uri_cache, uri);
+  if (parent) {
+    GST_LOG_OBJECT (gstd, "URI cache hit for %s", uri);
+    goto found;
+  }
 
-  it = nodes;
+  generation = gstd_uri_cache_get_generation (gstd->uri_cache);
   parent = g_object_ref (GSTD_OBJECT (gstd));
 
-  while (*it) {
+  /* Walk the URI in place, segments are copied to the stack */
+  for (start = uri; *start; start = end) {
     // Empty slash, try no normalize
-    if ('\0' == *it[0]) {
-      ++it;
+    if ('/' == *start) {
+      end = start + 1;
       continue;
     }
 
-    ret = gstd_object_read (parent, *it, &child);
+    end = strchr (start, '/');
+    if (!end)
+      end = start + strlen (start);
+    len = end - start;
+
+    if (len < sizeof (segment)) {
+      memcpy (segment, start, len);
+      segment[len] = '\0';
+      name = segment;
+    } else {
+      name = g_strndup (start, len);
+    }
+
+    cacheable = cacheable && gstd_session_is_cacheable (parent, name);
+    root = FALSE;
+
+    child = NULL;
+    ret = gstd_object_read (parent, name, &child);
     g_object_unref (parent);
 
-    if (ret)
+    /* A failed wait still answers with the state, not a node */
+    if (ret) {
+      g_clear_object (&child);
       goto nonode;
+    }
+
+    if (name != segment)
+      g_free (name);
 
     parent = child;
-    ++it;
   }
 
-  g_strfreev (nodes);
+  if (cacheable && !root)
+    gstd_uri_cache_insert (gstd->uri_cache, uri, parent, generation);
+
+found:
   *node = parent;
   return GSTD_EOK;
 
-badcommand:
-  {
-    GST_ERROR_OBJECT (gstd, "Invalid command");
-    return GSTD_BAD_COMMAND;
-  }
 nonode:
   {
-    GST_ERROR_OBJECT (gstd, "Invalid node %s", *it);
-    g_strfreev (nodes);
+    GST_ERROR_OBJECT (gstd, "Invalid node %s", name);
+    if (name != segment)
+      g_free (name);
     return GSTD_BAD_COMMAND;
   }
 }
+
+void
+gstd_session_wait_pipeline_deleted (GstdSession * gstd, GstdObject * pipeline)
+{
+  GstdIDeleter *deleter;
+
+  g_return_if_fail (GSTD_IS_SESSION (gstd));
+  g_return_if_fail (GSTD_IS_OBJECT (pipeline));
+
+  deleter = GSTD_OBJECT (gstd->pipelines)->deleter;
+  if (GSTD_IS_PIPELINE_DELETER (deleter))
+    gstd_pipeline_deleter_wait (GSTD_PIPELINE_DELETER (deleter), pipeline);
+}
+
+gchar **
+gstd_session_get_deleting_pipelines (GstdSession * gstd)
+{
+  GstdIDeleter *deleter;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (gstd), NULL);
+
+  deleter = GSTD_OBJECT (gstd->pipelines)->deleter;
+  if (!GSTD_IS_PIPELINE_DELETER (deleter))
+    return g_new0 (gchar *, 1);
+
+  return gstd_pipeline_deleter_get_deleting (GSTD_PIPELINE_DELETER (deleter));
+}
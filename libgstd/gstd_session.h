@@ -109,6 +109,13 @@
  *      ╰── PipelineN
  * ]|
  *
+ * Next to the pipelines, a "templates" list holds descriptions with
+ * ${name} placeholders. "CREATE /pipelines name @template a=1 b=2"
+ * builds a pipeline from one of them. A "standby" list holds pools of
+ * pipelines built ahead of time: after "CREATE /standby name size=2
+ * state=paused description", creating a pipeline with that same
+ * description takes one of them over, already in PAUSED.
+ *
  * - So, the state of Pipeline1 can be accessed via
  * |[
  * /pipelines/Pipeline1/state
@@ -176,6 +183,8 @@
 #include "gstd_pipeline.h"
 #include "gstd_list.h"
 #include "gstd_debug.h"
+#include "gstd_uri_cache.h"
+#include "gstd_status.h"
 
 G_BEGIN_DECLS
 #define GSTD_TYPE_SESSION \
@@ -202,6 +211,16 @@ struct _GstdSession
    */
   GstdList *pipelines;
 
+  /**
+   * The pipeline templates registered by the user
+   */
+  GstdList *templates;
+
+  /**
+   * The pools of pipelines kept ready by the user
+   */
+  GstdList *standby;
+
   /*
    * The current process identifier
    */
@@ -211,6 +230,17 @@ struct _GstdSession
    * Object containing debug options
    */
   GstdDebug *debug;
+
+  /*
+   * Resolved nodes by URI, flushed whenever a pipeline is created or
+   * deleted
+   */
+  GstdUriCache *uri_cache;
+
+  /*
+   * The published pipeline status, served by /pipelines/status
+   */
+  GstdStatus *status;
 };
 
 struct _GstdSessionClass
@@ -237,5 +267,26 @@ GstdSession *gstd_session_new (const gchar * name);
 GstdReturnCode
 gstd_get_by_uri (GstdSession * gstd, const gchar * uri, GstdObject ** node);
 
+/**
+ * gstd_session_wait_pipeline_deleted:
+ * @gstd: The session the pipeline was deleted from
+ * @pipeline: The deleted pipeline
+ *
+ * Deleted pipelines leave the pipeline list right away but reach NULL
+ * in the background. Blocks until @pipeline did. The caller's own
+ * reference, if any, is the only one left afterwards.
+ */
+void gstd_session_wait_pipeline_deleted (GstdSession * gstd,
+    GstdObject * pipeline);
+
+/**
+ * gstd_session_get_deleting_pipelines:
+ * @gstd: The session to query
+ *
+ * Returns: (transfer full): The names of the deleted pipelines still
+ * shutting down, free them with g_strfreev()
+ */
+gchar **gstd_session_get_deleting_pipelines (GstdSession * gstd);
+
 G_END_DECLS
 #endif //__GSTD_SESSION___
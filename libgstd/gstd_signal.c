@@ -31,6 +31,9 @@ enum
   PROP_TIMEOUT,
   PROP_CALLBACK,
   PROP_DISCONNECT,
+  PROP_MAX_CALLBACKS,
+  PROP_LAST_SEQ,
+  PROP_DROPPED,
   N_PROPERTIES
 };
 
@@ -38,6 +41,7 @@ enum
 #define DEFAULT_PROP_TIMEOUT -1
 #define DEFAULT_PROP_TIMEOUT_MIN -1
 #define DEFAULT_PROP_TIMEOUT_MAX G_MAXINT64
+#define DEFAULT_PROP_MAX_CALLBACKS_MAX 65536
 
 /* Gstd Signal debugging category */
 GST_DEBUG_CATEGORY_STATIC (gstd_signal_debug);
@@ -94,6 +98,25 @@ gstd_signal_class_init (GstdSignalClass * klass)
       "Stop waiting for signal", FALSE,
       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_MAX_CALLBACKS] =
+      g_param_spec_uint ("max-callbacks",
+      "Max Callbacks",
+      "The amount of emissions retained for the readers, the oldest are "
+      "dropped", 1, DEFAULT_PROP_MAX_CALLBACKS_MAX,
+      GSTD_SIGNAL_READER_RING_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_LAST_SEQ] =
+      g_param_spec_uint64 ("last-seq",
+      "Last Sequence",
+      "The sequence number of the newest emission, 0 if none arrived yet",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_DROPPED] =
+      g_param_spec_uint64 ("dropped",
+      "Dropped",
+      "The amount of emissions dropped from the retained ones",
+      0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
   /* Initialize debug category with nice colors */
@@ -120,6 +143,11 @@ gstd_signal_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s signal", GSTD_OBJECT_NAME (self));
 
+  /* The reader holds its own reference to the target while connected */
+  if (GSTD_OBJECT (self)->reader) {
+    gstd_signal_disconnect (self);
+  }
+
   if (self->target) {
     g_object_unref (self->target);
     self->target = NULL;
@@ -135,6 +163,10 @@ gstd_signal_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec)
 {
   GstdSignal *self = GSTD_SIGNAL (object);
+  GstdIReader *reader = GSTD_OBJECT (self)->reader;
+  guint max_callbacks = 0;
+  guint64 last_seq = 0;
+  guint64 dropped = 0;
 
   switch (property_id) {
     case PROP_TARGET:
@@ -150,6 +182,18 @@ gstd_signal_get_property (GObject * object,
     case PROP_CALLBACK:
       GST_DEBUG_OBJECT (self, "Connecting callback");
       break;
+    case PROP_MAX_CALLBACKS:
+      gstd_signal_reader_get_stats (reader, &max_callbacks, NULL, NULL);
+      g_value_set_uint (value, max_callbacks);
+      break;
+    case PROP_LAST_SEQ:
+      gstd_signal_reader_get_stats (reader, NULL, &last_seq, NULL);
+      g_value_set_uint64 (value, last_seq);
+      break;
+    case PROP_DROPPED:
+      gstd_signal_reader_get_stats (reader, NULL, NULL, &dropped);
+      g_value_set_uint64 (value, dropped);
+      break;
     default:
       /* We don't have any other signal... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -176,6 +220,12 @@ gstd_signal_set_property (GObject * object,
       GST_DEBUG_OBJECT (self, "Timeout changed to %" GST_TIME_FORMAT,
           GST_TIME_ARGS (self->timeout));
       break;
+    case PROP_MAX_CALLBACKS:
+      GST_DEBUG_OBJECT (self, "Retaining %u emissions",
+          g_value_get_uint (value));
+      gstd_signal_reader_set_max_callbacks (GSTD_OBJECT (self)->reader,
+          g_value_get_uint (value));
+      break;
     default:
       /* We don't have any other signal... */
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
@@ -68,14 +68,11 @@ gstd_signal_list_dispose (GObject * object)
 
   GST_INFO_OBJECT (self, "Disposing %s signal list", GSTD_OBJECT_NAME (self));
 
-  if (list->list) {
+  if (list->nodes.head) {
     GList *elem;
-    for (elem = list->list; elem; elem = g_list_next (elem)) {
+    for (elem = list->nodes.head; elem; elem = g_list_next (elem)) {
       gstd_signal_disconnect (elem->data);
     }
-
-    g_list_free_full (list->list, g_object_unref);
-    list->list = NULL;
   }
 
   G_OBJECT_CLASS (gstd_signal_list_parent_class)->dispose (object);
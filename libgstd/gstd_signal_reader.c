@@ -18,6 +18,11 @@
  * Boston, MA 02110-1301, USA.
  */
 
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <gst/gst.h>
 
 #include "gstd_signal_reader.h"
@@ -37,27 +42,56 @@ static GstdReturnCode gstd_signal_reader_read (GstdIReader * iface,
 static GstdReturnCode gstd_signal_reader_read_signal (GstdIReader * iface,
     GstdObject * object, GstdObject ** out);
 
-void gstd_signal_marshal (GClosure * closure, GValue * return_value,
-    guint n_param_values, const GValue * param_values,
-    gpointer invocation_hint, gpointer marshar_data);
+static void gstd_signal_reader_marshal (GClosure * closure,
+    GValue * return_value, guint n_param_values, const GValue * param_values,
+    gpointer invocation_hint, gpointer marshal_data);
 
 static void gstd_signal_reader_dispose (GObject * object);
+static void gstd_signal_reader_finalize (GObject * object);
 
 typedef struct _GstdSignalReaderClass GstdSignalReaderClass;
 
+typedef struct _GstdSignalReaderWaiter
+{
+  guint id;
+  GstdSignalReaderFunc func;
+  gpointer user_data;
+} GstdSignalReaderWaiter;
+
+/*
+ * The signal stays connected from the first read until it is
+ * disconnected, so no emission is missed between reads. Emissions are
+ * numbered and kept in a ring, readers with a cursor of their own go
+ * through gstd_signal_reader_read_since().
+ */
 struct _GstdSignalReader
 {
   GstdPropertyReader parent;
 
-  /* signal handling */
-  GstdSignal *target;
-
-  /* wait for signal */
+  /* Protects everything below */
   GMutex signal_lock;
-  gboolean waiting_signal;
   GCond signal_call;
-  GstdCallback *callback;
 
+  /* The connection, owner is NULL while disconnected */
+  GObject *owner;
+  gchar *name;
+  gulong handler_id;
+
+  /* Emissions first_seq..last_seq, at seq % size */
+  GstdCallback **ring;
+  guint size;
+  guint64 first_seq;
+  guint64 last_seq;
+  guint64 dropped;
+
+  /* The last emission taken by a callback read, shared by all of them */
+  guint64 cursor;
+
+  /* parked reads, the callback ones take the emission and the
+   * read_since ones only peek */
+  GList *waiters;
+  GList *readers;
+  guint next_id;
 };
 
 struct _GstdSignalReaderClass
@@ -86,6 +120,7 @@ gstd_signal_reader_class_init (GstdSignalReaderClass * klass)
   guint debug_color;
 
   object_class->dispose = gstd_signal_reader_dispose;
+  object_class->finalize = gstd_signal_reader_finalize;
 
   /* Initialize debug category with nice colors */
   debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
@@ -98,7 +133,18 @@ gstd_signal_reader_init (GstdSignalReader * self)
 {
   GST_INFO_OBJECT (self, "Initializing signal reader");
 
-  self->target = NULL;
+  self->owner = NULL;
+  self->name = NULL;
+  self->handler_id = 0;
+  self->size = GSTD_SIGNAL_READER_RING_SIZE;
+  self->ring = g_new0 (GstdCallback *, self->size);
+  self->first_seq = 1;
+  self->last_seq = 0;
+  self->dropped = 0;
+  self->cursor = 0;
+  self->waiters = NULL;
+  self->readers = NULL;
+  self->next_id = 1;
 
   g_mutex_init (&self->signal_lock);
   g_cond_init (&self->signal_call);
@@ -106,11 +152,23 @@ gstd_signal_reader_init (GstdSignalReader * self)
 
 static void
 gstd_signal_reader_dispose (GObject * object)
+{
+  /* The closure would be invalidated anyway, drop the owner too */
+  gstd_signal_reader_disconnect (GSTD_IREADER (object));
+
+  G_OBJECT_CLASS (gstd_signal_reader_parent_class)->dispose (object);
+}
+
+static void
+gstd_signal_reader_finalize (GObject * object)
 {
   GstdSignalReader *self = GSTD_SIGNAL_READER (object);
 
+  g_free (self->ring);
   g_mutex_clear (&self->signal_lock);
   g_cond_clear (&self->signal_call);
+
+  G_OBJECT_CLASS (gstd_signal_reader_parent_class)->finalize (object);
 }
 
 static GstdReturnCode
@@ -142,98 +200,497 @@ gstd_signal_reader_read (GstdIReader * iface, GstdObject * object,
   return ret;
 }
 
-static GstdReturnCode
-gstd_signal_reader_read_signal (GstdIReader * iface,
-    GstdObject * object, GstdObject ** out)
+/* Must be called with the lock held */
+static GstdCallback *
+gstd_signal_reader_at (GstdSignalReader * self, guint64 seq)
+{
+  return self->ring[seq % self->size];
+}
+
+/* Must be called with the lock held */
+static void
+gstd_signal_reader_drop_oldest (GstdSignalReader * self)
+{
+  GstdCallback **slot = &self->ring[self->first_seq % self->size];
+
+  g_object_unref (*slot);
+  *slot = NULL;
+  self->first_seq++;
+  self->dropped++;
+}
+
+/*
+ * Frees every emission kept. Unlike the ones overwritten, they don't
+ * count as dropped. Must be called with the lock held.
+ */
+static void
+gstd_signal_reader_clear (GstdSignalReader * self)
+{
+  GstdCallback **slot;
+
+  for (; self->first_seq <= self->last_seq; self->first_seq++) {
+    slot = &self->ring[self->first_seq % self->size];
+    g_object_unref (*slot);
+    *slot = NULL;
+  }
+}
+
+/*
+ * Connects to the signal @object wraps unless it already is. Must be
+ * called with the lock held.
+ */
+static void
+gstd_signal_reader_connect (GstdSignalReader * self, GstdObject * object)
 {
-  GstdReturnCode ret = GSTD_EOK;
-  GstdSignalReader *self = GSTD_SIGNAL_READER (iface);
-  GObject *target;
   GClosure *closure;
-  gulong handler_id;
-  guint64 timeout;
-  guint64 end_time;
 
-  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
-  g_return_val_if_fail (GSTD_IS_SIGNAL (object), GSTD_BAD_VALUE);
-  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
+  if (self->owner) {
+    return;
+  }
 
   GST_INFO_OBJECT (self, "connecting callback of %s",
       GSTD_OBJECT_NAME (object));
 
-  g_mutex_lock (&self->signal_lock);
+  g_object_get (object, "target", &self->owner, NULL);
+  self->name = g_strdup (GSTD_OBJECT_NAME (object));
 
-  self->waiting_signal = TRUE;
-  self->target = GSTD_SIGNAL (object);
+  /* Keeps the reader alive while an emission is being marshalled */
+  closure = g_closure_new_object (sizeof (GClosure), G_OBJECT (self));
+  g_closure_set_marshal (closure, gstd_signal_reader_marshal);
+  self->handler_id = g_signal_connect_closure (self->owner, self->name,
+      closure, FALSE);
 
-  /* get signal owner */
-  g_object_get (object, "target", &target, NULL);
+  /* Callback reads start with the emissions from now on */
+  self->cursor = self->last_seq;
+}
 
-  /* connect to signal */
-  closure = g_closure_new_simple (sizeof (GClosure), self);
-  g_closure_set_marshal (closure, gstd_signal_marshal);
-  handler_id =
-      g_signal_connect_closure (target, GSTD_OBJECT_NAME (object), closure,
-      FALSE);
+/*
+ * Moves the shared cursor to the next emission kept, if any. Must be
+ * called with the lock held.
+ */
+static GstdCallback *
+gstd_signal_reader_take (GstdSignalReader * self)
+{
+  self->cursor = MAX (self->cursor, self->first_seq - 1);
+  if (self->cursor >= self->last_seq) {
+    return NULL;
+  }
 
-  GST_DEBUG_OBJECT (object, "waiting signal");
+  self->cursor++;
+  return g_object_ref (gstd_signal_reader_at (self, self->cursor));
+}
 
-  g_object_get (object, "timeout", &timeout, NULL);
-  if (timeout != -1) {
-    end_time = g_get_monotonic_time () + timeout;
-    while (self->waiting_signal) {
-      if (!g_cond_wait_until (&self->signal_call, &self->signal_lock, end_time)) {
-        goto out;
-      }
-    }
-  } else {
-    while (self->waiting_signal)
+/* Converts a timeout in microseconds, -1 meaning forever */
+static gint64
+gstd_signal_reader_deadline (gint64 timeout)
+{
+  return timeout < 0 ? -1 : g_get_monotonic_time () + timeout;
+}
+
+/*
+ * Waits until an emission newer than @seq arrives, the signal is
+ * disconnected or @deadline passes. Must be called with the lock held.
+ */
+static gboolean
+gstd_signal_reader_wait (GstdSignalReader * self, guint64 seq, gint64 deadline)
+{
+  while (self->last_seq <= seq && self->owner) {
+    if (deadline < 0) {
       g_cond_wait (&self->signal_call, &self->signal_lock);
+    } else if (!g_cond_wait_until (&self->signal_call, &self->signal_lock,
+            deadline)) {
+      break;
+    }
   }
 
-  if (self->callback) {
-    *out = GSTD_OBJECT (self->callback);
-  }
+  return self->last_seq > seq;
+}
+
+static GstdReturnCode
+gstd_signal_reader_read_signal (GstdIReader * iface,
+    GstdObject * object, GstdObject ** out)
+{
+  GstdSignalReader *self = GSTD_SIGNAL_READER (iface);
+  GstdCallback *callback;
+  gint64 timeout;
+  gint64 deadline;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (GSTD_IS_SIGNAL (object), GSTD_BAD_VALUE);
+  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
 
-  self->callback = NULL;
+  g_object_get (object, "timeout", &timeout, NULL);
+  deadline = gstd_signal_reader_deadline (timeout);
+
+  g_mutex_lock (&self->signal_lock);
+  gstd_signal_reader_connect (self, object);
 
-out:
-  g_object_unref (target);
-  g_signal_handler_disconnect (target, handler_id);
+  GST_DEBUG_OBJECT (object, "waiting signal");
+
+  callback = gstd_signal_reader_take (self);
+  while (!callback && gstd_signal_reader_wait (self, self->cursor, deadline)) {
+    callback = gstd_signal_reader_take (self);
+  }
   g_mutex_unlock (&self->signal_lock);
 
-  return ret;
+  if (callback) {
+    *out = GSTD_OBJECT (callback);
+  }
+
+  return GSTD_EOK;
 }
 
-void
-gstd_signal_marshal (GClosure * closure, GValue * return_value,
-    guint n_param_values, const GValue * param_values, gpointer invocation_hint,
-    gpointer marshar_data)
+/*
+ * Runs in the thread emitting the signal. Stores the emission, dropping
+ * the oldest one once the ring is full, and hands it to the first
+ * parked read, if any.
+ */
+static void
+gstd_signal_reader_marshal (GClosure * closure, GValue * return_value,
+    guint n_param_values, const GValue * param_values,
+    gpointer invocation_hint, gpointer marshal_data)
 {
   GstdSignalReader *self = GSTD_SIGNAL_READER (closure->data);
+  GstdSignalReaderWaiter *waiter = NULL;
+  GstdCallback *callback;
+  GList *readers;
+  GList *iter;
 
-  self->callback =
-      gstd_callback_new (GSTD_OBJECT_NAME (self->target), return_value,
-      n_param_values, param_values);
   g_mutex_lock (&self->signal_lock);
-  self->waiting_signal = FALSE;
-  g_cond_signal (&self->signal_call);
+
+  /* Disconnected while this emission was on its way */
+  if (NULL == self->owner) {
+    g_mutex_unlock (&self->signal_lock);
+    return;
+  }
+
+  callback = gstd_callback_new (self->name, return_value, n_param_values,
+      param_values);
+
+  if (self->last_seq - self->first_seq + 1 >= self->size) {
+    gstd_signal_reader_drop_oldest (self);
+  }
+  self->last_seq++;
+  self->ring[self->last_seq % self->size] = callback;
+
+  /* Parked reads share the cursor, the first one takes it */
+  if (self->waiters) {
+    waiter = self->waiters->data;
+    self->waiters = g_list_delete_link (self->waiters, self->waiters);
+    self->cursor = self->last_seq;
+    g_object_ref (callback);
+  }
+
+  /* Readers with a cursor of their own all get it */
+  readers = self->readers;
+  self->readers = NULL;
+  for (iter = readers; iter; iter = iter->next) {
+    g_object_ref (callback);
+  }
+
+  g_cond_broadcast (&self->signal_call);
   g_mutex_unlock (&self->signal_lock);
+
+  if (waiter) {
+    waiter->func (GSTD_OBJECT (callback), waiter->user_data);
+    g_free (waiter);
+  }
+
+  for (iter = readers; iter; iter = iter->next) {
+    waiter = iter->data;
+    waiter->func (GSTD_OBJECT (callback), waiter->user_data);
+  }
+  g_list_free_full (readers, g_free);
 }
 
 GstdReturnCode
 gstd_signal_reader_disconnect (GstdIReader * iface)
 {
   GstdSignalReader *self;
+  GstdSignalReaderWaiter *waiter;
+  GObject *owner;
+  gulong handler_id;
+  GList *waiters;
+  GList *iter;
 
   g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
 
   self = GSTD_SIGNAL_READER (iface);
 
   g_mutex_lock (&self->signal_lock);
-  self->waiting_signal = FALSE;
+  owner = self->owner;
+  handler_id = self->handler_id;
+  self->owner = NULL;
+  self->handler_id = 0;
+  g_free (self->name);
+  self->name = NULL;
+  gstd_signal_reader_clear (self);
+  waiters = g_list_concat (self->waiters, self->readers);
+  self->waiters = self->readers = NULL;
+
+  /* Blocked readers give up */
   g_cond_broadcast (&self->signal_call);
   g_mutex_unlock (&self->signal_lock);
 
+  if (owner) {
+    GST_INFO_OBJECT (self, "disconnecting signal");
+    g_signal_handler_disconnect (owner, handler_id);
+    g_object_unref (owner);
+  }
+
+  /* Parked reads end without a callback too */
+  for (iter = waiters; iter; iter = iter->next) {
+    waiter = iter->data;
+    waiter->func (NULL, waiter->user_data);
+  }
+  g_list_free_full (waiters, g_free);
+
   return GSTD_EOK;
 }
+
+GstdObject *
+gstd_signal_reader_read_async (GstdIReader * iface, GstdObject * object,
+    GstdSignalReaderFunc func, gpointer user_data, guint * id)
+{
+  GstdSignalReader *self;
+  GstdSignalReaderWaiter *waiter;
+  GstdCallback *callback;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_READER (iface), NULL);
+  g_return_val_if_fail (GSTD_IS_SIGNAL (object), NULL);
+  g_return_val_if_fail (func, NULL);
+  g_return_val_if_fail (id, NULL);
+
+  self = GSTD_SIGNAL_READER (iface);
+
+  g_mutex_lock (&self->signal_lock);
+  gstd_signal_reader_connect (self, object);
+
+  callback = gstd_signal_reader_take (self);
+  if (callback) {
+    *id = 0;
+  } else {
+    GST_INFO_OBJECT (self, "parking callback read of %s",
+        GSTD_OBJECT_NAME (object));
+
+    waiter = g_new0 (GstdSignalReaderWaiter, 1);
+    waiter->id = *id = self->next_id++;
+    waiter->func = func;
+    waiter->user_data = user_data;
+    self->waiters = g_list_append (self->waiters, waiter);
+  }
+  g_mutex_unlock (&self->signal_lock);
+
+  return GSTD_OBJECT (callback);
+}
+
+/* Removes the waiter @id from @waiters, returns FALSE if not there */
+static gboolean
+gstd_signal_reader_withdraw (GstdSignalReader * self, GList ** waiters,
+    guint id)
+{
+  GList *iter;
+  gboolean found = FALSE;
+
+  g_mutex_lock (&self->signal_lock);
+  for (iter = *waiters; iter; iter = iter->next) {
+    if (((GstdSignalReaderWaiter *) iter->data)->id == id) {
+      g_free (iter->data);
+      *waiters = g_list_delete_link (*waiters, iter);
+      found = TRUE;
+      break;
+    }
+  }
+  g_mutex_unlock (&self->signal_lock);
+
+  return found;
+}
+
+gboolean
+gstd_signal_reader_cancel (GstdIReader * iface, guint id)
+{
+  GstdSignalReader *self;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_READER (iface), FALSE);
+
+  self = GSTD_SIGNAL_READER (iface);
+
+  return gstd_signal_reader_withdraw (self, &self->waiters, id);
+}
+
+guint
+gstd_signal_reader_read_since_async (GstdIReader * iface,
+    GstdObject * object, guint64 since, GstdSignalReaderFunc func,
+    gpointer user_data)
+{
+  GstdSignalReader *self;
+  GstdSignalReaderWaiter *waiter;
+  guint id = 0;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_READER (iface), 0);
+  g_return_val_if_fail (GSTD_IS_SIGNAL (object), 0);
+  g_return_val_if_fail (func, 0);
+
+  self = GSTD_SIGNAL_READER (iface);
+
+  g_mutex_lock (&self->signal_lock);
+  gstd_signal_reader_connect (self, object);
+
+  /* Nothing newer yet, see gstd_signal_reader_wait() */
+  if (since >= self->last_seq && self->owner) {
+    waiter = g_new0 (GstdSignalReaderWaiter, 1);
+    waiter->id = id = self->next_id++;
+    waiter->func = func;
+    waiter->user_data = user_data;
+    self->readers = g_list_append (self->readers, waiter);
+  }
+  g_mutex_unlock (&self->signal_lock);
+
+  return id;
+}
+
+gboolean
+gstd_signal_reader_read_since_cancel (GstdIReader * iface, guint id)
+{
+  GstdSignalReader *self;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_READER (iface), FALSE);
+
+  self = GSTD_SIGNAL_READER (iface);
+
+  return gstd_signal_reader_withdraw (self, &self->readers, id);
+}
+
+GstdReturnCode
+gstd_signal_reader_read_since (GstdIReader * iface, GstdObject * object,
+    guint64 since, guint max, gint64 timeout, gchar ** response)
+{
+  GstdSignalReader *self;
+  GstdIFormatter *formatter;
+  GPtrArray *callbacks;
+  GValue value = G_VALUE_INIT;
+  guint64 lost = 0;
+  guint64 first;
+  guint64 seq;
+  gint64 deadline;
+  guint i;
+
+  g_return_val_if_fail (GSTD_IS_SIGNAL_READER (iface), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (GSTD_IS_SIGNAL (object), GSTD_BAD_VALUE);
+  g_return_val_if_fail (response, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_SIGNAL_READER (iface);
+  callbacks = g_ptr_array_new_with_free_func (g_object_unref);
+  deadline = gstd_signal_reader_deadline (timeout > 0 ?
+      GST_TIME_AS_USECONDS (timeout) : timeout);
+
+  /* Only the references are taken under the lock. A cursor ahead of
+   * the ring, from before a reconnection, starts over */
+  g_mutex_lock (&self->signal_lock);
+  gstd_signal_reader_connect (self, object);
+
+  seq = MIN (since, self->last_seq);
+  if (gstd_signal_reader_wait (self, seq, deadline)) {
+    first = self->first_seq;
+    if (seq + 1 < first) {
+      lost = first - seq - 1;
+      seq = first - 1;
+    }
+
+    while (seq < self->last_seq && callbacks->len < max) {
+      seq++;
+      g_ptr_array_add (callbacks,
+          g_object_ref (gstd_signal_reader_at (self, seq)));
+    }
+  }
+  g_mutex_unlock (&self->signal_lock);
+
+  formatter = gstd_object_new_formatter (object);
+  gstd_iformatter_begin_object (formatter);
+
+  /* Where the next read should start from */
+  g_value_init (&value, G_TYPE_UINT64);
+  g_value_set_uint64 (&value, seq);
+  gstd_iformatter_set_member_name (formatter, "next");
+  gstd_iformatter_set_value (formatter, &value);
+
+  /* Emissions overwritten before they could be read */
+  g_value_set_uint64 (&value, lost);
+  gstd_iformatter_set_member_name (formatter, "lost");
+  gstd_iformatter_set_value (formatter, &value);
+
+  gstd_iformatter_set_member_name (formatter, "callbacks");
+  gstd_iformatter_begin_array (formatter);
+  for (i = 0; i < callbacks->len; i++) {
+    gstd_iformatter_begin_object (formatter);
+
+    g_value_set_uint64 (&value, seq - callbacks->len + i + 1);
+    gstd_iformatter_set_member_name (formatter, "seq");
+    gstd_iformatter_set_value (formatter, &value);
+
+    gstd_callback_serialize (g_ptr_array_index (callbacks, i), formatter);
+
+    gstd_iformatter_end_object (formatter);
+  }
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_generate (formatter, response);
+
+  g_value_unset (&value);
+  g_object_unref (formatter);
+  g_ptr_array_unref (callbacks);
+
+  return GSTD_EOK;
+}
+
+void
+gstd_signal_reader_set_max_callbacks (GstdIReader * iface, guint size)
+{
+  GstdSignalReader *self;
+  GstdCallback **ring;
+  guint64 seq;
+
+  g_return_if_fail (GSTD_IS_SIGNAL_READER (iface));
+  g_return_if_fail (size > 0);
+
+  self = GSTD_SIGNAL_READER (iface);
+
+  g_mutex_lock (&self->signal_lock);
+  while (self->last_seq - self->first_seq + 1 > size) {
+    gstd_signal_reader_drop_oldest (self);
+  }
+
+  ring = g_new0 (GstdCallback *, size);
+  for (seq = self->first_seq; seq <= self->last_seq; seq++) {
+    ring[seq % size] = gstd_signal_reader_at (self, seq);
+  }
+
+  g_free (self->ring);
+  self->ring = ring;
+  self->size = size;
+  g_mutex_unlock (&self->signal_lock);
+}
+
+void
+gstd_signal_reader_get_stats (GstdIReader * iface, guint * max_callbacks,
+    guint64 * last_seq, guint64 * dropped)
+{
+  GstdSignalReader *self;
+
+  g_return_if_fail (GSTD_IS_SIGNAL_READER (iface));
+
+  self = GSTD_SIGNAL_READER (iface);
+
+  g_mutex_lock (&self->signal_lock);
+  if (max_callbacks) {
+    *max_callbacks = self->size;
+  }
+  if (last_seq) {
+    *last_seq = self->last_seq;
+  }
+  if (dropped) {
+    *dropped = self->dropped;
+  }
+  g_mutex_unlock (&self->signal_lock);
+}
@@ -24,6 +24,7 @@
 #include <gst/gst.h>
 
 #include "gstd_ireader.h"
+#include "gstd_object.h"
 
 G_BEGIN_DECLS
 /*
@@ -43,9 +44,133 @@ G_BEGIN_DECLS
   (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_SIGNAL_READER, GstdSignalReaderClass))
 typedef struct _GstdSignalReader GstdSignalReader;
 
+/* Emissions kept per signal unless "max-callbacks" says otherwise */
+#define GSTD_SIGNAL_READER_RING_SIZE 256
+
 GType gstd_signal_reader_get_type (void);
 
+/**
+ * gstd_signal_reader_disconnect:
+ * @iface: The reader of the signal
+ *
+ * Disconnects from the signal and frees every emission kept, which
+ * doesn't count them as dropped. Blocked and parked reads end without
+ * a callback. The next read connects again.
+ *
+ * Returns: GSTD_EOK
+ */
 GstdReturnCode gstd_signal_reader_disconnect (GstdIReader * iface);
 
+/**
+ * GstdSignalReaderFunc:
+ * @callback: (transfer full) (nullable): The #GstdCallback describing
+ * the emission, NULL if the signal was disconnected
+ * @user_data: The data given to gstd_signal_reader_read_async()
+ *
+ * Runs in the thread that emitted the signal, it should only hand the
+ * callback over.
+ */
+typedef void (*GstdSignalReaderFunc) (GstdObject * callback,
+    gpointer user_data);
+
+/**
+ * gstd_signal_reader_read_async:
+ * @iface: The reader of @signal
+ * @signal: The #GstdSignal to wait for
+ * @func: Called once on the next emission
+ * @user_data: Data to pass to @func
+ * @id: (out): The id to cancel the read with, 0 if it wasn't parked
+ *
+ * Reads the "callback" resource. If no emission is pending the read is
+ * parked, no thread is held until the signal is emitted.
+ *
+ * Returns: (transfer full) (nullable): The next pending emission, NULL
+ * if the read was parked.
+ */
+GstdObject *gstd_signal_reader_read_async (GstdIReader * iface,
+    GstdObject * signal, GstdSignalReaderFunc func, gpointer user_data,
+    guint * id);
+
+/**
+ * gstd_signal_reader_cancel:
+ * @iface: The reader the read was parked on
+ * @id: The id given by gstd_signal_reader_read_async()
+ *
+ * Returns: TRUE if the read was still parked, FALSE if its function
+ * was already called.
+ */
+gboolean gstd_signal_reader_cancel (GstdIReader * iface, guint id);
+
+/**
+ * gstd_signal_reader_read_since:
+ * @iface: The reader of @signal
+ * @signal: The #GstdSignal to read
+ * @since: The last sequence number the client has seen, 0 for all
+ * @max: The maximum amount of callbacks to return
+ * @timeout: Nanoseconds to wait for an emission past @since, -1 for
+ * forever, like gstd_pipeline_bus_read_since()
+ * @response: (out) (transfer full): The formatted batch
+ *
+ * Reads the emissions after @since without moving the cursor other
+ * readers share, so each client can keep its own. The response holds
+ * "next", the sequence to pass on the following read, "lost", the
+ * emissions dropped before they could be read, and "callbacks".
+ *
+ * Returns: GSTD_EOK
+ */
+GstdReturnCode gstd_signal_reader_read_since (GstdIReader * iface,
+    GstdObject * signal, guint64 since, guint max, gint64 timeout,
+    gchar ** response);
+
+/**
+ * gstd_signal_reader_read_since_async:
+ * @iface: The reader of @signal
+ * @signal: The #GstdSignal to wait for
+ * @since: The last sequence number the client has seen
+ * @func: Called once on the next emission
+ * @user_data: Data to pass to @func
+ *
+ * Waits the way gstd_signal_reader_read_since() does without holding
+ * the calling thread, the emissions are then read with no timeout.
+ * Unlike gstd_signal_reader_read_async(), the emission is not taken
+ * from the other readers.
+ *
+ * Returns: The id to cancel the wait with, 0 if there already is an
+ * emission newer than @since, in which case @func won't be called.
+ */
+guint gstd_signal_reader_read_since_async (GstdIReader * iface,
+    GstdObject * signal, guint64 since, GstdSignalReaderFunc func,
+    gpointer user_data);
+
+/**
+ * gstd_signal_reader_read_since_cancel:
+ * @iface: The reader the wait was parked on
+ * @id: The id given by gstd_signal_reader_read_since_async()
+ *
+ * Returns: TRUE if the wait was still parked, FALSE if its function
+ * was already called.
+ */
+gboolean gstd_signal_reader_read_since_cancel (GstdIReader * iface,
+    guint id);
+
+/**
+ * gstd_signal_reader_set_max_callbacks:
+ * @iface: The reader of the signal
+ * @size: The amount of emissions to keep
+ *
+ * Shrinking keeps the newest emissions, the rest count as dropped.
+ */
+void gstd_signal_reader_set_max_callbacks (GstdIReader * iface, guint size);
+
+/**
+ * gstd_signal_reader_get_stats:
+ * @iface: The reader of the signal
+ * @max_callbacks: (out) (optional): The amount of emissions kept
+ * @last_seq: (out) (optional): The sequence of the last emission
+ * @dropped: (out) (optional): The emissions dropped unread or not
+ */
+void gstd_signal_reader_get_stats (GstdIReader * iface, guint * max_callbacks,
+    guint64 * last_seq, guint64 * dropped);
+
 G_END_DECLS
 #endif // __GSTD_SIGNAL_READER_H__
@@ -24,7 +24,10 @@
 
 #include <string.h>
 
+#include "gstd_bus_msg.h"
+#include "gstd_cbor_writer.h"
 #include "gstd_parser.h"
+#include "gstd_pipeline_bus.h"
 
 #include "gstd_socket.h"
 
@@ -34,6 +37,31 @@ GST_DEBUG_CATEGORY_STATIC (gstd_socket_debug);
 
 #define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
 
+/* How often an idle subscriber is checked for a hang up, in us */
+#define GSTD_SOCKET_SUBSCRIPTION_POLL (500 * G_TIME_SPAN_MILLISECOND)
+
+struct _GstdSocketSubscription
+{
+  GstdPipelineBus *bus;
+  guint id;
+  gint types;
+
+  /* Messages are pulled from the bus ring, so a client falling behind
+   * loses the oldest ones instead of queueing them. Only used by the
+   * reader, as is closed, set once the end was reported. */
+  guint64 seq;
+  gboolean closed;
+
+  /* Protects the fields below, set from the posting thread */
+  GMutex lock;
+  GCond posted;
+  gboolean pending;
+  gboolean ended;
+
+  GstdSocketWakeFunc wake;
+  gpointer user_data;
+};
+
 G_DEFINE_TYPE (GstdSocket, gstd_socket, GSTD_TYPE_IPC);
 
 /* VTable */
@@ -68,6 +96,9 @@ gstd_socket_init (GstdSocket * self)
   GstdIpc *base = GSTD_IPC (self);
   GST_INFO_OBJECT (self, "Initializing gstd Socket");
   self->service = NULL;
+  self->reactor = NULL;
+  self->io_threads = 0;
+  self->max_workers = 0;
   base->enabled = FALSE;
 }
 
@@ -81,6 +112,810 @@ gstd_socket_dispose (GObject * object)
 
 
 
+/*
+ * Describes the peer of @socket for the logs
+ */
+gchar *
+gstd_socket_get_client_info (GSocket * socket)
+{
+  GSocketAddress *remote_addr;
+  GInetAddress *inet_addr;
+  gchar *addr_str;
+  gchar *client_info;
+  guint16 port;
+
+  g_return_val_if_fail (socket, NULL);
+
+  remote_addr = g_socket_get_remote_address (socket, NULL);
+  if (remote_addr && G_IS_INET_SOCKET_ADDRESS (remote_addr)) {
+    inet_addr =
+        g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS
+        (remote_addr));
+    port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (remote_addr));
+    addr_str = g_inet_address_to_string (inet_addr);
+    client_info = g_strdup_printf ("%s:%u", addr_str, port);
+    g_free (addr_str);
+  } else {
+    client_info = g_strdup ("unknown");
+  }
+
+  if (remote_addr)
+    g_object_unref (remote_addr);
+
+  return client_info;
+}
+
+/*
+ * Logs the outcome of a command, at a level according to @ret
+ */
+static void
+gstd_socket_log_result (GstdSession * session, const gchar * client_info,
+    GstdReturnCode ret)
+{
+  if (ret != GSTD_EOK) {
+    GST_WARNING_OBJECT (session, "Command from %s failed: %s (code %d)",
+        client_info, gstd_return_code_to_string (ret), ret);
+  } else {
+    GST_DEBUG_OBJECT (session, "Command from %s succeeded", client_info);
+  }
+}
+
+/*
+ * Runs @command and logs its outcome
+ */
+static GstdReturnCode
+gstd_socket_parse (GstdSession * session, const gchar * client_info,
+    const gchar * command, gchar ** output)
+{
+  GstdReturnCode ret;
+
+  GST_DEBUG_OBJECT (session, "Received command from %s: %.80s%s",
+      client_info, command, strlen (command) > 80 ? "..." : "");
+
+  ret = gstd_parser_parse_cmd (session, command, output);
+  gstd_socket_log_result (session, client_info, ret);
+
+  return ret;
+}
+
+/*
+ * Wraps @output in the response envelope, taking it
+ */
+static gchar *
+gstd_socket_envelope (GstdReturnCode ret, gchar * output)
+{
+  gchar *response;
+  const gchar *description = NULL;
+
+  /* Prepend the code to the output */
+  description = gstd_return_code_to_string (ret);
+  response =
+      g_strdup_printf
+      ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : %s\n}",
+      ret, description, output ? output : "null");
+  g_free (output);
+
+  return response;
+}
+
+/*
+ * Runs @command and wraps its output in the response envelope
+ */
+gchar *
+gstd_socket_run_command (GstdSession * session, const gchar * client_info,
+    const gchar * command)
+{
+  gchar *output = NULL;
+  GstdReturnCode ret;
+
+  ret = gstd_socket_parse (session, client_info, command, &output);
+
+  return gstd_socket_envelope (ret, output);
+}
+
+typedef struct _GstdSocketParked
+{
+  GstdSocketResponseFunc func;
+  gpointer user_data;
+} GstdSocketParked;
+
+static void
+gstd_socket_on_parked (GstdReturnCode ret, gchar * output, gpointer data)
+{
+  GstdSocketParked *parked = data;
+
+  parked->func (gstd_socket_envelope (ret, output), parked->user_data);
+  g_free (parked);
+}
+
+/*
+ * Like gstd_socket_run_command(), except that a command waiting for a
+ * bus message or a signal is parked, see gstd_parser_parse_cmd_async().
+ * Returns FALSE in that case, @func gets the response later on.
+ */
+gboolean
+gstd_socket_run_command_async (GstdSession * session,
+    const gchar * client_info, const gchar * command,
+    GCancellable * cancellable, GstdSocketResponseFunc func,
+    gpointer user_data, gchar ** response)
+{
+  GstdSocketParked *parked;
+  gchar *output = NULL;
+  GstdReturnCode ret;
+
+  GST_DEBUG_OBJECT (session, "Received command from %s: %.80s%s",
+      client_info, command, strlen (command) > 80 ? "..." : "");
+
+  parked = g_new (GstdSocketParked, 1);
+  parked->func = func;
+  parked->user_data = user_data;
+
+  if (!gstd_parser_parse_cmd_async (session, command, cancellable,
+          gstd_socket_on_parked, parked, &ret, &output)) {
+    GST_DEBUG_OBJECT (session, "Command from %s parked", client_info);
+    return FALSE;
+  }
+  g_free (parked);
+
+  gstd_socket_log_result (session, client_info, ret);
+
+  *response = gstd_socket_envelope (ret, output);
+  return TRUE;
+}
+
+/*
+ * Checks whether @message asks to switch to framed mode. On success
+ * @consumed holds the amount of bytes that belong to the hello, any
+ * remaining ones are already framed, and @encoding the payload
+ * encoding requested.
+ */
+gboolean
+gstd_socket_is_framed_hello (const gchar * message, gsize len,
+    gsize * consumed, GstdSocketEncoding * encoding)
+{
+  const gsize hello_len = strlen (GSTD_SOCKET_FRAMED_HELLO);
+  const gsize cbor_len = strlen (GSTD_SOCKET_CBOR_HELLO);
+  gsize end;
+
+  if (len < hello_len || strncmp (message, GSTD_SOCKET_FRAMED_HELLO,
+          hello_len)) {
+    return FALSE;
+  }
+
+  if (len >= cbor_len && 0 == strncmp (message, GSTD_SOCKET_CBOR_HELLO,
+          cbor_len)) {
+    end = cbor_len;
+    *encoding = GSTD_SOCKET_ENCODING_CBOR;
+  } else {
+    end = hello_len;
+    *encoding = GSTD_SOCKET_ENCODING_JSON;
+  }
+
+  /* Allow the hello to be terminated by a newline or a NUL */
+  if (len == end) {
+    *consumed = end;
+    return TRUE;
+  }
+
+  if ('\n' == message[end] || '\0' == message[end]) {
+    *consumed = end + 1;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*
+ * Response to the framed hello, sent NUL terminated as a legacy one
+ */
+gchar *
+gstd_socket_framed_ack (GstdSocketEncoding encoding)
+{
+  if (GSTD_SOCKET_ENCODING_CBOR == encoding) {
+    return g_strdup_printf ("{\n  \"code\" : %d,\n  \"description\" : "
+        "\"%s\",\n  \"response\" : {\n    \"protocol\" : \"framed\",\n"
+        "    \"encoding\" : \"cbor\"\n  }\n}",
+        GSTD_EOK, gstd_return_code_to_string (GSTD_EOK));
+  }
+
+  return g_strdup_printf ("{\n  \"code\" : %d,\n  \"description\" : "
+      "\"%s\",\n  \"response\" : {\n    \"protocol\" : \"framed\"\n  }\n}",
+      GSTD_EOK, gstd_return_code_to_string (GSTD_EOK));
+}
+
+/*
+ * Appends the response to the frame @id to @out, taking @output
+ */
+static void
+gstd_socket_append_frame (GByteArray * out, guint32 id,
+    GstdSocketEncoding encoding, GstdReturnCode ret, gchar * output)
+{
+  guint8 header[GSTD_SOCKET_FRAME_HEADER_SIZE];
+  GByteArray *cbor_response;
+  gchar *response;
+  gsize response_len;
+
+  GST_WRITE_UINT32_BE (header + 4, id);
+
+  if (GSTD_SOCKET_ENCODING_CBOR == encoding) {
+    cbor_response = gstd_cbor_envelope (ret, gstd_return_code_to_string (ret),
+        output);
+    g_free (output);
+
+    GST_WRITE_UINT32_BE (header, cbor_response->len);
+    g_byte_array_append (out, header, sizeof (header));
+    g_byte_array_append (out, cbor_response->data, cbor_response->len);
+    g_byte_array_unref (cbor_response);
+    return;
+  }
+
+  response = gstd_socket_envelope (ret, output);
+  response_len = strlen (response);
+
+  GST_WRITE_UINT32_BE (header, response_len);
+  g_byte_array_append (out, header, sizeof (header));
+  g_byte_array_append (out, (const guint8 *) response, response_len);
+  g_free (response);
+}
+
+typedef struct _GstdSocketParkedFrame
+{
+  GstdSocketFrameFunc func;
+  gpointer user_data;
+  GstdSocketEncoding encoding;
+  guint32 id;
+} GstdSocketParkedFrame;
+
+static void
+gstd_socket_on_frame_parked (GstdReturnCode ret, gchar * output, gpointer data)
+{
+  GstdSocketParkedFrame *parked = data;
+  GByteArray *frame;
+
+  frame = g_byte_array_new ();
+  gstd_socket_append_frame (frame, parked->id, parked->encoding, ret, output);
+
+  /* The function takes the frame and the reference */
+  parked->func (frame, parked->user_data);
+  g_free (parked);
+}
+
+/*
+ * Runs the command of the frame @id, appending its response to @out
+ * unless it was parked
+ */
+static void
+gstd_socket_run_frame (GstdSession * session, const gchar * client_info,
+    GstdSocketEncoding encoding, guint32 id, const gchar * command,
+    GByteArray * out, GCancellable * cancellable, GstdSocketFrameFunc func,
+    GBoxedCopyFunc ref, GDestroyNotify unref, gpointer user_data)
+{
+  GstdSocketParkedFrame *parked;
+  gchar *output = NULL;
+  GstdReturnCode ret;
+  gboolean completed;
+
+  GST_DEBUG_OBJECT (session, "Received frame %u from %s: %.80s%s", id,
+      client_info, command, strlen (command) > 80 ? "..." : "");
+
+  parked = g_new (GstdSocketParkedFrame, 1);
+  parked->func = func;
+  parked->user_data = ref (user_data);
+  parked->encoding = encoding;
+  parked->id = id;
+
+  /* Every object is serialized as CBOR, parked ones too */
+  if (GSTD_SOCKET_ENCODING_CBOR == encoding)
+    gstd_object_set_thread_formatter (GSTD_TYPE_CBOR_WRITER);
+
+  completed = gstd_parser_parse_cmd_async (session, command, cancellable,
+      gstd_socket_on_frame_parked, parked, &ret, &output);
+
+  if (GSTD_SOCKET_ENCODING_CBOR == encoding)
+    gstd_object_set_thread_formatter (0);
+
+  if (!completed) {
+    GST_DEBUG_OBJECT (session, "Frame %u from %s parked", id, client_info);
+    return;
+  }
+
+  unref (parked->user_data);
+  g_free (parked);
+
+  gstd_socket_log_result (session, client_info, ret);
+  gstd_socket_append_frame (out, id, encoding, ret, output);
+}
+
+/*
+ * Runs every complete frame in @in, removing it, and appends the
+ * framed responses to @out. Frames waiting for a bus message or a
+ * signal are parked, see gstd_parser_parse_cmd_async(), and @func
+ * gets their responses later on, each holding a reference on
+ * @user_data taken with @ref. Returns FALSE if the client broke the
+ * protocol and the connection must be closed.
+ */
+gboolean
+gstd_socket_process_frames (GstdSession * session, GByteArray * in,
+    GByteArray * out, const gchar * client_info, GstdSocketEncoding encoding,
+    GCancellable * cancellable, GstdSocketFrameFunc func, GBoxedCopyFunc ref,
+    GDestroyNotify unref, gpointer user_data, guint * command_count)
+{
+  const guint8 nul = '\0';
+  gchar *command;
+  gsize offset;
+  guint32 length;
+  guint32 id;
+  gchar saved;
+  gboolean ret = TRUE;
+
+  /* Keep a spare byte after the data to NUL terminate the last frame */
+  g_byte_array_append (in, &nul, 1);
+  g_byte_array_set_size (in, in->len - 1);
+
+  for (offset = 0; in->len - offset >= GSTD_SOCKET_FRAME_HEADER_SIZE;
+      offset += GSTD_SOCKET_FRAME_HEADER_SIZE + length) {
+    length = GST_READ_UINT32_BE (in->data + offset);
+    id = GST_READ_UINT32_BE (in->data + offset + 4);
+
+    if (length > GSTD_SOCKET_MAX_FRAME_SIZE) {
+      GST_WARNING_OBJECT (session, "Frame of %u bytes from %s exceeds the "
+          "%u bytes limit, closing", length, client_info,
+          GSTD_SOCKET_MAX_FRAME_SIZE);
+      ret = FALSE;
+      break;
+    }
+
+    if (in->len - offset - GSTD_SOCKET_FRAME_HEADER_SIZE < length) {
+      break;
+    }
+
+    command = (gchar *) in->data + offset + GSTD_SOCKET_FRAME_HEADER_SIZE;
+    (*command_count)++;
+
+    if (GSTD_SOCKET_ENCODING_CBOR == encoding) {
+      command = gstd_cbor_to_command ((const guint8 *) command, length);
+      if (NULL == command) {
+        GST_WARNING_OBJECT (session, "Malformed CBOR request from %s",
+            client_info);
+        gstd_socket_append_frame (out, id, encoding, GSTD_BAD_COMMAND, NULL);
+        continue;
+      }
+
+      gstd_socket_run_frame (session, client_info, encoding, id, command, out,
+          cancellable, func, ref, unref, user_data);
+      g_free (command);
+      continue;
+    }
+
+    /* Terminate the command in place, the byte belongs to the next frame */
+    saved = command[length];
+    command[length] = '\0';
+    gstd_socket_run_frame (session, client_info, encoding, id, command, out,
+        cancellable, func, ref, unref, user_data);
+    command[length] = saved;
+  }
+  g_byte_array_remove_range (in, 0, offset);
+
+  return ret;
+}
+
+/*
+ * Whether @message asks to follow a pipeline bus
+ */
+gboolean
+gstd_socket_is_subscribe (const gchar * message, gsize len)
+{
+  const gsize subscribe_len = strlen (GSTD_SOCKET_SUBSCRIBE);
+
+  return len > subscribe_len && ' ' == message[subscribe_len]
+      && 0 == strncmp (message, GSTD_SOCKET_SUBSCRIBE, subscribe_len);
+}
+
+static void
+gstd_socket_subscription_push (GstdPipelineBus * bus, GstMessage * message,
+    guint64 seq, gpointer user_data)
+{
+  GstdSocketSubscription *sub = user_data;
+  gboolean pending;
+
+  g_mutex_lock (&sub->lock);
+  pending = sub->pending;
+  sub->pending = TRUE;
+  if (NULL == message) {
+    sub->ended = TRUE;
+  }
+  g_cond_signal (&sub->posted);
+  g_mutex_unlock (&sub->lock);
+
+  /* The reader pulls everything until it catches up, it only needs
+   * waking after that */
+  if (sub->wake && !pending) {
+    sub->wake (sub->user_data);
+  }
+}
+
+/*
+ * Subscribes to the bus named in @command, "bus_subscribe <pipeline>
+ * [types]". @response is set to the response to send back either way,
+ * NULL is returned on failure.
+ */
+GstdSocketSubscription *
+gstd_socket_subscribe (GstdSession * session, const gchar * client_info,
+    const gchar * command, GstdSocketWakeFunc wake, gpointer user_data,
+    gchar ** response)
+{
+  GstdSocketSubscription *sub = NULL;
+  GstdObject *bus = NULL;
+  GstdReturnCode ret;
+  gchar **tokens;
+  gchar *uri;
+  gint types;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), NULL);
+  g_return_val_if_fail (command, NULL);
+  g_return_val_if_fail (response, NULL);
+
+  tokens = g_strsplit (command, " ", 3);
+  if (NULL == tokens[1] || '\0' == g_strstrip (tokens[1])[0]) {
+    ret = GSTD_BAD_COMMAND;
+    goto out;
+  }
+
+  uri = g_strdup_printf ("/pipelines/%s/bus", tokens[1]);
+  ret = gstd_get_by_uri (session, uri, &bus);
+  g_free (uri);
+  if (ret) {
+    goto out;
+  }
+
+  if (tokens[2]) {
+    if (!gstd_pipeline_bus_parse_types (g_strstrip (tokens[2]), &types)) {
+      ret = GSTD_BAD_VALUE;
+      goto out;
+    }
+  } else {
+    g_object_get (bus, "types", &types, NULL);
+  }
+
+  sub = g_new0 (GstdSocketSubscription, 1);
+  sub->bus = GSTD_PIPELINE_BUS (g_object_ref (bus));
+  sub->types = types;
+  g_mutex_init (&sub->lock);
+  g_cond_init (&sub->posted);
+  sub->wake = wake;
+  sub->user_data = user_data;
+
+  /* Starts with the messages posted from now on */
+  g_object_get (bus, "last-seq", &sub->seq, NULL);
+  sub->id = gstd_pipeline_bus_subscribe (sub->bus, types,
+      GSTD_PIPELINE_BUS_SEQ_NONE, gstd_socket_subscription_push, sub, NULL);
+  if (0 == sub->id) {
+    gstd_socket_subscription_free (sub);
+    sub = NULL;
+    ret = GSTD_NO_PIPELINE;
+    goto out;
+  }
+
+  GST_INFO_OBJECT (session, "Client %s subscribed to %s", client_info,
+      tokens[1]);
+
+out:
+  if (ret) {
+    GST_WARNING_OBJECT (session, "Subscription from %s failed: %s (code %d)",
+        client_info, gstd_return_code_to_string (ret), ret);
+  }
+
+  *response = g_strdup_printf
+      ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : null\n}",
+      ret, gstd_return_code_to_string (ret));
+
+  if (bus) {
+    g_object_unref (bus);
+  }
+  g_strfreev (tokens);
+
+  return sub;
+}
+
+/*
+ * Waits up to @timeout us, or forever if negative, for the next
+ * message and returns its response. If the client fell behind and
+ * messages were dropped from the bus, a response holding the amount
+ * "lost" comes first. NULL is returned if none arrived or the
+ * subscription ended, which is flagged in @closed.
+ */
+gchar *
+gstd_socket_subscription_next (GstdSocketSubscription * sub, gint64 timeout,
+    gboolean * closed)
+{
+  GstdBusMsg *busmsg;
+  GstMessage *message;
+  gchar *output = NULL;
+  gchar *response;
+  guint64 lost;
+  gint64 deadline;
+  gboolean ended;
+
+  g_return_val_if_fail (sub, NULL);
+  g_return_val_if_fail (closed, NULL);
+
+  *closed = sub->closed;
+  if (sub->closed) {
+    return NULL;
+  }
+
+  deadline = timeout > 0 ? g_get_monotonic_time () + timeout : timeout;
+
+  while (TRUE) {
+    /* Checked first, the messages posted before the end still go */
+    g_mutex_lock (&sub->lock);
+    ended = sub->ended;
+    g_mutex_unlock (&sub->lock);
+
+    message = gstd_pipeline_bus_next (sub->bus, &sub->seq, sub->types, &lost);
+    if (message || lost) {
+      break;
+    }
+
+    if (ended) {
+      sub->closed = *closed = TRUE;
+      return NULL;
+    }
+
+    /* Caught up, a message posted from now on is pulled right away */
+    g_mutex_lock (&sub->lock);
+    while (!sub->pending && 0 != deadline) {
+      if (deadline < 0) {
+        g_cond_wait (&sub->posted, &sub->lock);
+      } else if (!g_cond_wait_until (&sub->posted, &sub->lock, deadline)) {
+        break;
+      }
+    }
+    if (!sub->pending) {
+      g_mutex_unlock (&sub->lock);
+      return NULL;
+    }
+    sub->pending = FALSE;
+    g_mutex_unlock (&sub->lock);
+  }
+
+  if (lost) {
+    GST_INFO_OBJECT (sub->bus, "Subscriber fell behind, %" G_GUINT64_FORMAT
+        " messages lost", lost);
+    return g_strdup_printf ("{\n  \"code\" : %d,\n  \"description\" : "
+        "\"%s\",\n  \"response\" : {\n    \"lost\" : %" G_GUINT64_FORMAT
+        "\n  }\n}", GSTD_EOK, gstd_return_code_to_string (GSTD_EOK), lost);
+  }
+
+  /* The bus message takes the reference */
+  busmsg = gstd_bus_msg_factory_make (message);
+  gstd_object_to_string (GSTD_OBJECT (busmsg), &output);
+  g_object_unref (busmsg);
+
+  response = g_strdup_printf
+      ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : %s\n}",
+      GSTD_EOK, gstd_return_code_to_string (GSTD_EOK),
+      output ? output : "null");
+  g_free (output);
+
+  return response;
+}
+
+void
+gstd_socket_subscription_free (GstdSocketSubscription * sub)
+{
+  g_return_if_fail (sub);
+
+  /* Nothing is posted to it once this returns */
+  if (sub->id) {
+    gstd_pipeline_bus_unsubscribe (sub->bus, sub->id);
+  }
+
+  g_cond_clear (&sub->posted);
+  g_mutex_clear (&sub->lock);
+  g_object_unref (sub->bus);
+  g_free (sub);
+}
+
+/*
+ * Pushes the bus messages of the subscription in @command until the
+ * client leaves or the pipeline is deleted
+ */
+static void
+gstd_socket_serve_subscription (GstdSession * session, GSocket * socket,
+    GInputStream * istream, GOutputStream * ostream, const gchar * command,
+    const gchar * client_info)
+{
+  GstdSocketSubscription *sub;
+  gchar *response = NULL;
+  gchar discard[256];
+  gboolean closed = FALSE;
+  gssize read;
+  GError *error = NULL;
+
+  sub = gstd_socket_subscribe (session, client_info, command, NULL, NULL,
+      &response);
+
+  while (response) {
+    if (!g_output_stream_write_all (ostream, response, strlen (response) + 1,
+            NULL, NULL, &error)) {
+      GST_WARNING_OBJECT (session, "Write error to %s: %s", client_info,
+          error->message);
+      g_error_free (error);
+      g_free (response);
+      break;
+    }
+    g_free (response);
+
+    response = NULL;
+    while (sub && !response && !closed) {
+      response = gstd_socket_subscription_next (sub,
+          GSTD_SOCKET_SUBSCRIPTION_POLL, &closed);
+
+      /* Nothing new, make sure the client is still there */
+      if (!response && g_socket_condition_check (socket,
+              G_IO_IN | G_IO_HUP | G_IO_ERR)) {
+        read = g_input_stream_read (istream, discard, sizeof (discard), NULL,
+            NULL);
+        if (read <= 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  if (sub) {
+    GST_INFO_OBJECT (session, "Client %s subscription ended", client_info);
+    gstd_socket_subscription_free (sub);
+  }
+}
+
+/*
+ * A framed connection of the threaded service. The responses of the
+ * parked frames are written from the park thread, so writes are
+ * serialized, and it lives until the last of them completed.
+ */
+typedef struct _GstdSocketFramed
+{
+  gint refcount;
+  GstdSession *session;
+  gchar *client_info;
+  GCancellable *cancellable;
+
+  /* Protects the fields below */
+  GMutex lock;
+  GOutputStream *ostream;
+  gboolean closed;
+} GstdSocketFramed;
+
+static gpointer
+gstd_socket_framed_ref (gpointer data)
+{
+  GstdSocketFramed *framed = data;
+
+  g_atomic_int_inc (&framed->refcount);
+
+  return framed;
+}
+
+static void
+gstd_socket_framed_unref (gpointer data)
+{
+  GstdSocketFramed *framed = data;
+
+  if (!g_atomic_int_dec_and_test (&framed->refcount))
+    return;
+
+  g_object_unref (framed->ostream);
+  g_object_unref (framed->cancellable);
+  g_object_unref (framed->session);
+  g_free (framed->client_info);
+  g_mutex_clear (&framed->lock);
+  g_free (framed);
+}
+
+/*
+ * Writes @data to the client unless the connection is closed, which
+ * it is on failure. Returns FALSE if it is.
+ */
+static gboolean
+gstd_socket_framed_write (GstdSocketFramed * framed, GByteArray * data)
+{
+  GError *error = NULL;
+  gboolean ret;
+
+  g_mutex_lock (&framed->lock);
+  if (!framed->closed && data->len
+      && !g_output_stream_write_all (framed->ostream, data->data, data->len,
+          NULL, NULL, &error)) {
+    GST_WARNING_OBJECT (framed->session, "Write error to %s: %s",
+        framed->client_info, error->message);
+    g_error_free (error);
+    framed->closed = TRUE;
+  }
+  ret = !framed->closed;
+  g_mutex_unlock (&framed->lock);
+
+  return ret;
+}
+
+/*
+ * Park thread: sends the response of a parked frame
+ */
+static void
+gstd_socket_framed_resume (GByteArray * frame, gpointer data)
+{
+  GstdSocketFramed *framed = data;
+
+  gstd_socket_framed_write (framed, frame);
+  g_byte_array_unref (frame);
+  gstd_socket_framed_unref (framed);
+}
+
+/*
+ * Serves a connection in framed mode until it is closed or a protocol
+ * error occurs. @pending holds bytes already read from the client.
+ * The responses of all the frames that arrived together are written
+ * back at once, the ones of parked frames as they complete.
+ */
+static void
+gstd_socket_serve_framed (GstdSession * session, GInputStream * istream,
+    GOutputStream * ostream, GByteArray * pending, const gchar * client_info,
+    GstdSocketEncoding encoding, guint * command_count)
+{
+  const guint size = 64 * 1024;
+  GstdSocketFramed *framed;
+  GByteArray *out;
+  guint8 *chunk;
+  gssize read;
+  GError *error = NULL;
+
+  framed = g_new0 (GstdSocketFramed, 1);
+  framed->refcount = 1;
+  framed->session = g_object_ref (session);
+  framed->client_info = g_strdup (client_info);
+  framed->cancellable = g_cancellable_new ();
+  g_mutex_init (&framed->lock);
+  framed->ostream = g_object_ref (ostream);
+
+  out = g_byte_array_new ();
+  chunk = g_malloc (size);
+
+  while (gstd_socket_process_frames (session, pending, out, client_info,
+          encoding, framed->cancellable, gstd_socket_framed_resume,
+          gstd_socket_framed_ref, gstd_socket_framed_unref, framed,
+          command_count)) {
+    if (!gstd_socket_framed_write (framed, out)) {
+      break;
+    }
+    g_byte_array_set_size (out, 0);
+
+    read = g_input_stream_read (istream, chunk, size, NULL, &error);
+    if (read < 0) {
+      GST_WARNING_OBJECT (session, "Read error from %s: %s",
+          client_info, error->message);
+      g_error_free (error);
+      break;
+    } else if (0 == read) {
+      GST_DEBUG_OBJECT (session, "Client %s closed connection after %u "
+          "commands", client_info, *command_count);
+      break;
+    }
+
+    g_byte_array_append (pending, chunk, read);
+  }
+
+  /* The frames still parked end early and complete into the void */
+  g_mutex_lock (&framed->lock);
+  framed->closed = TRUE;
+  g_mutex_unlock (&framed->lock);
+  g_cancellable_cancel (framed->cancellable);
+  gstd_socket_framed_unref (framed);
+
+  g_free (chunk);
+  g_byte_array_unref (out);
+}
+
 static gboolean
 gstd_socket_callback (GSocketService * service,
     GSocketConnection * connection, GObject * source_object, gpointer user_data)
@@ -90,43 +925,29 @@ gstd_socket_callback (GSocketService * service,
   GOutputStream *ostream;
   gint read;
   const guint size = 1024 * 1024;
-  gchar *output = NULL;
   gchar *response = NULL;
   gchar *message;
-  GstdReturnCode ret;
-  const gchar *description = NULL;
   GError *error = NULL;
-  GSocketAddress *remote_addr = NULL;
   gchar *client_info = NULL;
   guint command_count = 0;
+  GByteArray *pending;
+  gsize consumed;
+  GstdSocketEncoding encoding;
 
   g_return_val_if_fail (service, FALSE);
   g_return_val_if_fail (connection, FALSE);
   g_return_val_if_fail (user_data, FALSE);
 
-  session = GSTD_SESSION (user_data);
+  session = GSTD_IPC (user_data)->session;
   g_return_val_if_fail (session, FALSE);
 
-  /* Log client connection */
-  remote_addr = g_socket_connection_get_remote_address (connection, NULL);
-  if (remote_addr && G_IS_INET_SOCKET_ADDRESS (remote_addr)) {
-    GInetAddress *inet_addr;
-    gchar *addr_str;
-    guint16 port;
-    inet_addr = g_inet_socket_address_get_address (
-        G_INET_SOCKET_ADDRESS (remote_addr));
-    port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (remote_addr));
-    addr_str = g_inet_address_to_string (inet_addr);
-    client_info = g_strdup_printf ("%s:%u", addr_str, port);
-    g_free (addr_str);
-    GST_DEBUG_OBJECT (session, "Client connected: %s", client_info);
-    g_object_unref (remote_addr);
-  } else {
-    client_info = g_strdup ("unknown");
-    GST_DEBUG_OBJECT (session, "Client connected (address unavailable)");
-    if (remote_addr)
-      g_object_unref (remote_addr);
-  }
+  /* Each connection gets its own thread */
+  gstd_metrics_set_thread_ipc (GSTD_SOCKET_GET_CLASS (user_data)->ipc);
+
+  client_info =
+      gstd_socket_get_client_info (g_socket_connection_get_socket
+      (connection));
+  GST_DEBUG_OBJECT (session, "Client connected: %s", client_info);
 
   istream = g_io_stream_get_input_stream (G_IO_STREAM (connection));
   ostream = g_io_stream_get_output_stream (G_IO_STREAM (connection));
@@ -134,7 +955,8 @@ gstd_socket_callback (GSocketService * service,
   message = g_malloc (size);
 
   while (TRUE) {
-    read = g_input_stream_read (istream, message, size, NULL, &error);
+    /* Leave room for the NUL terminator */
+    read = g_input_stream_read (istream, message, size - 1, NULL, &error);
 
     /* Was connection closed or error? */
     if (read <= 0) {
@@ -150,29 +972,45 @@ gstd_socket_callback (GSocketService * service,
       break;
     }
     message[read] = '\0';
-    command_count++;
 
-    GST_DEBUG_OBJECT (session, "Received command from %s: %.80s%s",
-        client_info, message, strlen (message) > 80 ? "..." : "");
+    if (gstd_socket_is_framed_hello (message, read, &consumed, &encoding)) {
+      GST_INFO_OBJECT (session, "Client %s switched to framed mode%s",
+          client_info,
+          GSTD_SOCKET_ENCODING_CBOR == encoding ? " with CBOR" : "");
+
+      /* Anything after the hello is already framed */
+      pending = g_byte_array_new ();
+      g_byte_array_append (pending, (const guint8 *) message + consumed,
+          read - consumed);
 
-    ret = gstd_parser_parse_cmd (session, message, &output);
+      response = gstd_socket_framed_ack (encoding);
 
-    /* Log command result at appropriate level */
-    if (ret != GSTD_EOK) {
-      GST_WARNING_OBJECT (session, "Command from %s failed: %s (code %d)",
-          client_info, gstd_return_code_to_string (ret), ret);
-    } else {
-      GST_DEBUG_OBJECT (session, "Command from %s succeeded", client_info);
+      if (g_output_stream_write_all (ostream, response, strlen (response) + 1,
+              NULL, NULL, &error)) {
+        gstd_socket_serve_framed (session, istream, ostream, pending,
+            client_info, encoding, &command_count);
+      } else {
+        GST_WARNING_OBJECT (session, "Write error to %s: %s",
+            client_info, error->message);
+        g_error_free (error);
+        error = NULL;
+      }
+
+      g_free (response);
+      response = NULL;
+      g_byte_array_unref (pending);
+      break;
     }
 
-    /* Prepend the code to the output */
-    description = gstd_return_code_to_string (ret);
-    response =
-        g_strdup_printf
-        ("{\n  \"code\" : %d,\n  \"description\" : \"%s\",\n  \"response\" : %s\n}",
-        ret, description, output ? output : "null");
-    g_free (output);
-    output = NULL;
+    if (gstd_socket_is_subscribe (message, read)) {
+      gstd_socket_serve_subscription (session,
+          g_socket_connection_get_socket (connection), istream, ostream,
+          message, client_info);
+      break;
+    }
+
+    command_count++;
+    response = gstd_socket_run_command (session, client_info, message);
 
     read =
         g_output_stream_write (ostream, response, strlen (response) + 1, NULL,
@@ -209,6 +1047,49 @@ gstd_socket_callback (GSocketService * service,
   return TRUE;
 }
 
+static GstdReturnCode
+gstd_socket_start_reactor (GstdSocket * self, GstdSession * session)
+{
+  GstdSocketReactor *reactor;
+  GList *addresses = NULL;
+  GList *iter;
+  GError *error = NULL;
+  GstdReturnCode ret;
+
+  ret = GSTD_SOCKET_GET_CLASS (self)->get_addresses (self, &addresses);
+  if (ret != GSTD_EOK)
+    return ret;
+
+  reactor = gstd_socket_reactor_new (session,
+      GSTD_SOCKET_GET_CLASS (self)->ipc, self->io_threads, self->max_workers);
+
+  for (iter = addresses; iter; iter = iter->next) {
+    if (!gstd_socket_reactor_listen (reactor, G_SOCKET_ADDRESS (iter->data),
+            &error))
+      goto noconnection;
+  }
+
+  if (!gstd_socket_reactor_start (reactor, &error))
+    goto noconnection;
+
+  GST_INFO_OBJECT (self, "Serving from %d I/O threads", self->io_threads);
+
+  g_list_free_full (addresses, g_object_unref);
+  self->reactor = reactor;
+
+  return GSTD_EOK;
+
+noconnection:
+  {
+    GST_ERROR_OBJECT (self, "%s", error->message);
+    g_printerr ("%s\n", error->message);
+    g_error_free (error);
+    g_list_free_full (addresses, g_object_unref);
+    gstd_socket_reactor_free (reactor);
+    return GSTD_NO_CONNECTION;
+  }
+}
+
 static GstdReturnCode
 gstd_socket_start (GstdIpc * base, GstdSession * session)
 {
@@ -221,6 +1102,14 @@ gstd_socket_start (GstdIpc * base, GstdSession * session)
   /* Close any existing connection */
   gstd_socket_stop (base);
 
+  if (self->io_threads > 0) {
+    if (gstd_socket_reactor_is_supported ())
+      return gstd_socket_start_reactor (self, session);
+
+    GST_WARNING_OBJECT (self, "Event loop backend not supported, falling "
+        "back to one thread per connection");
+  }
+
   service = self->service;
 
   ret = GSTD_SOCKET_GET_CLASS (self)->create_socket_service (self, &service);
@@ -229,10 +1118,11 @@ gstd_socket_start (GstdIpc * base, GstdSession * session)
     return ret;
 
   /* listen to the 'incoming' signal */
-  g_signal_connect (service, "run", G_CALLBACK (gstd_socket_callback), session);
+  g_signal_connect (service, "run", G_CALLBACK (gstd_socket_callback), self);
 
   /* start the socket service */
   g_socket_service_start (service);
+  self->service = service;
 
   return GSTD_EOK;
 }
@@ -258,5 +1148,11 @@ gstd_socket_stop (GstdIpc * base)
     g_socket_service_stop (service);
     g_object_unref (service);
   }
+  if (self->reactor) {
+    GST_INFO_OBJECT (session, "Stopping SOCKET event loop for %s",
+        GSTD_OBJECT_NAME (session));
+    gstd_socket_reactor_free (self->reactor);
+    self->reactor = NULL;
+  }
   return GSTD_EOK;
 }
@@ -23,8 +23,47 @@
 #include <gio/gio.h>
 
 #include "gstd_ipc.h"
+#include "gstd_metrics.h"
+#include "gstd_socket_reactor.h"
 
 G_BEGIN_DECLS
+
+/*
+ * Wire protocol
+ *
+ * By default every read is treated as one command and every response
+ * is a NUL terminated JSON string. A client may switch its connection
+ * to framed mode by sending GSTD_SOCKET_FRAMED_HELLO as its command;
+ * the server acknowledges with a regular response and from then on
+ * both directions use frames:
+ *
+ *   | length (u32, big endian) | id (u32, big endian) | payload |
+ *
+ * The payload is the command (not NUL terminated) or its JSON response.
+ * Responses carry the id of the request they answer and are sent in
+ * request order, so a client may send many requests before reading
+ * any of the replies.
+ *
+ * Sending GSTD_SOCKET_CBOR_HELLO instead also switches the payloads to
+ * CBOR (RFC 8949): requests are a text string with the command or an
+ * array with its words, and responses are a map with the same code,
+ * description and response members as the JSON envelope. The ack is
+ * still JSON and carries "encoding" : "cbor".
+ *
+ * A legacy connection may instead send GSTD_SOCKET_SUBSCRIBE followed
+ * by a pipeline name and optionally the message types, as in
+ * "bus_subscribe p0 error+eos". After the regular response, every bus
+ * message of that pipeline matching the types (or the bus filter) is
+ * pushed as a NUL terminated response until the client disconnects or
+ * the pipeline is deleted. Anything the client sends afterwards is
+ * ignored.
+ */
+#define GSTD_SOCKET_FRAMED_HELLO "protocol framed"
+#define GSTD_SOCKET_CBOR_HELLO "protocol framed cbor"
+#define GSTD_SOCKET_FRAME_HEADER_SIZE 8
+#define GSTD_SOCKET_MAX_FRAME_SIZE (1024 * 1024)
+#define GSTD_SOCKET_SUBSCRIBE "bus_subscribe"
+
 #define GSTD_TYPE_SOCKET \
   (gstd_socket_get_type())
 #define GSTD_SOCKET(obj) \
@@ -40,10 +79,36 @@ G_BEGIN_DECLS
 typedef struct _GstdSocket GstdSocket;
 typedef struct _GstdSocketClass GstdSocketClass;
 
+/* A connection following a pipeline bus */
+typedef struct _GstdSocketSubscription GstdSocketSubscription;
+
+/* Called from the thread posting a message, once there is one to pull */
+typedef void (*GstdSocketWakeFunc) (gpointer user_data);
+
+/* Called from the park thread with the response of a parked command */
+typedef void (*GstdSocketResponseFunc) (gchar * response, gpointer user_data);
+
+/* Called from the park thread with the framed response of a parked
+ * frame, it takes the frame and the reference held on user_data */
+typedef void (*GstdSocketFrameFunc) (GByteArray * frame, gpointer user_data);
+
+/* Payload encoding of a framed connection */
+typedef enum
+{
+  GSTD_SOCKET_ENCODING_JSON,
+  GSTD_SOCKET_ENCODING_CBOR
+} GstdSocketEncoding;
+
 struct _GstdSocket
 {
   GstdIpc parent;
   GSocketService *service;
+
+  /* Event loop backend, used instead of the service when io_threads
+   * is not zero */
+  GstdSocketReactor *reactor;
+  gint io_threads;
+  gint max_workers;
 };
 
 struct _GstdSocketClass
@@ -51,9 +116,38 @@ struct _GstdSocketClass
   GstdIpcClass parent_class;
 
   GstdReturnCode (*create_socket_service) (GstdSocket *, GSocketService **);
+
+  /* Fills a list of GSocketAddress to listen on */
+  GstdReturnCode (*get_addresses) (GstdSocket *, GList **);
+
+  /* The label of the commands received in the metrics */
+  GstdMetricsIpc ipc;
 };
 
 GType gstd_socket_get_type (void);
 
+/* Helpers shared by the threaded service and the reactor */
+gchar *gstd_socket_get_client_info (GSocket * socket);
+gchar *gstd_socket_run_command (GstdSession * session,
+    const gchar * client_info, const gchar * command);
+gboolean gstd_socket_run_command_async (GstdSession * session,
+    const gchar * client_info, const gchar * command,
+    GCancellable * cancellable, GstdSocketResponseFunc func,
+    gpointer user_data, gchar ** response);
+gboolean gstd_socket_is_framed_hello (const gchar * message, gsize len,
+    gsize * consumed, GstdSocketEncoding * encoding);
+gchar *gstd_socket_framed_ack (GstdSocketEncoding encoding);
+gboolean gstd_socket_process_frames (GstdSession * session, GByteArray * in,
+    GByteArray * out, const gchar * client_info, GstdSocketEncoding encoding,
+    GCancellable * cancellable, GstdSocketFrameFunc func, GBoxedCopyFunc ref,
+    GDestroyNotify unref, gpointer user_data, guint * command_count);
+gboolean gstd_socket_is_subscribe (const gchar * message, gsize len);
+GstdSocketSubscription *gstd_socket_subscribe (GstdSession * session,
+    const gchar * client_info, const gchar * command, GstdSocketWakeFunc wake,
+    gpointer user_data, gchar ** response);
+gchar *gstd_socket_subscription_next (GstdSocketSubscription * sub,
+    gint64 timeout, gboolean * closed);
+void gstd_socket_subscription_free (GstdSocketSubscription * sub);
+
 G_END_DECLS
 #endif //__GSTD_SOCKET_H__
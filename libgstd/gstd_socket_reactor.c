@@ -0,0 +1,1204 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#include "gstd_socket.h"
+#include "gstd_socket_reactor.h"
+
+/* Gstd Socket Reactor debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_socket_reactor_debug);
+#define GST_CAT_DEFAULT gstd_socket_reactor_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/* Bytes requested from the kernel on every receive */
+#define GSTD_SOCKET_REACTOR_CHUNK_SIZE 4096
+
+/* Input buffers bigger than this are released once drained, so a
+ * single large command does not pin memory for the connection life */
+#define GSTD_SOCKET_REACTOR_RETAIN_SIZE (64 * 1024)
+
+/* Events fetched from epoll on every wait */
+#define GSTD_SOCKET_REACTOR_MAX_EVENTS 64
+
+#define GSTD_SOCKET_REACTOR_BACKLOG 1024
+
+typedef enum
+{
+  GSTD_SOCKET_SOURCE_LISTENER,
+  GSTD_SOCKET_SOURCE_CONNECTION,
+} GstdSocketSourceType;
+
+typedef struct _GstdSocketLoop GstdSocketLoop;
+typedef struct _GstdSocketSource GstdSocketSource;
+typedef struct _GstdSocketConnection GstdSocketConnection;
+typedef struct _GstdSocketPark GstdSocketPark;
+
+/* Anything registered in epoll starts with this */
+struct _GstdSocketSource
+{
+  GstdSocketSourceType type;
+  GSocket *socket;
+};
+
+/*
+ * A connection is armed in epoll with EPOLLONESHOT, so at any time it
+ * is owned either by its loop thread or by a single worker, and its
+ * fields need no locking.
+ */
+struct _GstdSocketConnection
+{
+  GstdSocketSource source;
+  GstdSocketLoop *loop;
+  GByteArray *in;
+  GByteArray *out;
+  gboolean framed;
+  GstdSocketEncoding encoding;
+  gboolean eof;
+  gchar *client_info;
+  guint command_count;
+
+  /* Set by a worker on bus_subscribe, the loop takes over the
+   * connection on its next wake up and sets streaming */
+  GstdSocketSubscription *subscription;
+  gboolean streaming;
+
+  /* Set by a worker whose command was parked, the connection is only
+   * watched for hang ups until the loop sends the response */
+  GstdSocketPark *park;
+  gboolean parked;
+
+  /* Whether it is in the loop woken list, protected by the loop lock */
+  gboolean woken;
+
+  /* Whether a worker has it, protected by the loop lock. The responses
+   * of parked frames are sent by the worker then, by the loop if not. */
+  gboolean working;
+};
+
+/*
+ * Where the parked command of a connection completes. It outlives the
+ * connection if the reactor stops first, conn is NULL then.
+ */
+struct _GstdSocketPark
+{
+  gint refcount;
+  GMutex lock;
+  GstdSocketConnection *conn;
+  GCancellable *cancellable;
+
+  /* Protected by the loop lock */
+  gchar *response;
+  GByteArray *frames;
+};
+
+struct _GstdSocketLoop
+{
+  GstdSocketReactor *reactor;
+  GThread *thread;
+  gint epoll_fd;
+  gint wakeup_fd;
+
+  /* Protects connections, which is only needed to close them all on
+   * shutdown, and woken */
+  GMutex lock;
+  GHashTable *connections;
+
+  /* Subscribed connections with bus messages to send */
+  GList *woken;
+};
+
+struct _GstdSocketReactor
+{
+  GstdSession *session;
+  GstdMetricsIpc ipc;
+  GPtrArray *listeners;
+  GstdSocketLoop *loops;
+  guint num_loops;
+  guint next_loop;
+  gint max_workers;
+  GThreadPool *workers;
+  gint running;
+};
+
+static void
+gstd_socket_reactor_init_debug (void)
+{
+  static gsize initialized = 0;
+  guint debug_color;
+
+  if (g_once_init_enter (&initialized)) {
+    debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+    GST_DEBUG_CATEGORY_INIT (gstd_socket_reactor_debug, "gstdsocketreactor",
+        debug_color, "Gstd Socket Reactor category");
+    g_once_init_leave (&initialized, 1);
+  }
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+
+static GstdSocketPark *
+gstd_socket_park_new (GstdSocketConnection * conn)
+{
+  GstdSocketPark *park = g_new0 (GstdSocketPark, 1);
+
+  park->refcount = 1;
+  g_mutex_init (&park->lock);
+  park->conn = conn;
+  park->cancellable = g_cancellable_new ();
+  park->frames = g_byte_array_new ();
+
+  return park;
+}
+
+static gpointer
+gstd_socket_park_ref (gpointer data)
+{
+  GstdSocketPark *park = data;
+
+  g_atomic_int_inc (&park->refcount);
+
+  return park;
+}
+
+static void
+gstd_socket_park_unref (gpointer data)
+{
+  GstdSocketPark *park = data;
+
+  if (!g_atomic_int_dec_and_test (&park->refcount))
+    return;
+
+  g_object_unref (park->cancellable);
+  g_mutex_clear (&park->lock);
+  g_free (park->response);
+  g_byte_array_unref (park->frames);
+  g_free (park);
+}
+
+/*
+ * The connection is gone, a command still parked completes into the
+ * void
+ */
+static void
+gstd_socket_park_detach (GstdSocketPark * park)
+{
+  g_mutex_lock (&park->lock);
+  park->conn = NULL;
+  g_mutex_unlock (&park->lock);
+
+  g_cancellable_cancel (park->cancellable);
+  gstd_socket_park_unref (park);
+}
+
+static void
+gstd_socket_connection_free (GstdSocketConnection * conn)
+{
+  GST_DEBUG ("Client disconnected: %s (processed %u commands)",
+      conn->client_info, conn->command_count);
+
+  if (conn->subscription)
+    gstd_socket_subscription_free (conn->subscription);
+
+  if (conn->park)
+    gstd_socket_park_detach (conn->park);
+
+  g_socket_close (conn->source.socket, NULL);
+  g_object_unref (conn->source.socket);
+  g_byte_array_unref (conn->in);
+  g_byte_array_unref (conn->out);
+  g_free (conn->client_info);
+  g_free (conn);
+}
+
+static void
+gstd_socket_connection_close (GstdSocketConnection * conn)
+{
+  GstdSocketLoop *loop = conn->loop;
+  gboolean owned;
+
+  g_mutex_lock (&loop->lock);
+  owned = g_hash_table_remove (loop->connections, conn);
+  if (conn->woken)
+    loop->woken = g_list_remove (loop->woken, conn);
+  g_mutex_unlock (&loop->lock);
+
+  /* The reactor is shutting down and will free it */
+  if (!owned)
+    return;
+
+  epoll_ctl (loop->epoll_fd, EPOLL_CTL_DEL,
+      g_socket_get_fd (conn->source.socket), NULL);
+  gstd_socket_connection_free (conn);
+}
+
+/*
+ * Watches @conn in its loop for input, or for the client to drain its
+ * responses. Returns FALSE on failure.
+ */
+static gboolean
+gstd_socket_connection_watch (GstdSocketConnection * conn, gint op)
+{
+  struct epoll_event event;
+
+  event.events = EPOLLONESHOT | EPOLLRDHUP;
+  event.data.ptr = conn;
+
+  /* Commands wait in the socket while one is parked */
+  if (conn->parked)
+    goto watch;
+
+  /* Stop reading from clients that do not collect their responses */
+  if (conn->out->len < GSTD_SOCKET_MAX_FRAME_SIZE)
+    event.events |= EPOLLIN;
+
+  /* A new subscriber is handed to the loop as soon as it's writable */
+  if (conn->out->len || (conn->subscription && !conn->streaming))
+    event.events |= EPOLLOUT;
+
+watch:
+  if (epoll_ctl (conn->loop->epoll_fd, op,
+          g_socket_get_fd (conn->source.socket), &event)) {
+    GST_ERROR ("Unable to watch %s: %s", conn->client_info,
+        g_strerror (errno));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*
+ * Hands @conn back to its loop
+ */
+static void
+gstd_socket_connection_arm (GstdSocketConnection * conn, gint op)
+{
+  if (!gstd_socket_connection_watch (conn, op))
+    gstd_socket_connection_close (conn);
+}
+
+/*
+ * Queues the responses of the parked frames completed so far, with
+ * the loop lock held
+ */
+static void
+gstd_socket_connection_take_frames (GstdSocketConnection * conn)
+{
+  GByteArray *frames;
+
+  if (NULL == conn->park || 0 == conn->park->frames->len)
+    return;
+
+  frames = conn->park->frames;
+  g_byte_array_append (conn->out, frames->data, frames->len);
+  g_byte_array_set_size (frames, 0);
+}
+
+/*
+ * Worker: hands @conn back to its loop along with the responses of
+ * the frames completed while it had it
+ */
+static void
+gstd_socket_connection_release (GstdSocketConnection * conn)
+{
+  GstdSocketLoop *loop = conn->loop;
+  gboolean watched;
+
+  /* Watched before the lock is released, from then on the loop sends
+   * the frames that complete */
+  g_mutex_lock (&loop->lock);
+  gstd_socket_connection_take_frames (conn);
+  conn->working = FALSE;
+  watched = gstd_socket_connection_watch (conn, EPOLL_CTL_MOD);
+  g_mutex_unlock (&loop->lock);
+
+  if (!watched)
+    gstd_socket_connection_close (conn);
+}
+
+/*
+ * Reads everything available without blocking. Returns FALSE on
+ * error, end of stream is flagged in @conn.
+ */
+static gboolean
+gstd_socket_connection_fill (GstdSocketConnection * conn)
+{
+  GError *error = NULL;
+  gssize read;
+  guint len;
+
+  while (conn->in->len <
+      GSTD_SOCKET_MAX_FRAME_SIZE + GSTD_SOCKET_FRAME_HEADER_SIZE) {
+    len = conn->in->len;
+    g_byte_array_set_size (conn->in, len + GSTD_SOCKET_REACTOR_CHUNK_SIZE);
+
+    read = g_socket_receive (conn->source.socket, (gchar *) conn->in->data +
+        len, GSTD_SOCKET_REACTOR_CHUNK_SIZE, NULL, &error);
+    g_byte_array_set_size (conn->in, len + MAX (read, 0));
+
+    if (read < 0) {
+      if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        g_error_free (error);
+        break;
+      }
+      GST_WARNING ("Read error from %s: %s", conn->client_info,
+          error->message);
+      g_error_free (error);
+      return FALSE;
+    }
+
+    if (0 == read) {
+      conn->eof = TRUE;
+      break;
+    }
+  }
+
+  return TRUE;
+}
+
+/*
+ * Writes as much of the pending output as the socket takes. Returns
+ * FALSE on error.
+ */
+static gboolean
+gstd_socket_connection_flush (GstdSocketConnection * conn)
+{
+  GError *error = NULL;
+  gssize sent;
+
+  while (conn->out->len) {
+    sent = g_socket_send (conn->source.socket, (const gchar *) conn->out->data,
+        conn->out->len, NULL, &error);
+
+    if (sent < 0) {
+      if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        g_error_free (error);
+        return TRUE;
+      }
+      GST_WARNING ("Write error to %s: %s", conn->client_info,
+          error->message);
+      g_error_free (error);
+      return FALSE;
+    }
+
+    g_byte_array_remove_range (conn->out, 0, sent);
+  }
+
+  return TRUE;
+}
+
+/*
+ * Whether the buffered input holds something for a worker
+ */
+static gboolean
+gstd_socket_connection_has_command (GstdSocketConnection * conn)
+{
+  guint32 length;
+
+  if (!conn->framed)
+    return conn->in->len > 0;
+
+  if (conn->in->len < GSTD_SOCKET_FRAME_HEADER_SIZE)
+    return FALSE;
+
+  /* Oversized frames are handed over too, so they get rejected */
+  length = GST_READ_UINT32_BE (conn->in->data);
+  return length > GSTD_SOCKET_MAX_FRAME_SIZE ||
+      conn->in->len >= GSTD_SOCKET_FRAME_HEADER_SIZE + length;
+}
+
+/*
+ * Posting thread: schedules the bus messages of @data for its loop
+ */
+static void
+gstd_socket_connection_wake (gpointer data)
+{
+  GstdSocketConnection *conn = data;
+  GstdSocketLoop *loop = conn->loop;
+  const guint64 one = 1;
+  gboolean wake = FALSE;
+
+  g_mutex_lock (&loop->lock);
+  if (!conn->woken && g_hash_table_contains (loop->connections, conn)) {
+    conn->woken = TRUE;
+    loop->woken = g_list_prepend (loop->woken, conn);
+    wake = TRUE;
+  }
+  g_mutex_unlock (&loop->lock);
+
+  if (wake && write (loop->wakeup_fd, &one, sizeof (one)) < 0) {
+    GST_WARNING ("Unable to wake up I/O thread: %s", g_strerror (errno));
+  }
+}
+
+/*
+ * Park thread: hands the response of a parked command to the loop
+ */
+static void
+gstd_socket_connection_resume (gchar * response, gpointer data)
+{
+  GstdSocketPark *park = data;
+  GstdSocketConnection *conn;
+  GstdSocketLoop *loop;
+  const guint64 one = 1;
+  gboolean wake = FALSE;
+
+  g_mutex_lock (&park->lock);
+  conn = park->conn;
+  if (conn) {
+    loop = conn->loop;
+
+    /* Unless the worker is still parking it, the loop sends it */
+    g_mutex_lock (&loop->lock);
+    park->response = response;
+    response = NULL;
+    if (conn->parked && !conn->woken) {
+      conn->woken = TRUE;
+      loop->woken = g_list_prepend (loop->woken, conn);
+      wake = TRUE;
+    }
+    g_mutex_unlock (&loop->lock);
+
+    if (wake && write (loop->wakeup_fd, &one, sizeof (one)) < 0) {
+      GST_WARNING ("Unable to wake up I/O thread: %s", g_strerror (errno));
+    }
+  }
+  g_mutex_unlock (&park->lock);
+
+  g_free (response);
+  gstd_socket_park_unref (park);
+}
+
+/*
+ * Park thread: hands the response of a parked frame to the loop,
+ * unless a worker has the connection and sends it itself
+ */
+static void
+gstd_socket_connection_resume_frame (GByteArray * frame, gpointer data)
+{
+  GstdSocketPark *park = data;
+  GstdSocketConnection *conn;
+  GstdSocketLoop *loop;
+  const guint64 one = 1;
+  gboolean wake = FALSE;
+
+  g_mutex_lock (&park->lock);
+  conn = park->conn;
+  if (conn) {
+    loop = conn->loop;
+
+    g_mutex_lock (&loop->lock);
+    g_byte_array_append (park->frames, frame->data, frame->len);
+    if (!conn->working && !conn->woken) {
+      conn->woken = TRUE;
+      loop->woken = g_list_prepend (loop->woken, conn);
+      wake = TRUE;
+    }
+    g_mutex_unlock (&loop->lock);
+
+    if (wake && write (loop->wakeup_fd, &one, sizeof (one)) < 0) {
+      GST_WARNING ("Unable to wake up I/O thread: %s", g_strerror (errno));
+    }
+  }
+  g_mutex_unlock (&park->lock);
+
+  g_byte_array_unref (frame);
+  gstd_socket_park_unref (park);
+}
+
+/*
+ * Worker: runs the line command buffered in @conn, parking it if it
+ * waits for an event. Returns NULL if it was parked, @conn belongs to
+ * the loop then.
+ */
+static gchar *
+gstd_socket_connection_run (GstdSocketConnection * conn,
+    GstdSocketReactor * reactor)
+{
+  GstdSocketLoop *loop = conn->loop;
+  struct epoll_event event;
+  gchar *response = NULL;
+
+  if (NULL == conn->park)
+    conn->park = gstd_socket_park_new (conn);
+
+  if (gstd_socket_run_command_async (reactor->session, conn->client_info,
+          (const gchar *) conn->in->data, conn->park->cancellable,
+          gstd_socket_connection_resume, gstd_socket_park_ref (conn->park),
+          &response)) {
+    gstd_socket_park_unref (conn->park);
+    g_byte_array_set_size (conn->in, 0);
+    conn->command_count++;
+    return response;
+  }
+
+  g_byte_array_set_size (conn->in, 0);
+  conn->command_count++;
+
+  /* Watched for hang ups only, before the loop may resume it */
+  event.events = EPOLLONESHOT | EPOLLRDHUP;
+  event.data.ptr = conn;
+
+  g_mutex_lock (&loop->lock);
+  response = conn->park->response;
+  conn->park->response = NULL;
+  conn->parked = NULL == response;
+  conn->working = !conn->parked;
+  if (conn->parked && epoll_ctl (loop->epoll_fd, EPOLL_CTL_MOD,
+          g_socket_get_fd (conn->source.socket), &event)) {
+    GST_ERROR ("Unable to watch %s: %s", conn->client_info,
+        g_strerror (errno));
+    conn->parked = FALSE;
+  }
+  g_mutex_unlock (&loop->lock);
+
+  /* Unless it completed meanwhile, it can't wait unwatched */
+  if (NULL == response && !conn->parked)
+    gstd_socket_connection_close (conn);
+
+  return response;
+}
+
+/*
+ * Loop thread: sends the response of a parked @conn once it arrived
+ */
+static void
+gstd_socket_connection_unpark (GstdSocketConnection * conn)
+{
+  GstdSocketLoop *loop = conn->loop;
+  gchar *response;
+
+  g_mutex_lock (&loop->lock);
+  response = conn->park->response;
+  conn->park->response = NULL;
+  conn->parked = NULL == response;
+  g_mutex_unlock (&loop->lock);
+
+  if (NULL == response)
+    return;
+
+  g_cancellable_reset (conn->park->cancellable);
+  g_byte_array_append (conn->out, (const guint8 *) response,
+      strlen (response) + 1);
+  g_free (response);
+
+  if (!gstd_socket_connection_flush (conn))
+    goto close;
+
+  gstd_socket_connection_arm (conn, EPOLL_CTL_MOD);
+  return;
+
+close:
+  gstd_socket_connection_close (conn);
+}
+
+/*
+ * Loop thread: sends the responses of the parked frames of @conn that
+ * completed while no worker had it
+ */
+static void
+gstd_socket_connection_deliver (GstdSocketConnection * conn)
+{
+  GstdSocketLoop *loop = conn->loop;
+  gboolean working;
+
+  g_mutex_lock (&loop->lock);
+  working = conn->working;
+  if (!working)
+    gstd_socket_connection_take_frames (conn);
+  g_mutex_unlock (&loop->lock);
+
+  /* The worker takes them along before giving it back */
+  if (working)
+    return;
+
+  if (!gstd_socket_connection_flush (conn))
+    goto close;
+
+  gstd_socket_connection_arm (conn, EPOLL_CTL_MOD);
+  return;
+
+close:
+  gstd_socket_connection_close (conn);
+}
+
+/*
+ * Loop thread: pulls the pending bus messages of a subscribed @conn
+ * and sends them
+ */
+static void
+gstd_socket_connection_stream (GstdSocketConnection * conn)
+{
+  gchar *response;
+  gboolean closed = FALSE;
+  gboolean full;
+
+  /* Messages wait in the bus ring while the client is behind, they
+   * are pulled again once the output drained */
+  do {
+    while (conn->out->len < GSTD_SOCKET_MAX_FRAME_SIZE
+        && (response = gstd_socket_subscription_next (conn->subscription, 0,
+                &closed))) {
+      g_byte_array_append (conn->out, (const guint8 *) response,
+          strlen (response) + 1);
+      g_free (response);
+    }
+    full = conn->out->len >= GSTD_SOCKET_MAX_FRAME_SIZE;
+
+    if (!gstd_socket_connection_flush (conn))
+      goto close;
+  } while (full && 0 == conn->out->len);
+
+  if (closed && 0 == conn->out->len)
+    goto close;
+
+  gstd_socket_connection_arm (conn, EPOLL_CTL_MOD);
+  return;
+
+close:
+  gstd_socket_connection_close (conn);
+}
+
+/*
+ * Worker: runs the buffered commands and queues their responses
+ */
+static void
+gstd_socket_connection_process (gpointer data, gpointer user_data)
+{
+  GstdSocketConnection *conn = data;
+  GstdSocketReactor *reactor = user_data;
+  const guint8 nul = '\0';
+  gchar *response;
+  gsize consumed;
+  guint len = conn->in->len;
+
+  gstd_metrics_set_thread_ipc (reactor->ipc);
+
+  if (!conn->framed) {
+    if (gstd_socket_is_subscribe ((const gchar *) conn->in->data,
+            conn->in->len)) {
+      g_byte_array_append (conn->in, &nul, 1);
+      conn->subscription = gstd_socket_subscribe (reactor->session,
+          conn->client_info, (const gchar *) conn->in->data,
+          gstd_socket_connection_wake, conn, &response);
+      g_byte_array_set_size (conn->in, 0);
+    } else if (gstd_socket_is_framed_hello ((const gchar *) conn->in->data,
+            conn->in->len, &consumed, &conn->encoding)) {
+      GST_INFO ("Client %s switched to framed mode%s", conn->client_info,
+          GSTD_SOCKET_ENCODING_CBOR == conn->encoding ? " with CBOR" : "");
+      conn->framed = TRUE;
+      g_byte_array_remove_range (conn->in, 0, consumed);
+      response = gstd_socket_framed_ack (conn->encoding);
+    } else {
+      /* As with the threaded service, a read is a whole command */
+      g_byte_array_append (conn->in, &nul, 1);
+      response = gstd_socket_connection_run (conn, reactor);
+
+      /* Parked, the loop owns it now */
+      if (NULL == response)
+        return;
+    }
+
+    g_byte_array_append (conn->out, (const guint8 *) response,
+        strlen (response) + 1);
+    g_free (response);
+  }
+
+  /* Parked frames don't hold the worker, the connection is given back
+   * to take more and their responses are sent as they complete */
+  if (conn->framed) {
+    if (NULL == conn->park)
+      conn->park = gstd_socket_park_new (conn);
+
+    if (!gstd_socket_process_frames (reactor->session, conn->in, conn->out,
+            conn->client_info, conn->encoding, conn->park->cancellable,
+            gstd_socket_connection_resume_frame, gstd_socket_park_ref,
+            gstd_socket_park_unref, conn->park, &conn->command_count))
+      goto close;
+  }
+
+  if (0 == conn->in->len && len > GSTD_SOCKET_REACTOR_RETAIN_SIZE) {
+    g_byte_array_unref (conn->in);
+    conn->in = g_byte_array_new ();
+  }
+
+  if (!gstd_socket_connection_flush (conn) || conn->eof)
+    goto close;
+
+  gstd_socket_connection_release (conn);
+  return;
+
+close:
+  gstd_socket_connection_close (conn);
+}
+
+/*
+ * Loop thread: handles a wake up of @conn
+ */
+static void
+gstd_socket_connection_dispatch (GstdSocketConnection * conn, guint32 events)
+{
+  GstdSocketReactor *reactor = conn->loop->reactor;
+  GError *error = NULL;
+
+  /* The client hung up while its command was parked, end it so the
+   * loop gets the connection back */
+  if (conn->parked) {
+    g_cancellable_cancel (conn->park->cancellable);
+    return;
+  }
+
+  if (conn->subscription) {
+    conn->streaming = TRUE;
+
+    /* Only hang ups matter, commands aren't taken anymore */
+    if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        && !gstd_socket_connection_fill (conn))
+      goto close;
+    g_byte_array_set_size (conn->in, 0);
+
+    if (conn->eof || (events & EPOLLERR))
+      goto close;
+
+    gstd_socket_connection_stream (conn);
+    return;
+  }
+
+  if ((events & EPOLLOUT) && !gstd_socket_connection_flush (conn))
+    goto close;
+
+  if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+      && !gstd_socket_connection_fill (conn))
+    goto close;
+
+  if (gstd_socket_connection_has_command (conn)) {
+    g_mutex_lock (&conn->loop->lock);
+    conn->working = TRUE;
+    g_mutex_unlock (&conn->loop->lock);
+
+    if (!g_thread_pool_push (reactor->workers, conn, &error)) {
+      GST_ERROR ("Unable to queue command from %s: %s", conn->client_info,
+          error->message);
+      g_error_free (error);
+      goto close;
+    }
+    return;
+  }
+
+  if (conn->eof || (events & EPOLLERR))
+    goto close;
+
+  gstd_socket_connection_arm (conn, EPOLL_CTL_MOD);
+  return;
+
+close:
+  gstd_socket_connection_close (conn);
+}
+
+static void
+gstd_socket_reactor_accept (GstdSocketReactor * reactor,
+    GstdSocketSource * listener)
+{
+  GstdSocketConnection *conn;
+  GstdSocketLoop *loop;
+  GSocket *socket;
+  GError *error = NULL;
+
+  while ((socket = g_socket_accept (listener->socket, NULL, &error))) {
+    g_socket_set_blocking (socket, FALSE);
+
+    /* Spread the clients across the loops */
+    loop = &reactor->loops[reactor->next_loop++ % reactor->num_loops];
+
+    conn = g_new0 (GstdSocketConnection, 1);
+    conn->source.type = GSTD_SOCKET_SOURCE_CONNECTION;
+    conn->source.socket = socket;
+    conn->loop = loop;
+    conn->in = g_byte_array_new ();
+    conn->out = g_byte_array_new ();
+    conn->client_info = gstd_socket_get_client_info (socket);
+
+    GST_DEBUG ("Client connected: %s", conn->client_info);
+
+    g_mutex_lock (&loop->lock);
+    g_hash_table_add (loop->connections, conn);
+    g_mutex_unlock (&loop->lock);
+
+    gstd_socket_connection_arm (conn, EPOLL_CTL_ADD);
+  }
+
+  if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+    GST_WARNING ("Unable to accept connection: %s", error->message);
+  }
+  g_error_free (error);
+}
+
+/*
+ * Sends the bus messages of the woken subscribers. The ones still
+ * being set up by a worker are served on their first loop wake up.
+ */
+static void
+gstd_socket_loop_stream (GstdSocketLoop * loop)
+{
+  GstdSocketConnection *conn;
+  GList *woken;
+  GList *iter;
+
+  g_mutex_lock (&loop->lock);
+  woken = loop->woken;
+  loop->woken = NULL;
+  for (iter = woken; iter; iter = iter->next) {
+    ((GstdSocketConnection *) iter->data)->woken = FALSE;
+  }
+  g_mutex_unlock (&loop->lock);
+
+  for (iter = woken; iter; iter = iter->next) {
+    conn = iter->data;
+    if (conn->streaming)
+      gstd_socket_connection_stream (conn);
+    else if (conn->parked)
+      gstd_socket_connection_unpark (conn);
+    else if (conn->framed)
+      gstd_socket_connection_deliver (conn);
+  }
+  g_list_free (woken);
+}
+
+static gpointer
+gstd_socket_loop_run (gpointer data)
+{
+  GstdSocketLoop *loop = data;
+  GstdSocketReactor *reactor = loop->reactor;
+  struct epoll_event events[GSTD_SOCKET_REACTOR_MAX_EVENTS];
+  GstdSocketSource *source;
+  guint64 value;
+  gboolean woken;
+  gint count;
+  gint i;
+
+  while (g_atomic_int_get (&reactor->running)) {
+    count = epoll_wait (loop->epoll_fd, events,
+        GSTD_SOCKET_REACTOR_MAX_EVENTS, -1);
+
+    if (count < 0) {
+      if (EINTR == errno)
+        continue;
+      GST_ERROR ("Unable to wait for events: %s", g_strerror (errno));
+      break;
+    }
+
+    woken = FALSE;
+    for (i = 0; i < count; i++) {
+      source = events[i].data.ptr;
+
+      /* The wake up event has no source */
+      if (NULL == source) {
+        if (read (loop->wakeup_fd, &value, sizeof (value)) < 0) {
+          GST_DEBUG ("Spurious wake up");
+        }
+        woken = TRUE;
+      } else if (GSTD_SOCKET_SOURCE_LISTENER == source->type) {
+        gstd_socket_reactor_accept (reactor, source);
+      } else {
+        gstd_socket_connection_dispatch ((GstdSocketConnection *) source,
+            events[i].events);
+      }
+    }
+
+    /* Once the whole batch is handled, so none of its events is stale
+     * for a connection re-armed here */
+    if (woken)
+      gstd_socket_loop_stream (loop);
+  }
+
+  return NULL;
+}
+
+static gboolean
+gstd_socket_loop_init (GstdSocketLoop * loop, GstdSocketReactor * reactor,
+    GError ** error)
+{
+  struct epoll_event event;
+
+  loop->reactor = reactor;
+  loop->connections = g_hash_table_new (NULL, NULL);
+  g_mutex_init (&loop->lock);
+
+  loop->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+  loop->wakeup_fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (loop->epoll_fd < 0 || loop->wakeup_fd < 0) {
+    goto error;
+  }
+
+  event.events = EPOLLIN;
+  event.data.ptr = NULL;
+  if (epoll_ctl (loop->epoll_fd, EPOLL_CTL_ADD, loop->wakeup_fd, &event)) {
+    goto error;
+  }
+
+  return TRUE;
+
+error:
+  {
+    g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+        "Unable to create event loop: %s", g_strerror (errno));
+    return FALSE;
+  }
+}
+
+static void
+gstd_socket_loop_clear (GstdSocketLoop * loop)
+{
+  GHashTableIter iter;
+  GstdSocketConnection *conn;
+  gpointer key;
+
+  /* Stop the subscriptions first, they look connections up */
+  g_hash_table_iter_init (&iter, loop->connections);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    conn = key;
+    if (conn->subscription) {
+      gstd_socket_subscription_free (conn->subscription);
+      conn->subscription = NULL;
+    }
+  }
+
+  g_hash_table_iter_init (&iter, loop->connections);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    gstd_socket_connection_free (key);
+  }
+  g_hash_table_unref (loop->connections);
+  g_list_free (loop->woken);
+  g_mutex_clear (&loop->lock);
+
+  if (loop->epoll_fd >= 0)
+    close (loop->epoll_fd);
+  if (loop->wakeup_fd >= 0)
+    close (loop->wakeup_fd);
+}
+
+gboolean
+gstd_socket_reactor_is_supported (void)
+{
+  return TRUE;
+}
+
+gboolean
+gstd_socket_reactor_start (GstdSocketReactor * reactor, GError ** error)
+{
+  GstdSocketSource *listener;
+  struct epoll_event event;
+  gchar *name;
+  guint i;
+
+  g_return_val_if_fail (reactor, FALSE);
+  g_return_val_if_fail (NULL == reactor->loops, FALSE);
+
+  reactor->workers = g_thread_pool_new (gstd_socket_connection_process,
+      reactor, reactor->max_workers, FALSE, error);
+  if (NULL == reactor->workers)
+    return FALSE;
+  gstd_metrics_add_pool (gstd_metrics_ipc_get_name (reactor->ipc),
+      reactor->workers);
+
+  reactor->loops = g_new0 (GstdSocketLoop, reactor->num_loops);
+  for (i = 0; i < reactor->num_loops; i++) {
+    reactor->loops[i].epoll_fd = -1;
+    reactor->loops[i].wakeup_fd = -1;
+  }
+
+  for (i = 0; i < reactor->num_loops; i++) {
+    if (!gstd_socket_loop_init (&reactor->loops[i], reactor, error))
+      return FALSE;
+  }
+
+  /* Connections are accepted by the first loop and spread from there */
+  for (i = 0; i < reactor->listeners->len; i++) {
+    listener = g_ptr_array_index (reactor->listeners, i);
+    event.events = EPOLLIN;
+    event.data.ptr = listener;
+    if (epoll_ctl (reactor->loops[0].epoll_fd, EPOLL_CTL_ADD,
+            g_socket_get_fd (listener->socket), &event)) {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+          "Unable to watch listener: %s", g_strerror (errno));
+      return FALSE;
+    }
+  }
+
+  g_atomic_int_set (&reactor->running, TRUE);
+  for (i = 0; i < reactor->num_loops; i++) {
+    name = g_strdup_printf ("gstd-io-%u", i);
+    reactor->loops[i].thread = g_thread_new (name, gstd_socket_loop_run,
+        &reactor->loops[i]);
+    g_free (name);
+  }
+
+  return TRUE;
+}
+
+static void
+gstd_socket_reactor_stop (GstdSocketReactor * reactor)
+{
+  const guint64 one = 1;
+  guint i;
+
+  if (NULL == reactor->loops)
+    return;
+
+  g_atomic_int_set (&reactor->running, FALSE);
+  for (i = 0; i < reactor->num_loops; i++) {
+    if (reactor->loops[i].thread) {
+      if (write (reactor->loops[i].wakeup_fd, &one, sizeof (one)) < 0) {
+        GST_WARNING ("Unable to wake up I/O thread: %s", g_strerror (errno));
+      }
+      g_thread_join (reactor->loops[i].thread);
+    }
+  }
+
+  /* Let the commands in flight finish before closing their clients */
+  if (reactor->workers) {
+    gstd_metrics_remove_pool (reactor->workers);
+    g_thread_pool_free (reactor->workers, FALSE, TRUE);
+    reactor->workers = NULL;
+  }
+
+  for (i = 0; i < reactor->num_loops; i++) {
+    if (reactor->loops[i].connections)
+      gstd_socket_loop_clear (&reactor->loops[i]);
+  }
+
+  g_free (reactor->loops);
+  reactor->loops = NULL;
+}
+
+#else
+
+gboolean
+gstd_socket_reactor_is_supported (void)
+{
+  return FALSE;
+}
+
+gboolean
+gstd_socket_reactor_start (GstdSocketReactor * reactor, GError ** error)
+{
+  g_return_val_if_fail (reactor, FALSE);
+
+  g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+      "Event loop backend not supported on this platform");
+  return FALSE;
+}
+
+static void
+gstd_socket_reactor_stop (GstdSocketReactor * reactor)
+{
+}
+
+#endif /* HAVE_SYS_EPOLL_H */
+
+GstdSocketReactor *
+gstd_socket_reactor_new (GstdSession * session, GstdMetricsIpc ipc,
+    guint io_threads, gint max_workers)
+{
+  GstdSocketReactor *reactor;
+
+  g_return_val_if_fail (GSTD_IS_SESSION (session), NULL);
+  g_return_val_if_fail (io_threads > 0, NULL);
+
+  gstd_socket_reactor_init_debug ();
+
+  reactor = g_new0 (GstdSocketReactor, 1);
+  reactor->session = g_object_ref (session);
+  reactor->ipc = ipc;
+  reactor->listeners = g_ptr_array_new ();
+  reactor->num_loops = io_threads;
+  reactor->max_workers =
+      max_workers > 0 ? max_workers : (gint) g_get_num_processors ();
+
+  return reactor;
+}
+
+gboolean
+gstd_socket_reactor_listen (GstdSocketReactor * reactor,
+    GSocketAddress * address, GError ** error)
+{
+  GstdSocketSource *listener;
+  GSocket *socket;
+
+  g_return_val_if_fail (reactor, FALSE);
+  g_return_val_if_fail (G_IS_SOCKET_ADDRESS (address), FALSE);
+  g_return_val_if_fail (NULL == reactor->loops, FALSE);
+
+  socket = g_socket_new (g_socket_address_get_family (address),
+      G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, error);
+  if (NULL == socket)
+    return FALSE;
+
+  g_socket_set_listen_backlog (socket, GSTD_SOCKET_REACTOR_BACKLOG);
+
+  if (!g_socket_bind (socket, address, TRUE, error)
+      || !g_socket_listen (socket, error)) {
+    g_object_unref (socket);
+    return FALSE;
+  }
+
+  g_socket_set_blocking (socket, FALSE);
+
+  listener = g_new0 (GstdSocketSource, 1);
+  listener->type = GSTD_SOCKET_SOURCE_LISTENER;
+  listener->socket = socket;
+  g_ptr_array_add (reactor->listeners, listener);
+
+  return TRUE;
+}
+
+void
+gstd_socket_reactor_free (GstdSocketReactor * reactor)
+{
+  GstdSocketSource *listener;
+  guint i;
+
+  g_return_if_fail (reactor);
+
+  gstd_socket_reactor_stop (reactor);
+
+  for (i = 0; i < reactor->listeners->len; i++) {
+    listener = g_ptr_array_index (reactor->listeners, i);
+    g_socket_close (listener->socket, NULL);
+    g_object_unref (listener->socket);
+    g_free (listener);
+  }
+  g_ptr_array_unref (reactor->listeners);
+
+  g_object_unref (reactor->session);
+  g_free (reactor);
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_SOCKET_REACTOR_H__
+#define __GSTD_SOCKET_REACTOR_H__
+
+#include <gio/gio.h>
+
+#include "gstd_metrics.h"
+#include "gstd_session.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GstdSocketReactor:
+ * An event driven server for the socket protocols. A fixed set of
+ * I/O threads wait on epoll for every connection and hand complete
+ * commands to a bounded pool of workers, so idle clients cost a
+ * small buffer instead of a thread.
+ */
+typedef struct _GstdSocketReactor GstdSocketReactor;
+
+/**
+ * gstd_socket_reactor_is_supported:
+ *
+ * Returns: TRUE if the reactor can be used on this platform.
+ */
+gboolean gstd_socket_reactor_is_supported (void);
+
+/**
+ * gstd_socket_reactor_new:
+ * @session: The session commands are run on
+ * @ipc: The IPC label of the commands and the workers in the metrics
+ * @io_threads: Number of I/O threads, at least one
+ * @max_workers: Maximum number of commands run at the same time, zero
+ * or less to use one per processor
+ *
+ * Returns: (transfer full): A stopped reactor, free it with
+ * gstd_socket_reactor_free()
+ */
+GstdSocketReactor *gstd_socket_reactor_new (GstdSession * session,
+    GstdMetricsIpc ipc, guint io_threads, gint max_workers);
+
+/**
+ * gstd_socket_reactor_listen:
+ * @reactor: The reactor to add the address to
+ * @address: The address to accept connections on
+ * @error: Return location for the bind error
+ *
+ * Returns: TRUE if @address is ready to accept connections.
+ */
+gboolean gstd_socket_reactor_listen (GstdSocketReactor * reactor,
+    GSocketAddress * address, GError ** error);
+
+gboolean gstd_socket_reactor_start (GstdSocketReactor * reactor,
+    GError ** error);
+
+/**
+ * gstd_socket_reactor_free:
+ * @reactor: The reactor to free
+ *
+ * Stops the I/O threads, waits for the running commands and closes
+ * every connection and listener.
+ */
+void gstd_socket_reactor_free (GstdSocketReactor * reactor);
+
+G_END_DECLS
+#endif // __GSTD_SOCKET_REACTOR_H__
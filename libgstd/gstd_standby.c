@@ -0,0 +1,562 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/gst.h>
+
+#include "gstd_property_reader.h"
+
+#include "gstd_standby.h"
+
+enum
+{
+  PROP_DESCRIPTION = 1,
+  PROP_TEMPLATE,
+  PROP_SIZE,
+  PROP_STATE,
+  PROP_AVAILABLE,
+  PROP_CLAIMS,
+  PROP_MISSES,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
+
+#define GSTD_STANDBY_DEFAULT_DESCRIPTION NULL
+#define GSTD_STANDBY_DEFAULT_SIZE 1
+#define GSTD_STANDBY_DEFAULT_STATE GST_STATE_PAUSED
+
+/* How long an instance may take to reach the parked state */
+#define GSTD_STANDBY_TIMEOUT (5 * GST_SECOND)
+
+/* Refills of every pool share these threads */
+#define GSTD_STANDBY_MAX_THREADS 2
+
+/* Gstd Standby debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_standby_debug);
+#define GST_CAT_DEFAULT gstd_standby_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/**
+ * GstdStandby:
+ * A pool of pipelines built ahead of time and parked in READY or
+ * PAUSED, for pipeline creations to take over instead of building
+ * their own.
+ */
+struct _GstdStandby
+{
+  GstdObject parent;
+
+  /**
+   * The description of the instances, raw or "@template name=value ..."
+   */
+  gchar *description;
+
+  /**
+   * The template the description refers to, if any
+   */
+  GstdTemplate *template;
+
+  /**
+   * The amount of instances to keep parked and the state they're
+   * parked in
+   */
+  guint size;
+  GstState state;
+
+  /**
+   * The parked instances, oldest first, and the amount of instances on
+   * their way. Protected by lock, as is the rest.
+   */
+  GMutex lock;
+  GQueue parked;
+  guint building;
+
+  /* No more refills once closed, or after one failed */
+  gboolean closed;
+  gboolean failing;
+
+  guint64 claims;
+  guint64 misses;
+};
+
+struct _GstdStandbyClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdStandby, gstd_standby, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static void
+gstd_standby_get_property (GObject *, guint, GValue *, GParamSpec *);
+static void
+gstd_standby_set_property (GObject *, guint, const GValue *, GParamSpec *);
+static void gstd_standby_finalize (GObject *);
+static void gstd_standby_refill (gpointer data, gpointer user_data);
+
+static void
+gstd_standby_class_init (GstdStandbyClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  object_class->set_property = gstd_standby_set_property;
+  object_class->get_property = gstd_standby_get_property;
+  object_class->finalize = gstd_standby_finalize;
+
+  properties[PROP_DESCRIPTION] =
+      g_param_spec_string ("description",
+      "Description",
+      "The description of the pipelines kept ready",
+      GSTD_STANDBY_DEFAULT_DESCRIPTION,
+      G_PARAM_CONSTRUCT_ONLY |
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_TEMPLATE] =
+      g_param_spec_object ("template", "Template",
+      "The template the description refers to",
+      GSTD_TYPE_TEMPLATE,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  properties[PROP_SIZE] =
+      g_param_spec_uint ("size",
+      "Size",
+      "The amount of pipelines kept ready",
+      1, GSTD_STANDBY_MAX_SIZE, GSTD_STANDBY_DEFAULT_SIZE,
+      G_PARAM_CONSTRUCT_ONLY |
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_STATE] =
+      g_param_spec_enum ("state",
+      "State",
+      "The state the pipelines are kept in, ready or paused",
+      GST_TYPE_STATE, GSTD_STANDBY_DEFAULT_STATE,
+      G_PARAM_CONSTRUCT_ONLY |
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_AVAILABLE] =
+      g_param_spec_uint ("available",
+      "Available",
+      "The amount of pipelines ready right now",
+      0, G_MAXUINT, 0,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_CLAIMS] =
+      g_param_spec_uint64 ("claims",
+      "Claims",
+      "The amount of pipeline creations served from the pool",
+      0, G_MAXUINT64, 0,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_MISSES] =
+      g_param_spec_uint64 ("misses",
+      "Misses",
+      "The amount of pipeline creations that found no pipeline ready",
+      0, G_MAXUINT64, 0,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_standby_debug, "gstdstandby", debug_color,
+      "Gstd Standby category");
+}
+
+static void
+gstd_standby_init (GstdStandby * self)
+{
+  GST_INFO_OBJECT (self, "Initializing standby");
+  self->description = g_strdup (GSTD_STANDBY_DEFAULT_DESCRIPTION);
+  self->template = NULL;
+  self->size = GSTD_STANDBY_DEFAULT_SIZE;
+  self->state = GSTD_STANDBY_DEFAULT_STATE;
+
+  g_mutex_init (&self->lock);
+  g_queue_init (&self->parked);
+  self->building = 0;
+  self->closed = FALSE;
+  self->failing = FALSE;
+  self->claims = 0;
+  self->misses = 0;
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
+}
+
+static void
+gstd_standby_drop (GstElement * pipeline)
+{
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static void
+gstd_standby_finalize (GObject * object)
+{
+  GstdStandby *self = GSTD_STANDBY (object);
+  GstElement *pipeline;
+
+  GST_INFO_OBJECT (self, "Finalizing %s standby", GSTD_OBJECT_NAME (self));
+
+  /* Refills hold a reference, none is running anymore */
+  while ((pipeline = g_queue_pop_head (&self->parked))) {
+    gstd_standby_drop (pipeline);
+  }
+
+  g_free (self->description);
+  g_clear_object (&self->template);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (gstd_standby_parent_class)->finalize (object);
+}
+
+static void
+gstd_standby_get_property (GObject * object,
+    guint property_id, GValue * value, GParamSpec * pspec)
+{
+  GstdStandby *self = GSTD_STANDBY (object);
+
+  switch (property_id) {
+    case PROP_DESCRIPTION:
+      g_value_set_string (value, self->description);
+      break;
+    case PROP_SIZE:
+      g_value_set_uint (value, self->size);
+      break;
+    case PROP_STATE:
+      g_value_set_enum (value, self->state);
+      break;
+    case PROP_AVAILABLE:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint (value, self->parked.length);
+      g_mutex_unlock (&self->lock);
+      break;
+    case PROP_CLAIMS:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint64 (value, self->claims);
+      g_mutex_unlock (&self->lock);
+      break;
+    case PROP_MISSES:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint64 (value, self->misses);
+      g_mutex_unlock (&self->lock);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_standby_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdStandby *self = GSTD_STANDBY (object);
+
+  switch (property_id) {
+    case PROP_DESCRIPTION:
+      g_free (self->description);
+      self->description = g_value_dup_string (value);
+      GST_INFO_OBJECT (self, "Changed description to \"%s\"",
+          self->description);
+      break;
+    case PROP_TEMPLATE:
+      g_clear_object (&self->template);
+      self->template = g_value_dup_object (value);
+      break;
+    case PROP_SIZE:
+      self->size = g_value_get_uint (value);
+      break;
+    case PROP_STATE:
+      self->state = g_value_get_enum (value);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static GThreadPool *
+gstd_standby_refills (void)
+{
+  static gsize initialized = 0;
+  static GThreadPool *refills = NULL;
+
+  if (g_once_init_enter (&initialized)) {
+    refills = g_thread_pool_new (gstd_standby_refill, NULL,
+        GSTD_STANDBY_MAX_THREADS, FALSE, NULL);
+    g_once_init_leave (&initialized, 1);
+  }
+
+  return refills;
+}
+
+/* Builds an instance and brings it to the parked state */
+static GstdReturnCode
+gstd_standby_make (GstdStandby * self, GstElement ** out)
+{
+  GstElement *pipeline = NULL;
+  GstElement *element;
+  GError *error = NULL;
+  GstParseFlags flags;
+  GstStateChangeReturn change;
+  GstdReturnCode ret;
+
+  *out = NULL;
+
+  if (self->template) {
+    /* The parameters follow the template name */
+    ret = gstd_template_instantiate (self->template,
+        strchr (self->description, ' '), &pipeline);
+    if (ret) {
+      return ret;
+    }
+  } else {
+    flags = GST_PARSE_FLAG_FATAL_ERRORS | GST_PARSE_FLAG_NO_SINGLE_ELEMENT_BINS;
+    pipeline = gst_parse_launch_full (self->description, NULL, flags, &error);
+    if (!pipeline) {
+      GST_ERROR_OBJECT (self, "Unable to parse \"%s\": %s", self->description,
+          error ? error->message : "unknown error");
+      g_clear_error (&error);
+      return GSTD_BAD_DESCRIPTION;
+    }
+  }
+
+  /* Wrapped as gstd_pipeline_build() would */
+  if (!GST_IS_PIPELINE (pipeline)) {
+    element = pipeline;
+    pipeline = gst_pipeline_new (GST_OBJECT_NAME (element));
+    gst_bin_add (GST_BIN (pipeline), element);
+  }
+  gst_object_ref_sink (pipeline);
+
+  change = gst_element_set_state (pipeline, self->state);
+  if (GST_STATE_CHANGE_ASYNC == change) {
+    change = gst_element_get_state (pipeline, NULL, NULL,
+        GSTD_STANDBY_TIMEOUT);
+  }
+
+  if (GST_STATE_CHANGE_FAILURE == change || GST_STATE_CHANGE_ASYNC == change) {
+    GST_ERROR_OBJECT (self, "Instance didn't reach %s",
+        gst_element_state_get_name (self->state));
+    gstd_standby_drop (pipeline);
+    return GSTD_STATE_ERROR;
+  }
+
+  *out = pipeline;
+
+  return GSTD_EOK;
+}
+
+/* Called with the lock held */
+static void
+gstd_standby_schedule (GstdStandby * self)
+{
+  GError *error = NULL;
+
+  while (!self->closed && !self->failing
+      && self->parked.length + self->building < self->size) {
+    self->building++;
+
+    /* The caller holds a reference too, this one can't be the last */
+    if (!g_thread_pool_push (gstd_standby_refills (), g_object_ref (self),
+            &error)) {
+      GST_WARNING_OBJECT (self, "Unable to refill: %s", error->message);
+      g_error_free (error);
+      self->building--;
+      g_object_unref (self);
+      break;
+    }
+  }
+}
+
+static void
+gstd_standby_refill (gpointer data, gpointer user_data)
+{
+  GstdStandby *self = GSTD_STANDBY (data);
+  GstElement *pipeline = NULL;
+  GstdReturnCode ret;
+
+  ret = gstd_standby_make (self, &pipeline);
+
+  g_mutex_lock (&self->lock);
+  self->building--;
+  if (ret) {
+    /* Don't spin on a broken pipeline, the next claim tries again */
+    GST_WARNING_OBJECT (self, "Refill of %s failed: %s",
+        GSTD_OBJECT_NAME (self), gstd_return_code_to_string (ret));
+    self->failing = TRUE;
+  } else if (!self->closed) {
+    g_queue_push_tail (&self->parked, pipeline);
+    pipeline = NULL;
+  }
+  g_mutex_unlock (&self->lock);
+
+  if (pipeline) {
+    gstd_standby_drop (pipeline);
+  }
+  g_object_unref (self);
+}
+
+GstdReturnCode
+gstd_standby_start (GstdStandby * self)
+{
+  GstElement *pipeline;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_STANDBY (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (self->description, GSTD_NULL_ARGUMENT);
+
+  ret = gstd_standby_make (self, &pipeline);
+  if (ret) {
+    return ret;
+  }
+
+  g_mutex_lock (&self->lock);
+  g_queue_push_tail (&self->parked, pipeline);
+  gstd_standby_schedule (self);
+  g_mutex_unlock (&self->lock);
+
+  GST_INFO_OBJECT (self, "Keeping %u instances of \"%s\" in %s", self->size,
+      self->description, gst_element_state_get_name (self->state));
+
+  return GSTD_EOK;
+}
+
+/*
+ * Clears what the instance posted while parked, so the pipeline bus
+ * starts from the claim. Instances that failed or fell out of their
+ * state meanwhile are not handed over.
+ */
+static gboolean
+gstd_standby_check (GstdStandby * self, GstElement * pipeline)
+{
+  GstBus *bus = gst_element_get_bus (pipeline);
+  GstMessage *error = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  gboolean ret = TRUE;
+
+  gst_bus_set_flushing (bus, TRUE);
+  gst_bus_set_flushing (bus, FALSE);
+  gst_object_unref (bus);
+
+  if (error || GST_STATE (pipeline) != self->state) {
+    GST_WARNING_OBJECT (self, "Dropping an instance broken while parked");
+    ret = FALSE;
+  }
+
+  if (error) {
+    gst_message_unref (error);
+  }
+
+  return ret;
+}
+
+GstElement *
+gstd_standby_claim (GstdStandby * self, GstdTemplate * template,
+    const gchar * description)
+{
+  GstElement *pipeline;
+  const gchar *parameters = NULL;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_STANDBY (self), NULL);
+  g_return_val_if_fail (description, NULL);
+
+  if (self->template) {
+    if (template != self->template) {
+      return NULL;
+    }
+    parameters = strchr (description, ' ');
+  } else if (strcmp (description, self->description)) {
+    return NULL;
+  }
+
+  g_mutex_lock (&self->lock);
+  pipeline = g_queue_pop_head (&self->parked);
+  g_mutex_unlock (&self->lock);
+
+  if (pipeline && !gstd_standby_check (self, pipeline)) {
+    gstd_standby_drop (pipeline);
+    pipeline = NULL;
+  }
+
+  if (pipeline && self->template) {
+    ret = gstd_template_reconfigure (self->template, pipeline,
+        strchr (self->description, ' '), parameters);
+    if (ret) {
+      /* Untouched, it still serves the parameters it was built with */
+      GST_INFO_OBJECT (self, "Not reusing an instance for \"%s\": %s",
+          description, gstd_return_code_to_string (ret));
+      g_mutex_lock (&self->lock);
+      if (!self->closed) {
+        g_queue_push_head (&self->parked, pipeline);
+        pipeline = NULL;
+      }
+      g_mutex_unlock (&self->lock);
+
+      if (pipeline) {
+        gstd_standby_drop (pipeline);
+        pipeline = NULL;
+      }
+    }
+  }
+
+  g_mutex_lock (&self->lock);
+  if (pipeline) {
+    self->claims++;
+  } else {
+    self->misses++;
+  }
+  self->failing = FALSE;
+  gstd_standby_schedule (self);
+  g_mutex_unlock (&self->lock);
+
+  GST_DEBUG_OBJECT (self, "%s instance for \"%s\"",
+      pipeline ? "Claimed an" : "No", description);
+
+  return pipeline;
+}
+
+void
+gstd_standby_close (GstdStandby * self)
+{
+  GQueue parked;
+  GstElement *pipeline;
+
+  g_return_if_fail (GSTD_IS_STANDBY (self));
+
+  g_mutex_lock (&self->lock);
+  self->closed = TRUE;
+  parked = self->parked;
+  g_queue_init (&self->parked);
+  g_mutex_unlock (&self->lock);
+
+  while ((pipeline = g_queue_pop_head (&parked))) {
+    gstd_standby_drop (pipeline);
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_STANDBY_H__
+#define __GSTD_STANDBY_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+#include "gstd_template.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_STANDBY \
+  (gstd_standby_get_type())
+#define GSTD_STANDBY(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_STANDBY,GstdStandby))
+#define GSTD_STANDBY_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_STANDBY,GstdStandbyClass))
+#define GSTD_IS_STANDBY(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_STANDBY))
+#define GSTD_IS_STANDBY_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_STANDBY))
+#define GSTD_STANDBY_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_STANDBY, GstdStandbyClass))
+typedef struct _GstdStandby GstdStandby;
+typedef struct _GstdStandbyClass GstdStandbyClass;
+GType gstd_standby_get_type (void);
+
+/* The most pipelines a pool keeps ready */
+#define GSTD_STANDBY_MAX_SIZE 64
+
+/**
+ * gstd_standby_start:
+ * @self: A #GstdStandby with its "description" set, and its
+ * "template" if the description is "@template name=value ..."
+ *
+ * Builds the first instance right away, so a description that doesn't
+ * parse or doesn't reach "state" is refused, and leaves the rest to
+ * the background refill.
+ *
+ * Returns: GSTD_EOK, GSTD_BAD_DESCRIPTION or the template errors if
+ * the instance can't be built, GSTD_STATE_ERROR if it doesn't reach
+ * "state".
+ */
+GstdReturnCode gstd_standby_start (GstdStandby * self);
+
+/**
+ * gstd_standby_claim:
+ * @self: A started #GstdStandby
+ * @template: (nullable): The template @description refers to
+ * @description: The description of the pipeline being created
+ *
+ * Hands over a parked instance if @self keeps @description ready. An
+ * instance of the same template serves any parameters, as long as
+ * gstd_template_reconfigure() can apply them in the parked state. A
+ * refill is scheduled for the instance taken.
+ *
+ * Returns: (transfer full) (nullable): A pipeline in "state" with its
+ * bus flushed, or NULL if @self has none for @description.
+ */
+GstElement *gstd_standby_claim (GstdStandby * self, GstdTemplate * template,
+    const gchar * description);
+
+/**
+ * gstd_standby_close:
+ * @self: A #GstdStandby
+ *
+ * Stops refilling and releases the parked instances. Instances on
+ * their way are dropped as they finish.
+ */
+void gstd_standby_close (GstdStandby * self);
+
+G_END_DECLS
+#endif // __GSTD_STANDBY_H__
@@ -0,0 +1,247 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "gstd_list.h"
+#include "gstd_standby.h"
+#include "gstd_standby_creator.h"
+
+enum
+{
+  PROP_TEMPLATES = 1,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_standby_creator_debug);
+#define GST_CAT_DEFAULT gstd_standby_creator_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static GstdReturnCode gstd_standby_creator_create (GstdICreator * iface,
+    const gchar * name, const gchar * description, GstdObject ** out);
+static void gstd_standby_creator_set_property (GObject *, guint,
+    const GValue *, GParamSpec *);
+static void gstd_standby_creator_dispose (GObject *);
+
+typedef struct _GstdStandbyCreatorClass GstdStandbyCreatorClass;
+
+/**
+ * GstdStandbyCreator:
+ * Starts standby pools from "[size=K] [state=ready|paused] description"
+ */
+struct _GstdStandbyCreator
+{
+  GObject parent;
+
+  /**
+   * The templates a description "@template name=value ..." refers to
+   */
+  GstdList *templates;
+};
+
+struct _GstdStandbyCreatorClass
+{
+  GObjectClass parent_class;
+};
+
+
+static void
+gstd_icreator_interface_init (GstdICreatorInterface * iface)
+{
+  iface->create = gstd_standby_creator_create;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdStandbyCreator, gstd_standby_creator,
+    G_TYPE_OBJECT, G_IMPLEMENT_INTERFACE (GSTD_TYPE_ICREATOR,
+        gstd_icreator_interface_init));
+
+static void
+gstd_standby_creator_class_init (GstdStandbyCreatorClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  object_class->set_property = gstd_standby_creator_set_property;
+  object_class->dispose = gstd_standby_creator_dispose;
+
+  properties[PROP_TEMPLATES] =
+      g_param_spec_object ("templates", "Templates",
+      "The templates pools may be started from",
+      GSTD_TYPE_LIST,
+      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_standby_creator_debug, "gstdstandbycreator",
+      debug_color, "Gstd Standby Creator category");
+}
+
+static void
+gstd_standby_creator_init (GstdStandbyCreator * self)
+{
+  GST_INFO_OBJECT (self, "Initializing standby creator");
+  self->templates = NULL;
+}
+
+static void
+gstd_standby_creator_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdStandbyCreator *self = GSTD_STANDBY_CREATOR (object);
+
+  switch (property_id) {
+    case PROP_TEMPLATES:
+      g_clear_object (&self->templates);
+      self->templates = g_value_dup_object (value);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_standby_creator_dispose (GObject * object)
+{
+  GstdStandbyCreator *self = GSTD_STANDBY_CREATOR (object);
+
+  g_clear_object (&self->templates);
+
+  G_OBJECT_CLASS (gstd_standby_creator_parent_class)->dispose (object);
+}
+
+/*
+ * Takes the leading size=K and state=ready|paused options out of
+ * @description
+ */
+static GstdReturnCode
+gstd_standby_creator_parse_options (GstdStandbyCreator * self,
+    const gchar ** description, guint * size, GstState * state)
+{
+  const gchar *option = *description;
+  gchar *value;
+  gchar *end;
+  guint64 number;
+  gsize len;
+  GstdReturnCode ret = GSTD_EOK;
+
+  while (GSTD_EOK == ret && (g_str_has_prefix (option, "size=")
+          || g_str_has_prefix (option, "state="))) {
+    len = strcspn (option, " ");
+    value = g_strndup (option, len);
+
+    if (g_str_has_prefix (value, "size=")) {
+      number = g_ascii_strtoull (value + 5, &end, 10);
+      if ('\0' != *end || 0 == number || number > GSTD_STANDBY_MAX_SIZE) {
+        GST_ERROR_OBJECT (self, "Standby size must be 1 to %d, not \"%s\"",
+            GSTD_STANDBY_MAX_SIZE, value + 5);
+        ret = GSTD_BAD_VALUE;
+      }
+      *size = number;
+    } else if (!g_ascii_strcasecmp (value + 6, "ready")) {
+      *state = GST_STATE_READY;
+    } else if (!g_ascii_strcasecmp (value + 6, "paused")) {
+      *state = GST_STATE_PAUSED;
+    } else {
+      GST_ERROR_OBJECT (self, "Pipelines are kept in ready or paused, not "
+          "\"%s\"", value + 6);
+      ret = GSTD_BAD_VALUE;
+    }
+    g_free (value);
+
+    option += len;
+    while (' ' == *option) {
+      option++;
+    }
+  }
+
+  *description = option;
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_standby_creator_create (GstdICreator * iface, const gchar * name,
+    const gchar * description, GstdObject ** out)
+{
+  GstdStandbyCreator *self;
+  GstdStandby *standby;
+  GstdObject *template = NULL;
+  GstState state = GST_STATE_PAUSED;
+  guint size = 1;
+  gchar *template_name;
+  GstdReturnCode ret;
+  *out = NULL;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_STANDBY_CREATOR (iface);
+
+  if (NULL == name) {
+    GST_ERROR_OBJECT (self, "Standby name not provided");
+    return GSTD_MISSING_NAME;
+  }
+
+  if (NULL == description) {
+    GST_ERROR_OBJECT (self, "Standby description not provided");
+    return GSTD_MISSING_ARGUMENT;
+  }
+
+  ret = gstd_standby_creator_parse_options (self, &description, &size,
+      &state);
+  if (ret) {
+    return ret;
+  }
+
+  if ('\0' == description[0]) {
+    GST_ERROR_OBJECT (self, "Standby description not provided");
+    return GSTD_MISSING_ARGUMENT;
+  }
+
+  if ('@' == description[0]) {
+    template_name = g_strndup (description + 1, strcspn (description + 1,
+            " "));
+    if (self->templates) {
+      template = gstd_list_find_child (self->templates, template_name);
+    }
+    if (!template) {
+      GST_ERROR_OBJECT (self, "No template named \"%s\"", template_name);
+      g_free (template_name);
+      return GSTD_NO_RESOURCE;
+    }
+    g_free (template_name);
+  }
+
+  standby = g_object_new (GSTD_TYPE_STANDBY, "name", name, "description",
+      description, "template", template, "size", size, "state", state, NULL);
+  *out = GSTD_OBJECT (standby);
+
+  if (template) {
+    g_object_unref (template);
+  }
+
+  return gstd_standby_start (standby);
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_standby.h"
+#include "gstd_standby_deleter.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_standby_deleter_debug);
+#define GST_CAT_DEFAULT gstd_standby_deleter_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static GstdReturnCode gstd_standby_deleter_delete (GstdIDeleter * iface,
+    GstdObject * object);
+
+typedef struct _GstdStandbyDeleterClass GstdStandbyDeleterClass;
+
+/**
+ * GstdStandbyDeleter:
+ * Drops standby pools along with their parked pipelines. Pipelines
+ * already claimed from a pool are not affected.
+ */
+struct _GstdStandbyDeleter
+{
+  GObject parent;
+};
+
+struct _GstdStandbyDeleterClass
+{
+  GObjectClass parent_class;
+};
+
+
+static void
+gstd_ideleter_interface_init (GstdIDeleterInterface * iface)
+{
+  iface->delete = gstd_standby_deleter_delete;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdStandbyDeleter, gstd_standby_deleter,
+    G_TYPE_OBJECT, G_IMPLEMENT_INTERFACE (GSTD_TYPE_IDELETER,
+        gstd_ideleter_interface_init));
+
+static void
+gstd_standby_deleter_class_init (GstdStandbyDeleterClass * klass)
+{
+  guint debug_color;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_standby_deleter_debug, "gstdstandbydeleter",
+      debug_color, "Gstd Standby Deleter category");
+}
+
+static void
+gstd_standby_deleter_init (GstdStandbyDeleter * self)
+{
+  GST_INFO_OBJECT (self, "Initializing standby deleter");
+}
+
+static GstdReturnCode
+gstd_standby_deleter_delete (GstdIDeleter * iface, GstdObject * object)
+{
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
+
+  GST_INFO_OBJECT (iface, "Deleting standby \"%s\"",
+      GSTD_OBJECT_NAME (object));
+
+  /* Refills and claims in flight hold their own reference */
+  gstd_standby_close (GSTD_STANDBY (object));
+  g_object_unref (object);
+
+  return GSTD_EOK;
+}
@@ -25,19 +25,35 @@
 #include <gst/gst.h>
 
 #include "gstd_state.h"
+#include "gstd_state_reader.h"
+#include "gstd_status.h"
 
 enum
 {
   PROP_0,
   PROP_REFCOUNT,
+  PROP_TRANSITION,
+  PROP_WAIT,
   N_PROPERTIES
 };
 
+/* Transitions whose outcome is remembered for late waiters */
+#define GSTD_STATE_HISTORY 16
+
+typedef struct _GstdStateWaiter GstdStateWaiter;
+
+struct _GstdStateWaiter
+{
+  guint id;
+  guint64 transition;
+  GstdStateWaitFunc func;
+  gpointer user_data;
+};
+
 struct _GstdState
 {
   GstdObject parent;
 
-  GstState state;
   GstElement *target;
 
   /**
@@ -46,6 +62,23 @@ struct _GstdState
    * is stopped.
    */
   guint refcount;
+
+  /*
+   * The transition record, protected by the object lock. It follows
+   * the bus, so reading it never queries the pipeline. The outcome of
+   * the latest transitions over is kept at outcomes[id % HISTORY],
+   * replaced ones count as failed.
+   */
+  GstState state;
+  guint64 transition;
+  GstState goal;
+  gboolean settled;
+  GstdReturnCode result;
+  GstdReturnCode outcomes[GSTD_STATE_HISTORY];
+  gboolean closed;
+  GCond cond;
+  GSList *waiters;
+  guint next_id;
 };
 
 struct _GstdStateClass
@@ -91,8 +124,14 @@ gstd_state_to_string (GstdObject * obj, gchar ** outstring);
 static GstdReturnCode
 gstd_state_update (GstdObject * object, const gchar * sstate);
 static void gstd_state_dispose (GObject * obj);
+static void gstd_state_finalize (GObject * obj);
 static void gstd_state_get_property (GObject *, guint, GValue *, GParamSpec *);
-static GstState gstd_state_read (GstdState * state);
+static void gstd_state_set_property (GObject *, guint, const GValue *,
+    GParamSpec *);
+static GSList *gstd_state_settle (GstdState * self, guint64 transition,
+    GstdReturnCode result);
+static GSList *gstd_state_take_waiters (GstdState * self, guint64 transition);
+static void gstd_state_notify (GstdState * self, GSList * waiters);
 
 static void
 gstd_state_class_init (GstdStateClass * klass)
@@ -102,7 +141,9 @@ gstd_state_class_init (GstdStateClass * klass)
   guint debug_color;
 
   oclass->dispose = gstd_state_dispose;
+  oclass->finalize = gstd_state_finalize;
   oclass->get_property = gstd_state_get_property;
+  oclass->set_property = gstd_state_set_property;
 
   gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_state_to_string);
   gstdc->update = GST_DEBUG_FUNCPTR (gstd_state_update);
@@ -116,6 +157,16 @@ gstd_state_class_init (GstdStateClass * klass)
       g_param_spec_int ("refcount", "Reference Count",
           "Reference count of pipeline play", 0, G_MAXINT, 0,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (oclass, PROP_TRANSITION,
+      g_param_spec_uint64 ("transition", "Transition",
+          "The id of the latest state change requested, 0 if none", 0,
+          G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (oclass, PROP_WAIT,
+      g_param_spec_object ("wait", "Wait",
+          "The state once the latest transition is over",
+          GSTD_TYPE_OBJECT, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -131,6 +182,13 @@ gstd_state_get_property (GObject * object,
       g_value_set_int (value, self->refcount);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_TRANSITION:
+      g_value_set_uint64 (value, gstd_state_get_transition (self));
+      break;
+    case PROP_WAIT:
+      /* Served by the state reader, see gstd_state_wait() */
+      g_value_set_object (value, NULL);
+      break;
 
     default:
       /* We don't have any other property... */
@@ -139,13 +197,54 @@ gstd_state_get_property (GObject * object,
   }
 }
 
+static void
+gstd_state_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
 static void
 gstd_state_init (GstdState * self)
 {
   GST_INFO_OBJECT (self, "Initializing state");
-  self->state = GST_STATE_NULL;
   self->target = NULL;
   self->refcount = 0;
+  self->state = GST_STATE_NULL;
+  self->transition = 0;
+  self->goal = GST_STATE_NULL;
+  self->settled = TRUE;
+  self->result = GSTD_EOK;
+  self->closed = FALSE;
+  self->waiters = NULL;
+  self->next_id = 1;
+  g_cond_init (&self->cond);
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_STATE_READER, NULL));
+}
+
+static void
+gstd_state_add_enum (GstdIFormatter * formatter, const gchar * name,
+    GstState state)
+{
+  GValue value = G_VALUE_INIT;
+  gchar *svalue;
+
+  g_value_init (&value, GSTD_TYPE_STATE_ENUM);
+  g_value_set_enum (&value, state);
+  svalue = gst_value_serialize (&value);
+
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_string_value (formatter, svalue);
+
+  g_free (svalue);
+  g_value_unset (&value);
 }
 
 static GstdReturnCode
@@ -155,33 +254,57 @@ gstd_state_to_string (GstdObject * obj, gchar ** outstring)
   GValue value = G_VALUE_INIT;
   gchar *svalue;
   const gchar *typename;
-  GstdIFormatter *formatter = g_object_new (obj->formatter_factory, NULL);
+  const gchar *status;
+  GstState state;
+  GstState goal;
+  guint64 transition;
+  GstdIFormatter *formatter = gstd_object_new_formatter (obj);
 
   g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
 
   self = GSTD_STATE (obj);
 
+  /* The record follows the bus, no need to query the pipeline */
+  GST_OBJECT_LOCK (self);
+  state = self->state;
+  goal = self->goal;
+  transition = self->transition;
+  if (!self->settled) {
+    status = "pending";
+  } else if (self->result) {
+    status = "failed";
+  } else {
+    status = "done";
+  }
+  GST_OBJECT_UNLOCK (self);
+
   /* Describe each parameter using a structure */
   gstd_iformatter_begin_object (formatter);
 
   gstd_iformatter_set_member_name (formatter, "name");
   gstd_iformatter_set_string_value (formatter, GSTD_OBJECT_NAME (self));
 
-  gstd_iformatter_set_member_name (formatter, "value");
+  gstd_state_add_enum (formatter, "value", state);
 
-  /* The state of the pipeline might have changed autonomously,
-     refresh the value */
-  self->state = gstd_state_read (self);
-
-  g_value_init (&value, GSTD_TYPE_STATE_ENUM);
-  g_value_set_enum (&value, self->state);
-  svalue = gst_value_serialize (&value);
-  gstd_iformatter_set_string_value (formatter, svalue);
+  gstd_iformatter_set_member_name (formatter, "transition");
+  /* Describe the latest change requested using a structure */
+  gstd_iformatter_begin_object (formatter);
 
-  g_free (svalue);
+  g_value_init (&value, G_TYPE_UINT64);
+  g_value_set_uint64 (&value, transition);
+  gstd_iformatter_set_member_name (formatter, "id");
+  gstd_iformatter_set_value (formatter, &value);
   g_value_unset (&value);
 
+  gstd_state_add_enum (formatter, "target", goal);
+
+  gstd_iformatter_set_member_name (formatter, "status");
+  gstd_iformatter_set_string_value (formatter, status);
+
+  /* Close transition structure */
+  gstd_iformatter_end_object (formatter);
+
   gstd_iformatter_set_member_name (formatter, "param");
   /* Describe the parameter specs using a structure */
   gstd_iformatter_begin_object (formatter);
@@ -223,6 +346,8 @@ gstd_state_update (GstdObject * object, const gchar * sstate)
   GstStateChangeReturn gstret;
   GValue value = G_VALUE_INIT;
   GstState state;
+  GSList *waiters;
+  guint64 transition;
 
   g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
   g_return_val_if_fail (sstate, GSTD_NULL_ARGUMENT);
@@ -239,20 +364,33 @@ gstd_state_update (GstdObject * object, const gchar * sstate)
   state = g_value_get_enum (&value);
   g_value_unset (&value);
 
-  GST_INFO_OBJECT (self, "Setting pipeline state to %s",
-      gst_element_state_get_name (state));
-
   if (!self->target) {
     GST_ERROR_OBJECT (self, "Target pipeline is NULL, cannot change state");
     return GSTD_NULL_ARGUMENT;
   }
 
+  /* Open the record first, the pipeline may post the messages that
+   * complete it before gst_element_set_state() returns. A transition
+   * still in progress won't complete, its waiters are released. */
+  GST_OBJECT_LOCK (self);
+  waiters = gstd_state_settle (self, self->transition, GSTD_STATE_ERROR);
+  transition = ++self->transition;
+  self->goal = state;
+  self->settled = FALSE;
+  self->result = GSTD_EOK;
+  GST_OBJECT_UNLOCK (self);
+
+  gstd_state_notify (self, waiters);
+
+  GST_INFO_OBJECT (self, "Setting pipeline state to %s, transition %"
+      G_GUINT64_FORMAT, gst_element_state_get_name (state), transition);
+
   gstret = gst_element_set_state (self->target, state);
 
   if (GST_STATE_CHANGE_ASYNC == gstret) {
     GST_INFO_OBJECT (self, "State change to %s is async (will complete later)",
         gst_element_state_get_name (state));
-    /* Async is OK - state change is in progress */
+    /* Async is OK - the bus completes the transition */
   }
 
   if (GST_STATE_CHANGE_FAILURE == gstret) {
@@ -261,9 +399,15 @@ gstd_state_update (GstdObject * object, const gchar * sstate)
 
     GST_ERROR_OBJECT (self, "Failed to change the state of the pipeline");
 
+    GST_OBJECT_LOCK (self);
+    waiters = gstd_state_settle (self, transition, GSTD_STATE_ERROR);
+    GST_OBJECT_UNLOCK (self);
+    gstd_state_notify (self, waiters);
+
     bus = gst_element_get_bus (self->target);
     if (bus) {
-      msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+      /* Leave it in place for the bus readers */
+      msg = gstd_pipeline_bus_find_last (bus, GST_MESSAGE_ERROR);
       if (msg) {
         GError *err = NULL;
         gchar *debug = NULL;
@@ -289,7 +433,17 @@ gstd_state_update (GstdObject * object, const gchar * sstate)
     return GSTD_STATE_ERROR;
   }
 
-  self->state = state;
+  /* Live pipelines reach PAUSED without prerolling */
+  if (GST_STATE_CHANGE_SUCCESS == gstret
+      || GST_STATE_CHANGE_NO_PREROLL == gstret) {
+    GST_OBJECT_LOCK (self);
+    if (transition == self->transition) {
+      self->state = state;
+    }
+    waiters = gstd_state_settle (self, transition, GSTD_EOK);
+    GST_OBJECT_UNLOCK (self);
+    gstd_state_notify (self, waiters);
+  }
 
   return GSTD_EOK;
 }
@@ -304,6 +458,9 @@ gstd_state_new (GstElement * target)
   self = g_object_new (GSTD_TYPE_STATE, "name", "state", NULL);
   self->target = gst_object_ref (target);
 
+  /* Prebuilt pipelines may not start in NULL */
+  self->state = self->goal = GST_STATE (target);
+
   return self;
 }
 
@@ -322,31 +479,293 @@ gstd_state_dispose (GObject * object)
   G_OBJECT_CLASS (gstd_state_parent_class)->dispose (object);
 }
 
-/* Timeout for state queries - 100ms is reasonable for status polling */
-#define GSTD_STATE_QUERY_TIMEOUT (100 * GST_MSECOND)
+static void
+gstd_state_finalize (GObject * object)
+{
+  GstdState *self = GSTD_STATE (object);
+
+  /* Parked waits hold a reference, none can be left */
+  g_warn_if_fail (NULL == self->waiters);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (gstd_state_parent_class)->finalize (object);
+}
+
+/*
+ * Called with the object lock held. Unlinks and returns the waiters of
+ * @transition, or of every transition if 0.
+ */
+static GSList *
+gstd_state_take_waiters (GstdState * self, guint64 transition)
+{
+  GSList *waiters = NULL;
+  GSList *iter;
+  GSList *next;
+  GstdStateWaiter *waiter;
+
+  for (iter = self->waiters; iter; iter = next) {
+    next = iter->next;
+    waiter = iter->data;
+    if (0 == transition || waiter->transition == transition) {
+      self->waiters = g_slist_remove_link (self->waiters, iter);
+      waiters = g_slist_concat (iter, waiters);
+    }
+  }
+
+  return waiters;
+}
+
+/*
+ * Called with the object lock held. Returns the waiters to notify once
+ * it is released, if @transition was still in progress.
+ */
+static GSList *
+gstd_state_settle (GstdState * self, guint64 transition, GstdReturnCode result)
+{
+  if (self->settled || transition != self->transition) {
+    return NULL;
+  }
+
+  GST_INFO_OBJECT (self, "Transition %" G_GUINT64_FORMAT " to %s %s",
+      transition, gst_element_state_get_name (self->goal),
+      result ? "failed" : "done");
+
+  self->settled = TRUE;
+  self->result = result;
+  self->outcomes[transition % GSTD_STATE_HISTORY] = result;
+  g_cond_broadcast (&self->cond);
+
+  return gstd_state_take_waiters (self, transition);
+}
+
+/*
+ * Called with the object lock held. Tells whether @transition is over
+ * and its outcome, see gstd_state_wait().
+ */
+static gboolean
+gstd_state_outcome (GstdState * self, guint64 transition,
+    GstdReturnCode * result)
+{
+  if (transition > self->transition
+      || transition + GSTD_STATE_HISTORY <= self->transition) {
+    *result = GSTD_BAD_VALUE;
+    return TRUE;
+  }
+
+  /* Nothing requested yet */
+  if (0 == transition) {
+    *result = GSTD_EOK;
+    return TRUE;
+  }
+
+  if (transition == self->transition && !self->settled) {
+    *result = GSTD_STATE_ERROR;
+    return self->closed;
+  }
+
+  *result = self->outcomes[transition % GSTD_STATE_HISTORY];
+  return TRUE;
+}
+
+static void
+gstd_state_notify (GstdState * self, GSList * waiters)
+{
+  GSList *iter;
+  GstdStateWaiter *waiter;
+
+  /* Prepended, notify in arrival order */
+  waiters = g_slist_reverse (waiters);
+  for (iter = waiters; iter; iter = iter->next) {
+    waiter = iter->data;
+    waiter->func (self, waiter->user_data);
+  }
+
+  g_slist_free_full (waiters, g_free);
+}
 
-static GstState
-gstd_state_read (GstdState * self)
+/* Runs in the posting thread, with the bus subscriptions locked */
+static void
+gstd_state_on_message (GstdPipelineBus * bus, GstMessage * message,
+    guint64 seq, gpointer user_data)
 {
-  GstState current;
+  GstdState *self = GSTD_STATE (user_data);
+  GSList *waiters = NULL;
+  gboolean changed = FALSE;
+  GstState old;
+  GstState state;
   GstState pending;
-  GstStateChangeReturn ret;
 
-  g_return_val_if_fail (self, GST_STATE_NULL);
-  g_return_val_if_fail (self->target, GST_STATE_NULL);
+  GST_OBJECT_LOCK (self);
+
+  /* The pipeline is gone, nothing completes anymore */
+  if (!message) {
+    self->closed = TRUE;
+    g_cond_broadcast (&self->cond);
+    waiters = gstd_state_take_waiters (self, 0);
+    goto out;
+  }
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_STATE_CHANGED:
+      if (GST_MESSAGE_SRC (message) != GST_OBJECT_CAST (self->target)) {
+        break;
+      }
+      gst_message_parse_state_changed (message, &old, &state, &pending);
+      self->state = state;
+      changed = TRUE;
+      if (state == self->goal && GST_STATE_VOID_PENDING == pending) {
+        waiters = gstd_state_settle (self, self->transition, GSTD_EOK);
+      }
+      break;
+    case GST_MESSAGE_ASYNC_DONE:
+      if (GST_MESSAGE_SRC (message) != GST_OBJECT_CAST (self->target)) {
+        break;
+      }
+      /* Without the state lock, it may be held by the thread posting */
+      state = GST_STATE (self->target);
+      if (state == self->goal
+          && GST_STATE_VOID_PENDING == GST_STATE_PENDING (self->target)) {
+        self->state = state;
+        waiters = gstd_state_settle (self, self->transition, GSTD_EOK);
+      }
+      break;
+    case GST_MESSAGE_ERROR:
+      waiters = gstd_state_settle (self, self->transition, GSTD_STATE_ERROR);
+      break;
+    default:
+      break;
+  }
+
+out:
+  GST_OBJECT_UNLOCK (self);
+
+  /* Only the top-level bin changes the status */
+  if (changed) {
+    gstd_status_invalidate_all ();
+  }
 
-  ret = gst_element_get_state (self->target, &current, &pending,
-      GSTD_STATE_QUERY_TIMEOUT);
+  gstd_state_notify (self, waiters);
+}
 
-  if (ret == GST_STATE_CHANGE_ASYNC) {
-    GST_DEBUG_OBJECT (self, "State change still pending, current=%s pending=%s",
-        gst_element_state_get_name (current),
-        gst_element_state_get_name (pending));
-  } else if (ret == GST_STATE_CHANGE_FAILURE) {
-    GST_WARNING_OBJECT (self, "Failed to get pipeline state");
+void
+gstd_state_track (GstdState * self, GstdPipelineBus * bus)
+{
+  guint id;
+
+  g_return_if_fail (GSTD_IS_STATE (self));
+  g_return_if_fail (GSTD_IS_PIPELINE_BUS (bus));
+
+  id = gstd_pipeline_bus_subscribe (bus, GST_MESSAGE_STATE_CHANGED |
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR, GSTD_PIPELINE_BUS_SEQ_NONE,
+      gstd_state_on_message, g_object_ref (self), g_object_unref);
+
+  if (0 == id) {
+    g_object_unref (self);
   }
+}
+
+guint64
+gstd_state_get_transition (GstdState * self)
+{
+  guint64 transition;
+
+  g_return_val_if_fail (GSTD_IS_STATE (self), 0);
+
+  GST_OBJECT_LOCK (self);
+  transition = self->transition;
+  GST_OBJECT_UNLOCK (self);
+
+  return transition;
+}
+
+GstdReturnCode
+gstd_state_wait (GstdState * self, guint64 transition, gint64 timeout)
+{
+  GstdReturnCode result;
+  gint64 deadline;
+  gboolean over;
+
+  g_return_val_if_fail (GSTD_IS_STATE (self), GSTD_NULL_ARGUMENT);
+
+  deadline = timeout > 0 ?
+      g_get_monotonic_time () + GST_TIME_AS_USECONDS (timeout) : timeout;
+
+  GST_OBJECT_LOCK (self);
+  if (0 == transition) {
+    transition = self->transition;
+  }
+  while (!(over = gstd_state_outcome (self, transition, &result))
+      && 0 != deadline) {
+    if (deadline < 0) {
+      g_cond_wait (&self->cond, GST_OBJECT_GET_LOCK (self));
+    } else if (!g_cond_wait_until (&self->cond, GST_OBJECT_GET_LOCK (self),
+            deadline)) {
+      over = gstd_state_outcome (self, transition, &result);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (!over) {
+    GST_INFO_OBJECT (self, "Transition %" G_GUINT64_FORMAT
+        " still in progress", transition);
+  } else if (GSTD_BAD_VALUE == result) {
+    GST_ERROR_OBJECT (self, "Unknown transition %" G_GUINT64_FORMAT,
+        transition);
+  }
+
+  return result;
+}
+
+guint
+gstd_state_wait_async (GstdState * self, guint64 transition,
+    GstdStateWaitFunc func, gpointer user_data)
+{
+  GstdStateWaiter *waiter;
+  GstdReturnCode result;
+  guint id = 0;
+
+  g_return_val_if_fail (GSTD_IS_STATE (self), 0);
+  g_return_val_if_fail (func, 0);
+
+  GST_OBJECT_LOCK (self);
+  if (0 == transition) {
+    transition = self->transition;
+  }
+  if (!gstd_state_outcome (self, transition, &result)) {
+    waiter = g_new0 (GstdStateWaiter, 1);
+    waiter->id = id = self->next_id++;
+    waiter->transition = transition;
+    waiter->func = func;
+    waiter->user_data = user_data;
+    self->waiters = g_slist_prepend (self->waiters, waiter);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return id;
+}
+
+gboolean
+gstd_state_wait_cancel (GstdState * self, guint id)
+{
+  GSList *iter;
+  GstdStateWaiter *waiter = NULL;
+
+  g_return_val_if_fail (GSTD_IS_STATE (self), FALSE);
+
+  GST_OBJECT_LOCK (self);
+  for (iter = self->waiters; iter; iter = iter->next) {
+    if (((GstdStateWaiter *) iter->data)->id == id) {
+      waiter = iter->data;
+      self->waiters = g_slist_delete_link (self->waiters, iter);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  g_free (waiter);
 
-  return current;
+  return NULL != waiter;
 }
 
 GstdReturnCode
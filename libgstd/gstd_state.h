@@ -22,6 +22,7 @@
 #define __GSTD_STATE_H__
 
 #include "gstd_object.h"
+#include "gstd_pipeline_bus.h"
 
 G_BEGIN_DECLS
 /*
@@ -46,6 +47,84 @@ GType gstd_state_get_type (void);
 
 GstdState *gstd_state_new (GstElement * target);
 
+/**
+ * gstd_state_track:
+ * @self: A #GstdState
+ * @bus: The bus of its pipeline
+ *
+ * Keeps the transition record up to date from the STATE_CHANGED,
+ * ASYNC_DONE and ERROR messages of @bus, so asynchronous changes
+ * complete without anybody querying the pipeline. Until the bus is
+ * closed, no more changes complete after gst_element_set_state()
+ * returned.
+ */
+void gstd_state_track (GstdState * self, GstdPipelineBus * bus);
+
+/**
+ * gstd_state_get_transition:
+ * @self: A #GstdState
+ *
+ * Returns: The id of the latest state change requested, starting at
+ * 1, or 0 if none was requested yet.
+ */
+guint64 gstd_state_get_transition (GstdState * self);
+
+/**
+ * gstd_state_wait:
+ * @self: A #GstdState
+ * @transition: The id of the transition to wait for, 0 for the latest
+ * one
+ * @timeout: Nanoseconds to wait, -1 to wait forever
+ *
+ * Waits until @transition reaches its target, fails because of an
+ * error posted on the bus, or is replaced by a newer change. Returns
+ * right away if it is already over. Only the outcome of the last few
+ * transitions is remembered.
+ *
+ * Returns: GSTD_EOK if @transition reached its target,
+ * GSTD_STATE_ERROR if it failed, was replaced or is still in progress
+ * after @timeout, GSTD_BAD_VALUE if it is not known.
+ */
+GstdReturnCode gstd_state_wait (GstdState * self, guint64 transition,
+    gint64 timeout);
+
+/**
+ * GstdStateWaitFunc:
+ * @self: The state waited on
+ * @user_data: The data given to gstd_state_wait_async()
+ *
+ * Runs in the thread that completed the transition, usually a
+ * streaming thread, so it should only hand the result over.
+ */
+typedef void (*GstdStateWaitFunc) (GstdState * self, gpointer user_data);
+
+/**
+ * gstd_state_wait_async:
+ * @self: A #GstdState
+ * @transition: The id of the transition to wait for, 0 for the latest
+ * one
+ * @func: Called once @transition is over
+ * @user_data: Data to pass to @func
+ *
+ * Like gstd_state_wait() without holding the calling thread. Its
+ * outcome is then read with gstd_state_wait() and no timeout.
+ *
+ * Returns: The id to cancel the wait with, 0 if @transition is already
+ * over or not known, in which case @func won't be called.
+ */
+guint gstd_state_wait_async (GstdState * self, guint64 transition,
+    GstdStateWaitFunc func, gpointer user_data);
+
+/**
+ * gstd_state_wait_cancel:
+ * @self: A #GstdState
+ * @id: The id given by gstd_state_wait_async()
+ *
+ * Returns: TRUE if the wait was still pending, FALSE if its function
+ * was already called.
+ */
+gboolean gstd_state_wait_cancel (GstdState * self, guint id);
+
 /**
  * Increment the play refcount stored in the state
  *
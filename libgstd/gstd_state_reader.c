@@ -0,0 +1,134 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+
+#include "gstd_state_reader.h"
+#include "gstd_property_reader.h"
+#include "gstd_state.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_state_reader_debug);
+#define GST_CAT_DEFAULT gstd_state_reader_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static GstdReturnCode
+gstd_state_reader_read (GstdIReader * iface,
+    GstdObject * object, const gchar * name, GstdObject ** out);
+
+static GstdReturnCode
+gstd_state_reader_read_wait (GstdIReader * iface,
+    GstdObject * object, GstdObject ** out);
+
+typedef struct _GstdStateReaderClass GstdStateReaderClass;
+
+struct _GstdStateReader
+{
+  GstdPropertyReader parent;
+};
+
+struct _GstdStateReaderClass
+{
+  GstdPropertyReaderClass parent_class;
+};
+
+static GstdIReaderInterface *parent_interface = NULL;
+
+static void
+gstd_ireader_interface_init (GstdIReaderInterface * iface)
+{
+  parent_interface = g_type_interface_peek_parent (iface);
+  iface->read = gstd_state_reader_read;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdStateReader, gstd_state_reader,
+    GSTD_TYPE_PROPERTY_READER, G_IMPLEMENT_INTERFACE (GSTD_TYPE_IREADER,
+        gstd_ireader_interface_init));
+
+static void
+gstd_state_reader_class_init (GstdStateReaderClass * klass)
+{
+  guint debug_color;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_state_reader_debug, "gstdstatereader",
+      debug_color, "Gstd State Reader category");
+}
+
+static void
+gstd_state_reader_init (GstdStateReader * self)
+{
+  GST_INFO_OBJECT (self, "Initializing state reader");
+}
+
+static GstdReturnCode
+gstd_state_reader_read (GstdIReader * iface, GstdObject * object,
+    const gchar * name, GstdObject ** out)
+{
+  GstdReturnCode ret;
+  GstdObject *resource = NULL;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
+
+  /* If the user requested to wait, block on the transition,
+   * else, default to the property reading implementation
+   */
+  if (!g_ascii_strcasecmp ("wait", name)) {
+    ret = gstd_state_reader_read_wait (iface, object, &resource);
+  } else {
+    ret = parent_interface->read (iface, object, name, &resource);
+  }
+
+  /* A failed wait still answers with the record */
+  if (!ret || resource) {
+    *out = resource;
+  }
+
+  return ret;
+}
+
+static GstdReturnCode
+gstd_state_reader_read_wait (GstdIReader * iface,
+    GstdObject * object, GstdObject ** out)
+{
+  GstdState *state;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (GSTD_IS_STATE (object), GSTD_BAD_VALUE);
+  g_return_val_if_fail (out, GSTD_NULL_ARGUMENT);
+
+  state = GSTD_STATE (object);
+
+  /* The latest transition, for as long as it takes. The record tells
+   * how it ended, even when it failed */
+  ret = gstd_state_wait (state, 0, -1);
+  *out = GSTD_OBJECT (g_object_ref (state));
+
+  return ret;
+}
@@ -0,0 +1,835 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <string.h>
+
+#include "gstd_property_reader.h"
+#include "gstd_stats.h"
+
+#if GST_CHECK_VERSION (1, 8, 0) && !defined (GST_DISABLE_GST_TRACER_HOOKS)
+#define GSTD_STATS_HAVE_TRACER 1
+#endif
+
+enum
+{
+  PROP_0,
+  PROP_ENABLED,
+  N_PROPERTIES
+};
+
+/* Nested pushes followed per thread, deeper ones aren't measured */
+#define GSTD_STATS_MAX_DEPTH 16
+
+/* Gstd Stats debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_stats_debug);
+#define GST_CAT_DEFAULT gstd_stats_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/*
+ * What the elements and pads of a pipeline point to, so the hooks
+ * find out whether to measure with a single qdata lookup. Each of them
+ * holds a reference, it outlives the GstdStats if they do.
+ */
+typedef struct _GstdStatsScope
+{
+  gint refcount;
+  gint enabled;
+
+  /* Bumped on every enable, counters of an older one are stale */
+  gint generation;
+  GstClockTime since;
+} GstdStatsScope;
+
+/* The counters of a source pad, as of the enable in generation */
+typedef struct _GstdStatsCounters
+{
+  gint generation;
+
+  guint64 buffers;
+  guint64 bytes;
+  guint64 latency_sum;
+  guint64 latency_count;
+  GstClockTime latency_max;
+} GstdStatsCounters;
+
+/*
+ * Pushes on a pad are serialized, so only its streaming thread writes
+ * the counters. It bumps seq before and after every update, a snapshot
+ * copies them and retries if seq was odd or changed meanwhile, so the
+ * 64-bit counters and a reset for a new generation are never seen half
+ * written, even on 32-bit.
+ */
+typedef struct _GstdStatsPad
+{
+  GstdStatsScope *scope;
+  gint seq;
+
+  GstdStatsCounters counters;
+} GstdStatsPad;
+
+/* The pushes in progress in a thread, innermost last */
+typedef struct _GstdStatsStack
+{
+  guint depth;
+  struct
+  {
+    GstPad *pad;
+    GstClockTime ts;
+  } frames[GSTD_STATS_MAX_DEPTH];
+} GstdStatsStack;
+
+/**
+ * GstdStats:
+ * The tracer stats of a pipeline
+ */
+struct _GstdStats
+{
+  GstdObject parent;
+
+  GstElement *target;
+  GstdStatsScope *scope;
+};
+
+struct _GstdStatsClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdStats, gstd_stats, GSTD_TYPE_OBJECT);
+
+static GQuark gstd_stats_quark;
+static GPrivate gstd_stats_stack = G_PRIVATE_INIT (g_free);
+
+/* VTable */
+static GstdReturnCode
+gstd_stats_to_string (GstdObject * obj, gchar ** outstring);
+static GstdReturnCode gstd_stats_update (GstdObject * object,
+    const gchar * value);
+static void gstd_stats_dispose (GObject * obj);
+static void gstd_stats_get_property (GObject *, guint, GValue *, GParamSpec *);
+
+static GstdStatsScope *
+gstd_stats_scope_ref (GstdStatsScope * scope)
+{
+  g_atomic_int_inc (&scope->refcount);
+
+  return scope;
+}
+
+static void
+gstd_stats_scope_unref (GstdStatsScope * scope)
+{
+  if (g_atomic_int_dec_and_test (&scope->refcount)) {
+    g_free (scope);
+  }
+}
+
+static void
+gstd_stats_pad_free (GstdStatsPad * stats)
+{
+  gstd_stats_scope_unref (stats->scope);
+  g_free (stats);
+}
+
+#ifdef GSTD_STATS_HAVE_TRACER
+
+static void
+gstd_stats_attach_pad (GstdStatsScope * scope, GstPad * pad)
+{
+  GstdStatsPad *stats = g_new0 (GstdStatsPad, 1);
+
+  stats->scope = gstd_stats_scope_ref (scope);
+
+  if (!g_object_replace_qdata (G_OBJECT (pad), gstd_stats_quark, NULL, stats,
+          (GDestroyNotify) gstd_stats_pad_free, NULL)) {
+    gstd_stats_pad_free (stats);
+  }
+}
+
+/* Marks @element, its source pads and, for bins, its children */
+static void
+gstd_stats_attach (GstdStatsScope * scope, GstElement * element)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  gboolean done = FALSE;
+
+  if (g_object_replace_qdata (G_OBJECT (element), gstd_stats_quark, NULL,
+          scope, (GDestroyNotify) gstd_stats_scope_unref, NULL)) {
+    gstd_stats_scope_ref (scope);
+  }
+
+  if (GST_IS_BIN (element)) {
+    it = gst_bin_iterate_elements (GST_BIN (element));
+  } else {
+    it = gst_element_iterate_src_pads (element);
+  }
+
+  /* Attaching twice is harmless, just start over on resync */
+  while (!done) {
+    switch (gst_iterator_next (it, &item)) {
+      case GST_ITERATOR_OK:
+        if (GST_IS_BIN (element)) {
+          gstd_stats_attach (scope, g_value_get_object (&item));
+        } else {
+          gstd_stats_attach_pad (scope, g_value_get_object (&item));
+        }
+        g_value_reset (&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync (it);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+
+  g_value_unset (&item);
+  gst_iterator_free (it);
+}
+
+/*
+ * The tracer, a single instance serves every pipeline. Its hooks run
+ * for every pad of the process, so pads that aren't measured return
+ * right after the qdata lookup.
+ */
+typedef struct _GstdStatsTracer
+{
+  GstTracer parent;
+} GstdStatsTracer;
+
+typedef struct _GstdStatsTracerClass
+{
+  GstTracerClass parent_class;
+} GstdStatsTracerClass;
+
+static GType gstd_stats_tracer_get_type (void);
+G_DEFINE_TYPE (GstdStatsTracer, gstd_stats_tracer, GST_TYPE_TRACER);
+
+/* Never released, the hooks keep running for the whole process */
+static GstTracer *gstd_stats_tracer = NULL;
+
+static void
+gstd_stats_push_pre (GstPad * pad, GstClockTime ts, guint buffers,
+    gsize bytes)
+{
+  GstdStatsPad *stats;
+  GstdStatsCounters *counters;
+  GstdStatsStack *stack;
+  gint generation;
+  GstClockTime latency;
+
+  stats = g_object_get_qdata (G_OBJECT (pad), gstd_stats_quark);
+  if (!stats || !g_atomic_int_get (&stats->scope->enabled)) {
+    return;
+  }
+
+  stack = g_private_get (&gstd_stats_stack);
+  if (G_UNLIKELY (!stack)) {
+    stack = g_new0 (GstdStatsStack, 1);
+    g_private_set (&gstd_stats_stack, stack);
+  }
+
+  counters = &stats->counters;
+  generation = g_atomic_int_get (&stats->scope->generation);
+
+  g_atomic_int_inc (&stats->seq);
+
+  /* Enabled again, start over */
+  if (G_UNLIKELY (counters->generation != generation)) {
+    memset (counters, 0, sizeof (GstdStatsCounters));
+    counters->generation = generation;
+  }
+
+  counters->buffers += buffers;
+  counters->bytes += bytes;
+
+  /* The innermost push in progress is the one that fed this element */
+  if (stack->depth > 0) {
+    latency = ts - stack->frames[stack->depth - 1].ts;
+    counters->latency_sum += latency;
+    counters->latency_count++;
+    counters->latency_max = MAX (counters->latency_max, latency);
+  }
+
+  g_atomic_int_inc (&stats->seq);
+
+  if (stack->depth < GSTD_STATS_MAX_DEPTH) {
+    stack->frames[stack->depth].pad = pad;
+    stack->frames[stack->depth].ts = ts;
+    stack->depth++;
+  }
+}
+
+/* Only pops its own frame, a push started before the pad was measured
+ * has none */
+static void
+gstd_stats_push_post (GstPad * pad)
+{
+  GstdStatsStack *stack = g_private_get (&gstd_stats_stack);
+
+  if (stack && stack->depth > 0
+      && stack->frames[stack->depth - 1].pad == pad) {
+    stack->depth--;
+  }
+}
+
+static void
+gstd_stats_on_push_pre (GObject * tracer, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  gstd_stats_push_pre (pad, ts, 1, gst_buffer_get_size (buffer));
+}
+
+static void
+gstd_stats_on_push_list_pre (GObject * tracer, GstClockTime ts, GstPad * pad,
+    GstBufferList * list)
+{
+  guint len = gst_buffer_list_length (list);
+  gsize bytes = 0;
+  guint i;
+
+  for (i = 0; i < len; i++) {
+    bytes += gst_buffer_get_size (gst_buffer_list_get (list, i));
+  }
+
+  gstd_stats_push_pre (pad, ts, len, bytes);
+}
+
+static void
+gstd_stats_on_push_post (GObject * tracer, GstClockTime ts, GstPad * pad,
+    GstFlowReturn res)
+{
+  gstd_stats_push_post (pad);
+}
+
+/* Pads created at runtime, by demuxers for example */
+static void
+gstd_stats_on_element_add_pad (GObject * tracer, GstClockTime ts,
+    GstElement * element, GstPad * pad)
+{
+  GstdStatsScope *scope;
+
+  scope = g_object_get_qdata (G_OBJECT (element), gstd_stats_quark);
+  if (!scope || GST_IS_BIN (element)
+      || GST_PAD_SRC != GST_PAD_DIRECTION (pad)) {
+    return;
+  }
+
+  gstd_stats_attach_pad (scope, pad);
+}
+
+/* Elements added at runtime, by decodebin for example */
+static void
+gstd_stats_on_bin_add_post (GObject * tracer, GstClockTime ts, GstBin * bin,
+    GstElement * element, gboolean result)
+{
+  GstdStatsScope *scope;
+
+  scope = g_object_get_qdata (G_OBJECT (bin), gstd_stats_quark);
+  if (!scope || !result) {
+    return;
+  }
+
+  gstd_stats_attach (scope, element);
+}
+
+static void
+gstd_stats_tracer_class_init (GstdStatsTracerClass * klass)
+{
+}
+
+static void
+gstd_stats_tracer_init (GstdStatsTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (gstd_stats_on_push_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (gstd_stats_on_push_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (gstd_stats_on_push_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (gstd_stats_on_push_post));
+  gst_tracing_register_hook (tracer, "element-add-pad",
+      G_CALLBACK (gstd_stats_on_element_add_pad));
+  gst_tracing_register_hook (tracer, "bin-add-post",
+      G_CALLBACK (gstd_stats_on_bin_add_post));
+}
+
+#endif // GSTD_STATS_HAVE_TRACER
+
+static void
+gstd_stats_class_init (GstdStatsClass * klass)
+{
+  GObjectClass *oclass = G_OBJECT_CLASS (klass);
+  GstdObjectClass *gstdc = GSTD_OBJECT_CLASS (klass);
+  guint debug_color;
+
+  oclass->dispose = gstd_stats_dispose;
+  oclass->get_property = gstd_stats_get_property;
+
+  gstdc->to_string = GST_DEBUG_FUNCPTR (gstd_stats_to_string);
+  gstdc->update = GST_DEBUG_FUNCPTR (gstd_stats_update);
+
+  g_object_class_install_property (oclass, PROP_ENABLED,
+      g_param_spec_boolean ("enabled", "Enabled",
+          "Whether the pipeline is being measured", FALSE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gstd_stats_quark = g_quark_from_static_string ("gstd-stats");
+
+#ifdef GSTD_STATS_HAVE_TRACER
+  /* Hooks are registered before any pipeline of ours runs, the list
+   * GStreamer keeps them in isn't safe to change while streaming */
+  gstd_stats_tracer = g_object_new (gstd_stats_tracer_get_type (), NULL);
+#endif
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_stats_debug, "gstdstats", debug_color,
+      "Gstd Stats category");
+}
+
+static void
+gstd_stats_init (GstdStats * self)
+{
+  GST_INFO_OBJECT (self, "Initializing stats");
+  self->target = NULL;
+  self->scope = g_new0 (GstdStatsScope, 1);
+  self->scope->refcount = 1;
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
+}
+
+static void
+gstd_stats_get_property (GObject * object,
+    guint property_id, GValue * value, GParamSpec * pspec)
+{
+  GstdStats *self = GSTD_STATS (object);
+
+  switch (property_id) {
+    case PROP_ENABLED:
+      g_value_set_boolean (value, g_atomic_int_get (&self->scope->enabled));
+      break;
+
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+GstdReturnCode
+gstd_stats_set_enabled (GstdStats * self, gboolean enabled)
+{
+  GstdStatsScope *scope;
+
+  g_return_val_if_fail (GSTD_IS_STATS (self), GSTD_NULL_ARGUMENT);
+
+  scope = self->scope;
+
+  if (!enabled) {
+    GST_INFO_OBJECT (self, "Disabling stats");
+    g_atomic_int_set (&scope->enabled, FALSE);
+    return GSTD_EOK;
+  }
+
+#ifdef GSTD_STATS_HAVE_TRACER
+  GST_INFO_OBJECT (self, "Enabling stats");
+
+  /* Elements added while disabled weren't marked */
+  gstd_stats_attach (scope, self->target);
+
+  g_atomic_int_set (&scope->enabled, FALSE);
+  scope->since = gst_util_get_timestamp ();
+  g_atomic_int_inc (&scope->generation);
+  g_atomic_int_set (&scope->enabled, TRUE);
+
+  return GSTD_EOK;
+#else
+  GST_ERROR_OBJECT (self, "GStreamer was built without tracer hooks");
+  return GSTD_NO_UPDATE;
+#endif
+}
+
+/* Copies the counters of @pad, FALSE if it wasn't measured since
+ * enabled */
+static gboolean
+gstd_stats_read (GstdStats * self, GstPad * pad, GstdStatsCounters * counters)
+{
+  GstdStatsPad *stats;
+  gint seq;
+
+  stats = g_object_get_qdata (G_OBJECT (pad), gstd_stats_quark);
+  if (!stats || stats->scope != self->scope) {
+    return FALSE;
+  }
+
+  /* The streaming thread is in the middle of an update, retry */
+  for (;;) {
+    seq = g_atomic_int_get (&stats->seq);
+    if (seq & 1) {
+      g_thread_yield ();
+      continue;
+    }
+
+    *counters = stats->counters;
+    if (seq == g_atomic_int_get (&stats->seq)) {
+      break;
+    }
+  }
+
+  return counters->generation == g_atomic_int_get (&self->scope->generation);
+}
+
+gboolean
+gstd_stats_get_pad (GstdStats * self, GstPad * pad, guint64 * buffers,
+    guint64 * bytes, GstClockTime * latency)
+{
+  GstdStatsCounters counters;
+
+  g_return_val_if_fail (GSTD_IS_STATS (self), FALSE);
+  g_return_val_if_fail (GST_IS_PAD (pad), FALSE);
+
+  if (!gstd_stats_read (self, pad, &counters)) {
+    return FALSE;
+  }
+
+  if (buffers) {
+    *buffers = counters.buffers;
+  }
+  if (bytes) {
+    *bytes = counters.bytes;
+  }
+  if (latency) {
+    guint64 count = counters.latency_count;
+
+    *latency = count ? counters.latency_sum / count : GST_CLOCK_TIME_NONE;
+  }
+
+  return TRUE;
+}
+
+static void
+gstd_stats_add_uint64 (GstdIFormatter * formatter, const gchar * name,
+    guint64 value)
+{
+  GValue gvalue = G_VALUE_INIT;
+
+  g_value_init (&gvalue, G_TYPE_UINT64);
+  g_value_set_uint64 (&gvalue, value);
+
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_value (formatter, &gvalue);
+
+  g_value_unset (&gvalue);
+}
+
+/* queue and queue2 don't agree on every type, take them as they are */
+static void
+gstd_stats_add_property (GstdIFormatter * formatter, GstElement * element,
+    const gchar * name, const gchar * property)
+{
+  GValue value = G_VALUE_INIT;
+  GParamSpec *pspec;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+      property);
+  if (!pspec) {
+    return;
+  }
+
+  g_value_init (&value, pspec->value_type);
+  g_object_get_property (G_OBJECT (element), property, &value);
+
+  gstd_iformatter_set_member_name (formatter, name);
+  gstd_iformatter_set_value (formatter, &value);
+
+  g_value_unset (&value);
+}
+
+/* The path of @element in the pipeline, as in the elements resource */
+static gchar *
+gstd_stats_get_path (GstdStats * self, GstElement * element)
+{
+  GstObject *parent;
+  GstObject *object = gst_object_ref (element);
+  gchar *name;
+  gchar *path = NULL;
+  gchar *tmp;
+
+  while (object && object != GST_OBJECT (self->target)) {
+    name = gst_object_get_name (object);
+    tmp = path ? g_strconcat (name, "/", path, NULL) : g_strdup (name);
+    g_free (path);
+    g_free (name);
+    path = tmp;
+
+    parent = gst_object_get_parent (object);
+    gst_object_unref (object);
+    object = parent;
+  }
+
+  if (object) {
+    gst_object_unref (object);
+  }
+
+  return path;
+}
+
+static void
+gstd_stats_add_pads (GstdStats * self, GstdIFormatter * formatter,
+    GstElement * element, const gchar * path)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstPad *pad;
+  GstdStatsCounters counters;
+  gchar *name;
+  guint64 count;
+
+  it = gst_element_iterate_src_pads (element);
+
+  /* A snapshot, pads changing meanwhile are left for the next one */
+  while (GST_ITERATOR_OK == gst_iterator_next (it, &item)) {
+    pad = g_value_get_object (&item);
+    if (gstd_stats_read (self, pad, &counters)) {
+      gstd_iformatter_begin_object (formatter);
+
+      gstd_iformatter_set_member_name (formatter, "element");
+      gstd_iformatter_set_string_value (formatter, path);
+
+      name = gst_pad_get_name (pad);
+      gstd_iformatter_set_member_name (formatter, "pad");
+      gstd_iformatter_set_string_value (formatter, name);
+      g_free (name);
+
+      gstd_stats_add_uint64 (formatter, "buffers", counters.buffers);
+      gstd_stats_add_uint64 (formatter, "bytes", counters.bytes);
+
+      gstd_iformatter_set_member_name (formatter, "latency");
+      gstd_iformatter_begin_object (formatter);
+      count = counters.latency_count;
+      gstd_stats_add_uint64 (formatter, "count", count);
+      gstd_stats_add_uint64 (formatter, "mean",
+          count ? counters.latency_sum / count : 0);
+      gstd_stats_add_uint64 (formatter, "max", counters.latency_max);
+      gstd_iformatter_end_object (formatter);
+
+      gstd_iformatter_end_object (formatter);
+    }
+
+    g_value_reset (&item);
+  }
+
+  g_value_unset (&item);
+  gst_iterator_free (it);
+}
+
+static void
+gstd_stats_add_queue (GstdIFormatter * formatter, GstElement * element,
+    const gchar * path)
+{
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "element");
+  gstd_iformatter_set_string_value (formatter, path);
+
+  gstd_stats_add_property (formatter, element, "buffers",
+      "current-level-buffers");
+  gstd_stats_add_property (formatter, element, "bytes",
+      "current-level-bytes");
+  gstd_stats_add_property (formatter, element, "time", "current-level-time");
+  gstd_stats_add_property (formatter, element, "max-buffers",
+      "max-size-buffers");
+  gstd_stats_add_property (formatter, element, "max-bytes", "max-size-bytes");
+  gstd_stats_add_property (formatter, element, "max-time", "max-size-time");
+
+  gstd_iformatter_end_object (formatter);
+}
+
+static GList *
+gstd_stats_get_elements (GstdStats * self)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GList *elements = NULL;
+  gboolean done = FALSE;
+
+  it = gst_bin_iterate_recurse (GST_BIN (self->target));
+
+  while (!done) {
+    switch (gst_iterator_next (it, &item)) {
+      case GST_ITERATOR_OK:
+        elements = g_list_prepend (elements,
+            gst_object_ref (g_value_get_object (&item)));
+        g_value_reset (&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        g_list_free_full (elements, gst_object_unref);
+        elements = NULL;
+        gst_iterator_resync (it);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  /* Prepended, keep the iteration order */
+  return g_list_reverse (elements);
+}
+
+static GstdReturnCode
+gstd_stats_to_string (GstdObject * obj, gchar ** outstring)
+{
+  GstdStats *self;
+  GstdIFormatter *formatter;
+  GValue value = G_VALUE_INIT;
+  GList *elements;
+  GList *iter;
+  GstElement *element;
+  gboolean enabled;
+  gchar *path;
+
+  g_return_val_if_fail (GSTD_IS_OBJECT (obj), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (outstring, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_STATS (obj);
+  formatter = gstd_object_new_formatter (obj);
+  enabled = g_atomic_int_get (&self->scope->enabled);
+  elements = enabled ? gstd_stats_get_elements (self) : NULL;
+
+  gstd_iformatter_begin_object (formatter);
+
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&value, enabled);
+  gstd_iformatter_set_member_name (formatter, "enabled");
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  gstd_stats_add_uint64 (formatter, "elapsed",
+      enabled ? gst_util_get_timestamp () - self->scope->since : 0);
+
+  gstd_iformatter_set_member_name (formatter, "pads");
+  gstd_iformatter_begin_array (formatter);
+  for (iter = elements; iter; iter = g_list_next (iter)) {
+    element = GST_ELEMENT (iter->data);
+    if (!GST_IS_BIN (element)) {
+      path = gstd_stats_get_path (self, element);
+      gstd_stats_add_pads (self, formatter, element, path);
+      g_free (path);
+    }
+  }
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "queues");
+  gstd_iformatter_begin_array (formatter);
+  for (iter = elements; iter; iter = g_list_next (iter)) {
+    element = GST_ELEMENT (iter->data);
+    if (g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+            "current-level-buffers")) {
+      path = gstd_stats_get_path (self, element);
+      gstd_stats_add_queue (formatter, element, path);
+      g_free (path);
+    }
+  }
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, outstring);
+
+  g_list_free_full (elements, gst_object_unref);
+  g_object_unref (formatter);
+
+  return GSTD_EOK;
+}
+
+static GstdReturnCode
+gstd_stats_update (GstdObject * object, const gchar * svalue)
+{
+  GstdStats *self;
+  GValue value = G_VALUE_INIT;
+  gboolean enabled;
+
+  g_return_val_if_fail (object, GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (svalue, GSTD_NULL_ARGUMENT);
+
+  self = GSTD_STATS (object);
+
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  if (!gst_value_deserialize (&value, svalue)) {
+    GST_ERROR_OBJECT (self, "Unable to interpret \"%s\" as a boolean", svalue);
+    g_value_unset (&value);
+    return GSTD_BAD_VALUE;
+  }
+
+  enabled = g_value_get_boolean (&value);
+  g_value_unset (&value);
+
+  return gstd_stats_set_enabled (self, enabled);
+}
+
+GstdStats *
+gstd_stats_new (GstElement * target)
+{
+  GstdStats *self;
+
+  g_return_val_if_fail (GST_IS_BIN (target), NULL);
+
+  self = g_object_new (GSTD_TYPE_STATS, "name", "stats", NULL);
+  self->target = gst_object_ref (target);
+
+  return self;
+}
+
+static void
+gstd_stats_dispose (GObject * object)
+{
+  GstdStats *self = GSTD_STATS (object);
+
+  /* The marked elements keep the scope until they are gone */
+  if (self->scope) {
+    g_atomic_int_set (&self->scope->enabled, FALSE);
+    gstd_stats_scope_unref (self->scope);
+    self->scope = NULL;
+  }
+
+  if (self->target) {
+    gst_object_unref (self->target);
+    self->target = NULL;
+  }
+
+  G_OBJECT_CLASS (gstd_stats_parent_class)->dispose (object);
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_STATS_H__
+#define __GSTD_STATS_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_STATS \
+  (gstd_stats_get_type())
+#define GSTD_STATS(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_STATS,GstdStats))
+#define GSTD_STATS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_STATS,GstdStatsClass))
+#define GSTD_IS_STATS(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_STATS))
+#define GSTD_IS_STATS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_STATS))
+#define GSTD_STATS_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_STATS, GstdStatsClass))
+typedef struct _GstdStats GstdStats;
+typedef struct _GstdStatsClass GstdStatsClass;
+
+GType gstd_stats_get_type (void);
+
+/*
+ * The throughput and latency of a pipeline, measured by a tracer
+ * built into gstd. Disabled by default, updating the resource with
+ * "true" or "false" turns it on and off while the pipeline runs, and
+ * reading it takes a snapshot:
+ *
+ * - buffers and bytes pushed by each source pad
+ * - the mean and maximum latency of each source pad: how long buffers
+ *   take from reaching the element to leaving through the pad, for
+ *   elements pushing from the thread that feeds them
+ * - the fill level of each queue
+ */
+
+GstdStats *gstd_stats_new (GstElement * target);
+
+/**
+ * gstd_stats_set_enabled:
+ * @self: A #GstdStats
+ * @enabled: Whether to measure the pipeline
+ *
+ * Enabling starts over from zero.
+ *
+ * Returns: GSTD_EOK, or GSTD_NO_UPDATE if GStreamer was built without
+ * tracer hooks.
+ */
+GstdReturnCode gstd_stats_set_enabled (GstdStats * self, gboolean enabled);
+
+/**
+ * gstd_stats_get_pad:
+ * @self: A #GstdStats
+ * @pad: A source pad of the pipeline
+ * @buffers: (out) (optional): Buffers pushed since enabled
+ * @bytes: (out) (optional): Bytes pushed since enabled
+ * @latency: (out) (optional): Mean latency, GST_CLOCK_TIME_NONE if
+ * never measured
+ *
+ * Returns: FALSE if @pad isn't measured.
+ */
+gboolean gstd_stats_get_pad (GstdStats * self, GstPad * pad,
+    guint64 * buffers, guint64 * bytes, GstClockTime * latency);
+
+G_END_DECLS
+#endif // __GSTD_STATS_H__
@@ -0,0 +1,331 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstd_status.h"
+#include "gstd_json_writer.h"
+#include "gstd_pipeline.h"
+#include "gstd_pipeline_deleter.h"
+
+typedef struct _GstdStatusWatch GstdStatusWatch;
+
+struct _GstdStatusWatch
+{
+  guint id;
+  GstdStatusFunc func;
+  gpointer user_data;
+};
+
+struct _GstdStatus
+{
+  GstdList *pipelines;
+
+  /* Serializes rebuilds, readers of a current document never take it */
+  GMutex build_lock;
+
+  /* The last gstd_status_epoch a rebuild started from */
+  gint built;
+
+  /* The content of the document, to skip versions on no-op changes.
+   * Protected by build_lock */
+  gchar *content;
+
+  /* Only held to swap or reference the document */
+  GMutex lock;
+  GBytes *document;
+  guint64 version;
+};
+
+/* Bumped by gstd_status_invalidate_all() */
+static gint gstd_status_epoch = 1;
+
+/* Protects the watches, shared by every status */
+static GMutex gstd_status_watch_lock;
+static GSList *gstd_status_watches = NULL;
+static guint gstd_status_next_id = 1;
+
+static gchar *gstd_status_build_content (GstdStatus * status);
+static void gstd_status_rebuild (GstdStatus * status);
+
+GstdStatus *
+gstd_status_new (GstdList * pipelines)
+{
+  GstdStatus *status;
+
+  g_return_val_if_fail (GSTD_IS_LIST (pipelines), NULL);
+
+  status = g_new0 (GstdStatus, 1);
+  status->pipelines = g_object_ref (pipelines);
+  g_mutex_init (&status->build_lock);
+  g_mutex_init (&status->lock);
+
+  /* Outdated, the first read builds it */
+  status->built = g_atomic_int_get (&gstd_status_epoch) - 1;
+
+  return status;
+}
+
+void
+gstd_status_free (GstdStatus * status)
+{
+  if (!status)
+    return;
+
+  g_clear_pointer (&status->document, g_bytes_unref);
+  g_free (status->content);
+  g_mutex_clear (&status->lock);
+  g_mutex_clear (&status->build_lock);
+  g_object_unref (status->pipelines);
+  g_free (status);
+}
+
+/*
+ * The part of the response below "response", without the version.
+ * The states are the last known ones, GST_STATE() doesn't wait for a
+ * change in progress.
+ */
+static gchar *
+gstd_status_build_content (GstdStatus * status)
+{
+  GstdList *list = status->pipelines;
+  GstdIDeleter *deleter;
+  GString *json;
+  GList *pipelines;
+  GList *iter;
+  gchar **deleting = NULL;
+  gboolean first = TRUE;
+  guint count;
+  guint i;
+
+  json = g_string_new ("\"pipelines\": [");
+
+  /* Only hold the list lock to take the pipelines */
+  GST_OBJECT_LOCK (list);
+  pipelines = g_list_copy_deep (list->nodes.head, (GCopyFunc) gst_object_ref,
+      NULL);
+  count = list->count;
+  GST_OBJECT_UNLOCK (list);
+
+  for (iter = pipelines; iter != NULL; iter = g_list_next (iter)) {
+    GstdPipeline *pipeline = GSTD_PIPELINE (iter->data);
+    GstElement *element = gstd_pipeline_get_element (pipeline);
+    GstState state = GST_STATE_NULL;
+
+    if (element) {
+      state = GST_STATE (element);
+    }
+
+    /* Names are user provided, escape them */
+    g_string_append_printf (json, "%s\n      {\"name\": ", first ? "" : ",");
+    gstd_json_writer_append_escaped (json, GSTD_OBJECT_NAME (pipeline));
+    g_string_append_printf (json, ", \"state\": \"%s\"}",
+        gst_element_state_get_name (state));
+    first = FALSE;
+  }
+
+  g_list_free_full (pipelines, gst_object_unref);
+
+  /* Pipelines still tearing down are already out of the list */
+  deleter = GSTD_OBJECT (list)->deleter;
+  if (GSTD_IS_PIPELINE_DELETER (deleter)) {
+    deleting =
+        gstd_pipeline_deleter_get_deleting (GSTD_PIPELINE_DELETER (deleter));
+  }
+
+  for (i = 0; deleting && deleting[i]; i++) {
+    g_string_append_printf (json, "%s\n      {\"name\": ", first ? "" : ",");
+    gstd_json_writer_append_escaped (json, deleting[i]);
+    g_string_append (json, ", \"state\": \"deleting\"}");
+    first = FALSE;
+  }
+  g_strfreev (deleting);
+
+  g_string_append_printf (json,
+      "\n    ],\n    \"count\": %u,\n    \"deleting\": %u", count, i);
+
+  return g_string_free (json, FALSE);
+}
+
+/*
+ * Builds a new document if the content changed and publishes it. The
+ * epoch is taken before reading the pipelines, so a change racing
+ * with the build outdates the result and the next read builds again.
+ */
+static void
+gstd_status_rebuild (GstdStatus * status)
+{
+  gint epoch;
+  GBytes *document;
+  GBytes *old;
+  gchar *content;
+  gchar *json;
+  guint64 version;
+
+  g_mutex_lock (&status->build_lock);
+
+  /* Another reader got here first */
+  epoch = g_atomic_int_get (&gstd_status_epoch);
+  if (g_atomic_int_get (&status->built) == epoch) {
+    g_mutex_unlock (&status->build_lock);
+    return;
+  }
+
+  content = gstd_status_build_content (status);
+
+  if (status->document && 0 == g_strcmp0 (content, status->content)) {
+    g_free (content);
+    goto out;
+  }
+
+  g_free (status->content);
+  status->content = content;
+
+  /* Only the builder changes the version */
+  version = status->version + 1;
+  json = g_strdup_printf ("{\n  \"code\" : 0,\n  \"description\" : \"OK\",\n"
+      "  \"response\" : {\n    \"version\": %" G_GUINT64_FORMAT ",\n    %s\n"
+      "  }\n}", version, content);
+  document = g_bytes_new_take (json, strlen (json));
+
+  g_mutex_lock (&status->lock);
+  old = status->document;
+  status->document = document;
+  status->version = version;
+  g_mutex_unlock (&status->lock);
+
+  /* Readers still sending the old one keep their own reference */
+  if (old) {
+    g_bytes_unref (old);
+  }
+
+out:
+  /* Only marked current once published, so a watch can't be set on a
+   * document about to be replaced */
+  g_atomic_int_set (&status->built, epoch);
+  g_mutex_unlock (&status->build_lock);
+}
+
+GBytes *
+gstd_status_get (GstdStatus * status, guint64 * version)
+{
+  GBytes *document;
+
+  g_return_val_if_fail (status, NULL);
+
+  if (g_atomic_int_get (&status->built) !=
+      g_atomic_int_get (&gstd_status_epoch)) {
+    gstd_status_rebuild (status);
+  }
+
+  g_mutex_lock (&status->lock);
+  document = g_bytes_ref (status->document);
+  if (version) {
+    *version = status->version;
+  }
+  g_mutex_unlock (&status->lock);
+
+  return document;
+}
+
+guint
+gstd_status_watch (GstdStatus * status, guint64 version,
+    GstdStatusFunc func, gpointer user_data)
+{
+  GstdStatusWatch *watch;
+  guint64 current;
+  guint id = 0;
+
+  g_return_val_if_fail (status, 0);
+  g_return_val_if_fail (func, 0);
+
+  g_mutex_lock (&status->lock);
+  current = status->version;
+  g_mutex_unlock (&status->lock);
+
+  /* Checked under the lock, an invalidation either came before and is
+   * reported, or comes after and finds the watch */
+  g_mutex_lock (&gstd_status_watch_lock);
+  if (current == version && g_atomic_int_get (&status->built) ==
+      g_atomic_int_get (&gstd_status_epoch)) {
+    watch = g_new (GstdStatusWatch, 1);
+    watch->id = id = gstd_status_next_id++;
+    watch->func = func;
+    watch->user_data = user_data;
+
+    /* Never hand out 0 */
+    if (0 == gstd_status_next_id) {
+      gstd_status_next_id = 1;
+    }
+
+    gstd_status_watches = g_slist_prepend (gstd_status_watches, watch);
+  }
+  g_mutex_unlock (&gstd_status_watch_lock);
+
+  return id;
+}
+
+gboolean
+gstd_status_unwatch (guint id)
+{
+  GstdStatusWatch *watch = NULL;
+  GSList *iter;
+
+  g_mutex_lock (&gstd_status_watch_lock);
+  for (iter = gstd_status_watches; iter; iter = g_slist_next (iter)) {
+    if (((GstdStatusWatch *) iter->data)->id == id) {
+      watch = iter->data;
+      gstd_status_watches =
+          g_slist_delete_link (gstd_status_watches, iter);
+      break;
+    }
+  }
+  g_mutex_unlock (&gstd_status_watch_lock);
+
+  g_free (watch);
+
+  return NULL != watch;
+}
+
+void
+gstd_status_invalidate_all (void)
+{
+  GSList *watches;
+  GSList *iter;
+
+  g_atomic_int_inc (&gstd_status_epoch);
+
+  g_mutex_lock (&gstd_status_watch_lock);
+  watches = gstd_status_watches;
+  gstd_status_watches = NULL;
+  g_mutex_unlock (&gstd_status_watch_lock);
+
+  for (iter = watches; iter; iter = g_slist_next (iter)) {
+    GstdStatusWatch *watch = iter->data;
+
+    watch->func (watch->user_data);
+  }
+
+  g_slist_free_full (watches, g_free);
+}
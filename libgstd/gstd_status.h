@@ -0,0 +1,108 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_STATUS_H__
+#define __GSTD_STATUS_H__
+
+#include <glib.h>
+
+#include "gstd_list.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GstdStatus:
+ * The published pipeline status document: the name and state of every
+ * pipeline, plus those still being deleted. The document is immutable
+ * and only rebuilt after a change, readers just take a reference to
+ * the current one.
+ */
+typedef struct _GstdStatus GstdStatus;
+
+/**
+ * gstd_status_new:
+ * @pipelines: The pipeline list of a session, with its deleter set
+ *
+ * Returns: (transfer full): A new #GstdStatus, keeping a reference to
+ * @pipelines. Free with gstd_status_free().
+ */
+GstdStatus *gstd_status_new (GstdList * pipelines);
+void gstd_status_free (GstdStatus * status);
+
+/**
+ * gstd_status_get:
+ * @status: The status of a session
+ * @version: (out) (optional): The version of the document, starting
+ * at 1 and increased every time its content changes
+ *
+ * Rebuilds the document first if something changed since it was
+ * built, which only happens once per change.
+ *
+ * Returns: (transfer full): The document, a complete JSON response.
+ */
+GBytes *gstd_status_get (GstdStatus * status, guint64 * version);
+
+/**
+ * GstdStatusFunc:
+ * @user_data: The data given to gstd_status_watch()
+ *
+ * Runs in the thread that made the change, usually a streaming thread,
+ * so it should only schedule the read of the new document.
+ */
+typedef void (*GstdStatusFunc) (gpointer user_data);
+
+/**
+ * gstd_status_watch:
+ * @status: The status of a session
+ * @version: The version the caller has
+ * @func: Called once on the next change
+ * @user_data: Data to pass to @func
+ *
+ * A change doesn't always produce a new version, @func may be called
+ * and find the same document.
+ *
+ * Returns: The id to cancel the watch with, or 0 if a change is
+ * already pending or @version is not the current one, in which case
+ * @func won't be called and the document should be read again.
+ */
+guint gstd_status_watch (GstdStatus * status, guint64 version,
+    GstdStatusFunc func, gpointer user_data);
+
+/**
+ * gstd_status_unwatch:
+ * @id: The id given by gstd_status_watch()
+ *
+ * Returns: TRUE if the watch was still pending, FALSE if its function
+ * was already called.
+ */
+gboolean gstd_status_unwatch (guint id);
+
+/**
+ * gstd_status_invalidate_all:
+ *
+ * Marks every status document as outdated and wakes the watchers. For
+ * changes whose owner doesn't know the session, like a pipeline
+ * changing state or finishing its deletion. Cheap enough to be called
+ * from streaming threads.
+ */
+void gstd_status_invalidate_all (void);
+
+G_END_DECLS
+#endif // __GSTD_STATUS_H__
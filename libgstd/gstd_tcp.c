@@ -62,6 +62,8 @@ G_DEFINE_TYPE (GstdTcp, gstd_tcp, GSTD_TYPE_SOCKET);
 static void gstd_tcp_dispose (GObject *);
 static GstdReturnCode gstd_tcp_create_socket_service (GstdSocket * base,
     GSocketService ** service);
+static GstdReturnCode gstd_tcp_get_addresses (GstdSocket * base,
+    GList ** addresses);
 static gboolean gstd_tcp_init_get_option_group (GstdIpc * base,
     GOptionGroup ** group);
 static gboolean gstd_tcp_add_listeners (GSocketService * service,
@@ -79,6 +81,8 @@ gstd_tcp_class_init (GstdTcpClass * klass)
       GST_DEBUG_FUNCPTR (gstd_tcp_init_get_option_group);
   socket_class->create_socket_service =
       GST_DEBUG_FUNCPTR (gstd_tcp_create_socket_service);
+  socket_class->get_addresses = GST_DEBUG_FUNCPTR (gstd_tcp_get_addresses);
+  socket_class->ipc = GSTD_METRICS_IPC_TCP;
   object_class->dispose = gstd_tcp_dispose;
 
   /* Initialize debug category with nice colors */
@@ -142,6 +146,31 @@ noconnection:
   }
 }
 
+static GstdReturnCode
+gstd_tcp_get_addresses (GstdSocket * base, GList ** addresses)
+{
+  GstdTcp *self = GSTD_TCP (base);
+  GSocketAddress *sa;
+  guint i;
+
+  /* The thread limit bounds the command workers instead */
+  base->max_workers = self->max_threads;
+
+  for (i = 0; i < self->num_ports; i++) {
+    sa = g_inet_socket_address_new_from_string (self->address,
+        self->base_port + i);
+    if (NULL == sa) {
+      GST_ERROR_OBJECT (self, "Invalid TCP address %s", self->address);
+      g_list_free_full (*addresses, g_object_unref);
+      *addresses = NULL;
+      return GSTD_NO_CONNECTION;
+    }
+    *addresses = g_list_append (*addresses, sa);
+  }
+
+  return GSTD_EOK;
+}
+
 gboolean
 gstd_tcp_init_get_option_group (GstdIpc * base, GOptionGroup ** group)
 {
@@ -167,6 +196,13 @@ gstd_tcp_init_get_option_group (GstdIpc * base, GOptionGroup ** group)
           "means unlimited (default -1)",
         "tcp-max-threads"}
     ,
+    {"tcp-io-threads", 0, 0, G_OPTION_ARG_INT,
+          &GSTD_SOCKET (self)->io_threads,
+          "Serve every connection from this many event loop threads, "
+          "running commands on at most tcp-max-threads workers. 0 uses one "
+          "thread per connection (default 0)",
+        "tcp-io-threads"}
+    ,
     {NULL}
   };
   GST_DEBUG_OBJECT (self, "TCP init group callback ");
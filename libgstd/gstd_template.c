@@ -0,0 +1,1237 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/gst.h>
+
+#include "gstd_property_reader.h"
+
+#include "gstd_template.h"
+
+enum
+{
+  PROP_DESCRIPTION = 1,
+  PROP_PARAMETERS,
+  PROP_COMPILED,
+  N_PROPERTIES                  // NOT A PROPERTY
+};
+
+#define GSTD_TEMPLATE_DEFAULT_DESCRIPTION NULL
+
+/* Gstd Template debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_template_debug);
+#define GST_CAT_DEFAULT gstd_template_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+/*
+ * A property set from placeholders, as in location=/tmp/${id}.mp4
+ */
+typedef struct _GstdTemplateBinding
+{
+  /* Where the pair was taken out of the stripped description */
+  gsize offset;
+  gchar *element;
+  gchar *property;
+  gchar *pattern;
+
+  /* Resolved by gstd_template_build() */
+  GParamSpec *pspec;
+  guint node;
+} GstdTemplateBinding;
+
+/*
+ * An element of a compiled template, with the properties the
+ * description sets on it
+ */
+typedef struct _GstdTemplateNode
+{
+  GstElementFactory *factory;
+  gchar *name;
+  GPtrArray *names;
+  GArray *values;
+} GstdTemplateNode;
+
+typedef struct _GstdTemplateLink
+{
+  guint src;
+  gchar *srcpad;
+  guint sink;
+  gchar *sinkpad;
+} GstdTemplateLink;
+
+/**
+ * GstdTemplate:
+ * A pipeline description with placeholders, validated once and
+ * instantiated many times. Immutable once built.
+ */
+struct _GstdTemplate
+{
+  GstdObject parent;
+
+  /**
+   * The description as registered
+   */
+  gchar *description;
+
+  /**
+   * The description without the placeholder pairs, where every element
+   * holding one is named
+   */
+  gchar *stripped;
+
+  /**
+   * The GstdTemplateBinding of each placeholder pair, in order
+   */
+  GPtrArray *bindings;
+
+  /**
+   * The placeholder names, in order of appearance
+   */
+  GPtrArray *parameters;
+
+  /**
+   * The GstdTemplateNode and GstdTemplateLink to build instances
+   * from, NULL if they go through gst_parse_launch()
+   */
+  GPtrArray *nodes;
+  GArray *links;
+};
+
+struct _GstdTemplateClass
+{
+  GstdObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GstdTemplate, gstd_template, GSTD_TYPE_OBJECT);
+
+/* VTable */
+static void
+gstd_template_get_property (GObject *, guint, GValue *, GParamSpec *);
+static void
+gstd_template_set_property (GObject *, guint, const GValue *, GParamSpec *);
+static void gstd_template_finalize (GObject *);
+static void gstd_template_binding_free (gpointer data);
+static void gstd_template_node_free (gpointer data);
+static void gstd_template_link_clear (gpointer data);
+
+static void
+gstd_template_class_init (GstdTemplateClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GParamSpec *properties[N_PROPERTIES] = { NULL, };
+  guint debug_color;
+
+  object_class->set_property = gstd_template_set_property;
+  object_class->get_property = gstd_template_get_property;
+  object_class->finalize = gstd_template_finalize;
+
+  properties[PROP_DESCRIPTION] =
+      g_param_spec_string ("description",
+      "Description",
+      "The gst-launch like description, with ${name} placeholders",
+      GSTD_TEMPLATE_DEFAULT_DESCRIPTION,
+      G_PARAM_CONSTRUCT_ONLY |
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_PARAMETERS] =
+      g_param_spec_string ("parameters",
+      "Parameters",
+      "The placeholder names, space separated",
+      NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  properties[PROP_COMPILED] =
+      g_param_spec_boolean ("compiled",
+      "Compiled",
+      "Whether instances are built without parsing the description",
+      FALSE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS | GSTD_PARAM_READ);
+
+  g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_template_debug, "gstdtemplate", debug_color,
+      "Gstd Template category");
+}
+
+static void
+gstd_template_init (GstdTemplate * self)
+{
+  GST_INFO_OBJECT (self, "Initializing template");
+  self->description = g_strdup (GSTD_TEMPLATE_DEFAULT_DESCRIPTION);
+  self->stripped = NULL;
+  self->bindings = g_ptr_array_new_with_free_func (gstd_template_binding_free);
+  self->parameters = g_ptr_array_new_with_free_func (g_free);
+  self->nodes = NULL;
+  self->links = NULL;
+
+  gstd_object_set_reader (GSTD_OBJECT (self),
+      g_object_new (GSTD_TYPE_PROPERTY_READER, NULL));
+}
+
+static void
+gstd_template_finalize (GObject * object)
+{
+  GstdTemplate *self = GSTD_TEMPLATE (object);
+
+  GST_INFO_OBJECT (self, "Finalizing %s template", GSTD_OBJECT_NAME (self));
+
+  g_free (self->description);
+  g_free (self->stripped);
+  g_ptr_array_unref (self->bindings);
+  g_ptr_array_unref (self->parameters);
+  if (self->nodes) {
+    g_ptr_array_unref (self->nodes);
+  }
+  if (self->links) {
+    g_array_unref (self->links);
+  }
+
+  G_OBJECT_CLASS (gstd_template_parent_class)->finalize (object);
+}
+
+static void
+gstd_template_get_property (GObject * object,
+    guint property_id, GValue * value, GParamSpec * pspec)
+{
+  GstdTemplate *self = GSTD_TEMPLATE (object);
+  GString *parameters;
+  guint i;
+
+  switch (property_id) {
+    case PROP_DESCRIPTION:
+      GST_DEBUG_OBJECT (self, "Returning description of \"%s\"",
+          self->description);
+      g_value_set_string (value, self->description);
+      break;
+    case PROP_PARAMETERS:
+      parameters = g_string_new (NULL);
+      for (i = 0; i < self->parameters->len; i++) {
+        g_string_append_printf (parameters, "%s%s", i ? " " : "",
+            (gchar *) g_ptr_array_index (self->parameters, i));
+      }
+      g_value_take_string (value, g_string_free (parameters, FALSE));
+      break;
+    case PROP_COMPILED:
+      g_value_set_boolean (value, NULL != self->nodes);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_template_set_property (GObject * object,
+    guint property_id, const GValue * value, GParamSpec * pspec)
+{
+  GstdTemplate *self = GSTD_TEMPLATE (object);
+
+  switch (property_id) {
+    case PROP_DESCRIPTION:
+      g_free (self->description);
+      self->description = g_value_dup_string (value);
+      GST_INFO_OBJECT (self, "Changed description to \"%s\"",
+          self->description);
+      break;
+    default:
+      /* We don't have any other property... */
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gstd_template_binding_free (gpointer data)
+{
+  GstdTemplateBinding *binding = data;
+
+  g_free (binding->element);
+  g_free (binding->property);
+  g_free (binding->pattern);
+  if (binding->pspec) {
+    g_param_spec_unref (binding->pspec);
+  }
+  g_free (binding);
+}
+
+static void
+gstd_template_node_free (gpointer data)
+{
+  GstdTemplateNode *node = data;
+
+  gst_object_unref (node->factory);
+  g_free (node->name);
+  g_ptr_array_unref (node->names);
+  g_array_unref (node->values);
+  g_free (node);
+}
+
+static void
+gstd_template_link_clear (gpointer data)
+{
+  GstdTemplateLink *link = data;
+
+  g_free (link->srcpad);
+  g_free (link->sinkpad);
+}
+
+/* Names are made of alphanumerics, '-', '_' and any of @extra */
+static gboolean
+gstd_template_is_word (const gchar * str, gsize len, const gchar * extra)
+{
+  gsize i;
+
+  if (0 == len) {
+    return FALSE;
+  }
+
+  for (i = 0; i < len; i++) {
+    if (!g_ascii_isalnum (str[i]) && '-' != str[i] && '_' != str[i]
+        && !strchr (extra, str[i])) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*
+ * Finds the next space separated token of @str from *@pos. Double
+ * quoted text is kept whole. In a @launch line "!" and a leading "("
+ * or ")" are tokens of their own.
+ */
+static gboolean
+gstd_template_next_token (const gchar * str, gboolean launch, gsize * pos,
+    gsize * start, gsize * end)
+{
+  gboolean quoted = FALSE;
+  gsize i = *pos;
+
+  while (g_ascii_isspace (str[i])) {
+    i++;
+  }
+
+  if ('\0' == str[i]) {
+    return FALSE;
+  }
+
+  *start = i;
+  if (launch && strchr ("!()", str[i])) {
+    i++;
+  } else {
+    for (; str[i]; i++) {
+      if ('\\' == str[i] && str[i + 1]) {
+        i++;
+      } else if ('"' == str[i]) {
+        quoted = !quoted;
+      } else if (!quoted && (g_ascii_isspace (str[i]) || (launch
+                  && '!' == str[i]))) {
+        break;
+      }
+    }
+  }
+  *end = *pos = i;
+
+  return TRUE;
+}
+
+/*
+ * The value of a name=value token, without its quotes. As in
+ * gst-launch, a backslash takes the next character literally.
+ */
+static gchar *
+gstd_template_unquote (const gchar * str, gsize len)
+{
+  GString *value;
+  gsize i;
+
+  if (len < 2 || '"' != str[0] || '"' != str[len - 1]) {
+    return g_strndup (str, len);
+  }
+
+  value = g_string_sized_new (len);
+  for (i = 1; i < len - 1; i++) {
+    if ('\\' == str[i] && i + 1 < len - 1) {
+      i++;
+    }
+    g_string_append_c (value, str[i]);
+  }
+
+  return g_string_free (value, FALSE);
+}
+
+/* The reverse of gstd_template_unquote() */
+static void
+gstd_template_append_quoted (GString * string, const gchar * value)
+{
+  g_string_append_c (string, '"');
+  for (; *value; value++) {
+    if ('"' == *value || '\\' == *value) {
+      g_string_append_c (string, '\\');
+    }
+    g_string_append_c (string, *value);
+  }
+  g_string_append_c (string, '"');
+}
+
+static gboolean
+gstd_template_has_parameter (GstdTemplate * self, const gchar * name)
+{
+  guint i;
+
+  for (i = 0; i < self->parameters->len; i++) {
+    if (!strcmp (name, g_ptr_array_index (self->parameters, i))) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* Adds the placeholders of @pattern to the parameters */
+static gboolean
+gstd_template_scan_pattern (GstdTemplate * self, const gchar * pattern)
+{
+  const gchar *open;
+  const gchar *close;
+  gchar *name;
+
+  while ((open = strstr (pattern, "${"))) {
+    close = strchr (open, '}');
+    if (!close || !gstd_template_is_word (open + 2, close - open - 2, "")) {
+      return FALSE;
+    }
+
+    name = g_strndup (open + 2, close - open - 2);
+    if (gstd_template_has_parameter (self, name)) {
+      g_free (name);
+    } else {
+      g_ptr_array_add (self->parameters, name);
+    }
+    pattern = close + 1;
+  }
+
+  return TRUE;
+}
+
+/* Replaces the placeholders of @pattern with their @values */
+static gchar *
+gstd_template_expand (const gchar * pattern, GHashTable * values)
+{
+  GString *expanded = g_string_new (NULL);
+  const gchar *open;
+  const gchar *close;
+  gchar *name;
+
+  while ((open = strstr (pattern, "${"))) {
+    close = strchr (open, '}');
+    g_string_append_len (expanded, pattern, open - pattern);
+
+    name = g_strndup (open + 2, close - open - 2);
+    g_string_append (expanded, g_hash_table_lookup (values, name));
+    g_free (name);
+
+    pattern = close + 1;
+  }
+  g_string_append (expanded, pattern);
+
+  return g_string_free (expanded, FALSE);
+}
+
+/*
+ * Hands the placeholder pairs of the element just described over to
+ * the bindings, naming the element if the description doesn't
+ */
+static void
+gstd_template_close_element (GstdTemplate * self, GString * stripped,
+    GPtrArray * pending, gchar ** element, gchar ** factory, guint count)
+{
+  GstdTemplateBinding *binding;
+  guint i;
+
+  if (pending->len && !*element) {
+    *element = g_strdup_printf ("%s_%u", gstd_template_is_word (*factory,
+            strlen (*factory), "") ? *factory : "element", count);
+    g_string_append_printf (stripped, " name=%s", *element);
+  }
+
+  for (i = 0; i < pending->len; i++) {
+    binding = g_ptr_array_index (pending, i);
+    binding->element = g_strdup (*element);
+    g_ptr_array_add (self->bindings, binding);
+  }
+  g_ptr_array_set_size (pending, 0);
+
+  g_clear_pointer (element, g_free);
+  g_clear_pointer (factory, g_free);
+}
+
+/*
+ * Takes the name=${value} pairs out of the description. Anything that
+ * is not a property starts or ends an element: an element, a link, a
+ * bin, a reference to a named element or caps.
+ */
+static GstdReturnCode
+gstd_template_strip (GstdTemplate * self)
+{
+  const gchar *description = self->description;
+  GString *stripped = g_string_new (NULL);
+  GPtrArray *pending = g_ptr_array_new ();
+  GstdTemplateBinding *binding;
+  gchar *element = NULL;
+  gchar *factory = NULL;
+  const gchar *token;
+  const gchar *equal;
+  gchar *value;
+  gsize pos = 0;
+  gsize start;
+  gsize end;
+  gsize len;
+  guint count = 0;
+  GstdReturnCode ret = GSTD_EOK;
+
+  while (gstd_template_next_token (description, TRUE, &pos, &start, &end)) {
+    token = description + start;
+    len = end - start;
+    equal = memchr (token, '=', len);
+
+    if (equal && gstd_template_is_word (token, equal - token, ":")) {
+      value = gstd_template_unquote (equal + 1, len - (equal - token) - 1);
+
+      if (factory && 4 == equal - token && !strncmp (token, "name", 4)) {
+        g_free (element);
+        element = g_strdup (value);
+      }
+
+      if (strstr (value, "${")) {
+        if (!factory || !gstd_template_scan_pattern (self, value)) {
+          GST_ERROR_OBJECT (self, "Misplaced placeholder in \"%.*s\"",
+              (gint) len, token);
+          g_free (value);
+          ret = GSTD_BAD_DESCRIPTION;
+          goto out;
+        }
+
+        binding = g_new0 (GstdTemplateBinding, 1);
+        binding->offset = stripped->len;
+        binding->property = g_strndup (token, equal - token);
+        binding->pattern = value;
+        g_ptr_array_add (pending, binding);
+        continue;
+      }
+      g_free (value);
+    } else {
+      gstd_template_close_element (self, stripped, pending, &element,
+          &factory, count);
+
+      /* URIs may be used as elements, caps and references may not */
+      if (!strchr ("!()", *token) && (g_strstr_len (token, len, "://")
+              || (!memchr (token, '/', len) && !memchr (token, '.', len)))) {
+        factory = g_strndup (token, len);
+        count++;
+      }
+    }
+
+    if (stripped->len) {
+      g_string_append_c (stripped, ' ');
+    }
+    g_string_append_len (stripped, token, len);
+  }
+
+  gstd_template_close_element (self, stripped, pending, &element, &factory,
+      count);
+
+out:
+  g_ptr_array_free (pending, TRUE);
+  g_free (element);
+  g_free (factory);
+  self->stripped = g_string_free (stripped, FALSE);
+
+  return ret;
+}
+
+/*
+ * Records the properties the description sets on @element, those that
+ * differ from a pristine instance
+ */
+static GstdTemplateNode *
+gstd_template_node_new (GstdTemplate * self, GstElement * element,
+    GstElementFactory * factory)
+{
+  GstdTemplateNode *node;
+  GstElement *pristine;
+  GParamSpec **pspecs;
+  GParamSpec *pspec;
+  GValue value = G_VALUE_INIT;
+  GValue initial = G_VALUE_INIT;
+  gboolean same;
+  guint n;
+  guint i;
+
+  pristine = gst_element_factory_create (factory, NULL);
+  if (!pristine) {
+    return NULL;
+  }
+  gst_object_ref_sink (pristine);
+
+  node = g_new0 (GstdTemplateNode, 1);
+  node->factory = gst_object_ref (factory);
+  node->name = gst_element_get_name (element);
+  node->names = g_ptr_array_new ();
+  node->values = g_array_new (FALSE, TRUE, sizeof (GValue));
+  g_array_set_clear_func (node->values, (GDestroyNotify) g_value_unset);
+
+  pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (element), &n);
+  for (i = 0; i < n; i++) {
+    pspec = pspecs[i];
+
+    if ((pspec->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE
+        || !g_strcmp0 (pspec->name, "name")
+        || !g_strcmp0 (pspec->name, "parent")) {
+      continue;
+    }
+
+    g_value_init (&value, pspec->value_type);
+    g_value_init (&initial, pspec->value_type);
+    g_object_get_property (G_OBJECT (element), pspec->name, &value);
+    g_object_get_property (G_OBJECT (pristine), pspec->name, &initial);
+    same = 0 == g_param_values_cmp (pspec, &value, &initial);
+    g_value_unset (&initial);
+
+    if (same) {
+      g_value_unset (&value);
+      continue;
+    }
+
+    /* Only plain values can be replayed */
+    if ((pspec->flags & G_PARAM_CONSTRUCT_ONLY)
+        || G_TYPE_IS_OBJECT (pspec->value_type)) {
+      GST_INFO_OBJECT (self, "Can't replay %s on %s", pspec->name,
+          node->name);
+      g_value_unset (&value);
+      gstd_template_node_free (node);
+      node = NULL;
+      break;
+    }
+
+    g_ptr_array_add (node->names, (gpointer) pspec->name);
+    g_array_append_val (node->values, value);
+    memset (&value, 0, sizeof (value));
+  }
+
+  g_free (pspecs);
+  gst_object_unref (pristine);
+
+  return node;
+}
+
+static gboolean
+gstd_template_has_sometimes_pads (GstElementFactory * factory)
+{
+  const GList *templates;
+  GstStaticPadTemplate *templ;
+
+  for (templates = gst_element_factory_get_static_pad_templates (factory);
+      templates; templates = templates->next) {
+    templ = templates->data;
+    if (GST_PAD_SOMETIMES == templ->presence) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static gint
+gstd_template_find_node (GPtrArray * elements, GstElement * element,
+    const gchar * name)
+{
+  GstElement *candidate;
+  guint i;
+
+  for (i = 0; i < elements->len; i++) {
+    candidate = g_ptr_array_index (elements, i);
+    if (candidate == element || (name
+            && !g_strcmp0 (GST_OBJECT_NAME (candidate), name))) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+static gboolean
+gstd_template_record_links (GstdTemplate * self, GPtrArray * elements)
+{
+  GstdTemplateLink link;
+  GstElement *element;
+  GstElement *peer_element;
+  GstPad *peer;
+  GList *pads;
+  gint sink;
+  guint i;
+  gboolean ret = TRUE;
+
+  for (i = 0; ret && i < elements->len; i++) {
+    element = g_ptr_array_index (elements, i);
+
+    GST_OBJECT_LOCK (element);
+    for (pads = element->srcpads; ret && pads; pads = pads->next) {
+      peer = gst_pad_get_peer (pads->data);
+      if (!peer) {
+        continue;
+      }
+
+      peer_element = gst_pad_get_parent_element (peer);
+      sink = gstd_template_find_node (elements, peer_element, NULL);
+      if (sink < 0) {
+        ret = FALSE;
+      } else {
+        link.src = i;
+        link.srcpad = g_strdup (GST_PAD_NAME (pads->data));
+        link.sink = sink;
+        link.sinkpad = g_strdup (GST_PAD_NAME (peer));
+        g_array_append_val (self->links, link);
+      }
+
+      if (peer_element) {
+        gst_object_unref (peer_element);
+      }
+      gst_object_unref (peer);
+    }
+    GST_OBJECT_UNLOCK (element);
+  }
+
+  return ret;
+}
+
+/*
+ * Turns the parsed description into a recipe. Only flat descriptions
+ * whose links are all made at parse time qualify: bins and elements
+ * with sometimes pads are left to gst_parse_launch().
+ */
+static gboolean
+gstd_template_compile (GstdTemplate * self, GstElement * parsed)
+{
+  GPtrArray *elements = g_ptr_array_new_with_free_func (gst_object_unref);
+  GstdTemplateBinding *binding;
+  GstElementFactory *factory;
+  GstdTemplateNode *node;
+  GstElement *element;
+  GList *children;
+  gint index;
+  guint i;
+  gboolean ret = FALSE;
+
+  factory = gst_element_get_factory (parsed);
+  if (GST_IS_PIPELINE (parsed) && factory
+      && !g_strcmp0 (GST_OBJECT_NAME (factory), "pipeline")) {
+    GST_OBJECT_LOCK (parsed);
+    for (children = GST_BIN_CHILDREN (parsed); children;
+        children = children->next) {
+      g_ptr_array_insert (elements, 0, gst_object_ref (children->data));
+    }
+    GST_OBJECT_UNLOCK (parsed);
+  } else {
+    g_ptr_array_add (elements, gst_object_ref (parsed));
+  }
+
+  self->nodes = g_ptr_array_new_with_free_func (gstd_template_node_free);
+  self->links = g_array_new (FALSE, FALSE, sizeof (GstdTemplateLink));
+  g_array_set_clear_func (self->links, gstd_template_link_clear);
+
+  for (i = 0; i < elements->len; i++) {
+    element = g_ptr_array_index (elements, i);
+    factory = gst_element_get_factory (element);
+
+    if (GST_IS_BIN (element) || !factory
+        || gstd_template_has_sometimes_pads (factory)) {
+      GST_INFO_OBJECT (self, "%s can't be compiled",
+          GST_OBJECT_NAME (element));
+      goto out;
+    }
+
+    node = gstd_template_node_new (self, element, factory);
+    if (!node) {
+      goto out;
+    }
+    g_ptr_array_add (self->nodes, node);
+  }
+
+  for (i = 0; i < self->bindings->len; i++) {
+    binding = g_ptr_array_index (self->bindings, i);
+    index = gstd_template_find_node (elements, NULL, binding->element);
+
+    /* Child properties and construct only ones are left to the parser */
+    if (index < 0 || strstr (binding->property, "::")
+        || (binding->pspec->flags & G_PARAM_CONSTRUCT_ONLY)) {
+      goto out;
+    }
+    binding->node = index;
+  }
+
+  ret = gstd_template_record_links (self, elements);
+
+out:
+  if (!ret) {
+    g_clear_pointer (&self->nodes, g_ptr_array_unref);
+    g_clear_pointer (&self->links, g_array_unref);
+  }
+  g_ptr_array_unref (elements);
+
+  return ret;
+}
+
+/* The object and property @binding sets below @top */
+static gboolean
+gstd_template_lookup (GstdTemplateBinding * binding, GstElement * top,
+    GObject ** target, GParamSpec ** pspec)
+{
+  GstElement *element;
+
+  *target = NULL;
+  *pspec = NULL;
+
+  if (!g_strcmp0 (GST_OBJECT_NAME (top), binding->element)) {
+    element = gst_object_ref (top);
+  } else if (GST_IS_BIN (top)) {
+    element = gst_bin_get_by_name (GST_BIN (top), binding->element);
+  } else {
+    element = NULL;
+  }
+
+  if (!element) {
+    return FALSE;
+  }
+
+  if (GST_IS_CHILD_PROXY (element)) {
+    gst_child_proxy_lookup (GST_CHILD_PROXY (element), binding->property,
+        target, pspec);
+    gst_object_unref (element);
+  } else {
+    *target = G_OBJECT (element);
+    *pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+        binding->property);
+  }
+
+  if (!*pspec) {
+    g_clear_object (target);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Makes sure every placeholder names a writable property */
+static GstdReturnCode
+gstd_template_resolve (GstdTemplate * self, GstElement * parsed)
+{
+  GstdTemplateBinding *binding;
+  GObject *target;
+  GParamSpec *pspec;
+  guint i;
+
+  for (i = 0; i < self->bindings->len; i++) {
+    binding = g_ptr_array_index (self->bindings, i);
+
+    if (!gstd_template_lookup (binding, parsed, &target, &pspec)
+        || !(pspec->flags & G_PARAM_WRITABLE)) {
+      GST_ERROR_OBJECT (self, "No writable %s property in \"%s\"",
+          binding->property, binding->element);
+      g_clear_object (&target);
+      return GSTD_BAD_DESCRIPTION;
+    }
+    g_object_unref (target);
+
+    binding->pspec = g_param_spec_ref (pspec);
+  }
+
+  return GSTD_EOK;
+}
+
+GstdReturnCode
+gstd_template_build (GstdTemplate * self)
+{
+  GstElement *parsed;
+  GError *error = NULL;
+  GstParseFlags flags;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_TEMPLATE (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (self->description, GSTD_NULL_ARGUMENT);
+
+  ret = gstd_template_strip (self);
+  if (ret) {
+    return ret;
+  }
+
+  flags = GST_PARSE_FLAG_FATAL_ERRORS | GST_PARSE_FLAG_NO_SINGLE_ELEMENT_BINS;
+  parsed = gst_parse_launch_full (self->stripped, NULL, flags, &error);
+  if (!parsed) {
+    GST_ERROR_OBJECT (self, "Unable to parse \"%s\": %s", self->stripped,
+        error ? error->message : "unknown error");
+    g_clear_error (&error);
+    return GSTD_BAD_DESCRIPTION;
+  }
+  gst_object_ref_sink (parsed);
+
+  ret = gstd_template_resolve (self, parsed);
+  if (GSTD_EOK == ret) {
+    gstd_template_compile (self, parsed);
+    GST_INFO_OBJECT (self, "Built %s template with %u parameters, %s",
+        GSTD_OBJECT_NAME (self), self->parameters->len,
+        self->nodes ? "compiled" : "parsed on creation");
+  }
+
+  gst_object_unref (parsed);
+
+  return ret;
+}
+
+/* Parses name=value pairs, every placeholder must be given a value */
+static GstdReturnCode
+gstd_template_parse_parameters (GstdTemplate * self, const gchar * parameters,
+    GHashTable * values)
+{
+  const gchar *token;
+  const gchar *equal;
+  gchar *name;
+  gsize pos = 0;
+  gsize start;
+  gsize end;
+  guint i;
+
+  while (parameters && gstd_template_next_token (parameters, FALSE, &pos,
+          &start, &end)) {
+    token = parameters + start;
+    equal = memchr (token, '=', end - start);
+
+    if (!equal || !gstd_template_is_word (token, equal - token, "")) {
+      GST_ERROR_OBJECT (self, "Malformed parameter \"%.*s\"",
+          (gint) (end - start), token);
+      return GSTD_BAD_VALUE;
+    }
+
+    name = g_strndup (token, equal - token);
+    if (!gstd_template_has_parameter (self, name)) {
+      GST_ERROR_OBJECT (self, "Unknown parameter \"%s\"", name);
+      g_free (name);
+      return GSTD_BAD_VALUE;
+    }
+
+    g_hash_table_replace (values, name, gstd_template_unquote (equal + 1,
+            end - start - (equal - token) - 1));
+  }
+
+  for (i = 0; i < self->parameters->len; i++) {
+    name = g_ptr_array_index (self->parameters, i);
+    if (!g_hash_table_contains (values, name)) {
+      GST_ERROR_OBJECT (self, "Missing parameter \"%s\"", name);
+      return GSTD_MISSING_ARGUMENT;
+    }
+  }
+
+  return GSTD_EOK;
+}
+
+static GstdReturnCode
+gstd_template_apply (GstdTemplate * self, GstdTemplateBinding * binding,
+    GstElement * element, GHashTable * values)
+{
+  GValue value = G_VALUE_INIT;
+  gchar *string;
+  GstdReturnCode ret = GSTD_EOK;
+
+  string = gstd_template_expand (binding->pattern, values);
+  g_value_init (&value, binding->pspec->value_type);
+
+  if (!gst_value_deserialize (&value, string)
+      || g_param_value_validate (binding->pspec, &value)) {
+    GST_ERROR_OBJECT (self, "Invalid %s for %s: \"%s\"", binding->property,
+        binding->element, string);
+    ret = GSTD_BAD_VALUE;
+  } else {
+    g_object_set_property (G_OBJECT (element), binding->pspec->name, &value);
+  }
+
+  g_value_unset (&value);
+  g_free (string);
+
+  return ret;
+}
+
+/* Builds an instance from the recipe */
+static GstdReturnCode
+gstd_template_assemble (GstdTemplate * self, GHashTable * values,
+    GstElement ** out)
+{
+  GstdTemplateBinding *binding;
+  GstdTemplateNode *node;
+  GstdTemplateLink *link;
+  GstElement **elements;
+  GstElement *pipeline;
+  guint i;
+  guint j;
+  GstdReturnCode ret = GSTD_EOK;
+
+  pipeline = gst_pipeline_new (NULL);
+  elements = g_new0 (GstElement *, self->nodes->len);
+
+  for (i = 0; i < self->nodes->len; i++) {
+    node = g_ptr_array_index (self->nodes, i);
+
+    elements[i] = gst_element_factory_create (node->factory, node->name);
+    if (!elements[i]) {
+      GST_ERROR_OBJECT (self, "Unable to create %s", node->name);
+      ret = GSTD_BAD_DESCRIPTION;
+      goto out;
+    }
+
+    for (j = 0; j < node->names->len; j++) {
+      g_object_set_property (G_OBJECT (elements[i]),
+          g_ptr_array_index (node->names, j),
+          &g_array_index (node->values, GValue, j));
+    }
+    gst_bin_add (GST_BIN (pipeline), elements[i]);
+  }
+
+  for (i = 0; i < self->bindings->len; i++) {
+    binding = g_ptr_array_index (self->bindings, i);
+    ret = gstd_template_apply (self, binding, elements[binding->node], values);
+    if (ret) {
+      goto out;
+    }
+  }
+
+  /* Caps and hierarchy were checked when the template was built */
+  for (i = 0; i < self->links->len; i++) {
+    link = &g_array_index (self->links, GstdTemplateLink, i);
+    if (!gst_element_link_pads_full (elements[link->src], link->srcpad,
+            elements[link->sink], link->sinkpad, GST_PAD_LINK_CHECK_NOTHING)) {
+      GST_ERROR_OBJECT (self, "Unable to link %s:%s to %s:%s",
+          GST_OBJECT_NAME (elements[link->src]), link->srcpad,
+          GST_OBJECT_NAME (elements[link->sink]), link->sinkpad);
+      ret = GSTD_BAD_DESCRIPTION;
+      goto out;
+    }
+  }
+
+out:
+  g_free (elements);
+  if (ret) {
+    gst_object_unref (pipeline);
+    pipeline = NULL;
+  }
+  *out = pipeline;
+
+  return ret;
+}
+
+/* Builds an instance by parsing the description with the values in */
+static GstdReturnCode
+gstd_template_launch (GstdTemplate * self, GHashTable * values,
+    GstElement ** out)
+{
+  GstdTemplateBinding *binding;
+  GString *launch = g_string_new (NULL);
+  GError *error = NULL;
+  GstParseFlags flags;
+  gchar *expanded;
+  gsize from = 0;
+  guint i;
+
+  for (i = 0; i < self->bindings->len; i++) {
+    binding = g_ptr_array_index (self->bindings, i);
+    expanded = gstd_template_expand (binding->pattern, values);
+
+    g_string_append_len (launch, self->stripped + from,
+        binding->offset - from);
+    g_string_append_printf (launch, " %s=", binding->property);
+    gstd_template_append_quoted (launch, expanded);
+    from = binding->offset;
+
+    g_free (expanded);
+  }
+  g_string_append (launch, self->stripped + from);
+
+  flags = GST_PARSE_FLAG_FATAL_ERRORS | GST_PARSE_FLAG_NO_SINGLE_ELEMENT_BINS;
+  *out = gst_parse_launch_full (launch->str, NULL, flags, &error);
+  if (!*out) {
+    GST_ERROR_OBJECT (self, "Unable to create \"%s\": %s", launch->str,
+        error ? error->message : "unknown error");
+    g_clear_error (&error);
+  }
+  g_string_free (launch, TRUE);
+
+  return *out ? GSTD_EOK : GSTD_BAD_VALUE;
+}
+
+GstdReturnCode
+gstd_template_instantiate (GstdTemplate * self, const gchar * parameters,
+    GstElement ** pipeline)
+{
+  GHashTable *values;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_TEMPLATE (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (self->stripped, GSTD_MISSING_INITIALIZATION);
+  g_return_val_if_fail (pipeline, GSTD_NULL_ARGUMENT);
+
+  *pipeline = NULL;
+
+  values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  ret = gstd_template_parse_parameters (self, parameters, values);
+  if (GSTD_EOK == ret) {
+    ret = self->nodes ? gstd_template_assemble (self, values, pipeline) :
+        gstd_template_launch (self, values, pipeline);
+  }
+
+  g_hash_table_unref (values);
+
+  return ret;
+}
+
+/* A property to set again on an instance */
+typedef struct _GstdTemplateChange
+{
+  GObject *target;
+  GParamSpec *pspec;
+  GValue value;
+} GstdTemplateChange;
+
+static void
+gstd_template_change_clear (gpointer data)
+{
+  GstdTemplateChange *change = data;
+
+  g_clear_object (&change->target);
+  if (G_IS_VALUE (&change->value)) {
+    g_value_unset (&change->value);
+  }
+}
+
+/* Properties without mutability flags are taken to need READY or below */
+static gboolean
+gstd_template_is_mutable (GParamSpec * pspec, GstState state)
+{
+  if (state <= GST_STATE_READY) {
+    return TRUE;
+  }
+
+  return 0 != (pspec->flags & (GST_PARAM_MUTABLE_PAUSED |
+          GST_PARAM_MUTABLE_PLAYING));
+}
+
+static GstdReturnCode
+gstd_template_change_init (GstdTemplate * self, GstdTemplateBinding * binding,
+    GstElement * pipeline, const gchar * string, GstdTemplateChange * change)
+{
+  GstState state = GST_STATE (pipeline);
+
+  if (!gstd_template_lookup (binding, pipeline, &change->target,
+          &change->pspec)) {
+    GST_ERROR_OBJECT (self, "No %s property in \"%s\"", binding->property,
+        binding->element);
+    return GSTD_NO_RESOURCE;
+  }
+
+  if (!gstd_template_is_mutable (change->pspec, state)) {
+    GST_INFO_OBJECT (self, "%s of %s can't be changed in %s",
+        binding->property, binding->element,
+        gst_element_state_get_name (state));
+    return GSTD_STATE_ERROR;
+  }
+
+  g_value_init (&change->value, change->pspec->value_type);
+  if (!gst_value_deserialize (&change->value, string)
+      || g_param_value_validate (change->pspec, &change->value)) {
+    GST_ERROR_OBJECT (self, "Invalid %s for %s: \"%s\"", binding->property,
+        binding->element, string);
+    return GSTD_BAD_VALUE;
+  }
+
+  return GSTD_EOK;
+}
+
+GstdReturnCode
+gstd_template_reconfigure (GstdTemplate * self, GstElement * pipeline,
+    const gchar * from, const gchar * to)
+{
+  GstdTemplateBinding *binding;
+  GstdTemplateChange change;
+  GstdTemplateChange *changed;
+  GHashTable *before;
+  GHashTable *after;
+  GArray *changes;
+  gchar *previous;
+  gchar *next;
+  guint i;
+  GstdReturnCode ret;
+
+  g_return_val_if_fail (GSTD_IS_TEMPLATE (self), GSTD_NULL_ARGUMENT);
+  g_return_val_if_fail (self->stripped, GSTD_MISSING_INITIALIZATION);
+  g_return_val_if_fail (GST_IS_ELEMENT (pipeline), GSTD_NULL_ARGUMENT);
+
+  before = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  after = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  changes = g_array_new (FALSE, TRUE, sizeof (GstdTemplateChange));
+  g_array_set_clear_func (changes, gstd_template_change_clear);
+
+  ret = gstd_template_parse_parameters (self, from, before);
+  if (GSTD_EOK == ret) {
+    ret = gstd_template_parse_parameters (self, to, after);
+  }
+
+  /* Check everything first, so a refused change leaves no trace */
+  for (i = 0; GSTD_EOK == ret && i < self->bindings->len; i++) {
+    binding = g_ptr_array_index (self->bindings, i);
+    previous = gstd_template_expand (binding->pattern, before);
+    next = gstd_template_expand (binding->pattern, after);
+
+    if (strcmp (previous, next)) {
+      memset (&change, 0, sizeof (change));
+      ret = gstd_template_change_init (self, binding, pipeline, next,
+          &change);
+      g_array_append_val (changes, change);
+    }
+
+    g_free (previous);
+    g_free (next);
+  }
+
+  for (i = 0; GSTD_EOK == ret && i < changes->len; i++) {
+    changed = &g_array_index (changes, GstdTemplateChange, i);
+    g_object_set_property (changed->target, changed->pspec->name,
+        &changed->value);
+  }
+
+  g_array_unref (changes);
+  g_hash_table_unref (after);
+  g_hash_table_unref (before);
+
+  return ret;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_TEMPLATE_H__
+#define __GSTD_TEMPLATE_H__
+
+#include <gst/gst.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+/*
+ * Type declaration.
+ */
+#define GSTD_TYPE_TEMPLATE \
+  (gstd_template_get_type())
+#define GSTD_TEMPLATE(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GSTD_TYPE_TEMPLATE,GstdTemplate))
+#define GSTD_TEMPLATE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GSTD_TYPE_TEMPLATE,GstdTemplateClass))
+#define GSTD_IS_TEMPLATE(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GSTD_TYPE_TEMPLATE))
+#define GSTD_IS_TEMPLATE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GSTD_TYPE_TEMPLATE))
+#define GSTD_TEMPLATE_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GSTD_TYPE_TEMPLATE, GstdTemplateClass))
+typedef struct _GstdTemplate GstdTemplate;
+typedef struct _GstdTemplateClass GstdTemplateClass;
+GType gstd_template_get_type (void);
+
+/**
+ * gstd_template_build:
+ * @self: A #GstdTemplate with its "description" set
+ *
+ * Validates the description once. Placeholders are written as
+ * ${name} in property values, as in "udpsink host=${host} port=${port}".
+ * The description is parsed with the placeholders left out and, when
+ * it is a flat chain of elements with static links, it is compiled
+ * into a recipe of factories, properties and links, so instances are
+ * built without going through gst_parse_launch().
+ *
+ * Returns: GSTD_EOK, or GSTD_BAD_DESCRIPTION if the description doesn't
+ * parse or a placeholder doesn't name a writable property.
+ */
+GstdReturnCode gstd_template_build (GstdTemplate * self);
+
+/**
+ * gstd_template_instantiate:
+ * @self: A built #GstdTemplate
+ * @parameters: (nullable): The placeholder values, as space separated
+ * name=value pairs. Values with spaces are double quoted
+ * @pipeline: (out) (transfer full): The new pipeline
+ *
+ * Builds a new pipeline from the template. Safe to call from several
+ * threads at once.
+ *
+ * Returns: GSTD_EOK, GSTD_MISSING_ARGUMENT if a placeholder has no
+ * value, GSTD_BAD_VALUE if a parameter is unknown or a value doesn't
+ * fit its property.
+ */
+GstdReturnCode gstd_template_instantiate (GstdTemplate * self,
+    const gchar * parameters, GstElement ** pipeline);
+
+/**
+ * gstd_template_reconfigure:
+ * @self: A built #GstdTemplate
+ * @pipeline: A pipeline instantiated with @from
+ * @from: (nullable): The parameters @pipeline was built with
+ * @to: (nullable): The parameters it should have instead
+ *
+ * Sets again the properties whose value differs between @from and @to.
+ * Nothing is set unless all of them can be changed in the current
+ * state of @pipeline: in READY or below any property can, in PAUSED
+ * only those flagged GST_PARAM_MUTABLE_PAUSED or _PLAYING.
+ *
+ * Returns: GSTD_EOK, GSTD_STATE_ERROR if a property can't be changed
+ * in the current state, or the errors of gstd_template_instantiate().
+ */
+GstdReturnCode gstd_template_reconfigure (GstdTemplate * self,
+    GstElement * pipeline, const gchar * from, const gchar * to);
+
+G_END_DECLS
+#endif // __GSTD_TEMPLATE_H__
@@ -0,0 +1,105 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_template.h"
+#include "gstd_template_creator.h"
+
+/* Gstd Core debugging category */
+GST_DEBUG_CATEGORY_STATIC (gstd_template_creator_debug);
+#define GST_CAT_DEFAULT gstd_template_creator_debug
+
+#define GSTD_DEBUG_DEFAULT_LEVEL GST_LEVEL_INFO
+
+static GstdReturnCode gstd_template_creator_create (GstdICreator * iface,
+    const gchar * name, const gchar * description, GstdObject ** out);
+
+typedef struct _GstdTemplateCreatorClass GstdTemplateCreatorClass;
+
+/**
+ * GstdTemplateCreator:
+ * Registers pipeline templates
+ */
+struct _GstdTemplateCreator
+{
+  GObject parent;
+};
+
+struct _GstdTemplateCreatorClass
+{
+  GObjectClass parent_class;
+};
+
+
+static void
+gstd_icreator_interface_init (GstdICreatorInterface * iface)
+{
+  iface->create = gstd_template_creator_create;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GstdTemplateCreator, gstd_template_creator,
+    G_TYPE_OBJECT, G_IMPLEMENT_INTERFACE (GSTD_TYPE_ICREATOR,
+        gstd_icreator_interface_init));
+
+static void
+gstd_template_creator_class_init (GstdTemplateCreatorClass * klass)
+{
+  guint debug_color;
+
+  /* Initialize debug category with nice colors */
+  debug_color = GST_DEBUG_FG_BLACK | GST_DEBUG_BOLD | GST_DEBUG_BG_WHITE;
+  GST_DEBUG_CATEGORY_INIT (gstd_template_creator_debug, "gstdtemplatecreator",
+      debug_color, "Gstd Template Creator category");
+}
+
+static void
+gstd_template_creator_init (GstdTemplateCreator * self)
+{
+  GST_INFO_OBJECT (self, "Initializing template creator");
+}
+
+static GstdReturnCode
+gstd_template_creator_create (GstdICreator * iface, const gchar * name,
+    const gchar * description, GstdObject ** out)
+{
+  GstdTemplate *template;
+  *out = NULL;
+
+  g_return_val_if_fail (iface, GSTD_NULL_ARGUMENT);
+
+  if (NULL == name) {
+    GST_ERROR_OBJECT (iface, "Template name not provided");
+    return GSTD_MISSING_NAME;
+  }
+
+  if (NULL == description) {
+    GST_ERROR_OBJECT (iface, "Template description not provided");
+    return GSTD_MISSING_ARGUMENT;
+  }
+
+  template = g_object_new (GSTD_TYPE_TEMPLATE, "name", name, "description",
+      description, NULL);
+  *out = GSTD_OBJECT (template);
+
+  return gstd_template_build (template);
+}
@@ -54,6 +54,8 @@ G_DEFINE_TYPE (GstdUnix, gstd_unix, GSTD_TYPE_SOCKET);
 static void gstd_unix_dispose (GObject *);
 static GstdReturnCode gstd_unix_create_socket_service (GstdSocket * base,
     GSocketService ** service);
+static GstdReturnCode gstd_unix_get_addresses (GstdSocket * base,
+    GList ** addresses);
 static gboolean gstd_unix_init_get_option_group (GstdIpc * base,
     GOptionGroup ** group);
 
@@ -69,6 +71,8 @@ gstd_unix_class_init (GstdUnixClass * klass)
       GST_DEBUG_FUNCPTR (gstd_unix_init_get_option_group);
   socket_class->create_socket_service =
       GST_DEBUG_FUNCPTR (gstd_unix_create_socket_service);
+  socket_class->get_addresses = GST_DEBUG_FUNCPTR (gstd_unix_get_addresses);
+  socket_class->ipc = GSTD_METRICS_IPC_UNIX;
   object_class->dispose = gstd_unix_dispose;
 
   /* Initialize debug category with nice colors */
@@ -169,6 +173,23 @@ noconnection:
   }
 }
 
+static GstdReturnCode
+gstd_unix_get_addresses (GstdSocket * base, GList ** addresses)
+{
+  GstdUnix *self = GSTD_UNIX (base);
+  gchar *path_name;
+  guint i;
+
+  for (i = 0; i < self->num_ports; i++) {
+    path_name = g_strdup_printf ("%s_%d", self->unix_path, i);
+    *addresses = g_list_append (*addresses,
+        g_unix_socket_address_new (path_name));
+    g_free (path_name);
+  }
+
+  return GSTD_EOK;
+}
+
 gboolean
 gstd_unix_init_get_option_group (GstdIpc * base, GOptionGroup ** group)
 {
@@ -186,6 +207,12 @@ gstd_unix_init_get_option_group (GstdIpc * base, GOptionGroup ** group)
           "Number of ports to use starting at base-port (default 1)",
         "unix-num-ports"}
     ,
+    {"unix-io-threads", 0, 0, G_OPTION_ARG_INT,
+          &GSTD_SOCKET (self)->io_threads,
+          "Serve every connection from this many event loop threads instead "
+          "of one thread per connection (default 0)",
+        "unix-io-threads"}
+    ,
     {NULL}
   };
   GST_DEBUG_OBJECT (self, "UNIX init group callback ");
@@ -0,0 +1,243 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd_uri_cache.h"
+
+typedef struct _GstdUriCacheEntry GstdUriCacheEntry;
+
+struct _GstdUriCacheEntry
+{
+  gchar *uri;
+  GstdObject *node;
+
+  /* Embedded so moving an entry in the LRU order doesn't allocate */
+  GList link;
+};
+
+struct _GstdUriCache
+{
+  GMutex lock;
+
+  guint capacity;
+
+  /* URI to GstdUriCacheEntry */
+  GHashTable *entries;
+
+  /* Most recently used entries at the head */
+  GQueue lru;
+
+  /* Bumped on every clear, see gstd_uri_cache_insert() */
+  guint generation;
+
+  /* The last gstd_uri_cache_epoch this cache was synced to */
+  gint epoch;
+};
+
+/* Bumped by gstd_uri_cache_invalidate_all() */
+static gint gstd_uri_cache_epoch = 0;
+
+static void gstd_uri_cache_entry_free (gpointer data);
+static GHashTable *gstd_uri_cache_reset (GstdUriCache * cache);
+static GHashTable *gstd_uri_cache_sync (GstdUriCache * cache);
+
+static void
+gstd_uri_cache_entry_free (gpointer data)
+{
+  GstdUriCacheEntry *entry = data;
+
+  g_free (entry->uri);
+  g_object_unref (entry->node);
+  g_slice_free (GstdUriCacheEntry, entry);
+}
+
+/*
+ * Empties the cache, returning the old table for the caller to release
+ * once the lock is dropped. Must be called with the lock held.
+ */
+static GHashTable *
+gstd_uri_cache_reset (GstdUriCache * cache)
+{
+  GHashTable *stale = cache->entries;
+
+  cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+      gstd_uri_cache_entry_free);
+  g_queue_init (&cache->lru);
+  cache->generation++;
+  cache->epoch = g_atomic_int_get (&gstd_uri_cache_epoch);
+
+  return stale;
+}
+
+/*
+ * Catches up with gstd_uri_cache_invalidate_all(), see
+ * gstd_uri_cache_reset(). Returns NULL if there was nothing to drop.
+ * Must be called with the lock held.
+ */
+static GHashTable *
+gstd_uri_cache_sync (GstdUriCache * cache)
+{
+  if (cache->epoch == g_atomic_int_get (&gstd_uri_cache_epoch)) {
+    return NULL;
+  }
+
+  return gstd_uri_cache_reset (cache);
+}
+
+GstdUriCache *
+gstd_uri_cache_new (guint capacity)
+{
+  GstdUriCache *cache;
+
+  g_return_val_if_fail (capacity > 0, NULL);
+
+  cache = g_slice_new0 (GstdUriCache);
+  g_mutex_init (&cache->lock);
+  cache->capacity = capacity;
+  /* The entry owns the key, so the table only frees the entry */
+  cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+      gstd_uri_cache_entry_free);
+  g_queue_init (&cache->lru);
+  cache->epoch = g_atomic_int_get (&gstd_uri_cache_epoch);
+
+  return cache;
+}
+
+void
+gstd_uri_cache_free (GstdUriCache * cache)
+{
+  g_return_if_fail (cache);
+
+  gstd_uri_cache_clear (cache);
+  g_hash_table_unref (cache->entries);
+  g_mutex_clear (&cache->lock);
+  g_slice_free (GstdUriCache, cache);
+}
+
+GstdObject *
+gstd_uri_cache_lookup (GstdUriCache * cache, const gchar * uri)
+{
+  GstdUriCacheEntry *entry;
+  GstdObject *node = NULL;
+  GHashTable *stale;
+
+  g_return_val_if_fail (cache, NULL);
+  g_return_val_if_fail (uri, NULL);
+
+  g_mutex_lock (&cache->lock);
+  stale = gstd_uri_cache_sync (cache);
+  entry = g_hash_table_lookup (cache->entries, uri);
+  if (entry) {
+    g_queue_unlink (&cache->lru, &entry->link);
+    g_queue_push_head_link (&cache->lru, &entry->link);
+    node = g_object_ref (entry->node);
+  }
+  g_mutex_unlock (&cache->lock);
+
+  if (stale) {
+    g_hash_table_unref (stale);
+  }
+
+  return node;
+}
+
+guint
+gstd_uri_cache_get_generation (GstdUriCache * cache)
+{
+  guint generation;
+  GHashTable *stale;
+
+  g_return_val_if_fail (cache, 0);
+
+  g_mutex_lock (&cache->lock);
+  stale = gstd_uri_cache_sync (cache);
+  generation = cache->generation;
+  g_mutex_unlock (&cache->lock);
+
+  if (stale) {
+    g_hash_table_unref (stale);
+  }
+
+  return generation;
+}
+
+void
+gstd_uri_cache_insert (GstdUriCache * cache, const gchar * uri,
+    GstdObject * node, guint generation)
+{
+  GstdUriCacheEntry *entry;
+  GstdUriCacheEntry *oldest;
+
+  g_return_if_fail (cache);
+  g_return_if_fail (uri);
+  g_return_if_fail (GSTD_IS_OBJECT (node));
+
+  g_mutex_lock (&cache->lock);
+
+  /* The tree changed while the node was being resolved, it may already
+   * be gone. Another thread may also have resolved the same URI. */
+  if (generation != cache->generation
+      || cache->epoch != g_atomic_int_get (&gstd_uri_cache_epoch)
+      || g_hash_table_contains (cache->entries, uri)) {
+    g_mutex_unlock (&cache->lock);
+    return;
+  }
+
+  if (cache->lru.length >= cache->capacity) {
+    oldest = cache->lru.tail->data;
+    g_queue_unlink (&cache->lru, &oldest->link);
+    g_hash_table_remove (cache->entries, oldest->uri);
+  }
+
+  entry = g_slice_new0 (GstdUriCacheEntry);
+  entry->uri = g_strdup (uri);
+  entry->node = g_object_ref (node);
+  entry->link.data = entry;
+
+  g_hash_table_insert (cache->entries, entry->uri, entry);
+  g_queue_push_head_link (&cache->lru, &entry->link);
+
+  g_mutex_unlock (&cache->lock);
+}
+
+void
+gstd_uri_cache_clear (GstdUriCache * cache)
+{
+  GHashTable *stale;
+
+  g_return_if_fail (cache);
+
+  /* Swap the table out so the nodes are released without holding the
+   * lock, their dispose may end up tearing down a pipeline */
+  g_mutex_lock (&cache->lock);
+  stale = gstd_uri_cache_reset (cache);
+  g_mutex_unlock (&cache->lock);
+
+  g_hash_table_unref (stale);
+}
+
+void
+gstd_uri_cache_invalidate_all (void)
+{
+  g_atomic_int_inc (&gstd_uri_cache_epoch);
+}
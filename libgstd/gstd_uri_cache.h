@@ -0,0 +1,76 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GSTD_URI_CACHE_H__
+#define __GSTD_URI_CACHE_H__
+
+#include <glib.h>
+
+#include "gstd_object.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GstdUriCache:
+ * A bounded LRU map from a full resource URI to the #GstdObject it
+ * resolves to. Lookups and hits do not allocate.
+ */
+typedef struct _GstdUriCache GstdUriCache;
+
+#define GSTD_URI_CACHE_DEFAULT_CAPACITY 256
+
+GstdUriCache *gstd_uri_cache_new (guint capacity);
+void gstd_uri_cache_free (GstdUriCache * cache);
+
+/**
+ * gstd_uri_cache_lookup:
+ * @cache: The cache to look into
+ * @uri: The full URI as received from the client
+ *
+ * Returns: (transfer full) (nullable): The cached node, ref'd, or
+ * NULL if @uri is not cached.
+ */
+GstdObject *gstd_uri_cache_lookup (GstdUriCache * cache, const gchar * uri);
+
+/**
+ * gstd_uri_cache_get_generation:
+ * @cache: The cache to query
+ *
+ * Returns: The current cache generation. Take it before resolving a
+ * URI and hand it to gstd_uri_cache_insert(), so a node resolved
+ * across a gstd_uri_cache_clear() is not cached.
+ */
+guint gstd_uri_cache_get_generation (GstdUriCache * cache);
+
+void gstd_uri_cache_insert (GstdUriCache * cache, const gchar * uri,
+    GstdObject * node, guint generation);
+void gstd_uri_cache_clear (GstdUriCache * cache);
+
+/**
+ * gstd_uri_cache_invalidate_all:
+ *
+ * Makes every cache drop its entries before the next lookup. For
+ * changes deep in the tree, like an element leaving a bin, whose
+ * owner doesn't know the session caching it.
+ */
+void gstd_uri_cache_invalidate_all (void);
+
+G_END_DECLS
+#endif // __GSTD_URI_CACHE_H__
@@ -0,0 +1,223 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the GstdCborWriter formatter:
+ * - Values are encoded as expected by RFC 8949
+ * - Incomplete and malformed items are detected
+ * - Outputs carry the length of their item
+ * - Requests are decoded into commands
+ * - The formatter can be overridden for the calling thread
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <string.h>
+
+#include "gstd_cbor_writer.h"
+#include "gstd_parser.h"
+#include "gstd_session.h"
+
+/*
+ * Test: Maps, arrays and values use the expected encoding
+ */
+GST_START_TEST (test_cbor_writer_encoding)
+{
+  static const guint8 expected[] = {
+    0xbf,
+    0x64, 'n', 'a', 'm', 'e', 0x61, 'a',
+    0x61, 'n', 0xf6,
+    0x61, 'v', 0x9f, 0xf5, 0x20, 0x19, 0x01, 0x2c,
+    0xfb, 0x3f, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xff
+  };
+  GstdIFormatter *formatter = g_object_new (GSTD_TYPE_CBOR_WRITER, NULL);
+  GValue value = G_VALUE_INIT;
+  const guint8 *item = NULL;
+  gchar *out = NULL;
+
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, "a");
+  gstd_iformatter_set_member_name (formatter, "n");
+  gstd_iformatter_set_null_value (formatter);
+  gstd_iformatter_set_member_name (formatter, "v");
+  gstd_iformatter_begin_array (formatter);
+
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&value, TRUE);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_INT);
+  g_value_set_int (&value, -1);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_UINT);
+  g_value_set_uint (&value, 300);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_DOUBLE);
+  g_value_set_double (&value, 0.25);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  gstd_iformatter_end_array (formatter);
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_generate (formatter, &out);
+
+  fail_unless (gstd_cbor_has_magic (out));
+  fail_unless_equals_int (gstd_cbor_output_get_item (out, &item),
+      sizeof (expected));
+  fail_if (memcmp (item, expected, sizeof (expected)));
+
+  g_free (out);
+  g_object_unref (formatter);
+}
+GST_END_TEST;
+
+/*
+ * Test: Truncated or malformed items have no size
+ */
+GST_START_TEST (test_cbor_item_size)
+{
+  static const guint8 text[] = { 0x63, 'a', 'b', 'c' };
+  static const guint8 unclosed[] = { 0x9f, 0x01, 0x02 };
+  static const guint8 reserved[] = { 0x1c };
+  static const guint8 long_text[] = { 0x7a, 0xff, 0xff, 0xff, 0xff, 'a' };
+
+  fail_unless_equals_int (gstd_cbor_item_size (text, sizeof (text)), 4);
+  fail_unless_equals_int (gstd_cbor_item_size (text, sizeof (text) - 1), 0);
+  fail_unless_equals_int (gstd_cbor_item_size (unclosed, sizeof (unclosed)),
+      0);
+  fail_unless_equals_int (gstd_cbor_item_size (reserved, sizeof (reserved)),
+      0);
+  fail_unless_equals_int (gstd_cbor_item_size (long_text,
+          sizeof (long_text)), 0);
+}
+GST_END_TEST;
+
+/*
+ * Test: Only outputs carrying a whole item within their length are
+ * taken as CBOR
+ */
+GST_START_TEST (test_cbor_output_get_item)
+{
+  static const gchar truncated[] = {
+    '\xd9', '\xd9', '\xf7', '\xd8', '\x18', '\x5b',
+    0, 0, 0, 0, 0, 0, 0, 2, '\x63', 'a', 'b', 'c', 0
+  };
+  static const gchar exact[] = {
+    '\xd9', '\xd9', '\xf7', '\xd8', '\x18', '\x5b',
+    0, 0, 0, 0, 0, 0, 0, 4, '\x63', 'a', 'b', 'c', 0
+  };
+  const guint8 *item = NULL;
+
+  fail_unless_equals_int (gstd_cbor_output_get_item ("plain", &item), 0);
+  fail_unless_equals_int (gstd_cbor_output_get_item ("\xd9\xd9\xf7",
+          &item), 0);
+  fail_unless_equals_int (gstd_cbor_output_get_item (truncated, &item), 0);
+  fail_unless_equals_int (gstd_cbor_output_get_item (exact, &item), 4);
+  fail_unless (item == (const guint8 *) exact + 14);
+}
+GST_END_TEST;
+
+/*
+ * Test: Requests may be a text string or an array of words
+ */
+GST_START_TEST (test_cbor_to_command)
+{
+  static const guint8 text[] = { 0x6e, 'l', 'i', 's', 't', '_', 'p', 'i',
+    'p', 'e', 'l', 'i', 'n', 'e', 's'
+  };
+  static const guint8 words[] = { 0x84, 0x6b, 'e', 'l', 'e', 'm', 'e', 'n',
+    't', '_', 's', 'e', 't', 0x20, 0x18, 0x2a, 0xf5
+  };
+  static const guint8 map[] = { 0xa0 };
+  gchar *command;
+
+  command = gstd_cbor_to_command (text, sizeof (text));
+  fail_unless_equals_string (command, "list_pipelines");
+  g_free (command);
+
+  command = gstd_cbor_to_command (words, sizeof (words));
+  fail_unless_equals_string (command, "element_set -1 42 true");
+  g_free (command);
+
+  fail_unless (NULL == gstd_cbor_to_command (map, sizeof (map)));
+  fail_unless (NULL == gstd_cbor_to_command (words, sizeof (words) - 1));
+}
+GST_END_TEST;
+
+/*
+ * Test: Objects are serialized as CBOR only in the thread that asked
+ * for it
+ */
+GST_START_TEST (test_cbor_thread_formatter)
+{
+  GstdSession *session = gstd_session_new ("Cbor Writer Test Session");
+  const guint8 *item = NULL;
+  gchar *out = NULL;
+
+  fail_if (gstd_parser_parse_cmd (session,
+          "pipeline_create p0 fakesrc ! fakesink", &out));
+  g_free (out);
+  out = NULL;
+
+  gstd_object_set_thread_formatter (GSTD_TYPE_CBOR_WRITER);
+  fail_if (gstd_parser_parse_cmd (session, "list_elements p0", &out));
+  gstd_object_set_thread_formatter (0);
+
+  fail_unless (gstd_cbor_has_magic (out));
+  fail_if (0 == gstd_cbor_output_get_item (out, &item));
+  g_free (out);
+  out = NULL;
+
+  fail_if (gstd_parser_parse_cmd (session, "list_elements p0", &out));
+  fail_unless ('{' == out[0]);
+  g_free (out);
+
+  g_object_unref (session);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_cbor_writer_suite (void)
+{
+  Suite *suite = suite_create ("gstd_cbor_writer");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+
+  tcase_add_test (tc, test_cbor_writer_encoding);
+  tcase_add_test (tc, test_cbor_item_size);
+  tcase_add_test (tc, test_cbor_output_get_item);
+  tcase_add_test (tc, test_cbor_to_command);
+  tcase_add_test (tc, test_cbor_thread_formatter);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_cbor_writer);
@@ -0,0 +1,301 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the GstdJsonWriter streaming formatter:
+ * - Output matches the JsonBuilder formatter byte for byte
+ * - Strings are escaped
+ * - The writer can be reused after generating
+ * - Levels nested too deep are written as null
+ * - Objects recycle a formatter per thread
+ * - The formatter can be selected per session
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_json_builder.h"
+#include "gstd_json_writer.h"
+#include "gstd_parser.h"
+#include "gstd_session.h"
+
+/* Writes a document using every formatter operation */
+static gchar *
+format_document (GType type)
+{
+  GstdIFormatter *formatter = g_object_new (type, NULL);
+  GValue value = G_VALUE_INIT;
+  gchar *out = NULL;
+
+  gstd_iformatter_begin_object (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "name");
+  gstd_iformatter_set_string_value (formatter, "tricky \"quoted\"\\\n\ttext");
+
+  gstd_iformatter_set_member_name (formatter, "nothing");
+  gstd_iformatter_set_null_value (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "empty");
+  gstd_iformatter_begin_array (formatter);
+  gstd_iformatter_end_array (formatter);
+
+  gstd_iformatter_set_member_name (formatter, "values");
+  gstd_iformatter_begin_array (formatter);
+
+  g_value_init (&value, G_TYPE_BOOLEAN);
+  g_value_set_boolean (&value, TRUE);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_INT);
+  g_value_set_int (&value, G_MININT);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_UINT);
+  g_value_set_uint (&value, G_MAXUINT);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_INT64);
+  g_value_set_int64 (&value, G_MININT64);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_DOUBLE);
+  g_value_set_double (&value, 0.25);
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  g_value_init (&value, G_TYPE_STRING);
+  g_value_set_string (&value, "string");
+  gstd_iformatter_set_value (formatter, &value);
+  g_value_unset (&value);
+
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_member_name (formatter, "nested");
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_end_array (formatter);
+  gstd_iformatter_end_object (formatter);
+
+  gstd_iformatter_generate (formatter, &out);
+  g_object_unref (formatter);
+
+  return out;
+}
+
+/*
+ * Test: The writer produces the same document as the JsonBuilder
+ */
+GST_START_TEST (test_json_writer_matches_builder)
+{
+  gchar *expected = format_document (GSTD_TYPE_JSON_BUILDER);
+  gchar *actual = format_document (GSTD_TYPE_JSON_WRITER);
+
+  fail_unless_equals_string (actual, expected);
+
+  g_free (expected);
+  g_free (actual);
+}
+GST_END_TEST;
+
+/*
+ * Test: Control characters are escaped as unicode sequences
+ */
+GST_START_TEST (test_json_writer_escape)
+{
+  GstdIFormatter *formatter = g_object_new (GSTD_TYPE_JSON_WRITER, NULL);
+  gchar *out = NULL;
+
+  gstd_iformatter_set_string_value (formatter, "a\001b\"c");
+  gstd_iformatter_generate (formatter, &out);
+
+  fail_unless_equals_string (out, "\"a\\u0001b\\\"c\"");
+
+  g_free (out);
+  g_object_unref (formatter);
+}
+GST_END_TEST;
+
+/*
+ * Test: A writer starts over after generating
+ */
+GST_START_TEST (test_json_writer_reuse)
+{
+  GstdIFormatter *formatter = g_object_new (GSTD_TYPE_JSON_WRITER, NULL);
+  gchar *first = NULL;
+  gchar *second = NULL;
+
+  gstd_iformatter_begin_array (formatter);
+  gstd_iformatter_set_string_value (formatter, "first");
+  gstd_iformatter_end_array (formatter);
+  gstd_iformatter_generate (formatter, &first);
+
+  gstd_iformatter_begin_array (formatter);
+  gstd_iformatter_set_null_value (formatter);
+  gstd_iformatter_end_array (formatter);
+  gstd_iformatter_generate (formatter, &second);
+
+  fail_unless_equals_string (first, "[\n    \"first\"\n]");
+  fail_unless_equals_string (second, "[\n    null\n]");
+
+  g_free (first);
+  g_free (second);
+  g_object_unref (formatter);
+}
+GST_END_TEST;
+
+static guint
+count_char (const gchar * str, gchar c)
+{
+  guint count = 0;
+
+  for (; *str; str++) {
+    count += *str == c;
+  }
+
+  return count;
+}
+
+/*
+ * Test: Levels past the depth limit collapse into a single null and
+ * the levels around them are still closed correctly
+ */
+GST_START_TEST (test_json_writer_too_deep)
+{
+  GstdIFormatter *formatter = g_object_new (GSTD_TYPE_JSON_WRITER, NULL);
+  gchar *out = NULL;
+  guint i;
+
+  gstd_iformatter_begin_object (formatter);
+  gstd_iformatter_set_member_name (formatter, "deep");
+  for (i = 0; i < 100; i++) {
+    gstd_iformatter_begin_array (formatter);
+  }
+  gstd_iformatter_set_string_value (formatter, "lost");
+  for (i = 0; i < 100; i++) {
+    gstd_iformatter_end_array (formatter);
+  }
+  gstd_iformatter_set_member_name (formatter, "after");
+  gstd_iformatter_set_string_value (formatter, "kept");
+  gstd_iformatter_end_object (formatter);
+  gstd_iformatter_generate (formatter, &out);
+
+  fail_unless_equals_int (count_char (out, '['), count_char (out, ']'));
+  fail_unless_equals_int (count_char (out, '{'), 1);
+  fail_unless_equals_int (count_char (out, '}'), 1);
+  fail_if (NULL == strstr (out, "null"));
+  fail_unless (NULL == strstr (out, "lost"));
+  fail_if (NULL == strstr (out, "\"after\" : \"kept\"\n}"));
+
+  g_free (out);
+  g_object_unref (formatter);
+}
+GST_END_TEST;
+
+/*
+ * Test: A released formatter is handed out again, reset, while one
+ * still in use is not
+ */
+GST_START_TEST (test_json_writer_recycled)
+{
+  GstdObject *object = g_object_new (GSTD_TYPE_OBJECT, "name", "obj", NULL);
+  GstdIFormatter *first;
+  GstdIFormatter *nested;
+  GstdIFormatter *again;
+  gchar *out = NULL;
+
+  first = gstd_object_new_formatter (object);
+  gstd_iformatter_begin_array (first);
+
+  nested = gstd_object_new_formatter (object);
+  fail_if (nested == first);
+  g_object_unref (nested);
+
+  g_object_unref (first);
+
+  again = gstd_object_new_formatter (object);
+  fail_unless (again == first);
+  gstd_iformatter_set_null_value (again);
+  gstd_iformatter_generate (again, &out);
+  fail_unless_equals_string (out, "null");
+
+  g_free (out);
+  g_object_unref (again);
+  g_object_unref (object);
+}
+GST_END_TEST;
+
+/*
+ * Test: Sessions serialize with the formatter they were given
+ */
+GST_START_TEST (test_json_writer_session)
+{
+  GstdSession *session = gstd_session_new ("Json Writer Test Session");
+  GType type = G_TYPE_INVALID;
+  gchar *builder = NULL;
+  gchar *writer = NULL;
+
+  g_object_get (session, "formatter", &type, NULL);
+  fail_unless (GSTD_TYPE_JSON_WRITER == type);
+
+  fail_if (gstd_parser_parse_cmd (session,
+          "pipeline_create p0 fakesrc ! fakesink", &writer));
+  g_free (writer);
+  writer = NULL;
+
+  fail_if (gstd_parser_parse_cmd (session, "list_elements p0", &writer));
+
+  g_object_set (session, "formatter", GSTD_TYPE_JSON_BUILDER, NULL);
+  fail_if (gstd_parser_parse_cmd (session, "list_elements p0", &builder));
+
+  fail_unless_equals_string (writer, builder);
+
+  g_free (builder);
+  g_free (writer);
+  g_object_unref (session);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_json_writer_suite (void)
+{
+  Suite *suite = suite_create ("gstd_json_writer");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+
+  tcase_add_test (tc, test_json_writer_matches_builder);
+  tcase_add_test (tc, test_json_writer_escape);
+  tcase_add_test (tc, test_json_writer_reuse);
+  tcase_add_test (tc, test_json_writer_too_deep);
+  tcase_add_test (tc, test_json_writer_recycled);
+  tcase_add_test (tc, test_json_writer_session);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_json_writer);
@@ -0,0 +1,413 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the GstdList container:
+ * - Append, lookup and duplicate detection
+ * - Listing order is preserved across deletions
+ * - Lookup finds every node of a 10k node list
+ * - Serialization lists every node
+ * - Lazy lists create a node on its first lookup only
+ *
+ * Set GSTD_CHECK_BENCH to also time lookups and serialization as the
+ * lists grow, the results are printed and never fail the run.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_list.h"
+#include "gstd_no_deleter.h"
+
+/* Nodes in the large list tests */
+#define LARGE_LIST_NODES 10000
+
+/* Number of lookups timed per list size */
+#define BENCH_LOOKUPS 200000
+
+/* Serializations timed per list size */
+#define BENCH_SERIALIZATIONS 20
+
+static GstdList *
+test_list_new (void)
+{
+  GstdList *list;
+
+  list = GSTD_LIST (g_object_new (GSTD_TYPE_LIST, "name", "test_list",
+          "node-type", GSTD_TYPE_OBJECT, "flags",
+          GSTD_PARAM_CREATE | GSTD_PARAM_READ | GSTD_PARAM_DELETE, NULL));
+
+  gstd_object_set_deleter (GSTD_OBJECT (list),
+      g_object_new (GSTD_TYPE_NO_DELETER, NULL));
+
+  return list;
+}
+
+static GstdObject *
+test_node_new (const gchar * name)
+{
+  return GSTD_OBJECT (g_object_new (GSTD_TYPE_OBJECT, "name", name, NULL));
+}
+
+/*
+ * Test: Appended nodes can be found and duplicates are rejected
+ */
+GST_START_TEST (test_list_append_find)
+{
+  GstdList *list = test_list_new ();
+  GstdObject *node;
+  GstdObject *dup;
+
+  fail_unless (gstd_list_append_child (list, test_node_new ("n0")));
+  fail_unless (gstd_list_append_child (list, test_node_new ("n1")));
+  fail_unless_equals_int (list->count, 2);
+
+  dup = test_node_new ("n0");
+  fail_if (gstd_list_append_child (list, dup));
+  g_object_unref (dup);
+  fail_unless_equals_int (list->count, 2);
+
+  node = gstd_list_find_child (list, "n1");
+  fail_if (NULL == node);
+  fail_unless_equals_string (GSTD_OBJECT_NAME (node), "n1");
+  g_object_unref (node);
+
+  fail_unless (NULL == gstd_list_find_child (list, "missing"));
+
+  g_object_unref (list);
+}
+GST_END_TEST;
+
+/*
+ * Test: Deleting a node keeps the remaining nodes in insertion order
+ */
+GST_START_TEST (test_list_order_after_delete)
+{
+  GstdList *list = test_list_new ();
+  const gchar *expected[] = { "a", "c", "d" };
+  GList *iter;
+  guint i;
+
+  gstd_list_append_child (list, test_node_new ("a"));
+  gstd_list_append_child (list, test_node_new ("b"));
+  gstd_list_append_child (list, test_node_new ("c"));
+  gstd_list_append_child (list, test_node_new ("d"));
+
+  fail_if (gstd_object_delete (GSTD_OBJECT (list), "b"));
+  fail_unless_equals_int (list->count, 3);
+  fail_unless (NULL == gstd_list_find_child (list, "b"));
+  fail_unless_equals_int (gstd_object_delete (GSTD_OBJECT (list), "b"),
+      GSTD_NO_RESOURCE);
+
+  for (i = 0, iter = list->nodes.head; iter; iter = iter->next, i++) {
+    fail_unless_equals_string (GSTD_OBJECT_NAME (iter->data), expected[i]);
+  }
+  fail_unless_equals_int (i, G_N_ELEMENTS (expected));
+
+  /* A deleted name can be reused and goes to the end */
+  fail_unless (gstd_list_append_child (list, test_node_new ("b")));
+  fail_unless_equals_string (GSTD_OBJECT_NAME (list->nodes.tail->data), "b");
+
+  g_object_unref (list);
+}
+GST_END_TEST;
+
+/*
+ * Test: Every node of a large list is found under its own name
+ */
+GST_START_TEST (test_list_find_large)
+{
+  GstdList *list = test_list_new ();
+  GstdObject *node;
+  gchar *name;
+  guint i;
+
+  for (i = 0; i < LARGE_LIST_NODES; i++) {
+    name = g_strdup_printf ("pipeline%u", i);
+    fail_unless (gstd_list_append_child (list, test_node_new (name)));
+    g_free (name);
+  }
+  fail_unless_equals_int (list->count, LARGE_LIST_NODES);
+
+  for (i = 0; i < LARGE_LIST_NODES; i++) {
+    name = g_strdup_printf ("pipeline%u", (i * 7919) % LARGE_LIST_NODES);
+    node = gstd_list_find_child (list, name);
+    fail_if (NULL == node);
+    fail_unless_equals_string (GSTD_OBJECT_NAME (node), name);
+    g_object_unref (node);
+    g_free (name);
+  }
+
+  fail_unless (NULL == gstd_list_find_child (list, "pipeline"));
+
+  g_object_unref (list);
+}
+GST_END_TEST;
+
+static gdouble
+bench_lookup (guint size)
+{
+  GstdList *list = test_list_new ();
+  GstdObject *node;
+  gchar **names;
+  gint64 start;
+  gint64 elapsed;
+  guint i;
+
+  names = g_new0 (gchar *, size + 1);
+  for (i = 0; i < size; i++) {
+    names[i] = g_strdup_printf ("pipeline%u", i);
+    gstd_list_append_child (list, test_node_new (names[i]));
+  }
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < BENCH_LOOKUPS; i++) {
+    /* Stride through the names so every position gets hit */
+    node = gstd_list_find_child (list, names[(i * 7919) % size]);
+    g_object_unref (node);
+  }
+  elapsed = g_get_monotonic_time () - start;
+
+  g_strfreev (names);
+  g_object_unref (list);
+
+  return (elapsed * 1000.0) / BENCH_LOOKUPS;
+}
+
+/*
+ * Benchmark: Lookup cost as the list grows from 10 to 10k nodes
+ */
+GST_START_TEST (test_list_lookup_bench)
+{
+  const guint sizes[] = { 10, 100, 1000, 10000 };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    g_print ("gstd_list_find_child: %5u nodes -> %8.1f ns/lookup\n",
+        sizes[i], bench_lookup (sizes[i]));
+  }
+}
+GST_END_TEST;
+
+/*
+ * Test: Serialization lists the nodes in order along the properties
+ */
+GST_START_TEST (test_list_to_string)
+{
+  GstdList *list = test_list_new ();
+  gchar *out = NULL;
+  const gchar *a;
+  const gchar *b;
+
+  gstd_list_append_child (list, test_node_new ("a\"quoted\""));
+  gstd_list_append_child (list, test_node_new ("b"));
+
+  fail_if (gstd_object_to_string (GSTD_OBJECT (list), &out));
+
+  fail_if (NULL == strstr (out, "\"properties\""));
+  fail_if (NULL == strstr (out, "\"nodes\""));
+  a = strstr (out, "\"a\\\"quoted\\\"\"");
+  b = strstr (out, "\"b\"");
+  fail_if (NULL == a || NULL == b);
+  fail_unless (a < b);
+
+  g_free (out);
+  g_object_unref (list);
+}
+GST_END_TEST;
+
+/*
+ * Test: Serializing a large list lists every node once
+ */
+GST_START_TEST (test_list_to_string_large)
+{
+  GstdList *list = test_list_new ();
+  gchar *name;
+  gchar *out = NULL;
+  gchar **parts;
+  guint i;
+
+  for (i = 0; i < LARGE_LIST_NODES; i++) {
+    name = g_strdup_printf ("pipeline%u", i);
+    gstd_list_append_child (list, test_node_new (name));
+    g_free (name);
+  }
+
+  fail_if (gstd_object_to_string (GSTD_OBJECT (list), &out));
+
+  parts = g_strsplit (out, "\"pipeline", -1);
+  fail_unless_equals_int (g_strv_length (parts) - 1, LARGE_LIST_NODES);
+  g_strfreev (parts);
+
+  name = g_strdup_printf ("\"pipeline%u\"", LARGE_LIST_NODES - 1);
+  fail_if (NULL == strstr (out, name));
+  g_free (name);
+
+  g_free (out);
+  g_object_unref (list);
+}
+GST_END_TEST;
+
+static gdouble
+bench_to_string (guint size)
+{
+  GstdList *list = test_list_new ();
+  gchar *name;
+  gchar *out;
+  gint64 start;
+  gint64 elapsed;
+  guint i;
+
+  for (i = 0; i < size; i++) {
+    name = g_strdup_printf ("pipeline%u", i);
+    gstd_list_append_child (list, test_node_new (name));
+    g_free (name);
+  }
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < BENCH_SERIALIZATIONS; i++) {
+    out = NULL;
+    gstd_object_to_string (GSTD_OBJECT (list), &out);
+    g_free (out);
+  }
+  elapsed = g_get_monotonic_time () - start;
+
+  g_object_unref (list);
+
+  return (elapsed * 1000.0) / BENCH_SERIALIZATIONS / size;
+}
+
+/*
+ * Benchmark: Serialization cost per node from 200 to 2000 nodes
+ */
+GST_START_TEST (test_list_to_string_bench)
+{
+  const guint sizes[] = { 200, 2000 };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    g_print ("gstd_list_to_string: %5u nodes -> %8.1f ns/node\n",
+        sizes[i], bench_to_string (sizes[i]));
+  }
+}
+GST_END_TEST;
+
+static const gchar *lazy_names[] = { "x", "y", "z" };
+
+static GPtrArray *
+lazy_list_names (GstdList * list, gpointer user_data)
+{
+  GPtrArray *names = g_ptr_array_new_with_free_func (g_free);
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (lazy_names); i++) {
+    g_ptr_array_add (names, g_strdup (lazy_names[i]));
+  }
+
+  return names;
+}
+
+static GstdObject *
+lazy_list_make_node (GstdList * list, const gchar * name, gpointer user_data)
+{
+  guint *made = user_data;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (lazy_names); i++) {
+    if (!g_strcmp0 (name, lazy_names[i])) {
+      (*made)++;
+      return test_node_new (name);
+    }
+  }
+
+  return NULL;
+}
+
+/*
+ * Test: A lazy list lists and counts every node but only creates the
+ * ones looked up, once
+ */
+GST_START_TEST (test_list_lazy)
+{
+  GstdList *list = test_list_new ();
+  GstdObject *first;
+  GstdObject *again;
+  guint made = 0;
+  guint count = 0;
+  gchar *out = NULL;
+
+  gstd_list_set_node_factory (list, lazy_list_names, lazy_list_make_node,
+      &made, NULL);
+
+  g_object_get (list, "count", &count, NULL);
+  fail_unless_equals_int (count, 3);
+  fail_if (gstd_object_to_string (GSTD_OBJECT (list), &out));
+  fail_if (NULL == strstr (out, "\"z\""));
+  g_free (out);
+  fail_unless_equals_int (made, 0);
+
+  first = gstd_list_find_child (list, "y");
+  again = gstd_list_find_child (list, "y");
+  fail_if (NULL == first);
+  fail_unless (first == again);
+  fail_unless_equals_int (made, 1);
+  fail_unless_equals_int (list->nodes.length, 1);
+  g_object_unref (first);
+  g_object_unref (again);
+
+  fail_unless (NULL == gstd_list_find_child (list, "missing"));
+
+  g_object_unref (list);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_list_suite (void)
+{
+  Suite *suite = suite_create ("gstd_list");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 60);
+
+  tcase_add_test (tc, test_list_append_find);
+  tcase_add_test (tc, test_list_order_after_delete);
+  tcase_add_test (tc, test_list_find_large);
+  tcase_add_test (tc, test_list_to_string);
+  tcase_add_test (tc, test_list_to_string_large);
+  tcase_add_test (tc, test_list_lazy);
+
+  /* Timing only, opt-in so loaded machines don't fail the suite */
+  if (g_getenv ("GSTD_CHECK_BENCH")) {
+    TCase *bench = tcase_create ("bench");
+
+    suite_add_tcase (suite, bench);
+    tcase_set_timeout (bench, 60);
+    tcase_add_test (bench, test_list_lookup_bench);
+    tcase_add_test (bench, test_list_to_string_bench);
+  }
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_list);
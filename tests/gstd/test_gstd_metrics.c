@@ -0,0 +1,168 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the metrics:
+ * - Commands are counted by IPC and command, failures included
+ * - Pipelines count their state changes and errors
+ * - The export is in the Prometheus text format
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/check/gstcheck.h>
+
+#include "gstd_parser.h"
+#include "gstd_session.h"
+#include "gstd_state.h"
+
+static GstdSession *test_session = NULL;
+
+static void
+setup (void)
+{
+  test_session = gstd_session_new ("Test_session");
+}
+
+static void
+teardown (void)
+{
+  gst_object_unref (test_session);
+  test_session = NULL;
+}
+
+static GstdReturnCode
+run (const gchar * cmd)
+{
+  gchar *output = NULL;
+  GstdReturnCode ret;
+
+  ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+  g_free (output);
+
+  return ret;
+}
+
+static gchar *
+format (void)
+{
+  GString *out = g_string_new (NULL);
+
+  gstd_metrics_format (out, test_session->pipelines);
+
+  return g_string_free (out, FALSE);
+}
+
+/*
+ * Test: Commands are counted in the thread's IPC
+ */
+GST_START_TEST (test_metrics_commands)
+{
+  gchar *metrics;
+
+  fail_if (run ("pipeline_create p0 fakesrc ! fakesink"));
+  fail_unless_equals_int (GSTD_EXISTING_RESOURCE,
+      run ("pipeline_create p0 fakesrc ! fakesink"));
+
+  gstd_metrics_set_thread_ipc (GSTD_METRICS_IPC_TCP);
+  fail_if (run ("list_pipelines"));
+  gstd_metrics_set_thread_ipc (GSTD_METRICS_IPC_API);
+
+  metrics = format ();
+
+  fail_unless (strstr (metrics, "gstd_command_duration_seconds_count"
+          "{ipc=\"api\",command=\"pipeline_create\"} 2\n"), "%s", metrics);
+  fail_unless (strstr (metrics, "gstd_command_duration_seconds_bucket"
+          "{ipc=\"api\",command=\"pipeline_create\",le=\"+Inf\"} 2\n"));
+  fail_unless (strstr (metrics, "gstd_command_errors_total"
+          "{ipc=\"api\",command=\"pipeline_create\"} 1\n"));
+  fail_unless (strstr (metrics, "gstd_command_duration_seconds_count"
+          "{ipc=\"tcp\",command=\"list_pipelines\"} 1\n"));
+  fail_if (strstr (metrics, "{ipc=\"tcp\",command=\"pipeline_create\""));
+  fail_if (strstr (metrics, "gstd_list_lock_acquisitions_total 0\n"));
+
+  g_free (metrics);
+}
+GST_END_TEST;
+
+/*
+ * Test: Pipelines count the state changes of their top-level bin
+ */
+GST_START_TEST (test_metrics_pipeline)
+{
+  GstdObject *node;
+  GstdPipeline *pipeline;
+  guint64 transitions = 0;
+  guint64 errors = 0;
+  gint64 deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  gchar *metrics;
+
+  fail_if (run ("pipeline_create p0 fakesrc ! fakesink"));
+  fail_if (run ("pipeline_pause p0"));
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/state", &node));
+  fail_if (gstd_state_wait (GSTD_STATE (node), 0, 5 * GST_SECOND));
+  g_object_unref (node);
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0", &node));
+  pipeline = GSTD_PIPELINE (node);
+
+  /* NULL to READY to PAUSED, the last one may still be on its way */
+  while (g_get_monotonic_time () < deadline) {
+    gstd_metrics_pipeline_get (gstd_pipeline_get_metrics (pipeline),
+        &transitions, &errors, NULL, NULL);
+    if (2 == transitions) {
+      break;
+    }
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+  assert_equals_uint64 (2, transitions);
+  assert_equals_uint64 (0, errors);
+
+  metrics = format ();
+  fail_unless (strstr (metrics,
+          "gstd_pipeline_state_transitions_total{pipeline=\"p0\"} 2\n"), "%s",
+      metrics);
+  fail_unless (strstr (metrics, "gstd_pipelines 1\n"));
+
+  g_free (metrics);
+  g_object_unref (node);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_metrics_suite (void)
+{
+  Suite *suite = suite_create ("gstd_metrics");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_metrics_commands);
+  tcase_add_test (tc, test_metrics_pipeline);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_metrics);
@@ -23,6 +23,14 @@
  * - Valid command parsing
  * - Invalid command handling
  * - Error paths
+ * - Batches
+ * - Pipelines created from templates
+ *
+ * Set GSTD_CHECK_BENCH to also run the timed benchmarks, their rates
+ * are printed and never fail the run:
+ * - element_set flood
+ * - Templated against raw pipeline_create
+ * - pipeline_create and pipeline_play, cold and from a standby pool
  */
 
 #ifdef HAVE_CONFIG_H
@@ -30,9 +38,20 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <json-glib/json-glib.h>
 
 #include "gstd_session.h"
 #include "gstd_parser.h"
+#include "gstd_pipeline_bus.h"
+
+/* Number of element_set commands in the flood benchmark */
+#define BENCH_COMMANDS 20000
+
+/* Number of pipelines created per kind in the creation benchmark */
+#define BENCH_PIPELINES 500
+
+/* Number of create and play rounds in the standby benchmark */
+#define BENCH_FAILOVERS 100
 
 static GstdSession *test_session = NULL;
 
@@ -95,6 +114,108 @@ GST_START_TEST (test_parse_pipeline_delete)
 }
 GST_END_TEST;
 
+/*
+ * Test: Async pipeline delete returns before the teardown is done
+ */
+GST_START_TEST (test_parse_pipeline_delete_async)
+{
+  GstdReturnCode ret;
+  GstdObject *pipeline = NULL;
+  gchar *output = NULL;
+  gchar **deleting;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create async_pipe fakesrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/async_pipe",
+          &pipeline));
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_play async_pipe",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_delete async_pipe async", &output);
+  fail_if (ret != GSTD_EOK, "Async delete failed with code %d", ret);
+  g_free (output);
+  output = NULL;
+
+  /* The name is free right away */
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_play async_pipe",
+      &output);
+  fail_if (ret == GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  /* The name can be reused while the old pipeline shuts down */
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create async_pipe fakesrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  gstd_session_wait_pipeline_deleted (test_session, pipeline);
+  g_object_unref (pipeline);
+
+  deleting = gstd_session_get_deleting_pipelines (test_session);
+  fail_if (g_strv_length (deleting) != 0);
+  g_strfreev (deleting);
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete async_pipe",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  deleting = gstd_session_get_deleting_pipelines (test_session);
+  fail_if (g_strv_length (deleting) != 0);
+  g_strfreev (deleting);
+
+  /* Unknown options are rejected */
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_delete async_pipe later", &output);
+  fail_if (ret != GSTD_BAD_VALUE);
+  g_free (output);
+}
+GST_END_TEST;
+
+/*
+ * Test: Default pipeline delete waits for the teardown
+ */
+GST_START_TEST (test_parse_pipeline_delete_sync)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gchar **deleting;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create sync_pipe fakesrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_play sync_pipe",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete sync_pipe",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+
+  deleting = gstd_session_get_deleting_pipelines (test_session);
+  fail_if (g_strv_length (deleting) != 0);
+  g_strfreev (deleting);
+}
+GST_END_TEST;
+
 /*
  * Test: Parse pipeline play command
  */
@@ -318,8 +439,6 @@ GST_END_TEST;
 
 /*
  * Test: NULL command returns error with expected critical warning
- * Note: Empty string "" causes crash in parser (known limitation)
- * so we test NULL instead
  */
 GST_START_TEST (test_parse_null_command)
 {
@@ -458,6 +577,596 @@ GST_START_TEST (test_parse_event_eos)
 }
 GST_END_TEST;
 
+/*
+ * Test: Commands are matched regardless of case, prefixes are not
+ */
+GST_START_TEST (test_parse_command_case)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "LIST_PIPELINES", &output);
+  fail_if (ret != GSTD_EOK, "Command lookup should ignore case");
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "list_pipeline", &output);
+  fail_unless_equals_int (ret, GSTD_BAD_COMMAND);
+  fail_unless (NULL == output);
+
+  ret = gstd_parser_parse_cmd (test_session, "list_pipelinesx", &output);
+  fail_unless_equals_int (ret, GSTD_BAD_COMMAND);
+  fail_unless (NULL == output);
+}
+GST_END_TEST;
+
+/*
+ * Test: Empty command returns error
+ */
+GST_START_TEST (test_parse_empty_command)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "", &output);
+  fail_unless_equals_int (ret, GSTD_BAD_COMMAND);
+  fail_unless (NULL == output);
+}
+GST_END_TEST;
+
+/*
+ * Reads the "codes" array of a batch response into @codes, returns
+ * its length
+ */
+static guint
+batch_codes (const gchar * output, gint * codes, guint max)
+{
+  JsonParser *parser = json_parser_new ();
+  JsonArray *array;
+  guint length;
+  guint i;
+
+  fail_unless (json_parser_load_from_data (parser, output, -1, NULL));
+  array = json_object_get_array_member (json_node_get_object
+      (json_parser_get_root (parser)), "codes");
+  fail_if (NULL == array);
+
+  length = json_array_get_length (array);
+  for (i = 0; i < length && i < max; i++) {
+    codes[i] = json_array_get_int_element (array, i);
+  }
+
+  g_object_unref (parser);
+  return length;
+}
+
+/*
+ * Test: Batch runs every operation and reports their codes
+ */
+GST_START_TEST (test_parse_batch)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gint codes[4];
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create batch_pipe fakesrc name=mysrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "batch \n"
+      "element_set batch_pipe mysrc num-buffers 10\n"
+      "element_set batch_pipe mysrc sizetype 2\n"
+      "element_set batch_pipe nope num-buffers 20\n"
+      "element_set batch_pipe mysrc num-buffers 30", &output);
+  fail_if (ret != GSTD_NO_RESOURCE && ret != GSTD_BAD_COMMAND,
+      "Expected the failure of the third operation, got %d", ret);
+  fail_if (NULL == output);
+
+  assert_equals_int (4, batch_codes (output, codes, 4));
+  assert_equals_int (GSTD_EOK, codes[0]);
+  assert_equals_int (GSTD_EOK, codes[1]);
+  assert_equals_int (ret, codes[2]);
+  assert_equals_int (GSTD_EOK, codes[3]);
+  g_free (output);
+  output = NULL;
+
+  /* Operations after the failure ran */
+  ret = gstd_parser_parse_cmd (test_session,
+      "element_get batch_pipe mysrc num-buffers", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (strstr (output, "30") == NULL, "Expected num-buffers=30");
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete batch_pipe",
+      &output);
+  g_free (output);
+}
+GST_END_TEST;
+
+/*
+ * Test: Batch skips the operations after the first failure
+ */
+GST_START_TEST (test_parse_batch_stop_on_error)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gint codes[3];
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create batch_pipe fakesrc name=mysrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "batch stop_on_error\n"
+      "element_set batch_pipe mysrc num-buffers 10\n"
+      "element_set batch_pipe nope num-buffers 20\n"
+      "element_set batch_pipe mysrc num-buffers 30\n", &output);
+  fail_if (ret == GSTD_EOK);
+
+  assert_equals_int (2, batch_codes (output, codes, 3));
+  assert_equals_int (GSTD_EOK, codes[0]);
+  assert_equals_int (ret, codes[1]);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "element_get batch_pipe mysrc num-buffers", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (strstr (output, "10") == NULL, "Expected num-buffers=10");
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete batch_pipe",
+      &output);
+  g_free (output);
+}
+GST_END_TEST;
+
+/*
+ * Test: Parents resolved by a batch don't outlive their pipeline
+ */
+GST_START_TEST (test_parse_batch_recreate)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  const gchar *cmds[] = {
+    "pipeline_create batch_pipe fakesrc name=mysrc ! fakesink",
+    "element_set batch_pipe mysrc num-buffers 10",
+    "pipeline_delete batch_pipe",
+    "",
+    "pipeline_create batch_pipe fakesrc name=mysrc ! fakesink",
+    "element_set batch_pipe mysrc num-buffers 20",
+    NULL
+  };
+  gint codes[6];
+
+  ret = gstd_parser_parse_batch (test_session, cmds, TRUE, &output);
+  fail_if (ret != GSTD_EOK, "Batch failed with code %d", ret);
+
+  /* Empty operations are skipped */
+  assert_equals_int (5, batch_codes (output, codes, 6));
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "element_get batch_pipe mysrc num-buffers", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (strstr (output, "20") == NULL,
+      "Expected the update on the new pipeline");
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete batch_pipe",
+      &output);
+  g_free (output);
+}
+GST_END_TEST;
+
+/*
+ * Test: Batches can't be nested
+ */
+GST_START_TEST (test_parse_batch_nested)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gint codes[2];
+
+  ret = gstd_parser_parse_cmd (test_session, "batch \n"
+      "batch stop_on_error\nlist_pipelines", &output);
+  assert_equals_int (GSTD_BAD_COMMAND, ret);
+  assert_equals_int (2, batch_codes (output, codes, 2));
+  assert_equals_int (GSTD_BAD_COMMAND, codes[0]);
+  assert_equals_int (GSTD_EOK, codes[1]);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "batch unknown_option\n"
+      "list_pipelines", &output);
+  assert_equals_int (GSTD_BAD_VALUE, ret);
+  g_free (output);
+}
+GST_END_TEST;
+
+/*
+ * Benchmark: element_set flood, reports the sustained command rate
+ */
+GST_START_TEST (test_parse_element_set_flood)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gchar cmd[128];
+  gint64 start;
+  gint64 elapsed;
+  guint i;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create flood_pipe fakesrc name=mysrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < BENCH_COMMANDS; i++) {
+    g_snprintf (cmd, sizeof (cmd),
+        "element_set flood_pipe mysrc num-buffers %u", i);
+    ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+    fail_if (ret != GSTD_EOK, "element_set failed with code %d", ret);
+    g_free (output);
+    output = NULL;
+  }
+  elapsed = g_get_monotonic_time () - start;
+
+  g_print ("element_set: %u commands in %.1f ms -> %.0f ops/s\n",
+      BENCH_COMMANDS, elapsed / 1000.0,
+      BENCH_COMMANDS * 1000000.0 / MAX (elapsed, 1));
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "element_get flood_pipe mysrc num-buffers", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (strstr (output, "19999") == NULL,
+      "Expected the last element_set to stick");
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete flood_pipe",
+      &output);
+  g_free (output);
+}
+GST_END_TEST;
+
+/*
+ * Test: Pipelines created from a template get the parameter values
+ */
+GST_START_TEST (test_parse_pipeline_create_from)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "template_create tpl fakesrc name=src num-buffers=${n} ! fakesink",
+      &output);
+  fail_if (ret != GSTD_EOK, "template_create failed with code %d", ret);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "list_templates", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (strstr (output, "tpl") == NULL);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create_from tpl_pipe tpl n=42", &output);
+  fail_if (ret != GSTD_EOK, "pipeline_create_from failed with code %d", ret);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "element_get tpl_pipe src num-buffers", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (strstr (output, "42") == NULL);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create_from other_pipe tpl", &output);
+  assert_equals_int (GSTD_MISSING_ARGUMENT, ret);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create_from other_pipe nope n=1", &output);
+  assert_equals_int (GSTD_NO_RESOURCE, ret);
+  g_free (output);
+  output = NULL;
+
+  /* The pipeline outlives its template */
+  ret = gstd_parser_parse_cmd (test_session, "template_delete tpl", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete tpl_pipe",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+}
+GST_END_TEST;
+
+/* Creates and deletes BENCH_PIPELINES pipelines, returns the rate */
+static gdouble
+create_pipelines (const gchar * format)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gchar cmd[256];
+  gint64 start;
+  gint64 elapsed;
+  guint i;
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < BENCH_PIPELINES; i++) {
+    g_snprintf (cmd, sizeof (cmd), format, i, i);
+    ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+    fail_if (ret != GSTD_EOK, "\"%s\" failed with code %d", cmd, ret);
+    g_free (output);
+    output = NULL;
+
+    g_snprintf (cmd, sizeof (cmd), "pipeline_delete bench%u", i);
+    ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+    fail_if (ret != GSTD_EOK);
+    g_free (output);
+    output = NULL;
+  }
+  elapsed = g_get_monotonic_time () - start;
+
+  return BENCH_PIPELINES * 1000000.0 / MAX (elapsed, 1);
+}
+
+/*
+ * Benchmark: pipeline_create from a template against the raw
+ * description, reports both creation rates
+ */
+GST_START_TEST (test_parse_pipeline_create_flood)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gdouble raw;
+  gdouble templated;
+
+  ret = gstd_parser_parse_cmd (test_session, "template_create bench "
+      "fakesrc num-buffers=${n} ! queue max-size-buffers=${n} ! "
+      "identity silent=false ! fakesink sync=false", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+
+  raw = create_pipelines ("pipeline_create bench%u fakesrc num-buffers=%u ! "
+      "queue max-size-buffers=5 ! identity silent=false ! fakesink "
+      "sync=false");
+  templated = create_pipelines ("pipeline_create_from bench%u bench n=%u");
+
+  g_print ("pipeline_create: raw %.0f/s, templated %.0f/s\n", raw, templated);
+}
+GST_END_TEST;
+
+/*
+ * Average time in microseconds from pipeline_create to pipeline_play
+ * returning. With a @standby pool, each round waits for it to refill
+ * first, as a fail-over would find it.
+ */
+static gdouble
+failover (const gchar * description, GstdObject * standby)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gchar cmd[256];
+  guint available;
+  gint64 start;
+  gint64 elapsed = 0;
+  guint i;
+
+  for (i = 0; i < BENCH_FAILOVERS; i++) {
+    while (standby) {
+      g_object_get (standby, "available", &available, NULL);
+      if (available) {
+        break;
+      }
+      g_usleep (1000);
+    }
+
+    start = g_get_monotonic_time ();
+    g_snprintf (cmd, sizeof (cmd), "pipeline_create bench%u %s", i,
+        description);
+    ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+    fail_if (ret != GSTD_EOK, "\"%s\" failed with code %d", cmd, ret);
+    g_free (output);
+    output = NULL;
+
+    g_snprintf (cmd, sizeof (cmd), "pipeline_play bench%u", i);
+    ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+    fail_if (ret != GSTD_EOK);
+    g_free (output);
+    output = NULL;
+    elapsed += g_get_monotonic_time () - start;
+
+    g_snprintf (cmd, sizeof (cmd), "pipeline_delete bench%u", i);
+    ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+    fail_if (ret != GSTD_EOK);
+    g_free (output);
+    output = NULL;
+  }
+
+  return (gdouble) elapsed / BENCH_FAILOVERS;
+}
+
+/*
+ * Benchmark: pipeline_create and pipeline_play with and without a
+ * standby pool paused ahead of time, reports the time both take
+ */
+GST_START_TEST (test_parse_pipeline_failover)
+{
+  const gchar *description = "fakesrc sizetype=fixed sizemax=4096 ! "
+      "queue ! identity silent=false ! fakesink sync=true";
+  GstdReturnCode ret;
+  GstdObject *standby = NULL;
+  gchar *output = NULL;
+  gchar cmd[256];
+  guint64 claims;
+  gdouble cold;
+  gdouble warm;
+
+  cold = failover (description, NULL);
+
+  g_snprintf (cmd, sizeof (cmd), "standby_create bench 2 paused %s",
+      description);
+  ret = gstd_parser_parse_cmd (test_session, cmd, &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+
+  fail_if (gstd_get_by_uri (test_session, "/standby/bench", &standby));
+  warm = failover (description, standby);
+  g_object_get (standby, "claims", &claims, NULL);
+  assert_equals_uint64 (BENCH_FAILOVERS, claims);
+  g_object_unref (standby);
+
+  g_print ("pipeline_create + pipeline_play: %.0f us cold, %.0f us from "
+      "standby\n", cold, warm);
+}
+GST_END_TEST;
+
+static void
+post_application_messages (const gchar * pipeline, guint count)
+{
+  GstdObject *bus = NULL;
+  GstBus *gstbus;
+  gchar *uri;
+  guint i;
+
+  uri = g_strdup_printf ("/pipelines/%s/bus", pipeline);
+  fail_if (gstd_get_by_uri (test_session, uri, &bus));
+  g_free (uri);
+
+  gstbus = gstd_pipeline_bus_get_bus (GSTD_PIPELINE_BUS (bus));
+  for (i = 0; i < count; i++) {
+    fail_unless (gst_bus_post (gstbus, gst_message_new_application (NULL,
+                gst_structure_new_empty ("ping"))));
+  }
+
+  gst_object_unref (gstbus);
+  g_object_unref (bus);
+}
+
+/*
+ * Runs @cmd, a bus_read_since, and returns the amount of messages
+ * read, along with the "next" and "lost" members
+ */
+static guint
+read_since (const gchar * cmd, guint64 * next, guint64 * lost)
+{
+  JsonParser *parser = json_parser_new ();
+  JsonObject *object;
+  gchar *output = NULL;
+  guint length;
+
+  fail_if (GSTD_EOK != gstd_parser_parse_cmd (test_session, cmd, &output));
+  fail_unless (json_parser_load_from_data (parser, output, -1, NULL));
+  object = json_node_get_object (json_parser_get_root (parser));
+
+  *next = json_object_get_int_member (object, "next");
+  *lost = json_object_get_int_member (object, "lost");
+  length = json_array_get_length (json_object_get_array_member (object,
+          "messages"));
+
+  g_object_unref (parser);
+  g_free (output);
+  return length;
+}
+
+/*
+ * Test: Readers keep their own cursor, so they all get the same
+ * messages, and are told how many they lost once the ring wrapped
+ */
+GST_START_TEST (test_parse_bus_read_since)
+{
+  GstdReturnCode ret;
+  gchar *output = NULL;
+  gchar *cmd;
+  guint64 next;
+  guint64 other;
+  guint64 lost;
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "pipeline_create since_pipe fakesrc ! fakesink", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+
+  post_application_messages ("since_pipe", 3);
+
+  /* Reading doesn't consume */
+  assert_equals_int (3, read_since ("bus_read_since since_pipe 0 application",
+          &next, &lost));
+  assert_equals_int (0, lost);
+  assert_equals_int (3, read_since ("bus_read_since since_pipe 0 application",
+          &other, &lost));
+  assert_equals_uint64 (next, other);
+
+  /* Batches continue where the previous one ended */
+  assert_equals_int (2,
+      read_since ("bus_read_since since_pipe 0 application 2", &other,
+          &lost));
+  cmd = g_strdup_printf ("bus_read_since since_pipe %" G_GUINT64_FORMAT
+      " application 2", other);
+  assert_equals_int (1, read_since (cmd, &other, &lost));
+  assert_equals_uint64 (next, other);
+  g_free (cmd);
+
+  /* The message resource still reads them */
+  ret = gstd_parser_parse_cmd (test_session,
+      "bus_filter since_pipe application", &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+  ret = gstd_parser_parse_cmd (test_session, "bus_timeout since_pipe 0",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+  output = NULL;
+  ret = gstd_parser_parse_cmd (test_session, "bus_read since_pipe", &output);
+  fail_if (ret != GSTD_EOK);
+  fail_if (NULL == strstr (output, "application"));
+  g_free (output);
+  output = NULL;
+  assert_equals_int (3, read_since ("bus_read_since since_pipe 0 application",
+          &other, &lost));
+
+  /* Overflow the ring */
+  post_application_messages ("since_pipe", GSTD_PIPELINE_BUS_RING_SIZE + 10);
+  cmd = g_strdup_printf ("bus_read_since since_pipe %" G_GUINT64_FORMAT
+      " application %d", next, GSTD_PIPELINE_BUS_RING_SIZE);
+  assert_equals_int (GSTD_PIPELINE_BUS_RING_SIZE, read_since (cmd, &other,
+          &lost));
+  assert_equals_int (10, lost);
+  assert_equals_uint64 (next + GSTD_PIPELINE_BUS_RING_SIZE + 10, other);
+  g_free (cmd);
+
+  ret = gstd_parser_parse_cmd (test_session,
+      "bus_read_since since_pipe nope", &output);
+  fail_unless_equals_int (ret, GSTD_BAD_VALUE);
+  g_free (output);
+  output = NULL;
+
+  ret = gstd_parser_parse_cmd (test_session, "pipeline_delete since_pipe",
+      &output);
+  fail_if (ret != GSTD_EOK);
+  g_free (output);
+}
+GST_END_TEST;
+
 static Suite *
 gstd_parser_suite (void)
 {
@@ -471,6 +1180,8 @@ gstd_parser_suite (void)
   /* Valid command tests */
   tcase_add_test (tc, test_parse_pipeline_create);
   tcase_add_test (tc, test_parse_pipeline_delete);
+  tcase_add_test (tc, test_parse_pipeline_delete_async);
+  tcase_add_test (tc, test_parse_pipeline_delete_sync);
   tcase_add_test (tc, test_parse_pipeline_play);
   tcase_add_test (tc, test_parse_pipeline_pause);
   tcase_add_test (tc, test_parse_pipeline_stop);
@@ -480,6 +1191,12 @@ gstd_parser_suite (void)
   tcase_add_test (tc, test_parse_element_set);
   tcase_add_test (tc, test_parse_list_elements);
   tcase_add_test (tc, test_parse_event_eos);
+  tcase_add_test (tc, test_parse_command_case);
+  tcase_add_test (tc, test_parse_batch);
+  tcase_add_test (tc, test_parse_batch_stop_on_error);
+  tcase_add_test (tc, test_parse_batch_recreate);
+  tcase_add_test (tc, test_parse_bus_read_since);
+  tcase_add_test (tc, test_parse_pipeline_create_from);
 
   /* Error handling tests */
   tcase_add_test (tc, test_parse_invalid_command);
@@ -488,6 +1205,20 @@ gstd_parser_suite (void)
   tcase_add_test (tc, test_parse_delete_nonexistent);
   tcase_add_test (tc, test_parse_play_nonexistent);
   tcase_add_test (tc, test_parse_missing_arguments);
+  tcase_add_test (tc, test_parse_empty_command);
+  tcase_add_test (tc, test_parse_batch_nested);
+
+  /* Benchmarks, timing only so they are opt-in */
+  if (g_getenv ("GSTD_CHECK_BENCH")) {
+    TCase *bench = tcase_create ("bench");
+
+    suite_add_tcase (suite, bench);
+    tcase_set_timeout (bench, 120);
+    tcase_add_checked_fixture (bench, setup, teardown);
+    tcase_add_test (bench, test_parse_element_set_flood);
+    tcase_add_test (bench, test_parse_pipeline_create_flood);
+    tcase_add_test (bench, test_parse_pipeline_failover);
+  }
 
   return suite;
 }
@@ -0,0 +1,370 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the retention of the pipeline bus:
+ * - Nothing stays queued in the GstBus
+ * - The oldest messages are dropped past max-messages or max-age,
+ *   and counted per type
+ * - The last error survives being dropped with keep-last-error
+ * - Parked reads complete on the next message, the timeout or when
+ *   cancelled
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_park.h"
+#include "gstd_pipeline_bus.h"
+
+static GstBus *test_bus = NULL;
+static GstdPipelineBus *test_pipeline_bus = NULL;
+
+static void
+setup (void)
+{
+  test_bus = gst_bus_new ();
+  test_pipeline_bus = gstd_pipeline_bus_new (gst_object_ref (test_bus));
+  fail_if (NULL == test_pipeline_bus);
+}
+
+static void
+teardown (void)
+{
+  g_object_unref (test_pipeline_bus);
+  gst_object_unref (test_bus);
+  test_pipeline_bus = NULL;
+  test_bus = NULL;
+}
+
+static void
+post (GstMessage * message, guint count)
+{
+  guint i;
+
+  for (i = 0; i < count; i++) {
+    fail_unless (gst_bus_post (test_bus, gst_message_copy (message)));
+  }
+  gst_message_unref (message);
+}
+
+static GstMessage *
+new_application (void)
+{
+  return gst_message_new_application (NULL, gst_structure_new_empty ("ping"));
+}
+
+static GstMessage *
+new_error (const gchar * text)
+{
+  GError *error = g_error_new_literal (GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+      text);
+  GstMessage *message = gst_message_new_error (NULL, error, NULL);
+
+  g_error_free (error);
+  return message;
+}
+
+/* Reads the amount of dropped messages of @type */
+static guint64
+dropped (const gchar * type)
+{
+  GstStructure *structure;
+  gchar *string = NULL;
+  guint64 count = 0;
+
+  g_object_get (test_pipeline_bus, "dropped", &string, NULL);
+  structure = gst_structure_from_string (string, NULL);
+  fail_if (NULL == structure);
+  gst_structure_get_uint64 (structure, type, &count);
+
+  gst_structure_free (structure);
+  g_free (string);
+  return count;
+}
+
+/* The outcome of a parked read, filled from the park thread */
+typedef struct _Parked
+{
+  GMutex lock;
+  GCond cond;
+  gboolean done;
+  GstdObject *result;
+} Parked;
+
+static void
+parked_init (Parked * parked)
+{
+  g_mutex_init (&parked->lock);
+  g_cond_init (&parked->cond);
+  parked->done = FALSE;
+  parked->result = NULL;
+}
+
+static void
+parked_clear (Parked * parked)
+{
+  g_clear_object (&parked->result);
+  g_cond_clear (&parked->cond);
+  g_mutex_clear (&parked->lock);
+}
+
+static void
+parked_complete (GstdObject * result, gpointer user_data)
+{
+  Parked *parked = user_data;
+
+  g_mutex_lock (&parked->lock);
+  fail_if (parked->done);
+  parked->done = TRUE;
+  parked->result = result;
+  g_cond_signal (&parked->cond);
+  g_mutex_unlock (&parked->lock);
+}
+
+static void
+parked_wait (Parked * parked)
+{
+  gint64 deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+
+  g_mutex_lock (&parked->lock);
+  while (!parked->done) {
+    fail_unless (g_cond_wait_until (&parked->cond, &parked->lock, deadline));
+  }
+  g_mutex_unlock (&parked->lock);
+}
+
+/*
+ * Test: Messages are drained from the bus as they are posted
+ */
+GST_START_TEST (test_pipeline_bus_drain)
+{
+  GstMessage *message;
+
+  post (new_application (), 10);
+
+  fail_unless (NULL == gst_bus_pop (test_bus));
+
+  message = gstd_pipeline_bus_pop (test_pipeline_bus, GST_MESSAGE_APPLICATION,
+      0);
+  fail_if (NULL == message);
+  gst_message_unref (message);
+}
+GST_END_TEST;
+
+/*
+ * Test: Past max-messages the oldest are dropped and counted
+ */
+GST_START_TEST (test_pipeline_bus_max_messages)
+{
+  gchar *response = NULL;
+  guint64 last_seq;
+
+  g_object_set (test_pipeline_bus, "max-messages", 8, NULL);
+  post (new_application (), 20);
+
+  g_object_get (test_pipeline_bus, "last-seq", &last_seq, NULL);
+  assert_equals_uint64 (20, last_seq);
+  assert_equals_uint64 (12, dropped ("application"));
+
+  fail_unless_equals_int (GSTD_EOK,
+      gstd_pipeline_bus_read_since (test_pipeline_bus, 0, GST_MESSAGE_ANY,
+          64, 0, &response));
+  fail_if (NULL == strstr (response, "\"lost\" : 12"));
+  g_free (response);
+
+  /* Shrinking keeps the newest */
+  g_object_set (test_pipeline_bus, "max-messages", 2, NULL);
+  assert_equals_uint64 (18, dropped ("application"));
+}
+GST_END_TEST;
+
+/*
+ * Test: Messages older than max-age are dropped
+ */
+GST_START_TEST (test_pipeline_bus_max_age)
+{
+  GstMessage *message;
+
+  g_object_set (test_pipeline_bus, "max-age", 10 * GST_MSECOND, NULL);
+  post (new_application (), 5);
+  g_usleep (20 * G_TIME_SPAN_MILLISECOND);
+
+  message = gstd_pipeline_bus_pop (test_pipeline_bus, GST_MESSAGE_APPLICATION,
+      0);
+  fail_unless (NULL == message);
+  assert_equals_uint64 (5, dropped ("application"));
+}
+GST_END_TEST;
+
+/*
+ * Test: The last error is still found after being dropped, unless
+ * keep-last-error is unset
+ */
+GST_START_TEST (test_pipeline_bus_keep_last_error)
+{
+  GstMessage *message;
+  GError *error = NULL;
+
+  g_object_set (test_pipeline_bus, "max-messages", 4, NULL);
+  post (new_error ("first"), 1);
+  post (new_error ("last"), 1);
+  post (new_application (), 10);
+  assert_equals_uint64 (2, dropped ("error"));
+
+  message = gstd_pipeline_bus_find_last (test_bus, GST_MESSAGE_ERROR);
+  fail_if (NULL == message);
+  gst_message_parse_error (message, &error, NULL);
+  fail_unless_equals_string ("last", error->message);
+  g_error_free (error);
+  gst_message_unref (message);
+
+  g_object_set (test_pipeline_bus, "keep-last-error", FALSE, NULL);
+  fail_unless (NULL == gstd_pipeline_bus_find_last (test_bus,
+          GST_MESSAGE_ERROR));
+}
+GST_END_TEST;
+
+/*
+ * Test: A parked read completes with the next message
+ */
+GST_START_TEST (test_pipeline_bus_park)
+{
+  Parked parked;
+  GstdObject *out = NULL;
+
+  parked_init (&parked);
+  g_object_set (test_pipeline_bus, "timeout", (gint64) - 1, "types",
+      GST_MESSAGE_APPLICATION, NULL);
+
+  fail_if (gstd_park_read (GSTD_OBJECT (test_pipeline_bus), NULL,
+          parked_complete, &parked, &out));
+  fail_unless (NULL == out);
+
+  post (new_application (), 1);
+  parked_wait (&parked);
+  fail_if (NULL == parked.result);
+
+  parked_clear (&parked);
+}
+GST_END_TEST;
+
+/*
+ * Test: A message already there is read right away
+ */
+GST_START_TEST (test_pipeline_bus_park_ready)
+{
+  Parked parked;
+  GstdObject *out = NULL;
+
+  parked_init (&parked);
+  g_object_set (test_pipeline_bus, "timeout", (gint64) - 1, "types",
+      GST_MESSAGE_APPLICATION, NULL);
+  post (new_application (), 1);
+
+  fail_unless (gstd_park_read (GSTD_OBJECT (test_pipeline_bus), NULL,
+          parked_complete, &parked, &out));
+  fail_if (NULL == out);
+  fail_if (parked.done);
+
+  g_object_unref (out);
+  parked_clear (&parked);
+}
+GST_END_TEST;
+
+/*
+ * Test: A parked read ends empty on timeout
+ */
+GST_START_TEST (test_pipeline_bus_park_timeout)
+{
+  Parked parked;
+  GstMessage *message;
+  GstdObject *out = NULL;
+
+  parked_init (&parked);
+  g_object_set (test_pipeline_bus, "timeout", 20 * GST_MSECOND, "types",
+      GST_MESSAGE_APPLICATION, NULL);
+
+  fail_if (gstd_park_read (GSTD_OBJECT (test_pipeline_bus), NULL,
+          parked_complete, &parked, &out));
+  parked_wait (&parked);
+  fail_unless (NULL == parked.result);
+
+  /* The waiter is gone, the message stays for the next read */
+  post (new_application (), 1);
+  message = gstd_pipeline_bus_pop (test_pipeline_bus, GST_MESSAGE_APPLICATION,
+      0);
+  fail_if (NULL == message);
+  gst_message_unref (message);
+
+  parked_clear (&parked);
+}
+GST_END_TEST;
+
+/*
+ * Test: A parked read ends empty when cancelled
+ */
+GST_START_TEST (test_pipeline_bus_park_cancel)
+{
+  Parked parked;
+  GCancellable *cancellable = g_cancellable_new ();
+  GstdObject *out = NULL;
+
+  parked_init (&parked);
+  g_object_set (test_pipeline_bus, "timeout", (gint64) - 1, "types",
+      GST_MESSAGE_APPLICATION, NULL);
+
+  fail_if (gstd_park_read (GSTD_OBJECT (test_pipeline_bus), cancellable,
+          parked_complete, &parked, &out));
+  g_cancellable_cancel (cancellable);
+  parked_wait (&parked);
+  fail_unless (NULL == parked.result);
+
+  g_object_unref (cancellable);
+  parked_clear (&parked);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_pipeline_bus_suite (void)
+{
+  Suite *suite = suite_create ("gstd_pipeline_bus");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 30);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_pipeline_bus_drain);
+  tcase_add_test (tc, test_pipeline_bus_max_messages);
+  tcase_add_test (tc, test_pipeline_bus_max_age);
+  tcase_add_test (tc, test_pipeline_bus_keep_last_error);
+  tcase_add_test (tc, test_pipeline_bus_park);
+  tcase_add_test (tc, test_pipeline_bus_park_ready);
+  tcase_add_test (tc, test_pipeline_bus_park_timeout);
+  tcase_add_test (tc, test_pipeline_bus_park_cancel);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_pipeline_bus);
@@ -107,6 +107,61 @@ GST_START_TEST (test_pipeline_create_erroneous_description)
 GST_END_TEST;
 
 
+/*
+ * Test: Elements inside bins are addressed by path, including the ones
+ * added or removed after the pipeline was created
+ */
+GST_START_TEST (test_pipeline_create_nested)
+{
+  GstdObject *node;
+  GstdObject *bin_node;
+  GstElement *bin;
+  GstElement *late;
+  GstdReturnCode ret;
+  GstdSession *test_session = gstd_session_new ("Test_session");
+
+  ret = gstd_get_by_uri (test_session, "/pipelines", &node);
+  fail_if (ret);
+  ret = gstd_object_create (node, "p4",
+      "fakesink name=top ( name=b fakesrc name=inner ! fakesink )");
+  fail_if (GSTD_EOK != ret);
+  gst_object_unref (node);
+
+  ret = gstd_get_by_uri (test_session,
+      "/pipelines/p4/elements/b/inner/properties/num-buffers", &node);
+  fail_if (ret);
+  gst_object_unref (node);
+
+  ret = gstd_get_by_uri (test_session, "/pipelines/p4/elements/b", &bin_node);
+  fail_if (ret);
+  g_object_get (bin_node, "gstelement", &bin, NULL);
+
+  late = gst_element_factory_make ("identity", "late");
+  fail_unless (gst_bin_add (GST_BIN (bin), late));
+  ret = gstd_get_by_uri (test_session, "/pipelines/p4/elements/b/late",
+      &node);
+  fail_if (ret);
+  gst_object_unref (node);
+
+  fail_unless (gst_bin_remove (GST_BIN (bin), late));
+  ret = gstd_get_by_uri (test_session, "/pipelines/p4/elements/b/late",
+      &node);
+  fail_if (GSTD_EOK == ret);
+
+  gst_object_unref (bin);
+  gst_object_unref (bin_node);
+
+  ret = gstd_get_by_uri (test_session, "/pipelines", &node);
+  fail_if (ret);
+  fail_if (gstd_object_delete (node, "p4"));
+  gst_object_unref (node);
+
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+
 static Suite *
 gstd_pipeline_create_suite (void)
 {
@@ -118,6 +173,7 @@ gstd_pipeline_create_suite (void)
   tcase_add_test (tc, test_pipeline_create_no_name);
   tcase_add_test (tc, test_pipeline_create_no_description);
   tcase_add_test (tc, test_pipeline_create_erroneous_description);
+  tcase_add_test (tc, test_pipeline_create_nested);
 
   return suite;
 }
@@ -0,0 +1,213 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/*
+ * Tests for the signal callbacks:
+ * - Emissions between reads are kept, none is missed
+ * - Past max-callbacks the oldest are dropped and counted
+ * - Readers with a cursor of their own don't take from each other
+ * - Disconnecting frees what was kept, not counted as dropped
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_callback.h"
+#include "gstd_signal.h"
+#include "gstd_signal_reader.h"
+
+static GstElement *test_element = NULL;
+static GstdObject *test_signal = NULL;
+
+static void
+setup (void)
+{
+  test_element = gst_element_factory_make ("identity", NULL);
+  fail_if (NULL == test_element);
+
+  test_signal = g_object_new (GSTD_TYPE_SIGNAL, "name", "handoff", "target",
+      test_element, NULL);
+  g_object_set (test_signal, "timeout", (gint64) 0, NULL);
+}
+
+static void
+teardown (void)
+{
+  g_object_unref (test_signal);
+  gst_object_unref (test_element);
+  test_signal = NULL;
+  test_element = NULL;
+}
+
+static void
+emit (guint count)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+  guint i;
+
+  for (i = 0; i < count; i++) {
+    g_signal_emit_by_name (test_element, "handoff", buffer);
+  }
+  gst_buffer_unref (buffer);
+}
+
+static gchar *
+read_since (guint64 since, guint max)
+{
+  gchar *response = NULL;
+
+  fail_unless_equals_int (GSTD_EOK,
+      gstd_signal_reader_read_since (test_signal->reader, test_signal, since,
+          max, 0, &response));
+  fail_if (NULL == response);
+
+  return response;
+}
+
+static GstdObject *
+read_callback (void)
+{
+  GstdObject *callback = NULL;
+
+  fail_unless_equals_int (GSTD_EOK,
+      gstd_object_read (test_signal, "callback", &callback));
+
+  return callback;
+}
+
+/*
+ * Test: Emissions between two callback reads are not missed
+ */
+GST_START_TEST (test_signal_callback)
+{
+  GstdObject *callback;
+  guint i;
+
+  /* The first read connects */
+  fail_unless (NULL == read_callback ());
+
+  emit (3);
+  for (i = 0; i < 3; i++) {
+    callback = read_callback ();
+    fail_unless (GSTD_IS_CALLBACK (callback));
+    g_object_unref (callback);
+  }
+  fail_unless (NULL == read_callback ());
+}
+GST_END_TEST;
+
+/*
+ * Test: Past max-callbacks the oldest are dropped and counted
+ */
+GST_START_TEST (test_signal_max_callbacks)
+{
+  gchar *response;
+  guint64 last_seq;
+  guint64 dropped;
+
+  g_object_set (test_signal, "max-callbacks", 2, NULL);
+  g_free (read_since (0, 64));
+  emit (5);
+
+  g_object_get (test_signal, "last-seq", &last_seq, "dropped", &dropped, NULL);
+  assert_equals_uint64 (5, last_seq);
+  assert_equals_uint64 (3, dropped);
+
+  response = read_since (0, 64);
+  fail_if (NULL == strstr (response, "\"lost\" : 3"));
+  fail_if (NULL == strstr (response, "\"next\" : 5"));
+  g_free (response);
+}
+GST_END_TEST;
+
+/*
+ * Test: Each reader sees every emission, batched up to max
+ */
+GST_START_TEST (test_signal_read_since)
+{
+  gchar *response;
+
+  g_free (read_since (0, 64));
+  emit (4);
+
+  response = read_since (0, 3);
+  fail_if (NULL == strstr (response, "\"next\" : 3"));
+  fail_if (NULL == strstr (response, "\"name\" : \"handoff\""));
+  g_free (response);
+
+  /* Another reader, and the callback read, still get them all */
+  response = read_since (0, 64);
+  fail_if (NULL == strstr (response, "\"next\" : 4"));
+  g_free (response);
+
+  response = read_since (3, 64);
+  fail_if (NULL == strstr (response, "\"seq\" : 4"));
+  fail_unless (NULL == strstr (response, "\"seq\" : 3"));
+  g_free (response);
+}
+GST_END_TEST;
+
+/*
+ * Test: Disconnecting frees the emissions kept without counting them
+ * as dropped, sequences go on
+ */
+GST_START_TEST (test_signal_disconnect)
+{
+  gchar *response;
+  guint64 dropped;
+
+  g_free (read_since (0, 64));
+  emit (2);
+
+  gstd_signal_disconnect (GSTD_SIGNAL (test_signal));
+  emit (2);
+
+  g_object_get (test_signal, "dropped", &dropped, NULL);
+  assert_equals_uint64 (0, dropped);
+
+  response = read_since (0, 64);
+  fail_if (NULL == strstr (response, "\"next\" : 2"));
+  fail_unless (NULL == strstr (response, "\"seq\""));
+  g_free (response);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_signal_suite (void)
+{
+  Suite *suite = suite_create ("gstd_signal");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_signal_callback);
+  tcase_add_test (tc, test_signal_max_callbacks);
+  tcase_add_test (tc, test_signal_read_since);
+  tcase_add_test (tc, test_signal_disconnect);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_signal);
@@ -0,0 +1,543 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the TCP socket server:
+ * - Legacy and framed commands through the event loop backend
+ * - CBOR encoded frames
+ * - Bus subscriptions on both backends
+ *
+ * Set GSTD_CHECK_BENCH to also compare memory and p99 latency with
+ * many concurrent clients, thread per connection vs event loop. The
+ * results are printed and never fail the run.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "gstd_cbor_writer.h"
+#include "gstd_pipeline_bus.h"
+#include "gstd_session.h"
+#include "gstd_socket.h"
+#include "gstd_tcp.h"
+
+#define TEST_ADDRESS "127.0.0.1"
+#define TEST_PORT 15100
+
+/* Concurrent clients in the benchmark, lowered if the process can not
+ * open enough descriptors for both ends */
+#define BENCH_CONNECTIONS 1000
+
+/* Requests sent by every client in the benchmark */
+#define BENCH_ROUNDS 5
+
+static GstdSession *test_session = NULL;
+
+static void
+setup (void)
+{
+  test_session = gstd_session_new ("Socket Test Session");
+  fail_if (NULL == test_session);
+}
+
+static void
+teardown (void)
+{
+  g_object_unref (test_session);
+  test_session = NULL;
+}
+
+static GstdIpc *
+start_tcp (guint port, gint io_threads)
+{
+  GstdIpc *tcp = GSTD_IPC (g_object_new (GSTD_TYPE_TCP, NULL));
+  GOptionContext *context;
+  GOptionGroup *group;
+  GError *error = NULL;
+  gchar *port_arg = g_strdup_printf ("%u", port);
+  gchar *io_arg = g_strdup_printf ("%d", io_threads);
+  gchar *args[] = { (gchar *) "test", (gchar *) "-t", (gchar *) "-p", port_arg,
+    (gchar *) "-m", (gchar *) "-1", (gchar *) "--tcp-io-threads", io_arg
+  };
+  gchar **argv = args;
+  gint argc = G_N_ELEMENTS (args);
+
+  context = g_option_context_new (NULL);
+  fail_unless (gstd_ipc_get_option_group (tcp, &group));
+  g_option_context_add_group (context, group);
+  fail_unless (g_option_context_parse (context, &argc, &argv, &error));
+  g_option_context_free (context);
+  g_free (port_arg);
+  g_free (io_arg);
+
+  fail_if (gstd_ipc_start (tcp, test_session));
+
+  return tcp;
+}
+
+static void
+stop_tcp (GstdIpc * tcp)
+{
+  gstd_ipc_stop (tcp);
+  g_object_unref (tcp);
+}
+
+static GSocket *
+client_connect (guint port)
+{
+  GSocketAddress *sa;
+  GSocket *socket;
+  GError *error = NULL;
+
+  sa = g_inet_socket_address_new_from_string (TEST_ADDRESS, port);
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  fail_if (error);
+  fail_unless (g_socket_connect (socket, sa, NULL, &error));
+  g_object_unref (sa);
+
+  return socket;
+}
+
+static void
+client_send (GSocket * socket, const gchar * data, gsize len)
+{
+  GError *error = NULL;
+  gssize sent;
+
+  while (len) {
+    sent = g_socket_send (socket, data, len, NULL, &error);
+    fail_if (sent <= 0);
+    data += sent;
+    len -= sent;
+  }
+}
+
+static void
+client_recv (GSocket * socket, gchar * data, gsize len)
+{
+  GError *error = NULL;
+  gssize read;
+
+  while (len) {
+    read = g_socket_receive (socket, data, len, NULL, &error);
+    fail_if (read <= 0);
+    data += read;
+    len -= read;
+  }
+}
+
+/* Reads a NUL terminated response */
+static gchar *
+client_read_response (GSocket * socket)
+{
+  GString *response = g_string_new (NULL);
+  gchar c;
+
+  do {
+    client_recv (socket, &c, 1);
+    g_string_append_c (response, c);
+  } while ('\0' != c);
+
+  return g_string_free (response, FALSE);
+}
+
+static gchar *
+client_request (GSocket * socket, const gchar * command)
+{
+  client_send (socket, command, strlen (command));
+  return client_read_response (socket);
+}
+
+static void
+client_send_frame (GSocket * socket, guint32 id, const gchar * command)
+{
+  guint8 header[GSTD_SOCKET_FRAME_HEADER_SIZE];
+
+  GST_WRITE_UINT32_BE (header, strlen (command));
+  GST_WRITE_UINT32_BE (header + 4, id);
+  client_send (socket, (const gchar *) header, sizeof (header));
+  client_send (socket, command, strlen (command));
+}
+
+static void
+client_send_cbor_frame (GSocket * socket, guint32 id, const gchar * command)
+{
+  GByteArray *payload = g_byte_array_new ();
+  guint8 header[GSTD_SOCKET_FRAME_HEADER_SIZE];
+
+  gstd_cbor_append_text (payload, command);
+
+  GST_WRITE_UINT32_BE (header, payload->len);
+  GST_WRITE_UINT32_BE (header + 4, id);
+  client_send (socket, (const gchar *) header, sizeof (header));
+  client_send (socket, (const gchar *) payload->data, payload->len);
+
+  g_byte_array_unref (payload);
+}
+
+static gchar *
+client_read_frame (GSocket * socket, guint32 * id, guint32 * length)
+{
+  guint8 header[GSTD_SOCKET_FRAME_HEADER_SIZE];
+  gchar *payload;
+
+  client_recv (socket, (gchar *) header, sizeof (header));
+  *length = GST_READ_UINT32_BE (header);
+  *id = GST_READ_UINT32_BE (header + 4);
+
+  payload = g_malloc (*length + 1);
+  client_recv (socket, payload, *length);
+  payload[*length] = '\0';
+
+  return payload;
+}
+
+/*
+ * Test: The event loop backend answers legacy commands
+ */
+GST_START_TEST (test_socket_reactor_legacy)
+{
+  GstdIpc *tcp = start_tcp (TEST_PORT, 2);
+  GSocket *socket = client_connect (TEST_PORT);
+  gchar *response;
+  guint i;
+
+  for (i = 0; i < 3; i++) {
+    response = client_request (socket, "list_pipelines");
+    fail_if (NULL == strstr (response, "\"code\" : 0"));
+    g_free (response);
+  }
+
+  response = client_request (socket, "not_a_command");
+  fail_unless (NULL == strstr (response, "\"code\" : 0"));
+  g_free (response);
+
+  g_object_unref (socket);
+  stop_tcp (tcp);
+}
+GST_END_TEST;
+
+/*
+ * Test: The event loop backend switches to framed mode and answers
+ * pipelined frames in order
+ */
+GST_START_TEST (test_socket_reactor_framed)
+{
+  GstdIpc *tcp = start_tcp (TEST_PORT + 1, 1);
+  GSocket *socket = client_connect (TEST_PORT + 1);
+  gchar *response;
+  guint32 length;
+  guint32 id;
+  guint i;
+
+  response = client_request (socket, GSTD_SOCKET_FRAMED_HELLO);
+  fail_if (NULL == strstr (response, "\"protocol\" : \"framed\""));
+  g_free (response);
+
+  for (i = 0; i < 4; i++) {
+    client_send_frame (socket, 100 + i, "list_pipelines");
+  }
+
+  for (i = 0; i < 4; i++) {
+    response = client_read_frame (socket, &id, &length);
+    fail_unless_equals_int (id, 100 + i);
+    fail_if (NULL == strstr (response, "\"code\" : 0"));
+    g_free (response);
+  }
+
+  g_object_unref (socket);
+  stop_tcp (tcp);
+}
+GST_END_TEST;
+
+/*
+ * Test: A connection negotiated with the CBOR hello gets CBOR
+ * responses, on both backends
+ */
+GST_START_TEST (test_socket_cbor)
+{
+  /* {"code": 0, ... */
+  static const guint8 prefix[] = { 0xd9, 0xd9, 0xf7, 0xa3,
+    0x64, 'c', 'o', 'd', 'e', 0x00
+  };
+  GstdIpc *tcp;
+  GSocket *socket;
+  gchar *response;
+  guint32 length;
+  guint32 id;
+  gint io_threads;
+
+  for (io_threads = 0; io_threads < 2; io_threads++) {
+    tcp = start_tcp (TEST_PORT + 4 + io_threads, io_threads);
+    socket = client_connect (TEST_PORT + 4 + io_threads);
+
+    response = client_request (socket, GSTD_SOCKET_CBOR_HELLO);
+    fail_if (NULL == strstr (response, "\"encoding\" : \"cbor\""));
+    g_free (response);
+
+    client_send_cbor_frame (socket, 7, "list_pipelines");
+    response = client_read_frame (socket, &id, &length);
+    fail_unless_equals_int (id, 7);
+    fail_unless_equals_int (gstd_cbor_item_size ((const guint8 *) response,
+            length), length);
+    fail_if (memcmp (response, prefix, sizeof (prefix)));
+    g_free (response);
+
+    /* Malformed requests are answered with an error */
+    client_send_frame (socket, 8, "\xff");
+    response = client_read_frame (socket, &id, &length);
+    fail_unless_equals_int (id, 8);
+    fail_unless (0 == memcmp (response, prefix, sizeof (prefix) - 1));
+    fail_unless_equals_int ((guint8) response[sizeof (prefix) - 1],
+        GSTD_BAD_COMMAND);
+    g_free (response);
+
+    g_object_unref (socket);
+    stop_tcp (tcp);
+  }
+}
+GST_END_TEST;
+
+static guint64
+get_rss_kib (void)
+{
+  gchar *statm = NULL;
+  gulong resident = 0;
+
+  if (g_file_get_contents ("/proc/self/statm", &statm, NULL, NULL)) {
+    sscanf (statm, "%*u %lu", &resident);
+    g_free (statm);
+  }
+
+  return resident * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+static gint
+compare_gint64 (gconstpointer a, gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a;
+  gint64 y = *(const gint64 *) b;
+
+  return (x > y) - (x < y);
+}
+
+static void
+bench_backend (guint port, gint io_threads, guint count, guint64 * rss_kib,
+    gint64 * p99_us)
+{
+  const gchar *command = "list_pipelines";
+  GstdIpc *tcp = start_tcp (port, io_threads);
+  GSocket **clients = g_new0 (GSocket *, count);
+  gint64 *sent = g_new0 (gint64, count);
+  gint64 *latency = g_new0 (gint64, count * BENCH_ROUNDS);
+  gchar *response;
+  guint64 rss;
+  guint round;
+  guint i;
+
+  rss = get_rss_kib ();
+
+  /* Every client runs a command so the server sets it up completely */
+  for (i = 0; i < count; i++) {
+    clients[i] = client_connect (port);
+    response = client_request (clients[i], command);
+    g_free (response);
+  }
+  *rss_kib = get_rss_kib () - rss;
+
+  /* All the clients fire at once, then the responses are collected */
+  for (round = 0; round < BENCH_ROUNDS; round++) {
+    for (i = 0; i < count; i++) {
+      sent[i] = g_get_monotonic_time ();
+      client_send (clients[i], command, strlen (command));
+    }
+    for (i = 0; i < count; i++) {
+      response = client_read_response (clients[i]);
+      latency[round * count + i] = g_get_monotonic_time () - sent[i];
+      fail_if (NULL == strstr (response, "\"code\" : 0"));
+      g_free (response);
+    }
+  }
+
+  qsort (latency, count * BENCH_ROUNDS, sizeof (gint64), compare_gint64);
+  *p99_us = latency[(count * BENCH_ROUNDS * 99) / 100];
+
+  for (i = 0; i < count; i++) {
+    g_object_unref (clients[i]);
+  }
+  stop_tcp (tcp);
+
+  g_free (latency);
+  g_free (sent);
+  g_free (clients);
+}
+
+static void
+post_application_message (const gchar * pipeline)
+{
+  GstdObject *bus = NULL;
+  GstBus *gstbus;
+  gchar *uri;
+
+  uri = g_strdup_printf ("/pipelines/%s/bus", pipeline);
+  fail_if (gstd_get_by_uri (test_session, uri, &bus));
+  g_free (uri);
+
+  gstbus = gstd_pipeline_bus_get_bus (GSTD_PIPELINE_BUS (bus));
+  fail_unless (gst_bus_post (gstbus, gst_message_new_application (NULL,
+              gst_structure_new_empty ("ping"))));
+
+  gst_object_unref (gstbus);
+  g_object_unref (bus);
+}
+
+/*
+ * Test: A subscribed connection gets the bus messages pushed, leaving
+ * them in the bus, until the pipeline is deleted
+ */
+GST_START_TEST (test_socket_bus_subscribe)
+{
+  GstdIpc *tcp;
+  GSocket *control;
+  GSocket *subscriber;
+  GstdObject *bus;
+  GstMessage *message;
+  gchar *response;
+  gchar c;
+  gint io_threads;
+
+  for (io_threads = 0; io_threads < 2; io_threads++) {
+    tcp = start_tcp (TEST_PORT + 6 + io_threads, io_threads);
+    control = client_connect (TEST_PORT + 6 + io_threads);
+    subscriber = client_connect (TEST_PORT + 6 + io_threads);
+
+    response = client_request (control,
+        "pipeline_create sub_pipe fakesrc ! fakesink");
+    fail_if (NULL == strstr (response, "\"code\" : 0"));
+    g_free (response);
+
+    response = client_request (subscriber, "bus_subscribe missing_pipe");
+    fail_if (NULL != strstr (response, "\"code\" : 0"));
+    g_free (response);
+    g_object_unref (subscriber);
+    subscriber = client_connect (TEST_PORT + 6 + io_threads);
+
+    response = client_request (subscriber,
+        "bus_subscribe sub_pipe application");
+    fail_if (NULL == strstr (response, "\"code\" : 0"));
+    g_free (response);
+
+    post_application_message ("sub_pipe");
+
+    response = client_read_response (subscriber);
+    fail_if (NULL == strstr (response, "application"));
+    g_free (response);
+
+    /* The message is still there for bus_read */
+    fail_if (gstd_get_by_uri (test_session, "/pipelines/sub_pipe/bus", &bus));
+    message = gstd_pipeline_bus_pop (GSTD_PIPELINE_BUS (bus),
+        GST_MESSAGE_APPLICATION, 0);
+    fail_if (NULL == message);
+    gst_message_unref (message);
+    g_object_unref (bus);
+
+    /* Deleting the pipeline ends the stream */
+    response = client_request (control, "pipeline_delete sub_pipe");
+    fail_if (NULL == strstr (response, "\"code\" : 0"));
+    g_free (response);
+    fail_unless_equals_int (g_socket_receive (subscriber, &c, 1, NULL, NULL),
+        0);
+
+    g_object_unref (subscriber);
+    g_object_unref (control);
+    stop_tcp (tcp);
+  }
+}
+GST_END_TEST;
+
+/*
+ * Benchmark: Memory and p99 latency with many concurrent clients,
+ * thread per connection vs event loop
+ */
+GST_START_TEST (test_socket_concurrent_bench)
+{
+  struct rlimit limit;
+  guint count = BENCH_CONNECTIONS;
+  guint64 threaded_rss;
+  guint64 reactor_rss;
+  gint64 threaded_p99;
+  gint64 reactor_p99;
+
+  /* Both ends of every connection live in this process */
+  if (0 == getrlimit (RLIMIT_NOFILE, &limit)) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit (RLIMIT_NOFILE, &limit);
+    getrlimit (RLIMIT_NOFILE, &limit);
+    count = MIN (count, (limit.rlim_cur - 64) / 2);
+  }
+
+  bench_backend (TEST_PORT + 2, 0, count, &threaded_rss, &threaded_p99);
+  bench_backend (TEST_PORT + 3, 2, count, &reactor_rss, &reactor_p99);
+
+  g_print ("socket server, %u clients:\n", count);
+  g_print ("  thread per connection: %8" G_GUINT64_FORMAT " KiB RSS, p99 %8"
+      G_GINT64_FORMAT " us\n", threaded_rss, threaded_p99);
+  g_print ("  event loop:            %8" G_GUINT64_FORMAT " KiB RSS, p99 %8"
+      G_GINT64_FORMAT " us\n", reactor_rss, reactor_p99);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_socket_suite (void)
+{
+  Suite *suite = suite_create ("gstd_socket");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 60);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_socket_reactor_legacy);
+  tcase_add_test (tc, test_socket_reactor_framed);
+  tcase_add_test (tc, test_socket_cbor);
+  tcase_add_test (tc, test_socket_bus_subscribe);
+
+  /* Opens up to a thousand connections, only when asked for */
+  if (g_getenv ("GSTD_CHECK_BENCH")) {
+    TCase *bench = tcase_create ("bench");
+
+    suite_add_tcase (suite, bench);
+    tcase_set_timeout (bench, 120);
+    tcase_add_checked_fixture (bench, setup, teardown);
+    tcase_add_test (bench, test_socket_concurrent_bench);
+  }
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_socket);
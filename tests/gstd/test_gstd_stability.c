@@ -37,7 +37,7 @@
 
 /*
  * Test: State query returns valid state even during async transitions
- * This tests the 100ms timeout fix in gstd_state_read()
+ * Reads come from the transition record and never block
  */
 GST_START_TEST (test_state_query_during_transition)
 {
@@ -0,0 +1,244 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the standby pools:
+ * - A pipeline created with the description of a pool takes over one
+ *   of its instances, already in the parked state, and the pool
+ *   refills
+ * - Template instances are handed over with the parameters of the
+ *   creation, unless they can't be changed in the parked state
+ * - Broken descriptions and options are refused
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_session.h"
+
+static GstdSession *test_session = NULL;
+
+static void
+setup (void)
+{
+  test_session = gstd_session_new ("Test_session");
+}
+
+static void
+teardown (void)
+{
+  gst_object_unref (test_session);
+  test_session = NULL;
+}
+
+static GstdReturnCode
+create (const gchar * uri, const gchar * name, const gchar * description)
+{
+  GstdObject *node;
+  GstdReturnCode ret;
+
+  fail_if (gstd_get_by_uri (test_session, uri, &node));
+  ret = gstd_object_create (node, name, description);
+  g_object_unref (node);
+
+  return ret;
+}
+
+static GstdObject *
+get (const gchar * uri)
+{
+  GstdObject *node = NULL;
+
+  fail_if (gstd_get_by_uri (test_session, uri, &node), "No %s", uri);
+
+  return node;
+}
+
+/* Waits for the background refill */
+static void
+wait_available (GstdObject * standby, guint expected)
+{
+  gint64 deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  guint available = 0;
+
+  while (g_get_monotonic_time () < deadline) {
+    g_object_get (standby, "available", &available, NULL);
+    if (available == expected) {
+      return;
+    }
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+
+  fail ("%u pipelines available instead of %u", available, expected);
+}
+
+static GstState
+get_state (const gchar * name)
+{
+  GstdObject *node;
+  GstElement *element;
+  GstElement *pipeline;
+  gchar *uri = g_strdup_printf ("/pipelines/%s/elements/sink", name);
+  GstState state;
+
+  node = get (uri);
+  g_object_get (node, "gstelement", &element, NULL);
+  pipeline = GST_ELEMENT (gst_element_get_parent (element));
+  state = GST_STATE (pipeline);
+
+  gst_object_unref (pipeline);
+  gst_object_unref (element);
+  g_object_unref (node);
+  g_free (uri);
+
+  return state;
+}
+
+static guint64
+get_counter (GstdObject * standby, const gchar * counter)
+{
+  guint64 value = 0;
+
+  g_object_get (standby, counter, &value, NULL);
+
+  return value;
+}
+
+/*
+ * Test: Creations with the description of a pool are served from it
+ */
+GST_START_TEST (test_standby_claim)
+{
+  GstdObject *standby;
+
+  fail_unless_equals_int (GSTD_EOK, create ("/standby", "s0",
+          "size=2 state=paused fakesrc ! fakesink name=sink"));
+  standby = get ("/standby/s0");
+  wait_available (standby, 2);
+
+  fail_unless_equals_int (GSTD_EOK, create ("/pipelines", "p0",
+          "fakesrc ! fakesink name=sink"));
+  assert_equals_int (GST_STATE_PAUSED, get_state ("p0"));
+  assert_equals_uint64 (1, get_counter (standby, "claims"));
+
+  /* Another description is built as usual */
+  fail_unless_equals_int (GSTD_EOK, create ("/pipelines", "p1",
+          "fakesrc ! fakesink name=sink sync=true"));
+  assert_equals_int (GST_STATE_NULL, get_state ("p1"));
+  assert_equals_uint64 (1, get_counter (standby, "claims"));
+  assert_equals_uint64 (0, get_counter (standby, "misses"));
+
+  wait_available (standby, 2);
+
+  g_object_unref (standby);
+}
+GST_END_TEST;
+
+/*
+ * Test: Template instances get the parameters of the creation, those
+ * that can't change while paused are built as usual
+ */
+GST_START_TEST (test_standby_template)
+{
+  GstdObject *standby;
+  GstdObject *node;
+  GstElement *src;
+  gint num_buffers;
+
+  fail_unless_equals_int (GSTD_EOK, create ("/templates", "t0",
+          "fakesrc name=src num-buffers=${n} ! fakesink name=sink"));
+
+  fail_unless_equals_int (GSTD_EOK, create ("/standby", "s0",
+          "size=1 state=ready @t0 n=1"));
+  standby = get ("/standby/s0");
+  wait_available (standby, 1);
+
+  fail_unless_equals_int (GSTD_EOK, create ("/pipelines", "p0",
+          "@t0 n=5"));
+  assert_equals_uint64 (1, get_counter (standby, "claims"));
+  assert_equals_int (GST_STATE_READY, get_state ("p0"));
+
+  node = get ("/pipelines/p0/elements/src");
+  g_object_get (node, "gstelement", &src, NULL);
+  g_object_get (src, "num-buffers", &num_buffers, NULL);
+  assert_equals_int (5, num_buffers);
+  gst_object_unref (src);
+  g_object_unref (node);
+  g_object_unref (standby);
+
+  /* num-buffers can't be changed in PAUSED */
+  fail_unless_equals_int (GSTD_EOK, create ("/standby", "s1",
+          "size=1 state=paused @t0 n=1"));
+  standby = get ("/standby/s1");
+  wait_available (standby, 1);
+
+  fail_unless_equals_int (GSTD_EOK, create ("/pipelines", "p1",
+          "@t0 n=5"));
+  assert_equals_uint64 (1, get_counter (standby, "misses"));
+  assert_equals_int (GST_STATE_NULL, get_state ("p1"));
+
+  fail_unless_equals_int (GSTD_EOK, create ("/pipelines", "p2",
+          "@t0 n=1"));
+  assert_equals_uint64 (1, get_counter (standby, "claims"));
+  assert_equals_int (GST_STATE_PAUSED, get_state ("p2"));
+
+  g_object_unref (standby);
+}
+GST_END_TEST;
+
+/*
+ * Test: Broken descriptions and options are refused
+ */
+GST_START_TEST (test_standby_errors)
+{
+  fail_unless_equals_int (GSTD_BAD_DESCRIPTION, create ("/standby", "s0",
+          "fakesrc !"));
+  fail_unless_equals_int (GSTD_BAD_VALUE, create ("/standby", "s1",
+          "size=0 fakesrc ! fakesink"));
+  fail_unless_equals_int (GSTD_BAD_VALUE, create ("/standby", "s2",
+          "state=playing fakesrc ! fakesink"));
+  fail_unless_equals_int (GSTD_NO_RESOURCE, create ("/standby", "s3",
+          "@nope n=1"));
+  fail_unless_equals_int (GSTD_MISSING_ARGUMENT, create ("/standby", "s4",
+          "size=1"));
+}
+GST_END_TEST;
+
+static Suite *
+gstd_standby_suite (void)
+{
+  Suite *suite = suite_create ("gstd_standby");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 30);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_standby_claim);
+  tcase_add_test (tc, test_standby_template);
+  tcase_add_test (tc, test_standby_errors);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_standby);
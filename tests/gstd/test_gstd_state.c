@@ -25,6 +25,7 @@
 #include <gst/check/gstcheck.h>
 
 #include "gstd_session.h"
+#include "gstd_state.h"
 
 
 GST_START_TEST (test_success)
@@ -83,6 +84,169 @@ GST_START_TEST (test_failure)
 
 GST_END_TEST;
 
+/* Prerolling takes a second, long enough to look at the transition */
+#define SLOW_PIPELINE "fakesrc ! identity name=slow sleep-time=1000000 ! fakesink"
+
+static GstdObject *
+create_state (GstdSession * session, const gchar * description)
+{
+  GstdObject *node;
+
+  fail_if (gstd_get_by_uri (session, "/pipelines", &node));
+  fail_if (gstd_object_create (node, "p0", description));
+  gst_object_unref (node);
+
+  fail_if (gstd_get_by_uri (session, "/pipelines/p0/state", &node));
+
+  return node;
+}
+
+static gchar *
+read_state (GstdObject * state)
+{
+  gchar *output = NULL;
+
+  fail_if (gstd_object_to_string (state, &output));
+  fail_if (NULL == output);
+
+  return output;
+}
+
+GST_START_TEST (test_wait)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstdObject *state;
+  guint64 transition;
+  gchar *output;
+
+  state = create_state (test_session, "fakesrc ! fakesink sync=true");
+
+  /* Nothing in progress */
+  fail_if (gstd_state_wait (GSTD_STATE (state), 0, 0));
+
+  fail_if (gstd_object_update (state, "playing"));
+  g_object_get (state, "transition", &transition, NULL);
+  assert_equals_uint64 (1, transition);
+
+  fail_if (gstd_state_wait (GSTD_STATE (state), transition, 5 * GST_SECOND));
+
+  output = read_state (state);
+  fail_if (NULL == strstr (output, "PLAYING"));
+  fail_if (NULL == strstr (output, "\"done\""));
+  g_free (output);
+
+  gst_object_unref (state);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_wait_timeout)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstdObject *state;
+  GstdObject *wait = NULL;
+  guint64 transition;
+  gchar *output;
+
+  state = create_state (test_session, SLOW_PIPELINE);
+
+  fail_if (gstd_object_update (state, "paused"));
+  transition = gstd_state_get_transition (GSTD_STATE (state));
+
+  /* Still prerolling, reading doesn't block */
+  fail_unless_equals_int (GSTD_STATE_ERROR,
+      gstd_state_wait (GSTD_STATE (state), transition, 0));
+  output = read_state (state);
+  fail_if (NULL == strstr (output, "\"pending\""));
+  g_free (output);
+
+  fail_unless_equals_int (GSTD_STATE_ERROR,
+      gstd_state_wait (GSTD_STATE (state), transition, 10 * GST_MSECOND));
+
+  /* Not requested yet */
+  fail_unless_equals_int (GSTD_BAD_VALUE,
+      gstd_state_wait (GSTD_STATE (state), transition + 1, 0));
+
+  /* The wait resource waits for the latest one */
+  fail_if (gstd_object_read (state, "wait", &wait));
+  fail_unless (wait == state);
+  output = read_state (wait);
+  fail_if (NULL == strstr (output, "PAUSED"));
+  fail_if (NULL == strstr (output, "\"done\""));
+  g_free (output);
+  g_object_unref (wait);
+
+  fail_if (gstd_state_wait (GSTD_STATE (state), transition, 0));
+
+  gst_object_unref (state);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_wait_replaced)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstdObject *state;
+  guint64 transition;
+
+  state = create_state (test_session, SLOW_PIPELINE);
+
+  fail_if (gstd_object_update (state, "paused"));
+  transition = gstd_state_get_transition (GSTD_STATE (state));
+
+  /* A newer change ends the one still prerolling */
+  fail_if (gstd_object_update (state, "null"));
+  fail_unless_equals_int (GSTD_STATE_ERROR,
+      gstd_state_wait (GSTD_STATE (state), transition, 0));
+  fail_if (gstd_state_wait (GSTD_STATE (state), transition + 1,
+          5 * GST_SECOND));
+
+  gst_object_unref (state);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_wait_error)
+{
+  GstdSession *test_session = gstd_session_new ("Test Session");
+  GstdObject *state;
+  GstdObject *node;
+  GstElement *slow;
+  GError *error;
+  gchar *output;
+
+  state = create_state (test_session, SLOW_PIPELINE);
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/elements/slow",
+          &node));
+  g_object_get (node, "gstelement", &slow, NULL);
+  gst_object_unref (node);
+
+  fail_if (gstd_object_update (state, "playing"));
+
+  /* An error posted while prerolling ends the transition */
+  error = g_error_new_literal (GST_STREAM_ERROR, GST_STREAM_ERROR_FAILED,
+      "Test error");
+  gst_element_post_message (slow, gst_message_new_error (GST_OBJECT (slow),
+          error, NULL));
+  g_error_free (error);
+
+  fail_unless_equals_int (GSTD_STATE_ERROR,
+      gstd_state_wait (GSTD_STATE (state), 0, 5 * GST_SECOND));
+  output = read_state (state);
+  fail_if (NULL == strstr (output, "\"failed\""));
+  g_free (output);
+
+  gst_object_unref (slow);
+  gst_object_unref (state);
+  gst_object_unref (test_session);
+}
+
+GST_END_TEST;
+
 static Suite *
 gstd_state_suite (void)
 {
@@ -92,6 +256,10 @@ gstd_state_suite (void)
   suite_add_tcase (suite, tc);
   tcase_add_test (tc, test_success);
   tcase_add_test (tc, test_failure);
+  tcase_add_test (tc, test_wait);
+  tcase_add_test (tc, test_wait_timeout);
+  tcase_add_test (tc, test_wait_replaced);
+  tcase_add_test (tc, test_wait_error);
 
   return suite;
 }
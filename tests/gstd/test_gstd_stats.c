@@ -0,0 +1,228 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the pipeline stats:
+ * - Nothing is measured until enabled
+ * - Source pads count buffers and bytes, and the latency of elements
+ *   pushing from the thread that feeds them
+ * - Enabling again starts over
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/check/gstcheck.h>
+
+#include "gstd_session.h"
+#include "gstd_stats.h"
+
+static GstdSession *test_session = NULL;
+
+static void
+setup (void)
+{
+  test_session = gstd_session_new ("Test_session");
+}
+
+static void
+teardown (void)
+{
+  gst_object_unref (test_session);
+  test_session = NULL;
+}
+
+static void
+create (const gchar * name, const gchar * description)
+{
+  GstdObject *node;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines", &node));
+  fail_if (gstd_object_create (node, name, description));
+  g_object_unref (node);
+}
+
+static void
+update (const gchar * uri, const gchar * value)
+{
+  GstdObject *node;
+
+  fail_if (gstd_get_by_uri (test_session, uri, &node));
+  fail_if (gstd_object_update (node, value));
+  g_object_unref (node);
+}
+
+static GstPad *
+get_src_pad (const gchar * element)
+{
+  GstdObject *node;
+  GstElement *pipeline;
+  GstElement *child;
+  GstPad *pad;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0", &node));
+  pipeline = gstd_pipeline_get_element (GSTD_PIPELINE (node));
+  child = gst_bin_get_by_name (GST_BIN (pipeline), element);
+  fail_unless (child);
+  pad = gst_element_get_static_pad (child, "src");
+
+  gst_object_unref (child);
+  g_object_unref (node);
+
+  return pad;
+}
+
+/*
+ * Test: A pipeline isn't measured until its stats are enabled
+ */
+GST_START_TEST (test_stats_disabled)
+{
+  GstdObject *node;
+  GstPad *pad;
+  gchar *out = NULL;
+
+  create ("p0", "fakesrc num-buffers=10 ! fakesink");
+  update ("/pipelines/p0/state", "playing");
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/stats", &node));
+  pad = get_src_pad ("fakesrc0");
+  fail_if (gstd_stats_get_pad (GSTD_STATS (node), pad, NULL, NULL, NULL));
+
+  fail_if (gstd_object_to_string (node, &out));
+  fail_unless (strstr (out, "\"enabled\" : false"), "%s", out);
+
+  g_free (out);
+  gst_object_unref (pad);
+  g_object_unref (node);
+}
+GST_END_TEST;
+
+/*
+ * Test: Source pads count what they push once enabled
+ */
+GST_START_TEST (test_stats_counts)
+{
+  GstdObject *node;
+  GstPad *src;
+  GstPad *identity;
+  guint64 buffers = 0;
+  guint64 bytes = 0;
+  GstClockTime latency = GST_CLOCK_TIME_NONE;
+  gint64 deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  gchar *out = NULL;
+
+  create ("p0", "fakesrc num-buffers=10 sizetype=fixed sizemax=100 "
+      "! identity ! queue ! fakesink");
+  update ("/pipelines/p0/stats", "true");
+  update ("/pipelines/p0/state", "playing");
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/stats", &node));
+  src = get_src_pad ("fakesrc0");
+  identity = get_src_pad ("identity0");
+
+  /* The queue pushes from its own thread, wait for the last buffer */
+  while (g_get_monotonic_time () < deadline) {
+    if (gstd_stats_get_pad (GSTD_STATS (node), identity, &buffers, &bytes,
+            &latency) && 10 == buffers) {
+      break;
+    }
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+  assert_equals_uint64 (10, buffers);
+  assert_equals_uint64 (1000, bytes);
+
+  /* Fed by the source's thread, so measured */
+  fail_if (GST_CLOCK_TIME_NONE == latency);
+
+  /* Nothing feeds the source */
+  fail_unless (gstd_stats_get_pad (GSTD_STATS (node), src, &buffers, NULL,
+          &latency));
+  assert_equals_uint64 (10, buffers);
+  fail_unless (GST_CLOCK_TIME_NONE == latency);
+
+  fail_if (gstd_object_to_string (node, &out));
+  fail_unless (strstr (out, "\"enabled\" : true"), "%s", out);
+  fail_unless (strstr (out, "\"element\" : \"queue0\""), "%s", out);
+
+  g_free (out);
+  gst_object_unref (identity);
+  gst_object_unref (src);
+  g_object_unref (node);
+}
+GST_END_TEST;
+
+/*
+ * Test: Enabling again starts over
+ */
+GST_START_TEST (test_stats_restart)
+{
+  GstdObject *node;
+  GstPad *src;
+  guint64 buffers = 0;
+  gint64 deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+
+  create ("p0", "fakesrc num-buffers=10 ! fakesink");
+  update ("/pipelines/p0/stats", "true");
+  update ("/pipelines/p0/state", "playing");
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/stats", &node));
+  src = get_src_pad ("fakesrc0");
+
+  while (g_get_monotonic_time () < deadline) {
+    gstd_stats_get_pad (GSTD_STATS (node), src, &buffers, NULL, NULL);
+    if (10 == buffers) {
+      break;
+    }
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+  assert_equals_uint64 (10, buffers);
+
+  /* The source is done, nothing is pushed since */
+  update ("/pipelines/p0/stats", "false");
+  update ("/pipelines/p0/stats", "true");
+  fail_if (gstd_stats_get_pad (GSTD_STATS (node), src, NULL, NULL, NULL));
+
+  fail_unless_equals_int (GSTD_BAD_VALUE, gstd_object_update (node, "maybe"));
+
+  gst_object_unref (src);
+  g_object_unref (node);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_stats_suite (void)
+{
+  Suite *suite = suite_create ("gstd_stats");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 30);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_stats_disabled);
+  tcase_add_test (tc, test_stats_counts);
+  tcase_add_test (tc, test_stats_restart);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_stats);
@@ -0,0 +1,251 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the published pipeline status:
+ * - The document is shared and keeps its version while nothing changes
+ * - Creating, deleting and changing the state of a pipeline publish a
+ *   new version
+ * - Watches fire once on the next change and refuse stale versions
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/check/gstcheck.h>
+
+#include "gstd_session.h"
+#include "gstd_state.h"
+
+static GstdSession *test_session = NULL;
+
+static void
+setup (void)
+{
+  test_session = gstd_session_new ("Test_session");
+}
+
+static void
+teardown (void)
+{
+  gst_object_unref (test_session);
+  test_session = NULL;
+}
+
+static void
+create (const gchar * name, const gchar * description)
+{
+  GstdObject *node;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines", &node));
+  fail_if (gstd_object_create (node, name, description));
+  g_object_unref (node);
+}
+
+static gboolean
+contains (GBytes * document, const gchar * text)
+{
+  gchar *str = g_strndup (g_bytes_get_data (document, NULL),
+      g_bytes_get_size (document));
+  gboolean found = NULL != strstr (str, text);
+
+  g_free (str);
+
+  return found;
+}
+
+/* Waits for the state change to reach the bus */
+static GBytes *
+wait_version (guint64 previous, guint64 * version)
+{
+  gint64 deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  GBytes *document;
+
+  while (TRUE) {
+    document = gstd_status_get (test_session->status, version);
+    if (*version > previous || g_get_monotonic_time () > deadline) {
+      return document;
+    }
+    g_bytes_unref (document);
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+}
+
+static void
+count_change (gpointer user_data)
+{
+  g_atomic_int_inc ((gint *) user_data);
+}
+
+/*
+ * Test: Reads without changes share the same document
+ */
+GST_START_TEST (test_status_stable)
+{
+  GBytes *first;
+  GBytes *second;
+  guint64 version;
+  guint64 again;
+
+  first = gstd_status_get (test_session->status, &version);
+  second = gstd_status_get (test_session->status, &again);
+
+  assert_equals_uint64 (1, version);
+  assert_equals_uint64 (version, again);
+  fail_unless (first == second);
+  fail_unless (contains (first, "\"count\": 0"));
+
+  /* A change that doesn't touch this session keeps the version */
+  gstd_status_invalidate_all ();
+  g_bytes_unref (second);
+  second = gstd_status_get (test_session->status, &again);
+  assert_equals_uint64 (version, again);
+
+  g_bytes_unref (first);
+  g_bytes_unref (second);
+}
+GST_END_TEST;
+
+/*
+ * Test: Creations, state changes and deletions publish a new version
+ */
+GST_START_TEST (test_status_changes)
+{
+  GstdObject *node;
+  GBytes *document;
+  guint64 version;
+  guint64 previous;
+
+  document = gstd_status_get (test_session->status, &previous);
+  g_bytes_unref (document);
+
+  create ("p0", "fakesrc ! fakesink");
+  document = gstd_status_get (test_session->status, &version);
+  fail_unless (version > previous);
+  fail_unless (contains (document, "{\"name\": \"p0\", \"state\": \"NULL\"}"));
+  g_bytes_unref (document);
+  previous = version;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/state", &node));
+  fail_if (gstd_object_update (node, "paused"));
+  g_object_unref (node);
+
+  document = wait_version (previous, &version);
+  fail_unless (version > previous);
+  g_bytes_unref (document);
+
+  /* Ends up paused once the last change arrives */
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0/state", &node));
+  fail_if (gstd_state_wait (GSTD_STATE (node), 0, 5 * GST_SECOND));
+  g_object_unref (node);
+  document = gstd_status_get (test_session->status, &version);
+  fail_unless (contains (document, "\"state\": \"PAUSED\""));
+  g_bytes_unref (document);
+  previous = version;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines", &node));
+  fail_if (gstd_object_delete (node, "p0"));
+  g_object_unref (node);
+
+  document = gstd_status_get (test_session->status, &version);
+  fail_unless (version > previous);
+  fail_if (contains (document, "\"state\": \"PAUSED\""));
+  g_bytes_unref (document);
+}
+GST_END_TEST;
+
+/*
+ * Test: Pipeline names are escaped in the document
+ */
+GST_START_TEST (test_status_escaped)
+{
+  GBytes *document;
+  guint64 version;
+
+  create ("q\"0\\", "fakesrc ! fakesink");
+  document = gstd_status_get (test_session->status, &version);
+  fail_unless (contains (document, "{\"name\": \"q\\\"0\\\\\", "));
+  g_bytes_unref (document);
+}
+GST_END_TEST;
+
+/*
+ * Test: Watches fire once and only on the current version
+ */
+GST_START_TEST (test_status_watch)
+{
+  GBytes *document;
+  guint64 version;
+  gint changes = 0;
+  guint id;
+
+  document = gstd_status_get (test_session->status, &version);
+  g_bytes_unref (document);
+
+  /* A stale version must read again */
+  assert_equals_int (0, gstd_status_watch (test_session->status, version - 1,
+          count_change, &changes));
+
+  id = gstd_status_watch (test_session->status, version, count_change,
+      &changes);
+  fail_unless (id);
+
+  create ("p0", "fakesrc ! fakesink");
+  assert_equals_int (1, g_atomic_int_get (&changes));
+  fail_if (gstd_status_unwatch (id));
+
+  /* Until read, the change is pending */
+  assert_equals_int (0, gstd_status_watch (test_session->status, version,
+          count_change, &changes));
+
+  document = gstd_status_get (test_session->status, &version);
+  g_bytes_unref (document);
+
+  id = gstd_status_watch (test_session->status, version, count_change,
+      &changes);
+  fail_unless (id);
+  fail_unless (gstd_status_unwatch (id));
+
+  create ("p1", "fakesrc ! fakesink");
+  assert_equals_int (1, g_atomic_int_get (&changes));
+}
+GST_END_TEST;
+
+static Suite *
+gstd_status_suite (void)
+{
+  Suite *suite = suite_create ("gstd_status");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 30);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_status_stable);
+  tcase_add_test (tc, test_status_changes);
+  tcase_add_test (tc, test_status_escaped);
+  tcase_add_test (tc, test_status_watch);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_status);
@@ -0,0 +1,241 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for the pipeline templates:
+ * - Flat descriptions are compiled, their instances get the values of
+ *   the placeholders and the rest of the description
+ * - Request pads are linked again on every instance
+ * - Descriptions with bins are instantiated through the parser
+ * - Missing, unknown and invalid parameters are refused
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_template.h"
+
+static GstdTemplate *
+build (const gchar * description, GstdReturnCode expected)
+{
+  GstdTemplate *template = g_object_new (GSTD_TYPE_TEMPLATE, "name", "t0",
+      "description", description, NULL);
+
+  fail_unless_equals_int (expected, gstd_template_build (template));
+
+  return template;
+}
+
+static gboolean
+compiled (GstdTemplate * template)
+{
+  gboolean compiled;
+
+  g_object_get (template, "compiled", &compiled, NULL);
+
+  return compiled;
+}
+
+static GstElement *
+instantiate (GstdTemplate * template, const gchar * parameters)
+{
+  GstElement *pipeline = NULL;
+
+  fail_unless_equals_int (GSTD_EOK, gstd_template_instantiate (template,
+          parameters, &pipeline));
+  fail_if (NULL == pipeline);
+
+  return pipeline;
+}
+
+static GstElement *
+get_child (GstElement * pipeline, const gchar * name)
+{
+  GstElement *element = gst_bin_get_by_name (GST_BIN (pipeline), name);
+
+  fail_if (NULL == element, "No %s element", name);
+  gst_object_unref (element);
+
+  return element;
+}
+
+/*
+ * Test: A flat description is compiled and its instances get both the
+ * placeholder values and the fixed properties
+ */
+GST_START_TEST (test_template_compiled)
+{
+  GstdTemplate *template;
+  GstElement *pipeline;
+  GstPad *pad;
+  gchar *parameters;
+  gint num_buffers;
+  gboolean silent;
+  gboolean sync;
+
+  template = build ("fakesrc num-buffers=${n} ! identity name=id "
+      "silent=false ! fakesink sync=${sync}", GSTD_EOK);
+  fail_unless (compiled (template));
+
+  g_object_get (template, "parameters", &parameters, NULL);
+  fail_unless_equals_string ("n sync", parameters);
+  g_free (parameters);
+
+  pipeline = instantiate (template, "n=5 sync=true");
+
+  g_object_get (get_child (pipeline, "fakesrc_1"), "num-buffers",
+      &num_buffers, NULL);
+  assert_equals_int (5, num_buffers);
+  g_object_get (get_child (pipeline, "id"), "silent", &silent, NULL);
+  fail_if (silent);
+  g_object_get (get_child (pipeline, "fakesink_3"), "sync", &sync, NULL);
+  fail_unless (sync);
+
+  pad = gst_element_get_static_pad (get_child (pipeline, "id"), "sink");
+  fail_unless (gst_pad_is_linked (pad));
+  gst_object_unref (pad);
+
+  gst_object_unref (pipeline);
+  g_object_unref (template);
+}
+GST_END_TEST;
+
+/*
+ * Test: Every instance requests and links its own tee pads
+ */
+GST_START_TEST (test_template_request_pads)
+{
+  GstdTemplate *template;
+  GstElement *pipeline;
+  GstElement *tee;
+  guint i;
+
+  template = build ("fakesrc num-buffers=${n} ! tee name=t "
+      "t. ! queue ! fakesink t. ! queue ! fakesink", GSTD_EOK);
+  fail_unless (compiled (template));
+
+  for (i = 0; i < 2; i++) {
+    pipeline = instantiate (template, "n=1");
+    tee = get_child (pipeline, "t");
+    assert_equals_int (2, tee->numsrcpads);
+    fail_unless (gst_pad_is_linked (tee->srcpads->data));
+    fail_unless (gst_pad_is_linked (tee->srcpads->next->data));
+    gst_object_unref (pipeline);
+  }
+
+  g_object_unref (template);
+}
+GST_END_TEST;
+
+/*
+ * Test: Values are taken literally, spaces and all
+ */
+GST_START_TEST (test_template_quoted)
+{
+  GstdTemplate *template;
+  GstElement *pipeline;
+  gchar *location;
+
+  template = build ("filesrc name=src location=\"/tmp/${dir}/${id}.bin\" "
+      "! fakesink", GSTD_EOK);
+
+  pipeline = instantiate (template, "id=\"a \\\"b\\\"\" dir=x");
+  g_object_get (get_child (pipeline, "src"), "location", &location, NULL);
+  fail_unless_equals_string ("/tmp/x/a \"b\".bin", location);
+  g_free (location);
+
+  gst_object_unref (pipeline);
+  g_object_unref (template);
+}
+GST_END_TEST;
+
+/*
+ * Test: Bins are left to the parser, with the values quoted in
+ */
+GST_START_TEST (test_template_parsed)
+{
+  GstdTemplate *template;
+  GstElement *pipeline;
+  gint num_buffers;
+
+  template = build ("fakesrc num-buffers=${n} ! fakesink "
+      "( name=b fakesrc ! fakesink )", GSTD_EOK);
+  fail_if (compiled (template));
+
+  pipeline = instantiate (template, "n=7");
+  g_object_get (get_child (pipeline, "fakesrc_1"), "num-buffers",
+      &num_buffers, NULL);
+  assert_equals_int (7, num_buffers);
+  get_child (pipeline, "b");
+
+  gst_object_unref (pipeline);
+  g_object_unref (template);
+}
+GST_END_TEST;
+
+/*
+ * Test: Broken descriptions and parameters are refused
+ */
+GST_START_TEST (test_template_errors)
+{
+  GstdTemplate *template;
+  GstElement *pipeline = NULL;
+
+  g_object_unref (build ("fakesrc nope=${n} ! fakesink",
+          GSTD_BAD_DESCRIPTION));
+  g_object_unref (build ("fakesrc num-buffers=${n ! fakesink",
+          GSTD_BAD_DESCRIPTION));
+  g_object_unref (build ("${n} ! fakesink", GSTD_BAD_DESCRIPTION));
+
+  template = build ("fakesrc num-buffers=${n} ! fakesink", GSTD_EOK);
+
+  fail_unless_equals_int (GSTD_MISSING_ARGUMENT,
+      gstd_template_instantiate (template, NULL, &pipeline));
+  fail_unless_equals_int (GSTD_BAD_VALUE,
+      gstd_template_instantiate (template, "n=1 x=2", &pipeline));
+  fail_unless_equals_int (GSTD_BAD_VALUE,
+      gstd_template_instantiate (template, "n=many", &pipeline));
+  fail_unless (NULL == pipeline);
+
+  g_object_unref (template);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_template_suite (void)
+{
+  Suite *suite = suite_create ("gstd_template");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+
+  tcase_add_test (tc, test_template_compiled);
+  tcase_add_test (tc, test_template_request_pads);
+  tcase_add_test (tc, test_template_quoted);
+  tcase_add_test (tc, test_template_parsed);
+  tcase_add_test (tc, test_template_errors);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_template);
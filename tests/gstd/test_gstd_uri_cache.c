@@ -0,0 +1,142 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tests for URI resolution in gstd_get_by_uri:
+ * - Repeated lookups of the same URI resolve to the same node
+ * - Creating or deleting a pipeline invalidates cached nodes
+ * - Non cacheable resources (bus messages) are resolved every time
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include "gstd_session.h"
+
+static GstdSession *test_session = NULL;
+
+static void
+setup (void)
+{
+  GstdObject *node;
+
+  test_session = gstd_session_new ("URI Cache Test Session");
+  fail_if (NULL == test_session);
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines", &node));
+  fail_if (gstd_object_create (node, "p0", "fakesrc name=src ! fakesink"));
+  gst_object_unref (node);
+}
+
+static void
+teardown (void)
+{
+  g_object_unref (test_session);
+  test_session = NULL;
+}
+
+/*
+ * Test: A cached URI resolves to the same node
+ */
+GST_START_TEST (test_uri_cache_hit)
+{
+  GstdObject *first;
+  GstdObject *second;
+  const gchar *uri = "/pipelines/p0/elements/src/properties/num-buffers";
+
+  fail_if (gstd_get_by_uri (test_session, uri, &first));
+  fail_if (gstd_get_by_uri (test_session, uri, &second));
+  fail_unless (first == second);
+  fail_unless_equals_string (GSTD_OBJECT_NAME (first), "num-buffers");
+
+  /* Same node through a non normalized URI */
+  gst_object_unref (second);
+  fail_if (gstd_get_by_uri (test_session,
+          "pipelines//p0/elements/src/properties/num-buffers/", &second));
+  fail_unless (first == second);
+
+  gst_object_unref (first);
+  gst_object_unref (second);
+}
+GST_END_TEST;
+
+/*
+ * Test: Deleting and recreating a pipeline invalidates cached nodes
+ */
+GST_START_TEST (test_uri_cache_invalidate)
+{
+  GstdObject *pipelines;
+  GstdObject *first;
+  GstdObject *second;
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0", &first));
+
+  fail_if (gstd_get_by_uri (test_session, "/pipelines", &pipelines));
+  fail_if (gstd_object_delete (pipelines, "p0"));
+
+  fail_unless_equals_int (gstd_get_by_uri (test_session, "/pipelines/p0",
+          &second), GSTD_BAD_COMMAND);
+
+  fail_if (gstd_object_create (pipelines, "p0", "fakesrc ! fakesink"));
+  fail_if (gstd_get_by_uri (test_session, "/pipelines/p0", &second));
+  fail_if (first == second);
+
+  gst_object_unref (first);
+  gst_object_unref (second);
+  gst_object_unref (pipelines);
+}
+GST_END_TEST;
+
+/*
+ * Test: Invalid URIs are reported and never cached
+ */
+GST_START_TEST (test_uri_cache_invalid)
+{
+  GstdObject *node = NULL;
+
+  fail_unless_equals_int (gstd_get_by_uri (test_session,
+          "/pipelines/p0/elements/nope", &node), GSTD_BAD_COMMAND);
+  fail_unless_equals_int (gstd_get_by_uri (test_session,
+          "/pipelines/p0/elements/nope", &node), GSTD_BAD_COMMAND);
+  fail_unless (NULL == node);
+}
+GST_END_TEST;
+
+static Suite *
+gstd_uri_cache_suite (void)
+{
+  Suite *suite = suite_create ("gstd_uri_cache");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+  tcase_set_timeout (tc, 30);
+  tcase_add_checked_fixture (tc, setup, teardown);
+
+  tcase_add_test (tc, test_uri_cache_hit);
+  tcase_add_test (tc, test_uri_cache_invalidate);
+  tcase_add_test (tc, test_uri_cache_invalid);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (gstd_uri_cache);
@@ -0,0 +1,60 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Framed and CBOR socket calls for the tests that mock the socket.
+ * Each test mocks new, free and send itself, these make the mock
+ * daemon reject the hellos so every request goes through send as JSON.
+ */
+
+#include "libgstc.h"
+#include "libgstc_socket.h"
+
+GstcStatus
+gstc_socket_enable_framing (GstcSocket * socket, const int timeout)
+{
+  return GSTC_UNSUPPORTED;
+}
+
+GstcStatus
+gstc_socket_enable_cbor (GstcSocket * socket, const int timeout)
+{
+  return GSTC_UNSUPPORTED;
+}
+
+GstcStatus
+gstc_socket_submit (GstcSocket * socket, const char *request,
+    unsigned int *id)
+{
+  return GSTC_UNSUPPORTED;
+}
+
+GstcStatus
+gstc_socket_receive (GstcSocket * socket, unsigned int *id, char **response,
+    const int timeout)
+{
+  return GSTC_UNSUPPORTED;
+}
+
+unsigned int
+gstc_socket_get_pending (GstcSocket * socket)
+{
+  return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * This file is part of GStreamer Daemon
+ * Copyright 2015-2022 Ridgerun, LLC (http://www.ridgerun.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <gst/check/gstcheck.h>
+#include <string.h>
+
+#include "libgstc.h"
+#include "libgstc_json.h"
+#include "libgstc_socket.h"
+#include "libgstc_assert.h"
+
+/* Test Fixture */
+static gchar _request[512];
+static GstClient *_client;
+static GstcBatch *_batch;
+
+/* Codes reported by the mock daemon */
+static const int _codes[] = { 0, 0, 5 };
+
+static int _code;
+static int _executed;
+
+static void
+setup (void)
+{
+  const gchar *address = "";
+  unsigned int port = 0;
+  unsigned long wait_time = 5;
+  int keep_connection_open = 0;
+
+  gstc_client_new (address, port, wait_time, keep_connection_open, &_client);
+  gstc_batch_new (&_batch, 0);
+
+  memset (_request, 0, sizeof (_request));
+  _code = GSTC_OK;
+  _executed = 3;
+}
+
+static void
+teardown (void)
+{
+  gstc_batch_free (_batch);
+  gstc_client_free (_client);
+}
+
+/* Mock implementation of a socket */
+typedef struct _GstcSocket
+{
+} GstcSocket;
+
+GstcSocket _socket;
+
+GstcStatus
+gstc_socket_new (const char *address, const unsigned int port,
+    const int keep_connection_open, GstcSocket ** out)
+{
+  *out = &_socket;
+
+  return GSTC_OK;
+}
+
+void
+gstc_socket_free (GstcSocket * socket)
+{
+}
+
+GstcStatus
+gstc_socket_send (GstcSocket * socket, const gchar * request, gchar ** response,
+    const int timeout)
+{
+  *response = malloc (1);
+
+  memcpy (_request, request, strlen (request));
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_json_get_int (const gchar * json, const gchar * name, gint * out)
+{
+  *out = _code;
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_json_is_null (const gchar * json, const gchar * name, gint * out)
+{
+  *out = 0;
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_json_get_child_char_array (const char *json, const char *parent_name,
+    const char *array_name, const char *element_name, char **out[],
+    int *array_lenght)
+{
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_json_get_child_int_array (const char *json, const char *parent_name,
+    const char *array_name, int *out, int max_lenght, int *array_lenght)
+{
+  int i;
+
+  gstc_assert_and_ret_val (NULL != json, GSTC_NULL_ARGUMENT);
+  assert_equals_string ("response", parent_name);
+  assert_equals_string ("codes", array_name);
+
+  for (i = 0; i < _executed && i < max_lenght; i++) {
+    out[i] = _codes[i];
+  }
+  *array_lenght = _executed;
+
+  return GSTC_OK;
+}
+
+GstcStatus
+gstc_json_child_string (const char *json, const char *parent_name,
+    const char *data_name, char **out)
+{
+  gstc_assert_and_ret_val (NULL != json, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != parent_name, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != data_name, GSTC_NULL_ARGUMENT);
+  gstc_assert_and_ret_val (NULL != out, GSTC_NULL_ARGUMENT);
+
+  return GSTC_OK;
+}
+
+GST_START_TEST (test_batch_request)
+{
+  GstcStatus ret;
+  const gchar *expected = "batch \n"
+      "element_set pipe elem prop 54321\n"
+      "element_set pipe elem caps video/x-raw,width=1920\n"
+      "pipeline_play pipe";
+
+  ret = gstc_batch_element_set (_batch, "pipe", "elem", "prop", "%d", 54321);
+  assert_equals_int (GSTC_OK, ret);
+  ret = gstc_batch_element_set (_batch, "pipe", "elem", "caps",
+      "video/x-raw,width=%d", 1920);
+  assert_equals_int (GSTC_OK, ret);
+  ret = gstc_batch_pipeline_play (_batch, "pipe");
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_int (3, gstc_batch_get_length (_batch));
+
+  ret = gstc_batch_execute (_client, _batch, NULL, NULL);
+  assert_equals_int (GSTC_OK, ret);
+
+  assert_equals_string (expected, _request);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_batch_stop_on_error)
+{
+  GstcStatus ret;
+  GstcBatch *batch;
+  const gchar *expected = "batch stop_on_error\n"
+      "pipeline_pause pipe\npipeline_stop pipe";
+
+  ret = gstc_batch_new (&batch, 1);
+  assert_equals_int (GSTC_OK, ret);
+
+  gstc_batch_pipeline_pause (batch, "pipe");
+  gstc_batch_pipeline_stop (batch, "pipe");
+
+  ret = gstc_batch_execute (_client, batch, NULL, NULL);
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_string (expected, _request);
+
+  gstc_batch_free (batch);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_batch_codes)
+{
+  GstcStatus ret;
+  int codes[3] = { -1, -1, -1 };
+  int executed = 0;
+
+  gstc_batch_add (_batch, "element_set pipe elem prop %d", 1);
+  gstc_batch_add (_batch, "element_set pipe elem prop %d", 2);
+  gstc_batch_add (_batch, "element_set pipe nope prop %d", 3);
+
+  /* The batch fails with its first failing operation */
+  _code = 5;
+  ret = gstc_batch_execute (_client, _batch, codes, &executed);
+  assert_equals_int (5, ret);
+
+  assert_equals_int (3, executed);
+  assert_equals_int (0, codes[0]);
+  assert_equals_int (0, codes[1]);
+  assert_equals_int (5, codes[2]);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_batch_multiline)
+{
+  GstcStatus ret;
+
+  ret = gstc_batch_element_set (_batch, "pipe", "elem", "prop", "%s",
+      "two\nlines");
+  assert_equals_int (GSTC_MALFORMED, ret);
+  assert_equals_int (0, gstc_batch_get_length (_batch));
+}
+
+GST_END_TEST;
+
+static Suite *
+libgstc_batch_suite (void)
+{
+  Suite *suite = suite_create ("libgstc_batch");
+  TCase *tc = tcase_create ("general");
+
+  suite_add_tcase (suite, tc);
+
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_batch_request);
+  tcase_add_test (tc, test_batch_stop_on_error);
+  tcase_add_test (tc, test_batch_codes);
+  tcase_add_test (tc, test_batch_multiline);
+
+  return suite;
+}
+
+GST_CHECK_MAIN (libgstc_batch);
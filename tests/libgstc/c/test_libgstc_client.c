@@ -18,6 +18,7 @@
  * Boston, MA 02110-1301, USA.
  */
 #include <gst/check/gstcheck.h>
+#include <string.h>
 
 #include "libgstc.h"
 #include "libgstc_socket.h"
@@ -27,11 +28,34 @@
 /* Mock implementation of a socket */
 typedef struct _GstcSocket
 {
+  /* Requests in flight, a connection is never shared by two threads */
+  gint in_use;
 } GstcSocket;
 
-static GstcSocket _socket;
+/* Requests to this pipeline are rejected by the mock daemon */
+#define FAIL_PIPELINE "fail"
+/* Any positive code is an error reported by the daemon */
+#define MOCK_DAEMON_ERROR 2
+
 static gboolean _fail_socket = FALSE;
 
+/* Guards the mock daemon state below */
+static GMutex _mock_lock;
+static GCond _mock_cond;
+/* Connections open, and the most there were at the same time */
+static gint _open_sockets = 0;
+static gint _max_open_sockets = 0;
+/* Set if a connection was used by two requests at the same time */
+static gboolean _shared_socket = FALSE;
+/* Microseconds each request takes */
+static gulong _request_delay = 0;
+/* Requests sent so far */
+static gint _requests = 0;
+/* Requests containing this are held until the gate is opened */
+static const gchar *_gated = NULL;
+static gboolean _gate_open = TRUE;
+static gint _gated_requests = 0;
+
 GstcStatus
 gstc_socket_new (const char *address, const unsigned int port,
     const int keep_connection_open, GstcSocket ** out)
@@ -39,22 +63,60 @@ gstc_socket_new (const char *address, const unsigned int port,
   if (_fail_socket) {
     *out = NULL;
     return GSTC_SOCKET_ERROR;
-  } else {
-    *out = &_socket;
-    return GSTC_OK;
   }
+
+  *out = g_new0 (GstcSocket, 1);
+
+  g_mutex_lock (&_mock_lock);
+  _open_sockets++;
+  _max_open_sockets = MAX (_max_open_sockets, _open_sockets);
+  g_mutex_unlock (&_mock_lock);
+
+  return GSTC_OK;
 }
 
 void
 gstc_socket_free (GstcSocket * socket)
 {
+  g_mutex_lock (&_mock_lock);
+  _open_sockets--;
+  g_mutex_unlock (&_mock_lock);
+
+  g_free (socket);
 }
 
 GstcStatus
 gstc_socket_send (GstcSocket * socket, const gchar * request, gchar ** response,
     const int timeout)
 {
-  *response = malloc (1);
+  g_mutex_lock (&_mock_lock);
+
+  if (socket->in_use++) {
+    _shared_socket = TRUE;
+  }
+  _requests++;
+
+  if (NULL != _gated && NULL != strstr (request, _gated)) {
+    _gated_requests++;
+    g_cond_broadcast (&_mock_cond);
+    while (!_gate_open) {
+      g_cond_wait (&_mock_cond, &_mock_lock);
+    }
+  }
+
+  g_mutex_unlock (&_mock_lock);
+
+  if (_request_delay) {
+    g_usleep (_request_delay);
+  }
+
+  /* The request is echoed so the code can be told from it */
+  *response = malloc (strlen (request) + 1);
+  strcpy (*response, request);
+
+  g_mutex_lock (&_mock_lock);
+  socket->in_use--;
+  g_mutex_unlock (&_mock_lock);
 
   return GSTC_OK;
 }
@@ -62,7 +124,13 @@ gstc_socket_send (GstcSocket * socket, const gchar * request, gchar ** response,
 GstcStatus
 gstc_json_get_int (const gchar * json, const gchar * name, gint * out)
 {
-  return *out = GSTC_OK;
+  if (NULL != strstr (json, "/" FAIL_PIPELINE "/")) {
+    *out = MOCK_DAEMON_ERROR;
+  } else {
+    *out = GSTC_OK;
+  }
+
+  return GSTC_OK;
 }
 
 GstcStatus
@@ -86,6 +154,13 @@ gstc_json_get_child_char_array (const char *json, const char *parent_name,
   return GSTC_OK;
 }
 
+GstcStatus
+gstc_json_get_child_int_array (const char *json, const char *parent_name,
+    const char *array_name, int *out, int max_lenght, int *array_lenght)
+{
+  return GSTC_OK;
+}
+
 GstcStatus
 gstc_json_child_string (const char *json, const char *parent_name,
     const char *data_name, char **out)
@@ -116,6 +191,34 @@ setup (void)
 {
   _use_mock_malloc = FALSE;
   _fail_socket = FALSE;
+  _open_sockets = 0;
+  _max_open_sockets = 0;
+  _shared_socket = FALSE;
+  _request_delay = 0;
+  _requests = 0;
+  _gated = NULL;
+  _gate_open = TRUE;
+  _gated_requests = 0;
+}
+
+/* Waits until @count requests are held by the gate */
+static void
+wait_gated_requests (gint count)
+{
+  g_mutex_lock (&_mock_lock);
+  while (_gated_requests < count) {
+    g_cond_wait (&_mock_cond, &_mock_lock);
+  }
+  g_mutex_unlock (&_mock_lock);
+}
+
+static void
+open_gate (void)
+{
+  g_mutex_lock (&_mock_lock);
+  _gate_open = TRUE;
+  g_cond_broadcast (&_mock_cond);
+  g_mutex_unlock (&_mock_lock);
 }
 
 static void
@@ -222,6 +325,366 @@ GST_START_TEST (test_client_no_socket)
 
 GST_END_TEST;
 
+GST_START_TEST (test_client_encoding_unsupported)
+{
+  GstClient *client;
+  GstcStatus ret;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  /* The mock daemon doesn't know the CBOR hello */
+  ret = gstc_client_set_encoding (client, GSTC_ENCODING_CBOR);
+  assert_equals_int (GSTC_UNSUPPORTED, ret);
+
+  ret = gstc_client_set_encoding (client, GSTC_ENCODING_JSON);
+  assert_equals_int (GSTC_OK, ret);
+
+  gstc_client_free (client);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_client_max_connections)
+{
+  GstClient *client;
+  GstcStatus ret;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_client_set_max_connections (client, 0);
+  assert_equals_int (GSTC_TYPE_ERROR, ret);
+
+  ret = gstc_client_set_max_connections (client, 8);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_client_set_max_connections (client, 1);
+  assert_equals_int (GSTC_OK, ret);
+
+  /* The connection left is still usable */
+  ret = gstc_client_ping (client);
+  assert_equals_int (GSTC_OK, ret);
+
+  gstc_client_free (client);
+}
+
+GST_END_TEST;
+
+#define CLIENT_THREADS 8
+#define THREAD_REQUESTS 20
+
+static gpointer
+ping_thread (gpointer user_data)
+{
+  GstClient *client = (GstClient *) user_data;
+  gint failures = 0;
+  gint i;
+
+  for (i = 0; i < THREAD_REQUESTS; i++) {
+    if (GSTC_OK != gstc_client_ping (client)) {
+      failures++;
+    }
+  }
+
+  return GINT_TO_POINTER (failures);
+}
+
+GST_START_TEST (test_client_concurrent_requests)
+{
+  GstClient *client;
+  GThread *threads[CLIENT_THREADS];
+  GstcStatus ret;
+  gint i;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_client_set_max_connections (client, 2);
+  assert_equals_int (GSTC_OK, ret);
+
+  _request_delay = 1000;
+
+  for (i = 0; i < CLIENT_THREADS; i++) {
+    threads[i] = g_thread_new (NULL, ping_thread, client);
+  }
+
+  for (i = 0; i < CLIENT_THREADS; i++) {
+    assert_equals_int (0, GPOINTER_TO_INT (g_thread_join (threads[i])));
+  }
+
+  /* The threads took turns over no more than the connections allowed */
+  fail_if (_shared_socket);
+  fail_unless (_max_open_sockets <= 2);
+
+  gstc_client_free (client);
+  assert_equals_int (0, _open_sockets);
+}
+
+GST_END_TEST;
+
+static gpointer
+play_thread (gpointer user_data)
+{
+  GstClient *client = (GstClient *) user_data;
+
+  return GINT_TO_POINTER (gstc_pipeline_play (client, "blocked"));
+}
+
+GST_START_TEST (test_client_wait_connection)
+{
+  GstClient *client;
+  GThread *blocked;
+  GThread *waiting;
+  GstcStatus ret;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_client_set_max_connections (client, 1);
+  assert_equals_int (GSTC_OK, ret);
+
+  _gated = "/blocked/";
+  _gate_open = FALSE;
+
+  /* Hold the only connection in the daemon */
+  blocked = g_thread_new (NULL, play_thread, client);
+  wait_gated_requests (1);
+
+  /* Nothing is sent until the connection is released */
+  waiting = g_thread_new (NULL, ping_thread, client);
+  g_usleep (G_USEC_PER_SEC / 20);
+  fail_if (_shared_socket);
+  assert_equals_int (1, _max_open_sockets);
+
+  open_gate ();
+
+  assert_equals_int (GSTC_OK, GPOINTER_TO_INT (g_thread_join (blocked)));
+  assert_equals_int (0, GPOINTER_TO_INT (g_thread_join (waiting)));
+
+  fail_if (_shared_socket);
+  assert_equals_int (1, _max_open_sockets);
+
+  gstc_client_free (client);
+}
+
+GST_END_TEST;
+
+typedef struct _BusData BusData;
+struct _BusData
+{
+  GMutex lock;
+  GCond cond;
+  gboolean done;
+  gchar *message;
+};
+
+static GstcStatus
+bus_callback (GstClient * client, const char *pipeline_name,
+    const char *message_name, const long long timeout, char *message,
+    void *user_data)
+{
+  BusData *data = (BusData *) user_data;
+
+  g_mutex_lock (&data->lock);
+  data->message = g_strdup (message);
+  data->done = TRUE;
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  return GSTC_OK;
+}
+
+GST_START_TEST (test_client_bus_wait_async_commands)
+{
+  GstClient *client;
+  GThread *threads[CLIENT_THREADS];
+  BusData data;
+  GstcStatus ret;
+  gint i;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.done = FALSE;
+  data.message = NULL;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_client_set_max_connections (client, 1);
+  assert_equals_int (GSTC_OK, ret);
+
+  _gated = "bus_read_since";
+  _gate_open = FALSE;
+
+  ret = gstc_pipeline_bus_wait_async (client, "pipe", "eos", -1,
+      bus_callback, &data);
+  assert_equals_int (GSTC_OK, ret);
+  wait_gated_requests (1);
+
+  /* The pending read doesn't take the connection commands go through */
+  for (i = 0; i < CLIENT_THREADS; i++) {
+    threads[i] = g_thread_new (NULL, ping_thread, client);
+  }
+
+  for (i = 0; i < CLIENT_THREADS; i++) {
+    assert_equals_int (0, GPOINTER_TO_INT (g_thread_join (threads[i])));
+  }
+
+  fail_if (_shared_socket);
+  assert_equals_int (2, _max_open_sockets);
+  fail_if (data.done);
+
+  open_gate ();
+
+  g_mutex_lock (&data.lock);
+  while (!data.done) {
+    g_cond_wait (&data.cond, &data.lock);
+  }
+  g_mutex_unlock (&data.lock);
+
+  fail_if (NULL == data.message);
+  fail_if (NULL == strstr (data.message, "bus_read_since pipe "));
+
+  gstc_client_free (client);
+
+  g_free (data.message);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
+
+static void
+wait_bus_data (BusData * data)
+{
+  g_mutex_lock (&data->lock);
+  while (!data->done) {
+    g_cond_wait (&data->cond, &data->lock);
+  }
+  g_mutex_unlock (&data->lock);
+}
+
+GST_START_TEST (test_client_bus_wait_concurrent)
+{
+  GstClient *client;
+  BusData eos;
+  BusData error;
+  GstcStatus ret;
+
+  g_mutex_init (&eos.lock);
+  g_cond_init (&eos.cond);
+  eos.done = FALSE;
+  eos.message = NULL;
+  g_mutex_init (&error.lock);
+  g_cond_init (&error.cond);
+  error.done = FALSE;
+  error.message = NULL;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  _gated = "bus_read_since";
+  _gate_open = FALSE;
+
+  ret = gstc_pipeline_bus_wait_async (client, "pipe", "eos", -1,
+      bus_callback, &eos);
+  assert_equals_int (GSTC_OK, ret);
+  ret = gstc_pipeline_bus_wait_async (client, "pipe", "error", 1000000,
+      bus_callback, &error);
+  assert_equals_int (GSTC_OK, ret);
+
+  /* Both reads are pending at the same time */
+  wait_gated_requests (2);
+  fail_if (eos.done);
+  fail_if (error.done);
+
+  open_gate ();
+  wait_bus_data (&eos);
+  wait_bus_data (&error);
+
+  /* Each read carries its own filter and timeout, nothing is shared
+   * through the pipeline bus properties */
+  assert_equals_int (2, _requests);
+  fail_if (_shared_socket);
+  fail_if (NULL == eos.message);
+  fail_if (NULL == strstr (eos.message, "bus_read_since pipe "));
+  fail_if (NULL == strstr (eos.message, " eos 1 -1"));
+  fail_if (NULL == error.message);
+  fail_if (NULL == strstr (error.message, " error 1 1000000"));
+
+  gstc_client_free (client);
+
+  g_free (eos.message);
+  g_cond_clear (&eos.cond);
+  g_mutex_clear (&eos.lock);
+  g_free (error.message);
+  g_cond_clear (&error.cond);
+  g_mutex_clear (&error.lock);
+}
+
+GST_END_TEST;
+
+static gpointer
+element_set_thread (gpointer user_data)
+{
+  GstClient *client = (GstClient *) user_data;
+  gint failures = 0;
+  gint i;
+
+  for (i = 0; i < THREAD_REQUESTS; i++) {
+    if (GSTC_OK != gstc_element_set_async (client, "pipe", "src", "num-buffers",
+            "%d", i)) {
+      failures++;
+    }
+  }
+
+  return GINT_TO_POINTER (failures);
+}
+
+GST_START_TEST (test_client_sync_connections)
+{
+  GstClient *client;
+  GThread *threads[CLIENT_THREADS];
+  GstcStatus ret;
+  gint i;
+
+  ret = gstc_client_new ("127.0.0.1", 12345, 0, 1, &client);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_client_set_max_connections (client, 4);
+  assert_equals_int (GSTC_OK, ret);
+
+  _request_delay = 1000;
+
+  for (i = 0; i < CLIENT_THREADS; i++) {
+    threads[i] = g_thread_new (NULL, element_set_thread, client);
+  }
+
+  /* A single failure among all the connections is reported */
+  ret = gstc_element_set_async (client, FAIL_PIPELINE, "src", "num-buffers",
+      "%d", 0);
+  assert_equals_int (GSTC_OK, ret);
+
+  for (i = 0; i < CLIENT_THREADS; i++) {
+    assert_equals_int (0, GPOINTER_TO_INT (g_thread_join (threads[i])));
+  }
+
+  fail_if (_shared_socket);
+  fail_unless (_max_open_sockets <= 4);
+
+  ret = gstc_client_sync (client);
+  assert_equals_int (MOCK_DAEMON_ERROR, ret);
+
+  /* The status is cleared once reported */
+  ret = gstc_client_sync (client);
+  assert_equals_int (GSTC_OK, ret);
+
+  gstc_client_free (client);
+}
+
+GST_END_TEST;
+
 static Suite *
 libgstc_client_suite (void)
 {
@@ -237,6 +700,13 @@ libgstc_client_suite (void)
   tcase_add_test (tc, test_client_null_placeholder);
   tcase_add_test (tc, test_client_null_in_free);
   tcase_add_test (tc, test_client_no_socket);
+  tcase_add_test (tc, test_client_encoding_unsupported);
+  tcase_add_test (tc, test_client_max_connections);
+  tcase_add_test (tc, test_client_concurrent_requests);
+  tcase_add_test (tc, test_client_wait_connection);
+  tcase_add_test (tc, test_client_bus_wait_async_commands);
+  tcase_add_test (tc, test_client_bus_wait_concurrent);
+  tcase_add_test (tc, test_client_sync_connections);
 
   return suite;
 }
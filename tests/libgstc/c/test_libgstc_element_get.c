@@ -107,6 +107,13 @@ gstc_json_get_child_char_array (const char *json, const char *parent_name,
   return GSTC_OK;
 }
 
+GstcStatus
+gstc_json_get_child_int_array (const char *json, const char *parent_name,
+    const char *array_name, int *out, int max_lenght, int *array_lenght)
+{
+  return GSTC_OK;
+}
+
 GstcStatus
 gstc_json_child_string (const char *json, const char *parent_name,
     const char *data_name, char **out)
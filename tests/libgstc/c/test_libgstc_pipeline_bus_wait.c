@@ -25,7 +25,7 @@
 #include "libgstc_thread.h"
 
 /* Test Fixture */
-static gchar _request[3][512];
+static gchar _request[512];
 static GstClient *_client;
 enum
 {
@@ -39,16 +39,27 @@ static const char *_expected_response_ok = "{\n\
   \"code\" : 0,\n\
   \"description\" : \"Success\",\n\
   \"response\" : {\n\
-    \"type\" : \"eos\",\n\
-    \"source\" : \"pipe\",\n\
-    \"timestamp\" : \"99:99:99.999999999\",\n\
-    \"seqnum\" : 1276\n\
-}\n\
+    \"next\" : 7,\n\
+    \"lost\" : 0,\n\
+    \"messages\" : [\n\
+      {\n\
+        \"seq\" : 7,\n\
+        \"type\" : \"eos\",\n\
+        \"source\" : \"pipe\",\n\
+        \"timestamp\" : \"99:99:99.999999999\",\n\
+        \"seqnum\" : 1276\n\
+      }\n\
+    ]\n\
+  }\n\
 }";
 static const char *_expected_response_timeout = "{\n\
   \"code\" : 0,\n\
   \"description\" : \"Success\",\n\
-  \"response\" : null\n\
+  \"response\" : {\n\
+    \"next\" : 6,\n\
+    \"lost\" : 0,\n\
+    \"messages\" : []\n\
+  }\n\
 }";
 
 static const char *_expected_response_corrupted = "{\n\
@@ -101,8 +112,6 @@ GstcStatus
 gstc_socket_send (GstcSocket * socket, const gchar * request, gchar ** response,
     const int timeout)
 {
-  static int reqnum = 0;
-
   switch (_status) {
     case TEST_TIMEOUT:
       *response = malloc (strlen (_expected_response_timeout) + 1);
@@ -121,9 +130,8 @@ gstc_socket_send (GstcSocket * socket, const gchar * request, gchar ** response,
       break;
   }
 
-  memcpy (_request[reqnum], request, strlen (request));
-
-  reqnum++;
+  /* A wait is a single request */
+  memcpy (_request, request, strlen (request));
 
   return GSTC_OK;
 }
@@ -135,19 +143,15 @@ GST_START_TEST (test_pipeline_bus_wait_success)
   const gchar *pipeline_name = "pipe";
   const gchar *message_name = "eos";
   const gint64 timeout = -1;
-  const gchar *expected[] = { "update /pipelines/pipe/bus/types eos",
-    "update /pipelines/pipe/bus/timeout -1",
-    "read /pipelines/pipe/bus/message"
-  };
+  const gchar *expected =
+      "bus_read_since pipe 18446744073709551614 eos 1 -1";
 
   ret =
       gstc_pipeline_bus_wait (_client, pipeline_name, message_name,
       timeout, &message);
   assert_equals_int (GSTC_OK, ret);
 
-  assert_equals_string (expected[0], _request[0]);
-  assert_equals_string (expected[1], _request[1]);
-  assert_equals_string (expected[2], _request[2]);
+  assert_equals_string (expected, _request);
   assert_equals_string (_expected_response_ok, message);
 
   g_free (message);
@@ -162,10 +166,8 @@ GST_START_TEST (test_pipeline_bus_wait_timeout)
   const gchar *pipeline_name = "pipe";
   const gchar *message_name = "eos";
   const gint64 timeout = -1;
-  const gchar *expected[] = { "update /pipelines/pipe/bus/types eos",
-    "update /pipelines/pipe/bus/timeout -1",
-    "read /pipelines/pipe/bus/message"
-  };
+  const gchar *expected =
+      "bus_read_since pipe 18446744073709551614 eos 1 -1";
 
   _status = TEST_TIMEOUT;
 
@@ -174,9 +176,7 @@ GST_START_TEST (test_pipeline_bus_wait_timeout)
       timeout, &message);
   assert_equals_int (GSTC_BUS_TIMEOUT, ret);
 
-  assert_equals_string (expected[0], _request[0]);
-  assert_equals_string (expected[1], _request[1]);
-  assert_equals_string (expected[2], _request[2]);
+  assert_equals_string (expected, _request);
   assert_equals_string (_expected_response_timeout, message);
 
   g_free (message);
@@ -191,10 +191,8 @@ GST_START_TEST (test_pipeline_bus_wait_corrupted)
   const gchar *pipeline_name = "pipe";
   const gchar *message_name = "eos";
   const gint64 timeout = -1;
-  const gchar *expected[] = { "update /pipelines/pipe/bus/types eos",
-    "update /pipelines/pipe/bus/timeout -1",
-    "read /pipelines/pipe/bus/message"
-  };
+  const gchar *expected =
+      "bus_read_since pipe 18446744073709551614 eos 1 -1";
 
   _status = TEST_CORRUPTED;
 
@@ -203,9 +201,7 @@ GST_START_TEST (test_pipeline_bus_wait_corrupted)
       timeout, &message);
   assert_equals_int (GSTC_NOT_FOUND, ret);
 
-  assert_equals_string (expected[0], _request[0]);
-  assert_equals_string (expected[1], _request[1]);
-  assert_equals_string (expected[2], _request[2]);
+  assert_equals_string (expected, _request);
   assert_equals_string (_expected_response_corrupted, message);
 
   g_free (message);
@@ -23,6 +23,7 @@
 #include <sys/socket.h>
 
 #include "libgstc.h"
+#include "libgstc_cbor.h"
 #include "libgstc_socket.h"
 
 struct _GstcSocket
@@ -39,6 +40,70 @@ GSocketService *_mock_server;
 GThread *_mock_thread;
 const gchar *_mock_expected;
 long socket_delay;
+gboolean _mock_framed;
+gboolean _mock_cbor;
+gboolean _mock_close;
+
+/* {"code": 0, "response": {"value": 42}} tagged as CBOR */
+static const guint8 _mock_cbor_response[] = {
+  0xd9, 0xd9, 0xf7, 0xa2, 0x64, 'c', 'o', 'd', 'e', 0x00,
+  0x68, 'r', 'e', 's', 'p', 'o', 'n', 's', 'e',
+  0xbf, 0x65, 'v', 'a', 'l', 'u', 'e', 0x18, 0x2a, 0xff
+};
+
+/* Answers every frame with _mock_expected, or the CBOR response if
+ * _mock_cbor is set, keeping the request id */
+static void
+mock_serve_frames (GInputStream * istream, GOutputStream * ostream)
+{
+  GError *error = NULL;
+  GByteArray *pending = g_byte_array_new ();
+  guint8 chunk[1024];
+  guint8 header[8];
+  guint32 length;
+  gssize count;
+  const void *reply;
+  gsize reply_len;
+
+  while (TRUE) {
+    while (pending->len >= 8) {
+      length = GST_READ_UINT32_BE (pending->data);
+      if (pending->len < 8 + length) {
+        break;
+      }
+
+      if (_mock_cbor) {
+        /* Requests must be a CBOR text string */
+        fail_unless (3 == pending->data[8] >> 5);
+        reply = _mock_cbor_response;
+        reply_len = sizeof (_mock_cbor_response);
+      } else {
+        reply = _mock_expected;
+        reply_len = strlen (_mock_expected);
+      }
+
+      GST_WRITE_UINT32_BE (header, reply_len);
+      memcpy (header + 4, pending->data + 4, 4);
+      g_output_stream_write_all (ostream, header, sizeof (header), NULL, NULL,
+          &error);
+      fail_if (error);
+      g_output_stream_write_all (ostream, reply, reply_len, NULL, NULL,
+          &error);
+      fail_if (error);
+
+      g_byte_array_remove_range (pending, 0, 8 + length);
+    }
+
+    count = g_input_stream_read (istream, chunk, sizeof (chunk), NULL, &error);
+    fail_if (error);
+    if (count <= 0) {
+      break;
+    }
+    g_byte_array_append (pending, chunk, count);
+  }
+
+  g_byte_array_unref (pending);
+}
 
 static gboolean
 mock_server_cb (GSocketService * service, GSocketConnection * connection,
@@ -49,11 +114,15 @@ mock_server_cb (GSocketService * service, GSocketConnection * connection,
       g_io_stream_get_input_stream (G_IO_STREAM (connection));
   GOutputStream *ostream =
       g_io_stream_get_output_stream (G_IO_STREAM (connection));
-  gchar message[64];
+  const gchar *ack = "{ \"response\" : { \"protocol\" : \"framed\" } }";
+  const gchar *cbor_ack = "{ \"response\" : { \"protocol\" : \"framed\", "
+      "\"encoding\" : \"cbor\" } }";
+  gchar message[1024];
   gssize count;
 
   while (TRUE) {
-    count = g_input_stream_read (istream, message, 1024, NULL, &error);
+    count = g_input_stream_read (istream, message, sizeof (message), NULL,
+        &error);
     fail_if (error);
     fail_if (-1 == count);
 
@@ -61,6 +130,22 @@ mock_server_cb (GSocketService * service, GSocketConnection * connection,
       break;
     }
 
+    if (_mock_cbor && 0 == strncmp (message, "protocol framed cbor", count)) {
+      g_output_stream_write_all (ostream, cbor_ack, strlen (cbor_ack) + 1,
+          NULL, NULL, &error);
+      fail_if (error);
+      mock_serve_frames (istream, ostream);
+      break;
+    }
+
+    if (_mock_framed && 0 == strncmp (message, "protocol framed", count)) {
+      g_output_stream_write_all (ostream, ack, strlen (ack) + 1, NULL, NULL,
+          &error);
+      fail_if (error);
+      mock_serve_frames (istream, ostream);
+      break;
+    }
+
     fail_if (NULL == _mock_expected);
     usleep (socket_delay * 1000);
 
@@ -68,6 +153,12 @@ mock_server_cb (GSocketService * service, GSocketConnection * connection,
         _mock_expected, strlen (_mock_expected) + 1, NULL, &error);
     fail_if (error);
     fail_if (-1 == count);
+
+    /* Drop the connection like a restarted daemon would */
+    if (_mock_close) {
+      g_io_stream_close (G_IO_STREAM (connection), NULL, NULL);
+      break;
+    }
   }
 
   return TRUE;
@@ -148,6 +239,9 @@ setup (void)
 {
   socket_delay = 0;
   _mock_malloc_oom = FALSE;
+  _mock_framed = FALSE;
+  _mock_cbor = FALSE;
+  _mock_close = FALSE;
   mock_server_new ();
 }
 
@@ -477,6 +571,181 @@ GST_START_TEST (test_socket_long_response)
 
 GST_END_TEST;
 
+GST_START_TEST (test_socket_framed_pipelining)
+{
+  GstcSocket *socket;
+  GstcStatus ret;
+  const gchar *address = "127.0.0.1";
+  const gint port = 54321;
+  const long wait_time = 1000;
+  const gint keep_open = TRUE;
+  unsigned int ids[3];
+  unsigned int id;
+  gchar *response;
+  gint i;
+
+  _mock_framed = TRUE;
+  _mock_expected = "pong";
+
+  ret = gstc_socket_new (address, port, keep_open, &socket);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_socket_enable_framing (socket, wait_time);
+  assert_equals_int (GSTC_OK, ret);
+
+  /* Queue every request before reading any reply */
+  for (i = 0; i < G_N_ELEMENTS (ids); i++) {
+    ret = gstc_socket_submit (socket, "ping", &ids[i]);
+    assert_equals_int (GSTC_OK, ret);
+  }
+  assert_equals_int (G_N_ELEMENTS (ids), gstc_socket_get_pending (socket));
+
+  for (i = 0; i < G_N_ELEMENTS (ids); i++) {
+    ret = gstc_socket_receive (socket, &id, &response, wait_time);
+    assert_equals_int (GSTC_OK, ret);
+    assert_equals_int (ids[i], id);
+    assert_equals_string (_mock_expected, response);
+    free (response);
+  }
+  assert_equals_int (0, gstc_socket_get_pending (socket));
+
+  /* Synchronous requests keep working over the framed connection */
+  ret = gstc_socket_send (socket, "ping", &response, wait_time);
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_string (_mock_expected, response);
+  free (response);
+
+  gstc_socket_free (socket);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_socket_framed_needs_persistent)
+{
+  GstcSocket *socket;
+  GstcStatus ret;
+  unsigned int id;
+
+  ret = gstc_socket_new ("127.0.0.1", 54321, FALSE, &socket);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_socket_enable_framing (socket, 1000);
+  assert_equals_int (GSTC_UNSUPPORTED, ret);
+
+  ret = gstc_socket_submit (socket, "ping", &id);
+  assert_equals_int (GSTC_UNSUPPORTED, ret);
+
+  gstc_socket_free (socket);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_socket_cbor)
+{
+  GstcSocket *socket;
+  GstcStatus ret;
+  const long wait_time = 1000;
+  gchar *response;
+  gchar *value;
+  gint code;
+
+  _mock_cbor = TRUE;
+
+  ret = gstc_socket_new ("127.0.0.1", 54321, TRUE, &socket);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_socket_enable_cbor (socket, wait_time);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_socket_send (socket, "ping", &response, wait_time);
+  assert_equals_int (GSTC_OK, ret);
+  fail_unless (gstc_cbor_has_magic (response));
+  fail_if (memcmp (_mock_cbor_response, response,
+          sizeof (_mock_cbor_response)));
+
+  ret = gstc_cbor_get_int (response, "code", &code);
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_int (0, code);
+
+  /* Numbers are handed over as text, as with JSON */
+  ret = gstc_cbor_child_string (response, "response", "value", &value);
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_string ("42", value);
+  free (value);
+  free (response);
+
+  /* The CBOR hello already enabled framing */
+  ret = gstc_socket_enable_framing (socket, wait_time);
+  assert_equals_int (GSTC_OK, ret);
+
+  gstc_socket_free (socket);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_socket_cbor_unsupported)
+{
+  GstcSocket *socket;
+  GstcStatus ret;
+
+  /* An older daemon runs the hello as an unknown command */
+  _mock_framed = TRUE;
+  _mock_expected = "{ \"code\" : 10 }";
+
+  ret = gstc_socket_new ("127.0.0.1", 54321, TRUE, &socket);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_socket_enable_cbor (socket, 1000);
+  assert_equals_int (GSTC_UNSUPPORTED, ret);
+
+  /* Plain framing is still available */
+  ret = gstc_socket_enable_framing (socket, 1000);
+  assert_equals_int (GSTC_OK, ret);
+
+  ret = gstc_socket_enable_cbor (socket, 1000);
+  assert_equals_int (GSTC_UNSUPPORTED, ret);
+
+  gstc_socket_free (socket);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_socket_reconnect)
+{
+  GstcSocket *socket;
+  GstcStatus ret;
+  const gchar *address = "127.0.0.1";
+  const gint port = 54321;
+  const int timeout = 1000;
+  const gint keep_open = TRUE;
+  const gchar *request = "ping";
+  const gchar *expected = "pong";
+  gchar *response = NULL;
+
+  ret = gstc_socket_new (address, port, keep_open, &socket);
+  assert_equals_int (GSTC_OK, ret);
+  fail_if (NULL == socket);
+
+  _mock_expected = expected;
+  _mock_close = TRUE;
+  ret = gstc_socket_send (socket, request, &response, timeout);
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_string (expected, response);
+  g_free (response);
+
+  /* Let the connection close, the next request opens a new one */
+  g_usleep (100 * G_TIME_SPAN_MILLISECOND);
+
+  ret = gstc_socket_send (socket, request, &response, timeout);
+  assert_equals_int (GSTC_OK, ret);
+  assert_equals_string (expected, response);
+  g_free (response);
+
+  gstc_socket_free (socket);
+}
+
+GST_END_TEST;
+
 static Suite *
 libgstc_client_suite (void)
 {
@@ -499,6 +768,11 @@ libgstc_client_suite (void)
   tcase_add_test (tc, test_socket_null_request);
   tcase_add_test (tc, test_socket_null_resp_placeholder);
   tcase_add_test (tc, test_socket_long_response);
+  tcase_add_test (tc, test_socket_framed_pipelining);
+  tcase_add_test (tc, test_socket_framed_needs_persistent);
+  tcase_add_test (tc, test_socket_cbor);
+  tcase_add_test (tc, test_socket_cbor_unsupported);
+  tcase_add_test (tc, test_socket_reconnect);
 
   return suite;
 }